@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+#
+# Record the -ftime-report timings of compiling a set of sources, and
+# compare them against an earlier recording to find compile-time
+# regressions.
+#
+# This file is part of GCC.
+#
+# GCC is free software; you can redistribute it and/or modify it under
+# the terms of the GNU General Public License as published by the Free
+# Software Foundation; either version 3, or (at your option) any later
+# version.
+#
+# GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+# for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GCC; see the file COPYING3.  If not see
+# <http://www.gnu.org/licenses/>.
+
+""" Record and compare compile-time reports.
+
+  compile-time-report.py run --compiler ./xgcc --compiler-arg=-B./ \\
+      --flags "-O2" --trials 5 --output new.json foo.c bar.C baz.f90
+
+compiles each source TRIALS times with -ftime-report and writes the
+user+sys time of every time variable, and the GGC memory it allocated,
+to a JSON file.
+
+  compile-time-report.py compare old.json new.json
+
+reports the time variables that got slower or allocate more memory.
+A time is only reported if the difference of the means exceeds all of
+--min-seconds, --min-percent of the old mean, and --deviations times
+the combined standard error of the two samples, so that the noise of
+a single run does not show up as a regression.  GGC memory does not
+vary between runs and only needs to exceed --min-percent.  The exit
+status is 1 if anything was reported.
+"""
+
+import argparse
+import json
+import math
+import os
+import re
+import shlex
+import subprocess
+import sys
+
+number = r'\s*([0-9.]+)\s*'
+percent = r'\(\s*[0-9]+%\)'
+# Memory is printed as "123 kB", or by newer compilers as "123k", "12M"
+# or "0 ".
+memory = r'([0-9]+)\s*(kB|[kMG]?)'
+row_parser = re.compile(r'^ (\S.*?)\s*:' + (number + percent) * 3
+                        + memory + r'\s*' + percent)
+total_parser = re.compile(r'^ TOTAL\s*:' + number * 3 + memory + r'\s*$')
+memory_scale = {'': 1.0 / 1024, 'kB': 1, 'k': 1, 'M': 1024, 'G': 1024 * 1024}
+
+
+def kilobytes(size, unit):
+    return int(int(size) * memory_scale[unit])
+
+
+def parse_time_report(text):
+    """ Return a dictionary mapping the time variables in the
+    -ftime-report output TEXT to (seconds, kB) pairs.  The seconds are
+    user plus system time; wall time is left out as it depends on the
+    load of the machine.  The total is recorded as TOTAL.
+    """
+    result = {}
+    for line in text.splitlines():
+        m = total_parser.match(line)
+        if m:
+            result['TOTAL'] = (float(m.group(1)) + float(m.group(2)),
+                               kilobytes(m.group(4), m.group(5)))
+            continue
+        m = row_parser.match(line)
+        if m:
+            result[m.group(1)] = (float(m.group(2)) + float(m.group(3)),
+                                  kilobytes(m.group(5), m.group(6)))
+    return result
+
+
+def run(args):
+    compiler = [args.compiler] + args.compiler_arg
+    flags = shlex.split(args.flags)
+    results = {}
+    for source in args.sources:
+        timevars = {}
+        for trial in range(args.trials):
+            cmd = (compiler + flags
+                   + ['-ftime-report', '-c', '-o', os.devnull, source])
+            proc = subprocess.run(cmd, stdout=subprocess.DEVNULL,
+                                  stderr=subprocess.PIPE,
+                                  universal_newlines=True)
+            if proc.returncode != 0:
+                sys.stderr.write(proc.stderr)
+                sys.exit('%s: compilation failed: %s'
+                         % (sys.argv[0], ' '.join(cmd)))
+            report = parse_time_report(proc.stderr)
+            if 'TOTAL' not in report:
+                sys.exit('%s: no -ftime-report output from: %s'
+                         % (sys.argv[0], ' '.join(cmd)))
+            for name, (seconds, kb) in report.items():
+                entry = timevars.setdefault(name, {'seconds': [], 'kB': 0})
+                entry['seconds'].append(seconds)
+                entry['kB'] = max(entry['kB'], kb)
+        # A time variable that is missing from some trials took no
+        # measurable time in them.
+        for entry in timevars.values():
+            entry['seconds'] += [0.0] * (args.trials - len(entry['seconds']))
+        results[source] = timevars
+        print('%s: %.2fs' % (source, mean(timevars['TOTAL']['seconds'])))
+    with open(args.output, 'w') as f:
+        json.dump({'flags': args.flags, 'trials': args.trials,
+                   'sources': results}, f, indent=1, sort_keys=True)
+
+
+def mean(values):
+    return sum(values) / len(values)
+
+
+def standard_error(values):
+    n = len(values)
+    if n < 2:
+        return 0.0
+    m = mean(values)
+    variance = sum((v - m) * (v - m) for v in values) / (n - 1)
+    return math.sqrt(variance / n)
+
+
+def compare(args):
+    with open(args.baseline) as f:
+        old = json.load(f)['sources']
+    with open(args.current) as f:
+        new = json.load(f)['sources']
+    regressions = 0
+    for source in sorted(new):
+        if source not in old:
+            print('%s: not in %s' % (source, args.baseline))
+            continue
+        for name in sorted(new[source]):
+            now = new[source][name]
+            was = old[source].get(name, {'seconds': [0.0], 'kB': 0})
+            old_mean = mean(was['seconds'])
+            new_mean = mean(now['seconds'])
+            noise = args.deviations * math.hypot(standard_error(was['seconds']),
+                                                 standard_error(now['seconds']))
+            diff = new_mean - old_mean
+            if (diff > args.min_seconds
+                    and diff > old_mean * args.min_percent / 100
+                    and diff > noise):
+                print('%s: %s: %.2fs -> %.2fs (+/- %.2fs)'
+                      % (source, name, old_mean, new_mean, noise))
+                regressions += 1
+            if (now['kB'] - was['kB'] > 0
+                    and now['kB'] - was['kB'] > was['kB'] * args.min_percent / 100):
+                print('%s: %s: %d kB -> %d kB'
+                      % (source, name, was['kB'], now['kB']))
+                regressions += 1
+    if regressions:
+        print('%d compile-time regressions' % regressions)
+        sys.exit(1)
+
+
+parser = argparse.ArgumentParser()
+subparsers = parser.add_subparsers(dest='command')
+subparsers.required = True
+
+run_parser = subparsers.add_parser('run', help='record compile times')
+run_parser.add_argument('--compiler', default='gcc',
+                        help='compiler driver to use')
+run_parser.add_argument('--compiler-arg', action='append', default=[],
+                        help='argument to pass to the compiler first, '
+                        'such as -B./')
+run_parser.add_argument('--flags', default='-O2',
+                        help='options to compile with')
+run_parser.add_argument('--trials', type=int, default=5,
+                        help='number of times to compile each source')
+run_parser.add_argument('--output', default='compile-time.json',
+                        help='file to write the results to')
+run_parser.add_argument('sources', nargs='+')
+run_parser.set_defaults(func=run)
+
+compare_parser = subparsers.add_parser('compare',
+                                       help='compare two recordings')
+compare_parser.add_argument('baseline')
+compare_parser.add_argument('current')
+compare_parser.add_argument('--min-seconds', type=float, default=0.05,
+                            help='smallest time difference to report')
+compare_parser.add_argument('--min-percent', type=float, default=2.0,
+                            help='smallest relative difference to report')
+compare_parser.add_argument('--deviations', type=float, default=3.0,
+                            help='number of standard errors a time '
+                            'difference must exceed')
+compare_parser.set_defaults(func=compare)
+
+args = parser.parse_args()
+args.func(args)
@@ -0,0 +1,407 @@
+/* Measure the costs of the operations the vectorizer cost model
+   counts on the machine this runs on, and write them out as a table
+   for the x86 -mvect-cost-table= option.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of GCC.
+
+   GCC is free software; you can redistribute it and/or modify it under
+   the terms of the GNU General Public License as published by the Free
+   Software Foundation; either version 3, or (at your option) any later
+   version.
+
+   GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+   for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GCC; see the file COPYING3.  If not see
+   <http://www.gnu.org/licenses/>.
+
+   Build it for the vector extensions the table is for, and run it on
+   an otherwise idle machine:
+
+     gcc -O2 -march=native vect-cost-calibrate.c -o vect-cost-calibrate
+     ./vect-cost-calibrate > costs.txt
+     gcc -O3 -march=native -mvect-cost-table=costs.txt foo.c
+
+   The vectorizer adds up the costs of the statements of the scalar and
+   the vector loop bodies and compares the sums, so what is measured is
+   the reciprocal throughput of each kind of operation: each kernel
+   issues eight independent operations per iteration and the time of an
+   empty loop is subtracted.  The costs are scaled so that a scalar
+   integer add costs COSTS_N_INSNS (1), that is 4.  Vector sizes the
+   compiler was not told to use are left out, and keep the costs of the
+   -mtune= model, as do the kinds of cost not measured here (gathers,
+   scatters, branches and promotions).
+
+   The table has a line for each cost:
+
+     KIND [int|fp] [BITS] COST
+
+   where KIND is a vect_cost_for_stmt name, int or fp restricts the line
+   to integer or floating-point elements and BITS to vectors of that
+   size.  '#' starts a comment.  */
+
+#if !defined (__x86_64__) && !defined (__i386__)
+#error "The cost table is only read by the x86 back end"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Iterations of each kernel, each doing eight operations.  */
+static long iterations = 20000000;
+
+/* The best of this many runs of each kernel is taken.  */
+#define RUNS 5
+
+/* Hide the value of X from the optimizers, so that the operation
+   producing it is done, and done again in each iteration.  */
+#define KEEP(x) __asm__ volatile ("" : "+r" (x))
+#define KEEP_VEC(x) __asm__ volatile ("" : "+v" (x))
+#define USE_VEC(x) __asm__ volatile ("" : : "v" (x))
+
+static double
+now (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Return the best time of RUNS runs of KERNEL, in nanoseconds per
+   operation.  */
+
+static double
+time_kernel (void (*kernel) (long))
+{
+  double best = 0;
+  int run;
+
+  for (run = 0; run < RUNS; run++)
+    {
+      double start = now ();
+      kernel (iterations);
+      double t = (now () - start) * 1e9 / (iterations * 8.0);
+      if (run == 0 || t < best)
+	best = t;
+    }
+  return best;
+}
+
+/* The loop overhead, subtracted from every kernel.  */
+
+static void
+kernel_empty (long n)
+{
+  long i;
+  for (i = 0; i < n; i++)
+    __asm__ volatile ("");
+}
+
+/* Eight independent chains of OP on variables of TYPE, kept in
+   registers by KEEPER.  */
+#define ARITH_KERNEL(NAME, TYPE, KEEPER, OP)				\
+static void								\
+NAME (long n)								\
+{									\
+  TYPE a0 = {1}, a1 = {2}, a2 = {3}, a3 = {4};				\
+  TYPE a4 = {5}, a5 = {6}, a6 = {7}, a7 = {8}, b = {1};			\
+  long i;								\
+  KEEPER (b);								\
+  for (i = 0; i < n; i++)						\
+    {									\
+      a0 = OP (a0, b); a1 = OP (a1, b); a2 = OP (a2, b);		\
+      a3 = OP (a3, b); a4 = OP (a4, b); a5 = OP (a5, b);		\
+      a6 = OP (a6, b); a7 = OP (a7, b);					\
+      KEEPER (a0); KEEPER (a1); KEEPER (a2); KEEPER (a3);		\
+      KEEPER (a4); KEEPER (a5); KEEPER (a6); KEEPER (a7);		\
+    }									\
+}
+
+#define ADD(a, b) ((a) + (b))
+
+/* Eight loads of TYPE a stride of STRIDE bytes apart, from BUF plus
+   OFFSET bytes.  */
+#define LOAD_KERNEL(NAME, TYPE, KEEPER, STRIDE, OFFSET)			\
+static void								\
+NAME (long n)								\
+{									\
+  char *p = buf + (OFFSET);						\
+  long i;								\
+  for (i = 0; i < n; i++)						\
+    {									\
+      TYPE x0, x1, x2, x3, x4, x5, x6, x7;				\
+      KEEP (p);								\
+      x0 = *(TYPE *) (p + 0 * (STRIDE));				\
+      x1 = *(TYPE *) (p + 1 * (STRIDE));				\
+      x2 = *(TYPE *) (p + 2 * (STRIDE));				\
+      x3 = *(TYPE *) (p + 3 * (STRIDE));				\
+      x4 = *(TYPE *) (p + 4 * (STRIDE));				\
+      x5 = *(TYPE *) (p + 5 * (STRIDE));				\
+      x6 = *(TYPE *) (p + 6 * (STRIDE));				\
+      x7 = *(TYPE *) (p + 7 * (STRIDE));				\
+      KEEPER (x0); KEEPER (x1); KEEPER (x2); KEEPER (x3);		\
+      KEEPER (x4); KEEPER (x5); KEEPER (x6); KEEPER (x7);		\
+    }									\
+}
+
+/* Likewise for stores.  */
+#define STORE_KERNEL(NAME, TYPE, KEEPER, STRIDE, OFFSET)		\
+static void								\
+NAME (long n)								\
+{									\
+  char *p = buf + (OFFSET);						\
+  TYPE x = {1};								\
+  long i;								\
+  KEEPER (x);								\
+  for (i = 0; i < n; i++)						\
+    {									\
+      KEEP (p);								\
+      *(TYPE *) (p + 0 * (STRIDE)) = x;					\
+      *(TYPE *) (p + 1 * (STRIDE)) = x;					\
+      *(TYPE *) (p + 2 * (STRIDE)) = x;					\
+      *(TYPE *) (p + 3 * (STRIDE)) = x;					\
+      *(TYPE *) (p + 4 * (STRIDE)) = x;					\
+      *(TYPE *) (p + 5 * (STRIDE)) = x;					\
+      *(TYPE *) (p + 6 * (STRIDE)) = x;					\
+      *(TYPE *) (p + 7 * (STRIDE)) = x;					\
+    }									\
+}
+
+/* Eight extractions of the first element of vectors of VTYPE into
+   ETYPE scalars.  */
+#define EXTRACT_KERNEL(NAME, VTYPE, ETYPE, EKEEPER)			\
+static void								\
+NAME (long n)								\
+{									\
+  VTYPE v0 = {1}, v1 = {2}, v2 = {3}, v3 = {4};				\
+  VTYPE v4 = {5}, v5 = {6}, v6 = {7}, v7 = {8};				\
+  long i;								\
+  for (i = 0; i < n; i++)						\
+    {									\
+      ETYPE e0, e1, e2, e3, e4, e5, e6, e7;				\
+      KEEP_VEC (v0); KEEP_VEC (v1); KEEP_VEC (v2); KEEP_VEC (v3);	\
+      KEEP_VEC (v4); KEEP_VEC (v5); KEEP_VEC (v6); KEEP_VEC (v7);	\
+      e0 = v0[0]; e1 = v1[0]; e2 = v2[0]; e3 = v3[0];			\
+      e4 = v4[0]; e5 = v5[0]; e6 = v6[0]; e7 = v7[0];			\
+      EKEEPER (e0); EKEEPER (e1); EKEEPER (e2); EKEEPER (e3);		\
+      EKEEPER (e4); EKEEPER (e5); EKEEPER (e6); EKEEPER (e7);		\
+    }									\
+}
+
+/* Eight broadcasts of ETYPE scalars into vectors of VTYPE.  */
+#define SPLAT_KERNEL(NAME, VTYPE, ETYPE, EKEEPER)			\
+static void								\
+NAME (long n)								\
+{									\
+  ETYPE e0 = 1, e1 = 2, e2 = 3, e3 = 4, e4 = 5, e5 = 6, e6 = 7, e7 = 8;	\
+  long i;								\
+  for (i = 0; i < n; i++)						\
+    {									\
+      VTYPE v0, v1, v2, v3, v4, v5, v6, v7;				\
+      EKEEPER (e0); EKEEPER (e1); EKEEPER (e2); EKEEPER (e3);		\
+      EKEEPER (e4); EKEEPER (e5); EKEEPER (e6); EKEEPER (e7);		\
+      v0 = e0 - (VTYPE) {0}; v1 = e1 - (VTYPE) {0};			\
+      v2 = e2 - (VTYPE) {0}; v3 = e3 - (VTYPE) {0};			\
+      v4 = e4 - (VTYPE) {0}; v5 = e5 - (VTYPE) {0};			\
+      v6 = e6 - (VTYPE) {0}; v7 = e7 - (VTYPE) {0};			\
+      USE_VEC (v0); USE_VEC (v1); USE_VEC (v2); USE_VEC (v3);		\
+      USE_VEC (v4); USE_VEC (v5); USE_VEC (v6); USE_VEC (v7);		\
+    }									\
+}
+
+/* Eight element reversals of vectors of VTYPE, using MASK.  */
+#define PERM_KERNEL(NAME, VTYPE, MTYPE, MASK)				\
+static void								\
+NAME (long n)								\
+{									\
+  VTYPE v0 = {1}, v1 = {2}, v2 = {3}, v3 = {4};				\
+  VTYPE v4 = {5}, v5 = {6}, v6 = {7}, v7 = {8};				\
+  const MTYPE m = MASK;							\
+  long i;								\
+  for (i = 0; i < n; i++)						\
+    {									\
+      v0 = __builtin_shuffle (v0, m); v1 = __builtin_shuffle (v1, m);	\
+      v2 = __builtin_shuffle (v2, m); v3 = __builtin_shuffle (v3, m);	\
+      v4 = __builtin_shuffle (v4, m); v5 = __builtin_shuffle (v5, m);	\
+      v6 = __builtin_shuffle (v6, m); v7 = __builtin_shuffle (v7, m);	\
+      KEEP_VEC (v0); KEEP_VEC (v1); KEEP_VEC (v2); KEEP_VEC (v3);	\
+      KEEP_VEC (v4); KEEP_VEC (v5); KEEP_VEC (v6); KEEP_VEC (v7);	\
+    }									\
+}
+
+/* A buffer small enough to stay in the L1 cache, aligned for the
+   largest vectors.  */
+static char buf[4096] __attribute__ ((aligned (64)));
+
+typedef long long v2di __attribute__ ((vector_size (16)));
+typedef double v2df __attribute__ ((vector_size (16)));
+typedef v2di v2di_u __attribute__ ((aligned (1)));
+typedef v2df v2df_u __attribute__ ((aligned (1)));
+
+ARITH_KERNEL (kernel_add_int, long long, KEEP, ADD)
+ARITH_KERNEL (kernel_add_fp, double, KEEP_VEC, ADD)
+LOAD_KERNEL (kernel_load_int, long long, KEEP, 64, 0)
+LOAD_KERNEL (kernel_load_fp, double, KEEP_VEC, 64, 0)
+STORE_KERNEL (kernel_store_int, long long, KEEP, 64, 0)
+STORE_KERNEL (kernel_store_fp, double, KEEP_VEC, 64, 0)
+
+ARITH_KERNEL (kernel_add_v2di, v2di, KEEP_VEC, ADD)
+ARITH_KERNEL (kernel_add_v2df, v2df, KEEP_VEC, ADD)
+LOAD_KERNEL (kernel_load_v2df, v2df, KEEP_VEC, 128, 0)
+LOAD_KERNEL (kernel_loadu_v2df, v2df_u, KEEP_VEC, 128, 8)
+STORE_KERNEL (kernel_store_v2df, v2df, KEEP_VEC, 128, 0)
+STORE_KERNEL (kernel_storeu_v2df, v2df_u, KEEP_VEC, 128, 8)
+EXTRACT_KERNEL (kernel_extract_v2di, v2di, long long, KEEP)
+EXTRACT_KERNEL (kernel_extract_v2df, v2df, double, KEEP_VEC)
+SPLAT_KERNEL (kernel_splat_v2di, v2di, long long, KEEP)
+SPLAT_KERNEL (kernel_splat_v2df, v2df, double, KEEP_VEC)
+PERM_KERNEL (kernel_perm_v2di, v2di, v2di, ((v2di) {1, 0}))
+PERM_KERNEL (kernel_perm_v2df, v2df, v2di, ((v2di) {1, 0}))
+
+#ifdef __AVX__
+typedef long long v4di __attribute__ ((vector_size (32)));
+typedef double v4df __attribute__ ((vector_size (32)));
+typedef v4df v4df_u __attribute__ ((aligned (1)));
+
+ARITH_KERNEL (kernel_add_v4df, v4df, KEEP_VEC, ADD)
+LOAD_KERNEL (kernel_load_v4df, v4df, KEEP_VEC, 128, 0)
+LOAD_KERNEL (kernel_loadu_v4df, v4df_u, KEEP_VEC, 128, 8)
+STORE_KERNEL (kernel_store_v4df, v4df, KEEP_VEC, 128, 0)
+STORE_KERNEL (kernel_storeu_v4df, v4df_u, KEEP_VEC, 128, 8)
+EXTRACT_KERNEL (kernel_extract_v4df, v4df, double, KEEP_VEC)
+SPLAT_KERNEL (kernel_splat_v4df, v4df, double, KEEP_VEC)
+PERM_KERNEL (kernel_perm_v4df, v4df, v4di, ((v4di) {3, 2, 1, 0}))
+#endif
+
+#ifdef __AVX2__
+ARITH_KERNEL (kernel_add_v4di, v4di, KEEP_VEC, ADD)
+EXTRACT_KERNEL (kernel_extract_v4di, v4di, long long, KEEP)
+SPLAT_KERNEL (kernel_splat_v4di, v4di, long long, KEEP)
+PERM_KERNEL (kernel_perm_v4di, v4di, v4di, ((v4di) {3, 2, 1, 0}))
+#endif
+
+#ifdef __AVX512F__
+typedef long long v8di __attribute__ ((vector_size (64)));
+typedef double v8df __attribute__ ((vector_size (64)));
+typedef v8df v8df_u __attribute__ ((aligned (1)));
+
+ARITH_KERNEL (kernel_add_v8di, v8di, KEEP_VEC, ADD)
+ARITH_KERNEL (kernel_add_v8df, v8df, KEEP_VEC, ADD)
+LOAD_KERNEL (kernel_load_v8df, v8df, KEEP_VEC, 128, 0)
+LOAD_KERNEL (kernel_loadu_v8df, v8df_u, KEEP_VEC, 128, 8)
+STORE_KERNEL (kernel_store_v8df, v8df, KEEP_VEC, 128, 0)
+STORE_KERNEL (kernel_storeu_v8df, v8df_u, KEEP_VEC, 128, 8)
+EXTRACT_KERNEL (kernel_extract_v8di, v8di, long long, KEEP)
+EXTRACT_KERNEL (kernel_extract_v8df, v8df, double, KEEP_VEC)
+SPLAT_KERNEL (kernel_splat_v8di, v8di, long long, KEEP)
+SPLAT_KERNEL (kernel_splat_v8df, v8df, double, KEEP_VEC)
+PERM_KERNEL (kernel_perm_v8di, v8di, v8di, ((v8di) {7, 6, 5, 4, 3, 2, 1, 0}))
+PERM_KERNEL (kernel_perm_v8df, v8df, v8di, ((v8di) {7, 6, 5, 4, 3, 2, 1, 0}))
+#endif
+
+/* The time of the empty loop, and of a scalar integer add.  */
+static double overhead, unit;
+
+/* Measure KERNEL and write its cost as the line "KIND CLASS BITS",
+   leaving out CLASS if NULL and BITS if zero.  */
+
+static void
+report (const char *kind, const char *cls, int bits, void (*kernel) (long))
+{
+  double t = time_kernel (kernel) - overhead;
+  int cost = (int) (4 * t / unit + 0.5);
+
+  if (cost < 1)
+    cost = 1;
+  printf ("%s", kind);
+  if (cls)
+    printf (" %s", cls);
+  if (bits)
+    printf (" %d", bits);
+  printf (" %d\n", cost);
+}
+
+int
+main (int argc, char **argv)
+{
+  if (argc > 1)
+    iterations = atol (argv[1]);
+  if (iterations <= 0)
+    {
+      fprintf (stderr, "usage: %s [iterations]\n", argv[0]);
+      return 1;
+    }
+
+  overhead = time_kernel (kernel_empty);
+  unit = time_kernel (kernel_add_int) - overhead;
+  if (unit <= 0)
+    {
+      fprintf (stderr, "%s: the timings are too noisy, "
+	       "try more iterations\n", argv[0]);
+      return 1;
+    }
+
+  printf ("# Vectorizer costs measured by vect-cost-calibrate,\n"
+	  "# %.3f ns per scalar integer add.\n", unit);
+
+  report ("scalar_stmt", "int", 0, kernel_add_int);
+  report ("scalar_stmt", "fp", 0, kernel_add_fp);
+  report ("scalar_load", "int", 0, kernel_load_int);
+  report ("scalar_load", "fp", 0, kernel_load_fp);
+  report ("scalar_store", "int", 0, kernel_store_int);
+  report ("scalar_store", "fp", 0, kernel_store_fp);
+
+  report ("vector_stmt", "int", 128, kernel_add_v2di);
+  report ("vector_stmt", "fp", 128, kernel_add_v2df);
+  report ("vector_load", NULL, 128, kernel_load_v2df);
+  report ("unaligned_load", NULL, 128, kernel_loadu_v2df);
+  report ("vector_store", NULL, 128, kernel_store_v2df);
+  report ("unaligned_store", NULL, 128, kernel_storeu_v2df);
+  report ("vec_to_scalar", "int", 128, kernel_extract_v2di);
+  report ("vec_to_scalar", "fp", 128, kernel_extract_v2df);
+  report ("scalar_to_vec", "int", 128, kernel_splat_v2di);
+  report ("scalar_to_vec", "fp", 128, kernel_splat_v2df);
+  report ("vec_perm", "int", 128, kernel_perm_v2di);
+  report ("vec_perm", "fp", 128, kernel_perm_v2df);
+
+#ifdef __AVX__
+  report ("vector_stmt", "fp", 256, kernel_add_v4df);
+  report ("vector_load", NULL, 256, kernel_load_v4df);
+  report ("unaligned_load", NULL, 256, kernel_loadu_v4df);
+  report ("vector_store", NULL, 256, kernel_store_v4df);
+  report ("unaligned_store", NULL, 256, kernel_storeu_v4df);
+  report ("vec_to_scalar", "fp", 256, kernel_extract_v4df);
+  report ("scalar_to_vec", "fp", 256, kernel_splat_v4df);
+  report ("vec_perm", "fp", 256, kernel_perm_v4df);
+#endif
+#ifdef __AVX2__
+  report ("vector_stmt", "int", 256, kernel_add_v4di);
+  report ("vec_to_scalar", "int", 256, kernel_extract_v4di);
+  report ("scalar_to_vec", "int", 256, kernel_splat_v4di);
+  report ("vec_perm", "int", 256, kernel_perm_v4di);
+#endif
+
+#ifdef __AVX512F__
+  report ("vector_stmt", "int", 512, kernel_add_v8di);
+  report ("vector_stmt", "fp", 512, kernel_add_v8df);
+  report ("vector_load", NULL, 512, kernel_load_v8df);
+  report ("unaligned_load", NULL, 512, kernel_loadu_v8df);
+  report ("vector_store", NULL, 512, kernel_store_v8df);
+  report ("unaligned_store", NULL, 512, kernel_storeu_v8df);
+  report ("vec_to_scalar", "int", 512, kernel_extract_v8di);
+  report ("vec_to_scalar", "fp", 512, kernel_extract_v8df);
+  report ("scalar_to_vec", "int", 512, kernel_splat_v8di);
+  report ("scalar_to_vec", "fp", 512, kernel_splat_v8df);
+  report ("vec_perm", "int", 512, kernel_perm_v8di);
+  report ("vec_perm", "fp", 512, kernel_perm_v8df);
+#endif
+
+  return 0;
+}
@@ -485,6 +485,11 @@ public:
   object_allocator (const char *name CXX_MEM_STAT_INFO):
     m_allocator (name, sizeof (T) PASS_MEM_STAT) {}
 
+  /* Free all objects at once, in time proportional to the number of
+     blocks of the pool rather than to the number of objects.  Their
+     destructors are not run, so when T needs no destruction this is
+     how a pass should discard its objects at its end, instead of
+     removing them one by one first.  */
   inline void
   release ()
   {
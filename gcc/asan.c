@@ -3286,6 +3286,7 @@ asan_expand_check_ifn (gimple_stmt_iterator *iter, bool use_calls)
   bool is_scalar_access = (flags & ASAN_CHECK_SCALAR_ACCESS) != 0;
   bool is_store = (flags & ASAN_CHECK_STORE) != 0;
   bool is_non_zero_len = (flags & ASAN_CHECK_NON_ZERO_LEN) != 0;
+  bool is_range = (flags & ASAN_CHECK_RANGE) != 0;
 
   tree base = gimple_call_arg (g, 1);
   tree len = gimple_call_arg (g, 2);
@@ -3294,7 +3295,10 @@ asan_expand_check_ifn (gimple_stmt_iterator *iter, bool use_calls)
   HOST_WIDE_INT size_in_bytes
     = is_scalar_access && tree_fits_shwi_p (len) ? tree_to_shwi (len) : -1;
 
-  if (use_calls)
+  /* The inline expansion below only tests the first and last bytes of
+     a non-scalar access, so a range check that must cover every byte
+     always uses the callbacks.  */
+  if (use_calls || is_range)
     {
       /* Instrument using callbacks.  */
       gimple *g = gimple_build_assign (make_ssa_name (pointer_sized_int_node),
@@ -81,7 +81,10 @@ enum asan_check_flags
   ASAN_CHECK_STORE = 1 << 0,
   ASAN_CHECK_SCALAR_ACCESS = 1 << 1,
   ASAN_CHECK_NON_ZERO_LEN = 1 << 2,
-  ASAN_CHECK_LAST = 1 << 3
+  /* The whole range must be checked, not just its first and last
+     bytes.  */
+  ASAN_CHECK_RANGE = 1 << 3,
+  ASAN_CHECK_LAST = 1 << 4
 };
 
 /* Flags for Asan check builtins.  */
@@ -1054,10 +1054,14 @@ afdo_indirect_call (gimple_stmt_iterator *gsi, const icall_target_map &map,
       fprintf (dump_file, "\n");
     }
 
-  /* FIXME: Count should be initialized.  */
+  /* Give the direct call the share of the samples that went to the
+     promoted target, so that the speculative check gets a meaningful
+     probability.  */
+  profile_count direct_count = profile_count::uninitialized ();
+  if (total > 0 && indirect_edge->count.initialized_p ())
+    direct_count = indirect_edge->count.apply_scale (max_iter->second, total);
   struct cgraph_edge *new_edge
-      = indirect_edge->make_speculative (direct_call,
-					 profile_count::uninitialized ());
+      = indirect_edge->make_speculative (direct_call, direct_count);
   new_edge->redirect_call_stmt_to_callee ();
   gimple_remove_histogram_value (cfun, stmt, hist);
   inline_call (new_edge, true, NULL, NULL, false);
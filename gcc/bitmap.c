@@ -2030,6 +2030,92 @@ bitmap_ior_into (bitmap a, const_bitmap b)
   return changed;
 }
 
+/* A |= B, and set DELTA to the bits that this adds to A, that is
+   B & ~A for the original A.  This is bitmap_and_compl (DELTA, B, A)
+   followed by bitmap_ior_into (A, DELTA), done in a single walk over
+   A and B.  Return true if A changes.  */
+
+bool
+bitmap_ior_into_delta (bitmap a, const_bitmap b, bitmap delta)
+{
+  bitmap_element *a_elt = a->first;
+  const bitmap_element *b_elt = b->first;
+  bitmap_element *a_prev = NULL;
+  bitmap_element *delta_elt = delta->first;
+  bitmap_element *delta_prev = NULL;
+
+  gcc_checking_assert (!a->tree_form && !b->tree_form && !delta->tree_form);
+  gcc_assert (delta != a && delta != b);
+
+  if (a == b)
+    {
+      bitmap_clear (delta);
+      return false;
+    }
+
+  while (b_elt)
+    {
+      BITMAP_WORD bits[BITMAP_ELEMENT_WORDS];
+      BITMAP_WORD ior = 0;
+      unsigned ix;
+
+      while (a_elt && a_elt->indx < b_elt->indx)
+	{
+	  a_prev = a_elt;
+	  a_elt = a_elt->next;
+	}
+
+      if (a_elt && a_elt->indx == b_elt->indx)
+	{
+	  /* Matching elts, generate B & ~A and add it to A.  */
+	  for (ix = 0; ix < BITMAP_ELEMENT_WORDS; ix++)
+	    {
+	      bits[ix] = b_elt->bits[ix] & ~a_elt->bits[ix];
+	      a_elt->bits[ix] |= bits[ix];
+	      ior |= bits[ix];
+	    }
+	}
+      else
+	{
+	  /* B's element is new to A, copy it over as a whole.  */
+	  a_elt = bitmap_list_insert_element_after (a, a_prev, b_elt->indx);
+	  memcpy (a_elt->bits, b_elt->bits, sizeof (a_elt->bits));
+	  memcpy (bits, b_elt->bits, sizeof (bits));
+	  ior = 1;
+	}
+      a_prev = a_elt;
+      a_elt = a_elt->next;
+
+      if (ior)
+	{
+	  /* Overwrite the elements DELTA already has rather than
+	     freeing and reallocating them.  */
+	  if (!delta_elt)
+	    delta_elt = bitmap_list_insert_element_after (delta, delta_prev,
+							  b_elt->indx);
+	  else
+	    delta_elt->indx = b_elt->indx;
+	  memcpy (delta_elt->bits, bits, sizeof (bits));
+	  delta_prev = delta_elt;
+	  delta_elt = delta_elt->next;
+	}
+      b_elt = b_elt->next;
+    }
+
+  /* Ensure that delta->current is valid.  */
+  delta->current = delta->first;
+  if (delta_elt)
+    bitmap_elt_clear_from (delta, delta_elt);
+  gcc_checking_assert (!delta->current == !delta->first);
+  if (delta->current)
+    delta->indx = delta->current->indx;
+
+  gcc_checking_assert (!a->current == !a->first);
+  if (a->current)
+    a->indx = a->current->indx;
+  return delta_prev != NULL;
+}
+
 /* A |= B.  Return true if A changes.  Free B (re-using its storage
    for the result).  */
 
@@ -2852,6 +2938,40 @@ test_bitmap_single_bit_set_p ()
   ASSERT_EQ (1066, bitmap_first_set_bit (b));
 }
 
+/* Verify bitmap_ior_into_delta against bitmap_and_compl and
+   bitmap_ior_into.  */
+
+static void
+test_ior_into_delta ()
+{
+  bitmap a = bitmap_gc_alloc ();
+  bitmap b = bitmap_gc_alloc ();
+  bitmap delta = bitmap_gc_alloc ();
+  bitmap expected = bitmap_gc_alloc ();
+
+  bitmap_set_range (a, 10, 20);
+  bitmap_set_range (a, 1000, 5);
+  bitmap_set_range (b, 0, 15);
+  bitmap_set_range (b, 500, 3);
+  bitmap_set_range (b, 1000, 5);
+  bitmap_set_range (b, 4000, 1);
+
+  /* Give DELTA stale contents, both before and beyond the result.  */
+  bitmap_set_bit (delta, 3);
+  bitmap_set_bit (delta, 9000);
+
+  bitmap_and_compl (expected, b, a);
+  ASSERT_TRUE (bitmap_ior_into_delta (a, b, delta));
+  ASSERT_TRUE (bitmap_equal_p (delta, expected));
+  ASSERT_EQ (10 + 3 + 1, bitmap_count_bits (delta));
+  ASSERT_EQ (20 + 10 + 3 + 5 + 1, bitmap_count_bits (a));
+  ASSERT_FALSE (bitmap_intersect_compl_p (b, a));
+
+  /* Nothing new the second time around.  */
+  ASSERT_FALSE (bitmap_ior_into_delta (a, b, delta));
+  ASSERT_TRUE (bitmap_empty_p (delta));
+}
+
 /* Run all of the selftests within this file.  */
 
 void
@@ -2862,6 +2982,7 @@ bitmap_c_tests ()
   test_clear_bit_in_middle ();
   test_copying ();
   test_bitmap_single_bit_set_p ();
+  test_ior_into_delta ();
 }
 
 } // namespace selftest
@@ -161,6 +161,11 @@ along with GCC; see the file COPYING3.  If not see
      * A | (B & ~C)		: bitmap_ior_and_compl /
 				  bitmap_ior_and_compl_into
 
+   as is the update of a set with the elements it gains, which the
+   points-to solver uses to propagate only what changed:
+
+     * A | B, with B & ~A	: bitmap_ior_into_delta
+
 
    BINARY TREE FORM
    ================
@@ -417,6 +422,7 @@ extern void bitmap_set_range (bitmap, unsigned int, unsigned int);
 extern bool bitmap_ior (bitmap, const_bitmap, const_bitmap);
 extern bool bitmap_ior_into (bitmap, const_bitmap);
 extern bool bitmap_ior_into_and_free (bitmap, bitmap *);
+extern bool bitmap_ior_into_delta (bitmap, const_bitmap, bitmap);
 extern void bitmap_xor (bitmap, const_bitmap, const_bitmap);
 extern void bitmap_xor_into (bitmap, const_bitmap);
 
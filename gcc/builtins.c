@@ -3895,6 +3895,9 @@ expand_builtin_memory_copy_args (tree dest, tree src, tree len,
   len_rtx = expand_normal (len);
   determine_block_size (len, len_rtx, &min_size, &max_size,
 			&probable_max_size);
+  if (currently_expanding_gimple_stmt)
+    stringop_size_profile (currently_expanding_gimple_stmt, min_size,
+			   &probable_max_size);
   src_str = c_getstr (src);
 
   /* If SRC is a string constant and block move would be done by
@@ -4560,6 +4563,9 @@ expand_builtin_memset_args (tree dest, tree val, tree len,
   len_rtx = expand_normal (len);
   determine_block_size (len, len_rtx, &min_size, &max_size,
 			&probable_max_size);
+  if (currently_expanding_gimple_stmt)
+    stringop_size_profile (currently_expanding_gimple_stmt, min_size,
+			   &probable_max_size);
   dest_mem = get_memory_rtx (dest, len);
   val_mode = TYPE_MODE (unsigned_char_type_node);
 
@@ -24,6 +24,11 @@
 #include "c-pragma.h"		/* For parse_in.  */
 #include "file-prefix-map.h"    /* remap_macro_filename()  */
 
+/* The size of the stdio buffer used for the output stream, unless it
+   is a terminal.  Preprocessed output is written in many small pieces,
+   so a larger buffer than the default means far fewer write calls.  */
+#define PP_OUTPUT_BUFFER_SIZE (256 * 1024)
+
 /* Encapsulates state used to convert a stream of tokens into a text
    file.  */
 static struct
@@ -54,6 +59,7 @@ static macro_queue *define_queue, *undef_queue;
 static void scan_translation_unit (cpp_reader *);
 static void print_lines_directives_only (int, const void *, size_t);
 static void scan_translation_unit_directives_only (cpp_reader *);
+static void scan_directives_only_nooutput (cpp_reader *);
 static void scan_translation_unit_trad (cpp_reader *);
 static void account_for_newlines (const unsigned char *, size_t);
 static int dump_macro (cpp_reader *, cpp_hashnode *, void *);
@@ -86,7 +92,11 @@ preprocess_file (cpp_reader *pfile)
 {
   /* A successful cpp_read_main_file guarantees that we can call
      cpp_scan_nooutput or cpp_get_token next.  */
-  if (flag_no_output && pfile->buffer)
+  if (flag_no_output && pfile->buffer
+      && cpp_get_options (pfile)->directives_only
+      && !cpp_get_options (pfile)->preprocessed)
+    scan_directives_only_nooutput (pfile);
+  else if (flag_no_output && pfile->buffer)
     {
       /* Scan -included buffers, then the main file.  */
       while (pfile->buffer->prev)
@@ -154,6 +164,11 @@ init_pp_output (FILE *out_stream)
   cb->get_source_date_epoch = cb_get_source_date_epoch;
   cb->remap_filename = remap_macro_filename;
 
+  /* Nothing has been written to OUT_STREAM yet, so its buffering can
+     still be changed.  */
+  if (!isatty (fileno (out_stream)))
+    setvbuf (out_stream, NULL, _IOFBF, PP_OUTPUT_BUFFER_SIZE);
+
   /* Initialize the print structure.  */
   print.src_line = 1;
   print.printed = false;
@@ -306,6 +321,31 @@ scan_translation_unit_directives_only (cpp_reader *pfile)
   _cpp_preprocess_dir_only (pfile, &cb);
 }
 
+static void
+print_lines_nooutput (int, const void *, size_t)
+{
+}
+
+static bool
+maybe_print_line_nooutput (location_t)
+{
+  return false;
+}
+
+/* Scans the translation unit for -M or -dM with -fdirectives-only:
+   only the directives are processed, and the text in between is
+   skipped without being tokenized.  */
+static void
+scan_directives_only_nooutput (cpp_reader *pfile)
+{
+  struct _cpp_dir_only_callbacks cb;
+
+  cb.print_lines = print_lines_nooutput;
+  cb.maybe_print_line = maybe_print_line_nooutput;
+
+  _cpp_preprocess_dir_only (pfile, &cb);
+}
+
 /* Adjust print.src_line for newlines embedded in output.  */
 static void
 account_for_newlines (const unsigned char *str, size_t len)
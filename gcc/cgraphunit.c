@@ -205,6 +205,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "lto-section-names.h"
 #include "stringpool.h"
 #include "attribs.h"
+#include "tree-inline.h"
 
 /* Queue of cgraph nodes scheduled to be added into cgraph.  This is a
    secondary queue used during optimization to accommodate passes that
@@ -2282,6 +2283,161 @@ node_cmp (const void *pa, const void *pb)
 	 : b->order - a->order;
 }
 
+/* Size, in eni_size_weights units, above which clusters built by
+   call-chain clustering are not merged.  This roughly corresponds to a
+   4k page of code.  */
+#define C3_MAX_CLUSTER_SIZE 1024
+
+/* Size assumed for functions whose body is not in memory.  */
+#define C3_DEFAULT_FUNCTION_SIZE 64
+
+/* A sequence of functions to be output next to each other by call-chain
+   clustering.  */
+
+struct function_cluster
+{
+  /* The functions, in output order.  */
+  auto_vec<cgraph_node *> nodes;
+  /* Sum of the execution counts of the functions.  */
+  gcov_type count;
+  /* Sum of the estimated sizes of the functions.  */
+  int size;
+  /* Position of the first function in the original output order.  */
+  int index;
+};
+
+/* A profiled call from CALLER to CALLEE, executed COUNT times.  */
+
+struct c3_edge
+{
+  cgraph_node *caller;
+  cgraph_node *callee;
+  gcov_type count;
+};
+
+/* Sort call edges by decreasing execution count.  */
+
+static int
+c3_edge_cmp (const void *pa, const void *pb)
+{
+  const c3_edge *a = (const c3_edge *) pa;
+  const c3_edge *b = (const c3_edge *) pb;
+
+  if (a->count != b->count)
+    return a->count > b->count ? -1 : 1;
+  if (a->caller->order != b->caller->order)
+    return a->caller->order - b->caller->order;
+  return a->callee->order - b->callee->order;
+}
+
+/* Sort clusters by decreasing density, keeping the original order among
+   equally dense clusters.  Clusters emptied by merging go last.  */
+
+static int
+function_cluster_cmp (const void *pa, const void *pb)
+{
+  const function_cluster *a = *(const function_cluster * const *) pa;
+  const function_cluster *b = *(const function_cluster * const *) pb;
+
+  if (a->nodes.is_empty () != b->nodes.is_empty ())
+    return a->nodes.is_empty () ? 1 : -1;
+  double da = (double) a->count / MAX (a->size, 1);
+  double db = (double) b->count / MAX (b->size, 1);
+  if (da != db)
+    return da > db ? -1 : 1;
+  return a->index - b->index;
+}
+
+/* Record in EDGES the profiled calls made by the body of ROOT, where NODE
+   is ROOT itself or one of the inline clones in its body.  */
+
+static void
+collect_c3_edges (cgraph_node *root, cgraph_node *node, vec<c3_edge> *edges)
+{
+  for (cgraph_edge *e = node->callees; e; e = e->next_callee)
+    if (!e->inline_failed)
+      collect_c3_edges (root, e->callee, edges);
+    else
+      {
+	profile_count count = e->count.ipa ();
+	cgraph_node *callee = e->callee->ultimate_alias_target ();
+	if (callee != root && count.initialized_p () && count.nonzero_p ())
+	  {
+	    c3_edge edge = { root, callee, count.to_gcov_type () };
+	    edges->safe_push (edge);
+	  }
+      }
+}
+
+/* Reorder the N functions in NODES using call-chain clustering (C3):
+   walk the profiled calls from the hottest one, and append the cluster of
+   the callee to the cluster of the caller unless the result would exceed
+   C3_MAX_CLUSTER_SIZE.  Then output the clusters by decreasing density.
+   NODES is in reverse output order, as in expand_all_functions.  */
+
+static void
+call_chain_clustering (cgraph_node **nodes, int n)
+{
+  hash_map<cgraph_node *, function_cluster *> cluster_of;
+  auto_vec<function_cluster *> clusters (n);
+  auto_vec<c3_edge> edges;
+
+  for (int i = n - 1; i >= 0; i--)
+    {
+      cgraph_node *node = nodes[i];
+      function_cluster *cluster = new function_cluster;
+      profile_count count = node->count.ipa ();
+      cluster->nodes.safe_push (node);
+      cluster->count = count.initialized_p () ? count.to_gcov_type () : 0;
+      cluster->size = (gimple_has_body_p (node->decl)
+		       ? estimate_num_insns_fn (node->decl, &eni_size_weights)
+		       : C3_DEFAULT_FUNCTION_SIZE);
+      cluster->index = clusters.length ();
+      clusters.quick_push (cluster);
+      cluster_of.put (node, cluster);
+      collect_c3_edges (node, node, &edges);
+    }
+
+  edges.qsort (c3_edge_cmp);
+  unsigned i;
+  c3_edge *edge;
+  FOR_EACH_VEC_ELT (edges, i, edge)
+    {
+      function_cluster **callee_slot = cluster_of.get (edge->callee);
+      if (!callee_slot)
+	continue;
+      function_cluster *caller = *cluster_of.get (edge->caller);
+      function_cluster *callee = *callee_slot;
+      if (caller == callee
+	  || caller->size + callee->size > C3_MAX_CLUSTER_SIZE)
+	continue;
+
+      unsigned j;
+      cgraph_node *node;
+      FOR_EACH_VEC_ELT (callee->nodes, j, node)
+	{
+	  caller->nodes.safe_push (node);
+	  cluster_of.put (node, caller);
+	}
+      caller->count += callee->count;
+      caller->size += callee->size;
+      callee->nodes.truncate (0);
+    }
+
+  clusters.qsort (function_cluster_cmp);
+  int pos = n;
+  function_cluster *cluster;
+  FOR_EACH_VEC_ELT (clusters, i, cluster)
+    {
+      unsigned j;
+      cgraph_node *node;
+      FOR_EACH_VEC_ELT (cluster->nodes, j, node)
+	nodes[--pos] = node;
+      delete cluster;
+    }
+  gcc_assert (pos == 0);
+}
+
 /* Expand all functions that must be output.
 
    Attempt to topologically sort the nodes so function is output when
@@ -2290,7 +2446,14 @@ node_cmp (const void *pa, const void *pb)
    between a function and its callees (later we may choose to use a more
    sophisticated algorithm for function reordering; we will likely want
    to use subsections to make the output functions appear in top-down
-   order).  */
+   order).
+
+   Expansion is strictly serial: each cgraph_node::expand runs the whole
+   RTL pipeline against the global cfun, crtl and this_target_* state,
+   allocates from the single GC heap and prints directly to asm_out_file.
+   The supported way to spread the backend of a large unit across cores
+   is therefore -flto with its LTRANS partitions, where every partition is
+   compiled by a separate process.  */
 
 static void
 expand_all_functions (void)
@@ -2311,7 +2474,9 @@ expand_all_functions (void)
     if (order[i]->process)
       order[new_order_pos++] = order[i];
 
-  if (flag_profile_reorder_functions)
+  if (flag_call_chain_clustering)
+    call_chain_clustering (order, new_order_pos);
+  else if (flag_profile_reorder_functions)
     qsort (order, new_order_pos, sizeof (cgraph_node *), node_cmp);
 
   for (i = new_order_pos - 1; i >= 0; i--)
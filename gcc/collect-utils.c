@@ -28,9 +28,13 @@ along with GCC; see the file COPYING3.  If not see
 #include "simple-object.h"
 #include "lto-section-names.h"
 #include "collect-utils.h"
+#include "trace-events.h"
 
 static char *response_file;
 
+/* When the last program was started, for -ftrace-events.  */
+static uint64_t trace_start;
+
 bool debug;
 bool verbose;
 bool save_temps;
@@ -68,6 +72,10 @@ collect_wait (const char *prog, struct pex_obj *pex)
     fatal_error (input_location, "cannot get program status: %m");
   pex_free (pex);
 
+  if (trace_events_enabled_p ())
+    trace_event_complete (TRACE_TRACK_MAIN, lbasename (prog), "program",
+			  trace_start);
+
   if (response_file && !save_temps)
     {
       unlink (response_file);
@@ -178,6 +186,7 @@ collect_execute (const char *prog, char **argv, const char *outname,
   if (argv[0] == 0)
     fatal_error (input_location, "cannot find %qs", prog);
 
+  trace_start = trace_events_now ();
   pex = pex_init (0, "collect2", NULL);
   if (pex == NULL)
     fatal_error (input_location, "%<pex_init%> failed: %m");
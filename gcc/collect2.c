@@ -46,6 +46,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "collect2.h"
 #include "collect2-aix.h"
 #include "collect-utils.h"
+#include "trace-events.h"
 #include "diagnostic.h"
 #include "demangle.h"
 #include "obstack.h"
@@ -962,6 +963,7 @@ main (int argc, char **argv)
   progname = p;
 
   xmalloc_set_program_name (progname);
+  trace_events_init (NULL, "collect2");
 
   old_argv = argv;
   expandargv (&argc, &argv);
@@ -2411,6 +2413,139 @@ is_lto_object_file (const char *prog_name)
   return false;
 }
 
+/* Add NAME, a symbol found in PROG_NAME during WHICH_PASS, to the
+   appropriate list if it is a constructor or destructor name, unless
+   this is a kind of symbol FILTER says we are not supposed to even
+   consider.  */
+
+static void
+scan_symbol (const char *name, const char *prog_name, scanpass which_pass,
+	     scanfilter filter)
+{
+  switch (is_ctor_dtor (name))
+    {
+    case SYM_CTOR:
+      if (! (filter & SCAN_CTOR))
+	break;
+      if (which_pass != PASS_LIB)
+	add_to_list (&constructors, name);
+      break;
+
+    case SYM_DTOR:
+      if (! (filter & SCAN_DTOR))
+	break;
+      if (which_pass != PASS_LIB)
+	add_to_list (&destructors, name);
+      break;
+
+    case SYM_INIT:
+      if (! (filter & SCAN_INIT))
+	break;
+      if (which_pass != PASS_LIB)
+	fatal_error (input_location, "init function found in object %s",
+		     prog_name);
+#ifndef LD_INIT_SWITCH
+      add_to_list (&constructors, name);
+#endif
+      break;
+
+    case SYM_FINI:
+      if (! (filter & SCAN_FINI))
+	break;
+      if (which_pass != PASS_LIB)
+	fatal_error (input_location, "fini function found in object %s",
+		     prog_name);
+#ifndef LD_FINI_SWITCH
+      add_to_list (&destructors, name);
+#endif
+      break;
+
+    case SYM_DWEH:
+      if (! (filter & SCAN_DWEH))
+	break;
+      if (which_pass != PASS_LIB)
+	add_to_list (&frame_tables, name);
+      break;
+
+    default:		/* not a constructor or destructor */
+      break;
+    }
+}
+
+/* Data passed to scan_symbol_callback.  */
+
+struct scan_symbol_data
+{
+  const char *prog_name;
+  scanpass which_pass;
+  scanfilter filter;
+};
+
+/* Called through simple_object_find_symbols for each symbol defined in
+   the program being scanned.  */
+
+static int
+scan_symbol_callback (void *data, const char *name)
+{
+  struct scan_symbol_data *ssd = (struct scan_symbol_data *) data;
+  const char *p;
+
+  if (debug)
+    fprintf (stderr, "\t%s\n", name);
+
+  /* Like the nm output parsing, consider the name from its first
+     underscore on.  */
+  p = strchr (name, '_');
+  if (p)
+    scan_symbol (p, ssd->prog_name, ssd->which_pass, ssd->filter);
+  return 1;
+}
+
+/* Scan the symbol table of PROG_NAME in process rather than running
+   nm over it.  Return false if the symbol table can't be read this way,
+   in which case nm has to be used.  */
+
+static bool
+scan_prog_file_symbols (const char *prog_name, scanpass which_pass,
+			scanfilter filter)
+{
+  struct scan_symbol_data ssd;
+  simple_object_read *inobj;
+  const char *errmsg;
+  int err;
+  int infd;
+
+  infd = open (prog_name, O_RDONLY | O_BINARY);
+  if (infd == -1)
+    return false;
+
+  inobj = simple_object_start_read (infd, 0, LTO_SEGMENT_NAME, &errmsg,
+				    &err);
+  if (!inobj)
+    {
+      close (infd);
+      return false;
+    }
+
+  if (debug)
+    fprintf (stderr, "\nsymbols with constructors/destructors.\n");
+
+  ssd.prog_name = prog_name;
+  ssd.which_pass = which_pass;
+  ssd.filter = filter;
+  errmsg = simple_object_find_symbols (inobj, scan_symbol_callback,
+				       (void *) &ssd, &err);
+  simple_object_release_read (inobj);
+  close (infd);
+
+  if (debug)
+    fprintf (stderr, "\n");
+
+  /* Symbols found before an error are found again by nm, which is
+     harmless as add_to_list drops duplicates.  */
+  return errmsg == NULL;
+}
+
 /* Generic version to scan the name list of the loaded program for
    the symbols g++ uses for static constructors and destructors.  */
 
@@ -2445,6 +2580,10 @@ scan_prog_file (const char *prog_name, scanpass which_pass,
       return;
     }
 
+  /* Read the symbol table directly if we can, saving running nm.  */
+  if (scan_prog_file_symbols (prog_name, which_pass, filter))
+    return;
+
   /* If we do not have an `nm', complain.  */
   if (nm_file_name == 0)
     fatal_error (input_location, "cannot find %<nm%>");
@@ -2530,54 +2669,7 @@ scan_prog_file (const char *prog_name, scanpass which_pass,
 
       *end = '\0';
 
-      switch (is_ctor_dtor (name))
-	{
-	case SYM_CTOR:
-	  if (! (filter & SCAN_CTOR))
-	    break;
-	  if (which_pass != PASS_LIB)
-	    add_to_list (&constructors, name);
-	  break;
-
-	case SYM_DTOR:
-	  if (! (filter & SCAN_DTOR))
-	    break;
-	  if (which_pass != PASS_LIB)
-	    add_to_list (&destructors, name);
-	  break;
-
-	case SYM_INIT:
-	  if (! (filter & SCAN_INIT))
-	    break;
-	  if (which_pass != PASS_LIB)
-	    fatal_error (input_location, "init function found in object %s",
-			 prog_name);
-#ifndef LD_INIT_SWITCH
-	  add_to_list (&constructors, name);
-#endif
-	  break;
-
-	case SYM_FINI:
-	  if (! (filter & SCAN_FINI))
-	    break;
-	  if (which_pass != PASS_LIB)
-	    fatal_error (input_location, "fini function found in object %s",
-			 prog_name);
-#ifndef LD_FINI_SWITCH
-	  add_to_list (&destructors, name);
-#endif
-	  break;
-
-	case SYM_DWEH:
-	  if (! (filter & SCAN_DWEH))
-	    break;
-	  if (which_pass != PASS_LIB)
-	    add_to_list (&frame_tables, name);
-	  break;
-
-	default:		/* not a constructor or destructor */
-	  continue;
-	}
+      scan_symbol (name, prog_name, which_pass, filter);
     }
 
   if (debug)
@@ -1256,6 +1256,7 @@ combine_instructions (rtx_insn *f, unsigned int nregs)
   FOR_EACH_BB_FN (this_basic_block, cfun)
     {
       rtx_insn *last_combined_insn = NULL;
+      int revisits_left = PARAM_VALUE (PARAM_MAX_COMBINE_REVISITS);
 
       /* Ignore instruction combination in basic blocks that are going to
 	 be removed as unreachable anyway.  See PR82386.  */
@@ -1299,6 +1300,20 @@ combine_instructions (rtx_insn *f, unsigned int nregs)
 	     into SUBREGs.  */
 	  note_uses (&PATTERN (insn), record_truncated_values, NULL);
 
+	  /* A combination can return an insn before LAST_COMBINED_INSN
+	     to restart from, which makes us try all the insns up to there
+	     again.  On huge blocks that is quadratic, so bound the number
+	     of such revisits.  */
+	  if (DF_INSN_LUID (insn) < DF_INSN_LUID (last_combined_insn)
+	      && revisits_left-- <= 0)
+	    {
+	      if (revisits_left == -1)
+		statistics_counter_event (cfun, "revisit limit reached", 1);
+	      if (!NOTE_P (insn))
+		record_dead_and_set_regs (insn);
+	      continue;
+	    }
+
 	  /* Try this insn with each insn it links back to.  */
 
 	  FOR_EACH_LOG_LINK (links, insn)
@@ -1435,6 +1435,116 @@ ix86_parse_stringop_strategy_string (char *strategy_str, bool is_memset)
     }
 }
 
+
+/* Costs read from the -mvect-cost-table= file, indexed by the kind of
+   cost, the kind of element (any, integer or floating point) and the
+   size of the vector (any, 128, 256 or 512 bits).  Negative entries
+   are not set, and fall back to the -mtune= costs.  */
+
+int ix86_vect_cost_table[vec_construct + 1][3][4];
+bool ix86_vect_cost_table_p;
+
+static const char *const vect_cost_names[vec_construct + 1] =
+{
+  "scalar_stmt", "scalar_load", "scalar_store", "vector_stmt",
+  "vector_load", "vector_gather_load", "unaligned_load",
+  "unaligned_store", "vector_store", "vector_scatter_store",
+  "vec_to_scalar", "scalar_to_vec", "cond_branch_not_taken",
+  "cond_branch_taken", "vec_perm", "vec_promote_demote", "vec_construct"
+};
+
+/* Read the vectorizer costs from FILENAME, written by
+   contrib/vect-cost-calibrate.c.  Each line is
+
+     KIND [int|fp] [BITS] COST
+
+   where KIND is one of vect_cost_names, int or fp restricts the cost to
+   integer or floating-point elements and BITS to vectors of that size.
+   '#' starts a comment.  */
+
+static void
+ix86_read_vect_cost_table (const char *filename)
+{
+  const char *opt = "-mvect-cost-table=";
+  char line[256];
+  int lineno = 0;
+  FILE *f;
+
+  memset (ix86_vect_cost_table, -1, sizeof (ix86_vect_cost_table));
+
+  f = fopen (filename, "r");
+  if (!f)
+    {
+      error ("cannot open %qs specified for option %qs: %m", filename, opt);
+      return;
+    }
+
+  while (fgets (line, sizeof (line), f))
+    {
+      char *tokens[5];
+      int ntokens = 0, kind, cls = 0, size = 0, i;
+      char *p, *end;
+      long cost;
+
+      lineno++;
+      if ((p = strchr (line, '#')) != NULL)
+	*p = '\0';
+      for (p = strtok (line, " \t\r\n"); p && ntokens < 5;
+	   p = strtok (NULL, " \t\r\n"))
+	tokens[ntokens++] = p;
+      if (ntokens == 0)
+	continue;
+      if (ntokens < 2 || ntokens > 4)
+	{
+	  error ("%s:%d: expected a kind of cost and a cost", filename,
+		 lineno);
+	  break;
+	}
+
+      for (kind = 0; kind <= vec_construct; kind++)
+	if (!strcmp (tokens[0], vect_cost_names[kind]))
+	  break;
+      if (kind > vec_construct)
+	{
+	  error ("%s:%d: unknown kind of cost %qs", filename, lineno,
+		 tokens[0]);
+	  break;
+	}
+
+      for (i = 1; i < ntokens - 1; i++)
+	if (!strcmp (tokens[i], "int") && cls == 0 && size == 0)
+	  cls = 1;
+	else if (!strcmp (tokens[i], "fp") && cls == 0 && size == 0)
+	  cls = 2;
+	else if (!strcmp (tokens[i], "128") && size == 0)
+	  size = 1;
+	else if (!strcmp (tokens[i], "256") && size == 0)
+	  size = 2;
+	else if (!strcmp (tokens[i], "512") && size == 0)
+	  size = 3;
+	else
+	  break;
+      if (i < ntokens - 1)
+	{
+	  error ("%s:%d: unexpected %qs", filename, lineno, tokens[i]);
+	  break;
+	}
+
+      cost = strtol (tokens[ntokens - 1], &end, 10);
+      if (*end || cost < 0 || cost > INT_MAX)
+	{
+	  error ("%s:%d: invalid cost %qs", filename, lineno,
+		 tokens[ntokens - 1]);
+	  break;
+	}
+
+      ix86_vect_cost_table[kind][cls][size] = cost;
+      ix86_vect_cost_table_p = true;
+    }
+
+  fclose (f);
+}
+
 
 /* parse -mtune-ctrl= option. When DUMP is true,
    print the features that are explicitly set.  */
@@ -2791,6 +2901,10 @@ ix86_option_override_internal (bool main_args_p,
       free (str);
     }
 
+  /* Handle -mvect-cost-table=.  */
+  if (main_args_p && opts->x_ix86_vect_cost_table_file)
+    ix86_read_vect_cost_table (opts->x_ix86_vect_cost_table_file);
+
   /* Save the initial options in case the user does function specific
      options.  */
   if (main_args_p)
@@ -64,6 +64,9 @@ enum ix86_function_specific_strings
 
 extern const char *stringop_alg_names[];
 
+extern int ix86_vect_cost_table[][3][4];
+extern bool ix86_vect_cost_table_p;
+
 void ix86_add_new_builtins (HOST_WIDE_INT isa, HOST_WIDE_INT isa2);
 void ix86_function_specific_save (struct cl_target_option *,
 				  struct gcc_options *opts);
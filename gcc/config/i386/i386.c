@@ -5785,6 +5785,16 @@ get_probe_interval (void)
 
 #define SPLIT_STACK_AVAILABLE 256
 
+/* The libgcc allocation routines actually leave at least 1024 bytes
+   below the boundary (BACKOFF in morestack.S), for the dynamic linker
+   and signal handlers.  A leaf function that needs at most this many
+   bytes of stack, including its return address and red zone, may use
+   part of that space instead of checking the boundary: its caller has
+   left at least SPLIT_STACK_AVAILABLE bytes of the rest, and it calls
+   nothing that could use more.  */
+
+#define SPLIT_STACK_LEAF_AVAILABLE 256
+
 /* Fill structure ix86_frame about frame of currently computed function.  */
 
 static void
@@ -9213,6 +9223,26 @@ ix86_split_stack_guard (void)
   return r;
 }
 
+/* Return true if the current function can run without checking the
+   split stack boundary, because it is a leaf function with a small
+   frame of a fixed size.  */
+
+static bool
+ix86_split_stack_leaf_p (void)
+{
+  struct ix86_frame &frame = cfun->machine->frame;
+
+  if (!crtl->is_leaf
+      || cfun->stdarg
+      || cfun->calls_alloca
+      || crtl->stack_realign_needed
+      || crtl->has_nonlocal_goto)
+    return false;
+
+  return (frame.stack_pointer_offset + frame.red_zone_size
+	  <= SPLIT_STACK_LEAF_AVAILABLE);
+}
+
 /* Handle -fsplit-stack.  These are the first instructions in the
    function, even before the regular prologue.  */
 
@@ -9234,6 +9264,9 @@ ix86_expand_split_stack_prologue (void)
   struct ix86_frame &frame = cfun->machine->frame;
   allocate = frame.stack_pointer_offset - INCOMING_FRAME_SP_OFFSET;
 
+  if (ix86_split_stack_leaf_p ())
+    return;
+
   /* This is the label we will branch to if we have enough stack
      space.  We expect the basic block reordering pass to reverse this
      branch if optimizing, so that we branch in the unlikely case.  */
@@ -21068,6 +21101,38 @@ asm_preferred_eh_data_format (int code, int global)
   return DW_EH_PE_absptr;
 }
 
+/* Return the cost of TYPE_OF_COST for VECTYPE given by the
+   -mvect-cost-table= file, or -1 if the file doesn't give one.  The
+   most specific entry for the element kind and vector size wins.  */
+
+static int
+ix86_vect_cost_table_lookup (enum vect_cost_for_stmt type_of_cost,
+			     tree vectype)
+{
+  int cls = 0, size = 0;
+  if (vectype != NULL)
+    {
+      cls = FLOAT_TYPE_P (vectype) ? 2 : 1;
+      if (VECTOR_TYPE_P (vectype))
+	switch (GET_MODE_BITSIZE (TYPE_MODE (vectype)))
+	  {
+	  case 128: size = 1; break;
+	  case 256: size = 2; break;
+	  case 512: size = 3; break;
+	  default: break;
+	  }
+    }
+
+  int (*costs)[4] = ix86_vect_cost_table[type_of_cost];
+  if (costs[cls][size] >= 0)
+    return costs[cls][size];
+  if (costs[cls][0] >= 0)
+    return costs[cls][0];
+  if (costs[0][size] >= 0)
+    return costs[0][size];
+  return costs[0][0];
+}
+
 /* Implement targetm.vectorize.builtin_vectorization_cost.  */
 static int
 ix86_builtin_vectorization_cost (enum vect_cost_for_stmt type_of_cost,
@@ -21082,6 +21147,13 @@ ix86_builtin_vectorization_cost (enum vect_cost_for_stmt type_of_cost,
       mode = TYPE_MODE (vectype);
     }
 
+  if (ix86_vect_cost_table_p)
+    {
+      int cost = ix86_vect_cost_table_lookup (type_of_cost, vectype);
+      if (cost >= 0)
+	return cost;
+    }
+
   switch (type_of_cost)
     {
       case scalar_stmt:
@@ -21569,6 +21641,11 @@ ix86_add_stmt_cost (void *data, int count, enum vect_cost_for_stmt kind,
 	case PLUS_EXPR:
 	case POINTER_PLUS_EXPR:
 	case MINUS_EXPR:
+	  /* These are what the -mvect-cost-table= costs are measured
+	     with.  */
+	  if (ix86_vect_cost_table_p
+	      && (stmt_cost = ix86_vect_cost_table_lookup (kind, vectype)) >= 0)
+	    break;
 	  if (kind == scalar_stmt)
 	    {
 	      if (SSE_FLOAT_MODE_P (mode) && TARGET_SSE_MATH)
@@ -112,6 +112,10 @@ static unsigned bbg_file_stamp;
 /* Name of the count data (gcda) file.  */
 static char *da_file_name;
 
+/* Name of the count data file relative to the profile directory, which
+   is how it is found in a profile database.  */
+static const char *da_file_key;
+
 /* The names of merge functions for counters.  */
 #define STR(str) #str
 #define DEF_GCOV_COUNTER(COUNTER, NAME, FN_TYPE) STR(__gcov_merge ## FN_TYPE),
@@ -180,6 +184,61 @@ counts_entry::remove (counts_entry *entry)
 /* Hash table of count data.  */
 static hash_table<counts_entry> *counts_hash;
 
+/* Open the profile database named by -fprofile-database= and move to
+   the start of the copy of the count data file in it.  Return nonzero
+   on success, or zero if the database has no data for this unit.  */
+
+static int
+open_profile_database (void)
+{
+  gcov_unsigned_t tag, count, ix;
+
+  if (!gcov_open (profile_database_name, 1))
+    {
+      warning (0, "profile database %qs not found", profile_database_name);
+      return 0;
+    }
+
+  if (!gcov_magic (gcov_read_unsigned (), GCOV_DATABASE_MAGIC))
+    {
+      warning (0, "%qs is not a profile database", profile_database_name);
+      gcov_close ();
+      return 0;
+    }
+  else if ((tag = gcov_read_unsigned ()) != GCOV_VERSION)
+    {
+      char v[4], e[4];
+
+      GCOV_UNSIGNED2STRING (v, tag);
+      GCOV_UNSIGNED2STRING (e, GCOV_VERSION);
+
+      warning (0, "%qs is version %q.*s, expected version %q.*s",
+	       profile_database_name, 4, v, 4, e);
+      gcov_close ();
+      return 0;
+    }
+
+  /* The name read is only valid until the next read, so compare it
+     straight away.  */
+  count = gcov_read_unsigned ();
+  for (ix = 0; ix != count && !gcov_is_error (); ix++)
+    {
+      const char *name = gcov_read_string ();
+      int found = name && !strcmp (name, da_file_key);
+      gcov_unsigned_t offset = gcov_read_unsigned ();
+
+      gcov_read_unsigned ();
+      if (found)
+	{
+	  gcov_sync (offset, 0);
+	  return 1;
+	}
+    }
+
+  gcov_close ();
+  return 0;
+}
+
 /* Read in the counts file, if available.  */
 
 static void
@@ -191,7 +250,12 @@ read_counts_file (void)
   unsigned lineno_checksum = 0;
   unsigned cfg_checksum = 0;
 
-  if (!gcov_open (da_file_name, 1))
+  if (profile_database_name)
+    {
+      if (!open_profile_database ())
+	return;
+    }
+  else if (!gcov_open (da_file_name, 1))
     return;
 
   if (!gcov_magic (gcov_read_unsigned (), GCOV_DATA_MAGIC))
@@ -1244,6 +1308,7 @@ coverage_init (const char *filename)
     }
   memcpy (da_file_name + prefix_len, filename, len);
   strcpy (da_file_name + prefix_len + len, GCOV_DATA_SUFFIX);
+  da_file_key = da_file_name + prefix_len;
 
   bbg_file_stamp = local_tick;
   
@@ -1311,6 +1376,7 @@ coverage_finish (void)
 
   XDELETEVEC (da_file_name);
   da_file_name = NULL;
+  da_file_key = NULL;
 }
 
 #include "gt-coverage.h"
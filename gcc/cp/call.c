@@ -147,6 +147,14 @@ struct conversion {
 
 static struct obstack conversion_obstack;
 static bool conversion_obstack_initialized;
+
+/* Statistics about overload resolution, for -fmem-report.  */
+
+static unsigned HOST_WIDE_INT n_overload_resolutions;
+static unsigned HOST_WIDE_INT n_candidates;
+static unsigned HOST_WIDE_INT n_viable_candidates;
+static unsigned HOST_WIDE_INT n_template_candidates;
+static unsigned HOST_WIDE_INT n_jousts;
 struct rejection_reason;
 
 static struct z_candidate * tourney (struct z_candidate *, tsubst_flags_t);
@@ -2112,6 +2120,10 @@ add_candidate (struct z_candidate **candidates,
   cand->flags = flags;
   *candidates = cand;
 
+  n_candidates++;
+  if (viable == 1)
+    n_viable_candidates++;
+
   return cand;
 }
 
@@ -3277,6 +3289,8 @@ add_template_candidate_real (struct z_candidate **candidates, tree tmpl,
   int errs;
   conversion **convs = NULL;
 
+  n_template_candidates++;
+
   /* We don't do deduction on the in-charge parameter, the VTT
      parameter or 'this'.  */
   if (DECL_NONSTATIC_MEMBER_FUNCTION_P (tmpl))
@@ -10730,6 +10744,8 @@ joust (struct z_candidate *cand1, struct z_candidate *cand2, bool warn,
   size_t i;
   size_t len;
 
+  n_jousts++;
+
   /* Candidates that involve bad conversions are always worse than those
      that don't.  */
   if (cand1->viable > cand2->viable)
@@ -11230,6 +11246,8 @@ tourney (struct z_candidate *candidates, tsubst_flags_t complain)
   int fate;
   int champ_compared_to_predecessor = 0;
 
+  n_overload_resolutions++;
+
   /* Walk through the list once, comparing each current champ to the next
      candidate, knocking out a candidate or two with each comparison.  */
 
@@ -11893,4 +11911,18 @@ is_list_ctor (tree decl)
   return true;
 }
 
+/* Print stats about overload resolution for -fmem-report.  */
+
+void
+print_overload_statistics (void)
+{
+  fprintf (stderr, "overload resolution: " HOST_WIDE_INT_PRINT_UNSIGNED
+	   " calls resolved, " HOST_WIDE_INT_PRINT_UNSIGNED " candidates ("
+	   HOST_WIDE_INT_PRINT_UNSIGNED " viable, "
+	   HOST_WIDE_INT_PRINT_UNSIGNED " from templates), "
+	   HOST_WIDE_INT_PRINT_UNSIGNED " comparisons\n",
+	   n_overload_resolutions, n_candidates, n_viable_candidates,
+	   n_template_candidates, n_jousts);
+}
+
 #include "gt-cp-call.h"
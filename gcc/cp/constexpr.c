@@ -142,6 +142,11 @@ struct GTY((for_user)) constexpr_fundef {
   tree body;
   tree parms;
   tree result;
+  /* Number of calls to this function evaluated, for -fmem-report.  */
+  unsigned HOST_WIDE_INT calls;
+  /* Number of those calls for which the body had to be evaluated because
+     no cached result was available.  */
+  unsigned HOST_WIDE_INT evaluations;
 };
 
 struct constexpr_fundef_hasher : ggc_ptr_hash<constexpr_fundef>
@@ -182,7 +187,7 @@ retrieve_constexpr_fundef (tree fun)
   if (constexpr_fundef_table == NULL)
     return NULL;
 
-  constexpr_fundef fundef = { fun, NULL, NULL, NULL };
+  constexpr_fundef fundef = { fun, NULL, NULL, NULL, 0, 0 };
   return constexpr_fundef_table->find (&fundef);
 }
 
@@ -899,6 +904,8 @@ register_constexpr_fundef (tree fun, tree body)
       = hash_table<constexpr_fundef_hasher>::create_ggc (101);
 
   entry.decl = fun;
+  entry.calls = 0;
+  entry.evaluations = 0;
   tree saved_fn = current_function_decl;
   bool clear_ctx = false;
   current_function_decl = fun;
@@ -987,6 +994,9 @@ struct GTY((for_user)) constexpr_call {
   hashval_t hash;
   /* Whether __builtin_is_constant_evaluated() should evaluate to true.  */
   bool manifestly_const_eval;
+  /* The value of constexpr_call_uses when this entry was last looked up,
+     used to evict the least recently used entries.  */
+  unsigned HOST_WIDE_INT last_use;
 };
 
 struct constexpr_call_hasher : ggc_ptr_hash<constexpr_call>
@@ -1061,6 +1071,13 @@ struct constexpr_ctx {
 
 static GTY (()) hash_table<constexpr_call_hasher> *constexpr_call_table;
 
+/* Statistics about CONSTEXPR_CALL_TABLE, for -fmem-report.  The number of
+   lookups also serves as the clock for evicting entries.  */
+
+static unsigned HOST_WIDE_INT constexpr_call_uses;
+static unsigned HOST_WIDE_INT constexpr_call_hits;
+static unsigned HOST_WIDE_INT constexpr_call_evictions;
+
 static tree cxx_eval_constant_expression (const constexpr_ctx *, tree,
 					  bool, bool *, bool *, tree * = NULL);
 
@@ -1099,6 +1116,42 @@ maybe_initialize_constexpr_call_table (void)
     constexpr_call_table = hash_table<constexpr_call_hasher>::create_ggc (101);
 }
 
+/* Callback for evict_constexpr_calls: remove the entry in SLOT if it has a
+   result and was last used before THRESHOLD.  Calls that are still being
+   evaluated stay in the table so that circular dependencies are caught.  */
+
+static int
+maybe_evict_constexpr_call (constexpr_call **slot,
+			    unsigned HOST_WIDE_INT threshold)
+{
+  constexpr_call *entry = *slot;
+  if (entry->result != NULL_TREE && entry->last_use < threshold)
+    {
+      constexpr_call_table->clear_slot (slot);
+      constexpr_call_evictions++;
+    }
+  return 1;
+}
+
+/* If the constexpr call table has reached -fconstexpr-cache-size entries,
+   drop the entries that were least recently used, keeping about half of
+   them.  Evicted results are recomputed if needed again.  */
+
+static void
+maybe_evict_constexpr_calls (void)
+{
+  if (constexpr_cache_size == 0
+      || constexpr_call_table->elements () < (size_t) constexpr_cache_size)
+    return;
+
+  /* Every lookup advances the clock, so at most constexpr_cache_size / 2
+     entries have been used since THRESHOLD.  */
+  unsigned HOST_WIDE_INT threshold
+    = constexpr_call_uses - constexpr_cache_size / 2;
+  constexpr_call_table->traverse_noresize
+    <unsigned HOST_WIDE_INT, maybe_evict_constexpr_call> (threshold);
+}
+
 /* During constexpr CALL_EXPR evaluation, to avoid issues with sharing when
    a function happens to get called recursively, we unshare the callee
    function's body and evaluate this unshared copy instead of evaluating the
@@ -1616,7 +1669,7 @@ cxx_eval_call_expression (const constexpr_ctx *ctx, tree t,
   location_t loc = cp_expr_loc_or_input_loc (t);
   tree fun = get_function_named_in_call (t);
   constexpr_call new_call
-    = { NULL, NULL, NULL, 0, ctx->manifestly_const_eval };
+    = { NULL, NULL, NULL, 0, ctx->manifestly_const_eval, 0 };
   int depth_ok;
 
   if (fun == NULL_TREE)
@@ -1831,6 +1884,8 @@ cxx_eval_call_expression (const constexpr_ctx *ctx, tree t,
         }
     }
 
+  new_call.fundef->calls++;
+
   bool non_constant_args = false;
   cxx_bind_parameters_in_call (ctx, t, &new_call,
 			       non_constant_p, overflow_p, &non_constant_args);
@@ -1886,6 +1941,8 @@ cxx_eval_call_expression (const constexpr_ctx *ctx, tree t,
 
       /* If we have seen this call before, we are done.  */
       maybe_initialize_constexpr_call_table ();
+      maybe_evict_constexpr_calls ();
+      new_call.last_use = ++constexpr_call_uses;
       constexpr_call **slot
 	= constexpr_call_table->find_slot (&new_call, INSERT);
       entry = *slot;
@@ -1913,7 +1970,11 @@ cxx_eval_call_expression (const constexpr_ctx *ctx, tree t,
 	  entry->result = result = error_mark_node;
 	}
       else
-	result = entry->result;
+	{
+	  result = entry->result;
+	  entry->last_use = new_call.last_use;
+	  constexpr_call_hits++;
+	}
     }
 
   if (!depth_ok)
@@ -1943,6 +2004,8 @@ cxx_eval_call_expression (const constexpr_ctx *ctx, tree t,
 	  tree body, parms, res;
 	  releasing_vec ctors;
 
+	  new_call.fundef->evaluations++;
+
 	  /* Reuse or create a new unshared copy of this function's body.  */
 	  tree copy = get_fundef_copy (new_call.fundef);
 	  body = TREE_PURPOSE (copy);
@@ -7329,6 +7392,64 @@ is_nondependent_static_init_expression (tree t)
 	  && !instantiation_dependent_expression_p (t));
 }
 
+/* Comparator for print_constexpr_statistics: sort constexpr functions
+   by decreasing number of evaluations.  */
+
+static int
+fundef_evaluations_cmp (const void *p1, const void *p2)
+{
+  const constexpr_fundef *f1 = *(const constexpr_fundef *const *) p1;
+  const constexpr_fundef *f2 = *(const constexpr_fundef *const *) p2;
+  if (f1->evaluations != f2->evaluations)
+    return f1->evaluations < f2->evaluations ? 1 : -1;
+  if (f1->calls != f2->calls)
+    return f1->calls < f2->calls ? 1 : -1;
+  return DECL_UID (f1->decl) < DECL_UID (f2->decl) ? -1 : 1;
+}
+
+/* The number of constexpr functions listed by print_constexpr_statistics.  */
+#define CONSTEXPR_FUNCTIONS_TO_PRINT 10
+
+/* Print stats about constexpr evaluation for -fmem-report: the call cache,
+   and the functions whose bodies were evaluated most often.  */
+
+void
+print_constexpr_statistics (void)
+{
+  if (constexpr_call_table)
+    fprintf (stderr, "constexpr_call_table: size %ld, %ld elements, "
+	     "%f collisions\n", (long) constexpr_call_table->size (),
+	     (long) constexpr_call_table->elements (),
+	     constexpr_call_table->collisions ());
+  fprintf (stderr, "constexpr calls: " HOST_WIDE_INT_PRINT_UNSIGNED
+	   " lookups, " HOST_WIDE_INT_PRINT_UNSIGNED " found, "
+	   HOST_WIDE_INT_PRINT_UNSIGNED " evicted\n",
+	   constexpr_call_uses, constexpr_call_hits, constexpr_call_evictions);
+
+  if (constexpr_fundef_table == NULL)
+    return;
+
+  auto_vec<constexpr_fundef *> fundefs;
+  for (hash_table<constexpr_fundef_hasher>::iterator it
+	 = constexpr_fundef_table->begin ();
+       it != constexpr_fundef_table->end (); ++it)
+    if ((*it)->calls)
+      fundefs.safe_push (*it);
+  fundefs.qsort (fundef_evaluations_cmp);
+
+  unsigned i;
+  constexpr_fundef *fundef;
+  FOR_EACH_VEC_ELT (fundefs, i, fundef)
+    {
+      if (i == CONSTEXPR_FUNCTIONS_TO_PRINT)
+	break;
+      fprintf (stderr, "  %-50s " HOST_WIDE_INT_PRINT_UNSIGNED " calls, "
+	       HOST_WIDE_INT_PRINT_UNSIGNED " evaluated\n",
+	       lang_decl_name (fundef->decl, 2, false),
+	       fundef->calls, fundef->evaluations);
+    }
+}
+
 /* Finalize constexpr processing after parsing.  */
 
 void
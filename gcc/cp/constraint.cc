@@ -2770,6 +2770,61 @@ equivalently_constrained (tree d1, tree d2)
                      Partial ordering of constraints
 ---------------------------------------------------------------------------*/
 
+/* Hash functions for subsumption entries.  The normal forms of the
+   constraints of declarations are cached, so they are compared by
+   identity.  */
+
+struct GTY((for_user)) subsumption_entry
+{
+  tree lhs;
+  tree rhs;
+  bool result;
+};
+
+struct subsumption_hasher : ggc_ptr_hash<subsumption_entry>
+{
+  static hashval_t hash (subsumption_entry *e)
+  {
+    hashval_t value = htab_hash_pointer (e->lhs);
+    return iterative_hash_hashval_t (htab_hash_pointer (e->rhs), value);
+  }
+
+  static bool equal (subsumption_entry *e1, subsumption_entry *e2)
+  {
+    return e1->lhs == e2->lhs && e1->rhs == e2->rhs;
+  }
+};
+
+/* Cache the result of subsumes for the normal forms of declarations'
+   constraints.  This is cleared by GC along with NORMALIZED_MAP, which
+   keeps those normal forms alive.  */
+static GTY((deletable)) hash_table<subsumption_hasher> *subsumption_cache;
+
+/* Like subsumes, but using SUBSUMPTION_CACHE.  LHS and RHS must be the
+   cached normal forms of declarations' constraints.  */
+
+static bool
+cached_subsumes (tree lhs, tree rhs)
+{
+  if (lhs == rhs || !lhs || !rhs)
+    return subsumes (lhs, rhs);
+
+  if (!subsumption_cache)
+    subsumption_cache = hash_table<subsumption_hasher>::create_ggc (31);
+  subsumption_entry elt = { lhs, rhs, false };
+  subsumption_entry **slot = subsumption_cache->find_slot (&elt, INSERT);
+  if (*slot)
+    return (*slot)->result;
+
+  elt.result = subsumes (lhs, rhs);
+  /* Evaluating the subsumption does not touch the table, so SLOT is still
+     valid.  */
+  subsumption_entry *entry = ggc_alloc<subsumption_entry> ();
+  *entry = elt;
+  *slot = entry;
+  return elt.result;
+}
+
 /* Returns true when the the constraints in A subsume those in B.  */
 
 bool
@@ -2818,9 +2873,9 @@ more_constrained (tree d1, tree d2)
   tree n2 = get_normalized_constraints_from_decl (d2);
 
   int winner = 0;
-  if (subsumes (n1, n2))
+  if (cached_subsumes (n1, n2))
     ++winner;
-  if (subsumes (n2, n1))
+  if (cached_subsumes (n2, n1))
     --winner;
   return winner;
 }
@@ -6157,6 +6157,7 @@ extern int raw_dump_id;
 
 /* in call.c */
 extern bool check_dtor_name			(tree, tree);
+extern void print_overload_statistics		(void);
 int magic_varargs_p				(tree);
 
 extern tree build_conditional_expr		(const op_location_t &,
@@ -6737,6 +6738,7 @@ extern void inject_this_parameter (tree, cp_cv_quals);
 extern location_t defparse_location (tree);
 extern void maybe_show_extern_c_location (void);
 extern bool literal_integer_zerop (const_tree);
+extern void print_parser_statistics		(void);
 
 /* in pt.c */
 extern void push_access_scope			(tree);
@@ -7775,6 +7777,7 @@ extern void vtv_build_vtable_verify_fndecl      (void);
 
 /* In constexpr.c */
 extern void fini_constexpr			(void);
+extern void print_constexpr_statistics		(void);
 extern bool literal_type_p                      (tree);
 extern tree register_constexpr_fundef           (tree, tree);
 extern bool is_valid_constexpr_fn		(tree, bool);
@@ -55,6 +55,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "stor-layout.h"
 #include "flags.h"
 #include "attribs.h"
+#include "params.h"
 
 /* Debugging support.  */
 
@@ -121,6 +122,15 @@ struct GTY(()) globals {
 
 static GTY (()) globals G;
 
+/* An index of the substitution candidates in G.substitutions, mapping
+   each candidate to its position so that find_substitution need not
+   compare against every candidate.  A type is entered under its
+   canonical type and anything else under itself.  The positions of
+   candidates that can only be matched by a structural comparison are
+   kept in SUBSTITUTION_UNINDEXED instead.  */
+static hash_map<tree, int> *substitution_index;
+static vec<int> substitution_unindexed;
+
 /* The obstack on which we build mangled names.  */
 static struct obstack *mangle_obstack;
 
@@ -428,6 +438,21 @@ canonicalize_for_substitution (tree node)
   return node;
 }
 
+/* Return the key under which the substitution candidate NODE is entered
+   in SUBSTITUTION_INDEX, or NULL_TREE if NODE must be compared
+   structurally.  */
+
+static tree
+substitution_key (tree node)
+{
+  if (TREE_CODE (node) == TREE_LIST)
+    return NULL_TREE;
+  if (TYPE_P (node))
+    return (USE_CANONICAL_TYPES && !TYPE_STRUCTURAL_EQUALITY_P (node)
+	    ? TYPE_CANONICAL (node) : NULL_TREE);
+  return node;
+}
+
 /* Add NODE as a substitution candidate.  NODE must not already be on
    the list of candidates.  */
 
@@ -464,6 +489,17 @@ add_substitution (tree node)
   /* Put the decl onto the varray of substitution candidates.  */
   vec_safe_push (G.substitutions, node);
 
+  int ix = G.substitutions->length () - 1;
+  if (tree key = substitution_key (node))
+    {
+      bool existed;
+      int &slot = substitution_index->get_or_insert (key, &existed);
+      if (!existed)
+	slot = ix;
+    }
+  else
+    substitution_unindexed.safe_push (ix);
+
   if (DEBUG_MANGLE)
     dump_substitution_candidates ();
 }
@@ -551,6 +587,61 @@ is_std_substitution_char (const tree node,
     && TREE_VEC_ELT (args, 0) == char_type_node;
 }
 
+/* Return true if the substitution CANDIDATE matches the canonicalized
+   NODE, whose name is DECL and whose type is TYPE.  */
+
+static bool
+substitution_matches_p (tree node, tree decl, tree type, tree candidate)
+{
+  /* NODE is a matched to a candidate if it's the same decl node or
+     if it's the same type.  */
+  return (decl == candidate
+	  || (TYPE_P (candidate) && type && TYPE_P (node)
+	      && same_type_p (type, candidate))
+	  || NESTED_TEMPLATE_MATCH (node, candidate));
+}
+
+/* Return the position of the first substitution candidate that matches
+   the canonicalized NODE, whose name is DECL and whose type is TYPE, or
+   -1 if there is none.  */
+
+static int
+lookup_substitution (tree node, tree decl, tree type)
+{
+  const int size = vec_safe_length (G.substitutions);
+  int i, best = -1;
+
+  /* If same_type_p cannot use canonical types, compare against all the
+     candidates.  */
+  if (comparing_specializations
+      || (TYPE_P (node) && !substitution_key (node)))
+    {
+      for (i = 0; i < size; ++i)
+	if (substitution_matches_p (node, decl, type, (*G.substitutions)[i]))
+	  return i;
+      return -1;
+    }
+
+  if (decl)
+    if (int *slot = substitution_index->get (decl))
+      best = *slot;
+  if (TYPE_P (node))
+    if (int *slot = substitution_index->get (TYPE_CANONICAL (node)))
+      if (best < 0 || *slot < best)
+	best = *slot;
+
+  /* An earlier candidate that is not in the index may match too.  */
+  unsigned ix;
+  FOR_EACH_VEC_ELT (substitution_unindexed, ix, i)
+    {
+      if (best >= 0 && i > best)
+	break;
+      if (substitution_matches_p (node, decl, type, (*G.substitutions)[i]))
+	return i;
+    }
+  return best;
+}
+
 /* Check whether a substitution should be used to represent NODE in
    the mangling.
 
@@ -588,8 +679,6 @@ is_std_substitution_char (const tree node,
 static int
 find_substitution (tree node)
 {
-  int i;
-  const int size = vec_safe_length (G.substitutions);
   tree decl;
   tree type;
   const char *abbr = NULL;
@@ -681,15 +770,10 @@ find_substitution (tree node)
     tags = get_abi_tags (type);
   /* Now check the list of available substitutions for this mangling
      operation.  */
-  if (!abbr || tags) for (i = 0; i < size; ++i)
+  if (!abbr || tags)
     {
-      tree candidate = (*G.substitutions)[i];
-      /* NODE is a matched to a candidate if it's the same decl node or
-	 if it's the same type.  */
-      if (decl == candidate
-	  || (TYPE_P (candidate) && type && TYPE_P (node)
-	      && same_type_p (type, candidate))
-	  || NESTED_TEMPLATE_MATCH (node, candidate))
+      int i = lookup_substitution (node, decl, type);
+      if (i >= 0)
 	{
 	  write_substitution (i);
 	  return 1;
@@ -3740,6 +3824,8 @@ finish_mangling_internal (void)
 {
   /* Clear all the substitutions.  */
   vec_safe_truncate (G.substitutions, 0);
+  substitution_index->empty ();
+  substitution_unindexed.truncate (0);
 
   /* Null-terminate the string.  */
   write_char ('\0');
@@ -3774,6 +3860,7 @@ init_mangle (void)
   gcc_obstack_init (&name_obstack);
   name_base = obstack_alloc (&name_obstack, 0);
   vec_alloc (G.substitutions, 0);
+  substitution_index = new hash_map<tree, int>;
 
   /* Cache these identifiers for quick comparison when checking for
      standard substitutions.  */
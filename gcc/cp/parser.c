@@ -1918,6 +1918,19 @@ static cp_parser_context *cp_parser_context_new
 
 static GTY((deletable)) cp_parser_context* cp_parser_context_free_list;
 
+/* Statistics about tentative parsing, for -fmem-report: the number of
+   tentative parses, how many of them failed, how many tokens were rolled
+   back by the failures, and how often a template-id, nested-name-specifier
+   or decltype saved in the token stream by an earlier tentative parse was
+   reused instead of being parsed again.  */
+
+static unsigned HOST_WIDE_INT n_tentative_parses;
+static unsigned HOST_WIDE_INT n_failed_tentative_parses;
+static unsigned HOST_WIDE_INT n_rolled_back_tokens;
+static unsigned HOST_WIDE_INT n_reparsed_template_ids;
+static unsigned HOST_WIDE_INT n_reparsed_nested_name_specifiers;
+static unsigned HOST_WIDE_INT n_reparsed_decltypes;
+
 /* The operator-precedence table used by cp_parser_binary_expression.
    Transformed into an associative array (binops_by_token) by
    cp_parser_new.  */
@@ -14709,6 +14722,7 @@ cp_parser_decltype (cp_parser *parser)
   if (start_token->type == CPP_DECLTYPE)
     {
       /* Already parsed.  */
+      n_reparsed_decltypes++;
       cp_lexer_consume_token (parser->lexer);
       return saved_checks_value (start_token->u.tree_check_value);
     }
@@ -16381,6 +16395,7 @@ cp_parser_template_id (cp_parser *parser,
 
   if (token->type == CPP_TEMPLATE_ID)
     {
+      n_reparsed_template_ids++;
       cp_lexer_consume_token (parser->lexer);
       return saved_checks_value (token->u.tree_check_value);
     }
@@ -30518,6 +30533,7 @@ cp_parser_pre_parsed_nested_name_specifier (cp_parser *parser)
 {
   struct tree_check *check_value;
 
+  n_reparsed_nested_name_specifiers++;
   /* Get the stored value.  */
   check_value = cp_lexer_consume_token (parser->lexer)->u.tree_check_value;
   /* Set the scope from the stored value.  */
@@ -30794,6 +30810,7 @@ defparse_location (tree default_argument)
 static void
 cp_parser_parse_tentatively (cp_parser* parser)
 {
+  n_tentative_parses++;
   /* Enter a new parsing context.  */
   parser->context = cp_parser_context_new (parser->context);
   /* Begin saving tokens.  */
@@ -30895,7 +30912,12 @@ cp_parser_parse_definitely (cp_parser* parser)
      are just as they were before we began the tentative parse.  */
   else
     {
-      cp_lexer_rollback_tokens (parser->lexer);
+      cp_lexer *lexer = parser->lexer;
+      n_failed_tentative_parses++;
+      if (lexer->next_token != &eof_token)
+	n_rolled_back_tokens
+	  += lexer->next_token - lexer->saved_tokens.last ();
+      cp_lexer_rollback_tokens (lexer);
       pop_deferring_access_checks ();
     }
   /* Add the context to the front of the free list.  */
@@ -30925,6 +30947,24 @@ cp_parser_error_occurred (cp_parser* parser)
 	  && parser->context->status == CP_PARSER_STATUS_KIND_ERROR);
 }
 
+/* Print stats about tentative parsing for -fmem-report.  */
+
+void
+print_parser_statistics (void)
+{
+  fprintf (stderr, "tentative parses: " HOST_WIDE_INT_PRINT_UNSIGNED
+	   " started, " HOST_WIDE_INT_PRINT_UNSIGNED " failed, "
+	   HOST_WIDE_INT_PRINT_UNSIGNED " tokens rolled back\n",
+	   n_tentative_parses, n_failed_tentative_parses,
+	   n_rolled_back_tokens);
+  fprintf (stderr, "reused from earlier tentative parses: "
+	   HOST_WIDE_INT_PRINT_UNSIGNED " template-ids, "
+	   HOST_WIDE_INT_PRINT_UNSIGNED " nested-name-specifiers, "
+	   HOST_WIDE_INT_PRINT_UNSIGNED " decltypes\n",
+	   n_reparsed_template_ids, n_reparsed_nested_name_specifiers,
+	   n_reparsed_decltypes);
+}
+
 /* Returns nonzero if GNU extensions are allowed.  */
 
 static bool
@@ -114,6 +114,16 @@ static GTY (()) hash_table<spec_hasher> *decl_specializations;
 
 static GTY (()) hash_table<spec_hasher> *type_specializations;
 
+/* Statistics for -fmem-report on how often an existing specialization
+   was found rather than a new one built, and how many function and
+   variable definitions were instantiated.  */
+
+static unsigned long decl_specialization_lookups;
+static unsigned long decl_specialization_hits;
+static unsigned long type_specialization_lookups;
+static unsigned long type_specialization_hits;
+static unsigned long instantiated_definitions;
+
 /* Contains canonical template parameter types. The vector is indexed by
    the TEMPLATE_TYPE_IDX of the template parameter. Each element is a
    TREE_LIST, whose TREE_VALUEs contain the canonical template
@@ -1273,6 +1283,11 @@ retrieve_specialization (tree tmpl, tree args, hashval_t hash)
       if (hash == 0)
 	hash = spec_hasher::hash (&elt);
       found = specializations->find_with_hash (&elt, hash);
+      if (GATHER_STATISTICS && specializations == decl_specializations)
+	{
+	  decl_specialization_lookups++;
+	  decl_specialization_hits += found != NULL;
+	}
       if (found)
 	return found->spec;
     }
@@ -9636,6 +9651,11 @@ lookup_template_class_1 (tree d1, tree arglist, tree in_decl, tree context,
       elt.spec = NULL_TREE;
       hash = spec_hasher::hash (&elt);
       entry = type_specializations->find_with_hash (&elt, hash);
+      if (GATHER_STATISTICS)
+	{
+	  type_specialization_lookups++;
+	  type_specialization_hits += entry != NULL;
+	}
 
       if (entry)
 	return entry->spec;
@@ -25093,6 +25113,8 @@ instantiate_decl (tree d, bool defer_ok, bool expl_inst_class_mem_p)
   /* Mark D as instantiated so that recursive calls to
      instantiate_decl do not try to instantiate it again.  */
   DECL_TEMPLATE_INSTANTIATED (d) = 1;
+  if (GATHER_STATISTICS)
+    instantiated_definitions++;
 
   /* Regenerate the declaration in case the template has been modified
      by a subsequent redeclaration.  */
@@ -28682,6 +28704,15 @@ print_template_statistics (void)
 	   "%f collisions\n", (long) type_specializations->size (),
 	   (long) type_specializations->elements (),
 	   type_specializations->collisions ());
+  if (GATHER_STATISTICS)
+    {
+      fprintf (stderr, "decl_specializations: %lu lookups, %lu found\n",
+	       decl_specialization_lookups, decl_specialization_hits);
+      fprintf (stderr, "type_specializations: %lu lookups, %lu found\n",
+	       type_specialization_lookups, type_specialization_hits);
+      fprintf (stderr, "instantiated definitions: %lu\n",
+	       instantiated_definitions);
+    }
 }
 
 #if CHECKING_P
@@ -1052,6 +1052,55 @@ lookup_field_r (tree binfo, void *data)
   return NULL_TREE;
 }
 
+/* An entry in MEMBER_LOOKUP_CACHE: the result of walking the bases of
+   BINFO with lookup_field_r for NAME and WANT_TYPE.  */
+
+struct GTY((for_user)) member_lookup_entry
+{
+  tree binfo;
+  tree name;
+  bool want_type;
+  tree rval;
+  tree rval_binfo;
+  tree ambiguous;
+  const char * GTY((skip)) errstr;
+};
+
+struct member_lookup_hasher : ggc_ptr_hash<member_lookup_entry>
+{
+  static hashval_t hash (member_lookup_entry *e)
+  {
+    hashval_t value = htab_hash_pointer (e->binfo);
+    value = iterative_hash_hashval_t (htab_hash_pointer (e->name), value);
+    return iterative_hash_hashval_t (e->want_type, value);
+  }
+
+  static bool equal (member_lookup_entry *e1, member_lookup_entry *e2)
+  {
+    return (e1->binfo == e2->binfo
+	    && e1->name == e2->name
+	    && e1->want_type == e2->want_type);
+  }
+};
+
+/* Cache of the walks done by lookup_member through the bases of complete
+   classes, whose members can no longer change.  */
+static GTY((deletable)) hash_table<member_lookup_hasher> *member_lookup_cache;
+
+/* Return true if the result of looking up NAME in the bases of TYPE may
+   be cached.  The implicitly declared special member functions are left
+   out, since looking for them declares them lazily.  */
+
+static bool
+member_lookup_cacheable_p (tree type, tree name)
+{
+  return (COMPLETE_TYPE_P (type)
+	  && !TYPE_BEING_DEFINED (type)
+	  && !dependent_type_p (type)
+	  && !IDENTIFIER_CDTOR_P (name)
+	  && name != assign_op_identifier);
+}
+
 /* Return a "baselink" with BASELINK_BINFO, BASELINK_ACCESS_BINFO,
    BASELINK_FUNCTIONS, and BASELINK_OPTYPE set to BINFO, ACCESS_BINFO,
    FUNCTIONS, and OPTYPE respectively.  */
@@ -1144,7 +1193,39 @@ lookup_member (tree xbasetype, tree name, int protect, bool want_type,
   lfi.type = type;
   lfi.name = name;
   lfi.want_type = want_type;
-  dfs_walk_all (basetype_path, &lookup_field_r, NULL, &lfi);
+
+  member_lookup_entry elt = { basetype_path, name, want_type,
+			      NULL_TREE, NULL_TREE, NULL_TREE, NULL };
+  member_lookup_entry **slot = NULL;
+  if (member_lookup_cacheable_p (type, name))
+    {
+      if (!member_lookup_cache)
+	member_lookup_cache
+	  = hash_table<member_lookup_hasher>::create_ggc (127);
+      slot = member_lookup_cache->find_slot (&elt, INSERT);
+    }
+  if (slot && *slot)
+    {
+      lfi.rval = (*slot)->rval;
+      lfi.rval_binfo = (*slot)->rval_binfo;
+      lfi.ambiguous = (*slot)->ambiguous;
+      lfi.errstr = (*slot)->errstr;
+    }
+  else
+    {
+      dfs_walk_all (basetype_path, &lookup_field_r, NULL, &lfi);
+      if (slot)
+	{
+	  /* Look up the slot again, in case the walk added to the table.  */
+	  slot = member_lookup_cache->find_slot (&elt, INSERT);
+	  elt.rval = lfi.rval;
+	  elt.rval_binfo = lfi.rval_binfo;
+	  elt.ambiguous = lfi.ambiguous;
+	  elt.errstr = lfi.errstr;
+	  *slot = ggc_alloc<member_lookup_entry> ();
+	  **slot = elt;
+	}
+    }
   rval = lfi.rval;
   rval_binfo = lfi.rval_binfo;
   if (rval_binfo)
@@ -2690,3 +2771,5 @@ any_dependent_bases_p (tree type)
 
   return false;
 }
+
+#include "gt-cp-search.h"
@@ -2826,7 +2826,10 @@ extern int depth_reached;
 void
 cxx_print_statistics (void)
 {
+  print_parser_statistics ();
   print_template_statistics ();
+  print_constexpr_statistics ();
+  print_overload_statistics ();
   if (GATHER_STATISTICS)
     fprintf (stderr, "maximum template instantiation depth reached: %d\n",
 	     depth_reached);
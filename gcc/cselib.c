@@ -33,6 +33,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "cselib.h"
 #include "params.h"
 #include "function-abi.h"
+#include "swiss-table.h"
 
 /* A list of cselib_val structures.  */
 struct elt_list
@@ -136,10 +137,10 @@ cselib_hasher::equal (const cselib_val *v, const key *x_arg)
 }
 
 /* A table that enables us to look up elts by their value.  */
-static hash_table<cselib_hasher> *cselib_hash_table;
+static swiss_hash_table<cselib_hasher> *cselib_hash_table;
 
 /* A table to hold preserved values.  */
-static hash_table<cselib_hasher> *cselib_preserved_hash_table;
+static swiss_hash_table<cselib_hasher> *cselib_preserved_hash_table;
 
 /* This is a global so we don't have to pass this through every function.
    It is used in new_elt_loc_list to set SETTING_INSN.  */
@@ -2853,12 +2854,12 @@ cselib_init (int record_what)
   n_used_regs = 0;
   /* FIXME: enable sanitization (PR87845) */
   cselib_hash_table
-    = new hash_table<cselib_hasher> (31, /* ggc */ false,
-				     /* sanitize_eq_and_hash */ false);
+    = new swiss_hash_table<cselib_hasher> (31, /* ggc */ false,
+					   /* sanitize_eq_and_hash */ false);
   if (cselib_preserve_constants)
     cselib_preserved_hash_table
-      = new hash_table<cselib_hasher> (31, /* ggc */ false,
-				       /* sanitize_eq_and_hash */ false);
+      = new swiss_hash_table<cselib_hasher> (31, /* ggc */ false,
+					     /* sanitize_eq_and_hash */ false);
   next_uid = 1;
 }
 
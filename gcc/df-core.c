@@ -1142,6 +1142,37 @@ df_prune_to_subcfg (int list[], unsigned len, bitmap blocks)
 }
 
 
+/* Names of the problems, indexed by df_problem_id, for dumps.  */
+
+static const char *const df_problem_names[DF_LAST_PROBLEM_PLUS1] =
+{
+  "scan", "lr", "live", "rd", "chain", "word_lr", "note", "md", "mir"
+};
+
+/* Record how many of the BLOCKS_TO_CONSIDER have their local information
+   recomputed by DFLOW because their transfer functions are out of date,
+   and how many reuse it.  */
+
+static void
+df_record_local_recompute (struct dataflow *dflow, bitmap blocks_to_consider)
+{
+  if (!dflow->out_of_date_transfer_functions)
+    return;
+
+  auto_bitmap dirty (&df_bitmap_obstack);
+  bitmap_and (dirty, dflow->out_of_date_transfer_functions,
+	      blocks_to_consider);
+  int recomputed = bitmap_count_bits (dirty);
+  int reused = bitmap_count_bits (blocks_to_consider) - recomputed;
+
+  statistics_counter_event (cfun, "df blocks recomputed", recomputed);
+  statistics_counter_event (cfun, "df blocks reused", reused);
+  if (dump_file)
+    fprintf (dump_file, "df_analyze_problem %s: %d blocks recomputed,"
+	     " %d reused\n", df_problem_names[dflow->problem->id],
+	     recomputed, reused);
+}
+
 /* Execute dataflow analysis on a single dataflow problem.
 
    BLOCKS_TO_CONSIDER are the blocks whose solution can either be
@@ -1156,6 +1187,8 @@ df_analyze_problem (struct dataflow *dflow,
 {
   timevar_push (dflow->problem->tv_id);
 
+  df_record_local_recompute (dflow, blocks_to_consider);
+
   /* (Re)Allocate the datastructures necessary to solve the problem.  */
   if (dflow->problem->alloc_fun)
     dflow->problem->alloc_fun (blocks_to_consider);
@@ -162,6 +162,89 @@ default_diagnostic_final_cb (diagnostic_context *context)
     }
 }
 
+/* The key identifying a warning for -fdiagnostics-deduplicate: its
+   location, the option controlling it and the (untranslated or
+   translated, but in either case unformatted) message.  */
+
+struct diagnostic_dedup_key
+{
+  location_t loc;
+  int option_index;
+  const char *format_spec;
+};
+
+struct diagnostic_dedup_hash_traits
+  : typed_noop_remove<diagnostic_dedup_key>
+{
+  typedef diagnostic_dedup_key value_type;
+  typedef diagnostic_dedup_key compare_type;
+
+  static hashval_t hash (const value_type &x)
+  {
+    inchash::hash hstate;
+    hstate.add_int (x.loc);
+    hstate.add_int (x.option_index);
+    hstate.add_ptr (x.format_spec);
+    return hstate.end ();
+  }
+
+  static bool equal (const value_type &x, const compare_type &y)
+  {
+    return (x.loc == y.loc
+	    && x.option_index == y.option_index
+	    && x.format_spec == y.format_spec);
+  }
+
+  static void mark_deleted (value_type &x)
+  {
+    x.format_spec = "";
+  }
+
+  static void mark_empty (value_type &x)
+  {
+    x.format_spec = NULL;
+  }
+
+  static bool is_deleted (const value_type &x)
+  {
+    return x.format_spec && !*x.format_spec;
+  }
+
+  static bool is_empty (const value_type &x)
+  {
+    return x.format_spec == NULL;
+  }
+};
+
+class diagnostic_dedup_set
+  : public hash_set<diagnostic_dedup_key, false, diagnostic_dedup_hash_traits>
+{
+};
+
+/* Return true if DIAGNOSTIC, about to be issued as a warning, repeats
+   one already issued and should be dropped, and record it otherwise.  */
+
+static bool
+diagnostic_duplicate_warning_p (diagnostic_context *context,
+				diagnostic_info *diagnostic)
+{
+  diagnostic_dedup_key key;
+  key.loc = diagnostic_location (diagnostic);
+  key.option_index = diagnostic->option_index;
+  key.format_spec = diagnostic->message.format_spec;
+  if (key.loc == UNKNOWN_LOCATION
+      || key.format_spec == NULL || *key.format_spec == '\0')
+    return false;
+
+  if (!context->dedup_set)
+    context->dedup_set = new diagnostic_dedup_set;
+  if (!context->dedup_set->add (key))
+    return false;
+
+  context->dedup_suppressed_count++;
+  return true;
+}
+
 /* Initialize the diagnostic message outputting machinery.  */
 void
 diagnostic_initialize (diagnostic_context *context, int n_opts)
@@ -193,6 +276,9 @@ diagnostic_initialize (diagnostic_context *context, int n_opts)
   context->dc_inhibit_warnings = false;
   context->dc_warn_system_headers = false;
   context->max_errors = 0;
+  context->deduplicate_warnings_p = false;
+  context->dedup_set = NULL;
+  context->dedup_suppressed_count = 0;
   context->internal_error = NULL;
   diagnostic_starter (context) = default_diagnostic_starter;
   context->start_span = default_diagnostic_start_span_fn;
@@ -265,11 +351,22 @@ diagnostic_urls_init (diagnostic_context *context, int value /*= -1 */)
 void
 diagnostic_finish (diagnostic_context *context)
 {
+  if (context->dedup_suppressed_count)
+    {
+      pp_verbatim (context->printer,
+		   _("%s: %d duplicate warnings were not shown"),
+		   progname, context->dedup_suppressed_count);
+      pp_newline_and_flush (context->printer);
+    }
+
   if (context->final_cb)
     context->final_cb (context);
 
   diagnostic_file_cache_fini ();
 
+  delete context->dedup_set;
+  context->dedup_set = NULL;
+
   XDELETEVEC (context->classify_diagnostic);
   context->classify_diagnostic = NULL;
 
@@ -1013,6 +1110,14 @@ diagnostic_report_diagnostic (diagnostic_context *context,
 	return false;
     }
 
+  /* Drop a repeated warning before anything is formatted, so that
+     e.g. the instantiation context of a warning in a template isn't
+     printed again for every instantiation.  */
+  if (context->deduplicate_warnings_p
+      && diagnostic->kind == DK_WARNING
+      && diagnostic_duplicate_warning_p (context, diagnostic))
+    return false;
+
   if (diagnostic->kind != DK_NOTE)
     diagnostic_check_max_errors (context);
 
@@ -158,6 +158,18 @@ struct diagnostic_context
   /* Maximum number of errors to report.  */
   int max_errors;
 
+  /* True if a warning with the same location, option and message
+     format as an earlier one should be dropped without being
+     formatted, as for the same problem in many template
+     instantiations.  */
+  bool deduplicate_warnings_p;
+
+  /* The warnings issued so far, if DEDUPLICATE_WARNINGS_P.  */
+  class diagnostic_dedup_set *dedup_set;
+
+  /* The number of warnings dropped as duplicates.  */
+  int dedup_suppressed_count;
+
   /* This function is called before any message is printed out.  It is
      responsible for preparing message prefix and such.  For example, it
      might say:
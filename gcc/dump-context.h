@@ -121,6 +121,8 @@ class dump_context
   void emit_item (optinfo_item *item, dump_flags_t dump_kind);
 
   bool apply_dump_filter_p (dump_flags_t dump_kind, dump_flags_t filter) const;
+  bool below_min_hotness_p (const dump_user_location_t &loc) const;
+  bool cold_p () const { return m_cold; }
 
  private:
   optinfo &ensure_pending_optinfo (const dump_metadata_t &metadata);
@@ -135,6 +137,11 @@ class dump_context
      if any.  */
   optinfo *m_pending;
 
+  /* Whether the location of the message being dumped is executed fewer
+     times than -fopt-info-min-hotness=, so that the message is left out
+     of the -fopt-info output.  */
+  bool m_cold;
+
   /* If -fsave-optimization-record is enabled, the heap-allocated JSON writer
      instance, otherwise NULL.  */
   optrecord_json_writer *m_json_writer;
@@ -88,7 +88,7 @@ set_alt_dump_file (FILE *new_alt_dump_file)
 
 #define DUMP_FILE_INFO(suffix, swtch, dkind, num) \
   {suffix, swtch, NULL, NULL, NULL, NULL, NULL, dkind, TDF_NONE, TDF_NONE, \
-   OPTGROUP_NONE, 0, 0, num, false, false}
+   OPTGROUP_NONE, 0, 0, num, false, false, NULL, NULL, NULL}
 
 /* Table of tree dump switches. This must be consistent with the
    TREE_DUMP_INDEX enumeration in dumpfile.h.  */
@@ -139,6 +139,7 @@ static const kv_pair<dump_flags_t> dump_options[] =
   {"scev", TDF_SCEV},
   {"gimple", TDF_GIMPLE},
   {"folding", TDF_FOLDING},
+  {"zstd", TDF_ZSTD},
   {"optimized", MSG_OPTIMIZED_LOCATIONS},
   {"missed", MSG_MISSED_OPTIMIZATION},
   {"note", MSG_NOTE},
@@ -146,7 +147,8 @@ static const kv_pair<dump_flags_t> dump_options[] =
   {"all", dump_flags_t (TDF_ALL_VALUES
 			& ~(TDF_RAW | TDF_SLIM | TDF_LINENO | TDF_GRAPH
 			    | TDF_STMTADDR | TDF_RHS_ONLY | TDF_NOUID
-			    | TDF_ENUMERATE_LOCALS | TDF_SCEV | TDF_GIMPLE))},
+			    | TDF_ENUMERATE_LOCALS | TDF_SCEV | TDF_GIMPLE
+			    | TDF_ZSTD))},
   {NULL, TDF_NONE}
 };
 
@@ -204,6 +206,7 @@ gcc::dump_manager::~dump_manager ()
       /* These, if non-NULL, are always dynamically allocated.  */
       XDELETEVEC (const_cast <char *> (dfi->pfilename));
       XDELETEVEC (const_cast <char *> (dfi->alt_filename));
+      XDELETEVEC (const_cast <char *> (dfi->functions));
     }
   XDELETEVEC (m_extra_dump_files);
 }
@@ -401,6 +404,117 @@ dump_open_alternate_stream (struct dump_file_info *dfi)
   return stream;
 }
 
+/* Return a stream for the dump FILENAME of DFI, which has TDF_ZSTD,
+   whose output is compressed by zstd into FILENAME.zst.  The zstd
+   process is started on the first open, and is then kept running and
+   reused for the rest of the compilation, rather than started again
+   each time the dump is appended to.  */
+
+static FILE *
+dump_open_zstd (struct dump_file_info *dfi, const char *filename)
+{
+  if (dfi->zstd_stream)
+    return dfi->zstd_stream;
+
+  char *outname = concat (filename, ".zst", NULL);
+  const char *argv[] = { "zstd", "-q", "-c", NULL };
+  const char *errmsg;
+  int err = 0;
+
+  struct pex_obj *pex = pex_init (PEX_USE_PIPES, "zstd", NULL);
+  FILE *stream = pex_input_pipe (pex, false);
+  if (!stream)
+    errmsg = "pex_input_pipe";
+  else
+    errmsg = pex_run (pex, PEX_LAST | PEX_SEARCH, argv[0],
+		      CONST_CAST (char **, argv), outname, NULL, &err);
+  if (errmsg)
+    {
+      if (err)
+	errno = err;
+      error ("could not start %<zstd%> for dump file %qs: %s: %m",
+	     outname, errmsg);
+      if (stream)
+	fclose (stream);
+      pex_free (pex);
+      stream = NULL;
+    }
+  else
+    {
+      dfi->zstd_pex = pex;
+      dfi->zstd_stream = stream;
+    }
+
+  free (outname);
+  return stream;
+}
+
+/* Close the stream to the zstd process of DFI, if any, and wait for it
+   to finish writing the compressed dump.  */
+
+static void
+dump_finish_zstd (struct dump_file_info *dfi)
+{
+  int status;
+
+  if (!dfi->zstd_stream)
+    return;
+
+  fclose (dfi->zstd_stream);
+  if (!pex_get_status (dfi->zstd_pex, 1, &status) || status != 0)
+    error ("%<zstd%> failed to compress a dump file");
+  pex_free (dfi->zstd_pex);
+  dfi->zstd_stream = NULL;
+  dfi->zstd_pex = NULL;
+}
+
+/* Return true if DFI dumps the current function: if it wasn't limited
+   to some functions with -fdump-<switch>=func:<names>, or the name or
+   assembler name of the function is one of those.  */
+
+static bool
+dump_function_selected_p (const struct dump_file_info *dfi)
+{
+  if (!dfi->functions)
+    return true;
+  if (!current_function_decl)
+    return false;
+
+  tree decl = current_function_decl;
+  const char *name = (DECL_NAME (decl)
+		      ? IDENTIFIER_POINTER (DECL_NAME (decl)) : NULL);
+  const char *asmname = (DECL_ASSEMBLER_NAME_SET_P (decl)
+			 ? IDENTIFIER_POINTER (DECL_ASSEMBLER_NAME (decl))
+			 : NULL);
+
+  const char *p = dfi->functions;
+  while (true)
+    {
+      const char *end = strchr (p, ',');
+      size_t len = end ? (size_t) (end - p) : strlen (p);
+      if ((name && strlen (name) == len && !memcmp (name, p, len))
+	  || (asmname && strlen (asmname) == len && !memcmp (asmname, p, len)))
+	return true;
+      if (!end)
+	return false;
+      p = end + 1;
+    }
+}
+
+/* Open the pass-specific dump FILENAME for DFI, compressing it if
+   asked for.  PART is as for dump_begin.  */
+
+static FILE *
+dump_open_pass_stream (struct dump_file_info *dfi, const char *filename,
+		       int part)
+{
+  /* A command-line provided file name may be shared by several dumps,
+     and may be a standard stream, so is never compressed.  */
+  if ((dfi->pflags & TDF_ZSTD) && !dfi->pfilename && part == -1)
+    return dump_open_zstd (dfi, filename);
+  return dump_open (filename, part != -1 || dfi->pstate < 0);
+}
+
 /* Construct a dump_user_location_t from STMT (using its location and
    hotness).  */
 
@@ -577,6 +691,19 @@ dump_context::apply_dump_filter_p (dump_flags_t dump_kind,
 	  && dump_kind & (filter & MSG_ALL_PRIORITIES));
 }
 
+/* Return true if LOC is executed fewer times than -fopt-info-min-hotness=,
+   or is not known to be executed at all when a minimum is given.  */
+
+bool
+dump_context::below_min_hotness_p (const dump_user_location_t &loc) const
+{
+  if (!flag_opt_info_min_hotness)
+    return false;
+  profile_count count = loc.get_count ();
+  return (!count.initialized_p ()
+	  || count.to_gcov_type () < flag_opt_info_min_hotness);
+}
+
 /* Print LOC to the appropriate dump destinations, given DUMP_KIND.
    If optinfos are enabled, begin a new optinfo.  */
 
@@ -600,11 +727,19 @@ dump_context::dump_loc_immediate (dump_flags_t dump_kind,
 {
   location_t srcloc = loc.get_location_t ();
 
+  m_cold = below_min_hotness_p (loc);
+
   if (dump_file && apply_dump_filter_p (dump_kind, pflags))
     ::dump_loc (dump_kind, dump_file, srcloc);
 
-  if (alt_dump_file && apply_dump_filter_p (dump_kind, alt_flags))
-    ::dump_loc (dump_kind, alt_dump_file, srcloc);
+  if (alt_dump_file && !m_cold && apply_dump_filter_p (dump_kind, alt_flags))
+    {
+      ::dump_loc (dump_kind, alt_dump_file, srcloc);
+      /* With a minimum hotness, show how hot each message is.  */
+      if (flag_opt_info_min_hotness)
+	fprintf (alt_dump_file, "[hotness %" PRId64 "] ",
+		 (int64_t) loc.get_count ().to_gcov_type ());
+    }
 
   /* Support for temp_dump_context in selftests.  */
   if (m_test_pp && apply_dump_filter_p (dump_kind, m_test_pp_flags))
@@ -1106,10 +1241,12 @@ dump_context::begin_scope (const char *name,
 
   location_t src_loc = user_location.get_location_t ();
 
+  m_cold = below_min_hotness_p (user_location);
+
   if (dump_file && apply_dump_filter_p (MSG_NOTE, pflags))
     ::dump_loc (MSG_NOTE, dump_file, src_loc);
 
-  if (alt_dump_file && apply_dump_filter_p (MSG_NOTE, alt_flags))
+  if (alt_dump_file && !m_cold && apply_dump_filter_p (MSG_NOTE, alt_flags))
     ::dump_loc (MSG_NOTE, alt_dump_file, src_loc);
 
   /* Support for temp_dump_context in selftests.  */
@@ -1203,8 +1340,11 @@ dump_context::end_any_optinfo ()
 void
 dump_context::emit_optinfo (const optinfo *info)
 {
-  /* -fsave-optimization-record.  */
-  if (m_json_writer)
+  /* -fsave-optimization-record.  Scopes are always kept, as the records
+     within them are nested in them.  */
+  if (m_json_writer
+      && (info->get_kind () == OPTINFO_KIND_SCOPE
+	  || !below_min_hotness_p (info->get_user_location ())))
     m_json_writer->add_record (info);
 }
 
@@ -1217,7 +1357,7 @@ dump_context::emit_item (optinfo_item *item, dump_flags_t dump_kind)
   if (dump_file && apply_dump_filter_p (dump_kind, pflags))
     fprintf (dump_file, "%s", item->get_text ());
 
-  if (alt_dump_file && apply_dump_filter_p (dump_kind, alt_flags))
+  if (alt_dump_file && !m_cold && apply_dump_filter_p (dump_kind, alt_flags))
     fprintf (alt_dump_file, "%s", item->get_text ());
 
   /* Support for temp_dump_context in selftests.  */
@@ -1370,6 +1510,7 @@ dump_dec (dump_flags_t dump_kind, const poly_wide_int &value, signop sgn)
     print_dec (value, dump_file, sgn);
 
   if (alt_dump_file
+      && !dump_context::get ().cold_p ()
       && dump_context::get ().apply_dump_filter_p (dump_kind, alt_flags))
     print_dec (value, alt_dump_file, sgn);
 }
@@ -1385,6 +1526,7 @@ dump_hex (dump_flags_t dump_kind, const poly_wide_int &value)
     print_hex (value, dump_file);
 
   if (alt_dump_file
+      && !dump_context::get ().cold_p ()
       && dump_context::get ().apply_dump_filter_p (dump_kind, alt_flags))
     print_hex (value, alt_dump_file);
 }
@@ -1457,9 +1599,14 @@ dump_start (int phase, dump_flags_t *flag_ptr)
 
   dfi = get_dump_file_info (phase);
   name = get_dump_file_name (phase);
+  if (name && !dump_function_selected_p (dfi))
+    {
+      free (name);
+      name = NULL;
+    }
   if (name)
     {
-      stream = dump_open (name, dfi->pstate < 0);
+      stream = dump_open_pass_stream (dfi, name, -1);
       if (stream)
         {
           dfi->pstate = 1;
@@ -1500,7 +1647,8 @@ dump_finish (int phase)
   if (phase < 0)
     return;
   dfi = get_dump_file_info (phase);
-  if (dfi->pstream && dfi->pstream != stdout && dfi->pstream != stderr)
+  if (dfi->pstream && dfi->pstream != stdout && dfi->pstream != stderr
+      && dfi->pstream != dfi->zstd_stream)
     fclose (dfi->pstream);
 
   if (dfi->alt_stream && dfi->alt_stream != stdout && dfi->alt_stream != stderr)
@@ -1539,14 +1687,16 @@ dump_begin (int phase, dump_flags_t *flag_ptr, int part)
   if (phase == TDI_none || !dump_phase_enabled_p (phase))
     return NULL;
 
+  dfi = get_dump_file_info (phase);
+  if (!dump_function_selected_p (dfi))
+    return NULL;
   name = get_dump_file_name (phase, part);
   if (!name)
     return NULL;
-  dfi = get_dump_file_info (phase);
 
   /* We do not support re-opening of dump files with parts.  This would require
      tracking pstate per part of the dump file.  */
-  stream = dump_open (name, part != -1 || dfi->pstate < 0);
+  stream = dump_open_pass_stream (dfi, name, part);
   if (stream)
     dfi->pstate = 1;
   free (name);
@@ -1650,18 +1800,35 @@ gcc::dump_manager::register_pass (opt_pass *pass)
     {
       pass_dfi->pstate = tdi_dfi->pstate;
       pass_dfi->pflags = tdi_dfi->pflags;
+      if (tdi_dfi->functions)
+	pass_dfi->functions = xstrdup (tdi_dfi->functions);
     }
 
   update_dfi_for_opt_info (pass_dfi);
 }
 
+/* Wait for the zstd processes of the TDF_ZSTD dumps to finish.  */
+
+void
+gcc::dump_manager::finish_compressed_dumps ()
+{
+  size_t i;
+
+  for (i = TDI_none + 1; i < (size_t) TDI_end; i++)
+    dump_finish_zstd (&dump_files[i]);
+  for (i = 0; i < m_extra_dump_files_in_use; i++)
+    dump_finish_zstd (&m_extra_dump_files[i]);
+}
+
 /* Finish a tree dump for PHASE. STREAM is the stream created by
    dump_begin.  */
 
 void
-dump_end (int phase ATTRIBUTE_UNUSED, FILE *stream)
+dump_end (int phase, FILE *stream)
 {
-  if (stream != stderr && stream != stdout)
+  struct dump_file_info *dfi = g->get_dumps ()->get_dump_file_info (phase);
+  if (stream != stderr && stream != stdout
+      && (!dfi || stream != dfi->zstd_stream))
     fclose (stream);
 }
 
@@ -1670,7 +1837,8 @@ dump_end (int phase ATTRIBUTE_UNUSED, FILE *stream)
 
 int
 gcc::dump_manager::
-dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename)
+dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename,
+		 const char *functions)
 {
   int n = 0;
   size_t i;
@@ -1693,6 +1861,11 @@ dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename)
             }
           if (old_filename && filename != old_filename)
             free (CONST_CAST (char *, old_filename));
+	  if (functions && functions != dump_files[i].functions)
+	    {
+	      free (CONST_CAST (char *, dump_files[i].functions));
+	      dump_files[i].functions = xstrdup (functions);
+	    }
         }
     }
 
@@ -1714,6 +1887,11 @@ dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename)
             }
           if (old_filename && filename != old_filename)
             free (CONST_CAST (char *, old_filename));
+	  if (functions && functions != m_extra_dump_files[i].functions)
+	    {
+	      free (CONST_CAST (char *, m_extra_dump_files[i].functions));
+	      m_extra_dump_files[i].functions = xstrdup (functions);
+	    }
         }
     }
 
@@ -1860,7 +2038,16 @@ dump_switch_p_1 (const char *arg, struct dump_file_info *dfi, bool doglob)
 
   const char *filename;
   flags = parse_dump_option (option_value, &filename);
-  if (filename)
+  /* =func:<names> limits the dump to those functions rather than
+     naming the file.  */
+  const char *functions = filename ? skip_leading_substring (filename, "func:")
+			  : NULL;
+  if (functions)
+    {
+      free (CONST_CAST (char *, dfi->functions));
+      dfi->functions = xstrdup (functions);
+    }
+  else if (filename)
     {
       if (dfi->pfilename)
   free (CONST_CAST (char *, dfi->pfilename));
@@ -1873,7 +2060,8 @@ dump_switch_p_1 (const char *arg, struct dump_file_info *dfi, bool doglob)
   /* Process -fdump-tree-all and -fdump-rtl-all, by enabling all the
      known dumps.  */
   if (dfi->suffix == NULL)
-    dump_enable_all (dfi->dkind, dfi->pflags, dfi->pfilename);
+    dump_enable_all (dfi->dkind, dfi->pflags, dfi->pfilename,
+		     dfi->functions);
 
   return 1;
 }
@@ -2028,6 +2216,7 @@ dump_basic_block (dump_flags_t dump_kind, basic_block bb, int indent)
       && dump_context::get ().apply_dump_filter_p (dump_kind, pflags))
     dump_bb (dump_file, bb, indent, TDF_DETAILS);
   if (alt_dump_file
+      && !dump_context::get ().cold_p ()
       && dump_context::get ().apply_dump_filter_p (dump_kind, alt_flags))
     dump_bb (alt_dump_file, bb, indent, TDF_DETAILS);
 }
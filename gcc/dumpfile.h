@@ -193,11 +193,14 @@ enum dump_flag
   /* Dumping for -fcompare-debug.  */
   TDF_COMPARE_DEBUG = (1 << 28),
 
+  /* Compress the dump file with zstd.  */
+  TDF_ZSTD = (1 << 29),
+
   /* For error.  */
   TDF_ERROR = (1 << 26),
 
   /* All values.  */
-  TDF_ALL_VALUES = (1 << 29) - 1
+  TDF_ALL_VALUES = (1 << 30) - 1
 };
 
 /* Dump flags type.  */
@@ -318,6 +321,13 @@ struct dump_file_info
   /* When a given dump file is being initialized, this flag is set to true
      if the corresponding TDF_graph dump file has also been initialized.  */
   bool graph_dump_initialized;
+  /* If non-NULL, the comma-separated names of the only functions to
+     dump, from -fdump-<switch>=func:<names>.  */
+  const char *functions;
+  /* For TDF_ZSTD, the zstd process compressing the pass-specific dump,
+     and the pipe to it, which are kept open for the whole compilation.  */
+  struct pex_obj *zstd_pex;
+  FILE *zstd_stream;
 };
 
 /* A class for describing where in the user's source that a dump message
@@ -720,6 +730,10 @@ public:
 
   void register_pass (opt_pass *pass);
 
+  /* Wait for the compression of any TDF_ZSTD dumps to finish.  */
+  void
+  finish_compressed_dumps ();
+
 private:
 
   int
@@ -729,7 +743,8 @@ private:
   dump_switch_p_1 (const char *arg, struct dump_file_info *dfi, bool doglob);
 
   int
-  dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename);
+  dump_enable_all (dump_kind dkind, dump_flags_t flags, const char *filename,
+		   const char *functions = NULL);
 
   int
   opt_info_enable_passes (optgroup_flags_t optgroup_flags, dump_flags_t flags,
@@ -9059,19 +9059,88 @@ static vec<unsigned int> abbrev_usage_count;
 /* Vector of all DIEs added with die_abbrev >= abbrev_opt_start.  */
 static vec<dw_die_ref> sorted_abbrev_dies;
 
+/* Hashtable helpers for finding the abbreviation of a DIE.  Two DIEs
+   share an abbreviation if they have the same tag, both have children
+   or neither has, and their attributes have the same names and forms
+   in the same order.  The table holds indices into abbrev_die_table.  */
+
+struct abbrev_hasher : int_hash <unsigned int, 0, -1U>
+{
+  typedef const die_struct *compare_type;
+  static inline hashval_t hash (unsigned int);
+  static inline hashval_t hash (const die_struct *);
+  static inline bool equal (unsigned int, const die_struct *);
+};
+
+inline hashval_t
+abbrev_hasher::hash (unsigned int abbrev_id)
+{
+  return hash ((*abbrev_die_table)[abbrev_id]);
+}
+
+inline hashval_t
+abbrev_hasher::hash (const die_struct *die)
+{
+  inchash::hash hstate;
+  dw_attr_node *a;
+  unsigned ix;
+
+  hstate.add_int (die->die_tag);
+  hstate.add_flag (die->die_child != NULL);
+  FOR_EACH_VEC_SAFE_ELT (die->die_attr, ix, a)
+    {
+      hstate.add_int (a->dw_attr);
+      hstate.add_int (value_format (a));
+    }
+  return hstate.end ();
+}
+
+inline bool
+abbrev_hasher::equal (unsigned int abbrev_id, const die_struct *die)
+{
+  dw_die_ref abbrev = (*abbrev_die_table)[abbrev_id];
+  dw_attr_node *die_a, *abbrev_a;
+  unsigned ix;
+
+  if (abbrev->die_tag != die->die_tag)
+    return false;
+  if ((abbrev->die_child != NULL) != (die->die_child != NULL))
+    return false;
+
+  if (vec_safe_length (abbrev->die_attr) != vec_safe_length (die->die_attr))
+    return false;
+
+  FOR_EACH_VEC_SAFE_ELT (die->die_attr, ix, die_a)
+    {
+      abbrev_a = &(*abbrev->die_attr)[ix];
+      if ((abbrev_a->dw_attr != die_a->dw_attr)
+	  || (value_format (abbrev_a) != value_format (die_a)))
+	return false;
+    }
+  return true;
+}
+
+/* Index of the entries of abbrev_die_table, to avoid comparing each DIE
+   with every abbreviation.  It only lives during build_abbrev_table,
+   because the forms of existing abbreviations can change between units,
+   for instance when optimize_abbrev_table uses DW_FORM_implicit_const
+   or when indirect string decisions are reset for the fat part of an
+   LTO object.  */
+
+static hash_table<abbrev_hasher> *abbrev_hash_table;
+
 /* The format of each DIE (and its attribute value pairs) is encoded in an
    abbreviation table.  This routine builds the abbreviation table and assigns
    a unique abbreviation id for each abbreviation entry.  The children of each
    die are visited recursively.  */
 
 static void
-build_abbrev_table (dw_die_ref die, external_ref_hash_type *extern_map)
+build_abbrev_table_1 (dw_die_ref die, external_ref_hash_type *extern_map)
 {
   unsigned int abbrev_id = 0;
   dw_die_ref c;
   dw_attr_node *a;
   unsigned ix;
-  dw_die_ref abbrev;
 
   /* Scan the DIE references, and replace any that refer to
      DIEs from other CUs (i.e. those which are not marked) with
@@ -9095,38 +9164,15 @@ build_abbrev_table (dw_die_ref die, external_ref_hash_type *extern_map)
 	  set_AT_ref_external (a, 1);
       }
 
-  FOR_EACH_VEC_SAFE_ELT (abbrev_die_table, abbrev_id, abbrev)
-    {
-      dw_attr_node *die_a, *abbrev_a;
-      unsigned ix;
-      bool ok = true;
-
-      if (abbrev_id == 0)
-	continue;
-      if (abbrev->die_tag != die->die_tag)
-	continue;
-      if ((abbrev->die_child != NULL) != (die->die_child != NULL))
-	continue;
-
-      if (vec_safe_length (abbrev->die_attr) != vec_safe_length (die->die_attr))
-	continue;
-
-      FOR_EACH_VEC_SAFE_ELT (die->die_attr, ix, die_a)
-	{
-	  abbrev_a = &(*abbrev->die_attr)[ix];
-	  if ((abbrev_a->dw_attr != die_a->dw_attr)
-	      || (value_format (abbrev_a) != value_format (die_a)))
-	    {
-	      ok = false;
-	      break;
-	    }
-	}
-      if (ok)
-	break;
-    }
-
-  if (abbrev_id >= vec_safe_length (abbrev_die_table))
+  unsigned int *slot
+    = abbrev_hash_table->find_slot_with_hash (die, abbrev_hasher::hash (die),
+					      INSERT);
+  if (*slot)
+    abbrev_id = *slot;
+  else
     {
+      abbrev_id = vec_safe_length (abbrev_die_table);
+      *slot = abbrev_id;
       vec_safe_push (abbrev_die_table, die);
       if (abbrev_opt_start)
 	abbrev_usage_count.safe_push (0);
@@ -9138,7 +9184,37 @@ build_abbrev_table (dw_die_ref die, external_ref_hash_type *extern_map)
     }
 
   die->die_abbrev = abbrev_id;
-  FOR_EACH_CHILD (die, c, build_abbrev_table (c, extern_map));
+  FOR_EACH_CHILD (die, c, build_abbrev_table_1 (c, extern_map));
+}
+
+/* Build the abbreviations for DIE and its children, indexing the
+   existing abbreviations first.  */
+
+static void
+build_abbrev_table (dw_die_ref die, external_ref_hash_type *extern_map)
+{
+  unsigned int abbrev_id;
+
+  abbrev_hash_table
+    = new hash_table<abbrev_hasher> (vec_safe_length (abbrev_die_table) + 64);
+  /* Keep the lowest numbered of any identical abbreviations, which is
+     the one a search of the table would find first.  */
+  for (abbrev_id = 1; abbrev_id < vec_safe_length (abbrev_die_table);
+       abbrev_id++)
+    {
+      dw_die_ref abbrev = (*abbrev_die_table)[abbrev_id];
+      unsigned int *slot
+	= abbrev_hash_table->find_slot_with_hash (abbrev,
+						  abbrev_hasher::hash (abbrev),
+						  INSERT);
+      if (!*slot)
+	*slot = abbrev_id;
+    }
+
+  build_abbrev_table_1 (die, extern_map);
+
+  delete abbrev_hash_table;
+  abbrev_hash_table = NULL;
 }
 
 /* Callback function for sorted_abbrev_dies vector sorting.  We sort
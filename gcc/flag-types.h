@@ -222,6 +222,13 @@ enum vect_cost_model {
   VECT_COST_MODEL_DEFAULT = 3
 };
 
+/* Vector math library whose functions may be used as simd clones of
+   math builtins.  */
+enum veclib {
+  VECLIB_NONE = 0,
+  VECLIB_LIBMVEC
+};
+
 /* Different instrumentation modes.  */
 enum sanitize_code {
   /* AddressSanitizer.  */
@@ -299,7 +306,8 @@ enum lto_partition_model {
   LTO_PARTITION_ONE = 1,
   LTO_PARTITION_BALANCED = 2,
   LTO_PARTITION_1TO1 = 3,
-  LTO_PARTITION_MAX = 4
+  LTO_PARTITION_MAX = 4,
+  LTO_PARTITION_CLUSTER = 5
 };
 
 /* flag_lto_linker_output initialization values.  */
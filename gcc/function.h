@@ -303,6 +303,10 @@ struct GTY(()) function {
   unsigned int curr_properties;
   unsigned int last_verified;
 
+  /* CPU time in microseconds the pass manager has spent on this function,
+     counted only with --param max-function-compile-time.  */
+  HOST_WIDE_INT compile_time;
+
   /* Non-null if the function does something that would prevent it from
      being copied; this applies to both versioning and inlining.  Set to
      a string describing the reason for failure.  */
@@ -397,6 +401,11 @@ struct GTY(()) function {
   /* Set when the function was compiled with generation of debug
      (begin stmt, inline entry, ...) markers enabled.  */
   unsigned int debug_nonbind_markers : 1;
+
+  /* Nonzero if the function has used up the time allowed by
+     --param max-function-compile-time, so that expensive optional
+     passes should use cheaper modes or be skipped.  */
+  unsigned int compile_budget_exceeded : 1;
 };
 
 /* Add the decl D to the local_decls list of FUN.  */
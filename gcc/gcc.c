@@ -44,6 +44,7 @@ compilation is specified by a string called a "spec".  */
 #include "params.h"
 #include "filenames.h"
 #include "spellcheck.h"
+#include "trace-events.h"
 
 
 
@@ -3021,6 +3022,31 @@ add_sysrooted_hdrs_prefix (struct path_prefix *pprefix, const char *prefix,
 
    Return 0 if successful, -1 if failed.  */
 
+/* Record in the event trace that PROG, run with ARGV, ran from START
+   until now.  ARGV[0] may have been freed already.  */
+
+static void
+trace_program (const char *prog, const char **argv, uint64_t start)
+{
+  size_t len = strlen (prog) + 1;
+  int i;
+
+  for (i = 1; argv[i]; i++)
+    len += strlen (argv[i]) + 1;
+
+  char *command = XNEWVEC (char, len);
+  char *p = stpcpy (command, prog);
+  for (i = 1; argv[i]; i++)
+    {
+      *p++ = ' ';
+      p = stpcpy (p, argv[i]);
+    }
+
+  trace_event_complete (TRACE_TRACK_MAIN, lbasename (prog), "program", start,
+			"command", command);
+  free (command);
+}
+
 static int
 execute (void)
 {
@@ -3194,6 +3220,7 @@ execute (void)
 
   /* Run each piped subprocess.  */
 
+  uint64_t trace_start = trace_events_now ();
   pex = pex_init (PEX_USE_PIPES | ((report_times || report_times_to_file)
 				   ? PEX_RECORD_TIMES : 0),
 		  progname, temp_filename);
@@ -3237,6 +3264,10 @@ execute (void)
     if (!pex_get_status (pex, n_commands, statuses))
       fatal_error (input_location, "failed to get exit status: %m");
 
+    if (trace_events_enabled_p ())
+      for (i = 0; i < n_commands; ++i)
+	trace_program (commands[i].prog, commands[i].argv, trace_start);
+
     if (report_times || report_times_to_file)
       {
 	times = (struct pex_time *) alloca (n_commands * sizeof (struct pex_time));
@@ -4189,6 +4220,11 @@ driver_handle_option (struct gcc_options *opts,
       do_save = false;
       break;
 
+    case OPT_ftrace_events_:
+      /* Start the trace here, so that the programs run add to it.  */
+      trace_events_init (arg, progname);
+      break;
+
     case OPT_time_:
       if (report_times_to_file)
 	fclose (report_times_to_file);
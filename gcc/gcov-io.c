@@ -35,6 +35,9 @@ static const gcov_unsigned_t *gcov_read_words (unsigned);
 #if !IN_LIBGCOV
 static void gcov_allocate (unsigned);
 #endif
+#if IN_GCOV
+static void gcov_read_whole_file (void);
+#endif
 
 /* Optimum number of gcov_unsigned_t's read from or written to disk.  */
 #define GCOV_BLOCK_SIZE (1 << 10)
@@ -61,6 +64,12 @@ struct gcov_var
   size_t alloc;
   gcov_unsigned_t *buffer;
 #endif
+#if IN_GCOV
+  /* Nonzero if the whole file is in BUFFER, which is then mapped from
+     the file if MAPPED is nonzero.  */
+  int whole;
+  size_t mapped;
+#endif
 } gcov_var;
 
 /* Save the current position in the gcov file.  */
@@ -194,6 +203,13 @@ gcov_open (const char *name, int mode)
 
   setbuf (gcov_var.file, (char *)0);
 
+#if IN_GCOV
+  gcov_var.whole = 0;
+  gcov_var.mapped = 0;
+  if (gcov_var.mode > 0)
+    gcov_read_whole_file ();
+#endif
+
   return 1;
 }
 
@@ -213,6 +229,17 @@ gcov_close (void)
       gcov_var.file = 0;
       gcov_var.length = 0;
     }
+#if IN_GCOV && defined (HAVE_MMAP_FILE)
+  if (gcov_var.mapped)
+    {
+      munmap ((void *) gcov_var.buffer, gcov_var.mapped);
+      gcov_var.buffer = 0;
+    }
+#endif
+#if IN_GCOV
+  gcov_var.whole = 0;
+  gcov_var.mapped = 0;
+#endif
 #if !IN_LIBGCOV
   free (gcov_var.buffer);
   gcov_var.alloc = 0;
@@ -259,6 +286,45 @@ gcov_allocate (unsigned length)
 }
 #endif
 
+#if IN_GCOV
+/* Get all of the file opened for reading into the buffer at once,
+   mapping it if possible, instead of reading it one block at a time.
+   The tools read every record anyway.  If the size of the file cannot
+   be determined, leave it to gcov_read_words.  */
+
+static void
+gcov_read_whole_file (void)
+{
+  struct stat status;
+  size_t words;
+
+  if (fstat (fileno (gcov_var.file), &status)
+      || !S_ISREG (status.st_mode)
+      || status.st_size < 4
+      || (off_t) (size_t) status.st_size != status.st_size)
+    return;
+  words = (size_t) status.st_size >> 2;
+
+#ifdef HAVE_MMAP_FILE
+  void *map = mmap (NULL, status.st_size, PROT_READ, MAP_PRIVATE,
+		    fileno (gcov_var.file), 0);
+  if (map != MAP_FAILED)
+    {
+      gcov_var.buffer = (gcov_unsigned_t *) map;
+      gcov_var.mapped = status.st_size;
+      gcov_var.length = words;
+      gcov_var.whole = 1;
+      return;
+    }
+#endif
+
+  gcov_allocate (words);
+  gcov_var.length = fread (gcov_var.buffer, 1, words << 2,
+			   gcov_var.file) >> 2;
+  gcov_var.whole = gcov_var.length == words;
+}
+#endif
+
 #if !IN_GCOV
 /* Write out the current block, if needs be.  */
 
@@ -469,6 +535,13 @@ gcov_read_words (unsigned words)
 
   if (excess < words)
     {
+#if IN_GCOV
+      if (gcov_var.whole)
+	{
+	  gcov_var.overread += words - excess;
+	  return 0;
+	}
+#endif
       gcov_var.start += gcov_var.offset;
       if (excess)
 	{
@@ -626,6 +699,10 @@ gcov_sync (gcov_position_t base, gcov_unsigned_t length)
   base += length;
   if (base - gcov_var.start <= gcov_var.length)
     gcov_var.offset = base - gcov_var.start;
+#if IN_GCOV
+  else if (gcov_var.whole)
+    gcov_var.offset = gcov_var.length;
+#endif
   else
     {
       gcov_var.offset = gcov_var.length = 0;
@@ -56,6 +56,18 @@ see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
 
    	file : int32:magic int32:version int32:stamp record*
 
+   Data files can also be packed into a profile database, one file for
+   a whole program, which -fprofile-database= reads instead of the
+   separate data files.  Its basic format is
+
+	database: int32:magic int32:version int32:count entry* data-file*
+	entry: string:name int32:offset int32:length
+
+   where NAME is the name of a data file relative to the profile
+   directory, and OFFSET and LENGTH give the position and size of its
+   unchanged contents within the database, in 4 byte units.  The
+   entries are sorted by name.
+
    The magic ident is different for the notes and the data files.  The
    magic ident is used to determine the endianness of the file, when
    reading.  The version is the same for both files and is derived
@@ -207,6 +219,7 @@ typedef uint64_t gcov_type_unsigned;
 /* File magic. Must not be palindromes.  */
 #define GCOV_DATA_MAGIC ((gcov_unsigned_t)0x67636461) /* "gcda" */
 #define GCOV_NOTE_MAGIC ((gcov_unsigned_t)0x67636e6f) /* "gcno" */
+#define GCOV_DATABASE_MAGIC ((gcov_unsigned_t)0x67636462) /* "gcdb" */
 
 /* gcov-iov.h is automatically generated by the makefile from
    version.c, it looks like
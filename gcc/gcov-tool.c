@@ -132,29 +132,32 @@ gcov_output_files (const char *out, struct gcov_info *profile)
   free (pwd);
 }
 
-/* Merging profile D1 and D2 with weight as W1 and W2, respectively.
-   The result profile is written to directory OUT.
+/* Merging the N profile directories DIRS, the counters of DIRS[I] being
+   weighted by WEIGHTS[I].  The result profile is written to directory OUT.
    Return 0 on success.  */
 
 static int
-profile_merge (const char *d1, const char *d2, const char *out, int w1, int w2)
+profile_merge (const char *const *dirs, const int *weights, int n,
+	       const char *out)
 {
   struct gcov_info *d1_profile;
   struct gcov_info *d2_profile;
   int ret;
 
-  d1_profile = gcov_read_profile_dir (d1, 0);
+  d1_profile = gcov_read_profile_dir (dirs[0], 0);
   if (!d1_profile)
     return 1;
 
-  if (d2)
+  for (int i = 1; i < n; i++)
     {
-      d2_profile = gcov_read_profile_dir (d2, 0);
+      d2_profile = gcov_read_profile_dir (dirs[i], 0);
       if (!d2_profile)
         return 1;
 
-      /* The actual merge: we overwrite to d1_profile.  */
-      ret = gcov_profile_merge (d1_profile, d2_profile, w1, w2);
+      /* The actual merge: we overwrite to d1_profile.  Its counters only
+	 need to be weighted the first time.  */
+      ret = gcov_profile_merge (d1_profile, d2_profile,
+				i == 1 ? weights[0] : 1, weights[i]);
 
       if (ret)
         return ret;
@@ -172,10 +175,10 @@ print_merge_usage_message (int error_p)
 {
   FILE *file = error_p ? stderr : stdout;
 
-  fnotice (file, "  merge [options] <dir1> <dir2>         Merge coverage file contents\n");
+  fnotice (file, "  merge [options] <dir1> <dir2> [<dir3>...] Merge coverage file contents\n");
   fnotice (file, "    -o, --output <dir>                  Output directory\n");
   fnotice (file, "    -v, --verbose                       Verbose mode\n");
-  fnotice (file, "    -w, --weight <w1,w2>                Set weights (float point values)\n");
+  fnotice (file, "    -w, --weight <w1,w2,...>            Set weights (integer values)\n");
 }
 
 static const struct option merge_options[] =
@@ -203,7 +206,7 @@ do_merge (int argc, char **argv)
 {
   int opt;
   const char *output_dir = 0;
-  int w1 = 1, w2 = 1;
+  const char *weight_list = 0;
 
   optind = 0;
   while ((opt = getopt_long (argc, argv, "vo:w:", merge_options, NULL)) != -1)
@@ -218,9 +221,7 @@ do_merge (int argc, char **argv)
           output_dir = optarg;
           break;
         case 'w':
-          sscanf (optarg, "%d,%d", &w1, &w2);
-          if (w1 < 0 || w2 < 0)
-	    fatal_error (input_location, "weights need to be non-negative");
+          weight_list = optarg;
           break;
         default:
           merge_usage ();
@@ -230,10 +231,36 @@ do_merge (int argc, char **argv)
   if (output_dir == NULL)
     output_dir = "merged_profile";
 
-  if (argc - optind != 2)
+  int n = argc - optind;
+  if (n < 2)
     merge_usage ();
 
-  return profile_merge (argv[optind], argv[optind+1], output_dir, w1, w2);
+  /* Directories without an explicit weight get weight 1.  */
+  int *weights = XNEWVEC (int, n);
+  for (int i = 0; i < n; i++)
+    weights[i] = 1;
+  if (weight_list)
+    {
+      const char *p = weight_list;
+      for (int i = 0; i < n && *p; i++)
+	{
+	  char *end;
+	  long w = strtol (p, &end, 10);
+	  if (end == p || (*end != ',' && *end != '\0'))
+	    fatal_error (input_location, "invalid weight list %qs",
+			 weight_list);
+	  if (w < 0 || w > INT_MAX)
+	    fatal_error (input_location, "weights need to be non-negative");
+	  weights[i] = w;
+	  p = *end ? end + 1 : end;
+	}
+      if (*p)
+	fatal_error (input_location, "more weights than directories");
+    }
+
+  int ret = profile_merge (argv + optind, weights, n, output_dir);
+  free (weights);
+  return ret;
 }
 
 /* If N_VAL is no-zero, normalize the profile by setting the largest counter
@@ -498,6 +525,216 @@ do_overlap (int argc, char **argv)
 }
 
 
+/* A data file to be packed into a profile database.  */
+
+struct pack_file
+{
+  char *name;		/* Name relative to the profile directory.  */
+  gcov_unsigned_t words;	/* Size in 4 byte units.  */
+};
+
+static struct pack_file *pack_files;
+static unsigned pack_n_files, pack_alloc_files;
+static size_t pack_dir_len;
+
+#if HAVE_FTW_H
+
+/* Add file NAME to PACK_FILES if it has a gcda suffix.  */
+
+static int
+add_pack_file (const char *name, const struct stat *status,
+	       int type, struct FTW *ftwbuf ATTRIBUTE_UNUSED)
+{
+  int len = strlen (name);
+  int len1 = strlen (GCOV_DATA_SUFFIX);
+  const char *rel = name + pack_dir_len;
+
+  if (type != FTW_F
+      || len <= len1 || strcmp (name + len - len1, GCOV_DATA_SUFFIX))
+    return 0;
+
+  if (status->st_size % 4 || status->st_size / 4 > (gcov_unsigned_t) -1)
+    fatal_error (input_location, "%s is not a gcov data file", name);
+
+  if (pack_n_files == pack_alloc_files)
+    {
+      pack_alloc_files = pack_alloc_files ? 2 * pack_alloc_files : 64;
+      pack_files = XRESIZEVEC (struct pack_file, pack_files, pack_alloc_files);
+    }
+  while (IS_DIR_SEPARATOR (*rel))
+    rel++;
+  pack_files[pack_n_files].name = xstrdup (rel);
+  pack_files[pack_n_files].words = status->st_size / 4;
+  pack_n_files++;
+  return 0;
+}
+#endif
+
+/* Order pack_files by name.  */
+
+static int
+cmp_pack_file (const void *p1, const void *p2)
+{
+  return strcmp (((const struct pack_file *) p1)->name,
+		 ((const struct pack_file *) p2)->name);
+}
+
+/* Write the word VALUE to the database OUT.  */
+
+static void
+pack_write_unsigned (FILE *out, gcov_unsigned_t value)
+{
+  if (fwrite (&value, sizeof (value), 1, out) != 1)
+    fatal_error (input_location, "error writing profile database");
+}
+
+/* Pack the data files in directory DIR into the profile database OUT,
+   in the format described in gcov-io.h.  Return 0 on success.  */
+
+static int
+profile_pack (const char *dir, const char *out)
+{
+#if HAVE_FTW_H
+  FILE *db;
+  gcov_unsigned_t offset, ix;
+  char buf[4096];
+
+  pack_dir_len = strlen (dir);
+  if (nftw (dir, add_pack_file, 64, FTW_PHYS))
+    fatal_error (input_location, "cannot read directory %s", dir);
+  if (!pack_n_files)
+    {
+      fnotice (stderr, "no data files in %s\n", dir);
+      return 1;
+    }
+  qsort (pack_files, pack_n_files, sizeof (struct pack_file), cmp_pack_file);
+
+  /* The data follows the header and the index.  */
+  offset = 3;
+  for (ix = 0; ix != pack_n_files; ix++)
+    offset += 1 + ((strlen (pack_files[ix].name) + 4) >> 2) + 2;
+
+  db = fopen (out, "wb");
+  if (!db)
+    fatal_error (input_location, "cannot open %s", out);
+
+  pack_write_unsigned (db, GCOV_DATABASE_MAGIC);
+  pack_write_unsigned (db, GCOV_VERSION);
+  pack_write_unsigned (db, pack_n_files);
+  for (ix = 0; ix != pack_n_files; ix++)
+    {
+      size_t len = strlen (pack_files[ix].name);
+      gcov_unsigned_t alloc = (len + 4) >> 2;
+      char *padded = XCNEWVEC (char, alloc * 4);
+
+      memcpy (padded, pack_files[ix].name, len);
+      pack_write_unsigned (db, alloc);
+      if (fwrite (padded, alloc * 4, 1, db) != 1)
+	fatal_error (input_location, "error writing profile database");
+      free (padded);
+      pack_write_unsigned (db, offset);
+      pack_write_unsigned (db, pack_files[ix].words);
+      offset += pack_files[ix].words;
+    }
+
+  for (ix = 0; ix != pack_n_files; ix++)
+    {
+      char *name = concat (dir, "/", pack_files[ix].name, NULL);
+      FILE *in = fopen (name, "rb");
+      size_t left = (size_t) pack_files[ix].words * 4;
+
+      if (!in)
+	fatal_error (input_location, "cannot open %s", name);
+      if (verbose)
+	fnotice (stdout, "Packing %s\n", name);
+      while (left)
+	{
+	  size_t n = fread (buf, 1, MIN (left, sizeof (buf)), in);
+
+	  if (!n)
+	    fatal_error (input_location, "error reading %s", name);
+	  if (fwrite (buf, n, 1, db) != 1)
+	    fatal_error (input_location, "error writing profile database");
+	  left -= n;
+	}
+      fclose (in);
+      free (name);
+      free (pack_files[ix].name);
+    }
+  free (pack_files);
+
+  if (fclose (db))
+    fatal_error (input_location, "error writing profile database");
+  return 0;
+#else
+  fnotice (stderr, "packing %s into %s is not supported on this host\n",
+	   dir, out);
+  return 1;
+#endif
+}
+
+/* Usage message for profile pack.  */
+
+static void
+print_pack_usage_message (int error_p)
+{
+  FILE *file = error_p ? stderr : stdout;
+
+  fnotice (file, "  pack [options] <dir>                  Pack coverage files into a profile database\n");
+  fnotice (file, "    -o, --output <file>                 Output file\n");
+  fnotice (file, "    -v, --verbose                       Verbose mode\n");
+}
+
+static const struct option pack_options[] =
+{
+  { "verbose",                no_argument,       NULL, 'v' },
+  { "output",                 required_argument, NULL, 'o' },
+  { 0, 0, 0, 0 }
+};
+
+/* Print pack usage and exit.  */
+
+static void ATTRIBUTE_NORETURN
+pack_usage (void)
+{
+  fnotice (stderr, "Pack subcomand usage:");
+  print_pack_usage_message (true);
+  exit (FATAL_EXIT_CODE);
+}
+
+/* Driver for profile pack sub-command.  */
+
+static int
+do_pack (int argc, char **argv)
+{
+  int opt;
+  const char *output_file = 0;
+
+  optind = 0;
+  while ((opt = getopt_long (argc, argv, "vo:", pack_options, NULL)) != -1)
+    {
+      switch (opt)
+        {
+        case 'v':
+          verbose = true;
+          break;
+        case 'o':
+          output_file = optarg;
+          break;
+        default:
+          pack_usage ();
+        }
+    }
+
+  if (output_file == NULL)
+    output_file = "profile.gcdb";
+
+  if (argc - optind != 1)
+    pack_usage ();
+
+  return profile_pack (argv[optind], output_file);
+}
+
 /* Print a usage message and exit.  If ERROR_P is nonzero, this is an error,
    otherwise the output of --help.  */
 
@@ -514,6 +751,7 @@ print_usage (int error_p)
   print_merge_usage_message (error_p);
   print_rewrite_usage_message (error_p);
   print_overlap_usage_message (error_p);
+  print_pack_usage_message (error_p);
   fnotice (file, "\nFor bug reporting instructions, please see:\n%s.\n",
            bug_report_url);
   exit (status);
@@ -606,6 +844,8 @@ main (int argc, char **argv)
     return do_rewrite (argc - optind, argv + optind);
   else if (!strcmp (sub_command, "overlap"))
     return do_overlap (argc - optind, argv + optind);
+  else if (!strcmp (sub_command, "pack"))
+    return do_pack (argc - optind, argv + optind);
 
   print_usage (true);
 }
@@ -543,6 +543,11 @@ static int flag_display_progress = 0;
 
 static int flag_json_format = 0;
 
+/* Number of processes among which to split the object files, when
+   each gets its own report.  */
+
+static int flag_jobs = 1;
+
 /* For included files, make the gcov output file name include the name
    of the input source file.  For example, if x.h is included in a.c,
    then the output file name is a.c##x.h.gcov instead of x.h.gcov.  */
@@ -608,6 +613,7 @@ static int flag_counts = 0;
 
 /* Forward declarations.  */
 static int process_args (int, char **);
+static int process_files_in_parallel (char **, int);
 static void print_usage (int) ATTRIBUTE_NORETURN;
 static void print_version (void) ATTRIBUTE_NORETURN;
 static void process_file (const char *);
@@ -859,6 +865,11 @@ main (int argc, char **argv)
 
   first_arg = argno;
 
+  /* With the JSON format, the objects are independent of each other.  */
+  if (flag_jobs > 1 && flag_json_format && !flag_use_stdout
+      && argc - argno > 1)
+    return process_files_in_parallel (argv + argno, argc - argno);
+
   for (; argno != argc; argno++)
     {
       if (flag_display_progress)
@@ -877,6 +888,94 @@ main (int argc, char **argv)
   return 0;
 }
 
+/* Process FILES[FIRST], FILES[FIRST + STEP] and so on up to COUNT,
+   each with its own report.  */
+
+static void
+process_file_share (char **files, int count, int first, int step)
+{
+  for (int i = first; i < count; i += step)
+    {
+      if (flag_display_progress)
+	printf ("Processing file %d out of %d\n", i + 1, count);
+      process_file (files[i]);
+      process_all_functions ();
+      generate_results (files[i]);
+      release_structures ();
+      /* Keep the summaries of different objects apart.  */
+      fflush (stdout);
+    }
+}
+
+/* Process the COUNT object files FILES, each with its own report, in
+   up to FLAG_JOBS child processes.  Return the exit status.  */
+
+static int
+process_files_in_parallel (char **files, int count)
+{
+#ifdef HAVE_WORKING_FORK
+  vector<char *> unique;
+  vector<pid_t> pids;
+  int status = SUCCESS_EXIT_CODE;
+
+  /* Drop duplicate files here, since different children would not
+     notice them.  */
+  for (int i = 0; i < count; i++)
+    {
+      create_file_names (files[i]);
+      unsigned j;
+      for (j = 0; j < processed_files.size (); j++)
+	if (strcmp (da_file_name, processed_files[j]) == 0)
+	  break;
+      if (j < processed_files.size ())
+	fnotice (stderr, "'%s' file is already processed\n", files[i]);
+      else
+	{
+	  processed_files.push_back (xstrdup (da_file_name));
+	  unique.push_back (files[i]);
+	}
+    }
+  for (unsigned j = 0; j < processed_files.size (); j++)
+    free (processed_files[j]);
+  processed_files.clear ();
+
+  count = unique.size ();
+  int jobs = MIN (flag_jobs, count);
+
+  fflush (stdout);
+  fflush (stderr);
+  for (int job = 0; job < jobs; job++)
+    {
+      pid_t pid = fork ();
+      if (pid == 0)
+	{
+	  process_file_share (&unique[0], count, job, jobs);
+	  exit (SUCCESS_EXIT_CODE);
+	}
+      else if (pid < 0)
+	/* Do this share here instead.  */
+	process_file_share (&unique[0], count, job, jobs);
+      else
+	pids.push_back (pid);
+    }
+
+  for (unsigned i = 0; i < pids.size (); i++)
+    {
+      int child_status;
+
+      if (waitpid (pids[i], &child_status, 0) < 0
+	  || !WIFEXITED (child_status)
+	  || WEXITSTATUS (child_status) != SUCCESS_EXIT_CODE)
+	status = FATAL_EXIT_CODE;
+    }
+
+  return status;
+#else
+  process_file_share (files, count, 0, 1);
+  return SUCCESS_EXIT_CODE;
+#endif
+}
+
 /* Print a usage message and exit.  If ERROR_P is nonzero, this is an error,
    otherwise the output of --help.  */
 
@@ -897,6 +996,8 @@ print_usage (int error_p)
   fnotice (file, "  -h, --help                      Print this help, then exit\n");
   fnotice (file, "  -i, --json-format               Output JSON intermediate format into .gcov.json.gz file\n");
   fnotice (file, "  -j, --human-readable            Output human readable numbers\n");
+  fnotice (file, "  -J, --jobs N                    Process up to N object files in parallel\n\
+                                    with --json-format\n");
   fnotice (file, "  -k, --use-colors                Emit colored output\n");
   fnotice (file, "  -l, --long-file-names           Use long output file names for included\n\
                                     source files\n");
@@ -942,6 +1043,7 @@ static const struct option options[] =
   { "branch-counts",        no_argument,       NULL, 'c' },
   { "json-format",	    no_argument,       NULL, 'i' },
   { "human-readable",	    no_argument,       NULL, 'j' },
+  { "jobs",		    required_argument, NULL, 'J' },
   { "no-output",            no_argument,       NULL, 'n' },
   { "long-file-names",      no_argument,       NULL, 'l' },
   { "function-summaries",   no_argument,       NULL, 'f' },
@@ -967,7 +1069,7 @@ process_args (int argc, char **argv)
 {
   int opt;
 
-  const char *opts = "abcdfhijklmno:pqrs:tuvwx";
+  const char *opts = "abcdfhijJ:klmno:pqrs:tuvwx";
   while ((opt = getopt_long (argc, argv, opts, options, NULL)) != -1)
     {
       switch (opt)
@@ -993,6 +1095,11 @@ process_args (int argc, char **argv)
 	case 'j':
 	  flag_human_readable_numbers = 1;
 	  break;
+	case 'J':
+	  flag_jobs = atoi (optarg);
+	  if (flag_jobs < 1)
+	    print_usage (true);
+	  break;
 	case 'k':
 	  flag_use_colors = 1;
 	  break;
@@ -1115,14 +1222,12 @@ get_gcov_intermediate_filename (const char *file_name)
   return result;
 }
 
-/* Output the result in JSON intermediate format.
-   Source info SRC is dumped into JSON_FILES which is JSON array.  */
+/* Return the result for source info SRC in JSON intermediate format.  */
 
-static void
-output_json_intermediate_file (json::array *json_files, source_info *src)
+static json::object *
+output_json_intermediate_file (source_info *src)
 {
   json::object *root = new json::object ();
-  json_files->append (root);
 
   root->set ("file", new json::string (src->name));
 
@@ -1184,6 +1289,60 @@ output_json_intermediate_file (json::array *json_files, source_info *src)
 				       (last_non_group_fn != NULL
 					? last_non_group_fn->m_name : NULL));
     }
+
+  return root;
+}
+
+/* The JSON intermediate format is written out one source file at a
+   time, so that the report for an object is never held in memory as a
+   whole.  It goes to the gzip file GZ, or to stdout if that is NULL.  */
+
+struct json_stream
+{
+  gzFile gz;
+  bool first_file;
+  bool error;
+};
+
+/* Write TEXT to the JSON stream JS.  */
+
+static void
+json_stream_write (json_stream *js, const char *text)
+{
+  if (js->gz == NULL)
+    fputs (text, stdout);
+  else if (!js->error && gzputs (js->gz, text) == EOF)
+    js->error = true;
+}
+
+/* Write the member KEY of the top-level object, with the string VALUE,
+   to JS.  */
+
+static void
+json_stream_write_member (json_stream *js, const char *key, const char *value)
+{
+  pretty_printer pp;
+  json::string str (value);
+
+  pp_printf (&pp, "\"%s\": ", key);
+  str.print (&pp);
+  pp_string (&pp, ", ");
+  json_stream_write (js, pp_formatted_text (&pp));
+}
+
+/* Write the JSON object FILE for a source file to JS, and free it.  */
+
+static void
+json_stream_write_file (json_stream *js, json::object *file)
+{
+  pretty_printer pp;
+
+  if (!js->first_file)
+    pp_string (&pp, ", ");
+  js->first_file = false;
+  file->print (&pp);
+  json_stream_write (js, pp_formatted_text (&pp));
+  delete file;
 }
 
 /* Function start pair.  */
@@ -1419,16 +1578,32 @@ generate_results (const char *file_name)
 
   gcov_intermediate_filename = get_gcov_intermediate_filename (file_name);
 
-  json::object *root = new json::object ();
-  root->set ("format_version", new json::string ("1"));
-  root->set ("gcc_version", new json::string (version_string));
-
-  if (bbg_cwd != NULL)
-    root->set ("current_working_directory", new json::string (bbg_cwd));
-  root->set ("data_file", new json::string (file_name));
+  json_stream js;
+  bool json_output = flag_gcov_file && flag_json_format;
 
-  json::array *json_files = new json::array ();
-  root->set ("files", json_files);
+  js.gz = NULL;
+  js.first_file = true;
+  js.error = false;
+  if (json_output && !flag_use_stdout)
+    {
+      js.gz = gzopen (gcov_intermediate_filename, "w");
+      if (js.gz == NULL)
+	{
+	  fnotice (stderr, "Cannot open JSON output file %s\n",
+		   gcov_intermediate_filename);
+	  json_output = false;
+	}
+    }
+  if (json_output)
+    {
+      json_stream_write (&js, "{");
+      json_stream_write_member (&js, "format_version", "1");
+      json_stream_write_member (&js, "gcc_version", version_string);
+      if (bbg_cwd != NULL)
+	json_stream_write_member (&js, "current_working_directory", bbg_cwd);
+      json_stream_write_member (&js, "data_file", file_name);
+      json_stream_write (&js, "\"files\": [");
+    }
 
   for (vector<source_info>::iterator it = sources.begin ();
        it != sources.end (); it++)
@@ -1457,7 +1632,11 @@ generate_results (const char *file_name)
       if (flag_gcov_file)
 	{
 	  if (flag_json_format)
-	    output_json_intermediate_file (json_files, src);
+	    {
+	      if (json_output)
+		json_stream_write_file (&js,
+					output_json_intermediate_file (src));
+	    }
 	  else
 	    {
 	      if (flag_use_stdout)
@@ -1474,34 +1653,16 @@ generate_results (const char *file_name)
 	}
     }
 
-  if (flag_gcov_file && flag_json_format)
+  if (json_output)
     {
+      json_stream_write (&js, "]}");
       if (flag_use_stdout)
+	printf ("\n");
+      else if (gzclose (js.gz) != Z_OK || js.error)
 	{
-	  root->dump (stdout);
-	  printf ("\n");
-	}
-      else
-	{
-	  pretty_printer pp;
-	  root->print (&pp);
-	  pp_formatted_text (&pp);
-
-	  gzFile output = gzopen (gcov_intermediate_filename, "w");
-	  if (output == NULL)
-	    {
-	      fnotice (stderr, "Cannot open JSON output file %s\n",
-		       gcov_intermediate_filename);
-	      return;
-	    }
-
-	  if (gzputs (output, pp_formatted_text (&pp)) == EOF
-	      || gzclose (output))
-	    {
-	      fnotice (stderr, "Error writing JSON output file %s\n",
-		       gcov_intermediate_filename);
-	      return;
-	    }
+	  fnotice (stderr, "Error writing JSON output file %s\n",
+		   gcov_intermediate_filename);
+	  return;
 	}
     }
 
@@ -4018,6 +4018,11 @@ gcse_or_cprop_is_too_expensive (const char *pass)
       return true;
     }
 
+  /* Give up if the function has used up its compile time budget; that
+     has already been diagnosed.  */
+  if (cfun->compile_budget_exceeded)
+    return true;
+
   return false;
 }
 
@@ -47,6 +47,40 @@ void ggc_free (void *)
 /* Verboseness.  0 is quiet, 1 adds some warnings, 2 is for debugging.  */
 unsigned verbose;
 
+/* If the generated code is split over several files, the file that
+   the declarations of the functions they share are written to.  */
+static FILE *header_file;
+
+/* Return the file of PARTS that the next function should be written
+   to, which is the one with the least code in it so far.  */
+
+static FILE *
+choose_output (const vec<FILE *> &parts)
+{
+  FILE *f = parts[0];
+  long size = ftell (f);
+  for (unsigned i = 1; i < parts.length (); ++i)
+    {
+      long part_size = ftell (parts[i]);
+      if (part_size < size)
+	{
+	  f = parts[i];
+	  size = part_size;
+	}
+    }
+  return f;
+}
+
+/* Return the storage class to give the helper functions in the generated
+   code.  They have to be visible from the other files if the code is
+   split over several files.  */
+
+static const char *
+helper_storage ()
+{
+  return header_file ? "" : "static ";
+}
+
 
 /* libccp helpers.  */
 
@@ -1720,7 +1754,7 @@ public:
   dt_node *root;
 
   void insert (class simplify *, unsigned);
-  void gen (FILE *f, bool gimple);
+  void gen (vec<FILE *> &parts, bool gimple);
   void print (FILE *f = stderr);
 
   decision_tree () { root = new dt_node (dt_node::DT_NODE, NULL); }
@@ -3723,11 +3757,93 @@ sinfo_hashmap_traits::equal_keys (const key_type &v,
 }
 
 
+/* Write to F the return type, name and parameters of the function
+   S->fname implementing the transform shared by several leafs, up to
+   but not including the closing parenthesis.  */
+
+static void
+write_tail_signature (FILE *f, sinfo *s, bool gimple)
+{
+  if (gimple)
+    fprintf (f, "\n%sbool\n"
+	     "%s (gimple_match_op *res_op, gimple_seq *seq,\n"
+	     "                 tree (*valueize)(tree) ATTRIBUTE_UNUSED,\n"
+	     "                 const tree ARG_UNUSED (type), tree *ARG_UNUSED "
+	     "(captures)\n",
+	     helper_storage (), s->fname);
+  else
+    {
+      fprintf (f, "\n%stree\n"
+	       "%s (location_t ARG_UNUSED (loc), const tree ARG_UNUSED (type),\n",
+	       helper_storage (), s->fname);
+      for (unsigned i = 0;
+	   i < as_a <expr *>(s->s->s->match)->ops.length (); ++i)
+	fprintf (f, " tree ARG_UNUSED (_p%d),", i);
+      fprintf (f, " tree *captures\n");
+    }
+  for (unsigned i = 0; i < s->s->s->for_subst_vec.length (); ++i)
+    {
+      if (! s->s->s->for_subst_vec[i].first->used)
+	continue;
+      if (is_a <operator_id *> (s->s->s->for_subst_vec[i].second))
+	fprintf (f, ", const enum tree_code ARG_UNUSED (%s)",
+		 s->s->s->for_subst_vec[i].first->id);
+      else if (is_a <fn_id *> (s->s->s->for_subst_vec[i].second))
+	fprintf (f, ", const combined_fn ARG_UNUSED (%s)",
+		 s->s->s->for_subst_vec[i].first->id);
+    }
+}
+
+/* Write to F the return type, name and parameters of the function
+   matching expressions with operation E, which has N operands.  */
+
+static void
+write_operation_signature (FILE *f, expr *e, unsigned n, bool gimple)
+{
+  if (gimple)
+    fprintf (f, "\n%sbool\n"
+	     "gimple_simplify_%s (gimple_match_op *res_op,"
+	     " gimple_seq *seq,\n"
+	     "                 tree (*valueize)(tree) "
+	     "ATTRIBUTE_UNUSED,\n"
+	     "                 code_helper ARG_UNUSED (code), tree "
+	     "ARG_UNUSED (type)\n",
+	     helper_storage (), e->operation->id);
+  else
+    fprintf (f, "\n%stree\n"
+	     "generic_simplify_%s (location_t ARG_UNUSED (loc), enum "
+	     "tree_code ARG_UNUSED (code), const tree ARG_UNUSED (type)",
+	     helper_storage (), e->operation->id);
+  for (unsigned i = 0; i < n; ++i)
+    fprintf (f, ", tree _p%d", i);
+  fprintf (f, ")");
+}
+
+/* Write to F the return type, name and parameters of the entry point
+   for matching operations with N operands.  */
+
+static void
+write_entry_signature (FILE *f, unsigned n, bool gimple)
+{
+  if (gimple)
+    fprintf (f, "\nbool\n"
+	     "gimple_simplify (gimple_match_op *res_op, gimple_seq *seq,\n"
+	     "                 tree (*valueize)(tree) ATTRIBUTE_UNUSED,\n"
+	     "                 code_helper code, const tree type");
+  else
+    fprintf (f, "\ntree\n"
+	     "generic_simplify (location_t loc, enum tree_code code, "
+	     "const tree type ATTRIBUTE_UNUSED");
+  for (unsigned i = 0; i < n; ++i)
+    fprintf (f, ", tree _p%d", i);
+  fprintf (f, ")");
+}
+
 /* Main entry to generate code for matching GIMPLE IL off the decision
-   tree.  */
+   tree.  The functions are distributed over the files in PARTS.  */
 
 void
-decision_tree::gen (FILE *f, bool gimple)
+decision_tree::gen (vec<FILE *> &parts, bool gimple)
 {
   sinfo_map_t si;
 
@@ -3759,33 +3875,12 @@ decision_tree::gen (FILE *f, bool gimple)
       /* Generate a split out function with the leaf transform code.  */
       s->fname = xasprintf ("%s_simplify_%u", gimple ? "gimple" : "generic",
 			    fcnt++);
-      if (gimple)
-	fprintf (f, "\nstatic bool\n"
-		 "%s (gimple_match_op *res_op, gimple_seq *seq,\n"
-		 "                 tree (*valueize)(tree) ATTRIBUTE_UNUSED,\n"
-		 "                 const tree ARG_UNUSED (type), tree *ARG_UNUSED "
-		 "(captures)\n",
-		 s->fname);
-      else
-	{
-	  fprintf (f, "\nstatic tree\n"
-		   "%s (location_t ARG_UNUSED (loc), const tree ARG_UNUSED (type),\n",
-		   (*iter).second->fname);
-	  for (unsigned i = 0;
-	       i < as_a <expr *>(s->s->s->match)->ops.length (); ++i)
-	    fprintf (f, " tree ARG_UNUSED (_p%d),", i);
-	  fprintf (f, " tree *captures\n");
-	}
-      for (unsigned i = 0; i < s->s->s->for_subst_vec.length (); ++i)
+      FILE *f = choose_output (parts);
+      write_tail_signature (f, s, gimple);
+      if (header_file)
 	{
-	  if (! s->s->s->for_subst_vec[i].first->used)
-	    continue;
-	  if (is_a <operator_id *> (s->s->s->for_subst_vec[i].second))
-	    fprintf (f, ", const enum tree_code ARG_UNUSED (%s)",
-		     s->s->s->for_subst_vec[i].first->id);
-	  else if (is_a <fn_id *> (s->s->s->for_subst_vec[i].second))
-	    fprintf (f, ", const combined_fn ARG_UNUSED (%s)",
-		     s->s->s->for_subst_vec[i].first->id);
+	  write_tail_signature (header_file, s, gimple);
+	  fprintf (header_file, ");\n");
 	}
 
       fprintf (f, ")\n{\n");
@@ -3814,24 +3909,14 @@ decision_tree::gen (FILE *f, bool gimple)
 		  && e->operation->kind != id_base::CODE))
 	    continue;
 
-	  if (gimple)
-	    fprintf (f, "\nstatic bool\n"
-		     "gimple_simplify_%s (gimple_match_op *res_op,"
-		     " gimple_seq *seq,\n"
-		     "                 tree (*valueize)(tree) "
-		     "ATTRIBUTE_UNUSED,\n"
-		     "                 code_helper ARG_UNUSED (code), tree "
-		     "ARG_UNUSED (type)\n",
-		     e->operation->id);
-	  else
-	    fprintf (f, "\nstatic tree\n"
-		     "generic_simplify_%s (location_t ARG_UNUSED (loc), enum "
-		     "tree_code ARG_UNUSED (code), const tree ARG_UNUSED (type)",
-		     e->operation->id);
-	  for (unsigned i = 0; i < n; ++i)
-	    fprintf (f, ", tree _p%d", i);
-	  fprintf (f, ")\n");
-	  fprintf (f, "{\n");
+	  FILE *f = choose_output (parts);
+	  write_operation_signature (f, e, n, gimple);
+	  if (header_file)
+	    {
+	      write_operation_signature (header_file, e, n, gimple);
+	      fprintf (header_file, ";\n");
+	    }
+	  fprintf (f, "\n{\n");
 	  dop->gen_kids (f, 2, gimple, 0);
 	  if (gimple)
 	    fprintf (f, "  return false;\n");
@@ -3841,20 +3926,11 @@ decision_tree::gen (FILE *f, bool gimple)
 	}
 
       /* Then generate the main entry with the outermost switch and
-         tail-calls to the split-out functions.  */
-      if (gimple)
-	fprintf (f, "\nstatic bool\n"
-		 "gimple_simplify (gimple_match_op *res_op, gimple_seq *seq,\n"
-		 "                 tree (*valueize)(tree) ATTRIBUTE_UNUSED,\n"
-		 "                 code_helper code, const tree type");
-      else
-	fprintf (f, "\ntree\n"
-		 "generic_simplify (location_t loc, enum tree_code code, "
-		 "const tree type ATTRIBUTE_UNUSED");
-      for (unsigned i = 0; i < n; ++i)
-	fprintf (f, ", tree _p%d", i);
-      fprintf (f, ")\n");
-      fprintf (f, "{\n");
+         tail-calls to the split-out functions.  The match heads
+	 declare it.  */
+      FILE *f = choose_output (parts);
+      write_entry_signature (f, n, gimple);
+      fprintf (f, "\n{\n");
 
       if (gimple)
 	fprintf (f, "  switch (code.get_rep())\n"
@@ -3908,6 +3984,11 @@ decision_tree::gen (FILE *f, bool gimple)
 void
 write_predicate (FILE *f, predicate_id *p, decision_tree &dt, bool gimple)
 {
+  if (header_file)
+    fprintf (header_file, "\nbool\n"
+	     "%s%s (tree t%s%s);\n", gimple ? "gimple_" : "tree_", p->id,
+	     p->nargs > 0 ? ", tree *res_ops" : "",
+	     gimple ? ", tree (*valueize)(tree)" : "");
   fprintf (f, "\nbool\n"
 	   "%s%s (tree t%s%s)\n"
 	   "{\n", gimple ? "gimple_" : "tree_", p->id,
@@ -3924,16 +4005,26 @@ write_predicate (FILE *f, predicate_id *p, decision_tree &dt, bool gimple)
 	   "}\n");
 }
 
-/* Write the common header for the GIMPLE/GENERIC IL matching routines.  */
+/* Write the common header for the GIMPLE/GENERIC IL matching routines.
+   If the code is split over several files, PRIMARY is true for the one
+   that defines the functions of HEAD that are not local to each file,
+   and INCLUDE is the name of the header declaring the functions shared
+   between the files.  */
 
 static void
-write_header (FILE *f, const char *head)
+write_header (FILE *f, const char *head, bool primary, const char *include)
 {
   fprintf (f, "/* Generated automatically by the program `genmatch' from\n");
   fprintf (f, "   a IL pattern matching and simplification description.  */\n");
 
+  if (!primary)
+    fprintf (f, "\n#define GENMATCH_SECONDARY_PART 1\n");
+
   /* Include the header instead of writing it awkwardly quoted here.  */
   fprintf (f, "\n#include \"%s\"\n", head);
+
+  if (include)
+    fprintf (f, "#include \"%s\"\n", include);
 }
 
 
@@ -5085,23 +5176,75 @@ main (int argc, char **argv)
     return 1;
 
   bool gimple = true;
-  char *input = argv[argc-1];
-  for (int i = 1; i < argc - 1; ++i)
+  char *input = NULL;
+  const char *header = NULL;
+  const char *include = NULL;
+  auto_vec<const char *> outputs;
+  for (int i = 1; i < argc; ++i)
     {
       if (strcmp (argv[i], "--gimple") == 0)
 	gimple = true;
       else if (strcmp (argv[i], "--generic") == 0)
 	gimple = false;
+      else if (strncmp (argv[i], "--header=", 9) == 0)
+	header = argv[i] + 9;
+      else if (strncmp (argv[i], "--include=", 10) == 0)
+	include = argv[i] + 10;
       else if (strcmp (argv[i], "-v") == 0)
 	verbose = 1;
       else if (strcmp (argv[i], "-vv") == 0)
 	verbose = 2;
+      else if (argv[i][0] != '-' && !input)
+	input = argv[i];
+      else if (argv[i][0] != '-')
+	outputs.safe_push (argv[i]);
       else
 	{
-	  fprintf (stderr, "Usage: genmatch "
-		   "[--gimple] [--generic] [-v[v]] input\n");
+	  input = NULL;
+	  break;
+	}
+    }
+
+  /* Without output files, everything goes to stdout.  With more than
+     one, the functions shared between them are declared in HEADER,
+     which the output files include as INCLUDE.  */
+  if (!input || (outputs.length () > 1 && !header))
+    {
+      fprintf (stderr, "Usage: genmatch [--gimple] [--generic] "
+	       "[--header=file] [--include=file] [-v[v]] input "
+	       "[output...]\n");
+      return 1;
+    }
+  if (outputs.length () <= 1)
+    header = NULL;
+  if (header && !include)
+    include = header;
+
+  auto_vec<FILE *> parts;
+  for (unsigned i = 0; i < outputs.length (); ++i)
+    {
+      FILE *f = fopen (outputs[i], "w");
+      if (!f)
+	{
+	  perror (outputs[i]);
 	  return 1;
 	}
+      parts.safe_push (f);
+    }
+  if (parts.is_empty ())
+    parts.safe_push (stdout);
+  if (header)
+    {
+      header_file = fopen (header, "w");
+      if (!header_file)
+	{
+	  perror (header);
+	  return 1;
+	}
+      fprintf (header_file, "/* Generated automatically by the program "
+	       "`genmatch' from\n"
+	       "   a IL pattern matching and simplification description.  "
+	       "*/\n");
     }
 
   line_table = XCNEW (class line_maps);
@@ -5156,10 +5299,10 @@ add_operator (VIEW_CONVERT2, "view_convert2", "tcc_unary", 1);
   /* Parse ahead!  */
   parser p (r);
 
-  if (gimple)
-    write_header (stdout, "gimple-match-head.c");
-  else
-    write_header (stdout, "generic-match-head.c");
+  for (unsigned i = 0; i < parts.length (); ++i)
+    write_header (parts[i],
+		  gimple ? "gimple-match-head.c" : "generic-match-head.c",
+		  i == 0, header ? include : NULL);
 
   /* Go over all predicates defined with patterns and perform
      lowering and code generation.  */
@@ -5179,7 +5322,7 @@ add_operator (VIEW_CONVERT2, "view_convert2", "tcc_unary", 1);
       if (verbose == 2)
 	dt.print (stderr);
 
-      write_predicate (stdout, pred, dt, gimple);
+      write_predicate (choose_output (parts), pred, dt, gimple);
     }
 
   /* Lower the main simplifiers and generate code for them.  */
@@ -5196,9 +5339,21 @@ add_operator (VIEW_CONVERT2, "view_convert2", "tcc_unary", 1);
   if (verbose == 2)
     dt.print (stderr);
 
-  dt.gen (stdout, gimple);
+  dt.gen (parts, gimple);
 
   /* Finalize.  */
+  for (unsigned i = 0; i < outputs.length (); ++i)
+    if (fclose (parts[i]) != 0)
+      {
+	perror (outputs[i]);
+	return 1;
+      }
+  if (header_file && fclose (header_file) != 0)
+    {
+      perror (header);
+      return 1;
+    }
+
   cpp_finish (r, NULL);
   cpp_destroy (r);
 
@@ -307,6 +307,17 @@ struct traversal_state
   size_t count;
   struct ptr_data **ptrs;
   size_t ptrs_i;
+
+  /* The address the image is laid out for.  */
+  char *base;
+
+  /* A bitmap with one bit per pointer-sized word of the image, set for
+     every word that holds a pointer into the image.  */
+  unsigned char *reloc_bitmap;
+
+  /* False if some pointer could not be recorded in RELOC_BITMAP, in
+     which case the image can only be used at BASE.  */
+  bool relocatable;
 };
 
 /* Callbacks for htab_traverse.  */
@@ -350,7 +361,7 @@ static void
 relocate_ptrs (void *ptr_p, void *state_p)
 {
   void **ptr = (void **)ptr_p;
-  struct traversal_state *state ATTRIBUTE_UNUSED
+  struct traversal_state *state
     = (struct traversal_state *)state_p;
   struct ptr_data *result;
 
@@ -361,6 +372,25 @@ relocate_ptrs (void *ptr_p, void *state_p)
     saving_htab->find_with_hash (*ptr, POINTER_HASH (*ptr));
   gcc_assert (result);
   *ptr = result->new_addr;
+
+  /* Remember where in the image the pointer will end up.  Reorder
+     functions also relocate copies of pointers held outside the object
+     being written, for instance to compare them; those never reach the
+     image.  A misaligned pointer cannot be described by the bitmap and
+     makes the image unrelocatable.  */
+  struct ptr_data *obj = state->ptrs[state->ptrs_i];
+  uintptr_t offset = (uintptr_t) ptr_p - (uintptr_t) obj->obj;
+  if ((char *) ptr_p < (char *) obj->obj
+      || offset + sizeof (void *) > obj->size)
+    return;
+  offset += (uintptr_t) obj->new_addr - (uintptr_t) state->base;
+  if (offset % sizeof (void *) != 0)
+    state->relocatable = false;
+  else
+    {
+      offset /= sizeof (void *);
+      state->reloc_bitmap[offset / CHAR_BIT] |= 1 << (offset % CHAR_BIT);
+    }
 }
 
 /* Write out, after relocation, the pointers in TAB.  */
@@ -404,6 +434,15 @@ struct mmap_info
   void *preferred_base;
 };
 
+/* Return the size in bytes of the relocation bitmap for an image of
+   SIZE bytes.  */
+
+static inline size_t
+pch_reloc_bitmap_size (size_t size)
+{
+  return (size / sizeof (void *) + CHAR_BIT - 1) / CHAR_BIT;
+}
+
 /* Write out the state of the compiler to F.  */
 
 void
@@ -447,6 +486,10 @@ gt_pch_save (FILE *f)
 
   state.ptrs = XNEWVEC (struct ptr_data *, state.count);
   state.ptrs_i = 0;
+  state.base = (char *) mmi.preferred_base;
+  state.reloc_bitmap
+    = XCNEWVEC (unsigned char, pch_reloc_bitmap_size (mmi.size));
+  state.relocatable = true;
 
   saving_htab->traverse <traversal_state *, ggc_call_alloc> (&state);
   timevar_pop (TV_PCH_PTR_REALLOC);
@@ -491,6 +534,7 @@ gt_pch_save (FILE *f)
   /* Actually write out the objects.  */
   for (i = 0; i < state.count; i++)
     {
+      state.ptrs_i = i;
       if (this_object_size < state.ptrs[i]->size)
 	{
 	  this_object_size = state.ptrs[i]->size;
@@ -572,8 +616,21 @@ gt_pch_save (FILE *f)
 #endif
 
   ggc_pch_finish (state.d, state.f);
+
+  /* Write out the relocation bitmap, or an empty one if the image can
+     only be used at its preferred base.  */
+  {
+    size_t reloc_size
+      = state.relocatable ? pch_reloc_bitmap_size (mmi.size) : 0;
+    if (fwrite (&reloc_size, sizeof (reloc_size), 1, f) != 1
+	|| (reloc_size != 0
+	    && fwrite (state.reloc_bitmap, reloc_size, 1, f) != 1))
+      fatal_error (input_location, "cannot write PCH file: %m");
+  }
+
   gt_pch_fixup_stringpool ();
 
+  XDELETE (state.reloc_bitmap);
   XDELETE (state.ptrs);
   XDELETE (this_object);
   delete saving_htab;
@@ -590,6 +647,8 @@ gt_pch_restore (FILE *f)
   size_t i;
   struct mmap_info mmi;
   int result;
+  char *base;
+  size_t reloc_size;
 
   /* Delete any deletable objects.  This makes ggc_pch_read much
      faster, as it can be sure that no GCable objects remain other
@@ -615,20 +674,71 @@ gt_pch_restore (FILE *f)
   if (fread (&mmi, sizeof (mmi), 1, f) != 1)
     fatal_error (input_location, "cannot read PCH file: %m");
 
-  result = host_hooks.gt_pch_use_address (mmi.preferred_base, mmi.size,
+  base = (char *) mmi.preferred_base;
+  result = host_hooks.gt_pch_use_address (base, mmi.size,
 					  fileno (f), mmi.offset);
   if (result < 0)
-    fatal_error (input_location, "had to relocate PCH");
+    {
+      /* The preferred address is taken.  Ask for another one; whether
+	 the image can actually be relocated there is only known once
+	 the relocation bitmap after it has been read.  */
+      base = (char *) host_hooks.gt_pch_get_address (mmi.size, fileno (f));
+      if (base != NULL)
+	result = host_hooks.gt_pch_use_address (base, mmi.size,
+						fileno (f), mmi.offset);
+      if (result < 0)
+	fatal_error (input_location, "had to relocate PCH");
+    }
   if (result == 0)
     {
       if (fseek (f, mmi.offset, SEEK_SET) != 0
-	  || fread (mmi.preferred_base, mmi.size, 1, f) != 1)
+	  || fread (base, mmi.size, 1, f) != 1)
 	fatal_error (input_location, "cannot read PCH file: %m");
     }
   else if (fseek (f, mmi.offset + mmi.size, SEEK_SET) != 0)
     fatal_error (input_location, "cannot read PCH file: %m");
 
-  ggc_pch_read (f, mmi.preferred_base);
+  ggc_pch_read (f, base);
+
+  if (fread (&reloc_size, sizeof (reloc_size), 1, f) != 1)
+    fatal_error (input_location, "cannot read PCH file: %m");
+  if (base == mmi.preferred_base)
+    {
+      if (reloc_size != 0 && fseek (f, reloc_size, SEEK_CUR) != 0)
+	fatal_error (input_location, "cannot read PCH file: %m");
+    }
+  else
+    {
+      if (reloc_size != pch_reloc_bitmap_size (mmi.size))
+	fatal_error (input_location, "had to relocate PCH");
+
+      unsigned char *reloc_bitmap = XNEWVEC (unsigned char, reloc_size);
+      if (fread (reloc_bitmap, reloc_size, 1, f) != 1)
+	fatal_error (input_location, "cannot read PCH file: %m");
+
+      /* Relocate the pointers within the image...  */
+      uintptr_t delta = (uintptr_t) base - (uintptr_t) mmi.preferred_base;
+      for (i = 0; i < reloc_size; i++)
+	if (reloc_bitmap[i])
+	  {
+	    uintptr_t *word = (uintptr_t *) base + i * CHAR_BIT;
+	    for (unsigned bit = 0; bit < CHAR_BIT; bit++)
+	      if (reloc_bitmap[i] & (1 << bit))
+		word[bit] += delta;
+	  }
+      XDELETEVEC (reloc_bitmap);
+
+      /* ... and the global pointers into it read above.  */
+      for (rt = gt_ggc_rtab; *rt; rt++)
+	for (rti = *rt; rti->base != NULL; rti++)
+	  for (i = 0; i < rti->nelt; i++)
+	    {
+	      uintptr_t *ptr = (uintptr_t *) ((char *)rti->base
+					      + rti->stride * i);
+	      if (*ptr != 0 && *ptr != 1)
+		*ptr += delta;
+	    }
+    }
 
   gt_pch_restore_stringpool ();
 }
@@ -207,6 +207,11 @@ static const size_t extra_order_size_table[] = {
 
 #define NUM_ORDERS (HOST_BITS_PER_PTR + NUM_EXTRA_ORDERS)
 
+/* Requests for fewer than this many bytes are mapped to their order
+   through the size_lookup table.  */
+
+#define NUM_SIZE_LOOKUP 512
+
 /* Compute the smallest nonnegative number which when added to X gives
    a multiple of F.  */
 
@@ -359,6 +364,24 @@ private:
   size_t m_n_objects;
 };
 
+/* The number of distinct page-entry sizes for which free pages are kept
+   on their own list.  Free pages whose size does not get a list of its
+   own go on the catch-all list at index zero.  */
+#define NUM_FREE_LISTS 10
+
+/* A list of free pages, all of the same size unless this is the
+   catch-all list.  Keeping one list per size means that alloc_page
+   finds a recyclable page in constant time instead of scanning past
+   pages of every other size.  */
+struct free_list
+{
+  /* The size of the pages on this list, or zero if the list is unused.  */
+  size_t bytes;
+
+  /* The free pages themselves.  */
+  page_entry *free_pages;
+};
+
 #ifdef ENABLE_GC_ALWAYS_COLLECT
 /* List of free objects to be verified as actually free on the
    next collection.  */
@@ -413,8 +436,8 @@ static struct ggc_globals
   int dev_zero_fd;
 #endif
 
-  /* A cache of free system pages.  */
-  page_entry *free_pages;
+  /* A cache of free system pages, one list per page-entry size.  */
+  struct free_list free_lists[NUM_FREE_LISTS];
 
 #ifdef USING_MALLOC_PAGE_GROUPS
   page_group *page_groups;
@@ -489,6 +512,12 @@ static struct ggc_globals
 
     /* The overhead for each of the allocation orders.  */
     unsigned long long total_overhead_per_order[NUM_ORDERS];
+
+    /* The number of allocations and their rounding overhead for each
+       requested size below NUM_SIZE_LOOKUP.  This is the histogram to
+       consult when tuning extra_order_size_table.  */
+    unsigned long long count_per_size[NUM_SIZE_LOOKUP];
+    unsigned long long overhead_per_size[NUM_SIZE_LOOKUP];
   } stats;
 } G;
 
@@ -580,6 +609,35 @@ push_by_depth (page_entry *p, unsigned long *s)
 #define save_in_use_p(__p) \
   (save_in_use_p_i (__p->index_by_depth))
 
+#if HOST_BITS_PER_PTR > 32
+/* Return the page table covering the 4GB region containing P, or NULL
+   if there is none.  Marking tends to look up many objects in the same
+   region in a row, so the table found is moved to the front of the
+   chain; the common case is then a single comparison.  */
+
+static inline page_table
+lookup_page_table_chain (const void *p)
+{
+  uintptr_t high_bits = (uintptr_t) p & ~ (uintptr_t) 0xffffffff;
+  page_table table = G.lookup, *prevp;
+
+  if (__builtin_expect (table != NULL && table->high_bits == high_bits, 1))
+    return table;
+  if (table == NULL)
+    return NULL;
+
+  for (prevp = &table->next; (table = *prevp) != NULL; prevp = &table->next)
+    if (table->high_bits == high_bits)
+      {
+	*prevp = table->next;
+	table->next = G.lookup;
+	G.lookup = table;
+	return table;
+      }
+  return NULL;
+}
+#endif
+
 /* Traverse the page table and find the entry for a page.
    If the object wasn't allocated in GC return NULL.  */
 
@@ -592,16 +650,9 @@ safe_lookup_page_table_entry (const void *p)
 #if HOST_BITS_PER_PTR <= 32
   base = &G.lookup[0];
 #else
-  page_table table = G.lookup;
-  uintptr_t high_bits = (uintptr_t) p & ~ (uintptr_t) 0xffffffff;
-  while (1)
-    {
-      if (table == NULL)
-	return NULL;
-      if (table->high_bits == high_bits)
-	break;
-      table = table->next;
-    }
+  page_table table = lookup_page_table_chain (p);
+  if (table == NULL)
+    return NULL;
   base = &table->table[0];
 #endif
 
@@ -626,10 +677,7 @@ lookup_page_table_entry (const void *p)
 #if HOST_BITS_PER_PTR <= 32
   base = &G.lookup[0];
 #else
-  page_table table = G.lookup;
-  uintptr_t high_bits = (uintptr_t) p & ~ (uintptr_t) 0xffffffff;
-  while (table->high_bits != high_bits)
-    table = table->next;
+  page_table table = lookup_page_table_chain (p);
   base = &table->table[0];
 #endif
 
@@ -651,18 +699,15 @@ set_page_table_entry (void *p, page_entry *entry)
 #if HOST_BITS_PER_PTR <= 32
   base = &G.lookup[0];
 #else
-  page_table table;
-  uintptr_t high_bits = (uintptr_t) p & ~ (uintptr_t) 0xffffffff;
-  for (table = G.lookup; table; table = table->next)
-    if (table->high_bits == high_bits)
-      goto found;
-
-  /* Not found -- allocate a new table.  */
-  table = XCNEW (struct page_table_chain);
-  table->next = G.lookup;
-  table->high_bits = high_bits;
-  G.lookup = table;
-found:
+  page_table table = lookup_page_table_chain (p);
+  if (table == NULL)
+    {
+      /* Not found -- allocate a new table.  */
+      table = XCNEW (struct page_table_chain);
+      table->next = G.lookup;
+      table->high_bits = (uintptr_t) p & ~ (uintptr_t) 0xffffffff;
+      G.lookup = table;
+    }
   base = &table->table[0];
 #endif
 
@@ -755,6 +800,27 @@ clear_page_group_in_use (page_group *group, char *page)
 }
 #endif
 
+/* Return the free list for pages of ENTRY_SIZE bytes, claiming an
+   unused list for that size if there is none yet.  */
+
+static inline struct free_list *
+find_free_list (size_t entry_size)
+{
+  int i;
+
+  for (i = 1; i < NUM_FREE_LISTS; i++)
+    {
+      if (G.free_lists[i].bytes == entry_size)
+	return &G.free_lists[i];
+      if (G.free_lists[i].bytes == 0)
+	{
+	  G.free_lists[i].bytes = entry_size;
+	  return &G.free_lists[i];
+	}
+    }
+  return &G.free_lists[0];
+}
+
 /* Allocate a new page for allocating objects of size 2^ORDER,
    and return an entry for it.  The entry is not added to the
    appropriate page_table list.  */
@@ -768,6 +834,7 @@ alloc_page (unsigned order)
   size_t bitmap_size;
   size_t page_entry_size;
   size_t entry_size;
+  struct free_list *free_list;
 #ifdef USING_MALLOC_PAGE_GROUPS
   page_group *group;
 #endif
@@ -783,8 +850,10 @@ alloc_page (unsigned order)
   entry = NULL;
   page = NULL;
 
-  /* Check the list of free pages for one we can use.  */
-  for (pp = &G.free_pages, p = *pp; p; pp = &p->next, p = *pp)
+  /* Check the list of free pages for one we can use.  Unless this is
+     the catch-all list, the first page on it is the right size.  */
+  free_list = find_free_list (entry_size);
+  for (pp = &free_list->free_pages, p = *pp; p; pp = &p->next, p = *pp)
     if (p->bytes == entry_size)
       break;
 
@@ -817,7 +886,7 @@ alloc_page (unsigned order)
       /* We want just one page.  Allocate a bunch of them and put the
 	 extras on the freelist.  (Can only do this optimization with
 	 mmap for backing store.)  */
-      struct page_entry *e, *f = G.free_pages;
+      struct page_entry *e, *f = free_list->free_pages;
       int i, entries = GGC_QUIRE_SIZE;
 
       page = alloc_anon (NULL, G.pagesize * GGC_QUIRE_SIZE, false);
@@ -839,7 +908,7 @@ alloc_page (unsigned order)
 	  f = e;
 	}
 
-      G.free_pages = f;
+      free_list->free_pages = f;
     }
   else
     page = alloc_anon (NULL, entry_size, true);
@@ -899,7 +968,7 @@ alloc_page (unsigned order)
       /* If we allocated multiple pages, put the rest on the free list.  */
       if (multiple_pages)
 	{
-	  struct page_entry *e, *f = G.free_pages;
+	  struct page_entry *e, *f = free_list->free_pages;
 	  for (a = enda - G.pagesize; a != page; a -= G.pagesize)
 	    {
 	      e = XCNEWVAR (struct page_entry, page_entry_size);
@@ -910,7 +979,7 @@ alloc_page (unsigned order)
 	      e->next = f;
 	      f = e;
 	    }
-	  G.free_pages = f;
+	  free_list->free_pages = f;
 	}
     }
 #endif
@@ -1006,8 +1075,9 @@ free_page (page_entry *entry)
 
   adjust_depth ();
 
-  entry->next = G.free_pages;
-  G.free_pages = entry;
+  struct free_list *free_list = find_free_list (entry->bytes);
+  entry->next = free_list->free_pages;
+  free_list->free_pages = entry;
 }
 
 /* Release the free page cache to the system.  */
@@ -1024,129 +1094,142 @@ release_pages (void)
   size_t mapped_len;
   page_entry *next, *prev, *newprev;
   size_t free_unit = (GGC_QUIRE_SIZE/2) * G.pagesize;
+  int i;
 
   /* First free larger continuous areas to the OS.
      This allows other allocators to grab these areas if needed.
      This is only done on larger chunks to avoid fragmentation. 
-     This does not always work because the free_pages list is only
+     This does not always work because the free_pages lists are only
      approximately sorted. */
 
-  p = G.free_pages;
-  prev = NULL;
-  while (p)
+  for (i = 0; i < NUM_FREE_LISTS; i++)
     {
-      start = p->page;
-      start_p = p;
-      len = 0;
-      mapped_len = 0;
-      newprev = prev;
-      while (p && p->page == start + len)
-        {
-          len += p->bytes;
-	  if (!p->discarded)
-	      mapped_len += p->bytes;
-	  newprev = p;
-          p = p->next;
-        }
-      if (len >= free_unit)
-        {
-          while (start_p != p)
-            {
-              next = start_p->next;
-              free (start_p);
-              start_p = next;
-            }
-          munmap (start, len);
-	  if (prev)
-	    prev->next = p;
-          else
-            G.free_pages = p;
-          G.bytes_mapped -= mapped_len;
-	  n1 += len;
-	  continue;
-        }
-      prev = newprev;
-   }
+      p = G.free_lists[i].free_pages;
+      prev = NULL;
+      while (p)
+	{
+	  start = p->page;
+	  start_p = p;
+	  len = 0;
+	  mapped_len = 0;
+	  newprev = prev;
+	  while (p && p->page == start + len)
+	    {
+	      len += p->bytes;
+	      if (!p->discarded)
+		mapped_len += p->bytes;
+	      newprev = p;
+	      p = p->next;
+	    }
+	  if (len >= free_unit)
+	    {
+	      while (start_p != p)
+		{
+		  next = start_p->next;
+		  free (start_p);
+		  start_p = next;
+		}
+	      munmap (start, len);
+	      if (prev)
+		prev->next = p;
+	      else
+		G.free_lists[i].free_pages = p;
+	      G.bytes_mapped -= mapped_len;
+	      n1 += len;
+	      continue;
+	    }
+	  prev = newprev;
+	}
+    }
 
   /* Now give back the fragmented pages to the OS, but keep the address 
      space to reuse it next time. */
 
-  for (p = G.free_pages; p; )
-    {
-      if (p->discarded)
-        {
-          p = p->next;
-          continue;
-        }
-      start = p->page;
-      len = p->bytes;
-      start_p = p;
-      p = p->next;
-      while (p && p->page == start + len)
-        {
-          len += p->bytes;
-          p = p->next;
-        }
-      /* Give the page back to the kernel, but don't free the mapping.
-         This avoids fragmentation in the virtual memory map of the 
- 	 process. Next time we can reuse it by just touching it. */
-      madvise (start, len, MADV_DONTNEED);
-      /* Don't count those pages as mapped to not touch the garbage collector
-         unnecessarily. */
-      G.bytes_mapped -= len;
-      n2 += len;
-      while (start_p != p)
-        {
-          start_p->discarded = true;
-          start_p = start_p->next;
-        }
-    }
+  for (i = 0; i < NUM_FREE_LISTS; i++)
+    for (p = G.free_lists[i].free_pages; p; )
+      {
+	if (p->discarded)
+	  {
+	    p = p->next;
+	    continue;
+	  }
+	start = p->page;
+	len = p->bytes;
+	start_p = p;
+	p = p->next;
+	while (p && p->page == start + len)
+	  {
+	    len += p->bytes;
+	    p = p->next;
+	  }
+	/* Give the page back to the kernel, but don't free the mapping.
+	   This avoids fragmentation in the virtual memory map of the 
+	   process. Next time we can reuse it by just touching it. */
+	madvise (start, len, MADV_DONTNEED);
+	/* Don't count those pages as mapped to not touch the garbage collector
+	   unnecessarily. */
+	G.bytes_mapped -= len;
+	n2 += len;
+	while (start_p != p)
+	  {
+	    start_p->discarded = true;
+	    start_p = start_p->next;
+	  }
+      }
 #endif
 #if defined(USING_MMAP) && !defined(USING_MADVISE)
   page_entry *p, *next;
   char *start;
   size_t len;
+  int i;
 
   /* Gather up adjacent pages so they are unmapped together.  */
-  p = G.free_pages;
-
-  while (p)
+  for (i = 0; i < NUM_FREE_LISTS; i++)
     {
-      start = p->page;
-      next = p->next;
-      len = p->bytes;
-      free (p);
-      p = next;
+      p = G.free_lists[i].free_pages;
 
-      while (p && p->page == start + len)
+      while (p)
 	{
+	  start = p->page;
 	  next = p->next;
-	  len += p->bytes;
+	  len = p->bytes;
 	  free (p);
 	  p = next;
+
+	  while (p && p->page == start + len)
+	    {
+	      next = p->next;
+	      len += p->bytes;
+	      free (p);
+	      p = next;
+	    }
+
+	  munmap (start, len);
+	  n1 += len;
+	  G.bytes_mapped -= len;
 	}
 
-      munmap (start, len);
-      n1 += len;
-      G.bytes_mapped -= len;
+      G.free_lists[i].free_pages = NULL;
     }
-
-  G.free_pages = NULL;
 #endif
 #ifdef USING_MALLOC_PAGE_GROUPS
   page_entry **pp, *p;
   page_group **gp, *g;
+  int i;
 
-  /* Remove all pages from free page groups from the list.  */
-  pp = &G.free_pages;
-  while ((p = *pp) != NULL)
-    if (p->group->in_use == 0)
-      {
-	*pp = p->next;
-	free (p);
-      }
-    else
-      pp = &p->next;
+  /* Remove all pages from free page groups from the lists.  */
+  for (i = 0; i < NUM_FREE_LISTS; i++)
+    {
+      pp = &G.free_lists[i].free_pages;
+      while ((p = *pp) != NULL)
+	if (p->group->in_use == 0)
+	  {
+	    *pp = p->next;
+	    free (p);
+	  }
+	else
+	  pp = &p->next;
+    }
 
   /* Remove all free page groups, and release the storage.  */
   gp = &G.page_groups;
@@ -1174,7 +1257,6 @@ release_pages (void)
 
 /* This table provides a fast way to determine ceil(log_2(size)) for
    allocation requests.  The minimum allocation size is eight bytes.  */
-#define NUM_SIZE_LOOKUP 512
 static unsigned char size_lookup[NUM_SIZE_LOOKUP] =
 {
   3, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4,
@@ -1445,6 +1527,11 @@ ggc_internal_alloc (size_t size, void (*f)(void *), size_t s, size_t n
 	  G.stats.total_overhead_under128 += overhead;
 	  G.stats.total_allocated_under128 += object_size;
 	}
+      if (size < NUM_SIZE_LOOKUP)
+	{
+	  G.stats.count_per_size[size]++;
+	  G.stats.overhead_per_size[size] += overhead;
+	}
     }
 
   if (GGC_DEBUG_LEVEL >= 3)
@@ -1766,8 +1853,9 @@ init_ggc (void)
     e = XCNEW (struct page_entry);
     e->bytes = G.pagesize;
     e->page = p;
-    e->next = G.free_pages;
-    G.free_pages = e;
+    struct free_list *free_list = find_free_list (e->bytes);
+    e->next = free_list->free_pages;
+    free_list->free_pages = e;
   }
 #endif
 
@@ -2075,10 +2163,13 @@ sweep_pages (void)
       while (! done);
 
       /* Now, restore the in_use_p vectors for any pages from contexts
-         other than the current one.  */
-      for (p = G.pages[order]; p; p = p->next)
-	if (p->context_depth != G.context_depth)
-	  ggc_recalculate_in_use_p (p);
+         other than the current one.  Every page is in the topmost
+         context unless one has been pushed (for a PCH), so avoid
+         walking the whole page list a second time in that case.  */
+      if (G.context_depth != 0)
+	for (p = G.pages[order]; p; p = p->next)
+	  if (p->context_depth != G.context_depth)
+	    ggc_recalculate_in_use_p (p);
     }
 }
 
@@ -2378,6 +2469,18 @@ ggc_print_statistics (void)
 		     (uint64_t)OBJECT_SIZE (i),
 		     SIZE_AMOUNT (G.stats.total_allocated_per_order[i]));
 	  }
+
+      /* Show which requested sizes lose memory to rounding, so that the
+	 worst offenders can be given an extra order of their own.  */
+      fprintf (stderr, "\nRounding overhead by requested size\n");
+      fprintf (stderr, "%-8s %-8s %10s  %10s\n",
+	       "Size", "Rounded", "Count", "Overhead");
+      for (i = 0; i < NUM_SIZE_LOOKUP; i++)
+	if (G.stats.overhead_per_size[i])
+	  fprintf (stderr, "%-8u %-8" PRIu64 " " PRsa (10) " " PRsa (10) "\n",
+		   i, (uint64_t)OBJECT_SIZE (size_lookup[i]),
+		   SIZE_AMOUNT (G.stats.count_per_size[i]),
+		   SIZE_AMOUNT (G.stats.overhead_per_size[i]));
   }
 }
 
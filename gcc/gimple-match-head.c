@@ -46,17 +46,18 @@ along with GCC; see the file COPYING3.  If not see
 
 /* Forward declarations of the private auto-generated matchers.
    They expect valueized operands in canonical order and do not
-   perform simplification of all-constant operands.  */
-static bool gimple_simplify (gimple_match_op *, gimple_seq *, tree (*)(tree),
-			     code_helper, tree, tree);
-static bool gimple_simplify (gimple_match_op *, gimple_seq *, tree (*)(tree),
-			     code_helper, tree, tree, tree);
-static bool gimple_simplify (gimple_match_op *, gimple_seq *, tree (*)(tree),
-			     code_helper, tree, tree, tree, tree);
-static bool gimple_simplify (gimple_match_op *, gimple_seq *, tree (*)(tree),
-			     code_helper, tree, tree, tree, tree, tree);
-static bool gimple_simplify (gimple_match_op *, gimple_seq *, tree (*)(tree),
-			     code_helper, tree, tree, tree, tree, tree, tree);
+   perform simplification of all-constant operands.  They are not
+   static since genmatch may split its output over several files.  */
+bool gimple_simplify (gimple_match_op *, gimple_seq *, tree (*)(tree),
+		      code_helper, tree, tree);
+bool gimple_simplify (gimple_match_op *, gimple_seq *, tree (*)(tree),
+		      code_helper, tree, tree, tree);
+bool gimple_simplify (gimple_match_op *, gimple_seq *, tree (*)(tree),
+		      code_helper, tree, tree, tree, tree);
+bool gimple_simplify (gimple_match_op *, gimple_seq *, tree (*)(tree),
+		      code_helper, tree, tree, tree, tree, tree);
+bool gimple_simplify (gimple_match_op *, gimple_seq *, tree (*)(tree),
+		      code_helper, tree, tree, tree, tree, tree, tree);
 static bool gimple_resimplify1 (gimple_seq *, gimple_match_op *,
 				tree (*)(tree));
 static bool gimple_resimplify2 (gimple_seq *, gimple_match_op *,
@@ -68,7 +69,9 @@ static bool gimple_resimplify4 (gimple_seq *, gimple_match_op *,
 static bool gimple_resimplify5 (gimple_seq *, gimple_match_op *,
 				tree (*)(tree));
 
+#ifndef GENMATCH_SECONDARY_PART
 const unsigned int gimple_match_op::MAX_NUM_OPS;
+#endif
 
 /* Return whether T is a constant that we'll dispatch to fold to
    evaluate fully constant expressions.  */
@@ -449,6 +452,11 @@ gimple_resimplify5 (gimple_seq *seq, gimple_match_op *res_op,
   return false;
 }
 
+/* The rest of the public interface, up to the helpers for the
+   autogenerated code, is defined only once if genmatch splits its
+   output over several files.  */
+#ifndef GENMATCH_SECONDARY_PART
+
 /* Match and simplify the toplevel valueized operation THIS.
    Replaces THIS with a simplified and/or canonicalized result and
    returns whether any change was made.  */
@@ -1062,6 +1070,8 @@ gimple_simplify (gimple *stmt, gimple_match_op *res_op, gimple_seq *seq,
   return false;
 }
 
+#endif /* GENMATCH_SECONDARY_PART */
+
 
 /* Helper for the autogenerated code, valueize OP.  */
 
@@ -342,7 +342,16 @@ builtin_memref::extend_offset_range (tree offset)
       /* A pointer offset is represented as sizetype but treated
 	 as signed.  */
       wide_int min, max;
-      value_range_kind rng = get_range_info (offset, &min, &max);
+      value_range_kind rng = VR_VARYING;
+      /* Refine the global range of the offset from its definition,
+	 which matters when VRP has not run.  */
+      value_range_base vr = ssa_range_query ().range_of_expr (offset);
+      if (vr.constant_p ())
+	{
+	  rng = vr.kind ();
+	  min = wi::to_wide (vr.min ());
+	  max = wi::to_wide (vr.max ());
+	}
       if (rng == VR_ANTI_RANGE && wi::lts_p (max, min))
 	{
 	  /* Convert an anti-range whose upper bound is less than
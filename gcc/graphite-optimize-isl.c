@@ -41,15 +41,67 @@ along with GCC; see the file COPYING3.  If not see
 #include "graphite.h"
 
 
+/* Return the size of the tiles to use for the loop nests of SCOP.  Unless
+   --param loop-block-tile-size is given explicitly, choose the size so
+   that a two-dimensional tile of each array accessed in SCOP fits in the
+   L1 cache.  */
+
+static long
+scop_tile_size (scop_p scop)
+{
+  if (global_options_set.x_param_values[PARAM_LOOP_BLOCK_TILE_SIZE])
+    return PARAM_VALUE (PARAM_LOOP_BLOCK_TILE_SIZE);
+
+  /* Count the distinct arrays and find the largest element size.  */
+  unsigned n_bases = 0;
+  unsigned HOST_WIDE_INT elt_size = 1;
+  int i, j;
+  dr_info *dri, *drj;
+  FOR_EACH_VEC_ELT (scop->drs, i, dri)
+    {
+      tree size = TYPE_SIZE_UNIT (TREE_TYPE (DR_REF (dri->dr)));
+      if (size && tree_fits_uhwi_p (size))
+	elt_size = MAX (elt_size, tree_to_uhwi (size));
+
+      bool seen = false;
+      FOR_EACH_VEC_ELT (scop->drs, j, drj)
+	{
+	  if (j >= i)
+	    break;
+	  if (operand_equal_p (DR_BASE_ADDRESS (dri->dr),
+			       DR_BASE_ADDRESS (drj->dr), 0))
+	    {
+	      seen = true;
+	      break;
+	    }
+	}
+      if (!seen)
+	n_bases++;
+    }
+
+  unsigned HOST_WIDE_INT cache_bytes
+    = (unsigned HOST_WIDE_INT) PARAM_VALUE (PARAM_L1_CACHE_SIZE) * 1024;
+  unsigned HOST_WIDE_INT elts = cache_bytes / (MAX (n_bases, 1) * elt_size);
+  long tile_size = 1;
+  while ((unsigned HOST_WIDE_INT) (tile_size + 1) * (tile_size + 1) <= elts)
+    tile_size++;
+
+  /* Tiles smaller than a few cache lines only add loop overhead.  */
+  if (tile_size < 8)
+    tile_size = 8;
+  if (dump_file && dump_flags)
+    fprintf (dump_file, "tile size %ld for %u arrays, element size %u\n",
+	     tile_size, n_bases, (unsigned) elt_size);
+  return tile_size;
+}
+
 /* get_schedule_for_node_st - Improve schedule for the schedule node.
-   Only Simple loop tiling is considered.  */
+   Only Simple loop tiling is considered.  USER points to the tile size
+   to use.  */
 
 static __isl_give isl_schedule_node *
 get_schedule_for_node_st (__isl_take isl_schedule_node *node, void *user)
 {
-  if (user)
-    return node;
-
   if (isl_schedule_node_get_type (node) != isl_schedule_node_band
       || isl_schedule_node_n_children (node) != 1)
     return node;
@@ -64,7 +116,7 @@ get_schedule_for_node_st (__isl_take isl_schedule_node *node, void *user)
   if (type != isl_schedule_node_leaf)
     return node;
 
-  long tile_size = PARAM_VALUE (PARAM_LOOP_BLOCK_TILE_SIZE);
+  long tile_size = *(long *) user;
   if (dims <= 1
       || tile_size == 0
       || !isl_schedule_node_band_get_permutable (node))
@@ -149,10 +201,12 @@ optimize_isl (scop_p scop)
      in the upper bound.  See the isl manual for more details.  */
   isl_options_set_ast_build_atomic_upper_bound (scop->isl_context, 1);
 
+  long tile_size = scop_tile_size (scop);
   scop->transformed_schedule = isl_schedule_constraints_compute_schedule (sc);
   scop->transformed_schedule =
     isl_schedule_map_schedule_node_bottom_up (scop->transformed_schedule,
-					      get_schedule_for_node_st, NULL);
+					      get_schedule_for_node_st,
+					      &tile_size);
 
   isl_options_set_on_error (scop->isl_context, old_err);
   isl_ctx_reset_operations (scop->isl_context);
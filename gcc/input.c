@@ -133,10 +133,14 @@ class line_maps *line_table;
 
 class line_maps *saved_line_table;
 
+/* A build emitting many diagnostics typically refers to lines of many
+   different headers, and a file that is evicted from the cache has to
+   be read again from the beginning, so keep a generous number of files
+   and of recorded line boundaries per file.  */
 static fcache *fcache_tab;
-static const size_t fcache_tab_size = 16;
-static const size_t fcache_buffer_size = 4 * 1024;
-static const size_t fcache_line_record_size = 100;
+static const size_t fcache_tab_size = 64;
+static const size_t fcache_buffer_size = 16 * 1024;
+static const size_t fcache_line_record_size = 1000;
 
 /* Expand the source location LOC into a human readable location.  If
    LOC resolves to a builtin location, the file name of the readable
@@ -286,10 +290,12 @@ lookup_file_in_cache_tab (const char *file_path)
   for (unsigned i = 0; i < fcache_tab_size; ++i)
     {
       fcache *c = &fcache_tab[i];
-      if (c->file_path && !strcmp (c->file_path, file_path))
+      if (c->file_path
+	  && (c->file_path == file_path || !strcmp (c->file_path, file_path)))
 	{
 	  ++c->use_count;
 	  r = c;
+	  break;
 	}
     }
 
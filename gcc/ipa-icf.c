@@ -3376,6 +3376,24 @@ sort_congruence_class_groups_by_decl_uid (const void *a, const void *b)
   return g1->second - g2->second;
 }
 
+/* Return the estimated size of ITEM: the number of instructions of a
+   function, or the number of bytes of a variable.  */
+
+static unsigned HOST_WIDE_INT
+sem_item_size (sem_item *item)
+{
+  if (item->type == FUNC)
+    {
+      cgraph_node *node = dyn_cast <cgraph_node *> (item->node);
+      ipa_fn_summary *s
+	= ipa_fn_summaries ? ipa_fn_summaries->get (node) : NULL;
+      return s ? s->self_size : 0;
+    }
+
+  tree size = DECL_SIZE_UNIT (item->decl);
+  return size && tree_fits_uhwi_p (size) ? tree_to_uhwi (size) : 0;
+}
+
 /* After reduction is done, we can declare all items in a group
    to be equal. PREV_CLASS_COUNT is start number of classes
    before reduction. True is returned if there's a merge operation
@@ -3451,6 +3469,7 @@ sem_item_optimizer::merge_classes (unsigned int prev_class_count)
 
   unsigned int l;
   std::pair<congruence_class_group *, int> *it;
+  unsigned HOST_WIDE_INT total_function_saved = 0, total_variable_saved = 0;
   FOR_EACH_VEC_ELT (classes, l, it)
     for (unsigned int i = 0; i < it->first->classes.length (); i++)
       {
@@ -3460,6 +3479,8 @@ sem_item_optimizer::merge_classes (unsigned int prev_class_count)
 	  continue;
 
 	sem_item *source = c->members[0];
+	unsigned int class_merged = 0;
+	unsigned HOST_WIDE_INT class_saved = 0;
 
 	if (DECL_NAME (source->decl)
 	    && MAIN_NAME_P (DECL_NAME (source->decl)))
@@ -3505,9 +3526,16 @@ sem_item_optimizer::merge_classes (unsigned int prev_class_count)
 
 	    if (dbg_cnt (merged_ipa_icf))
 	      {
+		unsigned HOST_WIDE_INT size = sem_item_size (alias);
 		bool merged = source->merge (alias);
 		merged_p |= merged;
 
+		if (merged)
+		  {
+		    class_merged++;
+		    class_saved += size;
+		  }
+
 		if (merged && alias->type == VAR)
 		  {
 		    symtab_pair p = symtab_pair (source->node, alias->node);
@@ -3515,8 +3543,31 @@ sem_item_optimizer::merge_classes (unsigned int prev_class_count)
 		  }
 	      }
 	  }
+
+	if (class_merged == 0)
+	  continue;
+	if (source->type == FUNC)
+	  total_function_saved += class_saved;
+	else
+	  total_variable_saved += class_saved;
+	if (dump_enabled_p ())
+	  dump_printf_loc (MSG_OPTIMIZED_LOCATIONS,
+			   dump_user_location_t::from_function_decl
+			     (source->decl),
+			   "Merged %u of %u members of the class of %s,"
+			   " saving about %wu %s\n",
+			   class_merged, c->members.length (),
+			   xstrdup_for_dump (source->node->name ()),
+			   class_saved,
+			   source->type == FUNC ? "instructions" : "bytes");
       }
 
+  if (dump_file)
+    fprintf (dump_file, "Estimated savings: " HOST_WIDE_INT_PRINT_UNSIGNED
+	     " instructions in functions, " HOST_WIDE_INT_PRINT_UNSIGNED
+	     " bytes in variables\n",
+	     total_function_saved, total_variable_saved);
+
   if (!m_merged_variables.is_empty ())
     fixup_points_to_sets ();
 
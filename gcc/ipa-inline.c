@@ -2073,6 +2073,12 @@ inline_small_functions (void)
 	  if (dump_flags & TDF_DETAILS)
 	    edge_badness (edge, true);
 	}
+      if (dump_enabled_p ())
+	dump_printf_loc (MSG_NOTE, edge->call_stmt,
+			 " Considering inlining %C into %C: badness %f,"
+			 " growth %i, frequency %f\n",
+			 callee, edge->caller, badness.to_double (), growth,
+			 edge->sreal_frequency ().to_double ());
 
       if (overall_size + growth > max_size
 	  && !DECL_DISREGARD_INLINE_LIMITS (callee->decl))
@@ -2183,9 +2189,11 @@ inline_small_functions (void)
 
 	  dump_printf_loc (MSG_OPTIMIZED_LOCATIONS, edge->call_stmt,
 			   " Inlined %C into %C which now has time %f and "
-			   "size %i, net change of %s.\n",
+			   "size %i, net change of %s (badness %f, "
+			   "growth %i).\n",
 			   edge->callee, edge->caller,
-			   s->time.to_double (), s->size, buf_net_change);
+			   s->time.to_double (), s->size, buf_net_change,
+			   badness.to_double (), growth);
 	}
       if (min_size > overall_size)
 	{
@@ -75,6 +75,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "gimple-walk.h"
 #include "tree-dfa.h"
 #include "tree-sra.h"
+#include "alloc-pool.h"
 #include "symbol-summary.h"
 #include "params.h"
 #include "dbgcnt.h"
@@ -428,11 +429,12 @@ static GTY(()) ipa_sra_function_summaries *func_sums;
 
 /* Class to manage call summaries.  */
 
-class ipa_sra_call_summaries: public call_summary <isra_call_summary *>
+class ipa_sra_call_summaries
+  : public fast_call_summary <isra_call_summary *, va_heap>
 {
 public:
   ipa_sra_call_summaries (symbol_table *table):
-    call_summary<isra_call_summary *> (table) { }
+    fast_call_summary<isra_call_summary *, va_heap> (table) { }
 
   /* Duplicate info when an edge is cloned.  */
   virtual void duplicate (cgraph_edge *, cgraph_edge *,
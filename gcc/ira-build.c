@@ -1143,15 +1143,22 @@ finish_allocno (ira_allocno_t a)
   allocno_pool.remove (a);
 }
 
-/* Free the memory allocated for all allocnos.  */
+/* Free the memory allocated for all allocnos.  The allocnos, their
+   objects and live ranges are released with their pools as a whole, and
+   their cost vectors with the pools of cost vectors right after, so
+   only the conflict arrays need to be freed one by one.  */
 static void
 finish_allocnos (void)
 {
   ira_allocno_t a;
   ira_allocno_iterator ai;
+  ira_object_t obj;
+  ira_allocno_object_iterator oi;
 
   FOR_EACH_ALLOCNO (a, ai)
-    finish_allocno (a);
+    FOR_EACH_ALLOCNO_OBJECT (a, obj, oi)
+      if (OBJECT_CONFLICT_ARRAY (obj) != NULL)
+	ira_free (OBJECT_CONFLICT_ARRAY (obj));
   ira_free (ira_regno_allocno_map);
   ira_object_id_map_vec.release ();
   allocno_vec.release ();
@@ -1334,15 +1341,10 @@ ira_remove_allocno_prefs (ira_allocno_t a)
   ALLOCNO_PREFS (a) = NULL;
 }
 
-/* Free memory allocated for all prefs.  */
+/* Free memory allocated for all prefs, all at once.  */
 static void
 finish_prefs (void)
 {
-  ira_pref_t pref;
-  ira_pref_iterator pi;
-
-  FOR_EACH_PREF (pref, pi)
-    finish_pref (pref);
   pref_vec.release ();
   pref_pool.release ();
 }
@@ -1593,15 +1595,10 @@ finish_copy (ira_copy_t cp)
 }
 
 
-/* Free memory allocated for all copies.  */
+/* Free memory allocated for all copies, all at once.  */
 static void
 finish_copies (void)
 {
-  ira_copy_t cp;
-  ira_copy_iterator ci;
-
-  FOR_EACH_COPY (cp, ci)
-    finish_copy (cp);
   copy_vec.release ();
   copy_pool.release ();
 }
@@ -3449,7 +3446,9 @@ ira_build (void)
   setup_min_max_allocno_live_range_point ();
   sort_conflict_id_map ();
   setup_min_max_conflict_allocno_ids ();
+  timevar_push (TV_IRA_CONFLICTS);
   ira_build_conflicts ();
+  timevar_pop (TV_IRA_CONFLICTS);
   update_conflict_hard_reg_costs ();
   if (! ira_conflicts_p)
     {
@@ -5338,7 +5338,9 @@ ira (FILE *f)
 
   if (internal_flag_ira_verbose > 0 && ira_dump_file != NULL)
     fprintf (ira_dump_file, "Building IRA IR\n");
+  timevar_push (TV_IRA_BUILD);
   loops_p = ira_build ();
+  timevar_pop (TV_IRA_BUILD);
 
   ira_assert (ira_conflicts_p || !loops_p);
 
@@ -5351,13 +5353,17 @@ ira (FILE *f)
        value and sharing slots does not guarantee it.  */
     flag_ira_share_spill_slots = FALSE;
 
+  timevar_push (TV_IRA_COLOR);
   ira_color ();
+  timevar_pop (TV_IRA_COLOR);
 
   ira_max_point_before_emit = ira_max_point;
 
   ira_initiate_emit_data ();
 
+  timevar_push (TV_IRA_EMIT);
   ira_emit (loops_p);
+  timevar_pop (TV_IRA_EMIT);
 
   max_regno = max_reg_num ();
   if (ira_conflicts_p)
@@ -93,6 +93,8 @@ const int NUM_GCC_JIT_TYPES = GCC_JIT_TYPE_COMPLEX_LONG_DOUBLE + 1;
 
    End of comment for inclusion in the docs.  */
 
+struct md5_ctx; // declared within md5.h
+
 namespace gcc {
 
 namespace jit {
@@ -166,6 +168,8 @@ public:
   dump (recording::context &ctxt,
 	const char *filename,
 	bool update_locations);
+  dump (recording::context &ctxt,
+	struct md5_ctx *md5_ctx);
   ~dump ();
 
   recording::context &get_context () { return m_ctxt; }
@@ -187,6 +191,10 @@ private:
   int m_line;
   int m_column;
   FILE *m_file;
+
+  /* If non-NULL, the dump is accumulated into this hash rather than
+     written to a file.  */
+  struct md5_ctx *m_md5_ctx;
 };
 
 /* A hidden enum of boolean options that are only exposed via API
@@ -196,6 +204,7 @@ enum inner_bool_option
 {
   INNER_BOOL_OPTION_ALLOW_UNREACHABLE_BLOCKS,
   INNER_BOOL_OPTION_USE_EXTERNAL_DRIVER,
+  INNER_BOOL_OPTION_COMPILE_IN_SUBPROCESS,
 
   NUM_INNER_BOOL_OPTIONS
 };
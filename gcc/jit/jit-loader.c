@@ -0,0 +1,630 @@
+/* Loading object files into memory within libgccjit.so
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+GCC is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "config.h"
+#include "system.h"
+#include "coretypes.h"
+
+#include "jit-loader.h"
+
+namespace gcc {
+
+namespace jit {
+
+#if JIT_HAVE_LOADER
+
+/* The subset of the ELF64 format used by the loader.  */
+
+struct elf64_ehdr
+{
+  unsigned char e_ident[16];
+  uint16_t e_type;
+  uint16_t e_machine;
+  uint32_t e_version;
+  uint64_t e_entry;
+  uint64_t e_phoff;
+  uint64_t e_shoff;
+  uint32_t e_flags;
+  uint16_t e_ehsize;
+  uint16_t e_phentsize;
+  uint16_t e_phnum;
+  uint16_t e_shentsize;
+  uint16_t e_shnum;
+  uint16_t e_shstrndx;
+};
+
+struct elf64_shdr
+{
+  uint32_t sh_name;
+  uint32_t sh_type;
+  uint64_t sh_flags;
+  uint64_t sh_addr;
+  uint64_t sh_offset;
+  uint64_t sh_size;
+  uint32_t sh_link;
+  uint32_t sh_info;
+  uint64_t sh_addralign;
+  uint64_t sh_entsize;
+};
+
+struct elf64_sym
+{
+  uint32_t st_name;
+  unsigned char st_info;
+  unsigned char st_other;
+  uint16_t st_shndx;
+  uint64_t st_value;
+  uint64_t st_size;
+};
+
+struct elf64_rela
+{
+  uint64_t r_offset;
+  uint64_t r_info;
+  int64_t r_addend;
+};
+
+#define ELFCLASS64 2
+#define ELFDATA2LSB 1
+#define ET_REL 1
+#define EM_X86_64 62
+
+#define SHT_SYMTAB 2
+#define SHT_RELA 4
+#define SHT_NOBITS 8
+#define SHT_REL 9
+#define SHT_INIT_ARRAY 14
+#define SHT_FINI_ARRAY 15
+#define SHT_PREINIT_ARRAY 16
+#define SHT_SYMTAB_SHNDX 18
+
+#define SHF_ALLOC 0x2
+#define SHF_EXECINSTR 0x4
+#define SHF_TLS 0x400
+
+#define SHN_UNDEF 0
+#define SHN_LORESERVE 0xff00
+#define SHN_ABS 0xfff1
+#define SHN_COMMON 0xfff2
+
+#define STB_LOCAL 0
+#define STB_WEAK 2
+#define STT_TLS 6
+#define STT_GNU_IFUNC 10
+
+#define R_X86_64_NONE 0
+#define R_X86_64_64 1
+#define R_X86_64_PC32 2
+#define R_X86_64_PLT32 4
+#define R_X86_64_GOTPCREL 9
+#define R_X86_64_32 10
+#define R_X86_64_32S 11
+#define R_X86_64_PC64 24
+#define R_X86_64_GOTOFF64 25
+#define R_X86_64_GOTPC32 26
+#define R_X86_64_GOTPCRELX 41
+#define R_X86_64_REX_GOTPCRELX 42
+
+/* Each stub is "jmp *0(%rip)" followed by the 8-byte target, padded.  */
+#define STUB_SIZE 16
+
+#define ROUND_UP_TO(X, ALIGN) (((X) + (ALIGN) - 1) & ~((ALIGN) - 1))
+
+typedef void (*register_frame_fn) (void *);
+
+/* Read the file at PATH into a malloc'ed buffer, storing its size in
+   *SIZE.  Return NULL on failure.  */
+
+static char *
+read_file (const char *path, size_t *size)
+{
+  FILE *f = fopen (path, "rb");
+  if (!f)
+    return NULL;
+
+  struct stat st;
+  if (fstat (fileno (f), &st) != 0)
+    {
+      fclose (f);
+      return NULL;
+    }
+
+  char *buf = XNEWVEC (char, st.st_size);
+  if (fread (buf, 1, st.st_size, f) != (size_t) st.st_size)
+    {
+      fclose (f);
+      free (buf);
+      return NULL;
+    }
+  fclose (f);
+  *size = st.st_size;
+  return buf;
+}
+
+/* Return true if VALUE fits in a signed 32-bit relocation field.  */
+
+static bool
+fits_int32_p (int64_t value)
+{
+  return value == (int64_t) (int32_t) value;
+}
+
+#endif /* JIT_HAVE_LOADER */
+
+/* Constructor for gcc::jit::loaded_object.
+   The real work is done by the load method.  */
+
+loaded_object::loaded_object (logger *logger)
+  : log_user (logger),
+    m_region (NULL),
+    m_region_size (0),
+    m_eh_frame (NULL),
+    m_strtab (NULL),
+    m_symbols ()
+{
+  JIT_LOG_SCOPE (get_logger ());
+}
+
+/* gcc::jit::loaded_object's destructor.  */
+
+loaded_object::~loaded_object ()
+{
+  JIT_LOG_SCOPE (get_logger ());
+  unmap ();
+}
+
+/* Load the relocatable object file at PATH into memory, returning
+   true on success.  On failure, the reason is logged, and nothing is
+   left mapped.  */
+
+bool
+loaded_object::load (const char *path)
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  size_t file_size;
+  char *file = NULL;
+#if JIT_HAVE_LOADER
+  file = read_file (path, &file_size);
+#endif
+  if (!file)
+    return fail ("unable to load %s", path);
+
+  bool ok = load_1 (file, file_size);
+  free (file);
+  if (!ok)
+    unmap ();
+  return ok;
+}
+
+/* Log a message describing why the object can't be loaded, and return
+   false.  */
+
+bool
+loaded_object::fail (const char *fmt, ...) const
+{
+  if (get_logger ())
+    {
+      va_list ap;
+      va_start (ap, fmt);
+      get_logger ()->log_va (fmt, ap);
+      va_end (ap);
+    }
+  return false;
+}
+
+/* Release everything held by this object.  */
+
+void
+loaded_object::unmap ()
+{
+#if JIT_HAVE_LOADER
+  if (m_eh_frame)
+    {
+      register_frame_fn deregister_frame
+	= (register_frame_fn) dlsym (RTLD_DEFAULT, "__deregister_frame");
+      if (deregister_frame)
+	deregister_frame (m_eh_frame);
+      m_eh_frame = NULL;
+    }
+  if (m_region)
+    {
+      munmap (m_region, m_region_size);
+      m_region = NULL;
+    }
+#endif
+  free (m_strtab);
+  m_strtab = NULL;
+  m_symbols.truncate (0);
+}
+
+/* Comparison function for sorting and searching m_symbols by name.  */
+
+int
+loaded_object::compare_symbols (const void *p1, const void *p2)
+{
+  const symbol *s1 = (const symbol *) p1;
+  const symbol *s2 = (const symbol *) p2;
+  return strcmp (s1->m_name, s2->m_name);
+}
+
+/* Look up the global symbol NAME within the loaded object, returning
+   NULL if it isn't defined.  */
+
+void *
+loaded_object::get_symbol (const char *name) const
+{
+  symbol key;
+  key.m_name = name;
+  key.m_addr = NULL;
+  const symbol *s
+    = (const symbol *) bsearch (&key, m_symbols.address (),
+				m_symbols.length (), sizeof (symbol),
+				compare_symbols);
+  return s ? s->m_addr : NULL;
+}
+
+/* Worker for loaded_object::load, loading the object file contents
+   FILE of size FILE_SIZE.  */
+
+bool
+loaded_object::load_1 (const char *file ATTRIBUTE_UNUSED,
+		       size_t file_size ATTRIBUTE_UNUSED)
+{
+#if JIT_HAVE_LOADER
+  const elf64_ehdr *ehdr = (const elf64_ehdr *) file;
+  if (file_size < sizeof (elf64_ehdr)
+      || memcmp (ehdr->e_ident, "\177ELF", 4) != 0
+      || ehdr->e_ident[4] != ELFCLASS64
+      || ehdr->e_ident[5] != ELFDATA2LSB
+      || ehdr->e_type != ET_REL
+      || ehdr->e_machine != EM_X86_64
+      || ehdr->e_shentsize != sizeof (elf64_shdr)
+      || ehdr->e_shnum == 0
+      || ehdr->e_shstrndx >= ehdr->e_shnum
+      || ehdr->e_shoff > file_size
+      || (file_size - ehdr->e_shoff) / sizeof (elf64_shdr) < ehdr->e_shnum)
+    return fail ("not a supported relocatable object");
+
+  const elf64_shdr *shdrs = (const elf64_shdr *) (file + ehdr->e_shoff);
+  unsigned int shnum = ehdr->e_shnum;
+  const elf64_shdr *shstrtab = &shdrs[ehdr->e_shstrndx];
+
+  /* Find the symbol table, and check the sections' bounds.  */
+  unsigned int symtab_idx = 0;
+  for (unsigned int i = 0; i < shnum; i++)
+    {
+      const elf64_shdr *sh = &shdrs[i];
+      if (sh->sh_type != SHT_NOBITS
+	  && (sh->sh_offset > file_size
+	      || sh->sh_size > file_size - sh->sh_offset))
+	return fail ("section %u is out of bounds", i);
+      if (sh->sh_type == SHT_SYMTAB)
+	symtab_idx = i;
+      else if (sh->sh_type == SHT_SYMTAB_SHNDX)
+	return fail ("extended section indices are not supported");
+    }
+  if (symtab_idx == 0 || shdrs[symtab_idx].sh_link >= shnum)
+    return fail ("no symbol table");
+
+  const elf64_shdr *symtab = &shdrs[symtab_idx];
+  const elf64_shdr *strtab = &shdrs[symtab->sh_link];
+  const elf64_sym *syms = (const elf64_sym *) (file + symtab->sh_offset);
+  size_t nsyms = symtab->sh_size / sizeof (elf64_sym);
+  const char *names = file + strtab->sh_offset;
+  for (size_t i = 0; i < nsyms; i++)
+    if (syms[i].st_name >= strtab->sh_size)
+      return fail ("symbol %lu has a bad name", (unsigned long) i);
+  if (strtab->sh_size == 0 || names[strtab->sh_size - 1] != '\0')
+    return fail ("bad string table");
+
+  /* Lay out the allocated sections: executable ones first, followed by
+     the stubs for calls to functions outside the object; then, on
+     separate pages, everything else, followed by the GOT and any common
+     symbols.  The GOT and the stubs have a slot for every symbol.  */
+  auto_vec<size_t> offsets;
+  offsets.safe_grow_cleared (shnum);
+  size_t eh_frame_idx = 0;
+  size_t size = 0;
+  size_t stubs_offset = 0;
+  size_t text_size = 0;
+  size_t page_size = getpagesize ();
+  for (int exec = 1; exec >= 0; exec--)
+    {
+      for (unsigned int i = 0; i < shnum; i++)
+	{
+	  const elf64_shdr *sh = &shdrs[i];
+	  if (!(sh->sh_flags & SHF_ALLOC)
+	      || !(sh->sh_flags & SHF_EXECINSTR) != !exec)
+	    continue;
+	  if (sh->sh_flags & SHF_TLS)
+	    return fail ("thread-local storage is not supported");
+	  if (sh->sh_type == SHT_INIT_ARRAY
+	      || sh->sh_type == SHT_FINI_ARRAY
+	      || sh->sh_type == SHT_PREINIT_ARRAY)
+	    return fail ("constructors are not supported");
+	  size_t align = sh->sh_addralign ? sh->sh_addralign : 1;
+	  if (align & (align - 1))
+	    return fail ("section %u has bad alignment", i);
+	  size = ROUND_UP_TO (size, align);
+	  offsets[i] = size;
+	  size += sh->sh_size;
+	  if (shstrtab->sh_type != SHT_NOBITS
+	      && sh->sh_name < shstrtab->sh_size
+	      && strcmp (file + shstrtab->sh_offset + sh->sh_name,
+			 ".eh_frame") == 0)
+	    {
+	      eh_frame_idx = i;
+	      /* Leave room for the terminating zero-length entry.  */
+	      size += 4;
+	    }
+	}
+      if (exec)
+	{
+	  stubs_offset = size = ROUND_UP_TO (size, STUB_SIZE);
+	  size += nsyms * STUB_SIZE;
+	  text_size = size = ROUND_UP_TO (size, page_size);
+	}
+    }
+  size = ROUND_UP_TO (size, 8);
+  size_t got_offset = size;
+  size += nsyms * 8;
+
+  auto_vec<size_t> common_offsets;
+  common_offsets.safe_grow_cleared (nsyms);
+  for (size_t i = 0; i < nsyms; i++)
+    if (syms[i].st_shndx == SHN_COMMON)
+      {
+	size_t align = syms[i].st_value ? syms[i].st_value : 1;
+	if (align & (align - 1))
+	  return fail ("symbol %lu has bad alignment", (unsigned long) i);
+	size = ROUND_UP_TO (size, align);
+	common_offsets[i] = size;
+	size += syms[i].st_size;
+      }
+  size = ROUND_UP_TO (size, page_size);
+
+  void *region = mmap (NULL, size, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (region == MAP_FAILED)
+    return fail ("unable to map %lu bytes", (unsigned long) size);
+  m_region = (char *) region;
+  m_region_size = size;
+  log ("mapped %lu bytes at %p", (unsigned long) size, region);
+
+  for (unsigned int i = 0; i < shnum; i++)
+    if ((shdrs[i].sh_flags & SHF_ALLOC) && shdrs[i].sh_type != SHT_NOBITS)
+      memcpy (m_region + offsets[i], file + shdrs[i].sh_offset,
+	      shdrs[i].sh_size);
+
+  /* Compute the address of each symbol.  */
+  auto_vec<uintptr_t> addrs;
+  addrs.safe_grow_cleared (nsyms);
+  auto_vec<bool> external;
+  external.safe_grow_cleared (nsyms);
+  for (size_t i = 1; i < nsyms; i++)
+    {
+      const elf64_sym *sym = &syms[i];
+      const char *name = names + sym->st_name;
+      unsigned int type = sym->st_info & 0xf;
+      if (type == STT_TLS)
+	return fail ("thread-local symbol %s is not supported", name);
+      if (type == STT_GNU_IFUNC)
+	return fail ("ifunc symbol %s is not supported", name);
+
+      if (sym->st_shndx == SHN_UNDEF
+	  && strcmp (name, "_GLOBAL_OFFSET_TABLE_") == 0)
+	addrs[i] = (uintptr_t) (m_region + got_offset);
+      else if (sym->st_shndx == SHN_UNDEF)
+	{
+	  void *addr = dlsym (RTLD_DEFAULT, name);
+	  if (!addr && (sym->st_info >> 4) != STB_WEAK)
+	    return fail ("undefined symbol %s", name);
+	  addrs[i] = (uintptr_t) addr;
+	  external[i] = true;
+	}
+      else if (sym->st_shndx == SHN_ABS)
+	addrs[i] = sym->st_value;
+      else if (sym->st_shndx == SHN_COMMON)
+	addrs[i] = (uintptr_t) (m_region + common_offsets[i]);
+      else if (sym->st_shndx >= SHN_LORESERVE || sym->st_shndx >= shnum)
+	return fail ("symbol %s has an unsupported section index", name);
+      else if (shdrs[sym->st_shndx].sh_flags & SHF_ALLOC)
+	addrs[i] = ((uintptr_t) (m_region + offsets[sym->st_shndx])
+		    + sym->st_value);
+    }
+
+  /* Apply the relocations to the allocated sections.  */
+  char *stubs = m_region + stubs_offset;
+  auto_vec<char *> stub_for_sym;
+  stub_for_sym.safe_grow_cleared (nsyms);
+  size_t next_stub = 0;
+  uint64_t *got = (uint64_t *) (m_region + got_offset);
+  for (unsigned int i = 0; i < shnum; i++)
+    {
+      const elf64_shdr *rsh = &shdrs[i];
+      if (rsh->sh_type != SHT_RELA && rsh->sh_type != SHT_REL)
+	continue;
+      if (rsh->sh_info >= shnum
+	  || !(shdrs[rsh->sh_info].sh_flags & SHF_ALLOC))
+	continue;
+      if (rsh->sh_type == SHT_REL)
+	return fail ("REL relocations are not supported");
+      if (rsh->sh_link != symtab_idx)
+	return fail ("relocations against another symbol table");
+
+      const elf64_shdr *target = &shdrs[rsh->sh_info];
+      char *base = m_region + offsets[rsh->sh_info];
+      const elf64_rela *relas = (const elf64_rela *) (file + rsh->sh_offset);
+      size_t nrelas = rsh->sh_size / sizeof (elf64_rela);
+      for (size_t j = 0; j < nrelas; j++)
+	{
+	  const elf64_rela *r = &relas[j];
+	  size_t symidx = r->r_info >> 32;
+	  unsigned int type = r->r_info & 0xffffffff;
+	  if (symidx >= nsyms)
+	    return fail ("relocation against bad symbol %lu",
+			 (unsigned long) symidx);
+	  if (r->r_offset > target->sh_size || target->sh_size - r->r_offset < 4)
+	    return fail ("relocation out of bounds");
+	  if (symidx != 0
+	      && syms[symidx].st_shndx != SHN_UNDEF
+	      && syms[symidx].st_shndx < SHN_LORESERVE
+	      && !(shdrs[syms[symidx].st_shndx].sh_flags & SHF_ALLOC))
+	    return fail ("relocation against an unloaded section");
+
+	  char *p = base + r->r_offset;
+	  int64_t s = addrs[symidx];
+	  int64_t a = r->r_addend;
+	  int64_t value;
+	  switch (type)
+	    {
+	    case R_X86_64_NONE:
+	      break;
+
+	    case R_X86_64_64:
+	    case R_X86_64_PC64:
+	    case R_X86_64_GOTOFF64:
+	      if (target->sh_size - r->r_offset < 8)
+		return fail ("relocation out of bounds");
+	      value = s + a;
+	      if (type == R_X86_64_PC64)
+		value -= (int64_t) (uintptr_t) p;
+	      else if (type == R_X86_64_GOTOFF64)
+		value -= (int64_t) (uintptr_t) got;
+	      memcpy (p, &value, 8);
+	      break;
+
+	    case R_X86_64_GOTPC32:
+	      value = (int64_t) (uintptr_t) got + a - (int64_t) (uintptr_t) p;
+	      if (!fits_int32_p (value))
+		return fail ("GOT relocation out of range");
+	      {
+		int32_t v32 = value;
+		memcpy (p, &v32, 4);
+	      }
+	      break;
+
+	    case R_X86_64_PC32:
+	    case R_X86_64_PLT32:
+	      value = s + a - (int64_t) (uintptr_t) p;
+	      /* Calls to functions outside the object may be out of range,
+		 so go through a stub.  */
+	      if (!fits_int32_p (value) && external[symidx] && s != 0)
+		{
+		  if (!stub_for_sym[symidx])
+		    {
+		      char *stub = stubs + next_stub++ * STUB_SIZE;
+		      static const unsigned char jmp[6]
+			= { 0xff, 0x25, 0, 0, 0, 0 };
+		      memcpy (stub, jmp, sizeof (jmp));
+		      memcpy (stub + sizeof (jmp), &s, 8);
+		      stub_for_sym[symidx] = stub;
+		    }
+		  value = ((int64_t) (uintptr_t) stub_for_sym[symidx] + a
+			   - (int64_t) (uintptr_t) p);
+		}
+	      if (!fits_int32_p (value))
+		return fail ("PC-relative relocation against %s out of range",
+			     names + syms[symidx].st_name);
+	      {
+		int32_t v32 = value;
+		memcpy (p, &v32, 4);
+	      }
+	      break;
+
+	    case R_X86_64_GOTPCREL:
+	    case R_X86_64_GOTPCRELX:
+	    case R_X86_64_REX_GOTPCRELX:
+	      got[symidx] = s;
+	      value = ((int64_t) (uintptr_t) &got[symidx] + a
+		       - (int64_t) (uintptr_t) p);
+	      if (!fits_int32_p (value))
+		return fail ("GOT relocation out of range");
+	      {
+		int32_t v32 = value;
+		memcpy (p, &v32, 4);
+	      }
+	      break;
+
+	    case R_X86_64_32:
+	    case R_X86_64_32S:
+	      value = s + a;
+	      if (type == R_X86_64_32
+		  ? (uint64_t) value != (uint32_t) value
+		  : !fits_int32_p (value))
+		return fail ("absolute relocation against %s out of range",
+			     names + syms[symidx].st_name);
+	      {
+		uint32_t v32 = value;
+		memcpy (p, &v32, 4);
+	      }
+	      break;
+
+	    default:
+	      return fail ("unsupported relocation type %u", type);
+	    }
+	}
+    }
+
+  /* Collect the global symbols defined by the object.  */
+  m_strtab = XNEWVEC (char, strtab->sh_size);
+  memcpy (m_strtab, names, strtab->sh_size);
+  for (size_t i = 1; i < nsyms; i++)
+    {
+      const elf64_sym *sym = &syms[i];
+      if ((sym->st_info >> 4) == STB_LOCAL
+	  || sym->st_shndx == SHN_UNDEF
+	  || sym->st_name == 0)
+	continue;
+      symbol s;
+      s.m_name = m_strtab + sym->st_name;
+      s.m_addr = (void *) addrs[i];
+      m_symbols.safe_push (s);
+    }
+  m_symbols.qsort (compare_symbols);
+
+  /* Make the code executable.  */
+  if (text_size
+      && mprotect (m_region, text_size, PROT_READ | PROT_EXEC) != 0)
+    return fail ("unable to make code executable");
+
+  /* Register the unwind info, so that the code can be unwound through,
+     e.g. by backtraces.  The memory after the section is already
+     zero, terminating it.  */
+  if (eh_frame_idx)
+    {
+      register_frame_fn register_frame
+	= (register_frame_fn) dlsym (RTLD_DEFAULT, "__register_frame");
+      if (register_frame)
+	{
+	  m_eh_frame = m_region + offsets[eh_frame_idx];
+	  register_frame (m_eh_frame);
+	}
+    }
+
+  return true;
+#else
+  return fail ("loading objects is not supported on this host");
+#endif
+}
+
+} // namespace gcc::jit
+
+} // namespace gcc
@@ -0,0 +1,91 @@
+/* Loading object files into memory within libgccjit.so
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+GCC is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef JIT_LOADER_H
+#define JIT_LOADER_H
+
+#include "jit-logging.h"
+
+/* The loader handles ELF64 relocatable objects for x86_64, resolving
+   undefined symbols against the process with dlsym.  */
+
+#if defined (__x86_64__) && defined (__LP64__) && defined (__ELF__) \
+    && defined (HAVE_MMAP_ANON) && defined (RTLD_DEFAULT)
+#define JIT_HAVE_LOADER 1
+#else
+#define JIT_HAVE_LOADER 0
+#endif
+
+namespace gcc {
+
+namespace jit {
+
+/* An object file that has been relocated into executable memory within
+   this process, avoiding the cost of linking it into a DSO and dlopening
+   that.
+
+   Only the subset of relocatable objects that libgccjit generates is
+   supported: anything else (e.g. TLS, constructors, or symbols that
+   can't be resolved within the process) makes "load" fail, and the
+   caller should fall back to building a DSO.  */
+
+class loaded_object : public log_user
+{
+ public:
+  loaded_object (logger *logger);
+  ~loaded_object ();
+
+  bool load (const char *path);
+
+  void *get_symbol (const char *name) const;
+
+ private:
+  struct symbol
+  {
+    const char *m_name;
+    void *m_addr;
+  };
+
+  bool load_1 (const char *file, size_t file_size);
+  bool fail (const char *fmt, ...) const GNU_PRINTF(2, 3);
+  void unmap ();
+
+  static int compare_symbols (const void *, const void *);
+
+ private:
+  /* The memory holding the loaded sections: executable sections at the
+     start, followed by data on separate pages.  */
+  char *m_region;
+  size_t m_region_size;
+
+  /* The registered .eh_frame section, or NULL.  */
+  void *m_eh_frame;
+
+  /* The object's string table, which the symbol names point into.  */
+  char *m_strtab;
+
+  /* The global symbols defined by the object, sorted by name.  */
+  auto_vec<symbol> m_symbols;
+};
+
+} // namespace gcc::jit
+
+} // namespace gcc
+
+#endif /* JIT_LOADER_H */
@@ -46,6 +46,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "jit-result.h"
 #include "jit-builtins.h"
 #include "jit-tempdir.h"
+#include "jit-loader.h"
 
 /* Compare with gcc/c-family/c-common.h: DECL_C_BIT_FIELD,
    SET_DECL_C_BIT_FIELD.
@@ -1826,9 +1827,11 @@ block (function *func,
      (A) In-memory compile ("gcc_jit_context_compile")
 
        For an in-memory compile we have the playback::compile_to_memory
-       subclass; "postprocess" will convert the .s file to a .so DSO,
-       and load it in memory (via dlopen), wrapping the result up as
-       a jit::result and returning it.
+       subclass; "postprocess" will assemble the .s file to a .o file
+       (or, where that can't be loaded directly, convert it to a .so DSO),
+       and "finish_postprocessing" will load it in memory (relocating the
+       .o file ourselves, or via dlopen), wrapping the result up as a
+       jit::result and returning it.
 
      (B) Compile to file ("gcc_jit_context_compile_to_file")
 
@@ -1866,17 +1869,41 @@ compile ()
   auto_vec <recording::requested_dump> requested_dumps;
   m_recording_ctxt->get_all_requested_dumps (&requested_dumps);
 
-  /* Acquire the JIT mutex and set "this" as the active playback ctxt.  */
-  acquire_mutex ();
-
-  auto_string_vec fake_args;
-  make_fake_args (&fake_args, ctxt_progname, &requested_dumps);
-  if (errors_occurred ())
+  /* Requested dumps are written back into the caller's memory, which a
+     subprocess can't do, so compile them in-process.  */
+  if (get_inner_bool_option (INNER_BOOL_OPTION_COMPILE_IN_SUBPROCESS)
+      && requested_dumps.is_empty ())
+    compile_in_subprocess (ctxt_progname);
+  else
     {
+      /* Acquire the JIT mutex and set "this" as the active playback
+	 ctxt.  */
+      acquire_mutex ();
+      run_compiler (ctxt_progname, &requested_dumps);
       release_mutex ();
-      return;
     }
 
+  if (errors_occurred ())
+    return;
+
+  finish_postprocessing (ctxt_progname);
+}
+
+/* Run the compiler proper on this context, followed by the "postprocess"
+   vfunc.  The jit mutex must be held.  */
+
+void
+playback::context::
+run_compiler (const char *ctxt_progname,
+	      vec <recording::requested_dump> *requested_dumps)
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  auto_string_vec fake_args;
+  make_fake_args (&fake_args, ctxt_progname, requested_dumps);
+  if (errors_occurred ())
+    return;
+
   /* This runs the compiler.  */
   toplev toplev (get_timer (), /* external_timer */
 		 false); /* init_signals */
@@ -1891,7 +1918,7 @@ compile ()
   /* Extracting dumps makes use of the gcc::dump_manager, hence we
      need to do it between toplev::main (which creates the dump manager)
      and toplev::finalize (which deletes it).  */
-  extract_any_requested_dumps (&requested_dumps);
+  extract_any_requested_dumps (requested_dumps);
 
   /* Clean up the compiler.  */
   enter_scope ("toplev::finalize");
@@ -1902,10 +1929,7 @@ compile ()
      followup activities use timevars, which are global state.  */
 
   if (errors_occurred ())
-    {
-      release_mutex ();
-      return;
-    }
+    return;
 
   if (get_bool_option (GCC_JIT_BOOL_OPTION_DUMP_GENERATED_CODE))
     dump_generated_code ();
@@ -1913,12 +1937,144 @@ compile ()
   /* We now have a .s file.
 
      Run any postprocessing steps.  This will either convert the .s file to
-     a .so DSO, and load it in memory (playback::compile_to_memory), or
-     convert the .s file to the requested output format, and copy it to a
-     given file (playback::compile_to_file).  */
+     a .so DSO (playback::compile_to_memory), or convert the .s file to the
+     requested output format, and copy it to a given file
+     (playback::compile_to_file).  */
   postprocess (ctxt_progname);
+}
+
+/* Write LEN bytes of BUF to FD, retrying on short writes.
+   Return false if an error occurs.  */
+
+static bool
+write_all (int fd, const char *buf, size_t len)
+{
+  while (len > 0)
+    {
+      ssize_t n = write (fd, buf, len);
+      if (n < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  return false;
+	}
+      buf += n;
+      len -= n;
+    }
+  return true;
+}
+
+/* Compile this context in a forked child process, so that other threads
+   can compile their own contexts concurrently.
+
+   The child runs the compiler and the "postprocess" vfunc, writing its
+   output into the tempdir, which is shared with this process.  It reports
+   the first and last error messages (if any) back through a pipe, as
+   NUL-terminated strings; the child has already printed them to stderr.
+   The calling process then runs "finish_postprocessing", e.g. to dlopen
+   the built DSO.  */
+
+void
+playback::context::
+compile_in_subprocess (const char *ctxt_progname)
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  /* Hold the jit mutex across the fork, so that the child doesn't
+     inherit the state of an in-process compilation in another thread.
+     In the child, the mutex is held by the thread doing the compile.
 
+     The write end of the pipe is closed in this process before the mutex
+     is released, so that a subprocess forked by another thread can't
+     keep it open and delay our seeing EOF.  */
+  acquire_mutex ();
+  int fds[2];
+  if (pipe (fds) != 0)
+    {
+      release_mutex ();
+      add_error (NULL, "error creating pipe for compile subprocess: %s",
+		 xstrerror (errno));
+      return;
+    }
+  fcntl (fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl (fds[1], F_SETFD, FD_CLOEXEC);
+  fflush (NULL);
+  pid_t pid = fork ();
+  if (pid == 0)
+    {
+      close (fds[0]);
+      auto_vec <recording::requested_dump> no_dumps;
+      run_compiler (ctxt_progname, &no_dumps);
+      if (errors_occurred ())
+	{
+	  const char *first = m_recording_ctxt->get_first_error ();
+	  const char *last = m_recording_ctxt->get_last_error ();
+	  if (first)
+	    write_all (fds[1], first, strlen (first) + 1);
+	  if (last && last != first)
+	    write_all (fds[1], last, strlen (last) + 1);
+	}
+      fflush (NULL);
+      _exit (errors_occurred () ? 1 : 0);
+    }
+  int fork_errno = errno;
+  close (fds[1]);
   release_mutex ();
+
+  if (pid < 0)
+    {
+      close (fds[0]);
+      add_error (NULL, "error forking compile subprocess: %s",
+		 xstrerror (fork_errno));
+      return;
+    }
+  log ("compiling in subprocess %i", (int) pid);
+
+  /* Read back the error messages until the child closes the pipe.  */
+  char *msgs = NULL;
+  size_t len = 0, alloc = 0;
+  for (;;)
+    {
+      if (len == alloc)
+	{
+	  alloc = alloc ? alloc * 2 : 256;
+	  msgs = XRESIZEVEC (char, msgs, alloc);
+	}
+      ssize_t n = read (fds[0], msgs + len, alloc - len);
+      if (n < 0 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	break;
+      len += n;
+    }
+  close (fds[0]);
+
+  int status;
+  while (waitpid (pid, &status, 0) < 0)
+    if (errno != EINTR)
+      {
+	add_error (NULL, "error waiting for compile subprocess: %s",
+		   xstrerror (errno));
+	free (msgs);
+	return;
+      }
+
+  for (size_t i = 0; i < len; i += strlen (msgs + i) + 1)
+    {
+      /* Guard against a message truncated by the child dying.  */
+      if (!memchr (msgs + i, '\0', len - i))
+	break;
+      m_recording_ctxt->add_subprocess_error (msgs + i);
+    }
+  free (msgs);
+
+  if (errors_occurred ())
+    return;
+  if (WIFSIGNALED (status))
+    add_error (NULL, "compile subprocess killed by signal %i",
+	       WTERMSIG (status));
+  else if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+    add_error (NULL, "compile subprocess failed");
 }
 
 /* Implementation of class gcc::jit::playback::compile_to_memory,
@@ -1928,25 +2084,249 @@ compile ()
 
 playback::compile_to_memory::compile_to_memory (recording::context *ctxt) :
   playback::context (ctxt),
-  m_result (NULL)
+  m_result (NULL),
+  m_cache_path (NULL)
 {
   JIT_LOG_SCOPE (get_logger ());
 }
 
+playback::compile_to_memory::~compile_to_memory ()
+{
+  free (m_cache_path);
+}
+
 /*  Implementation of the playback::context::process vfunc for compiling
     to memory.
 
-    Convert the .s file to a .so DSO, and load it in memory (via dlopen),
-    wrapping the result up as a jit::result and returning it.  */
+    Assemble the .s file to a .o file if we can load that directly,
+    avoiding the cost of linking; otherwise convert the .s file to a .so
+    DSO.  */
 
 void
 playback::compile_to_memory::postprocess (const char *ctxt_progname)
 {
   JIT_LOG_SCOPE (get_logger ());
-  convert_to_dso (ctxt_progname);
-  if (errors_occurred ())
-    return;
+  if (can_load_object_p ())
+    invoke_driver (ctxt_progname,
+		   get_tempdir ()->get_path_s_file (),
+		   get_tempdir ()->get_path_o_file (),
+		   TV_ASSEMBLE,
+		   false, /* bool shared, */
+		   false);/* bool run_linker */
+  else
+    convert_to_dso (ctxt_progname);
+}
+
+/* Implementation of the playback::context::finish_postprocessing vfunc
+   for compiling to memory: load the built .o file or DSO in memory,
+   wrapping the result up as a jit::result.
+
+   If the .o file can't be loaded directly (e.g. it needs a relocation
+   that the loader doesn't support), fall back to converting the .s file
+   to a DSO, which requires the jit mutex again.  */
+
+void
+playback::compile_to_memory::finish_postprocessing (const char *ctxt_progname)
+{
+  JIT_LOG_SCOPE (get_logger ());
+  bool load_object = can_load_object_p ();
+  if (load_object)
+    {
+      m_result = load_built_object ();
+      if (m_result)
+	{
+	  add_to_cache (get_tempdir ()->get_path_o_file ());
+	  return;
+	}
+
+      log ("unable to load .o file; falling back to a DSO");
+      acquire_mutex ();
+      convert_to_dso (ctxt_progname);
+      release_mutex ();
+      if (errors_occurred ())
+	return;
+    }
   m_result = dlopen_built_dso ();
+
+  /* The cache path names a .o file in the fallback case, and the cache
+     would keep failing to load it, so only cache DSOs we meant to
+     build.  */
+  if (m_result && !load_object)
+    add_to_cache (get_tempdir ()->get_path_so_file ());
+}
+
+/* Load the .o file built by postprocess directly into memory, returning
+   a jit::result for it, or NULL if it can't be loaded.  */
+
+result *
+playback::compile_to_memory::load_built_object ()
+{
+  JIT_LOG_SCOPE (get_logger ());
+  auto_timevar load_timevar (get_timer (), TV_LOAD);
+
+  loaded_object *object = new loaded_object (get_logger ());
+  if (!object->load (get_tempdir ()->get_path_o_file ()))
+    {
+      delete object;
+      return NULL;
+    }
+  return new result (get_logger (), object);
+}
+
+/* Return true if the code built for this context may be taken from or
+   added to the result cache: the options that ask for side effects of
+   compiling (dumps, debuginfo, intermediate files) can't be satisfied by
+   code that was built earlier.  */
+
+bool
+playback::compile_to_memory::result_cache_usable_p ()
+{
+  static const enum gcc_jit_bool_option uncacheable_options[] = {
+    GCC_JIT_BOOL_OPTION_DEBUGINFO,
+    GCC_JIT_BOOL_OPTION_DUMP_INITIAL_TREE,
+    GCC_JIT_BOOL_OPTION_DUMP_INITIAL_GIMPLE,
+    GCC_JIT_BOOL_OPTION_DUMP_GENERATED_CODE,
+    GCC_JIT_BOOL_OPTION_DUMP_SUMMARY,
+    GCC_JIT_BOOL_OPTION_DUMP_EVERYTHING,
+    GCC_JIT_BOOL_OPTION_KEEP_INTERMEDIATES
+  };
+
+  if (!get_recording_context ()->get_result_cache_dir ())
+    return false;
+
+  for (unsigned i = 0; i < ARRAY_SIZE (uncacheable_options); i++)
+    if (get_bool_option (uncacheable_options[i]))
+      {
+	log ("not using result cache: bool option %i is set",
+	     uncacheable_options[i]);
+	return false;
+      }
+
+  auto_vec <recording::requested_dump> requested_dumps;
+  get_recording_context ()->get_all_requested_dumps (&requested_dumps);
+  if (!requested_dumps.is_empty ())
+    {
+      log ("not using result cache: dumps were requested");
+      return false;
+    }
+
+  return true;
+}
+
+/* If the result cache is in use, look for code built for an identical
+   context within it, loading it and returning true if it's found.
+   Otherwise return false, having noted where "finish_postprocessing"
+   should add the code it builds to the cache.
+
+   The cache holds either .o files or DSOs, depending on which the
+   compile would build; either way, the entry is named after the
+   recording hash of the context.  */
+
+bool
+playback::compile_to_memory::load_from_cache ()
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  if (!result_cache_usable_p ())
+    return false;
+
+  recording::context *ctxt = get_recording_context ();
+  bool load_object = can_load_object_p ();
+  m_cache_path = concat (ctxt->get_result_cache_dir (), "/",
+			 ctxt->get_recording_hash (),
+			 load_object ? ".o" : ".so",
+			 NULL);
+
+  if (access (m_cache_path, R_OK) != 0)
+    {
+      log ("cache miss: %s", m_cache_path);
+      return false;
+    }
+
+  auto_timevar load_timevar (get_timer (), TV_LOAD);
+  if (load_object)
+    {
+      loaded_object *object = new loaded_object (get_logger ());
+      if (object->load (m_cache_path))
+	m_result = new result (get_logger (), object);
+      else
+	delete object;
+    }
+  else
+    {
+      /* Results loaded from the same cached DSO share a handle, and
+	 hence its globals; see the documentation of
+	 gcc_jit_context_set_result_cache_dir.  */
+      void *handle = dlopen (m_cache_path, RTLD_NOW | RTLD_LOCAL);
+      if (handle)
+	m_result = new result (get_logger (), handle, NULL);
+      else
+	log ("unable to dlopen %s: %s", m_cache_path, dlerror ());
+    }
+
+  if (!m_result)
+    return false;
+
+  log ("cache hit: %s", m_cache_path);
+  return true;
+}
+
+/* Copy the file at SRC_PATH into the result cache, if it's in use, so
+   that later compiles of an identical context can load it instead.
+
+   The copy is written under a temporary name and then renamed into
+   place, so that concurrent users of the cache never see a partial
+   file.  The cache is only an optimization, so failures are logged
+   rather than reported as errors.  */
+
+void
+playback::compile_to_memory::add_to_cache (const char *src_path)
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  if (!m_cache_path)
+    return;
+
+  char *tmp_path = concat (m_cache_path, ".XXXXXX", NULL);
+  int out_fd = mkstemps (tmp_path, 0);
+  if (out_fd < 0)
+    {
+      log ("unable to create %s: %s", tmp_path, xstrerror (errno));
+      free (tmp_path);
+      return;
+    }
+
+  bool ok = false;
+  int in_fd = open (src_path, O_RDONLY);
+  if (in_fd >= 0)
+    {
+      char buf[4096];
+      for (;;)
+	{
+	  ssize_t n = read (in_fd, buf, sizeof (buf));
+	  if (n < 0 && errno == EINTR)
+	    continue;
+	  if (n <= 0)
+	    {
+	      ok = (n == 0);
+	      break;
+	    }
+	  if (!write_all (out_fd, buf, n))
+	    break;
+	}
+      close (in_fd);
+    }
+  if (close (out_fd) != 0)
+    ok = false;
+
+  if (ok && rename (tmp_path, m_cache_path) == 0)
+    log ("added %s to cache", m_cache_path);
+  else
+    {
+      log ("unable to add %s to cache: %s", m_cache_path, xstrerror (errno));
+      unlink (tmp_path);
+    }
+  free (tmp_path);
 }
 
 /* Implementation of class gcc::jit::playback::compile_to_file,
@@ -2170,6 +2550,26 @@ playback::compile_to_file::copy_file (const char *src_path,
 
 /* Helper functions for gcc::jit::playback::context::compile.  */
 
+/* Return true if an in-memory compile should assemble to a .o file and
+   load it directly, rather than linking and dlopening a DSO.  Debuggers
+   only see code within DSOs, and driver options may name libraries that
+   the DSO should be linked against, so use a DSO for those.  */
+
+bool
+playback::context::can_load_object_p ()
+{
+#if JIT_HAVE_LOADER
+  if (get_bool_option (GCC_JIT_BOOL_OPTION_DEBUGINFO))
+    return false;
+
+  auto_string_vec driver_options;
+  m_recording_ctxt->append_driver_options (&driver_options);
+  return driver_options.is_empty ();
+#else
+  return false;
+#endif
+}
+
 /* This mutex guards gcc::jit::recording::context::compile, so that only
    one thread can be accessing the bulk of GCC's state at once.  */
 
@@ -270,8 +270,12 @@ private:
 
   /* Functions for implementing "compile".  */
 
-  void acquire_mutex ();
-  void release_mutex ();
+  void
+  run_compiler (const char *ctxt_progname,
+		vec <recording::requested_dump> *requested_dumps);
+
+  void
+  compile_in_subprocess (const char *ctxt_progname);
 
   void
   make_fake_args (vec <char *> *argvec,
@@ -287,8 +291,19 @@ private:
 
   virtual void postprocess (const char *ctxt_progname) = 0;
 
+  /* Postprocessing that doesn't touch GCC's global state, run after the
+     jit mutex has been released, and in the calling process when
+     compiling in a subprocess.  */
+  virtual void finish_postprocessing (const char *) {}
+
 protected:
   tempdir *get_tempdir () { return m_tempdir; }
+  recording::context *get_recording_context () { return m_recording_ctxt; }
+
+  void acquire_mutex ();
+  void release_mutex ();
+
+  bool can_load_object_p ();
 
   void
   convert_to_dso (const char *ctxt_progname);
@@ -335,12 +350,25 @@ class compile_to_memory : public context
 {
  public:
   compile_to_memory (recording::context *ctxt);
+  ~compile_to_memory ();
   void postprocess (const char *ctxt_progname) FINAL OVERRIDE;
+  void finish_postprocessing (const char *ctxt_progname) FINAL OVERRIDE;
+
+  bool load_from_cache ();
 
   result *get_result_obj () const { return m_result; }
 
+ private:
+  result *load_built_object ();
+  bool result_cache_usable_p ();
+  void add_to_cache (const char *src_path);
+
  private:
   result *m_result;
+
+  /* The path within the result cache for this context's code, or NULL
+     if the cache isn't in use.  */
+  char *m_cache_path;
 };
 
 class compile_to_file : public context
@@ -24,6 +24,8 @@ along with GCC; see the file COPYING3.  If not see
 #include "tm.h"
 #include "pretty-print.h"
 #include "toplev.h"
+#include "version.h"
+#include "md5.h"
 
 #include <pthread.h>
 
@@ -43,7 +45,8 @@ dump::dump (recording::context &ctxt,
   m_filename (filename),
   m_update_locations (update_locations),
   m_line (0),
-  m_column (0)
+  m_column (0),
+  m_md5_ctx (NULL)
 {
   m_file = fopen (filename, "w");
   if (!m_file)
@@ -53,6 +56,21 @@ dump::dump (recording::context &ctxt,
 		    xstrerror (errno));
 }
 
+/* Construct a dump that feeds its text into MD5_CTX, for use by
+   recording::context::get_recording_hash.  */
+
+dump::dump (recording::context &ctxt,
+	    struct md5_ctx *md5_ctx)
+: m_ctxt (ctxt),
+  m_filename (NULL),
+  m_update_locations (false),
+  m_line (0),
+  m_column (0),
+  m_file (NULL),
+  m_md5_ctx (md5_ctx)
+{
+}
+
 dump::~dump ()
 {
   if (m_file)
@@ -80,7 +98,7 @@ dump::write (const char *fmt, ...)
 
   /* If there was an error opening the file, we've already reported it.
      Don't attempt further work.  */
-  if (!m_file)
+  if (!m_file && !m_md5_ctx)
     return;
 
   va_start (ap, fmt);
@@ -90,7 +108,14 @@ dump::write (const char *fmt, ...)
   if (buf == NULL || len < 0)
     {
       m_ctxt.add_error (NULL, "malloc failure writing to dumpfile %s",
-			m_filename);
+			m_filename ? m_filename : "(hash)");
+      return;
+    }
+
+  if (m_md5_ctx)
+    {
+      md5_process_bytes (buf, len, m_md5_ctx);
+      free (buf);
       return;
     }
 
@@ -563,10 +588,14 @@ recording::context::context (context *parent_ctxt)
     m_globals (),
     m_functions (),
     m_FILE_type (NULL),
-    m_builtins_manager(NULL)
+    m_builtins_manager(NULL),
+    m_result_cache_dir (NULL)
 {
   if (parent_ctxt)
     {
+      if (parent_ctxt->m_result_cache_dir)
+	m_result_cache_dir = xstrdup (parent_ctxt->m_result_cache_dir);
+
       /* Inherit options from parent.  */
       for (unsigned i = 0;
 	   i < sizeof (m_str_options) / sizeof (m_str_options[0]);
@@ -595,6 +624,7 @@ recording::context::context (context *parent_ctxt)
     }
 
   memset (m_basic_types, 0, sizeof (m_basic_types));
+  memset (m_recording_hash, 0, sizeof (m_recording_hash));
 }
 
 /* The destructor for gcc::jit::recording::context, implicitly used by
@@ -612,6 +642,7 @@ recording::context::~context ()
 
   for (i = 0; i < GCC_JIT_NUM_STR_OPTIONS; ++i)
     free (m_str_options[i]);
+  free (m_result_cache_dir);
 
   char *optname;
   FOR_EACH_VEC_ELT (m_command_line_options, i, optname)
@@ -1393,8 +1424,10 @@ recording::context::compile ()
   /* Set up a compile_to_memory playback context.  */
   ::gcc::jit::playback::compile_to_memory replayer (this);
 
-  /* Use it.  */
-  replayer.compile ();
+  /* Use it, unless code built for an identical context is in the
+     result cache.  */
+  if (!replayer.load_from_cache ())
+    replayer.compile ();
 
   /* Get the jit::result (or NULL) from the
      compile_to_memory playback context.  */
@@ -1483,16 +1516,39 @@ recording::context::add_error_va (location *loc, const char *fmt, va_list ap)
 	     ctxt_progname,
 	     errmsg);
 
+  record_error (const_cast <char *> (errmsg), has_ownership);
+}
+
+/* Record ERRMSG, an error that a compile subprocess has already
+   printed to stderr, as an error on this context.  */
+
+void
+recording::context::add_subprocess_error (const char *errmsg)
+{
+  JIT_LOG_SCOPE (get_logger ());
+
+  if (get_logger ())
+    get_logger ()->log ("error %i: %s", m_error_count, errmsg);
+
+  record_error (xstrdup (errmsg), true);
+}
+
+/* Record ERRMSG as the latest error on this context, taking ownership
+   of it if HAS_OWNERSHIP.  */
+
+void
+recording::context::record_error (char *errmsg, bool has_ownership)
+{
   if (!m_error_count)
     {
-      m_first_error_str = const_cast <char *> (errmsg);
+      m_first_error_str = errmsg;
       m_owns_first_error_str = has_ownership;
     }
 
   if (m_owns_last_error_str)
     if (m_last_error_str != m_first_error_str)
       free (m_last_error_str);
-  m_last_error_str = const_cast <char *> (errmsg);
+  m_last_error_str = errmsg;
   m_owns_last_error_str = has_ownership;
 
   m_error_count++;
@@ -1546,8 +1602,17 @@ recording::context::get_opaque_FILE_type ()
 void
 recording::context::dump_to_file (const char *path, bool update_locations)
 {
-  int i;
   dump d (*this, path, update_locations);
+  write_to_dump (d);
+}
+
+/* Write C-like pseudocode for the types, globals and functions of this
+   context (but not those of its parents) to D.  */
+
+void
+recording::context::write_to_dump (dump &d)
+{
+  int i;
 
   /* Forward declaration of structs and unions.  */
   compound_type *st;
@@ -1580,6 +1645,109 @@ recording::context::dump_to_file (const char *path, bool update_locations)
     }
 }
 
+/* Add STR to the hash being accumulated in MD5_CTX, including its
+   terminator so that adjacent strings can't run together.  NULL is
+   hashed as a byte that can't occur within a UTF-8 string.  */
+
+static void
+hash_string (const char *str, struct md5_ctx *md5_ctx)
+{
+  if (str)
+    md5_process_bytes (str, strlen (str) + 1, md5_ctx);
+  else
+    md5_process_bytes ("\xff", 1, md5_ctx);
+}
+
+/* Add the recorded API usage of this context and its ancestors to the
+   hash being accumulated in MD5_CTX, in the form of the pseudocode
+   written by dump_to_file.  */
+
+void
+recording::context::hash_recording (struct md5_ctx *md5_ctx)
+{
+  if (m_parent_ctxt)
+    m_parent_ctxt->hash_recording (md5_ctx);
+
+  dump d (*this, md5_ctx);
+  write_to_dump (d);
+  hash_string ("", md5_ctx);
+}
+
+/* Get a hash of everything that affects the code that compiling this
+   context would build: the version of libgccjit, the options of this
+   context, and the types, globals and functions created within it and
+   within its ancestors.
+
+   The result is a string of 32 hex digits, which is valid until the next
+   call on this context, or until the context is released.
+
+   Implements the post-error-checking part of
+   gcc_jit_context_get_recording_hash.  */
+
+const char *
+recording::context::get_recording_hash ()
+{
+  JIT_LOG_SCOPE (get_logger ());
+  struct md5_ctx md5_ctx;
+  unsigned char digest[16];
+  char buf[32];
+  int i;
+
+  md5_init_ctx (&md5_ctx);
+
+  hash_string (pkgversion_string, &md5_ctx);
+  hash_string (version_string, &md5_ctx);
+
+  for (i = 0; i < GCC_JIT_NUM_STR_OPTIONS; i++)
+    hash_string (m_str_options[i], &md5_ctx);
+  for (i = 0; i < GCC_JIT_NUM_INT_OPTIONS; i++)
+    {
+      sprintf (buf, "%i", m_int_options[i]);
+      hash_string (buf, &md5_ctx);
+    }
+  md5_process_bytes (m_bool_options, sizeof (m_bool_options), &md5_ctx);
+  md5_process_bytes (m_inner_bool_options, sizeof (m_inner_bool_options),
+		     &md5_ctx);
+
+  auto_vec <char *> command_line_options;
+  append_command_line_options (&command_line_options);
+  char *optname;
+  FOR_EACH_VEC_ELT (command_line_options, i, optname)
+    {
+      hash_string (optname, &md5_ctx);
+      free (optname);
+    }
+  hash_string (NULL, &md5_ctx);
+
+  auto_string_vec driver_options;
+  append_driver_options (&driver_options);
+  FOR_EACH_VEC_ELT (driver_options, i, optname)
+    hash_string (optname, &md5_ctx);
+  hash_string (NULL, &md5_ctx);
+
+  hash_recording (&md5_ctx);
+
+  md5_finish_ctx (&md5_ctx, digest);
+  for (i = 0; i < 16; i++)
+    sprintf (m_recording_hash + 2 * i, "%02x", digest[i]);
+  log ("hash: %s", m_recording_hash);
+  return m_recording_hash;
+}
+
+/* Set the directory in which compile caches the code it builds, keyed
+   by get_recording_hash, or disable the cache if PATH is NULL.
+
+   Implements the post-error-checking part of
+   gcc_jit_context_set_result_cache_dir.  */
+
+void
+recording::context::set_result_cache_dir (const char *path)
+{
+  free (m_result_cache_dir);
+  m_result_cache_dir = path ? xstrdup (path) : NULL;
+  log ("result cache dir: %s", path ? path : "NULL");
+}
+
 static const char * const
  str_option_reproducer_strings[GCC_JIT_NUM_STR_OPTIONS] = {
   "GCC_JIT_STR_OPTION_PROGNAME"
@@ -1605,7 +1773,8 @@ static const char * const
 static const char * const
  inner_bool_option_reproducer_strings[NUM_INNER_BOOL_OPTIONS] = {
   "gcc_jit_context_set_bool_allow_unreachable_blocks",
-  "gcc_jit_context_set_bool_use_external_driver"
+  "gcc_jit_context_set_bool_use_external_driver",
+  "gcc_jit_context_set_bool_compile_in_subprocess"
 };
 
 /* Write the current value of all options to the log file (if any).  */
@@ -4319,9 +4488,11 @@ recording::block::make_debug_string ()
   if (m_name)
     return m_name;
   else
+    /* Use the index rather than the address, so that dumps (and hence
+       recording hashes) are reproducible.  */
     return string::from_printf (m_ctxt,
-				"<UNNAMED BLOCK %p>",
-				(void *)this);
+				"<UNNAMED BLOCK %i>",
+				m_index);
 }
 
 /* Implementation of recording::memento::write_reproducer for blocks. */
@@ -275,6 +275,9 @@ public:
   add_error_va (location *loc, const char *fmt, va_list ap)
       GNU_PRINTF(3, 0);
 
+  void
+  add_subprocess_error (const char *errmsg);
+
   const char *
   get_first_error () const;
 
@@ -295,6 +298,11 @@ public:
 
   void dump_reproducer_to_file (const char *path);
 
+  const char *get_recording_hash ();
+
+  void set_result_cache_dir (const char *path);
+  const char *get_result_cache_dir () const { return m_result_cache_dir; }
+
   void
   get_all_requested_dumps (vec <recording::requested_dump> *out);
 
@@ -308,6 +316,11 @@ private:
   void log_bool_option (enum gcc_jit_bool_option opt) const;
   void log_inner_bool_option (enum inner_bool_option opt) const;
 
+  void record_error (char *errmsg, bool has_ownership);
+
+  void write_to_dump (dump &d);
+  void hash_recording (struct md5_ctx *md5_ctx);
+
   void validate ();
 
 private:
@@ -349,6 +362,12 @@ private:
   type *m_FILE_type;
 
   builtins_manager *m_builtins_manager; // lazily created
+
+  /* The directory set by gcc_jit_context_set_result_cache_dir, or NULL.  */
+  char *m_result_cache_dir;
+
+  /* The buffer returned by get_recording_hash.  */
+  char m_recording_hash[33];
 };
 
 
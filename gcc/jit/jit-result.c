@@ -26,6 +26,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "jit-logging.h"
 #include "jit-result.h"
 #include "jit-tempdir.h"
+#include "jit-loader.h"
 
 namespace gcc {
 namespace jit {
@@ -36,11 +37,25 @@ result::
 result(logger *logger, void *dso_handle, tempdir *tempdir_) :
   log_user (logger),
   m_dso_handle (dso_handle),
+  m_object (NULL),
   m_tempdir (tempdir_)
 {
   JIT_LOG_SCOPE (get_logger ());
 }
 
+/* Constructor for a gcc::jit::result wrapping an object loaded
+   directly into memory, taking ownership of OBJECT.  */
+
+result::
+result(logger *logger, loaded_object *object) :
+  log_user (logger),
+  m_dso_handle (NULL),
+  m_object (object),
+  m_tempdir (NULL)
+{
+  JIT_LOG_SCOPE (get_logger ());
+}
+
 /* gcc::jit::result's destructor.
 
    Called implicitly by gcc_jit_result_release.  */
@@ -49,7 +64,10 @@ result::~result()
 {
   JIT_LOG_SCOPE (get_logger ());
 
-  dlclose (m_dso_handle);
+  if (m_object)
+    delete m_object;
+  else
+    dlclose (m_dso_handle);
 
   /* Responsibility for cleaning up the tempdir (including "fake.so" within
      the filesystem) might have been handed to us by the playback::context,
@@ -60,7 +78,8 @@ result::~result()
 }
 
 /* Attempt to locate the given function by name within the
-   playback::result, using dlsym.
+   playback::result, using dlsym (or the symbol table of an object
+   loaded directly into memory).
 
    Implements the post-error-checking part of
    gcc_jit_result_get_code.  */
@@ -74,6 +93,14 @@ get_code (const char *funcname)
   void *code;
   const char *error;
 
+  if (m_object)
+    {
+      code = m_object->get_symbol (funcname);
+      if (!code)
+	fprintf (stderr, "undefined symbol: %s\n", funcname);
+      return code;
+    }
+
   /* Clear any existing error.  */
   dlerror ();
 
@@ -87,7 +114,8 @@ get_code (const char *funcname)
 }
 
 /* Attempt to locate the given global by name within the
-   playback::result, using dlsym.
+   playback::result, using dlsym (or the symbol table of an object
+   loaded directly into memory).
 
    Implements the post-error-checking part of
    gcc_jit_result_get_global.  */
@@ -101,6 +129,14 @@ get_global (const char *name)
   void *global;
   const char *error;
 
+  if (m_object)
+    {
+      global = m_object->get_symbol (name);
+      if (!global)
+	fprintf (stderr, "undefined symbol: %s\n", name);
+      return global;
+    }
+
   /* Clear any existing error.  */
   dlerror ();
 
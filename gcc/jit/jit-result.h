@@ -25,11 +25,15 @@ namespace gcc {
 
 namespace jit {
 
-/* The result of JIT-compilation.  */
+class loaded_object;
+
+/* The result of JIT-compilation: either a dlopened DSO, or an object
+   file loaded directly into memory.  */
 class result : public log_user
 {
 public:
   result(logger *logger, void *dso_handle, tempdir *tempdir_);
+  result(logger *logger, loaded_object *object);
 
   virtual ~result();
 
@@ -41,6 +45,7 @@ public:
 
 private:
   void *m_dso_handle;
+  loaded_object *m_object;
   tempdir *m_tempdir;
 };
 
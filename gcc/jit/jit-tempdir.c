@@ -73,7 +73,8 @@ gcc::jit::tempdir::tempdir (logger *logger, int keep_intermediates)
     m_path_tempdir (NULL),
     m_path_c_file (NULL),
     m_path_s_file (NULL),
-    m_path_so_file (NULL)
+    m_path_so_file (NULL),
+    m_path_o_file (NULL)
 {
   JIT_LOG_SCOPE (get_logger ());
 }
@@ -104,6 +105,7 @@ gcc::jit::tempdir::create ()
   m_path_c_file = concat (m_path_tempdir, "/fake.c", NULL);
   m_path_s_file = concat (m_path_tempdir, "/fake.s", NULL);
   m_path_so_file = concat (m_path_tempdir, "/fake.so", NULL);
+  m_path_o_file = concat (m_path_tempdir, "/fake.o", NULL);
 
   /* Success.  */
   return true;
@@ -121,7 +123,7 @@ gcc::jit::tempdir::~tempdir ()
     fprintf (stderr, "intermediate files written to %s\n", m_path_tempdir);
   else
     {
-      /* Clean up .s/.so.  */
+      /* Clean up .s/.so/.o.  */
       if (m_path_s_file)
 	{
 	  log ("unlinking .s file: %s", m_path_s_file);
@@ -132,6 +134,11 @@ gcc::jit::tempdir::~tempdir ()
 	  log ("unlinking .so file: %s", m_path_so_file);
 	  unlink (m_path_so_file);
 	}
+      if (m_path_o_file)
+	{
+	  log ("unlinking .o file: %s", m_path_o_file);
+	  unlink (m_path_o_file);
+	}
 
       /* Clean up any other tempfiles.  */
       int i;
@@ -156,6 +163,7 @@ gcc::jit::tempdir::~tempdir ()
   free (m_path_c_file);
   free (m_path_s_file);
   free (m_path_so_file);
+  free (m_path_o_file);
 
   int i;
   char *tempfile;
@@ -42,6 +42,10 @@ namespace jit {
 			 ./fake.so
 			      (created by playback::context::convert_to_dso).
 
+			 ./fake.o
+			      (created instead of fake.so when the object
+			       is loaded directly into memory).
+
   It is normally deleted from the filesystem in the playback::context's
   dtor, unless GCC_JIT_BOOL_OPTION_KEEP_INTERMEDIATES was set.  */
 
@@ -57,6 +61,7 @@ class tempdir : public log_user
   const char * get_path_c_file () const { return m_path_c_file; }
   const char * get_path_s_file () const { return m_path_s_file; }
   const char * get_path_so_file () const { return m_path_so_file; }
+  const char * get_path_o_file () const { return m_path_o_file; }
 
   /* Add PATH to the vec of tempfiles that must be unlinked.
      Take ownership of the buffer PATH; it will be freed.  */
@@ -77,6 +82,7 @@ class tempdir : public log_user
   char *m_path_c_file;
   char *m_path_s_file;
   char *m_path_so_file;
+  char *m_path_o_file;
 
   /* Other files within the tempdir to be cleaned up:
      - certain ahead-of-time compilation artifacts (.o and .exe files)
@@ -125,6 +125,10 @@ namespace gccjit
 
     void set_bool_allow_unreachable_blocks (int bool_value);
     void set_bool_use_external_driver (int bool_value);
+    void set_bool_compile_in_subprocess (int bool_value);
+
+    const char *get_recording_hash ();
+    void set_result_cache_dir (const char *path);
 
     void add_command_line_option (const char *optname);
     void add_driver_option (const char *optname);
@@ -684,6 +688,25 @@ context::set_bool_use_external_driver (int bool_value)
 						bool_value);
 }
 
+inline void
+context::set_bool_compile_in_subprocess (int bool_value)
+{
+  gcc_jit_context_set_bool_compile_in_subprocess (m_inner_ctxt,
+						  bool_value);
+}
+
+inline const char *
+context::get_recording_hash ()
+{
+  return gcc_jit_context_get_recording_hash (m_inner_ctxt);
+}
+
+inline void
+context::set_result_cache_dir (const char *path)
+{
+  gcc_jit_context_set_result_cache_dir (m_inner_ctxt, path);
+}
+
 inline void
 context::add_command_line_option (const char *optname)
 {
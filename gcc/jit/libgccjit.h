@@ -302,6 +302,84 @@ gcc_jit_context_set_bool_use_external_driver (gcc_jit_context *ctxt,
    tested for with #ifdef.  */
 #define LIBGCCJIT_HAVE_gcc_jit_context_set_bool_use_external_driver
 
+/* Implementation detail:
+   libgccjit uses global state within GCC, so by default only one
+   context can be compiled at once within a process; concurrent calls
+   to gcc_jit_context_compile from different threads are serialized.
+
+   This option makes compiling the context run the compiler in a forked
+   subprocess, so that multiple threads can compile their contexts
+   concurrently.  The result is loaded into the calling process as
+   usual.  Contexts which have requested dumps via
+   gcc_jit_context_enable_dump are still compiled in-process, and any
+   timer set on the context does not see the time spent within the
+   subprocess.
+
+   This entrypoint was added in LIBGCCJIT_ABI_13; you can test for
+   its presence using
+     #ifdef LIBGCCJIT_HAVE_gcc_jit_context_set_bool_compile_in_subprocess
+*/
+
+extern void
+gcc_jit_context_set_bool_compile_in_subprocess (gcc_jit_context *ctxt,
+						int bool_value);
+
+/* Pre-canned feature macro to indicate the presence of
+   gcc_jit_context_set_bool_compile_in_subprocess.  This can be
+   tested for with #ifdef.  */
+#define LIBGCCJIT_HAVE_gcc_jit_context_set_bool_compile_in_subprocess
+
+/* Get a hash of everything that affects the code that compiling the
+   context would build: the version of libgccjit, the context's options,
+   and the types, globals and functions created within it and within its
+   ancestors.  Source locations are not included.
+
+   The result is a string of 32 hexadecimal digits, which is owned by
+   the context and valid until the next call to this function on it, or
+   until it is released.  Two contexts with equal hashes can be expected
+   to build equivalent code.
+
+   This entrypoint was added in LIBGCCJIT_ABI_14; you can test for
+   its presence using
+     #ifdef LIBGCCJIT_HAVE_RESULT_CACHE
+*/
+
+extern const char *
+gcc_jit_context_get_recording_hash (gcc_jit_context *ctxt);
+
+/* Enable an on-disk cache of the code built by gcc_jit_context_compile,
+   keyed by gcc_jit_context_get_recording_hash, within the directory
+   PATH, which must already exist; or disable it if PATH is NULL.  The
+   context takes a copy of the string.  Child contexts inherit the
+   setting.
+
+   When the cache is enabled, gcc_jit_context_compile loads the code
+   built for an identical context from the cache if it's there, skipping
+   the compiler entirely, and otherwise adds the code it builds to the
+   cache.  The cache can be shared between processes.  It is bypassed
+   for contexts that request debuginfo, dumps or intermediate files.
+
+   Where gcc_jit_context_compile builds a DSO (e.g. on hosts where
+   libgccjit can't load object files directly), results loaded from the
+   same cached DSO within a process share its global variables.
+
+   Nothing is ever removed from the cache; that is left to the user.
+
+   This entrypoint was added in LIBGCCJIT_ABI_14; you can test for
+   its presence using
+     #ifdef LIBGCCJIT_HAVE_RESULT_CACHE
+*/
+
+extern void
+gcc_jit_context_set_result_cache_dir (gcc_jit_context *ctxt,
+				      const char *path);
+
+/* Pre-canned feature macro to indicate the presence of
+   gcc_jit_context_get_recording_hash and
+   gcc_jit_context_set_result_cache_dir.  This can be tested for with
+   #ifdef.  */
+#define LIBGCCJIT_HAVE_RESULT_CACHE
+
 /* Add an arbitrary gcc command-line option to the context.
    The context takes a copy of the string, so the
    (const char *) optname is not needed anymore after the call
@@ -37,6 +37,7 @@ along with GCC; see the file COPYING3.  If not see
 
 #ifdef HAVE_ZSTD_H
 #include <zstd.h>
+#include <zdict.h>
 #endif
 
 /* Compression stream structure, holds the flush callback and opaque token,
@@ -105,7 +106,31 @@ lto_destroy_compression_stream (struct lto_compression_stream *stream)
   free (stream);
 }
 
+/* A dictionary read from an input file, digested for decompression.  */
+
+struct lto_compression_dictionary
+{
+#ifdef HAVE_ZSTD_H
+  ZSTD_DDict *ddict;
+#endif
+};
+
 #ifdef HAVE_ZSTD_H
+/* Upper bound on the size of a trained dictionary; the size zstd itself
+   defaults to.  */
+
+static const size_t MAX_DICTIONARY_SIZE = 110 * 1024;
+
+/* The dictionary the streams are compressed with, if any, and the context
+   used to compress with it.  */
+
+static ZSTD_CDict *compression_dictionary;
+static ZSTD_CCtx *compression_context;
+
+/* The context used to decompress streams with a dictionary.  */
+
+static ZSTD_DCtx *decompression_context;
+
 /* Return a zstd compression level that zstd will not reject.  Normalizes
    the compression level from the command line flag, clamping non-default
    values to the appropriate end of their valid range.  */
@@ -135,8 +160,12 @@ lto_compression_zstd (struct lto_compression_stream *stream)
   size_t const outbuf_length = ZSTD_compressBound (size);
   char *outbuf = (char *) xmalloc (outbuf_length);
 
-  size_t const csize = ZSTD_compress (outbuf, outbuf_length, cursor, size,
-				      lto_normalized_zstd_level ());
+  size_t const csize
+    = (compression_dictionary
+       ? ZSTD_compress_usingCDict (compression_context, outbuf, outbuf_length,
+				   cursor, size, compression_dictionary)
+       : ZSTD_compress (outbuf, outbuf_length, cursor, size,
+			lto_normalized_zstd_level ()));
 
   if (ZSTD_isError (csize))
     internal_error ("compressed stream: %s", ZSTD_getErrorName (csize));
@@ -148,10 +177,12 @@ lto_compression_zstd (struct lto_compression_stream *stream)
   timevar_pop (TV_IPA_LTO_COMPRESS);
 }
 
-/* Uncompress STREAM using ZSTD algorithm.  */
+/* Uncompress STREAM using ZSTD algorithm.  Frames that were compressed
+   with a dictionary are uncompressed with DICTIONARY.  */
 
 static void
-lto_uncompression_zstd (struct lto_compression_stream *stream)
+lto_uncompression_zstd (struct lto_compression_stream *stream,
+			const struct lto_compression_dictionary *dictionary)
 {
   unsigned char *cursor = (unsigned char *) stream->buffer;
   size_t size = stream->bytes;
@@ -164,7 +195,19 @@ lto_uncompression_zstd (struct lto_compression_stream *stream)
     internal_error ("original size unknown");
 
   char *outbuf = (char *) xmalloc (rsize);
-  size_t const dsize = ZSTD_decompress (outbuf, rsize, cursor, size);
+  size_t dsize;
+  if (ZSTD_getDictID_fromFrame (cursor, size) != 0)
+    {
+      if (!dictionary)
+	internal_error ("compressed stream: missing dictionary");
+      if (!decompression_context)
+	decompression_context = ZSTD_createDCtx ();
+      dsize = ZSTD_decompress_usingDDict (decompression_context, outbuf,
+					  rsize, cursor, size,
+					  dictionary->ddict);
+    }
+  else
+    dsize = ZSTD_decompress (outbuf, rsize, cursor, size);
 
   if (ZSTD_isError (dsize))
     internal_error ("decompressed stream: %s", ZSTD_getErrorName (dsize));
@@ -301,6 +344,100 @@ lto_compression_zlib (struct lto_compression_stream *stream)
   timevar_pop (TV_IPA_LTO_COMPRESS);
 }
 
+/* Train a compression dictionary over the contents of the N compression
+   STREAMS, which have not been finished yet, and compress all the streams
+   finished from now on with it.  Return the dictionary, which has to be
+   stored along with the streams, and set *LEN to its length.  Return NULL
+   if no dictionary could be trained, for instance because there is too
+   little data.  */
+
+char *
+lto_train_compression_dictionary (struct lto_compression_stream **streams
+				  ATTRIBUTE_UNUSED,
+				  unsigned n ATTRIBUTE_UNUSED,
+				  size_t *len ATTRIBUTE_UNUSED)
+{
+#ifdef HAVE_ZSTD_H
+  size_t total = 0, offset = 0;
+  unsigned i;
+
+  for (i = 0; i < n; i++)
+    total += streams[i]->bytes;
+  if (total == 0)
+    return NULL;
+
+  char *samples = XNEWVEC (char, total);
+  size_t *sizes = XNEWVEC (size_t, n);
+  for (i = 0; i < n; i++)
+    {
+      gcc_assert (streams[i]->is_compression);
+      memcpy (samples + offset, streams[i]->buffer, streams[i]->bytes);
+      sizes[i] = streams[i]->bytes;
+      offset += streams[i]->bytes;
+    }
+
+  /* zstd suggests about a hundred times more samples than the size of
+     the dictionary.  */
+  size_t capacity = MIN (MAX (total / 100, 1024), MAX_DICTIONARY_SIZE);
+  char *dictionary = XNEWVEC (char, capacity);
+
+  timevar_push (TV_IPA_LTO_COMPRESS);
+  size_t dsize = ZDICT_trainFromBuffer (dictionary, capacity, samples,
+					sizes, n);
+  timevar_pop (TV_IPA_LTO_COMPRESS);
+  free (samples);
+  free (sizes);
+  if (ZDICT_isError (dsize))
+    {
+      free (dictionary);
+      return NULL;
+    }
+
+  gcc_assert (!compression_dictionary);
+  compression_dictionary = ZSTD_createCDict (dictionary, dsize,
+					     lto_normalized_zstd_level ());
+  if (!compression_context)
+    compression_context = ZSTD_createCCtx ();
+  *len = dsize;
+  return dictionary;
+#else
+  gcc_unreachable ();
+#endif
+}
+
+/* Stop compressing streams with the dictionary returned by
+   lto_train_compression_dictionary.  */
+
+void
+lto_release_compression_dictionary (void)
+{
+#ifdef HAVE_ZSTD_H
+  ZSTD_freeCDict (compression_dictionary);
+  compression_dictionary = NULL;
+#endif
+}
+
+/* Return a dictionary for uncompressing streams from the LEN bytes at
+   DATA, as stored by the compiler after lto_train_compression_dictionary.
+   DATA may be freed afterwards.  Return NULL if LEN is zero.  */
+
+struct lto_compression_dictionary *
+lto_new_compression_dictionary (const char *data ATTRIBUTE_UNUSED, size_t len)
+{
+  if (len == 0)
+    return NULL;
+#ifdef HAVE_ZSTD_H
+  struct lto_compression_dictionary *dictionary
+    = XNEW (struct lto_compression_dictionary);
+  dictionary->ddict = ZSTD_createDDict (data, len);
+  if (!dictionary->ddict)
+    internal_error ("invalid compression dictionary");
+  return dictionary;
+#else
+  internal_error ("compiler does not support ZSTD LTO compression");
+#endif
+}
+
 void
 lto_end_compression (struct lto_compression_stream *stream)
 {
@@ -398,14 +535,20 @@ lto_uncompression_zlib (struct lto_compression_stream *stream)
   timevar_pop (TV_IPA_LTO_DECOMPRESS);
 }
 
+/* Finish uncompressing STREAM, which was compressed with COMPRESSION.
+   DICTIONARY is the dictionary of the file STREAM comes from, if it has
+   one.  */
+
 void
 lto_end_uncompression (struct lto_compression_stream *stream,
-		       lto_compression compression)
+		       lto_compression compression,
+		       const struct lto_compression_dictionary *dictionary
+		       ATTRIBUTE_UNUSED)
 {
 #ifdef HAVE_ZSTD_H
   if (compression == ZSTD)
     {
-      lto_uncompression_zstd (stream);
+      lto_uncompression_zstd (stream, dictionary);
       return;
     }
 #endif
@@ -23,6 +23,7 @@ along with GCC; see the file COPYING3.  If not see
 #define GCC_LTO_COMPRESS_H
 
 struct lto_compression_stream;
+struct lto_compression_dictionary;
 
 /* In lto-compress.c.  */
 extern struct lto_compression_stream
@@ -31,13 +32,19 @@ extern struct lto_compression_stream
 extern void lto_compress_block (struct lto_compression_stream *stream,
 				const char *base, size_t num_chars);
 extern void lto_end_compression (struct lto_compression_stream *stream);
+extern char *lto_train_compression_dictionary
+  (struct lto_compression_stream **streams, unsigned n, size_t *len);
+extern void lto_release_compression_dictionary (void);
+extern struct lto_compression_dictionary *
+  lto_new_compression_dictionary (const char *data, size_t len);
 
 extern struct lto_compression_stream
   *lto_start_uncompression (void (*callback) (const char *, unsigned, void *),
 			    void *opaque);
 extern void lto_uncompress_block (struct lto_compression_stream *stream,
 				  const char *base, size_t num_chars);
-extern void lto_end_uncompression (struct lto_compression_stream *stream,
-				  lto_compression compression);
+extern void lto_end_uncompression
+  (struct lto_compression_stream *stream, lto_compression compression,
+   const struct lto_compression_dictionary *dictionary);
 
 #endif /* GCC_LTO_COMPRESS_H  */
@@ -54,7 +54,8 @@ const char *lto_section_name[LTO_N_SECTION_TYPES] =
   "mode_table",
   "hsa",
   "lto",
-  "ipa_sra"
+  "ipa_sra",
+  "dictionary"
 };
 
 /* Hooks so that the ipa passes can call into the lto front end to get
@@ -163,7 +164,8 @@ lto_get_section_data (struct lto_file_decl_data *file_data,
       stream = lto_start_uncompression (lto_append_data, &buffer);
       lto_uncompress_block (stream, data, *len);
       lto_end_uncompression (stream,
-			     file_data->lto_section_header.get_compression ());
+			     file_data->lto_section_header.get_compression (),
+			     file_data->compression_dictionary);
 
       *len = buffer.length - header_length;
       data = buffer.data + header_length;
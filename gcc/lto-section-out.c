@@ -59,13 +59,44 @@ lto_append_data (const char *chars, unsigned int num_chars, void *opaque)
 
 static struct lto_compression_stream *compression_stream = NULL;
 
+/* A compressed section whose output is deferred until a compression
+   dictionary has been trained over all of them.  */
+
+struct lto_deferred_section
+{
+  char *name;
+  struct lto_compression_stream *stream;
+};
+
+/* The deferred sections, in the order they were begun, and the name of the
+   current one.  */
+
+static vec<lto_deferred_section> deferred_sections;
+static char *deferred_section_name;
+
+/* Return true if compressed sections are deferred and compressed with a
+   dictionary.  */
+
+bool
+lto_compression_dictionary_p (void)
+{
+#ifdef HAVE_ZSTD_H
+  return flag_lto_compression_dictionary && !flag_wpa;
+#else
+  return false;
+#endif
+}
+
 /* Begin a new output section named NAME. If COMPRESS is true, zlib compress
    the section. */
 
 void
 lto_begin_section (const char *name, bool compress)
 {
-  lang_hooks.lto.begin_section (name);
+  if (compress && lto_compression_dictionary_p ())
+    deferred_section_name = xstrdup (name);
+  else
+    lang_hooks.lto.begin_section (name);
 
   if (streamer_dump_file)
     {
@@ -87,6 +118,14 @@ lto_begin_section (const char *name, bool compress)
 void
 lto_end_section (void)
 {
+  if (deferred_section_name)
+    {
+      lto_deferred_section s = { deferred_section_name, compression_stream };
+      deferred_sections.safe_push (s);
+      deferred_section_name = NULL;
+      compression_stream = NULL;
+      return;
+    }
   if (compression_stream)
     {
       lto_end_compression (compression_stream);
@@ -95,6 +134,52 @@ lto_end_section (void)
   lang_hooks.lto.end_section ();
 }
 
+/* Train a compression dictionary over the deferred sections, output it and
+   then compress and output the deferred sections with it.  */
+
+void
+lto_write_deferred_sections (void)
+{
+  unsigned i;
+  size_t len = 0;
+  char *dictionary = NULL;
+  auto_vec<lto_compression_stream *> streams (deferred_sections.length ());
+
+  if (!lto_compression_dictionary_p ())
+    return;
+
+  for (i = 0; i < deferred_sections.length (); i++)
+    streams.quick_push (deferred_sections[i].stream);
+  if (streams.length ())
+    dictionary = lto_train_compression_dictionary (streams.address (),
+						   streams.length (), &len);
+
+  /* The LTO section promised a dictionary; store an empty one if it
+     could not be trained, the sections are then compressed without.  */
+  char *section_name
+    = lto_get_section_name (LTO_section_compression_dictionary, NULL, NULL);
+  lang_hooks.lto.begin_section (section_name);
+  free (section_name);
+  if (dictionary)
+    lang_hooks.lto.append_data (dictionary, len, NULL);
+  lang_hooks.lto.end_section ();
+
+  for (i = 0; i < deferred_sections.length (); i++)
+    {
+      lang_hooks.lto.begin_section (deferred_sections[i].name);
+      lto_end_compression (deferred_sections[i].stream);
+      lang_hooks.lto.end_section ();
+      free (deferred_sections[i].name);
+    }
+  deferred_sections.release ();
+
+  if (dictionary)
+    {
+      lto_release_compression_dictionary ();
+      free (dictionary);
+    }
+}
+
 /* Write SIZE bytes starting at DATA to the assembler.  */
 
 void
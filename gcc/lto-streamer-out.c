@@ -2314,26 +2314,39 @@ copy_function_or_variable (struct symtab_node *node)
   struct lto_in_decl_state *in_state;
   struct lto_out_decl_state *out_state = lto_get_out_decl_state ();
 
+  /* A body compressed with the dictionary of its file cannot be copied
+     verbatim: the output does not have that dictionary.  Recompress it
+     without one.  */
+  bool recompress = file_data->compression_dictionary != NULL;
+
   if (streamer_dump_file)
     fprintf (streamer_dump_file, "Copying section for %s\n", name);
-  lto_begin_section (section_name, false);
+  lto_begin_section (section_name, recompress);
   free (section_name);
 
   /* We may have renamed the declaration, e.g., a static function.  */
   name = lto_get_decl_name_mapping (file_data, name);
 
-  data = lto_get_raw_section_data (file_data, LTO_section_function_body,
-                                   name, &len);
+  in_state =
+    lto_get_function_in_decl_state (node->lto_file_data, function);
+  gcc_assert (in_state);
+
+  if (recompress)
+    data = lto_get_section_data (file_data, LTO_section_function_body,
+				 name, &len, in_state->compressed);
+  else
+    data = lto_get_raw_section_data (file_data, LTO_section_function_body,
+				     name, &len);
   gcc_assert (data);
 
   /* Do a bit copy of the function body.  */
-  lto_write_raw_data (data, len);
+  if (recompress)
+    lto_write_data (data, len);
+  else
+    lto_write_raw_data (data, len);
 
   /* Copy decls. */
-  in_state =
-    lto_get_function_in_decl_state (node->lto_file_data, function);
-  out_state->compressed = in_state->compressed;
-  gcc_assert (in_state);
+  out_state->compressed = recompress || in_state->compressed;
 
   for (i = 0; i < LTO_N_DECL_STREAMS; i++)
     {
@@ -2350,8 +2363,12 @@ copy_function_or_variable (struct symtab_node *node)
 	encoder->trees.safe_push ((*trees)[j]);
     }
 
-  lto_free_raw_section_data (file_data, LTO_section_function_body, name,
-			     data, len);
+  if (recompress)
+    lto_free_section_data (file_data, LTO_section_function_body, name,
+			   data, len, in_state->compressed);
+  else
+    lto_free_raw_section_data (file_data, LTO_section_function_body, name,
+			       data, len);
   lto_end_section ();
 }
 
@@ -2422,6 +2439,7 @@ produce_lto_section ()
   lto_section s
     = { LTO_major_version, LTO_minor_version, slim_object, 0 };
   s.set_compression (compression);
+  s.set_compression_dictionary (lto_compression_dictionary_p ());
   lto_write_data (&s, sizeof s);
   lto_end_section ();
   destroy_output_block (ob);
@@ -2986,4 +3004,5 @@ produce_asm_for_decls (void)
   destroy_output_block (ob);
   if (lto_stream_offload_p)
     lto_write_mode_table ();
+  lto_write_deferred_sections ();
 }
@@ -121,7 +121,7 @@ along with GCC; see the file COPYING3.  If not see
      form followed by the data for the string.  */
 
 #define LTO_major_version 9
-#define LTO_minor_version 0
+#define LTO_minor_version 1
 
 typedef unsigned char	lto_decl_flags_t;
 
@@ -236,6 +236,7 @@ enum lto_section_type
   LTO_section_ipa_hsa,
   LTO_section_lto,
   LTO_section_ipa_sra,
+  LTO_section_compression_dictionary,
   LTO_N_SECTION_TYPES		/* Must be last.  */
 };
 
@@ -403,14 +404,33 @@ struct lto_section
   /* Set compression to FLAGS.  */
   inline void set_compression (lto_compression c)
   {
-    flags = c;
+    flags = (flags & ~COMPRESSION_MASK) | c;
   }
 
   /* Get compression from FLAGS.  */
   inline lto_compression get_compression ()
   {
-    return (lto_compression) flags;
+    return (lto_compression) (flags & COMPRESSION_MASK);
   }
+
+  /* Record in FLAGS whether the compressed sections may use the dictionary
+     stored in the LTO_section_compression_dictionary section.  */
+  inline void set_compression_dictionary (bool d)
+  {
+    if (d)
+      flags |= COMPRESSION_DICTIONARY;
+    else
+      flags &= ~COMPRESSION_DICTIONARY;
+  }
+
+  /* Return true if FLAGS says there is a compression dictionary.  */
+  inline bool compression_dictionary_p ()
+  {
+    return flags & COMPRESSION_DICTIONARY;
+  }
+
+  static const uint16_t COMPRESSION_MASK = 0xff;
+  static const uint16_t COMPRESSION_DICTIONARY = 0x100;
 };
 
 STATIC_ASSERT (sizeof (lto_section) == 8);
@@ -620,6 +640,9 @@ struct GTY(()) lto_file_decl_data
 
   /* Read LTO section.  */
   lto_section lto_section_header;
+
+  /* Dictionary the sections were compressed with, if any.  */
+  struct lto_compression_dictionary * GTY((skip)) compression_dictionary;
 };
 
 typedef struct lto_file_decl_data *lto_file_decl_data_ptr;
@@ -817,6 +840,8 @@ extern void lto_value_range_error (const char *,
 /* In lto-section-out.c  */
 extern void lto_begin_section (const char *, bool);
 extern void lto_end_section (void);
+extern bool lto_compression_dictionary_p (void);
+extern void lto_write_deferred_sections (void);
 extern void lto_write_data (const void *, unsigned int);
 extern void lto_write_raw_data (const void *, unsigned int);
 extern void lto_write_stream (struct lto_output_stream *);
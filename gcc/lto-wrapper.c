@@ -48,6 +48,8 @@ along with GCC; see the file COPYING3.  If not see
 #include "simple-object.h"
 #include "lto-section-names.h"
 #include "collect-utils.h"
+#include "trace-events.h"
+#include "md5.h"
 
 /* Environment variable, used for passing the names of offload targets from GCC
    driver to lto-wrapper.  */
@@ -74,6 +76,10 @@ static char *makefile;
 static unsigned int num_deb_objs;
 static const char **early_debug_object_names;
 
+/* Directory given by -flto-incremental=, holding LTRANS objects from
+   earlier links, or NULL.  */
+static const char *incremental_dir;
+
 const char tool_name[] = "lto-wrapper";
 
 /* Delete tempfiles.  Called from utils_cleanup.  */
@@ -936,6 +942,60 @@ copy_file (const char *dest, const char *src)
   fclose (s);
 }
 
+/* Return the name under which the LTRANS object compiled from INPUT_NAME
+   by the driver command line ARGV[0..ARGC) is kept in INCREMENTAL_DIR.
+   The name is the MD5 of the command line and of the partition's
+   contents, so a partition that WPA wrote out unchanged maps to the same
+   object as in the previous link.  */
+
+static char *
+ltrans_cache_name (const char *input_name, const char **argv, int argc)
+{
+  struct md5_ctx ctx;
+  unsigned char digest[16];
+  char buffer[65536];
+  char hex[2 * sizeof (digest) + 1];
+  size_t len;
+  FILE *f;
+  int i;
+
+  md5_init_ctx (&ctx);
+  for (i = 0; i < argc; ++i)
+    md5_process_bytes (argv[i], strlen (argv[i]) + 1, &ctx);
+
+  f = fopen (input_name, "rb");
+  if (!f)
+    fatal_error (input_location, "%<fopen%>: %s: %m", input_name);
+  while ((len = fread (buffer, 1, sizeof (buffer), f)) > 0)
+    md5_process_bytes (buffer, len, &ctx);
+  if (ferror (f) != 0)
+    fatal_error (input_location, "reading input file");
+  fclose (f);
+
+  md5_finish_ctx (&ctx, digest);
+  for (i = 0; i < (int) sizeof (digest); ++i)
+    sprintf (hex + 2 * i, "%02x", digest[i]);
+  return concat (incremental_dir, "/", hex, ".ltrans.o", NULL);
+}
+
+/* Store the freshly compiled LTRANS object OUTPUT_NAME in the incremental
+   cache as CACHE_NAME.  Copy it under a temporary name first so that a
+   concurrent link never sees a partially written object.  */
+
+static void
+store_ltrans_object (const char *cache_name, const char *output_name)
+{
+  char pid[32];
+  char *tmp;
+
+  snprintf (pid, sizeof (pid), ".%ld", (long) getpid ());
+  tmp = concat (cache_name, pid, NULL);
+  copy_file (tmp, output_name);
+  if (rename (tmp, cache_name) != 0)
+    unlink (tmp);
+  free (tmp);
+}
+
 /* Find the crtoffloadtable.o file in LIBRARY_PATH, make copy and pass name of
    the copy to the linker.  */
 
@@ -1240,6 +1300,51 @@ jobserver_active_p (void)
 	  && is_valid_fd (wfd));
 }
 
+/* Rough estimate of the memory used by an LTRANS process: a fixed
+   amount for the compiler itself plus a per-insn amount for the IL,
+   the call graph and the RTL of the partition being compiled.  These
+   are deliberately on the generous side.  */
+
+#define LTRANS_BASE_MEMORY (128.0 * 1024 * 1024)
+#define LTRANS_MEMORY_PER_INSN (2.0 * 1024)
+
+/* Return the number of LTRANS jobs, at most MAX_JOBS, that can run
+   concurrently without their estimated memory use exceeding the
+   physical memory of the machine.  PRIORITIES holds the insn count and
+   index pairs of the NR partitions, largest first, which is also the
+   order in which they are started; OUTPUT_NAMES is non-NULL for
+   pass-through files that need no LTRANS process.  Since any of the
+   largest partitions may run at the same time, the jobs are limited so
+   that the largest ones fit together.  */
+
+static unsigned long
+ltrans_memory_limit (unsigned long max_jobs, const int *priorities,
+		     char **output_names, int nr)
+{
+  double budget = physmem_total ();
+  double used = 0;
+  unsigned long jobs = 0;
+
+  /* Nothing to go by if the amount of memory is unknown.  */
+  if (budget <= 0)
+    return max_jobs;
+
+  for (int i = 0; i < nr && jobs < max_jobs; i++)
+    {
+      if (output_names[priorities[i * 2 + 1]])
+	continue;
+      used += LTRANS_BASE_MEMORY
+	      + LTRANS_MEMORY_PER_INSN * priorities[i * 2];
+      if (used > budget)
+	break;
+      jobs++;
+    }
+
+  /* Always make progress, even if a single partition appears not to
+     fit.  */
+  return MAX (jobs, 1);
+}
+
 /* Execute gcc. ARGC is the number of arguments. ARGV contains the arguments. */
 
 static void
@@ -1269,6 +1374,8 @@ run_gcc (unsigned argc, char *argv[])
   char **lto_argv, **ltoobj_argv;
   bool linker_output_rel = false;
   bool skip_debug = false;
+  bool keep_asm = false;
+  bool have_random_seed = false;
   unsigned n_debugobj;
 
   /* Get the driver and options.  */
@@ -1365,6 +1472,10 @@ run_gcc (unsigned argc, char *argv[])
 	  save_temps = 1;
 	  break;
 
+	case OPT_save_temps_:
+	  keep_asm = true;
+	  break;
+
 	case OPT_v:
 	  verbose = 1;
 	  break;
@@ -1374,6 +1485,14 @@ run_gcc (unsigned argc, char *argv[])
 	    no_partition = true;
 	  break;
 
+	case OPT_flto_incremental_:
+	  incremental_dir = option->arg;
+	  break;
+
+	case OPT_frandom_seed_:
+	  have_random_seed = true;
+	  break;
+
 	case OPT_flto_:
 	  if (strcmp (option->arg, "jobserver") == 0)
 	    {
@@ -1425,6 +1544,19 @@ run_gcc (unsigned argc, char *argv[])
   if (linker_output_rel)
     no_partition = true;
 
+  if (incremental_dir)
+    {
+      if (access (incremental_dir, W_OK) != 0)
+	fatal_error (input_location,
+		     "cannot use %qs as LTO incremental directory: %m",
+		     incremental_dir);
+      /* WPA otherwise suffixes the LTO section names it writes with a
+	 random number, and no partition would ever match the one of an
+	 earlier link.  */
+      if (!have_random_seed)
+	obstack_ptr_grow (&argv_obstack, "-frandom-seed=lto-incremental");
+    }
+
   if (no_partition)
     {
       lto_mode = LTO_MODE_LTO;
@@ -1438,6 +1570,13 @@ run_gcc (unsigned argc, char *argv[])
       jobserver = 1;
     }
 
+  /* Have the driver pipe the assembly of each LTRANS unit straight into
+     the assembler.  It is typically several times the size of the
+     resulting object, and writing it to a temporary file only to read
+     it back is the bulk of the disk traffic of a partitioned link.  */
+  if (!save_temps && !keep_asm)
+    obstack_ptr_grow (&argv_obstack, "-pipe");
+
   if (linker_output)
     {
       char *output_dir, *base, *name;
@@ -1705,6 +1844,7 @@ cont1:
       FILE *mstream = NULL;
       struct obstack env_obstack;
       int priority;
+      char **cache_names = NULL;
 
       if (!stream)
 	fatal_error (input_location, "%<fopen%>: %s: %m", ltrans_output_file);
@@ -1762,8 +1902,29 @@ cont:
 	  makefile = make_temp_file (".mk");
 	  mstream = fopen (makefile, "w");
 	  qsort (ltrans_priorities, nr, sizeof (int) * 2, cmp_priority);
+
+	  /* With -flto=auto, do not start more LTRANS processes than the
+	     machine has memory for.  An explicit -flto=N is honored as
+	     given, and with a jobserver the number of jobs is up to the
+	     parent make.  */
+	  if (auto_parallel && !jobserver)
+	    {
+	      unsigned long limit
+		= ltrans_memory_limit (nthreads_var, ltrans_priorities,
+				       output_names, nr);
+	      if (limit < nthreads_var)
+		{
+		  if (verbose)
+		    fprintf (stderr, "LTRANS parallelism limited to %ld "
+			     "by physical memory\n", limit);
+		  nthreads_var = limit;
+		}
+	    }
 	}
 
+      if (incremental_dir)
+	cache_names = XCNEWVEC (char *, nr);
+
       /* Execute the LTRANS stage for each input file (or prepare a
 	 makefile to invoke this in parallel).  */
       for (i = 0; i < nr; ++i)
@@ -1797,6 +1958,30 @@ cont:
 	  argv_ptr[3] = output_name;
 	  argv_ptr[4] = input_name;
 	  argv_ptr[5] = NULL;
+
+	  /* With -flto-incremental, reuse the object of an earlier link if
+	     WPA produced the very same partition, and otherwise remember
+	     where to store the object once it has been compiled.  The
+	     dumpbase is left out of the key as it does not affect the
+	     generated code.  */
+	  if (incremental_dir)
+	    {
+	      cache_names[i] = ltrans_cache_name (input_name, new_argv,
+						  new_head_argc);
+	      if (access (cache_names[i], R_OK) == 0)
+		{
+		  if (verbose)
+		    fprintf (stderr, "Reusing %s for %s\n",
+			     cache_names[i], input_name);
+		  copy_file (output_name, cache_names[i]);
+		  maybe_unlink (input_name);
+		  free (cache_names[i]);
+		  cache_names[i] = NULL;
+		  output_names[i] = output_name;
+		  continue;
+		}
+	    }
+
 	  if (parallel)
 	    {
 	      fprintf (mstream, "%s:\n\t@%s ", output_name, new_argv[0]);
@@ -1864,6 +2049,16 @@ cont:
 	  for (i = 0; i < nr; ++i)
 	    maybe_unlink (input_names[i]);
 	}
+      if (cache_names)
+	{
+	  for (i = 0; i < nr; ++i)
+	    if (cache_names[i])
+	      {
+		store_ltrans_object (cache_names[i], output_names[i]);
+		free (cache_names[i]);
+	      }
+	  free (cache_names);
+	}
       for (i = 0; i < nr; ++i)
 	{
 	  fputs (output_names[i], stdout);
@@ -1938,6 +2133,7 @@ main (int argc, char *argv[])
      passed with @file.  Expand them into argv before processing.  */
   expandargv (&argc, &argv);
 
+  trace_events_init (NULL, "lto-wrapper");
   run_gcc (argc, argv);
 
   return 0;
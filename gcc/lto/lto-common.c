@@ -42,6 +42,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "debug.h"
 #include "lto.h"
 #include "lto-section-names.h"
+#include "lto-compress.h"
 #include "splay-tree.h"
 #include "lto-partition.h"
 #include "context.h"
@@ -2215,6 +2216,20 @@ lto_file_finalize (struct lto_file_decl_data *file_data, lto_file *file)
 		     file_data->lto_section_header.minor_version,
 		     file_data->file_name);
 
+  if (file_data->lto_section_header.compression_dictionary_p ())
+    {
+      data = lto_get_raw_section_data (file_data,
+				       LTO_section_compression_dictionary,
+				       NULL, &len);
+      if (data == NULL)
+	fatal_error (input_location, "cannot read compression dictionary "
+		     "from %qs", file_data->file_name);
+      file_data->compression_dictionary
+	= lto_new_compression_dictionary (data, len);
+      lto_free_raw_section_data (file_data, LTO_section_compression_dictionary,
+				 NULL, data, len);
+    }
+
   data = lto_get_section_data (file_data, LTO_section_decls, NULL, &len);
   if (data == NULL)
     {
@@ -2302,6 +2317,64 @@ lto_file_read (lto_file *file, FILE *resolution_file, int *count)
 #if LTO_MMAP_IO
 /* Page size of machine is used for mmap and munmap calls.  */
 static size_t page_mask;
+
+/* On hosts with enough address space each input file is mapped once as a
+   whole and sections are handed out as views into the mapping.  This saves
+   a mmap/munmap pair per section read and keeps no file descriptor open;
+   the pages of sections that are never read, typically the bodies of the
+   functions removed after IPA, are never touched.  */
+
+struct lto_file_mapping
+{
+  char *base;
+  size_t len;
+};
+
+/* Mappings of the input files, by file name.  A mapping with NULL base
+   records that the file could not be mapped as a whole.  */
+static hash_map<nofree_string_hash, lto_file_mapping> *file_mappings;
+
+/* Return the mapping of the whole file of FILE_DATA, or NULL.  FD is a
+   file descriptor open on the file.  */
+
+static lto_file_mapping *
+lto_map_whole_file (struct lto_file_decl_data *file_data, int fd)
+{
+  struct stat st;
+  lto_file_mapping m = { NULL, 0 };
+
+  if (sizeof (void *) >= 8
+      && fstat (fd, &st) == 0
+      && st.st_size > 0)
+    {
+      m.base = (char *) mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+			      fd, 0);
+      if (m.base == MAP_FAILED)
+	m.base = NULL;
+      else
+	m.len = st.st_size;
+    }
+  file_mappings->put (xstrdup (file_data->file_name), m);
+  return m.base ? file_mappings->get (file_data->file_name) : NULL;
+}
+
+/* Return the mapping of the whole file of FILE_DATA if it has been mapped
+   and contains the LEN bytes at OFFSET.  */
+
+static lto_file_mapping *
+lto_find_file_mapping (struct lto_file_decl_data *file_data,
+		       intptr_t offset, size_t len)
+{
+  lto_file_mapping *m;
+
+  if (!file_mappings
+      || !(m = file_mappings->get (file_data->file_name))
+      || !m->base
+      || offset < 0
+      || (size_t) offset + len > m->len)
+    return NULL;
+  return m;
+}
 #endif
 
 /* Get the section data of length LEN from FILENAME starting at
@@ -2319,6 +2392,11 @@ lto_read_section_data (struct lto_file_decl_data *file_data,
   intptr_t computed_len;
   intptr_t computed_offset;
   intptr_t diff;
+  lto_file_mapping *mapping
+    = lto_find_file_mapping (file_data, offset, len);
+
+  if (mapping)
+    return mapping->base + offset;
 #endif
 
   /* Keep a single-entry file-descriptor cache.  The last file we
@@ -2351,6 +2429,22 @@ lto_read_section_data (struct lto_file_decl_data *file_data,
       page_mask = ~(page_size - 1);
     }
 
+  if (!file_mappings)
+    file_mappings = new hash_map<nofree_string_hash, lto_file_mapping>;
+  if (!file_mappings->get (file_data->file_name)
+      && lto_map_whole_file (file_data, fd))
+    {
+      /* The mapping does not need the descriptor.  */
+      free (fd_name);
+      close (fd);
+      fd = -1;
+      mapping = lto_find_file_mapping (file_data, offset, len);
+      if (mapping)
+	return mapping->base + offset;
+      fatal_error (input_location, "Cannot read %s", file_data->file_name);
+      return NULL;
+    }
+
   computed_offset = offset & page_mask;
   diff = offset - computed_offset;
   computed_len = len + diff;
@@ -2434,6 +2528,24 @@ free_section_data (struct lto_file_decl_data *file_data ATTRIBUTE_UNUSED,
 #endif
 
 #if LTO_MMAP_IO
+  lto_file_mapping *mapping
+    = (file_mappings ? file_mappings->get (file_data->file_name) : NULL);
+  if (mapping && mapping->base
+      && offset >= mapping->base
+      && offset + len <= mapping->base + mapping->len)
+    {
+      /* Drop the pages that lie entirely within the section so that they
+	 no longer count towards the resident set; they are still in the
+	 page cache should the section be read again.  */
+#if defined(HAVE_MADVISE) && HAVE_DECL_MADVISE && defined(MADV_DONTNEED)
+      intptr_t start = ((intptr_t) offset + ~page_mask) & page_mask;
+      intptr_t end = ((intptr_t) offset + len) & page_mask;
+      if (start < end)
+	madvise ((caddr_t) start, end - start, MADV_DONTNEED);
+#endif
+      return;
+    }
+
   computed_offset = ((intptr_t) offset) & page_mask;
   diff = (intptr_t) offset - computed_offset;
   computed_len = len + diff;
@@ -2651,6 +2763,26 @@ lto_flatten_files (struct lto_file_decl_data **orig, int count,
 static int real_file_count;
 static GTY((length ("real_file_count + 1"))) struct lto_file_decl_data **real_file_decl_data;
 
+/* Number of input files ahead of the one being read for which
+   read_cgraph_and_symbols asks the OS to start reading.  */
+#define LTO_PREFETCH_FILES 4
+
+/* Ask the OS to read FNAME into the page cache in the background, so
+   that the I/O for the next object files overlaps with streaming in
+   the current one.  Archive members, named FILE@OFFSET, are skipped.  */
+
+static void
+lto_prefetch_file (const char *fname ATTRIBUTE_UNUSED)
+{
+#if defined (HAVE_POSIX_FADVISE) && defined (POSIX_FADV_WILLNEED)
+  int fd = open (fname, O_RDONLY | O_BINARY);
+  if (fd == -1)
+    return;
+  posix_fadvise (fd, 0, 0, POSIX_FADV_WILLNEED);
+  close (fd);
+#endif
+}
+
 /* Read all the symbols from the input files FNAMES.  NFILES is the
    number of files requested in the command line.  Instantiate a
    global call graph by aggregating all the sub-graphs found in each
@@ -2726,9 +2858,13 @@ read_cgraph_and_symbols (unsigned nfiles, const char **fnames)
     fprintf (stderr, "Reading object files:");
 
   /* Read all of the object files specified on the command line.  */
+  for (i = 0; i < nfiles && i < LTO_PREFETCH_FILES; ++i)
+    lto_prefetch_file (fnames[i]);
   for (i = 0, last_file_ix = 0; i < nfiles; ++i)
     {
       struct lto_file_decl_data *file_data = NULL;
+      if (i + LTO_PREFETCH_FILES < nfiles)
+	lto_prefetch_file (fnames[i + LTO_PREFETCH_FILES]);
       if (!quiet_flag)
 	{
 	  fprintf (stderr, " %s", fnames[i]);
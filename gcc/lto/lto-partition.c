@@ -858,6 +858,308 @@ lto_balanced_map (int n_lto_partitions, int max_partition_size)
     }
 }
 
+/* A group of functions laid out together by lto_cluster_map.  */
+
+struct lto_cluster
+{
+  /* Union-find parent.  A cluster is its own parent when it is the
+     representative of the merged clusters.  */
+  int parent;
+  /* Index of the partition the cluster was assigned to.  */
+  int partition;
+  /* Estimated LTRANS compile time and size of the cluster.  */
+  int64_t time;
+  int64_t size;
+};
+
+/* A call between two clusters and its weight.  */
+
+struct lto_cluster_edge
+{
+  int caller;
+  int callee;
+  int64_t weight;
+};
+
+/* Return the representative of cluster I in CLUSTERS.  */
+
+static int
+cluster_find (vec<lto_cluster> &clusters, int i)
+{
+  while (clusters[i].parent != i)
+    {
+      clusters[i].parent = clusters[clusters[i].parent].parent;
+      i = clusters[i].parent;
+    }
+  return i;
+}
+
+/* Estimate the time LTRANS needs to compile NODE.  The size already
+   includes the inlined callees; most of the optimizers are slightly
+   superlinear in the size of the function body, so scale it by its
+   logarithm.  */
+
+static int64_t
+estimated_compile_time (cgraph_node *node)
+{
+  int64_t size = ipa_fn_summaries->get (node)->size;
+
+  if (size <= 0)
+    return 1;
+  return size * (1 + floor_log2 (size));
+}
+
+/* Return the weight of the call EDGE: its count when the program was
+   trained and its estimated frequency otherwise.  */
+
+static int64_t
+cluster_edge_weight (cgraph_edge *edge)
+{
+  profile_count count = edge->count.ipa ();
+
+  if (count.initialized_p ())
+    return count.to_gcov_type ();
+  return edge->frequency ();
+}
+
+/* Record into EDGES the calls from the body of NODE to the other
+   clusters in INDEX.  NODE is either the function ROOT itself or one of
+   the functions inlined into it.  */
+
+static void
+collect_cluster_edges (cgraph_node *root, cgraph_node *node,
+		       hash_map<cgraph_node *, int> &index,
+		       vec<lto_cluster_edge> &edges)
+{
+  int *caller = index.get (root);
+
+  for (cgraph_edge *e = node->callees; e; e = e->next_callee)
+    if (!e->inline_failed)
+      collect_cluster_edges (root, e->callee, index, edges);
+    else if (account_reference_p (root, e->callee))
+      {
+	cgraph_node *callee = dyn_cast <cgraph_node *>
+				(contained_in_symbol (e->callee));
+	int *idx = callee ? index.get (callee) : NULL;
+	int64_t weight = cluster_edge_weight (e);
+
+	if (idx && *idx != *caller && weight > 0)
+	  {
+	    lto_cluster_edge edge = { *caller, *idx, weight };
+	    edges.safe_push (edge);
+	  }
+      }
+}
+
+/* Helper for qsort; sort cluster edges by decreasing weight.  */
+
+static int
+cluster_edge_cmp (const void *pa, const void *pb)
+{
+  const lto_cluster_edge *a = (const lto_cluster_edge *) pa;
+  const lto_cluster_edge *b = (const lto_cluster_edge *) pb;
+
+  if (a->weight != b->weight)
+    return a->weight < b->weight ? 1 : -1;
+  if (a->caller != b->caller)
+    return a->caller - b->caller;
+  return a->callee - b->callee;
+}
+
+/* Vector of clusters used by cluster_time_cmp.  */
+
+static vec<lto_cluster> *sorted_clusters;
+
+/* Helper for qsort; sort cluster indices by decreasing compile time.  */
+
+static int
+cluster_time_cmp (const void *pa, const void *pb)
+{
+  int a = *(const int *) pa;
+  int b = *(const int *) pb;
+  int64_t ta = (*sorted_clusters)[a].time;
+  int64_t tb = (*sorted_clusters)[b].time;
+
+  if (ta != tb)
+    return ta < tb ? 1 : -1;
+  return a - b;
+}
+
+/* Group cgraph nodes into partitions so that hot calls stay within one
+   partition, where they can be inlined, and every partition takes about
+   the same time to compile.
+
+   Every function starts in a cluster of its own.  Calls between clusters
+   are visited in order of decreasing weight (the profile count when
+   available, the estimated frequency otherwise) and the caller's and
+   callee's clusters are merged, as in Pettis and Hansen's code positioning
+   algorithm, as long as the result is not bigger than one partition's
+   share of the estimated compile time or MAX_PARTITION_SIZE insns.
+   Clusters are then packed into N_LTO_PARTITIONS partitions largest first,
+   each going to the partition with the least compile time so far, which
+   keeps the slowest LTRANS unit close to the average.
+
+   Variables go into the partition of the first function referring to
+   them.  Symbols that must not be reordered are all output into the first
+   partition in their original order.  */
+
+void
+lto_cluster_map (int n_lto_partitions, int max_partition_size)
+{
+  auto_vec<cgraph_node *> order;
+  auto_vec<symtab_node *> noreorder;
+  auto_vec<lto_cluster> clusters;
+  auto_vec<lto_cluster_edge> edges;
+  hash_map<cgraph_node *, int> index;
+  cgraph_node *node;
+  varpool_node *vnode;
+  symtab_node *snode;
+  int64_t total_size = 0, total_time = 0, partition_time;
+  unsigned i;
+
+  if (PARAM_VALUE (MIN_PARTITION_SIZE) > max_partition_size)
+    fatal_error (input_location, "min partition size cannot be greater "
+		 "than max partition size");
+
+  FOR_EACH_DEFINED_FUNCTION (node)
+    if (node->get_partitioning_class () == SYMBOL_PARTITION)
+      {
+	if (node->no_reorder)
+	  noreorder.safe_push (node);
+	else if (contained_in_symbol (node) == node)
+	  order.safe_push (node);
+      }
+  FOR_EACH_VARIABLE (vnode)
+    if (vnode->get_partitioning_class () == SYMBOL_PARTITION
+	&& vnode->no_reorder)
+      noreorder.safe_push (vnode);
+
+  /* Keep the source order within the partitions; see lto_balanced_map.  */
+  order.qsort (node_cmp);
+
+  clusters.reserve_exact (order.length ());
+  FOR_EACH_VEC_ELT (order, i, node)
+    {
+      lto_cluster c;
+      c.parent = i;
+      c.partition = -1;
+      c.time = estimated_compile_time (node);
+      c.size = ipa_fn_summaries->get (node)->size;
+      total_time += c.time;
+      total_size += c.size;
+      clusters.quick_push (c);
+      index.put (node, i);
+    }
+
+  /* Use fewer partitions for small programs, as lto_balanced_map does.  */
+  if (total_size / n_lto_partitions < PARAM_VALUE (MIN_PARTITION_SIZE))
+    n_lto_partitions = MAX (total_size / PARAM_VALUE (MIN_PARTITION_SIZE), 1);
+  partition_time = MAX (total_time / n_lto_partitions, 1);
+
+  FOR_EACH_VEC_ELT (order, i, node)
+    collect_cluster_edges (node, node, index, edges);
+  edges.qsort (cluster_edge_cmp);
+
+  if (dump_file)
+    fprintf (dump_file, "Total unit size: %" PRId64 ", time: %" PRId64
+	     ", partition time: %" PRId64 ", %u calls\n",
+	     total_size, total_time, partition_time, edges.length ());
+
+  for (i = 0; i < edges.length (); i++)
+    {
+      int a = cluster_find (clusters, edges[i].caller);
+      int b = cluster_find (clusters, edges[i].callee);
+
+      if (a == b
+	  || clusters[a].time + clusters[b].time > partition_time
+	  || clusters[a].size + clusters[b].size > max_partition_size)
+	continue;
+      if (dump_file)
+	fprintf (dump_file, "Merging %s and %s, weight %" PRId64 "\n",
+		 order[edges[i].caller]->dump_name (),
+		 order[edges[i].callee]->dump_name (), edges[i].weight);
+      clusters[b].parent = a;
+      clusters[a].time += clusters[b].time;
+      clusters[a].size += clusters[b].size;
+    }
+
+  /* Pack the clusters into partitions.  */
+  auto_vec<int> roots;
+  for (i = 0; i < clusters.length (); i++)
+    if (cluster_find (clusters, i) == (int) i)
+      roots.safe_push (i);
+  sorted_clusters = &clusters;
+  roots.qsort (cluster_time_cmp);
+  sorted_clusters = NULL;
+
+  int npartitions = MIN ((int) roots.length (), n_lto_partitions);
+  auto_vec<int64_t> load;
+  load.safe_grow_cleared (MAX (npartitions, 1));
+  for (i = 0; i < roots.length (); i++)
+    {
+      int best = 0;
+      for (int p = 1; p < npartitions; p++)
+	if (load[p] < load[best])
+	  best = p;
+      clusters[roots[i]].partition = best;
+      load[best] += clusters[roots[i]].time;
+    }
+
+  for (int p = 0; p < MAX (npartitions, 1); p++)
+    new_partition ("");
+
+  FOR_EACH_VEC_ELT (order, i, node)
+    if (!symbol_partitioned_p (node))
+      add_symbol_to_partition
+	(ltrans_partitions[clusters[cluster_find (clusters, i)].partition],
+	 node);
+
+  /* Put the variables next to their first user.  */
+  FOR_EACH_VARIABLE (vnode)
+    if (vnode->get_partitioning_class () == SYMBOL_PARTITION
+	&& !vnode->no_reorder
+	&& !symbol_partitioned_p (vnode))
+      {
+	struct ipa_ref *ref = NULL;
+	for (int j = 0; vnode->iterate_referring (j, ref); j++)
+	  {
+	    cgraph_node *user = dyn_cast <cgraph_node *>
+				  (contained_in_symbol (ref->referring));
+	    int *idx = user ? index.get (user) : NULL;
+	    if (idx)
+	      {
+		int p = clusters[cluster_find (clusters, *idx)].partition;
+		add_symbol_to_partition (ltrans_partitions[p], vnode);
+		break;
+	      }
+	  }
+      }
+
+  add_sorted_nodes (noreorder, ltrans_partitions[0]);
+
+  /* Whatever is left (unreferenced variables, aliases of symbols that are
+     not partitioned) goes into the smallest partition.  */
+  ltrans_partition smallest = ltrans_partitions[0];
+  for (i = 1; i < ltrans_partitions.length (); i++)
+    if (ltrans_partitions[i]->insns < smallest->insns)
+      smallest = ltrans_partitions[i];
+  FOR_EACH_SYMBOL (snode)
+    if (snode->get_partitioning_class () == SYMBOL_PARTITION
+	&& !snode->no_reorder
+	&& !symbol_partitioned_p (snode))
+      add_symbol_to_partition (smallest, snode);
+
+  if (dump_file)
+    {
+      fprintf (dump_file, "\nPartition sizes:\n");
+      for (i = 0; i < ltrans_partitions.length (); i++)
+	fprintf (dump_file, "partition %d contains %d symbols, %d insns"
+		 " and %" PRId64 " time\n", i, ltrans_partitions[i]->symbols,
+		 ltrans_partitions[i]->insns, load[i]);
+      fprintf (dump_file, "\n");
+    }
+}
+
 /* Return true if we must not change the name of the NODE.  The name as
    extracted from the corresponding decl should be passed in NAME.  */
 
@@ -209,23 +209,28 @@ wait_for_child ()
 }
 #endif
 
+/* Stream out the partitions that WORKER_OF assigns to WORKER.  */
+
 static void
-stream_out_partitions_1 (char *temp_filename, int blen, int min, int max)
+stream_out_partitions_1 (char *temp_filename, int blen,
+			 const vec<int> &worker_of, int worker)
 {
    /* Write all the nodes in SET.  */
-   for (int p = min; p < max; p ++)
-     {
-       sprintf (temp_filename + blen, "%u.o", p);
-       stream_out (temp_filename, ltrans_partitions[p]->encoder, p);
-       ltrans_partitions[p]->encoder = NULL;
-     }
+   for (unsigned p = 0; p < worker_of.length (); p ++)
+     if (worker_of[p] == worker)
+       {
+	 sprintf (temp_filename + blen, "%u.o", p);
+	 stream_out (temp_filename, ltrans_partitions[p]->encoder, p);
+	 ltrans_partitions[p]->encoder = NULL;
+       }
 }
 
-/* Stream out ENCODER into TEMP_FILENAME
+/* Stream out the partitions of WORKER into TEMP_FILENAME
    Fork if that seems to help.  */
 
 static void
-stream_out_partitions (char *temp_filename, int blen, int min, int max,
+stream_out_partitions (char *temp_filename, int blen,
+		       const vec<int> &worker_of, int worker,
 		       bool ARG_UNUSED (last))
 {
 #ifdef HAVE_WORKING_FORK
@@ -233,7 +238,7 @@ stream_out_partitions (char *temp_filename, int blen, int min, int max,
 
   if (lto_parallelism <= 1)
     {
-      stream_out_partitions_1 (temp_filename, blen, min, max);
+      stream_out_partitions_1 (temp_filename, blen, worker_of, worker);
       return;
     }
 
@@ -253,12 +258,12 @@ stream_out_partitions (char *temp_filename, int blen, int min, int max,
       if (!cpid)
 	{
 	  setproctitle ("lto1-wpa-streaming");
-          stream_out_partitions_1 (temp_filename, blen, min, max);
+          stream_out_partitions_1 (temp_filename, blen, worker_of, worker);
 	  exit (0);
 	}
       /* Fork failed; lets do the job ourseleves.  */
       else if (cpid == -1)
-	stream_out_partitions_1 (temp_filename, blen, min, max);
+	stream_out_partitions_1 (temp_filename, blen, worker_of, worker);
       else
 	nruns++;
     }
@@ -266,16 +271,70 @@ stream_out_partitions (char *temp_filename, int blen, int min, int max,
   else
     {
       int i;
-      stream_out_partitions_1 (temp_filename, blen, min, max);
+      stream_out_partitions_1 (temp_filename, blen, worker_of, worker);
       for (i = 0; i < nruns; i++)
 	wait_for_child ();
     }
   asm_nodes_output = true;
 #else
-  stream_out_partitions_1 (temp_filename, blen, min, max);
+  stream_out_partitions_1 (temp_filename, blen, worker_of, worker);
 #endif
 }
 
+/* Write to F the import list of PART, which is output to FILENAME: the
+   input files its function bodies and variable initializers are copied
+   from, with the number of them taken from each.  */
+
+static void
+write_import_list (FILE *f, const char *filename, ltrans_partition part)
+{
+  hash_map<nofree_string_hash, int> counts;
+  auto_vec<const char *> files;
+  lto_symtab_encoder_iterator lsei;
+
+  for (lsei = lsei_start (part->encoder); !lsei_end_p (lsei);
+       lsei_next (&lsei))
+    {
+      symtab_node *node = lsei_node (lsei);
+      cgraph_node *cnode = dyn_cast <cgraph_node *> (node);
+      varpool_node *vnode = dyn_cast <varpool_node *> (node);
+      bool existed;
+
+      if (!node->lto_file_data
+	  || (cnode
+	      && !lto_symtab_encoder_encode_body_p (part->encoder, cnode))
+	  || (vnode
+	      && !lto_symtab_encoder_encode_initializer_p (part->encoder,
+							    vnode)))
+	continue;
+      const char *file_name = node->lto_file_data->file_name;
+      int &n = counts.get_or_insert (file_name, &existed);
+      if (!existed)
+	{
+	  n = 0;
+	  files.safe_push (file_name);
+	}
+      n++;
+    }
+
+  fprintf (f, "%s %i\n", filename, part->insns);
+  for (unsigned i = 0; i < files.length (); i++)
+    fprintf (f, "\t%s %i\n", files[i], *counts.get (files[i]));
+}
+
+/* Compare the ltrans_partitions indices in A and B by decreasing size of
+   the partitions.  */
+
+static int
+cmp_partitions_size (const void *a, const void *b)
+{
+  int pa = *(const int *) a;
+  int pb = *(const int *) b;
+  if (ltrans_partitions[pa]->insns != ltrans_partitions[pb]->insns)
+    return ltrans_partitions[pb]->insns - ltrans_partitions[pa]->insns;
+  return pa - pb;
+}
+
 /* Write all output files in WPA mode and the file with the list of
    LTRANS units.  */
 
@@ -285,6 +344,7 @@ lto_wpa_write_files (void)
   unsigned i, n_sets;
   ltrans_partition part;
   FILE *ltrans_output_list_stream;
+  FILE *import_lists_stream = NULL;
   char *temp_filename;
   auto_vec <char *>temp_filenames;
   auto_vec <int>temp_priority;
@@ -322,13 +382,46 @@ lto_wpa_write_files (void)
     temp_filename[blen - sizeof (".out") + 1] = '\0';
   blen = strlen (temp_filename);
 
+  if (flag_lto_import_lists)
+    {
+      import_lists_stream = fopen (flag_lto_import_lists, "w");
+      if (import_lists_stream == NULL)
+	fatal_error (input_location, "opening LTO import lists %s: %m",
+		     flag_lto_import_lists);
+    }
+
   n_sets = ltrans_partitions.length ();
-  unsigned sets_per_worker = n_sets;
-  if (lto_parallelism > 1)
+  if (lto_parallelism > (int)n_sets)
+    lto_parallelism = n_sets;
+  int n_workers = MAX (lto_parallelism, 1);
+
+  /* Hand the partitions to the streaming workers largest first, each to
+     the worker with the fewest insns so far, so that the workers finish
+     at about the same time even when the partition sizes vary a lot, as
+     they do with -flto-partition=1to1 or max.  The last worker is the
+     WPA process itself, which then has to wait for all the others.  */
+  auto_vec<int> worker_of (n_sets);
+  worker_of.quick_grow (n_sets);
+  if (n_workers == 1)
+    for (i = 0; i < n_sets; i++)
+      worker_of[i] = 0;
+  else
     {
-      if (lto_parallelism > (int)n_sets)
-	lto_parallelism = n_sets;
-      sets_per_worker = (n_sets + lto_parallelism - 1) / lto_parallelism;
+      auto_vec<int> order (n_sets);
+      auto_vec<int64_t> load (n_workers);
+      for (i = 0; i < n_sets; i++)
+	order.quick_push (i);
+      order.qsort (cmp_partitions_size);
+      load.safe_grow_cleared (n_workers);
+      for (i = 0; i < n_sets; i++)
+	{
+	  int best = 0;
+	  for (int w = 1; w < n_workers; w++)
+	    if (load[w] < load[best])
+	      best = w;
+	  worker_of[order[i]] = best;
+	  load[best] += ltrans_partitions[order[i]]->insns;
+	}
     }
 
   for (i = 0; i < n_sets; i++)
@@ -383,16 +476,20 @@ lto_wpa_write_files (void)
 	}
       gcc_checking_assert (lto_symtab_encoder_size (part->encoder) || !i);
 
+      if (import_lists_stream)
+	write_import_list (import_lists_stream, temp_filename, part);
+
       temp_priority.safe_push (part->insns);
       temp_filenames.safe_push (xstrdup (temp_filename));
     }
 
-  for (int set = 0; set < MAX (lto_parallelism, 1); set++)
-    {
-      stream_out_partitions (temp_filename, blen, set * sets_per_worker,
-			     MIN ((set + 1) * sets_per_worker, n_sets),
-			     set == MAX (lto_parallelism, 1) - 1);
-    }
+  if (import_lists_stream && fclose (import_lists_stream))
+    fatal_error (input_location, "closing LTO import lists %s: %m",
+		 flag_lto_import_lists);
+
+  for (int set = 0; set < n_workers; set++)
+    stream_out_partitions (temp_filename, blen, worker_of, set,
+			   set == n_workers - 1);
 
   ltrans_output_list_stream = fopen (ltrans_output_list, "w");
   if (ltrans_output_list_stream == NULL)
@@ -495,6 +592,9 @@ do_whole_program_analysis (void)
   else if (flag_lto_partition == LTO_PARTITION_BALANCED)
     lto_balanced_map (PARAM_VALUE (PARAM_LTO_PARTITIONS),
 		      PARAM_VALUE (MAX_PARTITION_SIZE));
+  else if (flag_lto_partition == LTO_PARTITION_CLUSTER)
+    lto_cluster_map (PARAM_VALUE (PARAM_LTO_PARTITIONS),
+		     PARAM_VALUE (MAX_PARTITION_SIZE));
   else
     gcc_unreachable ();
 
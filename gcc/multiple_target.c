@@ -38,6 +38,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "gimple-walk.h"
 #include "tree-inline.h"
 #include "intl.h"
+#include "cfgloop.h"
 
 /* Walker callback that replaces all FUNCTION_DECL of a function that's
    going to be versioned.  */
@@ -509,15 +510,87 @@ redirect_to_specific_clone (cgraph_node *node)
     }
 }
 
+/* Return true if the function in NODE should get the target clones
+   from -ftarget-clones-auto=: it is a definition without target
+   attributes of its own, profile feedback was read for it, and it
+   contains an innermost loop that the profile says is hot, which is
+   where clones for wider vector units pay off.  */
+
+static bool
+auto_target_clone_p (cgraph_node *node)
+{
+  tree decl = node->decl;
+  function *fun = DECL_STRUCT_FUNCTION (decl);
+  struct loop *loop;
+
+  if (!node->definition
+      || node->alias
+      || node->thunk.thunk_p
+      || !fun
+      || DECL_FUNCTION_VERSIONED (decl)
+      || MAIN_NAME_P (DECL_NAME (decl))
+      || lookup_attribute ("target", DECL_ATTRIBUTES (decl))
+      || lookup_attribute ("target_clones", DECL_ATTRIBUTES (decl))
+      || profile_status_for_fn (fun) != PROFILE_READ
+      || !loops_for_fn (fun)
+      || !opt_for_fn (decl, flag_tree_loop_vectorize)
+      || !tree_versionable_function_p (decl))
+    return false;
+
+  FOR_EACH_LOOP_FN (fun, loop, LI_ONLY_INNERMOST)
+    if (maybe_hot_bb_p (fun, loop->header))
+      return true;
+
+  return false;
+}
+
+/* Add a target_clones attribute for the targets in -ftarget-clones-auto=
+   and the default one to the function in NODE.  */
+
+static void
+add_auto_target_clones (cgraph_node *node)
+{
+  tree targets = build_string (strlen (flag_target_clones_auto) + 1,
+			       flag_target_clones_auto);
+  tree dflt = build_string (strlen ("default") + 1, "default");
+  tree args = tree_cons (NULL_TREE, targets,
+			 build_tree_list (NULL_TREE, dflt));
+
+  if (dump_file)
+    fprintf (dump_file, "Cloning %s for targets %s\n",
+	     node->dump_name (), flag_target_clones_auto);
+
+  DECL_ATTRIBUTES (node->decl)
+    = tree_cons (get_identifier ("target_clones"), args,
+		 DECL_ATTRIBUTES (node->decl));
+}
+
+/* Create the clones and dispatchers for target_clones attributes.  If
+   AUTO_P, first add such attributes to the functions chosen by
+   auto_target_clone_p, and handle only those.  */
+
 static unsigned int
-ipa_target_clone (void)
+ipa_target_clone (bool auto_p)
 {
   struct cgraph_node *node;
+  auto_vec<cgraph_node *> to_expand;
   auto_vec<cgraph_node *> to_dispatch;
 
-  FOR_EACH_FUNCTION (node)
-    if (expand_target_clones (node, node->definition))
-      to_dispatch.safe_push (node);
+  if (auto_p)
+    {
+      FOR_EACH_DEFINED_FUNCTION (node)
+	if (auto_target_clone_p (node))
+	  to_expand.safe_push (node);
+      for (unsigned i = 0; i < to_expand.length (); i++)
+	add_auto_target_clones (to_expand[i]);
+    }
+  else
+    FOR_EACH_FUNCTION (node)
+      to_expand.safe_push (node);
+
+  for (unsigned i = 0; i < to_expand.length (); i++)
+    if (expand_target_clones (to_expand[i], to_expand[i]->definition))
+      to_dispatch.safe_push (to_expand[i]);
 
   for (unsigned i = 0; i < to_dispatch.length (); i++)
     create_dispatcher_calls (to_dispatch[i]);
@@ -547,18 +620,37 @@ class pass_target_clone : public simple_ipa_opt_pass
 {
 public:
   pass_target_clone (gcc::context *ctxt)
-    : simple_ipa_opt_pass (pass_data_target_clone, ctxt)
+    : simple_ipa_opt_pass (pass_data_target_clone, ctxt), auto_p (false)
   {}
 
   /* opt_pass methods: */
+  opt_pass * clone () { return new pass_target_clone (m_ctxt); }
+  void set_pass_param (unsigned int n, bool param)
+    {
+      gcc_assert (n == 0);
+      auto_p = param;
+    }
   virtual bool gate (function *);
-  virtual unsigned int execute (function *) { return ipa_target_clone (); }
+  virtual unsigned int execute (function *)
+    { return ipa_target_clone (auto_p); }
+
+ private:
+  /* True for the instance that runs after the profile is read and
+     handles -ftarget-clones-auto=.  */
+  bool auto_p;
 };
 
 bool
 pass_target_clone::gate (function *)
 {
-  return true;
+  if (!auto_p)
+    return true;
+
+  return (flag_target_clones_auto
+	  && *flag_target_clones_auto
+	  && (flag_branch_probabilities || flag_auto_profile)
+	  && targetm.has_ifunc_p ()
+	  && targetm.get_function_versions_dispatcher);
 }
 
 } // anon namespace
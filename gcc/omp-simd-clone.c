@@ -1636,12 +1636,71 @@ simd_clone_adjust (struct cgraph_node *node)
   pop_cfun ();
 }
 
+/* Return the name of the scalar function FN if the vector math library
+   selected by -fveclib provides notinbranch variants of it that follow
+   the target's vector function ABI, otherwise return NULL.  */
+
+static const char *
+veclib_function_name (enum built_in_function fn)
+{
+  switch (flag_veclib)
+    {
+    case VECLIB_LIBMVEC:
+      switch (fn)
+	{
+	case BUILT_IN_COS: return "cos";
+	case BUILT_IN_COSF: return "cosf";
+	case BUILT_IN_EXP: return "exp";
+	case BUILT_IN_EXPF: return "expf";
+	case BUILT_IN_LOG: return "log";
+	case BUILT_IN_LOGF: return "logf";
+	case BUILT_IN_POW: return "pow";
+	case BUILT_IN_POWF: return "powf";
+	case BUILT_IN_SIN: return "sin";
+	case BUILT_IN_SINF: return "sinf";
+	default: return NULL;
+	}
+    default:
+      return NULL;
+    }
+}
+
+/* If NODE is a declaration of a math builtin that the vector math library
+   selected by -fveclib implements, tag it as an elemental SIMD function,
+   as if it had been declared with __attribute__((simd ("notinbranch"))).
+   The vector variants do not set errno, so only do this with
+   -fno-math-errno.  */
+
+static void
+maybe_add_veclib_simd_attribute (struct cgraph_node *node)
+{
+  tree decl = node->decl;
+  if (flag_veclib == VECLIB_NONE
+      || flag_errno_math
+      || node->definition
+      || !fndecl_built_in_p (decl, BUILT_IN_NORMAL)
+      || lookup_attribute ("omp declare simd", DECL_ATTRIBUTES (decl)))
+    return;
+
+  const char *name = veclib_function_name (DECL_FUNCTION_CODE (decl));
+  if (name == NULL
+      || strcmp (IDENTIFIER_POINTER (DECL_ASSEMBLER_NAME (decl)), name) != 0)
+    return;
+
+  tree clause = build_omp_clause (DECL_SOURCE_LOCATION (decl),
+				  OMP_CLAUSE_NOTINBRANCH);
+  DECL_ATTRIBUTES (decl)
+    = tree_cons (get_identifier ("omp declare simd"),
+		 build_tree_list (NULL_TREE, clause), DECL_ATTRIBUTES (decl));
+}
+
 /* If the function in NODE is tagged as an elemental SIMD function,
    create the appropriate SIMD clones.  */
 
 void
 expand_simd_clones (struct cgraph_node *node)
 {
+  maybe_add_veclib_simd_attribute (node);
   tree attr = lookup_attribute ("omp declare simd",
 				DECL_ATTRIBUTES (node->decl));
   if (attr == NULL_TREE
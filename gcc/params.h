@@ -250,5 +250,7 @@ extern void init_param_values (int *params);
   PARAM_VALUE (PARAM_ASAN_INSTRUMENTATION_WITH_CALL_THRESHOLD)
 #define ASAN_PARAM_USE_AFTER_SCOPE_DIRECT_EMISSION_THRESHOLD \
   ((unsigned) PARAM_VALUE (PARAM_USE_AFTER_SCOPE_DIRECT_EMISSION_THRESHOLD))
+#define TSAN_SAMPLE_RATE \
+  PARAM_VALUE (PARAM_TSAN_SAMPLE_RATE)
 
 #endif /* ! GCC_PARAMS_H */
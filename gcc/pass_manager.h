@@ -58,6 +58,7 @@ public:
   void dump_passes () const;
 
   void dump_profile_report () const;
+  void dump_pass_memory_report () const;
 
   void finish_optimization_passes ();
 
@@ -63,6 +63,8 @@ along with GCC; see the file COPYING3.  If not see
 #include "diagnostic-core.h" /* for fnotice */
 #include "stringpool.h"
 #include "attribs.h"
+#include "params.h"
+#include "trace-events.h"
 
 using namespace gcc;
 
@@ -1830,6 +1832,125 @@ account_profile (int index, bool run)
   profile_record_account_profile (&profile_record[index]);
 }
 
+/* Add the CPU time elapsed since START, as returned by get_run_time, to
+   the time spent on the current function, and note when that exceeds
+   --param max-function-compile-time.  */
+
+static void
+account_compile_time (long start)
+{
+  cfun->compile_time += get_run_time () - start;
+  if (cfun->compile_budget_exceeded
+      || (cfun->compile_time
+	  <= (HOST_WIDE_INT) PARAM_VALUE (PARAM_MAX_FUNCTION_COMPILE_TIME)
+	     * 1000))
+    return;
+
+  cfun->compile_budget_exceeded = 1;
+  warning_at (DECL_SOURCE_LOCATION (current_function_decl),
+	      OPT_Wdisabled_optimization,
+	      "compile time budget for %qD exceeded after %qs; expensive "
+	      "optimizations disabled (%<--param max-function-compile-time%> "
+	      "is %d)", current_function_decl, current_pass->name,
+	      PARAM_VALUE (PARAM_MAX_FUNCTION_COMPILE_TIME));
+  if (dump_file)
+    fprintf (dump_file, "Compile time budget exceeded\n");
+}
+
+/* Memory used by one pass, summed over all its executions, for
+   -fmem-report.  */
+
+struct pass_memory_record
+{
+  /* The number of times the pass was executed.  */
+  unsigned runs;
+  /* Bytes of GC memory allocated by the pass.  */
+  size_t ggc_allocated;
+  /* The most GC memory allocated by a single execution.  */
+  size_t ggc_allocated_max;
+  /* The growth of the peak resident set size while the pass ran, in kB.
+     This also covers heap memory, which is not tracked otherwise.  */
+  long max_rss_growth;
+};
+
+static struct pass_memory_record *pass_memory_record;
+
+/* Return the peak resident set size of the compiler so far in kB, or 0
+   if it is not known.  */
+
+static long
+max_rss_kb (void)
+{
+#if defined (HAVE_GETRUSAGE) && defined (HAVE_SYS_RESOURCE_H)
+  struct rusage rusage;
+  if (getrusage (RUSAGE_SELF, &rusage) == 0)
+    return rusage.ru_maxrss;
+#endif
+  return 0;
+}
+
+/* Account the memory used by one execution of the pass with static
+   number INDEX, which started when GGC_START bytes of GC memory had been
+   allocated in total and the peak resident set size was RSS_START kB.  */
+
+static void
+account_pass_memory (int index, size_t ggc_start, long rss_start)
+{
+  pass_manager *passes = g->get_passes ();
+  if (index == -1)
+    return;
+  if (!pass_memory_record)
+    pass_memory_record = XCNEWVEC (struct pass_memory_record,
+				   passes->passes_by_id_size);
+  gcc_assert (index < passes->passes_by_id_size && index >= 0);
+  struct pass_memory_record *r = &pass_memory_record[index];
+  size_t allocated = timevar_ggc_mem_total - ggc_start;
+  r->runs++;
+  r->ggc_allocated += allocated;
+  r->ggc_allocated_max = MAX (r->ggc_allocated_max, allocated);
+  r->max_rss_growth += max_rss_kb () - rss_start;
+}
+
+/* Output the memory used by each pass.  */
+
+void
+dump_pass_memory_report (void)
+{
+  g->get_passes ()->dump_pass_memory_report ();
+}
+
+void
+pass_manager::dump_pass_memory_report () const
+{
+  if (!pass_memory_record)
+    return;
+  fprintf (stderr, "\nMemory used by passes:\n\n");
+  fprintf (stderr, "%-33s%10s%16s%16s%16s\n", "Pass name", "Runs",
+	   "GGC allocated", "GGC max/run", "Peak RSS growth");
+  size_t total_allocated = 0;
+  long total_rss_growth = 0;
+  for (int i = 1; i < passes_by_id_size; i++)
+    {
+      const struct pass_memory_record *r = &pass_memory_record[i];
+      if (!r->runs)
+	continue;
+      total_allocated += r->ggc_allocated;
+      total_rss_growth += r->max_rss_growth;
+      /* Leave out passes that allocated less than a page and did not
+	 raise the peak.  */
+      if (r->ggc_allocated < 4096 && r->max_rss_growth <= 0)
+	continue;
+      fprintf (stderr, "%-33s%10u" PRsa (15) PRsa (15) PRsa (15) "\n",
+	       passes_by_id[i]->name, r->runs,
+	       SIZE_AMOUNT (r->ggc_allocated),
+	       SIZE_AMOUNT (r->ggc_allocated_max),
+	       SIZE_AMOUNT ((uint64_t) MAX (r->max_rss_growth, 0) * 1024));
+    }
+  fprintf (stderr, "%-43s" PRsa (15) "%16s" PRsa (15) "\n", "Total",
+	   SIZE_AMOUNT (total_allocated), "",
+	   SIZE_AMOUNT ((uint64_t) MAX (total_rss_growth, 0) * 1024));
+}
+
 /* Output profile consistency.  */
 
 void
@@ -2198,6 +2319,17 @@ execute_ipa_summary_passes (ipa_opt_pass_d *ipa_pass)
     }
 }
 
+/* Record in the trace that PASS ran from START until now, on the
+   current function if there is one.  */
+
+static void
+trace_pass_event (opt_pass *pass, uint64_t start)
+{
+  trace_event_complete (TRACE_TRACK_PASSES, pass->name, "pass", start,
+			cfun ? "function" : NULL,
+			cfun ? function_name (cfun) : NULL);
+}
+
 /* Execute IPA_PASS function transform on NODE.  */
 
 static void
@@ -2221,6 +2353,24 @@ execute_one_ipa_transform_pass (struct cgraph_node *node,
   if (pass->tv_id != TV_NONE)
     timevar_push (pass->tv_id);
 
+  /* With --param max-function-compile-time, measure the pass.  */
+  bool budget_time = cfun && PARAM_VALUE (PARAM_MAX_FUNCTION_COMPILE_TIME);
+  long start_time = budget_time ? get_run_time () : 0;
+
+  /* With -fmem-report, note the memory use before the pass.  */
+  size_t ggc_start = timevar_ggc_mem_total;
+  long rss_start = mem_report ? max_rss_kb () : 0;
+
+  /* With -ftime-report-json, also attribute the time to the function.  */
+  bool time_function = g_timer && time_report_json && cfun;
+  if (time_function)
+    g_timer->push_function_pass (DECL_UID (current_function_decl),
+				 function_name (cfun), pass->name);
+
+  /* With -ftrace-events, record the pass and the function it ran on.  */
+  bool trace_pass = trace_events_enabled_p ();
+  uint64_t trace_start = trace_pass ? trace_events_now () : 0;
+
   if (profile_report && cfun && (cfun->curr_properties & PROP_cfg))
     check_profile_consistency (pass->static_pass_number, true);
 
@@ -2239,6 +2389,14 @@ execute_one_ipa_transform_pass (struct cgraph_node *node,
   /* Stop timevar.  */
   if (pass->tv_id != TV_NONE)
     timevar_pop (pass->tv_id);
+  if (time_function)
+    g_timer->pop_function_pass ();
+  if (trace_pass)
+    trace_pass_event (pass, trace_start);
+  if (mem_report)
+    account_pass_memory (pass->static_pass_number, ggc_start, rss_start);
+  if (budget_time)
+    account_compile_time (start_time);
 
   if (dump_file)
     do_per_function (execute_function_dump, pass);
@@ -2480,6 +2638,24 @@ execute_one_pass (opt_pass *pass)
   if (pass->tv_id != TV_NONE)
     timevar_push (pass->tv_id);
 
+  /* With --param max-function-compile-time, measure the pass.  */
+  bool budget_time = cfun && PARAM_VALUE (PARAM_MAX_FUNCTION_COMPILE_TIME);
+  long start_time = budget_time ? get_run_time () : 0;
+
+  /* With -fmem-report, note the memory use before the pass.  */
+  size_t ggc_start = timevar_ggc_mem_total;
+  long rss_start = mem_report ? max_rss_kb () : 0;
+
+  /* With -ftime-report-json, also attribute the time to the function.  */
+  bool time_function = g_timer && time_report_json && cfun;
+  if (time_function)
+    g_timer->push_function_pass (DECL_UID (current_function_decl),
+				 function_name (cfun), pass->name);
+
+  /* With -ftrace-events, record the pass and the function it ran on.  */
+  bool trace_pass = trace_events_enabled_p ();
+  uint64_t trace_start = trace_pass ? trace_events_now () : 0;
+
   if (profile_report && cfun && (cfun->curr_properties & PROP_cfg))
     check_profile_consistency (pass->static_pass_number, true);
 
@@ -2498,6 +2674,12 @@ execute_one_pass (opt_pass *pass)
       /* Stop timevar.  */
       if (pass->tv_id != TV_NONE)
 	timevar_pop (pass->tv_id);
+      if (time_function)
+	g_timer->pop_function_pass ();
+      if (trace_pass)
+	trace_pass_event (pass, trace_start);
+      if (mem_report)
+	account_pass_memory (pass->static_pass_number, ggc_start, rss_start);
 
       pass_fini_dump_file (pass);
 
@@ -2537,6 +2719,14 @@ execute_one_pass (opt_pass *pass)
   /* Stop timevar.  */
   if (pass->tv_id != TV_NONE)
     timevar_pop (pass->tv_id);
+  if (time_function)
+    g_timer->pop_function_pass ();
+  if (trace_pass)
+    trace_pass_event (pass, trace_start);
+  if (mem_report)
+    account_pass_memory (pass->static_pass_number, ggc_start, rss_start);
+  if (budget_time)
+    account_compile_time (start_time);
 
   if (pass->type == IPA_PASS
       && ((ipa_opt_pass_d *)pass)->function_transform)
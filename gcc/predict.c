@@ -228,6 +228,16 @@ probably_never_executed (struct function *fun, profile_count count)
 	return false;
       return true;
     }
+  /* AutoFDO counts are sampled and scaled, so they are never precise.
+     Still, a block without any samples in a function that has some is
+     the best evidence of a never executed block we get from it.  */
+  if (flag_auto_profile
+      && profile_status_for_fn (fun) == PROFILE_READ
+      && count.ipa ().initialized_p ()
+      && count.ipa ().quality () == AFDO
+      && !count.ipa ().nonzero_p ()
+      && ENTRY_BLOCK_PTR_FOR_FN (fun)->count.ipa ().nonzero_p ())
+    return true;
   if ((!profile_info || profile_status_for_fn (fun) != PROFILE_READ)
       && (cgraph_node::get (fun->decl)->frequency
 	  == NODE_FREQUENCY_UNLIKELY_EXECUTED))
@@ -46,6 +46,12 @@ along with GCC; see the file COPYING3.  If not see
 #include "tree-dfa.h"
 #include "tree-ssa.h"
 #include "varasm.h"
+#include "tree-eh.h"
+#include "cfgloop.h"
+#include "tree-chrec.h"
+#include "tree-scalar-evolution.h"
+#include "tree-ssa-loop.h"
+#include "gimplify-me.h"
 
 /* This is used to carry information about basic blocks.  It is
    attached to the AUX field of the standard CFG block.  */
@@ -757,6 +763,344 @@ maybe_optimize_asan_check_ifn (class sanopt_ctx *ctx, gimple *stmt)
   return remove;
 }
 
+/* Return true if STMT is an ASAN_CHECK of a constant, non-zero length
+   that is expanded as a single shadow memory test.  */
+
+static bool
+scalar_asan_check_p (gimple *stmt)
+{
+  if (!gimple_call_internal_p (stmt, IFN_ASAN_CHECK))
+    return false;
+  HOST_WIDE_INT flags = tree_to_shwi (gimple_call_arg (stmt, 0));
+  return ((flags & ASAN_CHECK_SCALAR_ACCESS) != 0
+	  && (flags & ASAN_CHECK_RANGE) == 0
+	  && tree_fits_uhwi_p (gimple_call_arg (stmt, 2)));
+}
+
+/* Split the address PTR checked by an ASAN_CHECK into a base and a
+   constant byte offset, returning the base and storing the offset
+   into *OFFSET.  Return NULL_TREE if that is not possible.  */
+
+static tree
+asan_check_base_and_offset (tree ptr, HOST_WIDE_INT *offset)
+{
+  poly_int64 off = 0;
+
+  if (TREE_CODE (ptr) == SSA_NAME)
+    {
+      gimple *g = SSA_NAME_DEF_STMT (ptr);
+      if (is_gimple_assign (g)
+	  && gimple_assign_rhs_code (g) == POINTER_PLUS_EXPR
+	  && tree_fits_shwi_p (gimple_assign_rhs2 (g)))
+	{
+	  off = tree_to_shwi (gimple_assign_rhs2 (g));
+	  ptr = gimple_assign_rhs1 (g);
+	}
+      else if (gimple_assign_single_p (g)
+	       && TREE_CODE (gimple_assign_rhs1 (g)) == ADDR_EXPR)
+	ptr = gimple_assign_rhs1 (g);
+    }
+
+  if (TREE_CODE (ptr) == ADDR_EXPR)
+    {
+      poly_int64 off2;
+      tree base = get_addr_base_and_unit_offset (TREE_OPERAND (ptr, 0),
+						 &off2);
+      if (base == NULL_TREE)
+	return NULL_TREE;
+      off += off2;
+      if (TREE_CODE (base) == MEM_REF)
+	{
+	  poly_offset_int moff = mem_ref_offset (base);
+	  if (!moff.to_shwi (&off2))
+	    return NULL_TREE;
+	  off += off2;
+	  base = TREE_OPERAND (base, 0);
+	}
+      ptr = base;
+    }
+
+  if (!off.is_constant (offset))
+    return NULL_TREE;
+  return ptr;
+}
+
+/* Try to merge the ASAN_CHECK STMT into the earlier check PREV of the
+   same base, so that PREV covers both accesses.  This is done when
+   STMT checks memory directly after or overlapping the memory checked
+   by PREV and the merged check is still a single scalar shadow memory
+   test, so no detection power is lost.  Return true if STMT can be
+   removed.  */
+
+static bool
+maybe_merge_asan_checks (gimple *prev, gimple *stmt)
+{
+  HOST_WIDE_INT pflags = tree_to_shwi (gimple_call_arg (prev, 0));
+  HOST_WIDE_INT flags = tree_to_shwi (gimple_call_arg (stmt, 0));
+  if ((pflags & ASAN_CHECK_STORE) != (flags & ASAN_CHECK_STORE))
+    return false;
+
+  HOST_WIDE_INT poff, off;
+  tree pbase = asan_check_base_and_offset (gimple_call_arg (prev, 1), &poff);
+  tree base = asan_check_base_and_offset (gimple_call_arg (stmt, 1), &off);
+  if (pbase == NULL_TREE
+      || base == NULL_TREE
+      || !operand_equal_p (pbase, base, 0))
+    return false;
+
+  HOST_WIDE_INT plen = tree_to_uhwi (gimple_call_arg (prev, 2));
+  HOST_WIDE_INT len = tree_to_uhwi (gimple_call_arg (stmt, 2));
+  if (off < poff || off > poff + plen)
+    return false;
+
+  HOST_WIDE_INT new_len = MAX (plen, off + len - poff);
+  if (new_len == plen)
+    return true;
+
+  /* Only widen to sizes that build_check_stmt would treat as scalar
+     accesses with the alignment known for PREV.  */
+  HOST_WIDE_INT align = tree_to_shwi (gimple_call_arg (prev, 3));
+  if (new_len > 16
+      || !pow2p_hwi (new_len)
+      || (align < new_len
+	  && (new_len != 16 || STRICT_ALIGNMENT || align < 8)))
+    return false;
+
+  if (dump_file && (dump_flags & TDF_DETAILS))
+    {
+      fprintf (dump_file, "Merging: ");
+      print_gimple_stmt (dump_file, stmt, 0, dump_flags);
+      fprintf (dump_file, "  into: ");
+      print_gimple_stmt (dump_file, prev, 0, dump_flags);
+    }
+
+  tree plen_arg = gimple_call_arg (prev, 2);
+  gimple_call_set_arg (prev, 2, build_int_cst (TREE_TYPE (plen_arg),
+					       new_len));
+  update_stmt (prev);
+  return true;
+}
+
+/* Merge ASAN_CHECKs of adjacent memory, such as neighboring fields of
+   a structure, within each basic block of FUN.  Any call or asm
+   statement between two checks prevents merging them, as it might
+   free or poison the memory.  */
+
+static void
+sanopt_merge_asan_checks (function *fun)
+{
+  basic_block bb;
+  auto_vec<gimple *, 8> checks;
+
+  FOR_EACH_BB_FN (bb, fun)
+    {
+      checks.truncate (0);
+      for (gimple_stmt_iterator gsi = gsi_start_bb (bb); !gsi_end_p (gsi);)
+	{
+	  gimple *stmt = gsi_stmt (gsi);
+
+	  if (gimple_code (stmt) == GIMPLE_ASM
+	      || (is_gimple_call (stmt)
+		  && !gimple_call_internal_p (stmt, IFN_ASAN_CHECK)))
+	    {
+	      checks.truncate (0);
+	      gsi_next (&gsi);
+	      continue;
+	    }
+
+	  if (!scalar_asan_check_p (stmt))
+	    {
+	      gsi_next (&gsi);
+	      continue;
+	    }
+
+	  unsigned int i;
+	  gimple *prev;
+	  bool merged = false;
+	  FOR_EACH_VEC_ELT (checks, i, prev)
+	    if (maybe_merge_asan_checks (prev, stmt))
+	      {
+		merged = true;
+		break;
+	      }
+
+	  if (merged)
+	    {
+	      unlink_stmt_vdef (stmt);
+	      gsi_remove (&gsi, true);
+	    }
+	  else
+	    {
+	      checks.safe_push (stmt);
+	      gsi_next (&gsi);
+	    }
+	}
+    }
+}
+
+/* Return true if LOOP contains nothing that could free or poison
+   memory, or leave the loop other than through its exits: no calls
+   other than ASAN_CHECK, no asm statements and no statements that
+   can throw.  */
+
+static bool
+loop_safe_for_asan_hoisting_p (class loop *loop)
+{
+  basic_block *body = get_loop_body (loop);
+  bool safe = true;
+
+  for (unsigned int i = 0; i < loop->num_nodes && safe; i++)
+    for (gimple_stmt_iterator gsi = gsi_start_bb (body[i]);
+	 !gsi_end_p (gsi); gsi_next (&gsi))
+      {
+	gimple *stmt = gsi_stmt (gsi);
+	if (gimple_code (stmt) == GIMPLE_ASM
+	    || (is_gimple_call (stmt)
+		&& !gimple_call_internal_p (stmt, IFN_ASAN_CHECK))
+	    || stmt_could_throw_p (cfun, stmt))
+	  {
+	    safe = false;
+	    break;
+	  }
+      }
+
+  free (body);
+  return safe;
+}
+
+/* If the ASAN_CHECK STMT in LOOP checks a loop invariant address,
+   move the check to the loop preheader.  If it checks an affine address
+   that advances by no more than the checked length on each iteration,
+   replace it by a single check of the whole range accessed by the loop,
+   placed in the loop preheader.  NITER is the number of latch
+   executions of LOOP.  Return true if STMT was replaced.  */
+
+static bool
+maybe_hoist_asan_check (class loop *loop, gimple *stmt, tree niter)
+{
+  tree ptr = gimple_call_arg (stmt, 1);
+  tree len = gimple_call_arg (stmt, 2);
+  HOST_WIDE_INT flags = tree_to_shwi (gimple_call_arg (stmt, 0));
+  affine_iv iv;
+
+  if (TREE_CODE (len) != INTEGER_CST
+      || integer_zerop (len)
+      || (flags & ASAN_CHECK_RANGE) != 0
+      || !simple_iv (loop, loop, ptr, &iv, false)
+      || TREE_CODE (iv.step) != INTEGER_CST)
+    return false;
+
+  tree start = iv.base;
+  tree size = len;
+  if (!integer_zerop (iv.step))
+    {
+      /* The accessed bytes must form one contiguous range, so that
+	 checking the whole range does not diagnose gaps the loop never
+	 touches.  */
+      tree step = iv.step;
+      bool negative = tree_int_cst_sign_bit (step);
+      if (negative)
+	step = fold_build1 (NEGATE_EXPR, sizetype, step);
+      if (tree_int_cst_lt (len, fold_convert (TREE_TYPE (len), step)))
+	return false;
+
+      /* The range starts at BASE, or at BASE - NITER * STEP for a
+	 decreasing address, and is NITER * STEP + LEN bytes long.  */
+      tree span = fold_build2 (MULT_EXPR, sizetype,
+			       fold_convert (sizetype, niter),
+			       fold_convert (sizetype, step));
+      if (negative)
+	start = fold_build_pointer_plus (start,
+					 fold_build1 (NEGATE_EXPR, sizetype,
+						      span));
+      size = fold_build2 (PLUS_EXPR, sizetype, span,
+			  fold_convert (sizetype, len));
+      size = fold_convert (pointer_sized_int_node, size);
+
+      flags &= ~ASAN_CHECK_SCALAR_ACCESS;
+      flags |= ASAN_CHECK_RANGE | ASAN_CHECK_NON_ZERO_LEN;
+    }
+
+  gimple_seq seq = NULL;
+  start = force_gimple_operand (start, &seq, true, NULL_TREE);
+  size = force_gimple_operand (size, &seq, true, NULL_TREE);
+
+  gcall *g = gimple_build_call_internal (IFN_ASAN_CHECK, 4,
+					build_int_cst (integer_type_node,
+						       flags),
+					start, size,
+					gimple_call_arg (stmt, 3));
+  gimple_set_location (g, gimple_location (stmt));
+  gimple_seq_add_stmt (&seq, g);
+  gsi_insert_seq_on_edge_immediate (loop_preheader_edge (loop), seq);
+
+  if (dump_file && (dump_flags & TDF_DETAILS))
+    {
+      fprintf (dump_file, "Hoisting out of loop %d: ", loop->num);
+      print_gimple_stmt (dump_file, stmt, 0, dump_flags);
+      fprintf (dump_file, "  as: ");
+      print_gimple_stmt (dump_file, g, 0, dump_flags);
+    }
+
+  gimple_stmt_iterator gsi = gsi_for_stmt (stmt);
+  unlink_stmt_vdef (stmt);
+  gsi_remove (&gsi, true);
+  return true;
+}
+
+/* Move ASAN_CHECKs of invariant addresses out of the innermost loops
+   of FUN that run a computable number of times, and replace checks of
+   affine addresses in them by one range check each in the loop
+   preheader.  Only checks executed on every iteration are
+   considered, and only in loops that cannot free or poison memory.
+   The range check is expanded as a call to the run-time library,
+   which tests every byte of the range.  */
+
+static void
+sanopt_hoist_asan_checks (function *fun)
+{
+  class loop *loop;
+
+  loop_optimizer_init (LOOPS_NORMAL | LOOPS_HAVE_RECORDED_EXITS);
+  scev_initialize ();
+
+  FOR_EACH_LOOP (loop, LI_ONLY_INNERMOST)
+    {
+      edge exit = single_exit (loop);
+      if (!exit || !loop_safe_for_asan_hoisting_p (loop))
+	continue;
+
+      tree niter = number_of_latch_executions (loop);
+      if (chrec_contains_undetermined (niter)
+	  || TREE_CODE (niter) == COND_EXPR)
+	continue;
+
+      auto_vec<gimple *, 8> checks;
+      basic_block *body = get_loop_body (loop);
+      for (unsigned int i = 0; i < loop->num_nodes; i++)
+	{
+	  /* The check must run on every iteration, including the one
+	     that leaves the loop.  */
+	  if (!dominated_by_p (CDI_DOMINATORS, loop->latch, body[i])
+	      || !dominated_by_p (CDI_DOMINATORS, exit->src, body[i]))
+	    continue;
+	  for (gimple_stmt_iterator gsi = gsi_start_bb (body[i]);
+	       !gsi_end_p (gsi); gsi_next (&gsi))
+	    if (gimple_call_internal_p (gsi_stmt (gsi), IFN_ASAN_CHECK))
+	      checks.safe_push (gsi_stmt (gsi));
+	}
+      free (body);
+
+      unsigned int i;
+      gimple *stmt;
+      FOR_EACH_VEC_ELT (checks, i, stmt)
+	maybe_hoist_asan_check (loop, stmt, niter);
+    }
+
+  scev_finalize ();
+  loop_optimizer_finalize ();
+}
+
 /* Try to optimize away redundant UBSAN_NULL and ASAN_CHECK calls.
 
    We walk blocks in the CFG via a depth first search of the dominator
@@ -891,6 +1235,14 @@ sanopt_optimize (function *fun, bool *contains_asan_mark)
   ctx.asan_num_accesses = 0;
   ctx.contains_asan_mark = false;
 
+  /* Cover the accesses of simple loops and neighboring fields with
+     fewer, wider checks before removing the redundant ones.  */
+  if (flag_sanitize & SANITIZE_ADDRESS)
+    {
+      sanopt_hoist_asan_checks (fun);
+      sanopt_merge_asan_checks (fun);
+    }
+
   /* Set up block info for each basic block.  */
   alloc_aux_for_blocks (sizeof (sanopt_info));
 
@@ -63,6 +63,7 @@ selftest::run_tests ()
   et_forest_c_tests ();
   hash_map_tests_c_tests ();
   hash_set_tests_c_tests ();
+  swiss_table_tests_c_tests ();
   vec_c_tests ();
   pretty_print_c_tests ();
   wide_int_cc_tests ();
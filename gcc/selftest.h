@@ -246,6 +246,7 @@ extern void spellcheck_c_tests ();
 extern void spellcheck_tree_c_tests ();
 extern void sreal_c_tests ();
 extern void store_merging_c_tests ();
+extern void swiss_table_tests_c_tests ();
 extern void tree_c_tests ();
 extern void tree_cfg_c_tests ();
 extern void typed_splay_tree_c_tests ();
@@ -238,6 +238,64 @@ do {                                            \
   memcpy (out, l, r - out);
 }
 
+/* Check whether the C->N elements at BASE are already in order.  Return 1
+   if each element compares less than or equal to its successor, -1 if
+   each compares strictly greater, 0 otherwise.  Symbol and DIE lists are
+   often built in an order matching their comparator, and a linear scan
+   that gives up at the first mismatch is much cheaper than the sort.
+   Mergesort leaves such input unchanged, and strictly decreasing input
+   has a single sorted permutation, so either shortcut gives exactly the
+   result of a full sort.  */
+template<typename sort_ctx>
+static int
+presorted_p (char *base, sort_ctx *c)
+{
+  char *end = base + (c->n - 1) * c->size;
+  int dir = c->cmp (base, base + c->size) <= 0 ? 1 : -1;
+  for (char *e = base + c->size; e != end; e += c->size)
+    {
+      int r = c->cmp (e, e + c->size);
+      if (dir > 0 ? r > 0 : r <= 0)
+	return 0;
+    }
+  return dir;
+}
+
+/* Reverse the C->N elements at BASE in place.  */
+template<typename sort_ctx>
+static void
+reverse_elts (char *base, sort_ctx *c)
+{
+  for (char *l = base, *r = base + (c->n - 1) * c->size; l < r;
+       l += c->size, r -= c->size)
+    for (size_t i = 0; i < c->size; i++)
+      {
+	char t = l[i];
+	l[i] = r[i];
+	r[i] = t;
+      }
+}
+
+/* Sort the C->N elements at BASE, using the linear shortcuts above when
+   the input allows them.  */
+template<typename sort_ctx>
+static void
+sort_elts (char *base, sort_ctx *c)
+{
+  int dir = presorted_p (base, c);
+  if (dir > 0)
+    return;
+  if (dir < 0)
+    return reverse_elts (base, c);
+
+  long long scratch[32];
+  size_t bufsz = (c->n / 2) * c->size;
+  void *buf = bufsz <= sizeof scratch ? scratch : xmalloc (bufsz);
+  mergesort (base, c, c->n, base, (char *)buf);
+  if (buf != scratch)
+    free (buf);
+}
+
 #if CHECKING_P
 /* Adapter for using two-argument comparators in functions expecting the
    three-argument sort_r_cmp_fn type.  */
@@ -260,12 +318,7 @@ gcc_qsort (void *vbase, size_t n, size_t size, cmp_fn *cmp)
     nlim = 3, size = ~size;
   char *base = (char *)vbase;
   sort_ctx c = {cmp, base, n, size, nlim};
-  long long scratch[32];
-  size_t bufsz = (n / 2) * size;
-  void *buf = bufsz <= sizeof scratch ? scratch : xmalloc (bufsz);
-  mergesort (base, &c, n, base, (char *)buf);
-  if (buf != scratch)
-    free (buf);
+  sort_elts (base, &c);
 #if CHECKING_P
   qsort_chk (vbase, n, size, cmp2to3, (void*)cmp);
 #endif
@@ -279,12 +332,7 @@ gcc_sort_r (void *vbase, size_t n, size_t size, sort_r_cmp_fn *cmp, void *data)
     return;
   char *base = (char *)vbase;
   sort_r_ctx c = {data, cmp, base, n, size, 5};
-  long long scratch[32];
-  size_t bufsz = (n / 2) * size;
-  void *buf = bufsz <= sizeof scratch ? scratch : xmalloc (bufsz);
-  mergesort (base, &c, n, base, (char *)buf);
-  if (buf != scratch)
-    free (buf);
+  sort_elts (base, &c);
 #if CHECKING_P
   qsort_chk (vbase, n, size, cmp, data);
 #endif
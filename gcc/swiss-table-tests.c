@@ -0,0 +1,203 @@
+/* Unit tests for swiss-table.h.
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "config.h"
+#include "system.h"
+#include "coretypes.h"
+#include "swiss-table.h"
+#include "selftest.h"
+
+#if CHECKING_P
+
+namespace selftest {
+
+/* A descriptor for tables of small integers, where 0 is the empty
+   entry.  The hash deliberately differs only in its high bits for
+   consecutive values, and collides for values that are equal modulo
+   1024, to exercise the mixing and the probing.  */
+
+struct int_hasher : int_hash <int, 0, -1>
+{
+  static inline hashval_t hash (int x) { return (hashval_t) x << 22; }
+};
+
+typedef swiss_hash_table <int_hasher> int_table;
+
+/* Insert X into TABLE, returning true if it was already there.  */
+
+static bool
+add (int_table &table, int x)
+{
+  int *slot = table.find_slot_with_hash (x, int_hasher::hash (x), INSERT);
+  if (*slot == x)
+    return true;
+  ASSERT_EQ (0, *slot);
+  *slot = x;
+  return false;
+}
+
+/* Return true if X is in TABLE.  */
+
+static bool
+contains (int_table &table, int x)
+{
+  return table.find_with_hash (x, int_hasher::hash (x)) == x;
+}
+
+/* Verify that elements can be inserted, found and removed, and that the
+   table grows as needed.  */
+
+static void
+test_insert_find_remove ()
+{
+  int_table table (1);
+  ASSERT_TRUE (table.is_empty ());
+  ASSERT_TRUE (pow2p_hwi (table.size ()));
+  ASSERT_FALSE (contains (table, 1));
+  ASSERT_EQ (NULL, table.find_slot_with_hash (1, int_hasher::hash (1),
+					      NO_INSERT));
+
+  for (int i = 1; i <= 5000; i++)
+    ASSERT_FALSE (add (table, i));
+  ASSERT_EQ (5000, table.elements ());
+  ASSERT_TRUE (pow2p_hwi (table.size ()));
+  ASSERT_TRUE (table.size () >= 5000 * 8 / 7);
+
+  for (int i = 1; i <= 5000; i++)
+    ASSERT_TRUE (add (table, i));
+  ASSERT_EQ (5000, table.elements ());
+
+  for (int i = 1; i <= 5000; i += 2)
+    table.remove_elt_with_hash (i, int_hasher::hash (i));
+  table.remove_elt_with_hash (6000, int_hasher::hash (6000));
+  ASSERT_EQ (2500, table.elements ());
+  for (int i = 1; i <= 5000; i++)
+    ASSERT_EQ ((i & 1) == 0, contains (table, i));
+
+  /* Reuse the deleted slots.  */
+  for (int i = 1; i <= 5000; i += 2)
+    ASSERT_FALSE (add (table, i));
+  ASSERT_EQ (5000, table.elements ());
+  for (int i = 1; i <= 5000; i++)
+    ASSERT_TRUE (contains (table, i));
+
+  table.empty ();
+  ASSERT_TRUE (table.is_empty ());
+  ASSERT_FALSE (contains (table, 42));
+}
+
+/* Verify that repeatedly inserting and removing elements, which leaves
+   deleted slots behind, does not fill up the table.  */
+
+static void
+test_churn ()
+{
+  int_table table (16);
+  for (int i = 1; i <= 100000; i++)
+    {
+      ASSERT_FALSE (add (table, i));
+      if (i > 10)
+	{
+	  int *slot = table.find_slot_with_hash (i - 10,
+						 int_hasher::hash (i - 10),
+						 NO_INSERT);
+	  ASSERT_NE (NULL, slot);
+	  table.clear_slot (slot);
+	}
+    }
+  ASSERT_EQ (10, table.elements ());
+  ASSERT_TRUE (table.size () <= 64);
+  for (int i = 99991; i <= 100000; i++)
+    ASSERT_TRUE (contains (table, i));
+  ASSERT_FALSE (contains (table, 99990));
+}
+
+/* Verify that a slot obtained with INSERT but left empty is not seen as
+   an element.  */
+
+static void
+test_unused_slot ()
+{
+  int_table table (8);
+  ASSERT_FALSE (add (table, 3));
+  int *slot = table.find_slot_with_hash (7, int_hasher::hash (7), INSERT);
+  ASSERT_EQ (0, *slot);
+
+  int seen = 0;
+  for (int_table::iterator it = table.begin (); it != table.end (); ++it)
+    {
+      ASSERT_EQ (3, *it);
+      seen++;
+    }
+  ASSERT_EQ (1, seen);
+  ASSERT_FALSE (contains (table, 7));
+  ASSERT_TRUE (contains (table, 3));
+}
+
+/* Callback for test_traverse: count the elements and stop at 100.  */
+
+static int
+count_elements (int *slot, int *count)
+{
+  ASSERT_NE (0, *slot);
+  return ++*count < 100;
+}
+
+/* Verify iteration and traversal.  */
+
+static void
+test_traverse ()
+{
+  int_table table (8);
+  int sum = 0;
+  for (int i = 1; i <= 1000; i++)
+    add (table, i);
+
+  for (int_table::iterator it = table.begin (); it != table.end (); ++it)
+    sum += *it;
+  ASSERT_EQ (1000 * 1001 / 2, sum);
+
+  int count = 0;
+  table.traverse <int *, count_elements> (&count);
+  ASSERT_EQ (100, count);
+
+  /* Traversing a mostly empty table shrinks it.  */
+  size_t size = table.size ();
+  for (int i = 11; i <= 1000; i++)
+    table.remove_elt_with_hash (i, int_hasher::hash (i));
+  count = 0;
+  table.traverse <int *, count_elements> (&count);
+  ASSERT_EQ (10, count);
+  ASSERT_TRUE (table.size () < size);
+}
+
+/* Run all of the selftests within this file.  */
+
+void
+swiss_table_tests_c_tests ()
+{
+  test_insert_find_remove ();
+  test_churn ();
+  test_unused_slot ();
+  test_traverse ();
+}
+
+} // namespace selftest
+
+#endif /* CHECKING_P */
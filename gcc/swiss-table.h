@@ -0,0 +1,776 @@
+/* A hash table with group-probed control bytes.
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef GCC_SWISS_TABLE_H
+#define GCC_SWISS_TABLE_H
+
+/* This file provides swiss_hash_table, an alternative to hash_table
+   with the same interface and the same descriptors, but a different
+   layout of the table.
+
+   hash_table keeps a prime number of slots and probes them one at a
+   time with double hashing, which needs a modulo by the prime and
+   usually a cache miss per probe, each of which depends on the last.
+
+   swiss_hash_table instead keeps a power of two number of slots,
+   divided into groups of swiss_group::width consecutive slots, and a
+   separate array with one control byte per slot.  A control byte is
+   either swiss_ctrl_empty, swiss_ctrl_deleted or, for a live slot,
+   seven bits of the hash of its element.  A lookup loads the control
+   bytes of a whole group at once, compares them against the seven bits
+   of the hash it is looking for and only then looks at the candidate
+   slots; a group with an empty slot terminates the search.  Groups are probed
+   quadratically, which visits every group as their number is a power
+   of two.  Where the host supports SSE2 a group is 16 slots large and
+   compared with two instructions; elsewhere it is 8 slots large and
+   compared with word-sized integer arithmetic.
+
+   Since the table is indexed by a power of two, the hash values are
+   mixed with a multiplication first, so that descriptors whose hash is
+   poor in its low bits (pointer hashes, say) still spread out.
+
+   Switching a table over is a matter of changing its type:
+
+      typedef swiss_hash_table <some_type_hasher> some_type_table;
+
+   Unlike hash_table, swiss_hash_table cannot be allocated in GC memory
+   and is not lazily allocated.  */
+
+#include "hash-table.h"
+
+/* Control byte of a slot, which is one of the following two values or
+   seven bits of the hash of the element in the slot.  */
+
+typedef signed char swiss_ctrl_t;
+
+static const swiss_ctrl_t swiss_ctrl_empty = -128;
+static const swiss_ctrl_t swiss_ctrl_deleted = -2;
+
+#if GCC_VERSION >= 4005 && defined (__SSE2__)
+
+/* The control bytes of a group of slots, compared with SSE2.  Bit N of
+   a match mask is set for slot N of the group.  */
+
+struct swiss_group
+{
+  typedef char v16qi __attribute__ ((__vector_size__ (16)));
+  typedef unsigned int mask_type;
+
+  static const unsigned int width = 16;
+  static const int mask_shift = 0;
+
+  explicit swiss_group (const swiss_ctrl_t *ctrl)
+  {
+    memcpy (&m_ctrl, ctrl, sizeof (m_ctrl));
+  }
+
+  /* Return the slots whose control byte is H2.  */
+  mask_type match (swiss_ctrl_t h2) const
+  {
+    return __builtin_ia32_pmovmskb128 (__builtin_ia32_pcmpeqb128 (m_ctrl,
+								  splat (h2)));
+  }
+
+  /* Return the empty slots.  */
+  mask_type match_empty () const
+  {
+    return match (swiss_ctrl_empty);
+  }
+
+  /* Return the empty and deleted slots, which are the ones whose
+     control byte has its sign bit set.  */
+  mask_type match_empty_or_deleted () const
+  {
+    return __builtin_ia32_pmovmskb128 (m_ctrl);
+  }
+
+private:
+  static v16qi splat (char c)
+  {
+    v16qi v = { c, c, c, c, c, c, c, c, c, c, c, c, c, c, c, c };
+    return v;
+  }
+
+  v16qi m_ctrl;
+};
+
+#else
+
+/* The control bytes of a group of slots, compared as a 64-bit word.
+   Bit 8 * N + 7 of a match mask is set for slot N of the group.  */
+
+struct swiss_group
+{
+  typedef uint64_t mask_type;
+
+  static const unsigned int width = 8;
+  static const int mask_shift = 3;
+
+  explicit swiss_group (const swiss_ctrl_t *ctrl)
+  {
+    m_ctrl = 0;
+    for (unsigned int i = 0; i < width; i++)
+      m_ctrl |= (uint64_t) (unsigned char) ctrl[i] << (i * 8);
+  }
+
+  /* Return the slots whose control byte is H2.  This may report full
+     slots whose control byte is not H2 as well, which the caller
+     weeds out when comparing the elements; it never reports empty or
+     deleted slots since H2 has its sign bit clear.  */
+  mask_type match (swiss_ctrl_t h2) const
+  {
+    uint64_t x = m_ctrl ^ (lsbs * (unsigned char) h2);
+    return (x - lsbs) & ~x & msbs;
+  }
+
+  /* Return the empty slots.  An empty control byte is the only one
+     with its sign bit set and its second lowest bit clear.  */
+  mask_type match_empty () const
+  {
+    return m_ctrl & (~m_ctrl << 6) & msbs;
+  }
+
+  /* Return the empty and deleted slots, which are the ones whose
+     control byte has its sign bit set.  */
+  mask_type match_empty_or_deleted () const
+  {
+    return m_ctrl & msbs;
+  }
+
+private:
+  static const uint64_t lsbs = HOST_WIDE_INT_UC (0x0101010101010101);
+  static const uint64_t msbs = HOST_WIDE_INT_UC (0x8080808080808080);
+
+  uint64_t m_ctrl;
+};
+
+#endif
+
+/* Return the index within its group of the first slot in MASK.  */
+
+inline unsigned int
+swiss_group_first (swiss_group::mask_type mask)
+{
+  return ctz_hwi (mask) >> swiss_group::mask_shift;
+}
+
+/* User-facing hash table type with group-probed control bytes.  See
+   hash_table for the interface, and the top of this file for the
+   differences.  */
+
+template <typename Descriptor,
+	  template<typename Type> class Allocator = xcallocator>
+class swiss_hash_table
+{
+  typedef typename Descriptor::value_type value_type;
+  typedef typename Descriptor::compare_type compare_type;
+
+public:
+  explicit swiss_hash_table (size_t, bool ggc = false,
+			     bool sanitize_eq_and_hash = true,
+			     bool gather_mem_stats = GATHER_STATISTICS,
+			     mem_alloc_origin origin = HASH_TABLE_ORIGIN
+			     CXX_MEM_STAT_INFO);
+  ~swiss_hash_table ();
+
+  /* Current size (in entries) of the hash table.  */
+  size_t size () const { return m_size; }
+
+  /* Return the current number of elements in this hash table. */
+  size_t elements () const { return m_n_elements - m_n_deleted; }
+
+  /* Return the current number of elements in this hash table. */
+  size_t elements_with_deleted () const { return m_n_elements; }
+
+  /* This function clears all entries in this hash table.  */
+  void empty () { if (elements ()) empty_slow (); }
+
+  /* Return true when there are no elements in this hash table.  */
+  bool is_empty () const { return elements () == 0; }
+
+  /* This function clears a specified SLOT in a hash table.  */
+  void clear_slot (value_type *);
+
+  /* This function searches for a hash table entry equal to the given
+     COMPARABLE element starting with the given HASH value.  It cannot
+     be used to insert or delete an element. */
+  value_type &find_with_hash (const compare_type &, hashval_t);
+
+  /* Like find_slot_with_hash, but compute the hash value from the
+     element.  */
+  value_type &find (const value_type &value)
+    {
+      return find_with_hash (value, Descriptor::hash (value));
+    }
+
+  value_type *find_slot (const value_type &value, insert_option insert)
+    {
+      return find_slot_with_hash (value, Descriptor::hash (value), insert);
+    }
+
+  /* This function searches for a hash table slot containing an entry
+     equal to the given COMPARABLE element and starting with the given
+     HASH.  To delete an entry, call this with insert=NO_INSERT, then
+     call clear_slot on the slot returned (possibly after doing some
+     checks).  To insert an entry, call this with insert=INSERT, then
+     write the value you want into the returned slot.  */
+  value_type *find_slot_with_hash (const compare_type &comparable,
+				   hashval_t hash, enum insert_option insert);
+
+  /* This function deletes an element with the given COMPARABLE value
+     from hash table starting with the given HASH.  If there is no
+     matching element in the hash table, this function does nothing. */
+  void remove_elt_with_hash (const compare_type &, hashval_t);
+
+  /* Like remove_elt_with_hash, but compute the hash value from the
+     element.  */
+  void remove_elt (const value_type &value)
+    {
+      remove_elt_with_hash (value, Descriptor::hash (value));
+    }
+
+  /* This function scans over the entire hash table calling CALLBACK for
+     each live entry.  If CALLBACK returns false, the iteration stops.
+     ARGUMENT is passed as CALLBACK's second argument. */
+  template <typename Argument,
+	    int (*Callback) (value_type *slot, Argument argument)>
+  void traverse_noresize (Argument argument);
+
+  /* Like traverse_noresize, but does resize the table when it is too empty
+     to improve effectivity of subsequent calls.  */
+  template <typename Argument,
+	    int (*Callback) (value_type *slot, Argument argument)>
+  void traverse (Argument argument);
+
+  class iterator
+  {
+  public:
+    iterator () : m_slot (NULL), m_limit (NULL), m_ctrl (NULL) {}
+
+    iterator (value_type *slot, value_type *limit, const swiss_ctrl_t *ctrl)
+      : m_slot (slot), m_limit (limit), m_ctrl (ctrl) {}
+
+    inline value_type &operator * () { return *m_slot; }
+    void slide ();
+    inline iterator &operator ++ ();
+    bool operator != (const iterator &other) const
+      {
+	return m_slot != other.m_slot || m_limit != other.m_limit;
+      }
+
+  private:
+    value_type *m_slot;
+    value_type *m_limit;
+    const swiss_ctrl_t *m_ctrl;
+  };
+
+  iterator begin () const
+    {
+      iterator iter (m_entries, m_entries + m_size, m_ctrl);
+      iter.slide ();
+      return iter;
+    }
+
+  iterator end () const { return iterator (); }
+
+  double collisions () const
+    {
+      return m_searches ? static_cast <double> (m_collisions) / m_searches : 0;
+    }
+
+private:
+  swiss_hash_table (const swiss_hash_table &);
+  void operator= (swiss_hash_table &);
+
+  void empty_slow ();
+
+  void alloc_entries (size_t n CXX_MEM_STAT_INFO);
+  void free_entries ();
+  size_t find_empty_slot_for_expand (hashval_t);
+  void verify (const compare_type &comparable, hashval_t hash);
+  bool too_empty_p (unsigned int);
+  void expand ();
+
+  /* Return true if slot I holds an element.  A slot can be full and
+     still hold an empty element if find_slot_with_hash was asked to
+     insert but the caller did not store anything into the slot.  */
+  bool live_p (size_t i) const
+  {
+    return m_ctrl[i] >= 0 && !Descriptor::is_empty (m_entries[i]);
+  }
+
+  /* Mix HASH so that all of its bits affect the bits used below.  */
+  static uint64_t mix_hash (hashval_t hash)
+  {
+    return (uint64_t) hash * HOST_WIDE_INT_UC (0x9e3779b97f4a7c15);
+  }
+
+  /* The seven bits of mixed hash M that are stored in the control
+     bytes, and the group at which the probing for M starts.  These
+     are taken from disjoint bits of M.  */
+  static swiss_ctrl_t h2 (uint64_t m) { return m >> 57; }
+  size_t h1 (uint64_t m) const { return (m >> 32) & m_group_mask; }
+
+  /* The slots, their control bytes and the number of slots.  */
+  value_type *m_entries;
+  swiss_ctrl_t *m_ctrl;
+  size_t m_size;
+
+  /* The number of groups of slots minus one.  */
+  size_t m_group_mask;
+
+  /* Current number of elements including also deleted elements.  */
+  size_t m_n_elements;
+
+  /* Current number of deleted elements in the table.  */
+  size_t m_n_deleted;
+
+  /* The following member is used for debugging. Its value is number
+     of all calls of `htab_find_slot' for the hash table. */
+  unsigned int m_searches;
+
+  /* The following member is used for debugging.  Its value is number
+     of groups probed beyond the first one. */
+  unsigned int m_collisions;
+
+  /* True if the table should be sanitized for equal and hash functions.  */
+  bool m_sanitize_eq_and_hash;
+
+  /* If we should gather memory statistics for the table.  */
+#if GATHER_STATISTICS
+  bool m_gather_mem_stats;
+#else
+  static const bool m_gather_mem_stats = false;
+#endif
+};
+
+/* Return the smallest valid table size with room for N elements.  */
+
+inline size_t
+swiss_table_size_for (size_t n)
+{
+  size_t size = swiss_group::width;
+  while (size < n)
+    size *= 2;
+  return size;
+}
+
+template<typename Descriptor, template<typename Type> class Allocator>
+swiss_hash_table<Descriptor, Allocator>::swiss_hash_table
+  (size_t size, bool ggc ATTRIBUTE_UNUSED, bool sanitize_eq_and_hash,
+   bool gather_mem_stats ATTRIBUTE_UNUSED, mem_alloc_origin origin
+   MEM_STAT_DECL) :
+  m_n_elements (0), m_n_deleted (0), m_searches (0), m_collisions (0),
+  m_sanitize_eq_and_hash (sanitize_eq_and_hash)
+#if GATHER_STATISTICS
+  , m_gather_mem_stats (gather_mem_stats)
+#endif
+{
+  gcc_assert (!ggc);
+
+  if (m_gather_mem_stats)
+    hash_table_usage ().register_descriptor (this, origin, false
+					     FINAL_PASS_MEM_STAT);
+
+  alloc_entries (swiss_table_size_for (size) PASS_MEM_STAT);
+}
+
+template<typename Descriptor, template<typename Type> class Allocator>
+swiss_hash_table<Descriptor, Allocator>::~swiss_hash_table ()
+{
+  for (size_t i = m_size - 1; i < m_size; i--)
+    if (live_p (i))
+      Descriptor::remove (m_entries[i]);
+
+  free_entries ();
+  if (m_gather_mem_stats)
+    hash_table_usage ().unregister_descriptor (this);
+}
+
+/* Allocate N empty slots and their control bytes, and make them the
+   table.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+swiss_hash_table<Descriptor, Allocator>::alloc_entries (size_t n
+							 MEM_STAT_DECL)
+{
+  if (m_gather_mem_stats)
+    hash_table_usage ().register_instance_overhead ((sizeof (value_type)
+						     + sizeof (swiss_ctrl_t))
+						    * n, this);
+
+  m_entries = Allocator <value_type> ::data_alloc (n);
+  m_ctrl = Allocator <swiss_ctrl_t> ::data_alloc (n);
+  gcc_assert (m_entries != NULL && m_ctrl != NULL);
+  for (size_t i = 0; i < n; i++)
+    Descriptor::mark_empty (m_entries[i]);
+  memset (m_ctrl, swiss_ctrl_empty, n);
+
+  m_size = n;
+  m_group_mask = n / swiss_group::width - 1;
+}
+
+/* Free the slots and control bytes of the table.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+swiss_hash_table<Descriptor, Allocator>::free_entries ()
+{
+  Allocator <value_type> ::data_free (m_entries);
+  Allocator <swiss_ctrl_t> ::data_free (m_ctrl);
+  if (m_gather_mem_stats)
+    hash_table_usage ().release_instance_overhead (this,
+						   (sizeof (value_type)
+						    + sizeof (swiss_ctrl_t))
+						   * m_size);
+}
+
+/* Return the index of an empty slot for an element with hash HASH.
+   This assumes the table has no deleted slots, and does not change
+   the table.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+size_t
+swiss_hash_table<Descriptor, Allocator>::find_empty_slot_for_expand
+  (hashval_t hash)
+{
+  uint64_t m = mix_hash (hash);
+  size_t group = h1 (m);
+
+  for (size_t stride = 1;; stride++)
+    {
+      size_t base = group * swiss_group::width;
+      swiss_group::mask_type empty
+	= swiss_group (m_ctrl + base).match_empty ();
+      if (empty)
+	{
+	  size_t i = base + swiss_group_first (empty);
+	  m_ctrl[i] = h2 (m);
+	  return i;
+	}
+      group = (group + stride) & m_group_mask;
+    }
+}
+
+/* Return true if the current table is excessively big for ELTS elements.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+inline bool
+swiss_hash_table<Descriptor, Allocator>::too_empty_p (unsigned int elts)
+{
+  return elts * 8 < m_size && m_size > 32;
+}
+
+/* Rehash the elements of the table into a table that is less than
+   half full, dropping the deleted slots.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+swiss_hash_table<Descriptor, Allocator>::expand ()
+{
+  value_type *oentries = m_entries;
+  swiss_ctrl_t *octrl = m_ctrl;
+  size_t osize = m_size;
+  size_t elts = elements ();
+
+  /* Resize only when table after removal of unused elements is either
+     too full or too empty.  */
+  size_t nsize = osize;
+  if (elts * 2 > osize || too_empty_p (elts))
+    nsize = swiss_table_size_for (elts * 2 + 1);
+
+  if (m_gather_mem_stats)
+    hash_table_usage ().release_instance_overhead (this,
+						   (sizeof (value_type)
+						    + sizeof (swiss_ctrl_t))
+						   * osize);
+
+  alloc_entries (nsize);
+  m_n_elements -= m_n_deleted;
+  m_n_deleted = 0;
+
+  for (size_t i = 0; i < osize; i++)
+    if (octrl[i] >= 0 && !Descriptor::is_empty (oentries[i]))
+      {
+	value_type &x = oentries[i];
+	m_entries[find_empty_slot_for_expand (Descriptor::hash (x))] = x;
+      }
+
+  Allocator <value_type> ::data_free (oentries);
+  Allocator <swiss_ctrl_t> ::data_free (octrl);
+}
+
+/* Implements empty() in cases where it isn't a no-op.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+swiss_hash_table<Descriptor, Allocator>::empty_slow ()
+{
+  size_t size = m_size;
+  size_t nsize = size;
+
+  for (size_t i = size - 1; i < size; i--)
+    if (live_p (i))
+      Descriptor::remove (m_entries[i]);
+
+  /* Instead of clearing megabyte, downsize the table.  */
+  if (size > 1024*1024 / sizeof (value_type))
+    nsize = swiss_table_size_for (1024 / sizeof (value_type));
+  else if (too_empty_p (m_n_elements))
+    nsize = swiss_table_size_for (m_n_elements * 2);
+
+  if (nsize != size)
+    {
+      free_entries ();
+      alloc_entries (nsize);
+    }
+  else
+    {
+      for (size_t i = 0; i < size; i++)
+	Descriptor::mark_empty (m_entries[i]);
+      memset (m_ctrl, swiss_ctrl_empty, size);
+    }
+  m_n_deleted = 0;
+  m_n_elements = 0;
+}
+
+/* This function clears a specified SLOT in a hash table.  It is
+   useful when you've already done the lookup and don't want to do it
+   again.  If the group of SLOT has an empty slot, no search can have
+   gone past it, so SLOT becomes empty rather than deleted.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+swiss_hash_table<Descriptor, Allocator>::clear_slot (value_type *slot)
+{
+  size_t i = slot - m_entries;
+  gcc_checking_assert (i < m_size && live_p (i));
+
+  Descriptor::remove (*slot);
+  Descriptor::mark_empty (*slot);
+
+  size_t base = i & ~(size_t) (swiss_group::width - 1);
+  if (swiss_group (m_ctrl + base).match_empty ())
+    {
+      m_ctrl[i] = swiss_ctrl_empty;
+      m_n_elements--;
+    }
+  else
+    {
+      m_ctrl[i] = swiss_ctrl_deleted;
+      m_n_deleted++;
+    }
+}
+
+/* This function searches for a hash table entry equal to the given
+   COMPARABLE element starting with the given HASH value.  It cannot
+   be used to insert or delete an element. */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+typename swiss_hash_table<Descriptor, Allocator>::value_type &
+swiss_hash_table<Descriptor, Allocator>
+::find_with_hash (const compare_type &comparable, hashval_t hash)
+{
+  m_searches++;
+  uint64_t m = mix_hash (hash);
+  swiss_ctrl_t tag = h2 (m);
+  size_t group = h1 (m);
+
+  for (size_t stride = 1;; stride++)
+    {
+      size_t base = group * swiss_group::width;
+      swiss_group g (m_ctrl + base);
+      for (swiss_group::mask_type match = g.match (tag); match;
+	   match &= match - 1)
+	{
+	  value_type *entry = &m_entries[base + swiss_group_first (match)];
+	  if (!Descriptor::is_empty (*entry)
+	      && Descriptor::equal (*entry, comparable))
+	    return *entry;
+	}
+      /* When the element is not found, return an empty slot like
+	 hash_table does.  */
+      if (swiss_group::mask_type empty = g.match_empty ())
+	{
+#if CHECKING_P
+	  if (m_sanitize_eq_and_hash)
+	    verify (comparable, hash);
+#endif
+	  return m_entries[base + swiss_group_first (empty)];
+	}
+      m_collisions++;
+      group = (group + stride) & m_group_mask;
+    }
+}
+
+/* This function searches for a hash table slot containing an entry
+   equal to the given COMPARABLE element and starting with the given
+   HASH.  To delete an entry, call this with insert=NO_INSERT, then
+   call clear_slot on the slot returned (possibly after doing some
+   checks).  To insert an entry, call this with insert=INSERT, then
+   write the value you want into the returned slot.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+typename swiss_hash_table<Descriptor, Allocator>::value_type *
+swiss_hash_table<Descriptor, Allocator>
+::find_slot_with_hash (const compare_type &comparable, hashval_t hash,
+		       enum insert_option insert)
+{
+  /* Keep at most 7/8 of the slots full or deleted, so that searches
+     always meet an empty slot soon enough.  */
+  if (insert == INSERT && (m_n_elements + 1) * 8 > m_size * 7)
+    expand ();
+
+#if CHECKING_P
+  if (m_sanitize_eq_and_hash)
+    verify (comparable, hash);
+#endif
+
+  m_searches++;
+  uint64_t m = mix_hash (hash);
+  swiss_ctrl_t tag = h2 (m);
+  size_t group = h1 (m);
+  size_t first_free = m_size;
+
+  for (size_t stride = 1;; stride++)
+    {
+      size_t base = group * swiss_group::width;
+      swiss_group g (m_ctrl + base);
+      for (swiss_group::mask_type match = g.match (tag); match;
+	   match &= match - 1)
+	{
+	  value_type *entry = &m_entries[base + swiss_group_first (match)];
+	  if (!Descriptor::is_empty (*entry)
+	      && Descriptor::equal (*entry, comparable))
+	    return entry;
+	}
+      if (first_free == m_size)
+	if (swiss_group::mask_type avail = g.match_empty_or_deleted ())
+	  first_free = base + swiss_group_first (avail);
+      if (g.match_empty ())
+	break;
+      m_collisions++;
+      group = (group + stride) & m_group_mask;
+    }
+
+  if (insert == NO_INSERT)
+    return NULL;
+
+  if (m_ctrl[first_free] == swiss_ctrl_deleted)
+    m_n_deleted--;
+  else
+    m_n_elements++;
+  m_ctrl[first_free] = tag;
+  return &m_entries[first_free];
+}
+
+/* Verify that all existing elements in th hash table which are
+   equal to COMPARABLE have an equal HASH value provided as argument.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+swiss_hash_table<Descriptor, Allocator>
+::verify (const compare_type &comparable, hashval_t hash)
+{
+  for (size_t i = 0; i < MIN (hash_table_sanitize_eq_limit, m_size); i++)
+    {
+      value_type *entry = &m_entries[i];
+      if (live_p (i)
+	  && hash != Descriptor::hash (*entry)
+	  && Descriptor::equal (*entry, comparable))
+	hashtab_chk_error ();
+    }
+}
+
+/* This function deletes an element with the given COMPARABLE value
+   from hash table starting with the given HASH.  If there is no
+   matching element in the hash table, this function does nothing. */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+swiss_hash_table<Descriptor, Allocator>
+::remove_elt_with_hash (const compare_type &comparable, hashval_t hash)
+{
+  value_type *slot = find_slot_with_hash (comparable, hash, NO_INSERT);
+  if (slot != NULL)
+    clear_slot (slot);
+}
+
+/* This function scans over the entire hash table calling CALLBACK for
+   each live entry.  If CALLBACK returns false, the iteration stops.
+   ARGUMENT is passed as CALLBACK's second argument. */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+template<typename Argument,
+	 int (*Callback)
+	 (typename swiss_hash_table<Descriptor, Allocator>::value_type *slot,
+	 Argument argument)>
+void
+swiss_hash_table<Descriptor, Allocator>::traverse_noresize (Argument argument)
+{
+  for (size_t i = 0; i < m_size; i++)
+    if (live_p (i))
+      if (! Callback (&m_entries[i], argument))
+	break;
+}
+
+/* Like traverse_noresize, but does resize the table when it is too empty
+   to improve effectivity of subsequent calls.  */
+
+template <typename Descriptor, template <typename Type> class Allocator>
+template <typename Argument,
+	  int (*Callback)
+	  (typename swiss_hash_table<Descriptor, Allocator>::value_type *slot,
+	  Argument argument)>
+void
+swiss_hash_table<Descriptor, Allocator>::traverse (Argument argument)
+{
+  if (too_empty_p (elements ()))
+    expand ();
+
+  traverse_noresize <Argument, Callback> (argument);
+}
+
+/* Slide down the iterator slots until an active entry is found.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+void
+swiss_hash_table<Descriptor, Allocator>::iterator::slide ()
+{
+  for ( ; m_slot < m_limit; ++m_slot, ++m_ctrl)
+    if (*m_ctrl >= 0 && !Descriptor::is_empty (*m_slot))
+      return;
+  m_slot = NULL;
+  m_limit = NULL;
+}
+
+/* Bump the iterator.  */
+
+template<typename Descriptor, template<typename Type> class Allocator>
+inline typename swiss_hash_table<Descriptor, Allocator>::iterator &
+swiss_hash_table<Descriptor, Allocator>::iterator::operator ++ ()
+{
+  ++m_slot;
+  ++m_ctrl;
+  slide ();
+  return *this;
+}
+
+#endif /* GCC_SWISS_TABLE_H */
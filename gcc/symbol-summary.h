@@ -29,7 +29,8 @@ class function_summary_base
 public:
   /* Default construction takes SYMTAB as an argument.  */
   function_summary_base (symbol_table *symtab): m_symtab (symtab),
-  m_insertion_enabled (true), m_released (false)
+  m_insertion_enabled (true), m_released (false),
+  m_allocator ("function summary")
   {}
 
   /* Basic implementation of insert operation.  */
@@ -58,8 +59,10 @@ protected:
   T* allocate_new ()
   {
     /* Call gcc_internal_because we do not want to call finalizer for
-       a type T.  We call dtor explicitly.  */
-    return is_ggc () ? new (ggc_internal_alloc (sizeof (T))) T () : new T () ;
+       a type T.  We call dtor explicitly.  Heap summaries come from a
+       pool, as there is one for each function or edge.  */
+    return (is_ggc () ? new (ggc_internal_alloc (sizeof (T))) T ()
+	    : new (m_allocator.allocate_raw ()) T ());
   }
 
   /* Release an item that is stored within map.  */
@@ -71,7 +74,7 @@ protected:
 	ggc_free (item);
       }
     else
-      delete item;
+      m_allocator.remove (item);
   }
 
   /* Unregister all call-graph hooks.  */
@@ -90,6 +93,8 @@ protected:
   bool m_insertion_enabled;
   /* Indicates if the summary is released.  */
   bool m_released;
+  /* Pool the summaries not in GGC memory are allocated from.  */
+  object_allocator<T> m_allocator;
 
 private:
   /* Return true when the summary uses GGC memory for allocation.  */
@@ -560,7 +565,8 @@ class call_summary_base
 public:
   /* Default construction takes SYMTAB as an argument.  */
   call_summary_base (symbol_table *symtab): m_symtab (symtab),
-  m_initialize_when_cloning (true), m_released (false)
+  m_initialize_when_cloning (true), m_released (false),
+  m_allocator ("call summary")
   {}
 
   /* Basic implementation of removal operation.  */
@@ -574,8 +580,10 @@ protected:
   T* allocate_new ()
   {
     /* Call gcc_internal_because we do not want to call finalizer for
-       a type T.  We call dtor explicitly.  */
-    return is_ggc () ? new (ggc_internal_alloc (sizeof (T))) T () : new T () ;
+       a type T.  We call dtor explicitly.  Heap summaries come from a
+       pool, as there is one for each function or edge.  */
+    return (is_ggc () ? new (ggc_internal_alloc (sizeof (T))) T ()
+	    : new (m_allocator.allocate_raw ()) T ());
   }
 
   /* Release an item that is stored within map.  */
@@ -587,7 +595,7 @@ protected:
 	ggc_free (item);
       }
     else
-      delete item;
+      m_allocator.remove (item);
   }
 
   /* Unregister all call-graph hooks.  */
@@ -604,6 +612,8 @@ protected:
   bool m_initialize_when_cloning;
   /* Indicates if the summary is released.  */
   bool m_released;
+  /* Pool the summaries not in GGC memory are allocated from.  */
+  object_allocator<T> m_allocator;
 
 private:
   /* Return true when the summary uses GGC memory for allocation.  */
@@ -0,0 +1,20 @@
+/* { dg-options "-fdump-tree-sanopt" } */
+/* { dg-do compile } */
+/* { dg-skip-if "" { *-*-* } { "*" } { "-O0" } } */
+
+struct S
+{
+  int a;
+  int b;
+} __attribute__ ((aligned (8)));
+
+void
+foo (struct S *p)
+{
+  /* The two adjacent 4-byte stores are checked with one 8-byte check.  */
+  p->a = 1;
+  p->b = 2;
+}
+
+/* { dg-final { scan-tree-dump-times "__builtin___asan_report_store8" 1 "sanopt" } } */
+/* { dg-final { scan-tree-dump-not "__builtin___asan_report_store4" "sanopt" } } */
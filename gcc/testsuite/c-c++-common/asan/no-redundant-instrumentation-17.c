@@ -0,0 +1,18 @@
+/* { dg-options "-fdump-tree-sanopt -fno-tree-vectorize -fno-tree-loop-distribute-patterns" } */
+/* { dg-do compile } */
+/* { dg-skip-if "" { *-*-* } { "*" } { "-O2" } } */
+
+int
+foo (int *p, int n)
+{
+  int i, s = 0;
+
+  /* The loads of p[0] through p[n - 1] are checked once before the
+     loop, by a single range check.  */
+  for (i = 0; i < n; i++)
+    s += p[i];
+  return s;
+}
+
+/* { dg-final { scan-tree-dump-times "__builtin___asan_loadN" 1 "sanopt" } } */
+/* { dg-final { scan-tree-dump-not "__builtin___asan_report_load4" "sanopt" } } */
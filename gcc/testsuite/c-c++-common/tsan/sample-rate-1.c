@@ -0,0 +1,15 @@
+/* { dg-do compile } */
+/* { dg-require-effective-target tls_native } */
+/* { dg-additional-options "--param tsan-sample-rate=100" } */
+
+int Global;
+
+void
+foo (int i)
+{
+  /* This store is instrumented, but only in sampled invocations.  */
+  Global = i;
+}
+
+/* { dg-final { scan-assembler "__tsan_sample_counter" } } */
+/* { dg-final { scan-assembler "__tsan_write4" } } */
@@ -0,0 +1,30 @@
+/* { dg-shouldfail "tsan" } */
+/* { dg-require-effective-target tls_native } */
+/* { dg-additional-options "--param tsan-sample-rate=1000 -ldl" } */
+
+/* The first invocation of each function on each thread is sampled, so
+   the race is still found.  */
+
+#include <pthread.h>
+#include "tsan_barrier.h"
+
+static pthread_barrier_t barrier;
+int Global;
+
+void *Thread1(void *x) {
+  barrier_wait(&barrier);
+  Global = 42;
+  return x;
+}
+
+int main() {
+  barrier_init(&barrier, 2);
+  pthread_t t;
+  pthread_create(&t, 0, Thread1, 0);
+  Global = 43;
+  barrier_wait(&barrier);
+  pthread_join(t, 0);
+  return Global;
+}
+
+/* { dg-output "WARNING: ThreadSanitizer: data race.*(\n|\r\n|\r)" } */
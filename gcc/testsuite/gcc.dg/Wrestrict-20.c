@@ -0,0 +1,14 @@
+/* Verify that -Wrestrict determines the range of an offset from its
+   definition when VRP has not run.
+   { dg-do compile }
+   { dg-options "-O1 -Wrestrict" } */
+
+typedef __SIZE_TYPE__ size_t;
+
+extern void* memcpy (void* restrict, const void* restrict, size_t);
+
+void f (char *d, size_t n)
+{
+  size_t i = n & 7;
+  memcpy (d, d + i, 32);	/* { dg-warning "overlaps" } */
+}
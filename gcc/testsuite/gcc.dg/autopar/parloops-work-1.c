@@ -0,0 +1,15 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -ftree-parallelize-loops=4 --param parloops-min-per-thread=2 -fopt-info-loop-missed -fdump-tree-optimized" } */
+
+#define N 100
+
+int a[N], b[N];
+
+void
+foo (void)
+{
+  for (int i = 0; i < N; i++) /* { dg-message "estimated work of \[0-9\]+ instructions is too small for 4 threads" } */
+    a[i] = b[i] + 1;
+}
+
+/* { dg-final { scan-tree-dump-times "loopfn" 0 "optimized" } } */
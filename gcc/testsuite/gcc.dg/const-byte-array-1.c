@@ -0,0 +1,41 @@
+/* Verify that initialized arrays of bytes, which are emitted as strings,
+   have the right contents.  */
+/* { dg-do run } */
+/* { dg-options "-O2 -save-temps -fno-asynchronous-unwind-tables" } */
+
+#define S4(x) x, x + 1, x + 2, x + 3
+#define S16(x) S4 (x), S4 (x + 4), S4 (x + 8), S4 (x + 12)
+
+static const unsigned char t[128] =
+{
+  [0 ... 9] = 0x80,
+  S16 (0), S16 (16), S16 (32), S16 (240),
+  '"', '\\', '\n', 0, 0xff,
+  [100] = 7
+};
+
+const unsigned char *volatile p = t;
+
+int
+main (void)
+{
+  int i;
+  for (i = 0; i < 10; i++)
+    if (p[i] != 0x80)
+      __builtin_abort ();
+  for (i = 0; i < 48; i++)
+    if (p[10 + i] != i)
+      __builtin_abort ();
+  for (i = 0; i < 16; i++)
+    if (p[58 + i] != 240 + i)
+      __builtin_abort ();
+  if (p[74] != '"' || p[75] != '\\' || p[76] != '\n' || p[77] != 0
+      || p[78] != 0xff || p[100] != 7)
+    __builtin_abort ();
+  for (i = 79; i < 128; i++)
+    if (i != 100 && p[i] != 0)
+      __builtin_abort ();
+  return 0;
+}
+
+/* { dg-final { scan-assembler-not "\\.byte" { target i?86-*-* x86_64-*-* } } } */
@@ -0,0 +1,19 @@
+/* { dg-do preprocess } */
+/* { dg-options "-M -fdirectives-only" } */
+
+/* Test that -M with -fdirectives-only still evaluates conditionals.  */
+
+#define USE_A 1
+#define PICK(x) x
+
+#if PICK (USE_A)
+#include "dir-only-3a.h"
+#else
+#include "dir-only-3b.h"
+#endif
+
+int not_a_directive = PICK (USE_A);
+
+/* { dg-final { scan-file dir-only-7.i "(^|\\n)dir-only-7.o:" } }
+   { dg-final { scan-file dir-only-7.i "dir-only-3a.h" } }
+   { dg-final { scan-file-not dir-only-7.i "dir-only-3b.h" } } */
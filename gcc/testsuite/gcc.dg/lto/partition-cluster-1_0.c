@@ -0,0 +1,18 @@
+/* { dg-lto-options {{ -O2 -flto -flto-partition=cluster --param lto-partitions=2 --param min-partition-size=1 }} } */
+/* { dg-lto-do run } */
+
+extern int hot (int);
+extern int cold (int);
+void abort (void);
+
+int
+main ()
+{
+  int i, s = 0;
+  for (i = 0; i < 1000; i++)
+    s += hot (i);
+  s += cold (s);
+  if (s != 2 * 499500 + 1)
+    abort ();
+  return 0;
+}
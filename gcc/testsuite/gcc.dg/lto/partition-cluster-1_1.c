@@ -0,0 +1,11 @@
+int
+hot (int x)
+{
+  return 2 * x;
+}
+
+int
+cold (int x)
+{
+  return x ? 1 : 0;
+}
@@ -0,0 +1,19 @@
+/* { dg-options "-O2 -fdump-ipa-profile" } */
+int a[1000];
+int b[1000];
+int max=10000;
+int
+main()
+{
+  int i;
+  for (i=0;i<max; i++)
+    {
+      __builtin_memcpy (a, b, (i % 4 + 1) * sizeof (a[0]));
+      asm("");
+    }
+   return 0;
+}
+/* No single size dominates, but all of them are small.  */
+/* autofdo doesn't support value profiling for now: */
+/* { dg-final-use-not-autofdo { scan-ipa-dump-not "Transformation done: single value" "profile"} } */
+/* { dg-final-use-not-autofdo { scan-ipa-dump "Interval counter range \\\[0,64\\\]: \\\[0:0, 1:0, 2:0, 3:0, 4:2500, 5:0, 6:0, 7:0, 8:2500, " "profile"} } */
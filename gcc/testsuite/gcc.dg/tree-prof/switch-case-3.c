@@ -0,0 +1,36 @@
+/* { dg-options "-O2 -fdump-tree-switchlower1" } */
+int g;
+
+__attribute__((noinline)) void foo (int  n)
+{
+  switch (n)
+    {
+    case 1:
+      g++; break;
+    case 2:
+      g += 2; break;
+    case 3:
+      g += 3; break;
+    case 4:
+      g += 4; break;
+    case 5:
+      g += 5; break;
+    case 6:
+      g += 6; break;
+    case 7:
+      g += 7; break;
+    default:
+      g += 8; break;
+   }
+}
+
+int main ()
+{
+ int i;
+ for (i = 0; i < 10000; i++)
+   foo (i % 20 ? 5 : i % 7);
+ return 0;
+}
+/* Case 5 is taken 95% of the time, so it is tested first.  */
+/* { dg-final-use-not-autofdo { scan-tree-dump-times ";; Peeling case 5 of the switch" 1 "switchlower1"} } */
+/* { dg-final-use-not-autofdo { scan-tree-dump-times ";; Peeling case" 1 "switchlower1"} } */
@@ -0,0 +1,40 @@
+/* { dg-require-ifunc "" } */
+/* { dg-skip-if "" { ! { i?86-*-* x86_64-*-* } } } */
+/* { dg-options "-O3 -ftarget-clones-auto=avx2,avx512f -fdump-ipa-targetclone2" } */
+
+#define N 1024
+
+double a[N], b[N], c[N];
+
+__attribute__((noinline)) void
+add (void)
+{
+  for (int i = 0; i < N; i++)
+    c[i] = a[i] + b[i];
+}
+
+__attribute__((noinline)) void
+init (void)
+{
+  for (int i = 0; i < N; i++)
+    {
+      a[i] = i;
+      b[i] = 2 * i;
+    }
+}
+
+int
+main (void)
+{
+  init ();
+  for (int i = 0; i < 1000; i++)
+    add ();
+  for (int i = 0; i < N; i++)
+    if (c[i] != 3 * i)
+      __builtin_abort ();
+  return 0;
+}
+
+/* main is never cloned.  */
+/* { dg-final-use-not-autofdo { scan-ipa-dump "Cloning add/\[0-9\]+ for targets avx2,avx512f" "targetclone2" } } */
+/* { dg-final-use-not-autofdo { scan-ipa-dump-not "Cloning main" "targetclone2" } } */
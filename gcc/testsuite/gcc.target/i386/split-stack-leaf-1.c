@@ -0,0 +1,22 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -fsplit-stack" } */
+/* { dg-require-effective-target split_stack } */
+
+/* A leaf function with a small frame doesn't check the stack boundary,
+   one with a large frame still does.  */
+
+int
+small (int *p, int n)
+{
+  return p[0] + p[n];
+}
+
+int
+large (int n)
+{
+  volatile int buf[1024];
+  buf[n] = n;
+  return buf[n + 1];
+}
+
+/* { dg-final { scan-assembler-times "call\[ \t\]+_*__morestack" 1 } } */
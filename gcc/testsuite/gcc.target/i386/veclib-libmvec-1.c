@@ -0,0 +1,22 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -ftree-vectorize -fno-math-errno -fveclib=libmvec -msse2 -mno-avx" } */
+
+float a[1024], b[1024];
+double c[1024], d[1024];
+
+void
+foo (void)
+{
+  for (int i = 0; i < 1024; i++)
+    a[i] = __builtin_expf (b[i]);
+}
+
+void
+bar (void)
+{
+  for (int i = 0; i < 1024; i++)
+    c[i] = __builtin_log (d[i]);
+}
+
+/* { dg-final { scan-assembler "_ZGVbN4v_expf" } } */
+/* { dg-final { scan-assembler "_ZGVbN2v_log" } } */
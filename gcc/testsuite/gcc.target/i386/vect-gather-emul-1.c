@@ -0,0 +1,20 @@
+/* { dg-do compile } */
+/* { dg-options "-O3 -msse4.2 -mno-avx -fvect-cost-model=unlimited -fdump-tree-vect-details" } */
+
+void
+dmul (double *restrict c, double *restrict a, int *restrict idx,
+      double *restrict b, int n)
+{
+  for (int i = 0; i < n; i++)
+    c[i] = a[idx[i]] * b[i];
+}
+
+void
+fmul (float *restrict c, float *restrict a, int *restrict idx,
+      float *restrict b, int n)
+{
+  for (int i = 0; i < n; i++)
+    c[i] = a[idx[i]] * b[i];
+}
+
+/* { dg-final { scan-tree-dump-times "vectorized 1 loops" 2 "vect" } } */
@@ -0,0 +1,86 @@
+! { dg-do run }
+! { dg-options "-fcoarray=lib -lcaf_shmem" }
+! { dg-set-target-env-var GFORTRAN_NUM_IMAGES "4" }
+!
+! Check communication between the images of the shared-memory coarray
+! library.
+
+program main
+  use iso_fortran_env, only: atomic_int_kind, event_type, lock_type
+  implicit none
+  type t
+    integer, allocatable :: v(:)
+  end type t
+  integer :: a(10)[*], b, me, n, i, s
+  real(kind=8) :: r(3)
+  integer(atomic_int_kind) :: at[*]
+  type(event_type) :: ev[*]
+  type(lock_type) :: lk[*]
+  integer, allocatable :: c(:)[:]
+  integer, allocatable :: got(:)
+  type(t) :: x[*]
+  integer :: cnt[*]
+
+  me = this_image ()
+  n = num_images ()
+  a = [(me * 100 + i, i = 1, 10)]
+  at = 0
+  cnt = 0
+  allocate (x%v(me))
+  x%v = me
+  sync all
+
+  ! Remote reads and writes.
+  b = a(3)[mod (me, n) + 1]
+  if (b /= mod (me, n) * 100 + 103) stop 1
+  a(1)[mod (me, n) + 1] = -me
+  sync all
+  if (a(1) /= -(mod (me + n - 2, n) + 1)) stop 2
+
+  ! Collectives.
+  s = me
+  call co_sum (s)
+  if (s /= n * (n + 1) / 2) stop 3
+  r = me
+  call co_max (r)
+  if (any (r /= n)) stop 4
+  s = me * 7
+  call co_broadcast (s, min (2, n))
+  if (s /= 7 * min (2, n)) stop 5
+  s = me
+  call co_reduce (s, add)
+  if (s /= n * (n + 1) / 2) stop 6
+
+  ! Atomics, critical sections and locks.
+  call atomic_add (at[1], me)
+  critical
+    cnt[1] = cnt[1] + 1
+  end critical
+  lock (lk[1])
+  cnt[1] = cnt[1] + 1
+  unlock (lk[1])
+  sync all
+  if (me == 1 .and. at /= n * (n + 1) / 2) stop 7
+  if (me == 1 .and. cnt /= 2 * n) stop 8
+
+  ! Allocatable coarrays and allocatable components.
+  allocate (c(5)[*])
+  c = me
+  sync all
+  if (any (c(:)[1] /= 1)) stop 9
+  allocate (got(n))
+  got(:) = x[n]%v
+  if (any (got /= n)) stop 10
+  deallocate (c)
+
+  ! Events.
+  if (me /= 1) event post (ev[1])
+  if (me == 1 .and. n > 1) event wait (ev, until_count=n - 1)
+  sync images (*)
+contains
+  pure function add (p, q)
+    integer, value :: p, q
+    integer :: add
+    add = p + q
+  end function add
+end program main
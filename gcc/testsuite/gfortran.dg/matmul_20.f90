@@ -0,0 +1,45 @@
+! { dg-do run }
+! { dg-options "-finline-matmul-limit=0" }
+! { dg-set-target-env-var GFORTRAN_MATMUL_THREADS "4" }
+! Check MATMUL when the library splits it between threads.
+
+program main
+  implicit none
+  integer, parameter :: m = 300, n = 200, p = 240
+  real(kind=8), dimension(m,n) :: a
+  real(kind=8), dimension(n,p) :: b
+  real(kind=8), dimension(:,:), allocatable :: c
+  real(kind=8), dimension(m,2*p) :: d
+  real(kind=8), dimension(m,p) :: ref
+  integer :: i, j, k
+
+  do j = 1, n
+     do i = 1, m
+        a(i,j) = mod(i + 3*j, 7) - 3
+     end do
+  end do
+  do j = 1, p
+     do i = 1, n
+        b(i,j) = mod(2*i + j, 5) - 2
+     end do
+  end do
+
+  ref = 0
+  do j = 1, p
+     do k = 1, n
+        do i = 1, m
+           ref(i,j) = ref(i,j) + a(i,k) * b(k,j)
+        end do
+     end do
+  end do
+
+  c = matmul (a, b)
+  if (any (c /= ref)) stop 1
+
+  d = -1
+  d(:,1:2*p:2) = matmul (a, b)
+  if (any (d(:,1:2*p:2) /= ref)) stop 2
+  if (any (d(:,2:2*p:2) /= -1)) stop 3
+
+  if (any (matmul (transpose (b), transpose (a)) /= transpose (ref))) stop 4
+end program main
@@ -0,0 +1,43 @@
+! { dg-do run }
+! Check unformatted transfers of whole arrays and of sections whose
+! leading dimensions are contiguous with each other.
+program main
+  implicit none
+  real(kind=8) :: a(50,40,3), b(50,40,3)
+  integer :: c(7,6,5), d(7,6,5), i
+  character(len=3) :: s(4,5), s2(4,5)
+  integer :: n(10)
+
+  a = reshape ([(real (i, kind=8) / 7, i = 1, size (a))], shape (a))
+  c = reshape ([(i, i = 1, size (c))], shape (c))
+  s = 'abc'
+  s(2,3) = 'xyz'
+
+  open (10, status='scratch', form='unformatted')
+  write (10) a, c, s
+  write (10) a(:,:,2:3), a(2:40,:,:), c(:,2:4,:), c(3,:,:)
+  rewind (10)
+
+  b = 0
+  d = 0
+  read (10) b, d, s2
+  if (any (b /= a)) stop 1
+  if (any (d /= c)) stop 2
+  if (any (s2 /= s)) stop 3
+
+  b = 0
+  d = 0
+  read (10) b(:,:,2:3), b(2:40,:,:), d(:,2:4,:), d(3,:,:)
+  if (any (b(2:40,:,:) /= a(2:40,:,:))) stop 4
+  if (any (b(:,:,2:3) /= a(:,:,2:3))) stop 5
+  if (any (d(:,2:4,:) /= c(:,2:4,:))) stop 6
+  if (any (d(3,:,:) /= c(3,:,:))) stop 7
+  close (10)
+
+  ! The record must be the same as if it was written element by element.
+  open (10, status='scratch', form='unformatted', access='stream')
+  write (10) c(:,1:2,1)
+  read (10, pos=1) n
+  if (any (n /= [(i, i = 1, 10)])) stop 8
+  close (10)
+end program main
@@ -88,6 +88,9 @@
 #undef create_code
 #undef verify_code
 
+/* test-compile-in-subprocess.c: We don't use this one, since the option
+   affects the whole context.  */
+
 /* test-compound-assignment.c */
 #define create_code create_code_compound_assignment
 #define verify_code verify_code_compound_assignment
@@ -213,6 +216,9 @@
 #undef create_code
 #undef verify_code
 
+/* test-result-cache.c: We don't use this one, since it creates and
+   removes a cache directory.  */
+
 /* test-string-literal.c */
 #define create_code create_code_string_literal
 #define verify_code verify_code_string_literal
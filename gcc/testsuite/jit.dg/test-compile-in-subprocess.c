@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "libgccjit.h"
+#include "harness.h"
+
+#ifndef LIBGCCJIT_HAVE_gcc_jit_context_set_bool_compile_in_subprocess
+#error LIBGCCJIT_HAVE_gcc_jit_context_set_bool_compile_in_subprocess was not defined
+#endif
+
+void
+create_code (gcc_jit_context *ctxt, void *user_data)
+{
+  gcc_jit_context_set_bool_compile_in_subprocess (ctxt, 1);
+
+  /* Let's try to inject the equivalent of:
+
+      int test_subprocess (int x)
+      {
+        return x * 3;
+      }
+  */
+  gcc_jit_type *int_type =
+    gcc_jit_context_get_type (ctxt, GCC_JIT_TYPE_INT);
+  gcc_jit_param *x =
+    gcc_jit_context_new_param (ctxt, NULL, int_type, "x");
+
+  gcc_jit_function *func =
+    gcc_jit_context_new_function (ctxt, NULL,
+                                  GCC_JIT_FUNCTION_EXPORTED,
+                                  int_type,
+                                  "test_subprocess",
+                                  1, &x,
+                                  0);
+
+  gcc_jit_block *block = gcc_jit_function_new_block (func, NULL);
+  gcc_jit_block_end_with_return (
+    block, NULL,
+    gcc_jit_context_new_binary_op (
+      ctxt, NULL,
+      GCC_JIT_BINARY_OP_MULT, int_type,
+      gcc_jit_param_as_rvalue (x),
+      gcc_jit_context_new_rvalue_from_int (ctxt, int_type, 3)));
+}
+
+void
+verify_code (gcc_jit_context *ctxt, gcc_jit_result *result)
+{
+  typedef int (*fn_type) (int);
+
+  CHECK_NON_NULL (result);
+  fn_type test_subprocess =
+    (fn_type)gcc_jit_result_get_code (result, "test_subprocess");
+  CHECK_NON_NULL (test_subprocess);
+
+  CHECK_VALUE (test_subprocess (14), 42);
+}
@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "libgccjit.h"
+#include "harness.h"
+
+#ifndef LIBGCCJIT_HAVE_RESULT_CACHE
+#error LIBGCCJIT_HAVE_RESULT_CACHE was not defined
+#endif
+
+/* Let's try to inject the equivalent of:
+
+     int test_cache (int x)
+     {
+       return x * FACTOR;
+     }
+*/
+
+static void
+populate (gcc_jit_context *ctxt, int factor)
+{
+  gcc_jit_type *int_type =
+    gcc_jit_context_get_type (ctxt, GCC_JIT_TYPE_INT);
+  gcc_jit_param *x =
+    gcc_jit_context_new_param (ctxt, NULL, int_type, "x");
+
+  gcc_jit_function *func =
+    gcc_jit_context_new_function (ctxt, NULL,
+                                  GCC_JIT_FUNCTION_EXPORTED,
+                                  int_type,
+                                  "test_cache",
+                                  1, &x,
+                                  0);
+
+  gcc_jit_block *block = gcc_jit_function_new_block (func, NULL);
+  gcc_jit_block_end_with_return (
+    block, NULL,
+    gcc_jit_context_new_binary_op (
+      ctxt, NULL,
+      GCC_JIT_BINARY_OP_MULT, int_type,
+      gcc_jit_param_as_rvalue (x),
+      gcc_jit_context_new_rvalue_from_int (ctxt, int_type, factor)));
+}
+
+static void
+verify_test_cache (gcc_jit_result *result, int factor)
+{
+  typedef int (*fn_type) (int);
+
+  CHECK_NON_NULL (result);
+  fn_type test_cache =
+    (fn_type)gcc_jit_result_get_code (result, "test_cache");
+  CHECK_NON_NULL (test_cache);
+
+  CHECK_VALUE (test_cache (14), 14 * factor);
+}
+
+void
+create_code (gcc_jit_context *ctxt, void *user_data)
+{
+  populate (ctxt, 3);
+}
+
+void
+verify_code (gcc_jit_context *ctxt, gcc_jit_result *result)
+{
+  verify_test_cache (result, 3);
+
+  gcc_jit_context *ctxt_a = gcc_jit_context_acquire ();
+  gcc_jit_context *ctxt_b = gcc_jit_context_acquire ();
+  gcc_jit_context *ctxt_c = gcc_jit_context_acquire ();
+  populate (ctxt_a, 3);
+  populate (ctxt_b, 3);
+  populate (ctxt_c, 4);
+
+  /* Identical contexts have the same hash; different code gives a
+     different hash.  */
+  const char *hash_a = gcc_jit_context_get_recording_hash (ctxt_a);
+  const char *hash_b = gcc_jit_context_get_recording_hash (ctxt_b);
+  const char *hash_c = gcc_jit_context_get_recording_hash (ctxt_c);
+  CHECK_NON_NULL (hash_a);
+  CHECK_VALUE (strlen (hash_a), 32);
+  CHECK_STRING_VALUE (hash_a, hash_b);
+  CHECK (strcmp (hash_a, hash_c) != 0);
+
+  /* Compile A into an empty cache, then load B from it.  */
+  char cache_dir[] = "/tmp/libgccjit-result-cache-XXXXXX";
+  CHECK_NON_NULL (mkdtemp (cache_dir));
+  gcc_jit_context_set_result_cache_dir (ctxt_a, cache_dir);
+  gcc_jit_context_set_result_cache_dir (ctxt_b, cache_dir);
+
+  gcc_jit_result *result_a = gcc_jit_context_compile (ctxt_a);
+  CHECK_NO_ERRORS (ctxt_a);
+  verify_test_cache (result_a, 3);
+
+  gcc_jit_result *result_b = gcc_jit_context_compile (ctxt_b);
+  CHECK_NO_ERRORS (ctxt_b);
+  verify_test_cache (result_b, 3);
+
+  gcc_jit_result_release (result_a);
+  gcc_jit_result_release (result_b);
+
+  /* Clean up the cache entry, whichever form it took.  */
+  char path_o[256];
+  char path_so[256];
+  snprintf (path_o, sizeof (path_o), "%s/%s.o", cache_dir, hash_a);
+  snprintf (path_so, sizeof (path_so), "%s/%s.so", cache_dir, hash_a);
+  CHECK (unlink (path_o) == 0 || unlink (path_so) == 0);
+  CHECK_VALUE (rmdir (cache_dir), 0);
+
+  gcc_jit_context_release (ctxt_a);
+  gcc_jit_context_release (ctxt_b);
+  gcc_jit_context_release (ctxt_c);
+}
@@ -23,6 +23,8 @@ along with GCC; see the file COPYING3.  If not see
 #include "coretypes.h"
 #include "timevar.h"
 #include "options.h"
+#include "json.h"
+#include "trace-events.h"
 
 #ifndef HAVE_CLOCK_T
 typedef int clock_t;
@@ -209,6 +211,218 @@ timer::named_items::print (FILE *fp, const timevar_time_def *total)
     }
 }
 
+/* The implementation of per-function timing.  Each execution of a pass
+   on a function is recorded separately, in execution order, so that the
+   profile shows which instance of a pass was expensive.  */
+
+class timer::function_items
+{
+ public:
+  function_items ();
+  ~function_items ();
+
+  void push (unsigned uid, const char *fn_name, const char *pass_name);
+  void pop ();
+  void print (FILE *fp, const timevar_time_def *total);
+  json::array *make_json () const;
+
+ private:
+  /* The time taken by one execution of a pass.  */
+  struct pass_item
+  {
+    const char *name;
+    timevar_time_def elapsed;
+  };
+
+  /* The times recorded for one function.  */
+  struct function_item
+  {
+    char *name;
+    timevar_time_def elapsed;
+    auto_vec <pass_item> passes;
+  };
+
+  /* A pass that is currently executing.  */
+  struct frame
+  {
+    function_item *fn;
+    const char *pass_name;
+    timevar_time_def start;
+  };
+
+  static int compare_wall (const void *, const void *);
+
+  /* Map from DECL_UID to the times for that function.  */
+  hash_map <int_hash <unsigned, -1U, -2U>, function_item *> m_uid_map;
+
+  /* The functions in the order in which they were first seen.  */
+  auto_vec <function_item *> m_functions;
+
+  /* Passes whose execution has not finished yet; passes may nest when
+     one pass runs others, as when IPA transforms are applied.  */
+  auto_vec <frame> m_stack;
+};
+
+/* The constructor for class timer::function_items.  */
+
+timer::function_items::function_items ()
+: m_uid_map (),
+  m_functions (),
+  m_stack ()
+{
+}
+
+/* The destructor for class timer::function_items.  */
+
+timer::function_items::~function_items ()
+{
+  unsigned int i;
+  function_item *fn;
+  FOR_EACH_VEC_ELT (m_functions, i, fn)
+    {
+      free (fn->name);
+      delete fn;
+    }
+}
+
+/* Start timing pass PASS_NAME on the function with DECL_UID UID,
+   whose printable name is FN_NAME.  */
+
+void
+timer::function_items::push (unsigned uid, const char *fn_name,
+			     const char *pass_name)
+{
+  bool existed;
+  function_item *&fn = m_uid_map.get_or_insert (uid, &existed);
+  if (!existed)
+    {
+      fn = new function_item;
+      fn->name = xstrdup (fn_name);
+      memset (&fn->elapsed, 0, sizeof (fn->elapsed));
+      m_functions.safe_push (fn);
+    }
+  frame f;
+  f.fn = fn;
+  f.pass_name = pass_name;
+  get_time (&f.start);
+  m_stack.safe_push (f);
+}
+
+/* Stop timing the innermost pass and record the time it took.  Time
+   spent in passes nested within another pass on the same function is
+   counted only once towards the function's total.  */
+
+void
+timer::function_items::pop ()
+{
+  timevar_time_def now;
+  get_time (&now);
+  frame f = m_stack.pop ();
+
+  pass_item p;
+  p.name = f.pass_name;
+  memset (&p.elapsed, 0, sizeof (p.elapsed));
+  timevar_accumulate (&p.elapsed, &f.start, &now);
+  f.fn->passes.safe_push (p);
+
+  bool nested = false;
+  unsigned int i;
+  frame *outer;
+  FOR_EACH_VEC_ELT (m_stack, i, outer)
+    if (outer->fn == f.fn)
+      nested = true;
+  if (!nested)
+    timevar_accumulate (&f.fn->elapsed, &f.start, &now);
+}
+
+/* qsort comparator sorting functions by decreasing wall time, then by
+   decreasing user time.  */
+
+int
+timer::function_items::compare_wall (const void *pa, const void *pb)
+{
+  const function_item *a = *(const function_item * const *) pa;
+  const function_item *b = *(const function_item * const *) pb;
+  if (a->elapsed.wall != b->elapsed.wall)
+    return a->elapsed.wall < b->elapsed.wall ? 1 : -1;
+  if (a->elapsed.user != b->elapsed.user)
+    return a->elapsed.user < b->elapsed.user ? 1 : -1;
+  return strcmp (a->name, b->name);
+}
+
+/* The number of functions listed in the text report.  */
+
+#define FUNCTION_ITEMS_TO_PRINT 10
+
+/* Print the most expensive functions.  Helper function for timer::print.  */
+
+void
+timer::function_items::print (FILE *fp, const timevar_time_def *total)
+{
+  auto_vec <function_item *> sorted;
+  sorted.safe_splice (m_functions);
+  sorted.qsort (compare_wall);
+
+  fprintf (fp, "Most expensive functions:\n");
+  unsigned int i;
+  function_item *fn;
+  FOR_EACH_VEC_ELT (sorted, i, fn)
+    {
+      if (i == FUNCTION_ITEMS_TO_PRINT || all_zero (fn->elapsed))
+	break;
+      char lname[36];
+      snprintf (lname, sizeof lname, "%s", fn->name);
+      print_row (fp, total, lname, fn->elapsed);
+    }
+}
+
+/* Make a JSON object for the times in ELAPSED.  */
+
+static json::object *
+time_to_json (const timevar_time_def &elapsed)
+{
+  json::object *obj = new json::object ();
+  obj->set ("user", new json::number (elapsed.user));
+  obj->set ("sys", new json::number (elapsed.sys));
+  obj->set ("wall", new json::number (elapsed.wall));
+  obj->set ("ggc_mem", new json::number (elapsed.ggc_mem));
+  return obj;
+}
+
+/* Make a JSON array describing each function, most expensive first,
+   with the passes executed on it in execution order.  */
+
+json::array *
+timer::function_items::make_json () const
+{
+  auto_vec <function_item *> sorted;
+  sorted.safe_splice (m_functions);
+  sorted.qsort (compare_wall);
+
+  json::array *fns = new json::array ();
+  unsigned int i;
+  function_item *fn;
+  FOR_EACH_VEC_ELT (sorted, i, fn)
+    {
+      json::object *fn_obj = new json::object ();
+      fn_obj->set ("name", new json::string (fn->name));
+      fn_obj->set ("time", time_to_json (fn->elapsed));
+      json::array *passes = new json::array ();
+      unsigned int j;
+      pass_item *p;
+      FOR_EACH_VEC_ELT (fn->passes, j, p)
+	{
+	  json::object *pass_obj = new json::object ();
+	  pass_obj->set ("name", new json::string (p->name ? p->name : ""));
+	  pass_obj->set ("time", time_to_json (p->elapsed));
+	  passes->append (pass_obj);
+	}
+      fn_obj->set ("passes", passes);
+      fns->append (fn_obj);
+    }
+  return fns;
+}
+
 /* Fill the current times into TIME.  The definition of this function
    also defines any or all of the HAVE_USER_TIME, HAVE_SYS_TIME, and
    HAVE_WALL_TIME macros.  */
@@ -259,7 +473,8 @@ timer::timer () :
   m_stack (NULL),
   m_unused_stack_instances (NULL),
   m_start_time (),
-  m_jit_client_items (NULL)
+  m_jit_client_items (NULL),
+  m_function_items (NULL)
 {
   /* Zero all elapsed times.  */
   memset (m_timevars, 0, sizeof (m_timevars));
@@ -300,6 +515,7 @@ timer::~timer ()
     delete m_timevars[i].children;
 
   delete m_jit_client_items;
+  delete m_function_items;
 }
 
 /* Initialize timing variables.  */
@@ -370,6 +586,8 @@ timer::push_internal (struct timevar_def *tv)
   context->timevar = tv;
   context->next = m_stack;
   m_stack = context;
+
+  trace_event_begin (tv->name, "timevar");
 }
 
 /* Pop the topmost timing variable element off the timing stack.  The
@@ -404,6 +622,8 @@ timer::pop_internal ()
   /* Take the item off the stack.  */
   m_stack = m_stack->next;
 
+  trace_event_end (popped->timevar->name, "timevar");
+
   /* Record the elapsed sub-time to the parent as well.  */
   if (m_stack && time_report_details)
     {
@@ -578,6 +798,28 @@ timer::pop_client_item ()
   m_jit_client_items->pop ();
 }
 
+/* Start attributing time to pass PASS_NAME running on the function with
+   DECL_UID UID and printable name FN_NAME, independently of the timing
+   stack.  */
+
+void
+timer::push_function_pass (unsigned uid, const char *fn_name,
+			   const char *pass_name)
+{
+  if (!m_function_items)
+    m_function_items = new function_items ();
+  m_function_items->push (uid, fn_name, pass_name);
+}
+
+/* Stop timing the pass most recently passed to push_function_pass.  */
+
+void
+timer::pop_function_pass ()
+{
+  gcc_assert (m_function_items);
+  m_function_items->pop ();
+}
+
 /* Validate that phase times are consistent.  */
 
 void
@@ -764,6 +1006,8 @@ timer::print (FILE *fp)
     }
   if (m_jit_client_items)
     m_jit_client_items->print (fp, total);
+  if (m_function_items)
+    m_function_items->print (fp, total);
 
   /* Print total time.  */
   fprintf (fp, " %-35s:", "TOTAL");
@@ -793,6 +1037,52 @@ timer::print (FILE *fp)
   validate_phases (fp);
 }
 
+/* Write the timing information to FP as JSON: the timing variables with
+   their children, then the per-function times if they were recorded.
+   timer::print must have been called first to account for the time
+   spent so far.  */
+
+void
+timer::print_json (FILE *fp)
+{
+  json::object *root = new json::object ();
+  root->set ("total", time_to_json (m_timevars[TV_TOTAL].elapsed));
+
+  json::array *timevars = new json::array ();
+  for (unsigned int id = 0; id < (unsigned int) TIMEVAR_LAST; ++id)
+    {
+      const timevar_def *tv = &m_timevars[(timevar_id_t) id];
+      if ((timevar_id_t) id == TV_TOTAL || !tv->used)
+	continue;
+
+      json::object *tv_obj = new json::object ();
+      tv_obj->set ("name", new json::string (tv->name));
+      tv_obj->set ("time", time_to_json (tv->elapsed));
+      if (tv->children)
+	{
+	  json::array *children = new json::array ();
+	  for (child_map_t::iterator i = tv->children->begin ();
+	       i != tv->children->end (); ++i)
+	    {
+	      json::object *child = new json::object ();
+	      child->set ("name", new json::string ((*i).first->name));
+	      child->set ("time", time_to_json ((*i).second));
+	      children->append (child);
+	    }
+	  tv_obj->set ("children", children);
+	}
+      timevars->append (tv_obj);
+    }
+  root->set ("timevars", timevars);
+
+  if (m_function_items)
+    root->set ("functions", m_function_items->make_json ());
+
+  root->dump (fp);
+  fputc ('\n', fp);
+  delete root;
+}
+
 /* Get the name of the topmost item.  For use by jit for validating
    inputs to gcc_jit_timer_pop.  */
 const char *
@@ -118,7 +118,12 @@ class timer
   void push_client_item (const char *item_name);
   void pop_client_item ();
 
+  void push_function_pass (unsigned uid, const char *fn_name,
+			   const char *pass_name);
+  void pop_function_pass ();
+
   void print (FILE *fp);
+  void print_json (FILE *fp);
 
   const char *get_topmost_item_name () const;
 
@@ -179,6 +184,10 @@ class timer
      from needing vec and hash_map.  */
   class named_items;
 
+  /* Likewise, a class for recording the time spent by each pass on each
+     function, for -ftime-report-json.  */
+  class function_items;
+
  private:
 
   /* Data members (all private).  */
@@ -202,7 +211,11 @@ class timer
   /* If non-NULL, for use when timing libgccjit's client code.  */
   named_items *m_jit_client_items;
 
+  /* If non-NULL, the per-function times recorded so far.  */
+  function_items *m_function_items;
+
   friend class named_items;
+  friend class function_items;
 };
 
 /* Provided for backward compatibility.  */
@@ -85,6 +85,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "ipa-fnsummary.h"
 #include "dump-context.h"
 #include "optinfo-emit-json.h"
+#include "trace-events.h"
 
 #if defined(DBX_DEBUGGING_INFO) || defined(XCOFF_DEBUGGING_INFO)
 #include "dbxout.h"
@@ -2009,6 +2010,7 @@ dump_memory_report (bool final)
   dump_ggc_loc_statistics (final);
   dump_alias_stats (stderr);
   dump_pta_stats (stderr);
+  dump_pass_memory_report ();
 }
 
 /* Clean up: close opened files, etc.  */
@@ -2065,6 +2067,9 @@ finalize (bool no_backend)
 
   /* Language-specific end of compilation actions.  */
   lang_hooks.finish ();
+
+  /* Wait for any compressed dumps to be written out.  */
+  g->get_dumps ()->finish_compressed_dumps ();
 }
 
 static bool
@@ -2193,7 +2198,23 @@ toplev::~toplev ()
   if (g_timer && m_use_TV_TOTAL)
     {
       g_timer->stop (TV_TOTAL);
-      g_timer->print (stderr);
+      if (time_report || time_report_json || !quiet_flag
+	  || flag_detailed_statistics)
+	g_timer->print (stderr);
+      if (time_report_json)
+	{
+	  char *filename = concat (dump_base_name, ".time.json", NULL);
+	  FILE *fp = fopen (filename, "w");
+	  if (fp)
+	    {
+	      g_timer->print_json (fp);
+	      fclose (fp);
+	    }
+	  else
+	    fnotice (stderr, "cannot open %s for writing the time report\n",
+		     filename);
+	  free (filename);
+	}
       delete g_timer;
       g_timer = NULL;
     }
@@ -2205,7 +2226,17 @@ toplev::~toplev ()
 void
 toplev::start_timevars ()
 {
-  if (time_report || !quiet_flag  || flag_detailed_statistics)
+  /* With -ftrace-events, or when run by a driver given it, name the
+     process after the file it compiles, which for LTRANS includes the
+     number of the partition.  */
+  char *name = concat (progname,
+		       flag_wpa ? " (WPA) " : flag_ltrans ? " (LTRANS) " : " ",
+		       main_input_filename ? main_input_filename : "", NULL);
+  trace_events_init (flag_trace_events, name);
+  free (name);
+
+  if (time_report || time_report_json || !quiet_flag
+      || flag_detailed_statistics || trace_events_enabled_p ())
     timevar_init ();
 
   timevar_start (TV_TOTAL);
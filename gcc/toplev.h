@@ -68,6 +68,7 @@ extern void global_decl_processing (void);
 
 extern void dump_memory_report (bool);
 extern void dump_profile_report (void);
+extern void dump_pass_memory_report (void);
 
 extern void target_reinit (void);
 
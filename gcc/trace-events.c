@@ -0,0 +1,271 @@
+/* Event tracing in the Chrome trace event format.
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#include "config.h"
+#include "system.h"
+#include "trace-events.h"
+
+/* The events of all the processes of a compilation go to one file,
+   opened for appending, and each event is written with a single write
+   so that the events of concurrent processes don't get mixed up.  The
+   closing ']' of the JSON array is optional in the trace event format,
+   and is never written, as there is no telling which process writes
+   the last event.  */
+
+#define TRACE_EVENTS_ENV "GCC_TRACE_EVENTS"
+
+/* Events longer than this have their strings truncated.  */
+#define TRACE_EVENT_MAX 4096
+
+static int trace_fd = -1;
+static long trace_pid;
+
+/* An event being built up.  */
+
+struct trace_buffer
+{
+  char data[TRACE_EVENT_MAX];
+  size_t len;
+};
+
+/* Room kept at the end of the buffer for closing the event.  */
+#define TRACE_EVENT_TAIL 8
+
+static void
+trace_append (trace_buffer *buf, const char *s)
+{
+  size_t n = strlen (s);
+  if (n > sizeof (buf->data) - TRACE_EVENT_TAIL - buf->len)
+    n = sizeof (buf->data) - TRACE_EVENT_TAIL - buf->len;
+  memcpy (buf->data + buf->len, s, n);
+  buf->len += n;
+}
+
+/* Append S as a JSON string.  */
+
+static void
+trace_append_string (trace_buffer *buf, const char *s)
+{
+  const size_t limit = sizeof (buf->data) - TRACE_EVENT_TAIL - 2;
+
+  buf->data[buf->len++] = '"';
+  for (; *s && buf->len < limit; s++)
+    {
+      unsigned char c = *s;
+      if (c == '"' || c == '\\')
+	{
+	  buf->data[buf->len++] = '\\';
+	  buf->data[buf->len++] = c;
+	}
+      else if (c < ' ')
+	buf->data[buf->len++] = ' ';
+      else
+	buf->data[buf->len++] = c;
+    }
+  buf->data[buf->len++] = '"';
+}
+
+/* Start an event of phase PH called NAME on TRACK at time TS.  */
+
+static void
+trace_event_start (trace_buffer *buf, const char *ph, const char *name,
+		   const char *category, enum trace_track track, uint64_t ts)
+{
+  char num[64];
+
+  buf->len = 0;
+  trace_append (buf, "{\"name\":");
+  trace_append_string (buf, name);
+  if (category)
+    {
+      trace_append (buf, ",\"cat\":");
+      trace_append_string (buf, category);
+    }
+  snprintf (num, sizeof (num),
+	    ",\"ph\":\"%s\",\"ts\":%" PRIu64 ",\"pid\":%ld,\"tid\":%d",
+	    ph, ts, trace_pid, (int) track);
+  trace_append (buf, num);
+}
+
+/* Append the argument ARG_NAME with value ARG_VALUE.  */
+
+static void
+trace_event_arg (trace_buffer *buf, const char *arg_name,
+		 const char *arg_value)
+{
+  trace_append (buf, ",\"args\":{");
+  trace_append_string (buf, arg_name);
+  trace_append (buf, ":");
+  trace_append_string (buf, arg_value);
+  trace_append (buf, "}");
+}
+
+/* Finish the event and write it out.  */
+
+static void
+trace_event_write (trace_buffer *buf)
+{
+  memcpy (buf->data + buf->len, "},\n", 3);
+  buf->len += 3;
+  if (write (trace_fd, buf->data, buf->len) != (ssize_t) buf->len)
+    {
+      /* Give up rather than write partial events.  */
+      close (trace_fd);
+      trace_fd = -1;
+    }
+}
+
+/* Write the metadata event naming TRACK, or the process if TRACK is
+   zero, NAME.  */
+
+static void
+trace_event_name (int track, const char *name)
+{
+  trace_buffer buf;
+  char num[64];
+
+  buf.len = 0;
+  trace_append (&buf, track ? "{\"name\":\"thread_name\""
+		: "{\"name\":\"process_name\"");
+  snprintf (num, sizeof (num), ",\"ph\":\"M\",\"pid\":%ld,\"tid\":%d",
+	    trace_pid, track);
+  trace_append (&buf, num);
+  trace_event_arg (&buf, "name", name);
+  trace_event_write (&buf);
+}
+
+/* Start tracing the events of this process, called PROCESS_NAME in the
+   trace.  If this process was started by a traced one, the events are
+   appended to its trace file.  Otherwise, if FILENAME is not NULL, a
+   new trace is started in FILENAME, and any processes started by this
+   one will add to it.  */
+
+void
+trace_events_init (const char *filename, const char *process_name)
+{
+  const char *inherited = getenv (TRACE_EVENTS_ENV);
+  bool start = false;
+
+  if (trace_fd >= 0)
+    return;
+  if (inherited && *inherited)
+    filename = inherited;
+  else if (filename && *filename)
+    start = true;
+  else
+    return;
+
+  trace_fd = open (filename,
+		   O_WRONLY | O_CREAT | O_APPEND | (start ? O_TRUNC : 0),
+		   0666);
+  if (trace_fd < 0)
+    {
+      fprintf (stderr, "cannot open %s for writing trace events: %s\n",
+	       filename, xstrerror (errno));
+      return;
+    }
+  if (start)
+    {
+      if (write (trace_fd, "[\n", 2) != 2)
+	{
+	  close (trace_fd);
+	  trace_fd = -1;
+	  return;
+	}
+      putenv (concat (TRACE_EVENTS_ENV, "=", filename, NULL));
+    }
+
+  trace_pid = (long) getpid ();
+  trace_event_name (0, process_name);
+  trace_event_name (TRACE_TRACK_MAIN, "main");
+  trace_event_name (TRACE_TRACK_PASSES, "passes");
+}
+
+/* Return true if events are being traced.  */
+
+bool
+trace_events_enabled_p (void)
+{
+  return trace_fd >= 0;
+}
+
+/* Return the current time in microseconds.  The clock is shared
+   between processes, so that their events line up.  */
+
+uint64_t
+trace_events_now (void)
+{
+#ifdef HAVE_GETTIMEOFDAY
+  struct timeval tv;
+  gettimeofday (&tv, NULL);
+  return (uint64_t) tv.tv_sec * 1000000 + tv.tv_usec;
+#else
+  return (uint64_t) time (NULL) * 1000000;
+#endif
+}
+
+/* Record the start of NAME on the main track.  */
+
+void
+trace_event_begin (const char *name, const char *category)
+{
+  trace_buffer buf;
+
+  if (trace_fd < 0)
+    return;
+  trace_event_start (&buf, "B", name, category, TRACE_TRACK_MAIN,
+		     trace_events_now ());
+  trace_event_write (&buf);
+}
+
+/* Record the end of NAME on the main track.  */
+
+void
+trace_event_end (const char *name, const char *category)
+{
+  trace_buffer buf;
+
+  if (trace_fd < 0)
+    return;
+  trace_event_start (&buf, "E", name, category, TRACE_TRACK_MAIN,
+		     trace_events_now ());
+  trace_event_write (&buf);
+}
+
+/* Record that NAME ran on TRACK from START until now, with the argument
+   ARG_NAME set to ARG_VALUE if ARG_NAME is not NULL.  */
+
+void
+trace_event_complete (enum trace_track track, const char *name,
+		      const char *category, uint64_t start,
+		      const char *arg_name, const char *arg_value)
+{
+  trace_buffer buf;
+  char num[64];
+
+  if (trace_fd < 0)
+    return;
+  trace_event_start (&buf, "X", name, category, track, start);
+  snprintf (num, sizeof (num), ",\"dur\":%" PRIu64,
+	    trace_events_now () - start);
+  trace_append (&buf, num);
+  if (arg_name)
+    trace_event_arg (&buf, arg_name, arg_value);
+  trace_event_write (&buf);
+}
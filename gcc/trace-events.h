@@ -0,0 +1,50 @@
+/* Event tracing in the Chrome trace event format.
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#ifndef GCC_TRACE_EVENTS_H
+#define GCC_TRACE_EVENTS_H
+
+/* With -ftrace-events=FILE, the driver and every process it starts,
+   directly or through collect2 and lto-wrapper, append events to FILE
+   in the JSON array form of the Chrome trace event format, which
+   chrome://tracing and Perfetto can display as a single timeline.  The
+   driver passes the file name down in the GCC_TRACE_EVENTS environment
+   variable.  Each process is a "pid" in the trace, and its events are
+   split over the tracks (Chrome "threads") below.  */
+
+enum trace_track
+{
+  /* Subprocesses run, and timevars.  */
+  TRACE_TRACK_MAIN = 1,
+  /* Passes run on each function.  */
+  TRACE_TRACK_PASSES = 2
+};
+
+extern void trace_events_init (const char *filename,
+			       const char *process_name);
+extern bool trace_events_enabled_p (void);
+extern uint64_t trace_events_now (void);
+extern void trace_event_begin (const char *name, const char *category);
+extern void trace_event_end (const char *name, const char *category);
+extern void trace_event_complete (enum trace_track track, const char *name,
+				  const char *category, uint64_t start,
+				  const char *arg_name = NULL,
+				  const char *arg_value = NULL);
+
+#endif /* GCC_TRACE_EVENTS_H */
@@ -60,6 +60,8 @@ along with GCC; see the file COPYING3.  If not see
 #include "tree-dfa.h"
 #include "stringpool.h"
 #include "attribs.h"
+#include "tree-inline.h"
+#include "sreal.h"
 
 /* This pass tries to distribute iterations of loops into several threads.
    The implementation is straightforward -- for each loop we test whether its
@@ -892,6 +894,10 @@ parloops_force_simple_reduction (loop_vec_info loop_info, stmt_vec_info phi_info
    thread.  */
 #define MIN_PER_THREAD PARAM_VALUE (PARAM_PARLOOPS_MIN_PER_THREAD)
 
+/* Minimal estimated amount of work, in instructions, that should be
+   executed in each thread.  */
+#define MIN_WORK_PER_THREAD PARAM_VALUE (PARAM_PARLOOPS_MIN_WORK_PER_THREAD)
+
 /* Element of the hashtable, representing a
    reduction in the current loop.  */
 struct reduction_info
@@ -3986,6 +3992,34 @@ oacc_entry_exit_ok (class loop *loop,
   return res;
 }
 
+/* Return an estimate of the number of instructions executed by one
+   iteration of LOOP, including the iterations of its inner loops.  The
+   statements of each block are weighted by the execution count of the
+   block relative to that of the loop header.  */
+
+static sreal
+loop_work_per_iteration (class loop *loop)
+{
+  basic_block *bbs = get_loop_body (loop);
+  profile_count header_count = loop->header->count;
+  sreal work = 0;
+
+  for (unsigned i = 0; i < loop->num_nodes; i++)
+    {
+      int bb_work = 0;
+      for (gimple_stmt_iterator gsi = gsi_start_bb (bbs[i]);
+	   !gsi_end_p (gsi); gsi_next (&gsi))
+	bb_work += estimate_num_insns (gsi_stmt (gsi), &eni_time_weights);
+
+      bool known;
+      sreal scale = bbs[i]->count.to_sreal_scale (header_count, &known);
+      work += known ? scale * bb_work : bb_work;
+    }
+
+  free (bbs);
+  return work;
+}
+
 /* Detect parallel loops and generate parallel code using libgomp
    primitives.  Returns true if some loop was parallelized, false
    otherwise.  */
@@ -4098,7 +4132,33 @@ parallelize_loops (bool oacc_kernels_p)
 		      * (loop->inner ? 2 : MIN_PER_THREAD) - 1)))
 	      /* Do not bother with loops in cold areas.  */
 	      || optimize_loop_nest_for_size_p (loop)))
-	continue;
+	{
+	  if (dump_enabled_p ())
+	    dump_printf_loc (MSG_MISSED_OPTIMIZATION, find_loop_location (loop),
+			     "not parallelizing loop %d: too few iterations"
+			     " or cold\n", loop->num);
+	  continue;
+	}
+
+      /* Starting the threads and distributing the iterations has a cost
+	 that only pays off if each thread gets enough work.  */
+      if (!flag_loop_parallelize_all
+	  && !oacc_kernels_p
+	  && estimated != -1)
+	{
+	  sreal work = loop_work_per_iteration (loop) * (estimated + 1);
+	  if (work < (sreal) n_threads * MIN_WORK_PER_THREAD)
+	    {
+	      if (dump_enabled_p ())
+		dump_printf_loc (MSG_MISSED_OPTIMIZATION,
+				 find_loop_location (loop),
+				 "not parallelizing loop %d: estimated work"
+				 " of %wd instructions is too small for %u"
+				 " threads\n", loop->num, work.to_int (),
+				 n_threads);
+	      continue;
+	    }
+	}
 
       if (!try_get_loop_niter (loop, &niter_desc))
 	continue;
@@ -4111,7 +4171,13 @@ parallelize_loops (bool oacc_kernels_p)
 
       if (!loop->can_be_parallel
 	  && !loop_parallel_p (loop, &parloop_obstack))
-	continue;
+	{
+	  if (dump_enabled_p ())
+	    dump_printf_loc (MSG_MISSED_OPTIMIZATION, find_loop_location (loop),
+			     "not parallelizing loop %d: possible data"
+			     " dependences\n", loop->num);
+	  continue;
+	}
 
       if (oacc_kernels_p
 	&& !oacc_entry_exit_ok (loop, &reduction_list))
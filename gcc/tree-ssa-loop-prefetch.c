@@ -49,6 +49,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "tree-data-ref.h"
 #include "diagnostic-core.h"
 #include "dbgcnt.h"
+#include "sreal.h"
 
 /* This pass inserts prefetch instructions to optimize cache usage during
    accesses to arrays in loops.  It processes loops sequentially and:
@@ -1878,6 +1879,42 @@ insn_to_prefetch_ratio_too_small_p (unsigned ninsns, unsigned prefetch_count,
 /* Issue prefetch instructions for array references in LOOP.  Returns
    true if the LOOP was unrolled.  */
 
+/* Returns the estimated time of one iteration of LOOP.  With a profile
+   read from feedback, the time of each block is weighted by its measured
+   execution count relative to the loop header, so that rarely executed
+   paths do not increase the prefetch distance, and inner loops are
+   accounted for by their real trip counts.  */
+
+static unsigned
+loop_iteration_time (class loop *loop)
+{
+  unsigned time = tree_num_loop_insns (loop, &eni_time_weights);
+  if (time == 0
+      || profile_status_for_fn (cfun) != PROFILE_READ
+      || !loop->header->count.ipa ().nonzero_p ())
+    return time;
+
+  basic_block *body = get_loop_body (loop);
+  sreal weighted = 0;
+  for (unsigned i = 0; i < loop->num_nodes; i++)
+    {
+      unsigned bb_time = 0;
+      for (gimple_stmt_iterator gsi = gsi_start_bb (body[i]);
+	   !gsi_end_p (gsi); gsi_next (&gsi))
+	bb_time += estimate_num_insns (gsi_stmt (gsi), &eni_time_weights);
+      weighted += body[i]->count.to_sreal_scale (loop->header->count)
+		  * bb_time;
+    }
+  free (body);
+
+  if (dump_file && (dump_flags & TDF_DETAILS))
+    fprintf (dump_file, "  time %u, weighted by profile %f\n", time,
+	     weighted.to_double ());
+  if (weighted > INT_MAX)
+    return INT_MAX;
+  return MAX (weighted.to_int (), 1);
+}
+
 static bool
 loop_prefetch_arrays (class loop *loop)
 {
@@ -1896,9 +1933,7 @@ loop_prefetch_arrays (class loop *loop)
       return false;
     }
 
-  /* FIXME: the time should be weighted by the probabilities of the blocks in
-     the loop body.  */
-  time = tree_num_loop_insns (loop, &eni_time_weights);
+  time = loop_iteration_time (loop);
   if (time == 0)
     return false;
 
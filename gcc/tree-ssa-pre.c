@@ -4148,8 +4148,11 @@ public:
   {}
 
   /* opt_pass methods: */
-  virtual bool gate (function *)
-    { return flag_tree_pre != 0 || flag_code_hoisting != 0; }
+  virtual bool gate (function *fun)
+    {
+      return ((flag_tree_pre != 0 || flag_code_hoisting != 0)
+	      && !fun->compile_budget_exceeded);
+    }
   virtual unsigned int execute (function *);
 
 }; // class pass_pre
@@ -4197,7 +4200,15 @@ pass_pre::execute (function *fun)
   scev_initialize ();
   calculate_dominance_info (CDI_DOMINATORS);
 
-  run_rpo_vn (VN_WALK);
+  /* Optimistic value-numbering iterates over cycles which on huge
+     functions with many loops makes its compile-time super-linear.
+     Fall back to the linear non-iterating mode for those.  */
+  bool iterate_p = (n_basic_blocks_for_fn (fun)
+		    < PARAM_VALUE (PARAM_RPO_VN_MAX_ITERATE_BLOCKS));
+  if (!iterate_p && dump_file && (dump_flags & TDF_DETAILS))
+    fprintf (dump_file, "Function has %d basic blocks, using "
+	     "non-iterating value-numbering\n", n_basic_blocks_for_fn (fun));
+  run_rpo_vn (VN_WALK, iterate_p);
 
   init_pre ();
 
@@ -4209,12 +4220,16 @@ pass_pre::execute (function *fun)
      bb's.  If we aren't going to run insert, there is no point in
      computing ANTIC, either, even though it's plenty fast nor do
      we require AVAIL.  */
-  if (n_basic_blocks_for_fn (fun) < 4000)
+  if (n_basic_blocks_for_fn (fun) < PARAM_VALUE (PARAM_MAX_PRE_BASIC_BLOCKS))
     {
       compute_avail ();
       compute_antic ();
       insert ();
     }
+  else if (dump_enabled_p ())
+    dump_printf (MSG_MISSED_OPTIMIZATION,
+		 "not performing PRE insertion: function has %d basic "
+		 "blocks\n", n_basic_blocks_for_fn (fun));
 
   /* Make sure to remove fake edges before committing our inserts.
      This makes sure we don't end up with extra critical edges that
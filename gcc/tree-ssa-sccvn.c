@@ -68,6 +68,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "dbgcnt.h"
 #include "tree-cfgcleanup.h"
 #include "tree-ssa-loop.h"
+#include "swiss-table.h"
 #include "tree-scalar-evolution.h"
 #include "tree-ssa-loop-niter.h"
 #include "builtins.h"
@@ -161,7 +162,7 @@ vn_nary_op_hasher::equal (const vn_nary_op_s *vno1, const vn_nary_op_s *vno2)
   return vno1 == vno2 || vn_nary_op_eq (vno1, vno2);
 }
 
-typedef hash_table<vn_nary_op_hasher> vn_nary_op_table_type;
+typedef swiss_hash_table<vn_nary_op_hasher> vn_nary_op_table_type;
 typedef vn_nary_op_table_type::iterator vn_nary_op_iterator_type;
 
 
@@ -192,7 +193,7 @@ vn_phi_hasher::equal (const vn_phi_s *vp1, const vn_phi_s *vp2)
   return vp1 == vp2 || vn_phi_eq (vp1, vp2);
 }
 
-typedef hash_table<vn_phi_hasher> vn_phi_table_type;
+typedef swiss_hash_table<vn_phi_hasher> vn_phi_table_type;
 typedef vn_phi_table_type::iterator vn_phi_iterator_type;
 
 
@@ -247,7 +248,7 @@ vn_reference_hasher::equal (const vn_reference_s *v, const vn_reference_s *c)
   return v == c || vn_reference_eq (v, c);
 }
 
-typedef hash_table<vn_reference_hasher> vn_reference_table_type;
+typedef swiss_hash_table<vn_reference_hasher> vn_reference_table_type;
 typedef vn_reference_table_type::iterator vn_reference_iterator_type;
 
 
@@ -6092,10 +6093,10 @@ do_rpo_vn (function *fn, edge entry, bitmap exit_bbs,
 	   bool iterate, bool eliminate);
 
 void
-run_rpo_vn (vn_lookup_kind kind)
+run_rpo_vn (vn_lookup_kind kind, bool iterate)
 {
   default_vn_walk_kind = kind;
-  do_rpo_vn (cfun, NULL, NULL, true, false);
+  do_rpo_vn (cfun, NULL, NULL, iterate, false);
 
   /* ???  Prune requirement of these.  */
   constant_to_value_id = new hash_table<vn_constant_hasher> (23);
@@ -276,7 +276,7 @@ tree fully_constant_vn_reference_p (vn_reference_t);
 tree vn_nary_simplify (vn_nary_op_t);
 
 unsigned do_rpo_vn (function *, edge, bitmap);
-void run_rpo_vn (vn_lookup_kind);
+void run_rpo_vn (vn_lookup_kind, bool = true);
 unsigned eliminate_with_rpo_vn (bitmap);
 void free_rpo_vn (void);
 
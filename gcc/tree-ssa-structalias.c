@@ -2763,18 +2763,20 @@ solve_graph (constraint_graph_t graph)
 		      && bitmap_bit_p (vi->oldsolution, anything_id))
 		    continue;
 		  bitmap_copy (pts, get_varinfo (find (anything_id))->solution);
+		  if (vi->oldsolution)
+		    bitmap_ior_into (vi->oldsolution, pts);
 		}
 	      else if (vi->oldsolution)
-		bitmap_and_compl (pts, vi->solution, vi->oldsolution);
+		/* Compute the new bits and add them to the old solution
+		   in one go.  */
+		bitmap_ior_into_delta (vi->oldsolution, vi->solution, pts);
 	      else
 		bitmap_copy (pts, vi->solution);
 
 	      if (bitmap_empty_p (pts))
 		continue;
 
-	      if (vi->oldsolution)
-		bitmap_ior_into (vi->oldsolution, pts);
-	      else
+	      if (!vi->oldsolution)
 		{
 		  vi->oldsolution = BITMAP_ALLOC (&oldpta_obstack);
 		  bitmap_copy (vi->oldsolution, pts);
@@ -7276,6 +7278,11 @@ solve_constraints (void)
     }
   free (map);
 
+  /* Account the offline simplification of the constraint graph and
+     its solving separately from the constraint generation done by our
+     callers.  */
+  timevar_push (TV_PTA_GRAPH);
+
   if (dump_file)
     fprintf (dump_file,
 	     "\nCollapsing static cycles and doing variable "
@@ -7325,10 +7332,14 @@ solve_constraints (void)
       fprintf (dump_file, "\n\n");
     }
 
+  timevar_pop (TV_PTA_GRAPH);
+
   if (dump_file)
     fprintf (dump_file, "Solving graph\n");
 
+  timevar_push (TV_PTA_SOLVE);
   solve_graph (graph);
+  timevar_pop (TV_PTA_SOLVE);
 
   if (dump_file && (dump_flags & TDF_GRAPH))
     {
@@ -2440,6 +2440,122 @@ make_pass_convert_switch (gcc::context *ctxt)
   return new pass_convert_switch (ctxt);
 }
 
+/* If profile feedback says that one case of switch statement SWTCH is
+   taken at least PARAM_SWITCH_PEEL_PROBABILITY percent of the time,
+   test for it with a comparison in front of the switch, so that the
+   common path is a single well predicted branch rather than a walk of
+   a decision tree or an indirect jump.  Repeat for the rest of the
+   switch.  Only cases for a single value that have an edge of their
+   own are peeled.  Return true if any case was peeled.  */
+
+static bool
+peel_hot_switch_cases (gswitch *swtch)
+{
+  tree index = gimple_switch_index (swtch);
+  bool peeled = false;
+
+  if (profile_status_for_fn (cfun) != PROFILE_READ
+      || !optimize_bb_for_speed_p (gimple_bb (swtch)))
+    return false;
+
+  /* Leave at least two cases besides the default one in the switch.  */
+  while (gimple_switch_num_labels (swtch) > 3)
+    {
+      basic_block bb = gimple_bb (swtch);
+      unsigned l = gimple_switch_num_labels (swtch);
+      unsigned best = 0;
+
+      switch_decision_tree::reset_out_edges_aux (swtch);
+      for (unsigned i = 1; i < l; i++)
+	{
+	  edge case_edge = gimple_switch_edge (cfun, swtch, i);
+	  case_edge->aux = (void *) ((intptr_t) (case_edge->aux) + 1);
+	}
+      for (unsigned i = 1; i < l; i++)
+	{
+	  tree elt = gimple_switch_label (swtch, i);
+	  edge case_edge = gimple_switch_edge (cfun, swtch, i);
+	  if ((CASE_HIGH (elt)
+	       && !tree_int_cst_equal (CASE_LOW (elt), CASE_HIGH (elt)))
+	      || (intptr_t) (case_edge->aux) != 1
+	      || !case_edge->probability.reliable_p ())
+	    continue;
+	  if (!best
+	      || gimple_switch_edge (cfun, swtch, best)->probability
+		 < case_edge->probability)
+	    best = i;
+	}
+      switch_decision_tree::reset_out_edges_aux (swtch);
+
+      if (!best)
+	break;
+      edge hot = gimple_switch_edge (cfun, swtch, best);
+      profile_probability prob = hot->probability;
+      if (prob.to_reg_br_prob_base ()
+	  < REG_BR_PROB_BASE * PARAM_VALUE (PARAM_SWITCH_PEEL_PROBABILITY) / 100)
+	break;
+
+      tree value = fold_convert (TREE_TYPE (index),
+				 CASE_LOW (gimple_switch_label (swtch, best)));
+      if (dump_file)
+	{
+	  fprintf (dump_file, ";; Peeling case ");
+	  print_generic_expr (dump_file, value);
+	  fprintf (dump_file, " of the switch, taken with probability ");
+	  prob.dump (dump_file);
+	  fprintf (dump_file, "\n");
+	}
+
+      /* Move the switch into a block of its own, and end BB with the
+	 comparison instead.  */
+      gimple_stmt_iterator gsi = gsi_last_bb (bb);
+      edge e;
+      gsi_prev (&gsi);
+      if (gsi_end_p (gsi))
+	e = split_block_after_labels (bb);
+      else
+	e = split_block (bb, gsi_stmt (gsi));
+      basic_block switch_bb = e->dest;
+
+      gcond *cond = gimple_build_cond (EQ_EXPR, index, value,
+				       NULL_TREE, NULL_TREE);
+      gimple_set_location (cond, gimple_location (swtch));
+      gsi = gsi_last_bb (bb);
+      gsi_insert_after (&gsi, cond, GSI_NEW_STMT);
+
+      edge hot_edge = make_edge (bb, hot->dest, EDGE_TRUE_VALUE);
+      e->flags = (e->flags & ~EDGE_FALLTHRU) | EDGE_FALSE_VALUE;
+      hot_edge->probability = prob;
+      e->probability = prob.invert ();
+      switch_bb->count = bb->count.apply_probability (e->probability);
+
+      /* The new edge passes the same values to PHIs as the case did.  */
+      for (gphi_iterator gpi = gsi_start_phis (hot->dest);
+	   !gsi_end_p (gpi); gsi_next (&gpi))
+	{
+	  gphi *phi = gpi.phi ();
+	  add_phi_arg (phi, PHI_ARG_DEF_FROM_EDGE (phi, hot), hot_edge,
+		       gimple_phi_arg_location_from_edge (phi, hot));
+	}
+
+      /* Drop the case from the switch.  It was the only label for its
+	 edge.  */
+      for (unsigned i = best; i + 1 < l; i++)
+	gimple_switch_set_label (swtch, i, gimple_switch_label (swtch, i + 1));
+      gimple_switch_set_num_labels (swtch, l - 1);
+      remove_edge (hot);
+
+      edge_iterator ei;
+      edge se;
+      FOR_EACH_EDGE (se, ei, switch_bb->succs)
+	se->probability = se->probability / e->probability;
+
+      peeled = true;
+    }
+
+  return peeled;
+}
+
 /* The main function of the pass scans statements for switches and invokes
    process_switch on them.  */
 
@@ -2518,6 +2634,9 @@ pass_lower_switch<O0>::execute (function *fun)
       gswitch *swtch = dyn_cast<gswitch *> (stmt);
       if (swtch)
 	{
+	  if (!O0)
+	    expanded |= peel_hot_switch_cases (swtch);
+
 	  switch_decision_tree dt (swtch);
 	  expanded |= dt.analyze_switch_statement ();
 	}
@@ -3727,7 +3727,10 @@ vect_describe_gather_scatter_call (stmt_vec_info stmt_info,
 }
 
 /* Return true if a non-affine read or write in STMT_INFO is suitable for a
-   gather load or scatter store.  Describe the operation in *INFO if so.  */
+   gather load or scatter store.  Describe the operation in *INFO if so.
+   If the target has no suitable gather instruction, an unconditional
+   read can still be emulated using scalar loads; this is indicated by
+   both INFO->ifn being IFN_LAST and INFO->decl being null.  */
 
 bool
 vect_check_gather_scatter (stmt_vec_info stmt_info, loop_vec_info loop_vinfo,
@@ -3985,7 +3988,7 @@ vect_check_gather_scatter (stmt_vec_info stmt_info, loop_vec_info loop_vinfo,
 	    decl = targetm.vectorize.builtin_scatter (vectype, offtype, scale);
 	}
 
-      if (!decl)
+      if (!decl && (!DR_IS_READ (dr) || masked_p))
 	return false;
 
       ifn = IFN_LAST;
@@ -2198,7 +2198,11 @@ vect_analyze_slp (vec_info *vinfo, unsigned max_tree_size)
 
   /* Find SLP sequences starting from groups of grouped stores.  */
   FOR_EACH_VEC_ELT (vinfo->grouped_stores, i, first_element)
-    vect_analyze_slp_instance (vinfo, first_element, max_tree_size);
+    if (!vect_analyze_slp_instance (vinfo, first_element, max_tree_size)
+	&& dump_enabled_p ())
+      dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+		       "SLP discovery failed for the store group starting "
+		       "at %G", first_element->stmt);
 
   if (loop_vec_info loop_vinfo = dyn_cast <loop_vec_info> (vinfo))
     {
@@ -2650,8 +2654,7 @@ vect_slp_analyze_operations (vec_info *vinfo)
   for (i = 0; vinfo->slp_instances.iterate (i, &instance); )
     {
       scalar_stmts_to_slp_tree_map_t lvisited;
-      stmt_vector_for_cost cost_vec;
-      cost_vec.create (2);
+      auto_vec<stmt_info_for_cost, 16> cost_vec;
       if (!vect_slp_analyze_node_operations (vinfo,
 					     SLP_INSTANCE_TREE (instance),
 					     instance, visited, &lvisited,
@@ -2665,7 +2668,6 @@ vect_slp_analyze_operations (vec_info *vinfo)
 			     stmt_info->stmt);
 	  vect_free_slp_instance (instance, false);
           vinfo->slp_instances.ordered_remove (i);
-	  cost_vec.release ();
 	}
       else
 	{
@@ -2675,7 +2677,6 @@ vect_slp_analyze_operations (vec_info *vinfo)
 	  i++;
 
 	  add_stmt_costs (vinfo->target_cost_data, &cost_vec);
-	  cost_vec.release ();
 	}
     }
   delete visited;
@@ -2788,8 +2789,7 @@ vect_bb_vectorization_profitable_p (bb_vec_info bb_vinfo)
   unsigned int vec_prologue_cost = 0, vec_epilogue_cost = 0;
 
   /* Calculate scalar cost.  */
-  stmt_vector_for_cost scalar_costs;
-  scalar_costs.create (0);
+  auto_vec<stmt_info_for_cost, 32> scalar_costs;
   FOR_EACH_VEC_ELT (slp_instances, i, instance)
     {
       auto_vec<bool, 20> life;
@@ -2800,7 +2800,6 @@ vect_bb_vectorization_profitable_p (bb_vec_info bb_vinfo)
     }
   void *target_cost_data = init_cost (NULL);
   add_stmt_costs (target_cost_data, &scalar_costs);
-  scalar_costs.release ();
   unsigned dummy;
   finish_cost (target_cost_data, &dummy, &scalar_cost, &dummy);
   destroy_cost_data (target_cost_data);
@@ -2832,7 +2831,15 @@ vect_bb_vectorization_profitable_p (bb_vec_info bb_vinfo)
      free on the scalar side but cost a load on the vector side for
      example).  */
   if (vec_outside_cost + vec_inside_cost > scalar_cost)
-    return false;
+    {
+      if (dump_enabled_p ())
+	dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+			 "vector cost %d (inside %d, outside %d) is higher "
+			 "than scalar cost %d\n",
+			 vec_outside_cost + vec_inside_cost, vec_inside_cost,
+			 vec_outside_cost, scalar_cost);
+      return false;
+    }
 
   return true;
 }
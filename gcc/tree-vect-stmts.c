@@ -1173,6 +1173,7 @@ vect_get_store_cost (stmt_vec_info stmt_info, int ncopies,
 static void
 vect_model_load_cost (stmt_vec_info stmt_info, unsigned ncopies,
 		      vect_memory_access_type memory_access_type,
+		      gather_scatter_info *gs_info,
 		      slp_instance instance,
 		      slp_tree slp_node,
 		      stmt_vector_for_cost *cost_vec)
@@ -1261,6 +1262,9 @@ vect_model_load_cost (stmt_vec_info stmt_info, unsigned ncopies,
     }
 
   /* The loads themselves.  */
+  bool emulated_gather_p = (memory_access_type == VMAT_GATHER_SCATTER
+			    && gs_info->ifn == IFN_LAST
+			    && !gs_info->decl);
   if (memory_access_type == VMAT_ELEMENTWISE
       || memory_access_type == VMAT_GATHER_SCATTER)
     {
@@ -1270,13 +1274,21 @@ vect_model_load_cost (stmt_vec_info stmt_info, unsigned ncopies,
       inside_cost += record_stmt_cost (cost_vec,
 				       ncopies * assumed_nunits,
 				       scalar_load, stmt_info, 0, vect_body);
+      /* An emulated gather also extracts each offset from the offset
+	 vector.  */
+      if (emulated_gather_p)
+	inside_cost += record_stmt_cost (cost_vec,
+					 ncopies * assumed_nunits,
+					 vec_to_scalar, stmt_info, 0,
+					 vect_body);
     }
   else
     vect_get_load_cost (stmt_info, ncopies, first_stmt_p,
 			&inside_cost, &prologue_cost, 
 			cost_vec, cost_vec, true);
   if (memory_access_type == VMAT_ELEMENTWISE
-      || memory_access_type == VMAT_STRIDED_SLP)
+      || memory_access_type == VMAT_STRIDED_SLP
+      || emulated_gather_p)
     inside_cost += record_stmt_cost (cost_vec, ncopies, vec_construct,
 				     stmt_info, 0, vect_body);
 
@@ -2113,7 +2125,7 @@ vect_use_strided_gather_scatters_p (stmt_vec_info stmt_info,
 				    gather_scatter_info *gs_info)
 {
   if (!vect_check_gather_scatter (stmt_info, loop_vinfo, gs_info)
-      || gs_info->decl)
+      || gs_info->ifn == IFN_LAST)
     return vect_truncate_gather_scatter_offset (stmt_info, loop_vinfo,
 						masked_p, gs_info);
 
@@ -2486,6 +2498,25 @@ get_load_store_type (stmt_vec_info stmt_info, tree vectype, bool slp,
 			     vls_type == VLS_LOAD ? "gather" : "scatter");
 	  return false;
 	}
+      else if (gs_info->ifn == IFN_LAST && !gs_info->decl)
+	{
+	  /* An emulated gather extracts the offsets of each copy from one
+	     offset vector, which therefore needs a fixed number of
+	     elements that is a multiple of that of VECTYPE.  */
+	  if (slp
+	      || !nunits.is_constant ()
+	      || !gs_info->offset_vectype
+	      || !TYPE_VECTOR_SUBPARTS (gs_info->offset_vectype).is_constant ()
+	      || !multiple_p (TYPE_VECTOR_SUBPARTS (gs_info->offset_vectype),
+			      nunits))
+	    {
+	      if (dump_enabled_p ())
+		dump_printf_loc (MSG_MISSED_OPTIMIZATION, vect_location,
+				 "unsupported vector types for emulated "
+				 "gather.\n");
+	      return false;
+	    }
+	}
     }
   else if (STMT_VINFO_GROUPED_ACCESS (stmt_info))
     {
@@ -2992,6 +3023,88 @@ vect_get_gather_scatter_ops (class loop *loop, stmt_vec_info stmt_info,
 					      offset_vectype);
 }
 
+/* Build the vector statements for STMT_INFO, an unconditional gather
+   load described by GS_INFO, for which the target has no gather
+   instruction.  Each element is loaded by a scalar load from the base
+   address plus the corresponding element of the offset vector times the
+   scale, and the elements are then combined with a CONSTRUCTOR.  The
+   offset vector may have more elements than the data vector, in which
+   case consecutive copies use consecutive parts of it.  */
+
+static void
+vect_build_emulated_gather_load (stmt_vec_info stmt_info,
+				 gimple_stmt_iterator *gsi,
+				 stmt_vec_info *vec_stmt,
+				 gather_scatter_info *gs_info)
+{
+  loop_vec_info loop_vinfo = STMT_VINFO_LOOP_VINFO (stmt_info);
+  class loop *loop = LOOP_VINFO_LOOP (loop_vinfo);
+  tree vectype = STMT_VINFO_VECTYPE (stmt_info);
+  unsigned HOST_WIDE_INT nunits
+    = TYPE_VECTOR_SUBPARTS (vectype).to_constant ();
+  int ncopies = vect_get_num_copies (loop_vinfo, vectype);
+  data_reference *dr = STMT_VINFO_DATA_REF (stmt_info);
+
+  tree dataref_ptr, vec_offset;
+  vect_get_gather_scatter_ops (loop, stmt_info, gs_info, &dataref_ptr,
+			       &vec_offset);
+  unsigned HOST_WIDE_INT offset_nunits
+    = TYPE_VECTOR_SUBPARTS (TREE_TYPE (vec_offset)).to_constant ();
+  gcc_assert (offset_nunits % nunits == 0);
+  unsigned HOST_WIDE_INT factor = offset_nunits / nunits;
+
+  tree scalar_dest = gimple_get_lhs (stmt_info->stmt);
+  tree vec_dest = vect_create_destination_var (scalar_dest, vectype);
+  tree idx_type = TREE_TYPE (TREE_TYPE (vec_offset));
+  tree ref_type = reference_alias_ptr_type (DR_REF (dr));
+  tree ltype = build_aligned_type (TREE_TYPE (vectype),
+				   get_object_alignment (DR_REF (dr)));
+  tree scale = size_int (gs_info->scale);
+
+  stmt_vec_info prev_stmt_info = NULL;
+  for (int j = 0; j < ncopies; ++j)
+    {
+      if (j != 0 && j % factor == 0)
+	vec_offset = vect_get_vec_def_for_stmt_copy (loop_vinfo, vec_offset);
+      unsigned HOST_WIDE_INT elt_offset = (j % factor) * nunits;
+
+      vec<constructor_elt, va_gc> *ctor_elts;
+      vec_alloc (ctor_elts, nunits);
+      gimple_seq stmts = NULL;
+      for (unsigned HOST_WIDE_INT k = 0; k < nunits; ++k)
+	{
+	  tree bitpos = bitsize_int ((k + elt_offset)
+				     * tree_to_uhwi (TYPE_SIZE (idx_type)));
+	  tree idx = gimple_build (&stmts, BIT_FIELD_REF, idx_type,
+				   vec_offset, TYPE_SIZE (idx_type), bitpos);
+	  idx = gimple_convert (&stmts, sizetype, idx);
+	  idx = gimple_build (&stmts, MULT_EXPR, sizetype, idx, scale);
+	  /* The base is an integer after vect_check_gather_scatter has
+	     folded constant offsets into it.  */
+	  tree ptr = gimple_convert (&stmts, sizetype, dataref_ptr);
+	  ptr = gimple_build (&stmts, PLUS_EXPR, sizetype, ptr, idx);
+	  ptr = gimple_convert (&stmts, ptr_type_node, ptr);
+	  tree elt = make_ssa_name (TREE_TYPE (vectype));
+	  tree ref = build2 (MEM_REF, ltype, ptr, build_int_cst (ref_type, 0));
+	  gimple_seq_add_stmt (&stmts, gimple_build_assign (elt, ref));
+	  CONSTRUCTOR_APPEND_ELT (ctor_elts, NULL_TREE, elt);
+	}
+      gsi_insert_seq_before (gsi, stmts, GSI_SAME_STMT);
+
+      gassign *new_stmt
+	= gimple_build_assign (make_ssa_name (vec_dest),
+			       build_constructor (vectype, ctor_elts));
+      stmt_vec_info new_stmt_info
+	= vect_finish_stmt_generation (stmt_info, new_stmt, gsi);
+
+      if (prev_stmt_info == NULL)
+	STMT_VINFO_VEC_STMT (stmt_info) = *vec_stmt = new_stmt_info;
+      else
+	STMT_VINFO_RELATED_STMT (prev_stmt_info) = new_stmt_info;
+      prev_stmt_info = new_stmt_info;
+    }
+}
+
 /* Prepare to implement a grouped or strided load or store using
    the gather load or scatter store operation described by GS_INFO.
    STMT_INFO is the load or store statement.
@@ -8646,7 +8759,7 @@ vectorizable_load (stmt_vec_info stmt_info, gimple_stmt_iterator *gsi,
 
       STMT_VINFO_TYPE (stmt_info) = load_vec_info_type;
       vect_model_load_cost (stmt_info, ncopies, memory_access_type,
-			    slp_node_instance, slp_node, cost_vec);
+			    &gs_info, slp_node_instance, slp_node, cost_vec);
       return true;
     }
 
@@ -8669,6 +8782,13 @@ vectorizable_load (stmt_vec_info stmt_info, gimple_stmt_iterator *gsi,
       return true;
     }
 
+  if (memory_access_type == VMAT_GATHER_SCATTER && gs_info.ifn == IFN_LAST)
+    {
+      gcc_assert (!mask);
+      vect_build_emulated_gather_load (stmt_info, gsi, vec_stmt, &gs_info);
+      return true;
+    }
+
   if (memory_access_type == VMAT_INVARIANT)
     {
       gcc_assert (!grouped_load && !mask && !bb_vinfo);
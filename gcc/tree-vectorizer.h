@@ -1070,7 +1070,9 @@ struct gather_scatter_info {
   internal_fn ifn;
 
   /* The FUNCTION_DECL for the built-in gather/scatter function,
-     or null if an internal function should be used instead.  */
+     or null if an internal function should be used instead.  If both
+     IFN is IFN_LAST and DECL is null, the gather is emulated using
+     scalar loads.  */
   tree decl;
 
   /* The loop-invariant base value.  */
@@ -1956,6 +1956,101 @@ range_fold_unary_expr (value_range_base *vr,
 			value_range_base (expr_type));
 }
 
+/* Return the range of the integer constant or SSA name EXPR.  */
+
+value_range_base
+ssa_range_query::range_of_expr (tree expr)
+{
+  return range_of_expr (expr, m_max_depth);
+}
+
+/* Return the range of EXPR, looking through at most DEPTH definitions.  */
+
+value_range_base
+ssa_range_query::range_of_expr (tree expr, unsigned depth)
+{
+  tree type = TREE_TYPE (expr);
+  if (TREE_CODE (expr) == INTEGER_CST)
+    return value_range_base (expr, expr);
+  if (TREE_CODE (expr) != SSA_NAME || !INTEGRAL_TYPE_P (type))
+    return value_range_base (type);
+
+  if (value_range_base *cached = m_cache.get (expr))
+    return *cached;
+
+  value_range_base vr;
+  get_range_info (expr, vr);
+  if (depth == 0)
+    return vr;
+
+  /* Seed the cache with the global range so that cycles through PHIs
+     terminate.  It is conservative, so whatever is computed from it
+     can be cached as well.  */
+  m_cache.put (expr, vr);
+  value_range_base def_vr = range_of_def (SSA_NAME_DEF_STMT (expr), type,
+					  depth - 1);
+  if (def_vr.constant_p ())
+    vr.intersect (def_vr);
+  m_cache.put (expr, vr);
+  return vr;
+}
+
+/* Return the range of the value of type TYPE defined by STMT, looking
+   through at most DEPTH further definitions.  */
+
+value_range_base
+ssa_range_query::range_of_def (gimple *stmt, tree type, unsigned depth)
+{
+  value_range_base vr (type);
+
+  if (gphi *phi = dyn_cast <gphi *> (stmt))
+    {
+      vr.set_undefined ();
+      for (unsigned i = 0; i < gimple_phi_num_args (phi); ++i)
+	{
+	  vr.union_ (range_of_expr (gimple_phi_arg_def (phi, i), depth));
+	  if (vr.varying_p ())
+	    break;
+	}
+      return vr;
+    }
+
+  if (!is_gimple_assign (stmt))
+    return vr;
+
+  enum tree_code code = gimple_assign_rhs_code (stmt);
+  tree rhs1 = gimple_assign_rhs1 (stmt);
+  if (!INTEGRAL_TYPE_P (TREE_TYPE (rhs1)))
+    return vr;
+
+  switch (get_gimple_rhs_class (code))
+    {
+    case GIMPLE_SINGLE_RHS:
+      return range_of_expr (rhs1, depth);
+
+    case GIMPLE_UNARY_RHS:
+      {
+	value_range_base vr0 = range_of_expr (rhs1, depth);
+	range_fold_unary_expr (&vr, code, type, &vr0, TREE_TYPE (rhs1));
+	return vr;
+      }
+
+    case GIMPLE_BINARY_RHS:
+      {
+	tree rhs2 = gimple_assign_rhs2 (stmt);
+	if (!INTEGRAL_TYPE_P (TREE_TYPE (rhs2)))
+	  return vr;
+	value_range_base vr0 = range_of_expr (rhs1, depth);
+	value_range_base vr1 = range_of_expr (rhs2, depth);
+	range_fold_binary_expr (&vr, code, type, &vr0, &vr1);
+	return vr;
+      }
+
+    default:
+      return vr;
+    }
+}
+
 /* Given a COND_EXPR COND of the form 'V OP W', and an SSA name V,
    create a new SSA name N and return the assertion assignment
    'N = ASSERT_EXPR <V, V OP W>'.  */
@@ -299,6 +299,28 @@ void range_fold_binary_expr (value_range_base *, enum tree_code, tree type,
 			     const value_range_base *,
 			     const value_range_base *);
 
+/* On-demand range queries for SSA names, for passes that need the range
+   of a few names without running all of VRP.  The range of a name is
+   its global range, refined by folding the ranges of the operands of
+   its definition with range-ops.  Results are cached for the lifetime
+   of the object, so it must not outlive changes to the IL.  */
+
+class ssa_range_query
+{
+ public:
+  ssa_range_query (unsigned max_depth = 6) : m_max_depth (max_depth) {}
+
+  value_range_base range_of_expr (tree);
+
+ private:
+  value_range_base range_of_expr (tree, unsigned);
+  value_range_base range_of_def (gimple *, tree, unsigned);
+
+  hash_map<tree, value_range_base> m_cache;
+  /* The maximum depth of definitions to look through.  */
+  unsigned m_max_depth;
+};
+
 extern bool vrp_operand_equal_p (const_tree, const_tree);
 extern enum value_range_kind intersect_range_with_nonzero_bits
   (enum value_range_kind, wide_int *, wide_int *, const wide_int &, signop);
@@ -45,9 +45,20 @@ along with GCC; see the file COPYING3.  If not see
 #include "asan.h"
 #include "builtins.h"
 #include "target.h"
+#include "params.h"
+#include "varasm.h"
+#include "tree-into-ssa.h"
 
 /* Number of instrumented memory accesses in the current function.  */
 
+/* The memory access instrumentation calls inserted into the current
+   function, recorded when --param tsan-sample-rate asks for them to
+   be sampled.  */
+static vec<gimple *> tsan_access_calls;
+
+/* The thread-local countdown used to sample function invocations.  */
+static GTY(()) tree tsan_sample_counter_decl;
+
 /* Builds the following decl
    void __tsan_read/writeX (void *addr);  */
 
@@ -213,6 +224,8 @@ instrument_expr (gimple_stmt_iterator gsi, tree expr, bool is_write)
     }
   gimple_set_location (g, loc);
   gimple_seq_add_stmt_without_update (&seq, g);
+  if (TSAN_SAMPLE_RATE > 1)
+    tsan_access_calls.safe_push (g);
   /* Instrumentation for assignment of a function result
      must be inserted after the call.  Instrumentation for
      reads of function arguments must be inserted before the call.
@@ -844,6 +857,98 @@ instrument_func_entry (void)
   gsi_insert_seq_on_edge_immediate (e, seq);
 }
 
+/* Return the thread-local variable that counts down the function
+   invocations until the next sampled one, creating it if needed.  */
+
+static tree
+get_tsan_sample_counter (void)
+{
+  if (tsan_sample_counter_decl == NULL_TREE)
+    {
+      tree decl = build_decl (BUILTINS_LOCATION, VAR_DECL,
+			      get_identifier ("__tsan_sample_counter"),
+			      unsigned_type_node);
+      TREE_STATIC (decl) = 1;
+      TREE_PUBLIC (decl) = 0;
+      TREE_USED (decl) = 1;
+      DECL_ARTIFICIAL (decl) = 1;
+      DECL_IGNORED_P (decl) = 1;
+      set_decl_tls_model (decl, decl_default_tls_model (decl));
+      varpool_node::finalize_decl (decl);
+      tsan_sample_counter_decl = decl;
+    }
+  return tsan_sample_counter_decl;
+}
+
+/* Make the memory access instrumentation recorded in TSAN_ACCESS_CALLS
+   run only in sampled invocations of the current function.  One counter
+   per thread is shared by all the instrumented functions of the
+   translation unit, so one in every TSAN_SAMPLE_RATE of their
+   invocations on each thread is sampled.  Synchronization is always
+   instrumented, so the races found between sampled accesses are real
+   races.  At function entry this emits
+
+     c = __tsan_sample_counter;
+     sampled = c == 0;
+     __tsan_sample_counter = MIN (c - 1, TSAN_SAMPLE_RATE - 1);
+
+   and each access call is then guarded by if (sampled).  */
+
+static void
+sample_memory_accesses (void)
+{
+  tree counter = get_tsan_sample_counter ();
+  gimple_seq seq = NULL;
+  gimple *g;
+
+  tree c = make_ssa_name (unsigned_type_node);
+  g = gimple_build_assign (c, counter);
+  gimple_seq_add_stmt_without_update (&seq, g);
+  tree sampled = make_ssa_name (boolean_type_node);
+  g = gimple_build_assign (sampled, EQ_EXPR, c,
+			   build_zero_cst (unsigned_type_node));
+  gimple_seq_add_stmt_without_update (&seq, g);
+  tree c1 = make_ssa_name (unsigned_type_node);
+  g = gimple_build_assign (c1, MINUS_EXPR, c,
+			   build_one_cst (unsigned_type_node));
+  gimple_seq_add_stmt_without_update (&seq, g);
+  tree c2 = make_ssa_name (unsigned_type_node);
+  g = gimple_build_assign (c2, MIN_EXPR, c1,
+			   build_int_cst (unsigned_type_node,
+					  TSAN_SAMPLE_RATE - 1));
+  gimple_seq_add_stmt_without_update (&seq, g);
+  g = gimple_build_assign (unshare_expr (counter), c2);
+  gimple_seq_add_stmt_without_update (&seq, g);
+  gimple_seq_set_location (seq, cfun->function_start_locus);
+
+  edge e = single_succ_edge (ENTRY_BLOCK_PTR_FOR_FN (cfun));
+  gsi_insert_seq_on_edge_immediate (e, seq);
+
+  unsigned int i;
+  gimple *call;
+  FOR_EACH_VEC_ELT (tsan_access_calls, i, call)
+    {
+      gimple_stmt_iterator gsi = gsi_for_stmt (call);
+      basic_block then_bb, fallthru_bb;
+      gimple_stmt_iterator cond_gsi
+	= create_cond_insert_point (&gsi, /*before_p=*/true,
+				    /*then_more_likely_p=*/false,
+				    /*create_then_fallthru_edge=*/true,
+				    &then_bb, &fallthru_bb);
+      g = gimple_build_cond (NE_EXPR, sampled, boolean_false_node,
+			     NULL_TREE, NULL_TREE);
+      gimple_set_location (g, gimple_location (call));
+      gsi_insert_after (&cond_gsi, g, GSI_NEW_STMT);
+
+      /* GSI now points to CALL at the start of FALLTHRU_BB; move it
+	 into the then block.  */
+      gsi_remove (&gsi, false);
+      gimple_stmt_iterator then_gsi = gsi_start_bb (then_bb);
+      gsi_insert_after (&then_gsi, call, GSI_NEW_STMT);
+    }
+  mark_virtual_operands_for_renaming (cfun);
+}
+
 /* ThreadSanitizer instrumentation pass.  */
 
 static unsigned
@@ -851,8 +956,15 @@ tsan_pass (void)
 {
   initialize_sanitizer_builtins ();
   bool cfg_changed = false;
+  tsan_access_calls.truncate (0);
   if (instrument_memory_accesses (&cfg_changed))
     instrument_func_entry ();
+  if (!tsan_access_calls.is_empty ())
+    {
+      if (targetm.have_tls)
+	sample_memory_accesses ();
+      tsan_access_calls.release ();
+    }
   return cfg_changed ? TODO_cleanup_cfg : 0;
 }
 
@@ -953,3 +1065,5 @@ make_pass_tsan_O0 (gcc::context *ctxt)
 {
   return new pass_tsan_O0 (ctxt);
 }
+
+#include "gt-tsan.h"
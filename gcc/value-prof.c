@@ -1714,6 +1714,51 @@ gimple_stringops_transform (gimple_stmt_iterator *gsi)
   return true;
 }
 
+/* Sizes of string operations in [0, STRINGOP_SIZE_STEPS) are counted
+   separately by the interval histogram of the length.  */
+
+#define STRINGOP_SIZE_STEPS 65
+
+/* Lower *PROBABLE_MAX_SIZE for the string operation STMT to the smallest
+   size that covers at least 95% of the lengths recorded by its interval
+   histogram, so that the expander can pick an inline sequence for the
+   sizes that are actually used.  MIN_SIZE is the known lower bound of
+   the length.  */
+
+void
+stringop_size_profile (gimple *stmt, unsigned HOST_WIDE_INT min_size,
+		       unsigned HOST_WIDE_INT *probable_max_size)
+{
+  histogram_value histogram;
+  gcov_type all = 0, covered = 0;
+  unsigned int i, steps;
+
+  histogram = gimple_histogram_value_of_type (cfun, stmt, HIST_TYPE_INTERVAL);
+  if (!histogram)
+    return;
+
+  steps = histogram->hdata.intvl.steps;
+  for (i = 0; i < steps + 2; i++)
+    all += histogram->hvalue.counters[i];
+
+  /* Lengths below the interval only come from values that don't fit
+     gcov_type, so they count as large ones just like those above it.  */
+  if (all > 0)
+    for (i = 0; i < steps; i++)
+      {
+	covered += histogram->hvalue.counters[i];
+	if (covered >= all - all / 20)
+	  {
+	    unsigned HOST_WIDE_INT size = histogram->hdata.intvl.int_start + i;
+	    if (size >= min_size && size < *probable_max_size)
+	      *probable_max_size = size;
+	    break;
+	  }
+      }
+
+  gimple_remove_histogram_value (cfun, stmt, histogram);
+}
+
 void
 stringop_block_profile (gimple *stmt, unsigned int *expected_align,
 			HOST_WIDE_INT *expected_size)
@@ -1875,6 +1920,14 @@ gimple_stringops_values_to_profile (gimple *gs, histogram_values *values)
 						       stmt, blck_size));
       values->safe_push (gimple_alloc_histogram_value (cfun, HIST_TYPE_AVERAGE,
 						       stmt, blck_size));
+
+      /* The distribution of the small sizes, for stringop_size_profile.  */
+      histogram_value hist
+	= gimple_alloc_histogram_value (cfun, HIST_TYPE_INTERVAL,
+					stmt, blck_size);
+      hist->hdata.intvl.int_start = 0;
+      hist->hdata.intvl.steps = STRINGOP_SIZE_STEPS;
+      values->safe_push (hist);
     }
 
   if (TREE_CODE (blck_size) != INTEGER_CST)
@@ -10182,6 +10182,14 @@ vt_initialize (void)
 	  HOST_WIDE_INT offset = VTI (bb)->out.stack_adjust;
 	  VTI (bb)->out.stack_adjust = VTI (bb)->in.stack_adjust;
 
+	  /* Most insns give rise to at least one micro operation, so size
+	     the vector up front rather than growing it a push at a time.  */
+	  unsigned int n_insns = 0;
+	  FOR_BB_INSNS (bb, insn)
+	    if (INSN_P (insn))
+	      n_insns++;
+	  VTI (bb)->mos.reserve (n_insns);
+
 	  rtx_insn *next;
 	  FOR_BB_INSNS_SAFE (bb, insn, next)
 	    {
@@ -10447,6 +10455,17 @@ variable_tracking_main_1 (void)
       return 0;
     }
 
+  /* Once the function is over its compile time budget, track variables
+     without the more expensive debug bind insns, as when the hash tables
+     grow beyond --param max-vartrack-size.  */
+  if (cfun->compile_budget_exceeded && flag_var_tracking_assignments > 0)
+    {
+      delete_vta_debug_insns (true);
+
+      /* This is later restored by our caller.  */
+      flag_var_tracking_assignments = 0;
+    }
+
   mark_dfs_back_edges ();
   if (!vt_initialize ())
     {
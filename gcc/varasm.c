@@ -4865,6 +4865,88 @@ static unsigned HOST_WIDE_INT
 output_constructor (tree, unsigned HOST_WIDE_INT, unsigned int, bool,
 		    oc_outer_state *);
 
+/* Try to output the CONSTRUCTOR EXP of an array of bytes, padded to SIZE
+   bytes, as a string rather than with a directive per element, which
+   considerably reduces the size of the assembly for big tables.  Return
+   the number of bytes output, or zero if EXP is not suitable.  */
+
+static unsigned HOST_WIDE_INT
+output_byte_array_constructor (tree exp, unsigned HOST_WIDE_INT size)
+{
+  tree type = TREE_TYPE (exp);
+  tree eltype = TREE_TYPE (type);
+  tree domain = TYPE_DOMAIN (type);
+
+  if (BITS_PER_UNIT != 8
+      || TREE_CODE (type) != ARRAY_TYPE
+      || !INTEGRAL_TYPE_P (eltype)
+      || TYPE_PRECISION (eltype) != BITS_PER_UNIT
+      || !integer_onep (TYPE_SIZE_UNIT (eltype))
+      || !domain
+      || !TYPE_MIN_VALUE (domain)
+      || !tree_fits_shwi_p (TYPE_MIN_VALUE (domain))
+      /* Not worth it for small arrays.  */
+      || CONSTRUCTOR_NELTS (exp) < 64)
+    return 0;
+
+  HOST_WIDE_INT min_index = tree_to_shwi (TYPE_MIN_VALUE (domain));
+
+  /* Find the extent of the explicitly initialized bytes.  */
+  unsigned HOST_WIDE_INT len = 0, pos = 0;
+  unsigned HOST_WIDE_INT cnt;
+  tree index, value;
+  FOR_EACH_CONSTRUCTOR_ELT (CONSTRUCTOR_ELTS (exp), cnt, index, value)
+    {
+      if (TREE_CODE (value) != INTEGER_CST)
+	return 0;
+      if (index && TREE_CODE (index) == RANGE_EXPR)
+	{
+	  if (!tree_fits_shwi_p (TREE_OPERAND (index, 0))
+	      || tree_to_shwi (TREE_OPERAND (index, 0)) < min_index)
+	    return 0;
+	  index = TREE_OPERAND (index, 1);
+	}
+      if (index)
+	{
+	  if (!tree_fits_shwi_p (index)
+	      || tree_to_shwi (index) < min_index)
+	    return 0;
+	  pos = tree_to_shwi (index) - min_index;
+	}
+      len = MAX (len, pos + 1);
+      pos++;
+    }
+  if (len > size || len > INT_MAX)
+    return 0;
+
+  char *buf = XCNEWVEC (char, len);
+  pos = 0;
+  FOR_EACH_CONSTRUCTOR_ELT (CONSTRUCTOR_ELTS (exp), cnt, index, value)
+    {
+      unsigned HOST_WIDE_INT first, last;
+      if (index && TREE_CODE (index) == RANGE_EXPR)
+	{
+	  first = tree_to_shwi (TREE_OPERAND (index, 0)) - min_index;
+	  last = tree_to_shwi (TREE_OPERAND (index, 1)) - min_index;
+	}
+      else
+	{
+	  if (index)
+	    pos = tree_to_shwi (index) - min_index;
+	  first = last = pos;
+	}
+      for (unsigned HOST_WIDE_INT i = first; i <= last; i++)
+	buf[i] = TREE_INT_CST_LOW (value) & 0xff;
+      pos = last + 1;
+    }
+
+  assemble_string (buf, len);
+  XDELETEVEC (buf);
+  if (size > len)
+    assemble_zeros (size - len);
+  return size;
+}
+
 /* Output assembler code for constant EXP, with no label.
    This includes the pseudo-op such as ".int" or ".byte", and a newline.
    Assumes output_addressed_constants has been done on EXP already.
@@ -5018,6 +5100,9 @@ output_constant (tree exp, unsigned HOST_WIDE_INT size, unsigned int align,
       switch (TREE_CODE (exp))
 	{
 	case CONSTRUCTOR:
+	  if (unsigned HOST_WIDE_INT done
+		= output_byte_array_constructor (exp, size))
+	    return done;
 	  return output_constructor (exp, size, align, reverse, NULL);
 	case STRING_CST:
 	  thissize = (unsigned HOST_WIDE_INT)TREE_STRING_LENGTH (exp);
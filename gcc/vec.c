@@ -53,14 +53,16 @@ class vec_usage: public mem_usage
 {
 public:
   /* Default constructor.  */
-  vec_usage (): m_items (0), m_items_peak (0), m_element_size (0) {}
+  vec_usage (): m_items (0), m_items_peak (0), m_element_size (0),
+    m_reallocs (0) {}
 
   /* Constructor.  */
   vec_usage (size_t allocated, size_t times, size_t peak,
-	     size_t items, size_t items_peak, size_t element_size)
+	     size_t items, size_t items_peak, size_t element_size,
+	     size_t reallocs)
     : mem_usage (allocated, times, peak),
     m_items (items), m_items_peak (items_peak),
-    m_element_size (element_size) {}
+    m_element_size (element_size), m_reallocs (reallocs) {}
 
   /* Sum the usage with SECOND usage.  */
   vec_usage
@@ -70,7 +72,8 @@ public:
 		      m_times + second.m_times,
 		      m_peak + second.m_peak,
 		      m_items + second.m_items,
-		      m_items_peak + second.m_items_peak, 0);
+		      m_items_peak + second.m_items_peak, 0,
+		      m_reallocs + second.m_reallocs);
   }
 
   /* Dump usage coupled to LOC location, where TOTAL is sum of all rows.  */
@@ -85,31 +88,34 @@ public:
 
     fprintf (stderr,
 	     "%-48s %10" PRIu64 PRsa (10) ":%4.1f%%" PRsa (9) "%10" PRIu64
-	     ":%4.1f%%" PRsa (10) PRsa (10) "\n",
+	     ":%4.1f%%" PRsa (10) PRsa (10) PRsa (10) "\n",
 	     s,
 	     (uint64_t)m_element_size,
 	     SIZE_AMOUNT (m_allocated),
 	     m_allocated * 100.0 / total.m_allocated,
 	     SIZE_AMOUNT (m_peak), (uint64_t)m_times,
 	     m_times * 100.0 / total.m_times,
-	     SIZE_AMOUNT (m_items), SIZE_AMOUNT (m_items_peak));
+	     SIZE_AMOUNT (m_items), SIZE_AMOUNT (m_items_peak),
+	     SIZE_AMOUNT (m_reallocs));
   }
 
   /* Dump footer.  */
   inline void
   dump_footer ()
   {
-    fprintf (stderr, "%s" PRsa (64) PRsa (25) PRsa (16) "\n",
+    fprintf (stderr, "%s" PRsa (64) PRsa (25) PRsa (16) PRsa (21) "\n",
 	     "Total", SIZE_AMOUNT (m_allocated),
-	     SIZE_AMOUNT (m_times), SIZE_AMOUNT (m_items));
+	     SIZE_AMOUNT (m_times), SIZE_AMOUNT (m_items),
+	     SIZE_AMOUNT (m_reallocs));
   }
 
   /* Dump header with NAME.  */
   static inline void
   dump_header (const char *name)
   {
-    fprintf (stderr, "%-48s %10s%11s%16s%10s%17s%11s\n", name, "sizeof(T)",
-	     "Leak", "Peak", "Times", "Leak items", "Peak items");
+    fprintf (stderr, "%-48s %10s%11s%16s%10s%17s%11s%11s\n", name,
+	     "sizeof(T)", "Leak", "Peak", "Times", "Leak items", "Peak items",
+	     "Reallocs");
   }
 
   /* Current number of items allocated.  */
@@ -118,16 +124,19 @@ public:
   size_t m_items_peak;
   /* Size of element of the vector.  */
   size_t m_element_size;
+  /* Number of times an existing vector had to be reallocated to grow.  */
+  size_t m_reallocs;
 };
 
 /* Vector memory description.  */
 static mem_alloc_description <vec_usage> vec_mem_desc;
 
-/* Account the overhead.  */
+/* Account the overhead.  GROWN is true if PTR is the result of
+   growing an existing vector rather than of a fresh allocation.  */
 
 void
 vec_prefix::register_overhead (void *ptr, size_t elements,
-			       size_t element_size MEM_STAT_DECL)
+			       size_t element_size, bool grown MEM_STAT_DECL)
 {
   vec_mem_desc.register_descriptor (ptr, VEC_ORIGIN, false
 				    FINAL_PASS_MEM_STAT);
@@ -135,6 +144,8 @@ vec_prefix::register_overhead (void *ptr, size_t elements,
     = vec_mem_desc.register_instance_overhead (elements * element_size, ptr);
   usage->m_element_size = element_size;
   usage->m_items += elements;
+  if (grown)
+    usage->m_reallocs++;
   if (usage->m_items_peak < usage->m_items)
     usage->m_items_peak = usage->m_items;
 }
@@ -477,6 +488,20 @@ test_qsort ()
   ASSERT_EQ (1, v[8]);
   ASSERT_EQ (0, v[9]);
   ASSERT_EQ (10, v.length ());
+
+  /* Already sorted input, with ties, and input that is sorted except
+     for its last element.  */
+  v.truncate (0);
+  for (int i = 0; i < 20; i++)
+    v.safe_push (20 - i / 2);
+  v.qsort (reverse_cmp);
+  for (int i = 0; i < 20; i++)
+    ASSERT_EQ (20 - i / 2, v[i]);
+  v.safe_push (21);
+  v.qsort (reverse_cmp);
+  ASSERT_EQ (21, v[0]);
+  ASSERT_EQ (20, v[1]);
+  ASSERT_EQ (11, v[20]);
 }
 
 /* Verify that vec::reverse works correctly.  */
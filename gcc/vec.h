@@ -194,7 +194,7 @@ struct vec_prefix
 	     compilers that have stricter notions of PODness for types.  */
 
   /* Memory allocation support routines in vec.c.  */
-  void register_overhead (void *, size_t, size_t CXX_MEM_STAT_INFO);
+  void register_overhead (void *, size_t, size_t, bool CXX_MEM_STAT_INFO);
   void release_overhead (void *, size_t, size_t, bool CXX_MEM_STAT_INFO);
   static unsigned calculate_allocation (vec_prefix *, unsigned, bool);
   static unsigned calculate_allocation_1 (unsigned, unsigned);
@@ -287,11 +287,13 @@ va_heap::reserve (vec<T, va_heap, vl_embed> *&v, unsigned reserve, bool exact
 
   size_t size = vec<T, va_heap, vl_embed>::embedded_size (alloc);
   unsigned nelem = v ? v->length () : 0;
+  bool grown = v != NULL;
   v = static_cast <vec<T, va_heap, vl_embed> *> (xrealloc (v, size));
   v->embedded_init (alloc, nelem);
 
   if (GATHER_STATISTICS)
-    v->m_vecpfx.register_overhead (v, alloc, elt_size PASS_MEM_STAT);
+    v->m_vecpfx.register_overhead (v, alloc, elt_size, grown
+				   PASS_MEM_STAT);
 }
 
 
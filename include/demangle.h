@@ -146,6 +146,30 @@ cplus_demangle_v3_callback (const char *mangled, int options,
 extern char*
 cplus_demangle_v3 (const char *mangled, int options);
 
+/* Reusable working memory for demangling many names in turn, so that
+   it is neither allocated for each name nor on the stack.  */
+struct demangle_workspace;
+
+extern struct demangle_workspace *
+cplus_demangle_workspace_create (void);
+
+extern void
+cplus_demangle_workspace_free (struct demangle_workspace *ws);
+
+/* Like cplus_demangle_v3_callback, with the working memory in WS.  */
+extern int
+cplus_demangle_v3_workspace_callback (const char *mangled, int options,
+                                      demangle_callbackref callback,
+                                      void *opaque,
+                                      struct demangle_workspace *ws);
+
+/* Store the demangled name in BUF, which is SIZE bytes long, truncating
+   it like snprintf, and return its full length, or 0 on error.  WS may
+   be NULL to use the stack for the working memory.  */
+extern size_t
+cplus_demangle_v3_buffer (const char *mangled, int options, char *buf,
+                          size_t size, struct demangle_workspace *ws);
+
 extern int
 java_demangle_v3_callback (const char *mangled,
                            demangle_callbackref callback, void *opaque);
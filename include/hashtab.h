@@ -132,12 +132,30 @@ struct htab {
   htab_free_with_arg free_with_arg_f;
 
   /* Current size (in entries) of the hash table, as an index into the
-     table of primes.  */
+     table of primes, or its base-2 logarithm if HTAB_POWER_OF_2 is
+     set in FLAGS.  */
   unsigned int size_prime_index;
+
+  /* The HTAB_* flags the table was created with.  */
+  unsigned int flags;
+
+  /* If HTAB_CACHE_HASHES is set in FLAGS, the hash values of the
+     entries, in parallel to ENTRIES.  Otherwise NULL.  */
+  hashval_t *hashes;
 };
 
 typedef struct htab *htab_t;
 
+/* Flags for htab_create_alloc_flags.  */
+
+/* Store the hash value of each entry, so that lookups only call the
+   equality function on hash matches and expansion does not rehash.  */
+#define HTAB_CACHE_HASHES	1
+
+/* Use power-of-two sizes with quadratic probing instead of prime sizes
+   with double hashing.  */
+#define HTAB_POWER_OF_2		2
+
 /* An enum saying whether we insert into the hash table or not.  */
 enum insert_option {NO_INSERT, INSERT};
 
@@ -155,6 +173,11 @@ extern htab_t	htab_create_alloc_ex (size_t, htab_hash,
 extern htab_t  htab_create_typed_alloc (size_t, htab_hash, htab_eq, htab_del,
 					htab_alloc, htab_alloc, htab_free);
 
+extern htab_t	htab_create_alloc_flags (size_t, htab_hash,
+                                         htab_eq, htab_del,
+                                         htab_alloc, htab_free,
+                                         unsigned int);
+
 /* Backward-compatibility functions.  */
 extern htab_t htab_create (size_t, htab_hash, htab_eq, htab_del);
 extern htab_t htab_try_create (size_t, htab_hash, htab_eq, htab_del);
@@ -95,6 +95,22 @@ simple_object_find_section (simple_object_read *simple_object,
 			    const char *name, off_t *offset, off_t *length,
 			    const char **errmsg, int *err);
 
+/* Call PFN for each symbol defined in SIMPLE_OBJECT, passing it the
+   symbol name.  Undefined symbols are skipped.  The DATA argument to
+   simple_object_find_symbols is passed on to PFN.  If PFN returns 0,
+   the loop is stopped and simple_object_find_symbols returns.  If PFN
+   returns non-zero, the loop continues.  On success this returns
+   NULL.  On error it returns an error string, and sets *ERR to an
+   errno value or 0 if there is no relevant errno.  Reading symbols
+   is only supported for ELF; for other object file formats this
+   returns an error string and sets *ERR to EINVAL.  */
+
+extern const char *
+simple_object_find_symbols (simple_object_read *simple_object,
+			    int (*pfn) (void *data, const char *name),
+			    void *data,
+			    int *err);
+
 /* Release all resources associated with SIMPLE_OBJECT.  This does not
    close the file descriptor.  */
 
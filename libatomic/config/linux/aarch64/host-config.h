@@ -23,14 +23,71 @@
 
 #if HAVE_IFUNC
 #include <stdlib.h>
+#include <sys/auxv.h>
 
+# ifndef HWCAP_USCAT
+#  define HWCAP_USCAT	(1 << 25)
+# endif
+
+/* Alternative 1 uses the LSE atomics.  For 16 bytes it additionally
+   needs LSE2, which makes aligned LDP and STP single-copy atomic, and
+   alternative 2 is plain LSE.  */
 # ifdef HWCAP_ATOMICS
-#  define IFUNC_COND_1	(hwcap & HWCAP_ATOMICS)
+#  define IFUNC_COND_1	(N == 16					\
+			 ? ((hwcap & (HWCAP_ATOMICS | HWCAP_USCAT))	\
+			    == (HWCAP_ATOMICS | HWCAP_USCAT))		\
+			 : (hwcap & HWCAP_ATOMICS) != 0)
+#  define IFUNC_COND_2	((hwcap & HWCAP_ATOMICS) != 0)
 # else
 #  define IFUNC_COND_1	(false)
+#  define IFUNC_COND_2	(false)
 # endif
-# define IFUNC_NCOND(N)	(1)
+# define IFUNC_NCOND(N)	(1 + (N == 16))
 
 #endif /* HAVE_IFUNC */
 
+#if N == 16 && IFUNC_ALT == 1
+/* The compiler never expands 16-byte atomic loads and stores inline, and
+   the fallback through CAS writes to the location.  With LSE2, a plain
+   aligned LDP or STP is atomic, so only the barriers are needed.  */
+static inline UTYPE
+atomic_load_n (UTYPE *mptr, int smodel)
+{
+  uint64_t first, second;
+
+  if (smodel == __ATOMIC_SEQ_CST)
+    __asm__ __volatile__ ("dmb\tish" : : : "memory");
+  __asm__ __volatile__ ("ldp\t%0, %1, %2"
+			: "=r" (first), "=r" (second) : "Q" (*mptr)
+			: "memory");
+  if (smodel != __ATOMIC_RELAXED)
+    __asm__ __volatile__ ("dmb\tishld" : : : "memory");
+# ifdef __AARCH64EB__
+  return ((UTYPE) first << 64) | second;
+# else
+  return ((UTYPE) second << 64) | first;
+# endif
+}
+# define atomic_load_n atomic_load_n
+
+static inline void
+atomic_store_n (UTYPE *mptr, UTYPE newval, int smodel)
+{
+# ifdef __AARCH64EB__
+  uint64_t first = newval >> 64, second = newval;
+# else
+  uint64_t first = newval, second = newval >> 64;
+# endif
+
+  if (smodel != __ATOMIC_RELAXED)
+    __asm__ __volatile__ ("dmb\tish" : : : "memory");
+  __asm__ __volatile__ ("stp\t%1, %2, %0"
+			: "=Q" (*mptr) : "r" (first), "r" (second)
+			: "memory");
+  if (smodel == __ATOMIC_SEQ_CST)
+    __asm__ __volatile__ ("dmb\tish" : : : "memory");
+}
+# define atomic_store_n atomic_store_n
+#endif /* N == 16 && IFUNC_ALT == 1 */
+
 #include_next <host-config.h>
@@ -47,6 +47,28 @@ protect_end (void *ptr, UWORD dummy UNUSED)
 }
 
 # define protect_start_end 1
+
+/* Optimistic reads: take the sequence count of the lock of PTR with
+   protect_read_begin, copy the data without the lock, and use the copy
+   unless protect_read_retry says a writer got in the way.  */
+UWORD libat_seq_begin_1 (void *ptr);
+bool libat_seq_retry_1 (void *ptr, UWORD seq);
+UWORD libat_seq_begin_n (void *ptr, size_t n);
+bool libat_seq_retry_n (void *ptr, size_t n, UWORD seq);
+
+static inline UWORD
+protect_read_begin (void *ptr)
+{
+  return libat_seq_begin_1 (ptr);
+}
+
+static inline bool
+protect_read_retry (void *ptr, UWORD seq)
+{
+  return libat_seq_retry_1 (ptr, seq);
+}
+
+# define protect_read_begin_retry 1
 # ifdef HAVE_ATTRIBUTE_VISIBILITY
 #  pragma GCC visibility pop
 # endif
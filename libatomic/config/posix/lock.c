@@ -22,6 +22,8 @@
    see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
    <http://www.gnu.org/licenses/>.  */
 
+/* For PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP.  */
+#define _GNU_SOURCE 1
 #include "libatomic_i.h"
 #include <pthread.h>
 
@@ -45,17 +47,29 @@
 #define WATCH_SIZE	CACHLINE_SIZE
 #endif
 
+/* The critical sections are a few loads and stores, so where available
+   use mutexes that spin for a while before sleeping.  */
+#ifdef PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP
+# define LOCK_INITIALIZER	PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP
+#else
+# define LOCK_INITIALIZER	PTHREAD_MUTEX_INITIALIZER
+#endif
+
+/* Each lock also is a sequence lock: SEQ is odd while the mutex is held,
+   and is incremented again when it is released.  Readers copy the data
+   without taking the mutex, and retry if SEQ was odd or has changed.  */
 struct lock
 {
   pthread_mutex_t mutex;
-  char pad[sizeof(pthread_mutex_t) < CACHLINE_SIZE
-	   ? CACHLINE_SIZE - sizeof(pthread_mutex_t)
+  UWORD seq;
+  char pad[sizeof(pthread_mutex_t) + sizeof(UWORD) < CACHLINE_SIZE
+	   ? CACHLINE_SIZE - sizeof(pthread_mutex_t) - sizeof(UWORD)
 	   : 0];
 };
 
 #define NLOCKS		(PAGE_SIZE / WATCH_SIZE)
 static struct lock locks[NLOCKS] = {
-  [0 ... NLOCKS-1].mutex = PTHREAD_MUTEX_INITIALIZER
+  [0 ... NLOCKS-1].mutex = LOCK_INITIALIZER
 };
 
 static inline uintptr_t 
@@ -64,16 +78,48 @@ addr_hash (void *ptr)
   return ((uintptr_t)ptr / WATCH_SIZE) % NLOCKS;
 }
 
+static inline void
+lock_acquire (struct lock *l)
+{
+  pthread_mutex_lock (&l->mutex);
+  __atomic_store_n (&l->seq, l->seq + 1, __ATOMIC_RELAXED);
+  /* Keep the stores of the critical section after the increment.  */
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+}
+
+static inline void
+lock_release (struct lock *l)
+{
+  __atomic_store_n (&l->seq, l->seq + 1, __ATOMIC_RELEASE);
+  pthread_mutex_unlock (&l->mutex);
+}
+
 void
 libat_lock_1 (void *ptr)
 {
-  pthread_mutex_lock (&locks[addr_hash (ptr)].mutex);
+  lock_acquire (&locks[addr_hash (ptr)]);
 }
 
 void
 libat_unlock_1 (void *ptr)
 {
-  pthread_mutex_unlock (&locks[addr_hash (ptr)].mutex);
+  lock_release (&locks[addr_hash (ptr)]);
+}
+
+UWORD
+libat_seq_begin_1 (void *ptr)
+{
+  return __atomic_load_n (&locks[addr_hash (ptr)].seq, __ATOMIC_ACQUIRE);
+}
+
+bool
+libat_seq_retry_1 (void *ptr, UWORD seq)
+{
+  /* Keep the loads of the data before the check.  */
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  return ((seq & 1) != 0
+	  || __atomic_load_n (&locks[addr_hash (ptr)].seq,
+			      __ATOMIC_RELAXED) != seq);
 }
 
 void
@@ -88,7 +134,7 @@ libat_lock_n (void *ptr, size_t n)
 
   do
     {
-      pthread_mutex_lock (&locks[h].mutex);
+      lock_acquire (&locks[h]);
       if (++h == NLOCKS)
 	h = 0;
       i += WATCH_SIZE;
@@ -107,10 +153,51 @@ libat_unlock_n (void *ptr, size_t n)
 
   do
     {
-      pthread_mutex_unlock (&locks[h].mutex);
+      lock_release (&locks[h]);
+      if (++h == NLOCKS)
+	h = 0;
+      i += WATCH_SIZE;
+    }
+  while (i < n);
+}
+
+/* The sequence counts only ever increase, so the sum of those of all the
+   locks covering the data changes whenever one of them does.  An odd
+   count makes the read fail.  */
+
+static UWORD
+seq_sum_n (void *ptr, size_t n, int memmodel)
+{
+  uintptr_t h = addr_hash (ptr);
+  UWORD sum = 0, odd = 0;
+  size_t i = 0;
+
+  if (n > PAGE_SIZE)
+    n = PAGE_SIZE;
+
+  do
+    {
+      UWORD seq = __atomic_load_n (&locks[h].seq, memmodel);
+      sum += seq;
+      odd |= seq & 1;
       if (++h == NLOCKS)
 	h = 0;
       i += WATCH_SIZE;
     }
   while (i < n);
+
+  return odd ? 1 : sum;
+}
+
+UWORD
+libat_seq_begin_n (void *ptr, size_t n)
+{
+  return seq_sum_n (ptr, n, __ATOMIC_ACQUIRE);
+}
+
+bool
+libat_seq_retry_n (void *ptr, size_t n, UWORD seq)
+{
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  return (seq & 1) != 0 || seq_sum_n (ptr, n, __ATOMIC_RELAXED) != seq;
 }
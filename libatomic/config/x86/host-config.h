@@ -32,7 +32,7 @@
 #endif
 
 /* Value of the CPUID feature register FEAT1_REGISTER for the cmpxchg
-   bit for IFUNC_COND1 below.  */
+   and AVX bits for IFUNC_COND_1 and IFUNC_COND_2 below.  */
 extern unsigned int __libat_feat1 HIDDEN;
 
 /* Initialize libat_feat1 and return its value.  */
@@ -55,28 +55,35 @@ load_feat1 (void)
 }
 
 #ifdef __x86_64__
-# define IFUNC_COND_1	(load_feat1 () & bit_CMPXCHG16B)
+/* Alternative 1 additionally loads and stores with aligned 16-byte
+   vector moves, which are atomic on the CPUs that __libat_feat1_init
+   leaves bit_AVX set for.  Alternative 2 only has cmpxchg16b.  */
+# define IFUNC_COND_1	((load_feat1 () & (bit_AVX | bit_CMPXCHG16B)) \
+			 == (bit_AVX | bit_CMPXCHG16B))
+# define IFUNC_COND_2	(load_feat1 () & bit_CMPXCHG16B)
 #else
 # define IFUNC_COND_1	(load_feat1 () & bit_CMPXCHG8B)
 #endif
 
 #ifdef __x86_64__
-# define IFUNC_NCOND(N) (N == 16)
+# define IFUNC_NCOND(N) (2 * (N == 16))
 #else
 # define IFUNC_NCOND(N) (N == 8)
 #endif
 
 #ifdef __x86_64__
 # undef MAYBE_HAVE_ATOMIC_CAS_16
-# define MAYBE_HAVE_ATOMIC_CAS_16	IFUNC_COND_1
+# define MAYBE_HAVE_ATOMIC_CAS_16	IFUNC_COND_2
 # undef MAYBE_HAVE_ATOMIC_EXCHANGE_16
-# define MAYBE_HAVE_ATOMIC_EXCHANGE_16	IFUNC_COND_1
+# define MAYBE_HAVE_ATOMIC_EXCHANGE_16	IFUNC_COND_2
 # undef MAYBE_HAVE_ATOMIC_LDST_16
-# define MAYBE_HAVE_ATOMIC_LDST_16	IFUNC_COND_1
-/* Since load and store are implemented with CAS, they are not fast.  */
+# define MAYBE_HAVE_ATOMIC_LDST_16	IFUNC_COND_2
+/* Without AVX, load and store are implemented with CAS, so they are not
+   fast.  Keep answering the same either way, so that lock-freedom does
+   not depend on the CPU the program happens to run on.  */
 # undef FAST_ATOMIC_LDST_16
 # define FAST_ATOMIC_LDST_16		0
-# if IFUNC_ALT == 1
+# if IFUNC_ALT == 1 || IFUNC_ALT == 2
 #  undef HAVE_ATOMIC_CAS_16
 #  define HAVE_ATOMIC_CAS_16 1
 # endif
@@ -93,7 +100,7 @@ load_feat1 (void)
 # endif
 #endif
 
-#if defined(__x86_64__) && N == 16 && IFUNC_ALT == 1
+#if defined(__x86_64__) && N == 16 && (IFUNC_ALT == 1 || IFUNC_ALT == 2)
 static inline bool
 atomic_compare_exchange_n (UTYPE *mptr, UTYPE *eptr, UTYPE newval,
                            bool weak_p UNUSED, int sm UNUSED, int fm UNUSED)
@@ -108,6 +115,31 @@ atomic_compare_exchange_n (UTYPE *mptr, UTYPE *eptr, UTYPE newval,
 # define atomic_compare_exchange_n atomic_compare_exchange_n
 #endif /* Have CAS 16 */
 
+#if defined(__x86_64__) && N == 16 && IFUNC_ALT == 1
+/* The compiler never expands 16-byte atomic loads and stores inline, so
+   spell out the vector moves.  Loads are already ordered as acquire or
+   seq_cst on x86; seq_cst stores need a trailing fence.  */
+static inline UTYPE
+atomic_load_n (UTYPE *mptr, int smodel UNUSED)
+{
+  UTYPE ret;
+  __asm__ __volatile__ ("vmovdqa\t%1, %0" : "=x" (ret) : "m" (*mptr)
+			: "memory");
+  return ret;
+}
+# define atomic_load_n atomic_load_n
+
+static inline void
+atomic_store_n (UTYPE *mptr, UTYPE newval, int smodel)
+{
+  __asm__ __volatile__ ("vmovdqa\t%1, %0" : "=m" (*mptr) : "x" (newval)
+			: "memory");
+  if (smodel == __ATOMIC_SEQ_CST)
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+}
+# define atomic_store_n atomic_store_n
+#endif /* Have AVX 16-byte loads and stores */
+
 #endif /* HAVE_IFUNC */
 
 #include_next <host-config.h>
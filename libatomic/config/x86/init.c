@@ -34,6 +34,28 @@ __libat_feat1_init (void)
   unsigned int eax, ebx, ecx, edx;
   FEAT1_REGISTER = 0;
   __get_cpuid (1, &eax, &ebx, &ecx, &edx);
+#ifdef __x86_64__
+  /* Intel and AMD document that aligned 16-byte SSE and AVX loads and
+     stores are atomic on processors that support AVX.  Only advertise
+     AVX where that holds and the OS has enabled the AVX state.  */
+  if ((ecx & (bit_AVX | bit_OSXSAVE)) == (bit_AVX | bit_OSXSAVE))
+    {
+      unsigned int xcr0, vendor_ecx;
+
+      __asm__ ("xgetbv" : "=a" (xcr0), "=d" (edx) : "c" (0));
+      __cpuid (0, eax, ebx, vendor_ecx, edx);
+      if ((xcr0 & 6) != 6
+	  || !((ebx == signature_INTEL_ebx
+		&& vendor_ecx == signature_INTEL_ecx
+		&& edx == signature_INTEL_edx)
+	       || (ebx == signature_AMD_ebx
+		   && vendor_ecx == signature_AMD_ecx
+		   && edx == signature_AMD_edx)))
+	ecx &= ~bit_AVX;
+    }
+  else
+    ecx &= ~bit_AVX;
+#endif
   /* See the load in load_feat1.  */
   __atomic_store_n (&__libat_feat1, FEAT1_REGISTER, __ATOMIC_RELAXED);
   return FEAT1_REGISTER;
@@ -88,6 +88,19 @@ libat_load (size_t n, void *mptr, void *rptr, int smodel)
       return;
     }
 
+#ifdef protect_read_begin_retry
+  /* Try reading without the locks first, see load_n.c.  */
+  if (!maybe_specialcase_relaxed(smodel))
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+  for (int i = 0; i < SEQ_READ_TRIES; i++)
+    {
+      UWORD seq = libat_seq_begin_n (mptr, n);
+      memcpy (rptr, mptr, n);
+      if (!libat_seq_retry_n (mptr, n, seq))
+	return;
+    }
+#endif
+
   pre_seq_barrier (smodel);
   libat_lock_n (mptr, n);
 
@@ -33,6 +33,15 @@
 # define atomic_compare_exchange_w  __atomic_compare_exchange_n
 #endif
 
+/* Likewise, the target may know of loads and stores that are atomic
+   even though the compiler does not expand the builtins inline.  */
+#if !defined(atomic_load_n) && SIZE(HAVE_ATOMIC_LDST)
+# define atomic_load_n  __atomic_load_n
+#endif
+#if !defined(atomic_store_n) && SIZE(HAVE_ATOMIC_LDST)
+# define atomic_store_n  __atomic_store_n
+#endif
+
 /* For some targets, it may be significantly faster to avoid all barriers
    if the user only wants relaxed memory order.  Sometimes we don't want
    the extra code bloat.  In all cases, use the input to avoid warnings.  */
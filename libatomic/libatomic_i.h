@@ -156,6 +156,10 @@ void protect_end (void *ptr, UWORD);
 void libat_lock_n (void *ptr, size_t n);
 void libat_unlock_n (void *ptr, size_t n);
 
+/* Number of times a read without the lock is retried before taking it,
+   for targets that define protect_read_begin_retry.  */
+#define SEQ_READ_TRIES	4
+
 /* We'll need to declare all of the sized functions a few times...  */
 #define DECLARE_ALL_SIZED(N)  DECLARE_ALL_SIZED_(N,C2(U_,N))
 #define DECLARE_ALL_SIZED_(N,T)						\
@@ -25,18 +25,19 @@
 #include "libatomic_i.h"
 
 
-/* If we support the builtin, just use it.  */
-#if !DONE && SIZE(HAVE_ATOMIC_LDST)
+/* If we support the builtin, or the target provides an atomic access of
+   this size, just use it.  */
+#if !DONE && defined(atomic_load_n)
 UTYPE
 SIZE(libat_load) (UTYPE *mptr, int smodel)
 {
   if (maybe_specialcase_relaxed(smodel))
-    return __atomic_load_n (mptr, __ATOMIC_RELAXED);
+    return atomic_load_n (mptr, __ATOMIC_RELAXED);
   else if (maybe_specialcase_acqrel(smodel))
     /* Note that REL and ACQ_REL are not valid for loads.  */
-    return __atomic_load_n (mptr, __ATOMIC_ACQUIRE);
+    return atomic_load_n (mptr, __ATOMIC_ACQUIRE);
   else
-    return __atomic_load_n (mptr, __ATOMIC_SEQ_CST);
+    return atomic_load_n (mptr, __ATOMIC_SEQ_CST);
 }
 
 #define DONE 1
@@ -100,6 +101,23 @@ SIZE(libat_load) (UTYPE *mptr, int smodel)
   UTYPE ret;
   UWORD magic;
 
+#ifdef protect_read_begin_retry
+  /* Try reading without the lock first, so that readers don't contend
+     with each other.  The lock would have ordered the read after
+     earlier accesses, so do that with a fence instead.  */
+  int i;
+
+  if (!maybe_specialcase_relaxed(smodel))
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+  for (i = 0; i < SEQ_READ_TRIES; i++)
+    {
+      magic = protect_read_begin (mptr);
+      ret = *mptr;
+      if (!protect_read_retry (mptr, magic))
+	return ret;
+    }
+#endif
+
   pre_seq_barrier (smodel);
   magic = protect_start (mptr);
 
@@ -0,0 +1,90 @@
+/* Readers of objects too large to be lock-free must never see a store
+   half done, whether they read without the lock or fall back to it.  */
+/* { dg-do run } */
+/* { dg-options "-pthread" } */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define NREADERS 3
+#define ITERS 200000
+
+/* Within one lock granule, and spanning several.  */
+struct small { long a, b, c; };
+struct large { long v[24]; };
+
+static struct small small;
+static struct large large;
+static int done;
+
+static void *
+writer (void *arg)
+{
+  long i;
+  int j;
+
+  for (i = 1; i <= ITERS; i++)
+    {
+      struct small s = { i, i, i }, old;
+      struct large l;
+
+      for (j = 0; j < 24; j++)
+	l.v[j] = i;
+      __atomic_store (&small, &s, __ATOMIC_SEQ_CST);
+      __atomic_store (&large, &l, __ATOMIC_RELEASE);
+      if (i % 16 == 0)
+	{
+	  old = s;
+	  s.a = s.b = s.c = -i;
+	  if (!__atomic_compare_exchange (&small, &old, &s, false,
+					  __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+	    abort ();
+	}
+    }
+  __atomic_store_n (&done, 1, __ATOMIC_RELEASE);
+  return arg;
+}
+
+static void *
+reader (void *arg)
+{
+  long last = 0;
+  int j;
+
+  while (!__atomic_load_n (&done, __ATOMIC_ACQUIRE))
+    {
+      struct small s;
+      struct large l;
+
+      __atomic_load (&small, &s, __ATOMIC_SEQ_CST);
+      if (s.a != s.b || s.b != s.c)
+	abort ();
+      __atomic_load (&large, &l, __ATOMIC_ACQUIRE);
+      for (j = 1; j < 24; j++)
+	if (l.v[j] != l.v[0])
+	  abort ();
+      /* The writer's stores are ordered, so values never go back.  */
+      if (l.v[0] < last)
+	abort ();
+      last = l.v[0];
+    }
+  return arg;
+}
+
+int
+main (void)
+{
+  pthread_t w, r[NREADERS];
+  int i;
+
+  for (i = 0; i < NREADERS; i++)
+    if (pthread_create (&r[i], NULL, reader, NULL))
+      return 0;
+  if (pthread_create (&w, NULL, writer, NULL))
+    abort ();
+  pthread_join (w, NULL);
+  for (i = 0; i < NREADERS; i++)
+    pthread_join (r[i], NULL);
+  return 0;
+}
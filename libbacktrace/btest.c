@@ -458,6 +458,101 @@ test5 (void)
   return failures;
 }
 
+/* Test that looking up the same PC values again, which is answered
+   from the cache, gives the same results.  */
+
+static int test6 (void) __attribute__ ((noinline, noclone, unused));
+static int f42 (int) __attribute__ ((noinline, noclone));
+static int f43 (int, int) __attribute__ ((noinline, noclone));
+
+static int
+test6 (void)
+{
+  return f42 (__LINE__) + 1;
+}
+
+static int
+f42 (int f1line)
+{
+  return f43 (f1line, __LINE__) + 2;
+}
+
+static int
+f43 (int f1line, int f2line)
+{
+  uintptr_t addrs[20];
+  struct sdata data;
+  int f3line;
+  int i;
+
+  data.addrs = &addrs[0];
+  data.index = 0;
+  data.max = 20;
+  data.failed = 0;
+
+  f3line = __LINE__ + 1;
+  i = backtrace_simple (state, 0, callback_two, error_callback_two, &data);
+
+  if (i != 0)
+    {
+      fprintf (stderr, "test6: unexpected return value %d\n", i);
+      data.failed = 1;
+    }
+
+  if (!data.failed)
+    {
+      int pass;
+
+      for (pass = 0; pass < 3; ++pass)
+	{
+	  struct info all[20];
+	  struct bdata bdata;
+	  int j;
+
+	  bdata.all = &all[0];
+	  bdata.index = 0;
+	  bdata.max = 20;
+	  bdata.failed = 0;
+
+	  for (j = 0; j < 3; ++j)
+	    {
+	      i = backtrace_pcinfo (state, addrs[j], callback_one,
+				    error_callback_one, &bdata);
+	      if (i != 0)
+		{
+		  fprintf (stderr,
+			   ("test6: unexpected return value "
+			    "from backtrace_pcinfo %d\n"),
+			   i);
+		  bdata.failed = 1;
+		}
+	      if (!bdata.failed && bdata.index != (size_t) (j + 1))
+		{
+		  fprintf (stderr,
+			   ("test6: wrong number of calls from "
+			    "backtrace_pcinfo got %u expected %d\n"),
+			   (unsigned int) bdata.index, j + 1);
+		  bdata.failed = 1;
+		}
+	    }
+
+	  check ("test6", 0, all, f3line, "f43", "btest.c", &bdata.failed);
+	  check ("test6", 1, all, f2line, "f42", "btest.c", &bdata.failed);
+	  check ("test6", 2, all, f1line, "test6", "btest.c", &bdata.failed);
+
+	  if (bdata.failed)
+	    data.failed = 1;
+	}
+    }
+
+  printf ("%s: backtrace_pcinfo repeated\n", data.failed ? "FAIL" : "PASS");
+
+  if (data.failed)
+    ++failures;
+
+  return failures;
+}
+
 /* Check that are no files left open.  */
 
 static void
@@ -490,6 +585,7 @@ main (int argc ATTRIBUTE_UNUSED, char **argv)
   test2 ();
   test3 ();
   test4 ();
+  test6 ();
 #if BACKTRACE_SUPPORTS_DATA
   test5 ();
 #endif
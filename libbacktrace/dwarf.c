@@ -295,22 +295,30 @@ struct unit
   int is_dwarf64;
   /* Address size.  */
   int addrsize;
+  /* Absolute file name, only set if needed.  */
+  const char *abs_filename;
+
+  /* The fields above this point are read in during initialization and
+     may be accessed freely.  The fields below this point are read in
+     as needed, and therefore require care, as different threads may
+     try to initialize them simultaneously.  */
+
+  /* Whether the fields from LINEOFF to ABBREVS have been read: 0 if
+     not, 1 if they have, -1 if there was an error reading them, and 2
+     while some thread is reading them.  When the address map is built
+     from .debug_aranges, these fields are only read when the unit is
+     first used; otherwise they are read during initialization.  See
+     unit_init.  */
+  int initialized;
   /* Offset into line number information.  */
   off_t lineoff;
   /* Primary source file.  */
   const char *filename;
   /* Compilation command working directory.  */
   const char *comp_dir;
-  /* Absolute file name, only set if needed.  */
-  const char *abs_filename;
   /* The abbreviations for this unit.  */
   struct abbrevs abbrevs;
 
-  /* The fields above this point are read in during initialization and
-     may be accessed freely.  The fields below this point are read in
-     as needed, and therefore require care, as different threads may
-     try to initialize them simultaneously.  */
-
   /* PC to line number mapping.  This is NULL if the values have not
      been read.  This is (struct line *) -1 if there was an error
      reading the values.  */
@@ -376,6 +384,9 @@ struct dwarf_data
   /* The unparsed .debug_info section.  */
   const unsigned char *dwarf_info;
   size_t dwarf_info_size;
+  /* The unparsed .debug_abbrev section.  */
+  const unsigned char *dwarf_abbrev;
+  size_t dwarf_abbrev_size;
   /* The unparsed .debug_line section.  */
   const unsigned char *dwarf_line;
   size_t dwarf_line_size;
@@ -1011,9 +1022,9 @@ unit_addrs_compare (const void *v1, const void *v2)
     return 1;
   if (a1->high > a2->high)
     return -1;
-  if (a1->u->lineoff < a2->u->lineoff)
+  if (a1->u->low_offset < a2->u->low_offset)
     return -1;
-  if (a1->u->lineoff > a2->u->lineoff)
+  if (a1->u->low_offset > a2->u->low_offset)
     return 1;
   return 0;
 }
@@ -1335,8 +1346,9 @@ add_unit_ranges (struct backtrace_state *state, uintptr_t base_address,
 }
 
 /* Find the address range covered by a compilation unit, reading from
-   UNIT_BUF and adding values to U.  Returns 1 if all data could be
-   read, 0 if there is some error.  */
+   UNIT_BUF and adding values to U.  If ADDRS is NULL, only read the
+   attributes of the compilation unit DIE into U.  Returns 1 if all
+   data could be read, 0 if there is some error.  */
 
 static int
 find_address_ranges (struct backtrace_state *state, uintptr_t base_address,
@@ -1446,6 +1458,9 @@ find_address_ranges (struct backtrace_state *state, uintptr_t base_address,
 	    }
 	}
 
+      if (addrs == NULL)
+	return 1;
+
       if (abbrev->tag == DW_TAG_compile_unit
 	  || abbrev->tag == DW_TAG_subprogram)
 	{
@@ -1493,6 +1508,187 @@ find_address_ranges (struct backtrace_state *state, uintptr_t base_address,
   return 1;
 }
 
+/* Read the abbreviations of U and the attributes of its compilation
+   unit DIE.  Returns 1 on success, 0 on failure.  */
+
+static int
+read_unit_die (struct backtrace_state *state, struct dwarf_data *ddata,
+	       struct unit *u, backtrace_error_callback error_callback,
+	       void *data)
+{
+  struct dwarf_buf unit_buf;
+  uint64_t abbrev_offset;
+
+  /* The abbrev offset follows the version at the start of the unit
+     header.  */
+  unit_buf.name = ".debug_info";
+  unit_buf.start = ddata->dwarf_info;
+  unit_buf.buf = u->unit_data - u->unit_data_offset;
+  unit_buf.buf += u->is_dwarf64 ? 14 : 6;
+  unit_buf.left = u->unit_data_offset - (u->is_dwarf64 ? 14 : 6);
+  unit_buf.is_bigendian = ddata->is_bigendian;
+  unit_buf.error_callback = error_callback;
+  unit_buf.data = data;
+  unit_buf.reported_underflow = 0;
+
+  abbrev_offset = read_offset (&unit_buf, u->is_dwarf64);
+  if (!read_abbrevs (state, abbrev_offset, ddata->dwarf_abbrev,
+		     ddata->dwarf_abbrev_size, ddata->is_bigendian,
+		     error_callback, data, &u->abbrevs))
+    return 0;
+
+  unit_buf.buf = u->unit_data;
+  unit_buf.left = u->unit_data_len;
+  if (!find_address_ranges (state, ddata->base_address, &unit_buf,
+			    ddata->dwarf_str, ddata->dwarf_str_size,
+			    ddata->dwarf_ranges, ddata->dwarf_ranges_size,
+			    ddata->is_bigendian, ddata->altlink,
+			    error_callback, data, u, NULL, NULL)
+      || unit_buf.reported_underflow)
+    return 0;
+  return 1;
+}
+
+/* Make sure that the fields of U that are read as needed from its
+   compilation unit DIE have been read.  Returns 1 on success, 0 on
+   failure.  */
+
+static int
+unit_init (struct backtrace_state *state, struct dwarf_data *ddata,
+	   struct unit *u, backtrace_error_callback error_callback,
+	   void *data)
+{
+  int ret;
+
+  if (!state->threaded)
+    {
+      if (u->initialized == 0)
+	u->initialized = (read_unit_die (state, ddata, u, error_callback, data)
+			  ? 1 : -1);
+      return u->initialized > 0;
+    }
+
+  /* Only one thread may read the fields, as they are not updated
+     atomically.  Other threads wait for it, which should not take
+     long, as this is just a single DIE.  */
+  while (1)
+    {
+      ret = backtrace_atomic_load_int (&u->initialized);
+      if (ret == 1 || ret == -1)
+	return ret > 0;
+      if (ret == 0 && __sync_bool_compare_and_swap (&u->initialized, 0, 2))
+	{
+	  ret = read_unit_die (state, ddata, u, error_callback, data);
+	  backtrace_atomic_store_int (&u->initialized, ret ? 1 : -1);
+	  return ret;
+	}
+    }
+}
+
+/* Add the address ranges listed in the .debug_aranges section to
+   ADDRS.  Each range maps to the unit in UNITS whose offset the
+   section lists; mark the units that have ranges in COVERED.  A unit
+   that is not listed is not marked, and its ranges must be found in
+   .debug_info.  Returns 1 on success, 0 on failure.  */
+
+static int
+read_aranges (struct backtrace_state *state, uintptr_t base_address,
+	      const unsigned char *dwarf_aranges, size_t dwarf_aranges_size,
+	      int is_bigendian, struct unit **units, size_t units_count,
+	      char *covered, backtrace_error_callback error_callback,
+	      void *data, struct unit_addrs_vector *addrs)
+{
+  struct dwarf_buf aranges;
+
+  aranges.name = ".debug_aranges";
+  aranges.start = dwarf_aranges;
+  aranges.buf = dwarf_aranges;
+  aranges.left = dwarf_aranges_size;
+  aranges.is_bigendian = is_bigendian;
+  aranges.error_callback = error_callback;
+  aranges.data = data;
+  aranges.reported_underflow = 0;
+
+  while (aranges.left > 0)
+    {
+      const unsigned char *set_start;
+      uint64_t len;
+      int is_dwarf64;
+      struct dwarf_buf set_buf;
+      int version;
+      uint64_t info_offset;
+      int addrsize;
+      int segsize;
+      size_t align;
+      struct unit **pu;
+
+      if (aranges.reported_underflow)
+	return 0;
+
+      set_start = aranges.buf;
+      len = read_initial_length (&aranges, &is_dwarf64);
+      set_buf = aranges;
+      set_buf.left = len;
+
+      if (!advance (&aranges, len))
+	return 0;
+
+      version = read_uint16 (&set_buf);
+      info_offset = read_offset (&set_buf, is_dwarf64);
+      addrsize = read_byte (&set_buf);
+      segsize = read_byte (&set_buf);
+      if (set_buf.reported_underflow)
+	return 0;
+
+      /* Skip sets that we can't handle; their units will be
+	 handled by looking at .debug_info.  */
+      if (version != 2
+	  || segsize != 0
+	  || (addrsize != 1 && addrsize != 2 && addrsize != 4
+	      && addrsize != 8))
+	continue;
+
+      pu = ((struct unit **)
+	    bsearch (&info_offset, units, units_count,
+		     sizeof (struct unit *), units_search));
+      if (pu == NULL || (*pu)->low_offset != info_offset)
+	continue;
+
+      /* The tuples are aligned to twice the address size, relative to
+	 the start of the set.  */
+      align = (size_t) (set_buf.buf - set_start) % (2 * addrsize);
+      if (align != 0 && !advance (&set_buf, 2 * addrsize - align))
+	return 0;
+
+      while (set_buf.left > 0)
+	{
+	  uint64_t address;
+	  uint64_t length;
+	  struct unit_addrs a;
+
+	  address = read_address (&set_buf, addrsize);
+	  length = read_address (&set_buf, addrsize);
+	  if (set_buf.reported_underflow)
+	    return 0;
+	  if (address == 0 && length == 0)
+	    break;
+	  if (length == 0)
+	    continue;
+
+	  a.low = address;
+	  a.high = address + length;
+	  a.u = *pu;
+	  if (!add_unit_addr (state, base_address, a, error_callback, data,
+			      addrs))
+	    return 0;
+	}
+
+      covered[pu - units] = 1;
+    }
+
+  return 1;
+}
+
 /* Build a mapping from address ranges to the compilation units where
    the line number information for that range can be found.  Returns 1
    on success, 0 on failure.  */
@@ -1503,6 +1699,8 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
 		   const unsigned char *dwarf_abbrev, size_t dwarf_abbrev_size,
 		   const unsigned char *dwarf_ranges, size_t dwarf_ranges_size,
 		   const unsigned char *dwarf_str, size_t dwarf_str_size,
+		   const unsigned char *dwarf_aranges,
+		   size_t dwarf_aranges_size,
 		   int is_bigendian, struct dwarf_data *altlink,
 		   backtrace_error_callback error_callback, void *data,
 		   struct unit_addrs_vector *addrs,
@@ -1514,15 +1712,25 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
   size_t i;
   struct unit **pu;
   size_t unit_offset = 0;
+  int lazy;
+  char *covered;
 
   memset (&addrs->vec, 0, sizeof addrs->vec);
   memset (&unit_vec->vec, 0, sizeof unit_vec->vec);
   addrs->count = 0;
   unit_vec->count = 0;
+  covered = NULL;
+
+  /* If there is a .debug_aranges section, we take the address ranges
+     of the units from there, and only read the unit headers from
+     .debug_info here.  The abbrevs and the compilation unit DIE of a
+     unit are then read when the unit is first used, which avoids
+     parsing all of .debug_info before we can look up the first PC.
+     gdb and addr2line don't trust .debug_aranges to be complete, so
+     units that are not listed there are still read now.  */
+  lazy = dwarf_aranges != NULL && dwarf_aranges_size > 0;
 
-  /* Read through the .debug_info section.  FIXME: Should we use the
-     .debug_aranges section?  gdb and addr2line don't use it, but I'm
-     not sure why.  */
+  /* Read through the .debug_info section.  */
 
   info.name = ".debug_info";
   info.start = dwarf_info;
@@ -1583,8 +1791,10 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
 
       memset (&u->abbrevs, 0, sizeof u->abbrevs);
       abbrev_offset = read_offset (&unit_buf, is_dwarf64);
-      if (!read_abbrevs (state, abbrev_offset, dwarf_abbrev, dwarf_abbrev_size,
-			 is_bigendian, error_callback, data, &u->abbrevs))
+      if (!lazy
+	  && !read_abbrevs (state, abbrev_offset, dwarf_abbrev,
+			    dwarf_abbrev_size, is_bigendian, error_callback,
+			    data, &u->abbrevs))
 	goto fail;
 
       addrsize = read_byte (&unit_buf);
@@ -1609,6 +1819,13 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
       u->function_addrs = NULL;
       u->function_addrs_count = 0;
 
+      if (lazy)
+	{
+	  u->initialized = 0;
+	  continue;
+	}
+      u->initialized = 1;
+
       if (!find_address_ranges (state, base_address, &unit_buf,
 				dwarf_str, dwarf_str_size,
 				dwarf_ranges, dwarf_ranges_size,
@@ -1622,11 +1839,69 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
   if (info.reported_underflow)
     goto fail;
 
+  if (lazy && units_count > 0)
+    {
+      struct dwarf_data ddata;
+
+      covered = ((char *)
+		 backtrace_alloc (state, units_count, error_callback, data));
+      if (covered == NULL)
+	goto fail;
+      memset (covered, 0, units_count);
+
+      pu = (struct unit **) units.base;
+      if (!read_aranges (state, base_address, dwarf_aranges,
+			 dwarf_aranges_size, is_bigendian, pu, units_count,
+			 covered, error_callback, data, addrs))
+	goto fail;
+
+      /* Read the units that .debug_aranges does not cover now, to find
+	 their address ranges.  */
+      memset (&ddata, 0, sizeof ddata);
+      ddata.altlink = altlink;
+      ddata.dwarf_info = dwarf_info;
+      ddata.dwarf_info_size = dwarf_info_size;
+      ddata.dwarf_abbrev = dwarf_abbrev;
+      ddata.dwarf_abbrev_size = dwarf_abbrev_size;
+      ddata.dwarf_str = dwarf_str;
+      ddata.dwarf_str_size = dwarf_str_size;
+      ddata.is_bigendian = is_bigendian;
+      for (i = 0; i < units_count; i++)
+	{
+	  struct dwarf_buf unit_buf;
+	  struct unit *u;
+
+	  if (covered[i])
+	    continue;
+
+	  u = pu[i];
+	  if (!read_unit_die (state, &ddata, u, error_callback, data))
+	    goto fail;
+	  u->initialized = 1;
+
+	  unit_buf = info;
+	  unit_buf.buf = u->unit_data;
+	  unit_buf.left = u->unit_data_len;
+	  if (!find_address_ranges (state, base_address, &unit_buf,
+				    dwarf_str, dwarf_str_size,
+				    dwarf_ranges, dwarf_ranges_size,
+				    is_bigendian, altlink, error_callback,
+				    data, u, addrs, NULL))
+	    goto fail;
+	  if (unit_buf.reported_underflow)
+	    goto fail;
+	}
+
+      backtrace_free (state, covered, units_count, error_callback, data);
+    }
+
   unit_vec->vec = units;
   unit_vec->count = units_count;
   return 1;
 
  fail:
+  if (covered != NULL)
+    backtrace_free (state, covered, units_count, error_callback, data);
   if (units_count > 0)
     {
       pu = (struct unit **) units.base;
@@ -2154,14 +2429,16 @@ read_line_info (struct backtrace_state *state, struct dwarf_data *ddata,
   return 0;
 }
 
-static const char *read_referenced_name (struct dwarf_data *, struct unit *,
+static const char *read_referenced_name (struct backtrace_state *,
+					 struct dwarf_data *, struct unit *,
 					 uint64_t, backtrace_error_callback,
 					 void *);
 
 /* Read the name of a function from a DIE referenced by ATTR with VAL.  */
 
 static const char *
-read_referenced_name_from_attr (struct dwarf_data *ddata, struct unit *u,
+read_referenced_name_from_attr (struct backtrace_state *state,
+				struct dwarf_data *ddata, struct unit *u,
 				struct attr *attr, struct attr_val *val,
 				backtrace_error_callback error_callback,
 				void *data)
@@ -2183,27 +2460,32 @@ read_referenced_name_from_attr (struct dwarf_data *ddata, struct unit *u,
       struct unit *unit
 	= find_unit (ddata->units, ddata->units_count,
 		     val->u.uint);
-      if (unit == NULL)
+      if (unit == NULL
+	  || !unit_init (state, ddata, unit, error_callback, data))
 	return NULL;
 
       uint64_t offset = val->u.uint - unit->low_offset;
-      return read_referenced_name (ddata, unit, offset, error_callback, data);
+      return read_referenced_name (state, ddata, unit, offset,
+				   error_callback, data);
     }
 
   if (val->encoding == ATTR_VAL_UINT
       || val->encoding == ATTR_VAL_REF_UNIT)
-    return read_referenced_name (ddata, u, val->u.uint, error_callback, data);
+    return read_referenced_name (state, ddata, u, val->u.uint,
+				 error_callback, data);
 
   if (val->encoding == ATTR_VAL_REF_ALT_INFO)
     {
       struct unit *alt_unit
 	= find_unit (ddata->altlink->units, ddata->altlink->units_count,
 		     val->u.uint);
-      if (alt_unit == NULL)
+      if (alt_unit == NULL
+	  || !unit_init (state, ddata->altlink, alt_unit, error_callback,
+			 data))
 	return NULL;
 
       uint64_t offset = val->u.uint - alt_unit->low_offset;
-      return read_referenced_name (ddata->altlink, alt_unit, offset,
+      return read_referenced_name (state, ddata->altlink, alt_unit, offset,
 				   error_callback, data);
     }
 
@@ -2215,9 +2497,9 @@ read_referenced_name_from_attr (struct dwarf_data *ddata, struct unit *u,
    the same compilation unit.  */
 
 static const char *
-read_referenced_name (struct dwarf_data *ddata, struct unit *u,
-		      uint64_t offset, backtrace_error_callback error_callback,
-		      void *data)
+read_referenced_name (struct backtrace_state *state, struct dwarf_data *ddata,
+		      struct unit *u, uint64_t offset,
+		      backtrace_error_callback error_callback, void *data)
 {
   struct dwarf_buf unit_buf;
   uint64_t code;
@@ -2296,8 +2578,9 @@ read_referenced_name (struct dwarf_data *ddata, struct unit *u,
 	  {
 	    const char *name;
 
-	    name = read_referenced_name_from_attr (ddata, u, &abbrev->attrs[i],
-						   &val, error_callback, data);
+	    name = read_referenced_name_from_attr (state, ddata, u,
+						   &abbrev->attrs[i], &val,
+						   error_callback, data);
 	    if (name != NULL)
 	      ret = name;
 	  }
@@ -2529,7 +2812,7 @@ read_function_entry (struct backtrace_state *state, struct dwarf_data *ddata,
 		    const char *name;
 
 		    name
-		      = read_referenced_name_from_attr (ddata, u,
+		      = read_referenced_name_from_attr (state, ddata, u,
 							&abbrev->attrs[i], &val,
 							error_callback, data);
 		    if (name != NULL)
@@ -2884,8 +3167,13 @@ dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
 
       function_addrs = NULL;
       function_addrs_count = 0;
-      if (read_line_info (state, ddata, error_callback, data, entry->u, &lhdr,
-			  &lines, &count))
+      if (!unit_init (state, ddata, entry->u, error_callback, data))
+	{
+	  lines = (struct line *) (uintptr_t) -1;
+	  count = 0;
+	}
+      else if (read_line_info (state, ddata, error_callback, data, entry->u,
+			       &lhdr, &lines, &count))
 	{
 	  struct function_vector *pfvec;
 
@@ -3087,6 +3375,8 @@ build_dwarf_data (struct backtrace_state *state,
 		  size_t dwarf_ranges_size,
 		  const unsigned char *dwarf_str,
 		  size_t dwarf_str_size,
+		  const unsigned char *dwarf_aranges,
+		  size_t dwarf_aranges_size,
 		  int is_bigendian,
 		  struct dwarf_data *altlink,
 		  backtrace_error_callback error_callback,
@@ -3103,8 +3393,9 @@ build_dwarf_data (struct backtrace_state *state,
   if (!build_address_map (state, base_address, dwarf_info, dwarf_info_size,
 			  dwarf_abbrev, dwarf_abbrev_size, dwarf_ranges,
 			  dwarf_ranges_size, dwarf_str, dwarf_str_size,
-			  is_bigendian, altlink, error_callback, data,
-			  &addrs_vec, &units_vec))
+			  dwarf_aranges, dwarf_aranges_size, is_bigendian,
+			  altlink, error_callback, data, &addrs_vec,
+			  &units_vec))
     return NULL;
 
   if (!backtrace_vector_release (state, &addrs_vec.vec, error_callback, data))
@@ -3134,6 +3425,8 @@ build_dwarf_data (struct backtrace_state *state,
   fdata->units_count = units_count;
   fdata->dwarf_info = dwarf_info;
   fdata->dwarf_info_size = dwarf_info_size;
+  fdata->dwarf_abbrev = dwarf_abbrev;
+  fdata->dwarf_abbrev_size = dwarf_abbrev_size;
   fdata->dwarf_line = dwarf_line;
   fdata->dwarf_line_size = dwarf_line_size;
   fdata->dwarf_ranges = dwarf_ranges;
@@ -3163,6 +3456,8 @@ backtrace_dwarf_add (struct backtrace_state *state,
 		     size_t dwarf_ranges_size,
 		     const unsigned char *dwarf_str,
 		     size_t dwarf_str_size,
+		     const unsigned char *dwarf_aranges,
+		     size_t dwarf_aranges_size,
 		     int is_bigendian,
 		     struct dwarf_data *fileline_altlink,
 		     backtrace_error_callback error_callback,
@@ -3174,7 +3469,8 @@ backtrace_dwarf_add (struct backtrace_state *state,
   fdata = build_dwarf_data (state, base_address, dwarf_info, dwarf_info_size,
 			    dwarf_line, dwarf_line_size, dwarf_abbrev,
 			    dwarf_abbrev_size, dwarf_ranges, dwarf_ranges_size,
-			    dwarf_str, dwarf_str_size, is_bigendian,
+			    dwarf_str, dwarf_str_size, dwarf_aranges,
+			    dwarf_aranges_size, is_bigendian,
 			    fileline_altlink, error_callback, data);
   if (fdata == NULL)
     return 0;
@@ -179,6 +179,7 @@ dl_iterate_phdr (int (*callback) (struct dl_phdr_info *,
 #undef STT_FUNC
 #undef NT_GNU_BUILD_ID
 #undef ELFCOMPRESS_ZLIB
+#undef ELFCOMPRESS_ZSTD
 
 /* Basic types.  */
 
@@ -336,6 +337,7 @@ typedef struct
 #endif /* BACKTRACE_ELF_SIZE != 32 */
 
 #define ELFCOMPRESS_ZLIB 1
+#define ELFCOMPRESS_ZSTD 2
 
 /* An index of ELF sections we care about.  */
 
@@ -346,6 +348,7 @@ enum debug_section
   DEBUG_ABBREV,
   DEBUG_RANGES,
   DEBUG_STR,
+  DEBUG_ARANGES,
 
   /* The old style compressed sections.  This list must correspond to
      the list of normal debug sections.  */
@@ -354,6 +357,7 @@ enum debug_section
   ZDEBUG_ABBREV,
   ZDEBUG_RANGES,
   ZDEBUG_STR,
+  ZDEBUG_ARANGES,
 
   DEBUG_MAX
 };
@@ -367,11 +371,13 @@ static const char * const debug_section_names[DEBUG_MAX] =
   ".debug_abbrev",
   ".debug_ranges",
   ".debug_str",
+  ".debug_aranges",
   ".zdebug_info",
   ".zdebug_line",
   ".zdebug_abbrev",
   ".zdebug_ranges",
-  ".zdebug_str"
+  ".zdebug_str",
+  ".zdebug_aranges"
 };
 
 /* Information we gather for the sections we care about.  */
@@ -2497,6 +2503,1299 @@ elf_zlib_inflate_and_verify (const unsigned char *pin, size_t sin,
   return 1;
 }
 
+/* The zstd format, used by --compress-debug-sections=zstd, is defined
+   by RFC 8878.  We support what is needed for debug sections: a
+   sequence of frames, possibly with checksums, but without
+   dictionaries.  Since we have the whole output buffer, we don't need
+   to care about the window size.  */
+
+#define ZSTD_MAGIC 0xfd2fb528
+#define ZSTD_SKIPPABLE_MAGIC 0x184d2a50
+#define ZSTD_SKIPPABLE_MASK 0xfffffff0
+
+/* The maximum size of a block, and therefore of its literals.  */
+
+#define ZSTD_BLOCK_SIZE_MAX (128 * 1024)
+
+/* The maximum accuracy logs of the FSE tables, and the maximum number
+   of bits of a Huffman code for literals.  */
+
+#define ZSTD_LL_LOG_MAX 9
+#define ZSTD_ML_LOG_MAX 9
+#define ZSTD_OF_LOG_MAX 8
+#define ZSTD_WEIGHT_LOG_MAX 6
+#define ZSTD_HUFFMAN_BITS_MAX 11
+
+/* An entry in an FSE decoding table.  The next state is BASE plus
+   BITS bits read from the stream.  */
+
+struct elf_zstd_fse_entry
+{
+  unsigned char symbol;
+  unsigned char bits;
+  uint16_t base;
+};
+
+/* An FSE decoding table, with its accuracy log.  VALID is zero until
+   the table has been set up in the current frame.  */
+
+struct elf_zstd_fse_table
+{
+  struct elf_zstd_fse_entry *entries;
+  int log;
+  int valid;
+};
+
+/* Work space for decompressing a zstd stream.  The tables carry over
+   from one block to the next within a frame.  */
+
+struct elf_zstd_workspace
+{
+  struct elf_zstd_fse_entry ll_entries[1 << ZSTD_LL_LOG_MAX];
+  struct elf_zstd_fse_entry ml_entries[1 << ZSTD_ML_LOG_MAX];
+  struct elf_zstd_fse_entry of_entries[1 << ZSTD_OF_LOG_MAX];
+  /* The Huffman table for literals: the symbol in the high byte, the
+     number of bits in the low byte.  */
+  uint16_t huffman[1 << ZSTD_HUFFMAN_BITS_MAX];
+  int huffman_bits;
+  unsigned char literals[ZSTD_BLOCK_SIZE_MAX];
+};
+
+/* The predefined distributions for literal lengths, match lengths and
+   offsets.  */
+
+static const int16_t elf_zstd_ll_default[36] =
+{
+  4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+  -1, -1, -1, -1
+};
+
+static const int16_t elf_zstd_ml_default[53] =
+{
+  1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+  -1, -1, -1, -1, -1
+};
+
+static const int16_t elf_zstd_of_default[29] =
+{
+  1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+};
+
+/* Baselines and numbers of extra bits of the literal length and match
+   length codes.  */
+
+static const uint32_t elf_zstd_ll_base[36] =
+{
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+  16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096,
+  8192, 16384, 32768, 65536
+};
+
+static const unsigned char elf_zstd_ll_bits[36] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+  13, 14, 15, 16
+};
+
+static const uint32_t elf_zstd_ml_base[53] =
+{
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+  19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+  35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051,
+  4099, 8195, 16387, 32771, 65539
+};
+
+static const unsigned char elf_zstd_ml_bits[53] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+  12, 13, 14, 15, 16
+};
+
+/* A function useful for setting a breakpoint for a zstd failure when
+   this code is compiled with -g.  */
+
+static void
+elf_zstd_failed (void)
+{
+}
+
+/* Return the index of the highest bit set in V, which must not be
+   zero.  */
+
+static int
+elf_zstd_highbit (uint32_t v)
+{
+  return 31 - __builtin_clz (v);
+}
+
+/* Read a little-endian value of SIZE bytes, at most 8, from P.  */
+
+static uint64_t
+elf_zstd_read_le (const unsigned char *p, int size)
+{
+  uint64_t v;
+  int i;
+
+  v = 0;
+  for (i = size - 1; i >= 0; --i)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+/* Return N bits, N <= 32, of the SIZE bytes at P, starting at bit POS
+   counted from the least significant bit of the first byte.  Bits
+   past the end read as zero.  */
+
+static uint32_t
+elf_zstd_bits (const unsigned char *p, size_t size, size_t pos, int n)
+{
+  size_t byte;
+  int off;
+  uint64_t val;
+
+  if (n == 0)
+    return 0;
+  byte = pos >> 3;
+  off = pos & 7;
+  if (byte + 8 <= size)
+    val = elf_zstd_read_le (p + byte, 8);
+  else if (byte < size)
+    val = elf_zstd_read_le (p + byte, size - byte);
+  else
+    val = 0;
+  return (uint32_t) ((val >> off) & (((uint64_t) 1 << n) - 1));
+}
+
+/* A bit stream that is read backward, as used for Huffman coded
+   literals and for sequences.  */
+
+struct elf_zstd_backward
+{
+  const unsigned char *start;
+  size_t size;
+  /* The number of bits that have not been read yet.  This becomes
+     negative if we read past the start, which is only an error if
+     the caller says so.  */
+  int64_t pos;
+};
+
+/* Start reading the SIZE bytes at P backward.  The last byte holds a
+   marker bit above the first bit to read.  Returns 1 on success, 0 on
+   error.  */
+
+static int
+elf_zstd_backward_init (struct elf_zstd_backward *b, const unsigned char *p,
+			size_t size)
+{
+  if (unlikely (size == 0 || p[size - 1] == 0))
+    {
+      elf_zstd_failed ();
+      return 0;
+    }
+  b->start = p;
+  b->size = size;
+  b->pos = (int64_t) (size - 1) * 8 + elf_zstd_highbit (p[size - 1]);
+  return 1;
+}
+
+/* Return the next N bits of B without consuming them.  Bits before
+   the start of the stream read as zero.  */
+
+static uint32_t
+elf_zstd_backward_peek (const struct elf_zstd_backward *b, int n)
+{
+  if (b->pos >= n)
+    return elf_zstd_bits (b->start, b->size, b->pos - n, n);
+  if (b->pos <= 0)
+    return 0;
+  return (elf_zstd_bits (b->start, b->size, 0, (int) b->pos)
+	  << (n - (int) b->pos));
+}
+
+/* Read N bits from B.  */
+
+static uint32_t
+elf_zstd_backward_read (struct elf_zstd_backward *b, int n)
+{
+  uint32_t v;
+
+  v = elf_zstd_backward_peek (b, n);
+  b->pos -= n;
+  return v;
+}
+
+/* Read an FSE table description from the SIZE bytes at P into NORM,
+   which has room for MAXSYM + 1 symbols.  Sets *PNSYM to the number
+   of symbols, *PLOG to the accuracy log, and *PCONSUMED to the number
+   of bytes read.  Returns 1 on success, 0 on error.  */
+
+static int
+elf_zstd_read_fse (const unsigned char *p, size_t size, int maxsym,
+		   int maxlog, int16_t *norm, int *pnsym, int *plog,
+		   size_t *pconsumed)
+{
+  size_t pos;
+  int log;
+  int remaining;
+  int threshold;
+  int nbits;
+  int sym;
+
+  if (unlikely (size == 0))
+    {
+      elf_zstd_failed ();
+      return 0;
+    }
+
+  log = (p[0] & 0xf) + 5;
+  if (unlikely (log > maxlog))
+    {
+      elf_zstd_failed ();
+      return 0;
+    }
+  pos = 4;
+
+  remaining = (1 << log) + 1;
+  threshold = 1 << log;
+  nbits = log + 1;
+  sym = 0;
+  while (remaining > 1)
+    {
+      int max;
+      uint32_t v;
+      int count;
+
+      if (unlikely (sym > maxsym))
+	{
+	  elf_zstd_failed ();
+	  return 0;
+	}
+
+      max = 2 * threshold - 1 - remaining;
+      v = elf_zstd_bits (p, size, pos, nbits);
+      if ((int) (v & (threshold - 1)) < max)
+	{
+	  count = v & (threshold - 1);
+	  pos += nbits - 1;
+	}
+      else
+	{
+	  count = v & (2 * threshold - 1);
+	  if (count >= threshold)
+	    count -= max;
+	  pos += nbits;
+	}
+
+      /* The value read is the probability plus one, where -1 means a
+	 probability below one.  */
+      --count;
+      remaining -= count < 0 ? -count : count;
+      norm[sym++] = count;
+
+      /* A zero probability is followed by two bit repeat flags
+	 saying how many more symbols have zero probability.  */
+      if (count == 0)
+	{
+	  while (1)
+	    {
+	      uint32_t repeat;
+	      uint32_t i;
+
+	      repeat = elf_zstd_bits (p, size, pos, 2);
+	      pos += 2;
+	      if (unlikely (sym + (int) repeat > maxsym + 1))
+		{
+		  elf_zstd_failed ();
+		  return 0;
+		}
+	      for (i = 0; i < repeat; ++i)
+		norm[sym++] = 0;
+	      if (repeat != 3)
+		break;
+	    }
+	}
+
+      while (remaining < threshold)
+	{
+	  --nbits;
+	  threshold >>= 1;
+	}
+    }
+
+  if (unlikely (remaining != 1 || pos > size * 8))
+    {
+      elf_zstd_failed ();
+      return 0;
+    }
+
+  *pnsym = sym;
+  *plog = log;
+  *pconsumed = (pos + 7) / 8;
+  return 1;
+}
+
+/* Build the FSE decoding table for the NSYM probabilities in NORM,
+   with accuracy log LOG, into TABLE.  Returns 1 on success, 0 on
+   error.  */
+
+static int
+elf_zstd_build_fse (const int16_t *norm, int nsym, int log,
+		    struct elf_zstd_fse_table *table)
+{
+  struct elf_zstd_fse_entry *entries;
+  uint16_t next[64];
+  size_t size;
+  size_t high;
+  size_t pos;
+  size_t step;
+  size_t u;
+  int s;
+
+  if (unlikely (nsym > 64))
+    {
+      elf_zstd_failed ();
+      return 0;
+    }
+
+  entries = table->entries;
+  size = (size_t) 1 << log;
+  high = size - 1;
+
+  /* Symbols with a probability below one go at the end.  */
+  for (s = 0; s < nsym; ++s)
+    {
+      if (norm[s] == -1)
+	{
+	  entries[high--].symbol = s;
+	  next[s] = 1;
+	}
+      else
+	next[s] = norm[s];
+    }
+
+  /* Spread the other symbols over the table.  */
+  pos = 0;
+  step = (size >> 1) + (size >> 3) + 3;
+  for (s = 0; s < nsym; ++s)
+    {
+      int i;
+
+      for (i = 0; i < norm[s]; ++i)
+	{
+	  entries[pos].symbol = s;
+	  do
+	    pos = (pos + step) & (size - 1);
+	  while (pos > high);
+	}
+    }
+  if (unlikely (pos != 0))
+    {
+      elf_zstd_failed ();
+      return 0;
+    }
+
+  for (u = 0; u < size; ++u)
+    {
+      uint32_t n;
+      int bits;
+
+      n = next[entries[u].symbol]++;
+      bits = log - elf_zstd_highbit (n);
+      entries[u].bits = bits;
+      entries[u].base = (n << bits) - size;
+    }
+
+  table->log = log;
+  table->valid = 1;
+  return 1;
+}
+
+/* Set up TABLE for the compression mode MODE of a sequence code, from
+   the SIZE bytes at P.  DEFAULT_NORM and DEFAULT_LOG are the
+   predefined distribution.  Sets *PCONSUMED to the number of bytes
+   read.  Returns 1 on success, 0 on error.  */
+
+static int
+elf_zstd_setup_fse (int mode, const unsigned char *p, size_t size,
+		    const int16_t *default_norm, int default_nsym,
+		    int default_log, int maxsym, int maxlog,
+		    struct elf_zstd_fse_table *table, size_t *pconsumed)
+{
+  int16_t norm[64];
+  int nsym;
+  int log;
+
+  *pconsumed = 0;
+  switch (mode)
+    {
+    case 0:
+      /* Predefined mode.  */
+      return elf_zstd_build_fse (default_norm, default_nsym, default_log,
+				 table);
+
+    case 1:
+      /* RLE mode: a single symbol, with no bits to read.  */
+      if (unlikely (size < 1 || p[0] > maxsym))
+	break;
+      table->entries[0].symbol = p[0];
+      table->entries[0].bits = 0;
+      table->entries[0].base = 0;
+      table->log = 0;
+      table->valid = 1;
+      *pconsumed = 1;
+      return 1;
+
+    case 2:
+      /* FSE compressed mode.  */
+      if (!elf_zstd_read_fse (p, size, maxsym, maxlog, norm, &nsym, &log,
+			      pconsumed))
+	return 0;
+      return elf_zstd_build_fse (norm, nsym, log, table);
+
+    case 3:
+      /* Repeat mode.  */
+      if (table->valid)
+	return 1;
+      break;
+    }
+
+  elf_zstd_failed ();
+  return 0;
+}
+
+/* Read the Huffman tree description for literals from the SIZE bytes
+   at P into WS.  Sets *PCONSUMED to the number of bytes read.  Returns
+   1 on success, 0 on error.  */
+
+static int
+elf_zstd_read_huffman (const unsigned char *p, size_t size,
+		       struct elf_zstd_workspace *ws, size_t *pconsumed)
+{
+  unsigned char weights[256];
+  size_t nweights;
+  uint32_t counts[ZSTD_HUFFMAN_BITS_MAX + 1];
+  uint32_t start[ZSTD_HUFFMAN_BITS_MAX + 1];
+  uint32_t total;
+  uint32_t rest;
+  int bits;
+  size_t i;
+  int w;
+
+  if (unlikely (size == 0))
+    {
+      elf_zstd_failed ();
+      return 0;
+    }
+
+  if (p[0] < 128)
+    {
+      /* The weights are FSE compressed, using two interleaved
+	 states.  */
+      size_t csize;
+      struct elf_zstd_fse_entry entries[1 << ZSTD_WEIGHT_LOG_MAX];
+      struct elf_zstd_fse_table table;
+      int16_t norm[64];
+      int nsym;
+      int log;
+      size_t consumed;
+      struct elf_zstd_backward b;
+      uint32_t state1;
+      uint32_t state2;
+
+      csize = p[0];
+      if (unlikely (csize + 1 > size))
+	{
+	  elf_zstd_failed ();
+	  return 0;
+	}
+      if (!elf_zstd_read_fse (p + 1, csize, 15, ZSTD_WEIGHT_LOG_MAX, norm,
+			      &nsym, &log, &consumed))
+	return 0;
+      table.entries = entries;
+      if (!elf_zstd_build_fse (norm, nsym, log, &table))
+	return 0;
+      if (!elf_zstd_backward_init (&b, p + 1 + consumed, csize - consumed))
+	return 0;
+
+      state1 = elf_zstd_backward_read (&b, log);
+      state2 = elf_zstd_backward_read (&b, log);
+      /* When the stream runs out after updating one state, the
+	 symbol of the other state is the last weight.  There are at
+	 most 255 weights, as the last one is implied.  */
+      nweights = 0;
+      while (1)
+	{
+	  if (unlikely (nweights + 2 > 255))
+	    {
+	      elf_zstd_failed ();
+	      return 0;
+	    }
+	  weights[nweights++] = entries[state1].symbol;
+	  state1 = (entries[state1].base
+		    + elf_zstd_backward_read (&b, entries[state1].bits));
+	  if (b.pos < 0)
+	    {
+	      weights[nweights++] = entries[state2].symbol;
+	      break;
+	    }
+	  weights[nweights++] = entries[state2].symbol;
+	  state2 = (entries[state2].base
+		    + elf_zstd_backward_read (&b, entries[state2].bits));
+	  if (b.pos < 0)
+	    {
+	      if (unlikely (nweights + 1 > 255))
+		{
+		  elf_zstd_failed ();
+		  return 0;
+		}
+	      weights[nweights++] = entries[state1].symbol;
+	      break;
+	    }
+	}
+
+      *pconsumed = 1 + csize;
+    }
+  else
+    {
+      /* The weights are stored directly, four bits each.  */
+      nweights = p[0] - 127;
+      if (unlikely (1 + (nweights + 1) / 2 > size))
+	{
+	  elf_zstd_failed ();
+	  return 0;
+	}
+      for (i = 0; i < nweights; ++i)
+	{
+	  unsigned char c;
+
+	  c = p[1 + i / 2];
+	  weights[i] = (i & 1) == 0 ? c >> 4 : c & 0xf;
+	}
+      *pconsumed = 1 + (nweights + 1) / 2;
+    }
+
+  /* The weight of the last symbol is implied: it brings the total to
+     the next power of two.  */
+  memset (counts, 0, sizeof counts);
+  total = 0;
+  for (i = 0; i < nweights; ++i)
+    {
+      if (unlikely (weights[i] > ZSTD_HUFFMAN_BITS_MAX))
+	{
+	  elf_zstd_failed ();
+	  return 0;
+	}
+      if (weights[i] > 0)
+	total += (uint32_t) 1 << (weights[i] - 1);
+    }
+  if (unlikely (total == 0))
+    {
+      elf_zstd_failed ();
+      return 0;
+    }
+  bits = elf_zstd_highbit (total) + 1;
+  rest = ((uint32_t) 1 << bits) - total;
+  if (unlikely (bits > ZSTD_HUFFMAN_BITS_MAX || (rest & (rest - 1)) != 0))
+    {
+      elf_zstd_failed ();
+      return 0;
+    }
+  weights[nweights++] = elf_zstd_highbit (rest) + 1;
+
+  for (i = 0; i < nweights; ++i)
+    ++counts[weights[i]];
+
+  /* Symbols with the lowest weight, and so the longest code, come
+     first in the table.  */
+  total = 0;
+  for (w = 1; w <= bits; ++w)
+    {
+      start[w] = total;
+      total += counts[w] << (w - 1);
+    }
+
+  for (i = 0; i < nweights; ++i)
+    {
+      uint32_t len;
+      uint16_t entry;
+      uint32_t j;
+
+      w = weights[i];
+      if (w == 0)
+	continue;
+      len = (uint32_t) 1 << (w - 1);
+      entry = (uint16_t) ((i << 8) | (bits + 1 - w));
+      for (j = 0; j < len; ++j)
+	ws->huffman[start[w] + j] = entry;
+      start[w] += len;
+    }
+
+  ws->huffman_bits = bits;
+  return 1;
+}
+
+/* Decode COUNT literals from the Huffman coded stream in the SIZE
+   bytes at P into POUT.  Returns 1 on success, 0 on error.  */
+
+static int
+elf_zstd_read_huffman_stream (const unsigned char *p, size_t size,
+			      const struct elf_zstd_workspace *ws,
+			      unsigned char *pout, size_t count)
+{
+  struct elf_zstd_backward b;
+  int bits;
+  size_t i;
+
+  if (!elf_zstd_backward_init (&b, p, size))
+    return 0;
+  bits = ws->huffman_bits;
+  for (i = 0; i < count; ++i)
+    {
+      uint16_t entry;
+
+      entry = ws->huffman[elf_zstd_backward_peek (&b, bits)];
+      pout[i] = entry >> 8;
+      b.pos -= entry & 0xff;
+    }
+  if (unlikely (b.pos != 0))
+    {
+      elf_zstd_failed ();
+      return 0;
+    }
+  return 1;
+}
+
+/* Read the literals section of a block from the SIZE bytes at P.
+   Sets *PLITERALS and *PCOUNT to the literals, which either point into
+   the input or into WS, and *PCONSUMED to the number of bytes read.
+   Returns 1 on success, 0 on error.  */
+
+static int
+elf_zstd_read_literals (const unsigned char *p, size_t size,
+			struct elf_zstd_workspace *ws,
+			const unsigned char **pliterals, size_t *pcount,
+			size_t *pconsumed)
+{
+  int type;
+  int format;
+  size_t hsize;
+  size_t regen;
+  size_t csize;
+  int nbits;
+  uint64_t h;
+  const unsigned char *q;
+  size_t consumed;
+
+  if (unlikely (size == 0))
+    {
+      elf_zstd_failed ();
+      return 0;
+    }
+
+  type = p[0] & 3;
+  format = (p[0] >> 2) & 3;
+
+  if (type <= 1)
+    {
+      /* Raw or RLE literals.  */
+      switch (format)
+	{
+	case 0: case 2:
+	  hsize = 1;
+	  regen = p[0] >> 3;
+	  break;
+	case 1:
+	  hsize = 2;
+	  if (unlikely (size < hsize))
+	    goto fail;
+	  regen = (p[0] >> 4) + ((size_t) p[1] << 4);
+	  break;
+	default:
+	  hsize = 3;
+	  if (unlikely (size < hsize))
+	    goto fail;
+	  regen = ((p[0] >> 4) + ((size_t) p[1] << 4)
+		   + ((size_t) p[2] << 12));
+	  break;
+	}
+      if (unlikely (regen > ZSTD_BLOCK_SIZE_MAX))
+	goto fail;
+
+      if (type == 0)
+	{
+	  if (unlikely (size - hsize < regen))
+	    goto fail;
+	  *pliterals = p + hsize;
+	  *pconsumed = hsize + regen;
+	}
+      else
+	{
+	  if (unlikely (size - hsize < 1))
+	    goto fail;
+	  memset (ws->literals, p[hsize], regen);
+	  *pliterals = ws->literals;
+	  *pconsumed = hsize + 1;
+	}
+      *pcount = regen;
+      return 1;
+    }
+
+  /* Huffman coded literals, with a new tree (type 2) or with the tree
+     of the previous block (type 3), in one or four streams.  */
+  hsize = format <= 1 ? 3 : format == 2 ? 4 : 5;
+  nbits = format <= 1 ? 10 : format == 2 ? 14 : 18;
+  if (unlikely (size < hsize))
+    goto fail;
+  h = elf_zstd_read_le (p, hsize);
+  regen = (h >> 4) & ((1U << nbits) - 1);
+  csize = (h >> (4 + nbits)) & ((1U << nbits) - 1);
+  if (unlikely (regen > ZSTD_BLOCK_SIZE_MAX || size - hsize < csize))
+    goto fail;
+
+  q = p + hsize;
+  if (type == 2)
+    {
+      if (!elf_zstd_read_huffman (q, csize, ws, &consumed))
+	return 0;
+      q += consumed;
+      csize -= consumed;
+    }
+  else if (unlikely (ws->huffman_bits == 0))
+    goto fail;
+
+  if (format == 0)
+    {
+      if (!elf_zstd_read_huffman_stream (q, csize, ws, ws->literals, regen))
+	return 0;
+    }
+  else
+    {
+      size_t sizes[4];
+      size_t segment;
+      size_t i;
+      unsigned char *pout;
+
+      if (unlikely (csize < 6))
+	goto fail;
+      sizes[0] = elf_zstd_read_le (q, 2);
+      sizes[1] = elf_zstd_read_le (q + 2, 2);
+      sizes[2] = elf_zstd_read_le (q + 4, 2);
+      q += 6;
+      csize -= 6;
+      if (unlikely (sizes[0] + sizes[1] + sizes[2] > csize))
+	goto fail;
+      sizes[3] = csize - sizes[0] - sizes[1] - sizes[2];
+
+      segment = (regen + 3) / 4;
+      if (unlikely (segment * 3 > regen))
+	goto fail;
+      pout = ws->literals;
+      for (i = 0; i < 4; ++i)
+	{
+	  size_t count;
+
+	  count = i < 3 ? segment : regen - 3 * segment;
+	  if (!elf_zstd_read_huffman_stream (q, sizes[i], ws, pout, count))
+	    return 0;
+	  q += sizes[i];
+	  pout += count;
+	}
+    }
+
+  *pliterals = ws->literals;
+  *pcount = regen;
+  *pconsumed = q - p + (format == 0 ? csize : 0);
+  return 1;
+
+ fail:
+  elf_zstd_failed ();
+  return 0;
+}
+
+/* Decompress a compressed block from the SIZE bytes at P, writing to
+   *PPOUT, up to POUTEND.  FRAME_START is the start of the output of
+   the current frame, which is as far back as matches may go.  REPS
+   holds the repeated offsets.  Returns 1 on success, 0 on error.  */
+
+static int
+elf_zstd_block (const unsigned char *p, size_t size,
+		struct elf_zstd_workspace *ws,
+		struct elf_zstd_fse_table *ll_table,
+		struct elf_zstd_fse_table *of_table,
+		struct elf_zstd_fse_table *ml_table,
+		uint32_t *reps, unsigned char *frame_start,
+		unsigned char **ppout, unsigned char *poutend)
+{
+  const unsigned char *literals;
+  size_t literals_count;
+  const unsigned char *literals_end;
+  size_t consumed;
+  size_t nseq;
+  int modes;
+  struct elf_zstd_backward b;
+  uint32_t ll_state;
+  uint32_t of_state;
+  uint32_t ml_state;
+  unsigned char *pout;
+  size_t i;
+
+  if (!elf_zstd_read_literals (p, size, ws, &literals, &literals_count,
+			       &consumed))
+    return 0;
+  p += consumed;
+  size -= consumed;
+  literals_end = literals + literals_count;
+  pout = *ppout;
+
+  /* The number of sequences.  */
+  if (unlikely (size < 1))
+    goto fail;
+  if (p[0] < 128)
+    {
+      nseq = p[0];
+      consumed = 1;
+    }
+  else if (p[0] < 255)
+    {
+      if (unlikely (size < 2))
+	goto fail;
+      nseq = ((size_t) (p[0] - 128) << 8) + p[1];
+      consumed = 2;
+    }
+  else
+    {
+      if (unlikely (size < 3))
+	goto fail;
+      nseq = p[1] + ((size_t) p[2] << 8) + 0x7f00;
+      consumed = 3;
+    }
+  p += consumed;
+  size -= consumed;
+
+  if (nseq == 0)
+    {
+      if (unlikely ((size_t) (poutend - pout) < literals_count))
+	goto fail;
+      memcpy (pout, literals, literals_count);
+      *ppout = pout + literals_count;
+      return 1;
+    }
+
+  if (unlikely (size < 1))
+    goto fail;
+  modes = p[0];
+  if (unlikely ((modes & 3) != 0))
+    goto fail;
+  ++p;
+  --size;
+
+  if (!elf_zstd_setup_fse ((modes >> 6) & 3, p, size, elf_zstd_ll_default,
+			   36, 6, 35, ZSTD_LL_LOG_MAX, ll_table, &consumed))
+    return 0;
+  p += consumed;
+  size -= consumed;
+  if (!elf_zstd_setup_fse ((modes >> 4) & 3, p, size, elf_zstd_of_default,
+			   29, 5, 31, ZSTD_OF_LOG_MAX, of_table, &consumed))
+    return 0;
+  p += consumed;
+  size -= consumed;
+  if (!elf_zstd_setup_fse ((modes >> 2) & 3, p, size, elf_zstd_ml_default,
+			   53, 6, 52, ZSTD_ML_LOG_MAX, ml_table, &consumed))
+    return 0;
+  p += consumed;
+  size -= consumed;
+
+  if (!elf_zstd_backward_init (&b, p, size))
+    return 0;
+  ll_state = elf_zstd_backward_read (&b, ll_table->log);
+  of_state = elf_zstd_backward_read (&b, of_table->log);
+  ml_state = elf_zstd_backward_read (&b, ml_table->log);
+
+  for (i = 0; i < nseq; ++i)
+    {
+      const struct elf_zstd_fse_entry *ll_entry;
+      const struct elf_zstd_fse_entry *of_entry;
+      const struct elf_zstd_fse_entry *ml_entry;
+      uint32_t offset_value;
+      uint32_t offset;
+      uint32_t match;
+      uint32_t lit;
+
+      ll_entry = &ll_table->entries[ll_state];
+      of_entry = &of_table->entries[of_state];
+      ml_entry = &ml_table->entries[ml_state];
+
+      /* The extra bits come in the order offset, match length,
+	 literal length.  */
+      offset_value = (((uint32_t) 1 << of_entry->symbol)
+		      + elf_zstd_backward_read (&b, of_entry->symbol));
+      match = (elf_zstd_ml_base[ml_entry->symbol]
+	       + elf_zstd_backward_read (&b,
+					 elf_zstd_ml_bits[ml_entry->symbol]));
+      lit = (elf_zstd_ll_base[ll_entry->symbol]
+	     + elf_zstd_backward_read (&b,
+				       elf_zstd_ll_bits[ll_entry->symbol]));
+
+      /* Offset values 1 to 3 refer to the repeated offsets, shifted
+	 by one if there are no literals.  */
+      if (offset_value > 3)
+	{
+	  offset = offset_value - 3;
+	  reps[2] = reps[1];
+	  reps[1] = reps[0];
+	  reps[0] = offset;
+	}
+      else
+	{
+	  uint32_t index;
+
+	  index = offset_value - 1 + (lit == 0 ? 1 : 0);
+	  if (index == 0)
+	    offset = reps[0];
+	  else
+	    {
+	      offset = index == 3 ? reps[0] - 1 : reps[index];
+	      if (index != 1)
+		reps[2] = reps[1];
+	      reps[1] = reps[0];
+	      reps[0] = offset;
+	    }
+	}
+
+      if (i + 1 < nseq)
+	{
+	  /* The states are updated in the order literal length, match
+	     length, offset.  */
+	  ll_state = (ll_entry->base
+		      + elf_zstd_backward_read (&b, ll_entry->bits));
+	  ml_state = (ml_entry->base
+		      + elf_zstd_backward_read (&b, ml_entry->bits));
+	  of_state = (of_entry->base
+		      + elf_zstd_backward_read (&b, of_entry->bits));
+	}
+
+      if (unlikely ((size_t) (literals_end - literals) < lit
+		    || (size_t) (poutend - pout) < (size_t) lit + match))
+	goto fail;
+      memcpy (pout, literals, lit);
+      literals += lit;
+      pout += lit;
+
+      if (unlikely (offset == 0 || (size_t) (pout - frame_start) < offset))
+	goto fail;
+      if (offset >= match)
+	{
+	  memcpy (pout, pout - offset, match);
+	  pout += match;
+	}
+      else
+	{
+	  /* The match overlaps the output, repeating the last OFFSET
+	     bytes.  */
+	  while (match-- > 0)
+	    {
+	      *pout = *(pout - offset);
+	      ++pout;
+	    }
+	}
+    }
+
+  if (unlikely (b.pos != 0))
+    goto fail;
+
+  /* Copy the literals after the last sequence.  */
+  if (unlikely ((size_t) (poutend - pout)
+		< (size_t) (literals_end - literals)))
+    goto fail;
+  memcpy (pout, literals, literals_end - literals);
+  pout += literals_end - literals;
+
+  *ppout = pout;
+  return 1;
+
+ fail:
+  elf_zstd_failed ();
+  return 0;
+}
+
+/* Compute the XXH64 hash, with seed zero, of the SIZE bytes at P.
+   zstd frames use the low 32 bits as a checksum.  */
+
+#define XXH_PRIME64_1 0x9e3779b185ebca87ULL
+#define XXH_PRIME64_2 0xc2b2ae3d27d4eb4fULL
+#define XXH_PRIME64_3 0x165667b19e3779f9ULL
+#define XXH_PRIME64_4 0x85ebca77c2b2ae63ULL
+#define XXH_PRIME64_5 0x27d4eb2f165667c5ULL
+
+static uint64_t
+elf_xxh64_rotl (uint64_t v, int r)
+{
+  return (v << r) | (v >> (64 - r));
+}
+
+static uint64_t
+elf_xxh64_round (uint64_t acc, uint64_t input)
+{
+  acc += input * XXH_PRIME64_2;
+  acc = elf_xxh64_rotl (acc, 31);
+  return acc * XXH_PRIME64_1;
+}
+
+static uint64_t
+elf_xxh64_merge (uint64_t acc, uint64_t val)
+{
+  acc ^= elf_xxh64_round (0, val);
+  return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+static uint64_t
+elf_xxh64 (const unsigned char *p, size_t size)
+{
+  const unsigned char *pend;
+  uint64_t h;
+
+  pend = p + size;
+  if (size >= 32)
+    {
+      uint64_t v1, v2, v3, v4;
+
+      v1 = XXH_PRIME64_1 + XXH_PRIME64_2;
+      v2 = XXH_PRIME64_2;
+      v3 = 0;
+      v4 = -XXH_PRIME64_1;
+      while (pend - p >= 32)
+	{
+	  v1 = elf_xxh64_round (v1, elf_zstd_read_le (p, 8));
+	  v2 = elf_xxh64_round (v2, elf_zstd_read_le (p + 8, 8));
+	  v3 = elf_xxh64_round (v3, elf_zstd_read_le (p + 16, 8));
+	  v4 = elf_xxh64_round (v4, elf_zstd_read_le (p + 24, 8));
+	  p += 32;
+	}
+      h = (elf_xxh64_rotl (v1, 1) + elf_xxh64_rotl (v2, 7)
+	   + elf_xxh64_rotl (v3, 12) + elf_xxh64_rotl (v4, 18));
+      h = elf_xxh64_merge (h, v1);
+      h = elf_xxh64_merge (h, v2);
+      h = elf_xxh64_merge (h, v3);
+      h = elf_xxh64_merge (h, v4);
+    }
+  else
+    h = XXH_PRIME64_5;
+
+  h += size;
+
+  while (pend - p >= 8)
+    {
+      h ^= elf_xxh64_round (0, elf_zstd_read_le (p, 8));
+      h = elf_xxh64_rotl (h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+      p += 8;
+    }
+  if (pend - p >= 4)
+    {
+      h ^= elf_zstd_read_le (p, 4) * XXH_PRIME64_1;
+      h = elf_xxh64_rotl (h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+      p += 4;
+    }
+  while (p < pend)
+    {
+      h ^= *p * XXH_PRIME64_5;
+      h = elf_xxh64_rotl (h, 11) * XXH_PRIME64_1;
+      ++p;
+    }
+
+  h ^= h >> 33;
+  h *= XXH_PRIME64_2;
+  h ^= h >> 29;
+  h *= XXH_PRIME64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+/* Decompress the zstd stream from PIN/SIN to POUT/SOUT, verifying
+   the frame checksums if present.  WS is work space.  Returns 1 on
+   success, 0 on error.  */
+
+static int
+elf_zstd_decompress (const unsigned char *pin, size_t sin,
+		     struct elf_zstd_workspace *ws, unsigned char *pout,
+		     size_t sout)
+{
+  unsigned char *poutend;
+
+  poutend = pout + sout;
+  while (sin > 0)
+    {
+      uint32_t magic;
+      int descriptor;
+      int fcs_size;
+      int did_size;
+      int has_checksum;
+      size_t hsize;
+      uint64_t fcs;
+      unsigned char *frame_start;
+      struct elf_zstd_fse_table ll_table;
+      struct elf_zstd_fse_table of_table;
+      struct elf_zstd_fse_table ml_table;
+      uint32_t reps[3];
+      int last;
+
+      if (unlikely (sin < 4))
+	goto fail;
+      magic = elf_zstd_read_le (pin, 4);
+
+      if ((magic & ZSTD_SKIPPABLE_MASK) == ZSTD_SKIPPABLE_MAGIC)
+	{
+	  uint32_t skip;
+
+	  if (unlikely (sin < 8))
+	    goto fail;
+	  skip = elf_zstd_read_le (pin + 4, 4);
+	  if (unlikely (sin - 8 < skip))
+	    goto fail;
+	  pin += 8 + skip;
+	  sin -= 8 + skip;
+	  continue;
+	}
+
+      if (unlikely (magic != ZSTD_MAGIC || sin < 5))
+	goto fail;
+
+      /* The frame header.  */
+      descriptor = pin[4];
+      if (unlikely ((descriptor & 0x08) != 0))
+	goto fail;
+      has_checksum = (descriptor & 0x04) != 0;
+      did_size = (descriptor & 3) == 3 ? 4 : descriptor & 3;
+      switch (descriptor >> 6)
+	{
+	case 0:
+	  fcs_size = (descriptor & 0x20) != 0 ? 1 : 0;
+	  break;
+	case 1:
+	  fcs_size = 2;
+	  break;
+	case 2:
+	  fcs_size = 4;
+	  break;
+	default:
+	  fcs_size = 8;
+	  break;
+	}
+      hsize = 5 + ((descriptor & 0x20) != 0 ? 0 : 1) + did_size + fcs_size;
+      if (unlikely (sin < hsize))
+	goto fail;
+
+      /* We don't support dictionaries.  */
+      if (unlikely (did_size > 0
+		    && elf_zstd_read_le (pin + hsize - fcs_size - did_size,
+					 did_size) != 0))
+	goto fail;
+
+      fcs = elf_zstd_read_le (pin + hsize - fcs_size, fcs_size);
+      if (fcs_size == 2)
+	fcs += 256;
+
+      pin += hsize;
+      sin -= hsize;
+
+      frame_start = pout;
+      ll_table.entries = ws->ll_entries;
+      ll_table.valid = 0;
+      of_table.entries = ws->of_entries;
+      of_table.valid = 0;
+      ml_table.entries = ws->ml_entries;
+      ml_table.valid = 0;
+      ws->huffman_bits = 0;
+      reps[0] = 1;
+      reps[1] = 4;
+      reps[2] = 8;
+
+      do
+	{
+	  uint32_t bhdr;
+	  size_t bsize;
+
+	  if (unlikely (sin < 3))
+	    goto fail;
+	  bhdr = elf_zstd_read_le (pin, 3);
+	  pin += 3;
+	  sin -= 3;
+	  last = bhdr & 1;
+	  bsize = bhdr >> 3;
+
+	  switch ((bhdr >> 1) & 3)
+	    {
+	    case 0:
+	      /* Raw block.  */
+	      if (unlikely (sin < bsize
+			    || (size_t) (poutend - pout) < bsize))
+		goto fail;
+	      memcpy (pout, pin, bsize);
+	      pout += bsize;
+	      pin += bsize;
+	      sin -= bsize;
+	      break;
+
+	    case 1:
+	      /* RLE block: BSIZE is the number of times to repeat one
+		 byte.  */
+	      if (unlikely (sin < 1
+			    || (size_t) (poutend - pout) < bsize))
+		goto fail;
+	      memset (pout, pin[0], bsize);
+	      pout += bsize;
+	      pin += 1;
+	      sin -= 1;
+	      break;
+
+	    case 2:
+	      if (unlikely (sin < bsize || bsize > ZSTD_BLOCK_SIZE_MAX))
+		goto fail;
+	      if (!elf_zstd_block (pin, bsize, ws, &ll_table, &of_table,
+				   &ml_table, reps, frame_start, &pout,
+				   poutend))
+		return 0;
+	      pin += bsize;
+	      sin -= bsize;
+	      break;
+
+	    default:
+	      goto fail;
+	    }
+	}
+      while (!last);
+
+      if (unlikely (fcs_size > 0 && (uint64_t) (pout - frame_start) != fcs))
+	goto fail;
+
+      if (has_checksum)
+	{
+	  if (unlikely (sin < 4))
+	    goto fail;
+	  if (unlikely ((uint32_t) elf_xxh64 (frame_start, pout - frame_start)
+			!= elf_zstd_read_le (pin, 4)))
+	    goto fail;
+	  pin += 4;
+	  sin -= 4;
+	}
+    }
+
+  if (unlikely (pout != poutend))
+    goto fail;
+
+  return 1;
+
+ fail:
+  elf_zstd_failed ();
+  return 0;
+}
+
 /* Uncompress the old compressed debug format, the one emitted by
    --compress-debug-sections=zlib-gnu.  The compressed data is in
    COMPRESSED / COMPRESSED_SIZE, and the function writes to
@@ -2550,13 +3849,14 @@ elf_uncompress_zdebug (struct backtrace_state *state,
 }
 
 /* Uncompress the new compressed debug format, the official standard
-   ELF approach emitted by --compress-debug-sections=zlib-gabi.  The
-   compressed data is in COMPRESSED / COMPRESSED_SIZE, and the
-   function writes to *UNCOMPRESSED / *UNCOMPRESSED_SIZE.
-   ZDEBUG_TABLE is work space as for elf_uncompress_zdebug.  Returns 0
-   on error, 1 on successful decompression or if something goes wrong.
-   In general we try to carry on, by returning 1, even if we can't
-   decompress.  */
+   ELF approach emitted by --compress-debug-sections=zlib-gabi or
+   --compress-debug-sections=zstd.  The compressed data is in
+   COMPRESSED / COMPRESSED_SIZE, and the function writes to
+   *UNCOMPRESSED / *UNCOMPRESSED_SIZE.  ZDEBUG_TABLE is work space as
+   for elf_uncompress_zdebug; zstd needs more, which we allocate here.
+   Returns 0 on error, 1 on successful decompression or if something
+   goes wrong.  In general we try to carry on, by returning 1, even if
+   we can't decompress.  */
 
 static int
 elf_uncompress_chdr (struct backtrace_state *state,
@@ -2577,7 +3877,8 @@ elf_uncompress_chdr (struct backtrace_state *state,
 
   chdr = (const b_elf_chdr *) compressed;
 
-  if (chdr->ch_type != ELFCOMPRESS_ZLIB)
+  if (chdr->ch_type != ELFCOMPRESS_ZLIB
+      && chdr->ch_type != ELFCOMPRESS_ZSTD)
     {
       /* Unsupported compression algorithm.  */
       return 1;
@@ -2593,9 +3894,25 @@ elf_uncompress_chdr (struct backtrace_state *state,
 	return 0;
     }
 
-  if (!elf_zlib_inflate_and_verify (compressed + sizeof (b_elf_chdr),
-				    compressed_size - sizeof (b_elf_chdr),
-				    zdebug_table, po, chdr->ch_size))
+  if (chdr->ch_type == ELFCOMPRESS_ZSTD)
+    {
+      struct elf_zstd_workspace *ws;
+      int ok;
+
+      ws = ((struct elf_zstd_workspace *)
+	    backtrace_alloc (state, sizeof *ws, error_callback, data));
+      if (ws == NULL)
+	return 0;
+      ok = elf_zstd_decompress (compressed + sizeof (b_elf_chdr),
+				compressed_size - sizeof (b_elf_chdr),
+				ws, po, chdr->ch_size);
+      backtrace_free (state, ws, sizeof *ws, error_callback, data);
+      if (!ok)
+	return 1;
+    }
+  else if (!elf_zlib_inflate_and_verify (compressed + sizeof (b_elf_chdr),
+					 compressed_size - sizeof (b_elf_chdr),
+					 zdebug_table, po, chdr->ch_size))
     return 1;
 
   *uncompressed = po;
@@ -2630,6 +3947,30 @@ backtrace_uncompress_zdebug (struct backtrace_state *state,
   return ret;
 }
 
+/* This function is a hook for testing the zstd support.  It is only
+   used by tests.  The uncompressed size must be known.  */
+
+int
+backtrace_uncompress_zstd (struct backtrace_state *state,
+			   const unsigned char *compressed,
+			   size_t compressed_size,
+			   backtrace_error_callback error_callback,
+			   void *data, unsigned char *uncompressed,
+			   size_t uncompressed_size)
+{
+  struct elf_zstd_workspace *ws;
+  int ret;
+
+  ws = ((struct elf_zstd_workspace *)
+	backtrace_alloc (state, sizeof *ws, error_callback, data));
+  if (ws == NULL)
+    return 0;
+  ret = elf_zstd_decompress (compressed, compressed_size, ws,
+			     uncompressed, uncompressed_size);
+  backtrace_free (state, ws, sizeof *ws, error_callback, data);
+  return ret;
+}
+
 /* Add the backtrace data for one ELF file.  Returns 1 on success,
    0 on failure (in both cases descriptor is closed) or -1 if exe
    is non-zero and the ELF file is ET_DYN, which tells the caller that
@@ -3267,6 +4608,8 @@ elf_add (struct backtrace_state *state, const char *filename, int descriptor,
 			    sections[DEBUG_RANGES].size,
 			    sections[DEBUG_STR].data,
 			    sections[DEBUG_STR].size,
+			    sections[DEBUG_ARANGES].data,
+			    sections[DEBUG_ARANGES].size,
 			    ehdr.e_ident[EI_DATA] == ELFDATA2MSB,
 			    fileline_altlink,
 			    error_callback, data, fileline_fn,
@@ -37,6 +37,7 @@ POSSIBILITY OF SUCH DAMAGE.  */
 #include <errno.h>
 #include <fcntl.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "backtrace.h"
@@ -46,6 +47,197 @@ POSSIBILITY OF SUCH DAMAGE.  */
 #define getexecname() NULL
 #endif
 
+/* A cache of the results of backtrace_pcinfo, so that a profiler that
+   looks up the same hot PC values over and over does not search the
+   debug info each time.  The cache is a direct mapped table of
+   PC_CACHE_SIZE entries, allocated once when the file/line information
+   is initialized.  It does not take any locks, so that it may be used
+   from a signal handler: each entry is guarded by a sequence number
+   that is odd while the entry is being written.  A reader that sees an
+   odd sequence number, or a sequence number that changed while it was
+   copying the entry, treats the lookup as a miss.  A writer that finds
+   the entry busy simply does not cache its result.
+
+   The strings recorded in the cache point into the debug info, which
+   is never freed, so they remain valid for the life of the state.  */
+
+#ifdef HAVE_SYNC_FUNCTIONS
+
+/* The number of entries in the cache.  This must be a power of 2.  */
+
+#define PC_CACHE_SIZE 1024
+
+/* The maximum number of frames, counting inlined functions, that we
+   record for a single PC.  Lookups that produce more frames than
+   this are not cached.  */
+
+#define PC_CACHE_FRAMES 4
+
+/* One file/line result.  */
+
+struct pc_cache_frame
+{
+  const char *filename;
+  int lineno;
+  const char *function;
+};
+
+/* One cache entry.  */
+
+struct pc_cache_entry
+{
+  /* The sequence number; odd while the entry is being changed.  */
+  int seq;
+  /* The number of valid entries in FRAMES; 0 if the entry is empty.  */
+  int count;
+  /* The PC that this entry describes.  */
+  uintptr_t pc;
+  /* The results, outermost inlined function last.  */
+  struct pc_cache_frame frames[PC_CACHE_FRAMES];
+};
+
+struct backtrace_pc_cache
+{
+  struct pc_cache_entry entries[PC_CACHE_SIZE];
+};
+
+/* Data passed through to pc_cache_record_callback and
+   pc_cache_record_error_callback when filling a cache entry.  */
+
+struct pc_cache_record
+{
+  /* The caller's callbacks and data.  */
+  backtrace_full_callback callback;
+  backtrace_error_callback error_callback;
+  void *data;
+  /* The number of frames seen so far.  */
+  int count;
+  /* Set if the result should not be cached.  */
+  int failed;
+  /* The frames seen so far.  */
+  struct pc_cache_frame frames[PC_CACHE_FRAMES];
+};
+
+/* Allocate the cache for STATE if we can.  It is not an error if we
+   can't; we just don't cache anything.  */
+
+static void
+pc_cache_initialize (struct backtrace_state *state)
+{
+  struct backtrace_pc_cache *cache;
+
+  if (state->pc_cache != NULL)
+    return;
+
+  cache = ((struct backtrace_pc_cache *)
+	   backtrace_alloc (state, sizeof *cache, NULL, NULL));
+  if (cache == NULL)
+    return;
+  memset (cache, 0, sizeof *cache);
+
+  if (!state->threaded)
+    state->pc_cache = cache;
+  else if (!__sync_bool_compare_and_swap (&state->pc_cache, NULL, cache))
+    backtrace_free (state, cache, sizeof *cache, NULL, NULL);
+}
+
+/* Return the cache entry for PC.  */
+
+static struct pc_cache_entry *
+pc_cache_entry (struct backtrace_pc_cache *cache, uintptr_t pc)
+{
+  uintptr_t h;
+
+  h = pc ^ (pc >> 10) ^ (pc >> 20);
+  return &cache->entries[h & (PC_CACHE_SIZE - 1)];
+}
+
+/* Look up PC in the cache.  On a hit copy the frames into *FRAMES and
+   return the number of frames.  On a miss return 0.  */
+
+static int
+pc_cache_lookup (struct backtrace_pc_cache *cache, uintptr_t pc,
+		 struct pc_cache_frame *frames)
+{
+  struct pc_cache_entry *e;
+  int seq;
+  int count;
+  int i;
+
+  e = pc_cache_entry (cache, pc);
+  seq = backtrace_atomic_load_int (&e->seq);
+  if ((seq & 1) != 0)
+    return 0;
+  count = e->count;
+  if (e->pc != pc || count <= 0 || count > PC_CACHE_FRAMES)
+    return 0;
+  for (i = 0; i < count; ++i)
+    frames[i] = e->frames[i];
+  __sync_synchronize ();
+  if (backtrace_atomic_load_int (&e->seq) != seq)
+    return 0;
+  return count;
+}
+
+/* Store the frames in REC into the cache entry for PC, unless another
+   thread, or an interrupted caller, is updating the entry.  */
+
+static void
+pc_cache_insert (struct backtrace_pc_cache *cache, uintptr_t pc,
+		 const struct pc_cache_record *rec)
+{
+  struct pc_cache_entry *e;
+  int seq;
+  int i;
+
+  e = pc_cache_entry (cache, pc);
+  seq = backtrace_atomic_load_int (&e->seq);
+  if ((seq & 1) != 0)
+    return;
+  if (!__sync_bool_compare_and_swap (&e->seq, seq, seq + 1))
+    return;
+  e->pc = pc;
+  e->count = rec->count;
+  for (i = 0; i < rec->count; ++i)
+    e->frames[i] = rec->frames[i];
+  backtrace_atomic_store_int (&e->seq, seq + 2);
+}
+
+/* The callback used while filling a cache entry.  Record the frame and
+   pass it on to the caller.  */
+
+static int
+pc_cache_record_callback (void *vdata, uintptr_t pc, const char *filename,
+			  int lineno, const char *function)
+{
+  struct pc_cache_record *rec = (struct pc_cache_record *) vdata;
+
+  if (rec->count < PC_CACHE_FRAMES)
+    {
+      rec->frames[rec->count].filename = filename;
+      rec->frames[rec->count].lineno = lineno;
+      rec->frames[rec->count].function = function;
+    }
+  else
+    rec->failed = 1;
+  ++rec->count;
+  return rec->callback (rec->data, pc, filename, lineno, function);
+}
+
+/* The error callback used while filling a cache entry.  A lookup that
+   reports an error is not cached.  */
+
+static void
+pc_cache_record_error_callback (void *vdata, const char *msg, int errnum)
+{
+  struct pc_cache_record *rec = (struct pc_cache_record *) vdata;
+
+  rec->failed = 1;
+  rec->error_callback (rec->data, msg, errnum);
+}
+
+#endif /* defined (HAVE_SYNC_FUNCTIONS) */
+
 /* Initialize the fileline information from the executable.  Returns 1
    on success, 0 on failure.  */
 
@@ -154,6 +346,10 @@ fileline_initialize (struct backtrace_state *state,
       return 0;
     }
 
+#ifdef HAVE_SYNC_FUNCTIONS
+  pc_cache_initialize (state);
+#endif
+
   if (!state->threaded)
     state->fileline_fn = fileline_fn;
   else
@@ -180,6 +376,50 @@ backtrace_pcinfo (struct backtrace_state *state, uintptr_t pc,
   if (state->fileline_initialization_failed)
     return 0;
 
+#ifdef HAVE_SYNC_FUNCTIONS
+  {
+    struct backtrace_pc_cache *cache;
+
+    if (!state->threaded)
+      cache = state->pc_cache;
+    else
+      cache = backtrace_atomic_load_pointer (&state->pc_cache);
+
+    if (cache != NULL)
+      {
+	struct pc_cache_record rec;
+	int count;
+	int ret;
+	int i;
+
+	count = pc_cache_lookup (cache, pc, &rec.frames[0]);
+	if (count > 0)
+	  {
+	    for (i = 0; i < count; ++i)
+	      {
+		ret = callback (data, pc, rec.frames[i].filename,
+				rec.frames[i].lineno,
+				rec.frames[i].function);
+		if (ret != 0)
+		  return ret;
+	      }
+	    return 0;
+	  }
+
+	rec.callback = callback;
+	rec.error_callback = error_callback;
+	rec.data = data;
+	rec.count = 0;
+	rec.failed = 0;
+	ret = state->fileline_fn (state, pc, pc_cache_record_callback,
+				  pc_cache_record_error_callback, &rec);
+	if (ret == 0 && !rec.failed && rec.count > 0)
+	  pc_cache_insert (cache, pc, &rec);
+	return ret;
+      }
+  }
+#endif
+
   return state->fileline_fn (state, pc, callback, error_callback, data);
 }
 
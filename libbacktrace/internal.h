@@ -148,6 +148,8 @@ struct backtrace_state
   int lock_alloc;
   /* The freelist when using mmap.  */
   struct backtrace_freelist_struct *freelist;
+  /* The cache of recent backtrace_pcinfo results, or NULL.  */
+  struct backtrace_pc_cache *pc_cache;
 };
 
 /* Open a file for reading.  Returns -1 on error.  If DOES_NOT_EXIST
@@ -302,6 +304,8 @@ extern int backtrace_dwarf_add (struct backtrace_state *state,
 				size_t dwarf_range_size,
 				const unsigned char *dwarf_str,
 				size_t dwarf_str_size,
+				const unsigned char *dwarf_aranges,
+				size_t dwarf_aranges_size,
 				int is_bigendian,
 				struct dwarf_data *fileline_altlink,
 				backtrace_error_callback error_callback,
@@ -317,4 +321,13 @@ extern int backtrace_uncompress_zdebug (struct backtrace_state *,
 					unsigned char **uncompressed,
 					size_t *uncompressed_size);
 
+/* A test-only hook for elf_zstd_decompress.  */
+
+extern int backtrace_uncompress_zstd (struct backtrace_state *,
+				      const unsigned char *compressed,
+				      size_t compressed_size,
+				      backtrace_error_callback, void *data,
+				      unsigned char *uncompressed,
+				      size_t uncompressed_size);
+
 #endif
@@ -1314,6 +1314,7 @@ xcoff_add (struct backtrace_state *state, int descriptor, off_t offset,
 				dwsect[DWSECT_RANGES].size,
 				dwsect[DWSECT_STR].data,
 				dwsect[DWSECT_STR].size,
+				NULL, 0,
 				1, /* big endian */
 				NULL,
 				error_callback, data, fileline_fn,
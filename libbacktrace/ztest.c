@@ -183,6 +183,47 @@ static const struct zlib_test tests[] =
   }
 };
 
+/* The same samples compressed with zstd (level 19, with a frame
+   checksum), in the same order as tests.  */
+
+struct zstd_test
+{
+  const char *compressed;
+  size_t compressed_len;
+};
+
+static const struct zstd_test zstd_tests[] =
+{
+  {
+    ("\x28\xb5\x2f\xfd\x24\x00\x01\x00\x00\x99\xe9\xd8\x51"),
+    13,
+  },
+  {
+    ("\x28\xb5\x2f\xfd\x24\x0d\x69\x00\x00\x68\x65\x6c\x6c\x6f\x2c\x20"
+     "\x77\x6f\x72\x6c\x64\x0a\x4c\x1f\xf9\xf1"),
+    26,
+  },
+  {
+    ("\x28\xb5\x2f\xfd\x24\x0e\x71\x00\x00\x67\x6f\x6f\x64\x62\x79\x65"
+     "\x2c\x20\x77\x6f\x72\x6c\x64\x61\x7b\x4b\x83"),
+    27,
+  },
+  {
+    ("\x28\xb5\x2f\xfd\x64\xa0\x01\xad\x04\x00\x44\x05\xcc\x11\x00\xd5"
+     "\x13\x00\x1c\x14\x00\x72\x9d\xd5\xfb\x12\x00\x09\x13\x00\x0c\xcb"
+     "\x29\x14\x00\x4e\x67\x5f\x0b\x00\x6c\x7d\x7e\x0c\x00\x38\x0f\x00"
+     "\x5c\x83\x0c\x00\xfa\xfd\x0d\x00\xef\x0e\x00\x14\x38\x9f\xac\xdb"
+     "\xff\x00\xd8\x0e\xfa\x0c\x00\xea\x5c\x2c\x10\x00\x60\x11\x00\xd1"
+     "\x16\x00\x40\x0b\x00\x7a\xb6\x00\x00\x9f\x01\x00\xa7\x01\x00\xa9"
+     "\x2e\xa8\x40\x62\xf0\x40\x4f\x49\x1e\x11\xe4\x05\x68\x9c\xc4\x50"
+     "\x92\x40\x39\x66\x54\xca\x03\xa0\x48\x13\xdd\xa6\x60\xb6\xe4\x45"
+     "\xe9\x66\x22\x37\xd0\x98\x08\x8c\xfa\x84\x3c\x0a\x93\x1c\x82\xfc"
+     "\x47\xab\xc3\x34\x20\x27\x03\xc5\x8a\xa5\x93\xa1\x0d\xea\x03\x02"
+     "\xcb\xe0\xce"),
+    163,
+  }
+};
+
 /* Test the hand coded samples.  */
 
 static void
@@ -246,6 +287,50 @@ test_samples (struct backtrace_state *state)
     }
 }
 
+/* Test the zstd compressed samples.  */
+
+static void
+test_zstd_samples (struct backtrace_state *state)
+{
+  size_t i;
+
+  for (i = 0; i < sizeof zstd_tests / sizeof zstd_tests[0]; ++i)
+    {
+      size_t v;
+      unsigned char *uncompressed;
+
+      v = tests[i].uncompressed_len;
+      if (v == 0)
+	v = strlen (tests[i].uncompressed);
+      uncompressed = (unsigned char *) malloc (v + 1);
+      if (uncompressed == NULL)
+	{
+	  perror ("malloc");
+	  exit (EXIT_FAILURE);
+	}
+      if (!backtrace_uncompress_zstd (state,
+				      ((const unsigned char *)
+				       zstd_tests[i].compressed),
+				      zstd_tests[i].compressed_len,
+				      error_callback_compress, NULL,
+				      uncompressed, v))
+	{
+	  fprintf (stderr, "test %s: uncompress failed\n", tests[i].name);
+	  ++failures;
+	}
+      else if (memcmp (tests[i].uncompressed, uncompressed, v) != 0)
+	{
+	  fprintf (stderr, "test %s: uncompressed data mismatch\n",
+		   tests[i].name);
+	  ++failures;
+	}
+      else
+	printf ("PASS: zstd %s\n", tests[i].name);
+
+      free (uncompressed);
+    }
+}
+
 #ifdef HAVE_ZLIB
 
 /* Given a set of TRIALS timings, discard the lowest and highest
@@ -531,6 +616,7 @@ main (int argc ATTRIBUTE_UNUSED, char **argv)
 				  error_callback_create, NULL);
 
   test_samples (state);
+  test_zstd_samples (state);
   test_large (state);
 
   exit (failures != 0 ? EXIT_FAILURE : EXIT_SUCCESS);
@@ -751,7 +751,12 @@ _cpp_destroy_iconv (cpp_reader *pfile)
 	iconv_close (pfile->char32_cset_desc.cd);
       if (pfile->wide_cset_desc.func == convert_using_iconv)
 	iconv_close (pfile->wide_cset_desc.cd);
+      if (pfile->input_cset_name
+	  && pfile->input_cset_desc.func == convert_using_iconv)
+	iconv_close (pfile->input_cset_desc.cd);
     }
+  free (pfile->input_cset_name);
+  pfile->input_cset_name = NULL;
 }
 
 /* Utility routine for use by a full compiler.  C is a character taken
@@ -2123,7 +2128,22 @@ _cpp_convert_input (cpp_reader *pfile, const char *input_charset,
   struct _cpp_strbuf to;
   unsigned char *buffer;
 
-  input_cset = init_iconv_desc (pfile, SOURCE_CHARSET, input_charset);
+  /* Every file of a translation unit is normally read with the same
+     input character set, so open the converter once and reuse it
+     rather than paying for iconv_open on each header.  */
+  if (pfile->input_cset_name == NULL
+      || strcasecmp (pfile->input_cset_name, input_charset))
+    {
+      if (pfile->input_cset_name
+	  && pfile->input_cset_desc.func == convert_using_iconv)
+	iconv_close (pfile->input_cset_desc.cd);
+      free (pfile->input_cset_name);
+      pfile->input_cset_desc = init_iconv_desc (pfile, SOURCE_CHARSET,
+						input_charset);
+      pfile->input_cset_name = xstrdup (input_charset);
+    }
+  input_cset = pfile->input_cset_desc;
+
   if (input_cset.func == convert_no_conversion)
     {
       to.text = input;
@@ -2144,10 +2164,6 @@ _cpp_convert_input (cpp_reader *pfile, const char *input_charset,
       free (input);
     }
 
-  /* Clean up the mess.  */
-  if (input_cset.func == convert_using_iconv)
-    iconv_close (input_cset.cd);
-
   /* Resize buffer if we allocated substantially too much, or if we
      haven't enough space for the \n-terminator or following
      15 bytes of padding (used to quiet warnings from valgrind or
@@ -69,6 +69,11 @@ struct _cpp_file
   /* Chain through all files.  */
   struct _cpp_file *next_file;
 
+  /* Chain through the once-only files not yet in the once-only hash,
+     in reverse order of marking, or through the once-only files with
+     the same size and modification time.  */
+  struct _cpp_file *next_once_only;
+
   /* The contents of NAME after calling read_file().  */
   const uchar *buffer;
 
@@ -94,6 +99,9 @@ struct _cpp_file
      otherwise errno obtained from failure.  */
   int err_no;
 
+  /* Hash of the contents of the file, if CONTENT_HASH_VALID.  */
+  hashval_t content_hash;
+
   /* Number of times the file has been stacked for preprocessing.  */
   unsigned short stack_count;
 
@@ -111,6 +119,9 @@ struct _cpp_file
 
   /* If this file is implicitly preincluded.  */
   bool implicit_preinclude : 1;
+
+  /* If CONTENT_HASH has been computed.  */
+  bool content_hash_valid : 1;
 };
 
 /* A singly-linked list for all searches for a given file name, with
@@ -191,6 +202,10 @@ static struct cpp_file_hash_entry *new_file_hash_entry (cpp_reader *pfile);
 static int report_missing_guard (void **slot, void *b);
 static hashval_t file_hash_hash (const void *p);
 static int file_hash_eq (const void *p, const void *q);
+static hashval_t once_only_hash_hash (const void *p);
+static int once_only_hash_eq (const void *p, const void *q);
+static hashval_t guarded_file_hash_hash (const void *p);
+static int guarded_file_hash_eq (const void *p, const void *q);
 static char *read_filename_string (int ch, FILE *f);
 static void read_name_map (cpp_dir *dir);
 static char *remap_filename (cpp_reader *pfile, _cpp_file *file);
@@ -199,6 +214,8 @@ static bool validate_pch (cpp_reader *, _cpp_file *file, const char *pchname);
 static int pchf_save_compare (const void *e1, const void *e2);
 static int pchf_compare (const void *d_p, const void *e_p);
 static bool check_file_against_entries (cpp_reader *, _cpp_file *, bool);
+static bool dir_may_contain_p (cpp_reader *, _cpp_file *);
+static void note_dir_miss (cpp_reader *, const cpp_dir *);
 
 /* Given a filename in FILE->PATH, with the empty string interpreted
    as <stdin>, open it.
@@ -293,13 +310,22 @@ pch_open_file (cpp_reader *pfile, _cpp_file *file, bool *invalid_pch)
 
   /* If the file is not included as first include from either the toplevel
      file or the command-line it is not a valid use of PCH.  */
+  bool first_include = true;
   for (_cpp_file *f = pfile->all_files; f; f = f->next_file)
     if (f->implicit_preinclude)
       continue;
     else if (f->main_file)
       break;
     else
-      return false;
+      {
+	first_include = false;
+	break;
+      }
+
+  /* Only one PCH can be loaded, as the first include.  Unless asked to
+     explain why PCH files are not used, don't even look for one.  */
+  if (!first_include && !CPP_OPTION (pfile, warn_invalid_pch))
+    return false;
 
   flen = strlen (path);
   len = flen + sizeof (extension);
@@ -307,6 +333,16 @@ pch_open_file (cpp_reader *pfile, _cpp_file *file, bool *invalid_pch)
   memcpy (pchname, path, flen);
   memcpy (pchname + flen, extension, sizeof (extension));
 
+  if (!first_include)
+    {
+      if (stat (pchname, &st) == 0)
+	cpp_warning_syshdr (pfile, CPP_W_INVALID_PCH,
+			    "%s: not used because `%s' is not the first"
+			    " include", pchname, file->name);
+      free (pchname);
+      return false;
+    }
+
   if (stat (pchname, &st) == 0)
     {
       DIR *pchdir;
@@ -419,6 +455,13 @@ find_file_in_dir (cpp_reader *pfile, _cpp_file *file, bool *invalid_pch,
 	  return false;
 	}
 
+      if (!dir_may_contain_p (pfile, file))
+	{
+	  file->err_no = ENOENT;
+	  free (path);
+	  return false;
+	}
+
       file->path = path;
       if (pch_open_file (pfile, file, invalid_pch))
 	return true;
@@ -441,6 +484,7 @@ find_file_in_dir (cpp_reader *pfile, _cpp_file *file, bool *invalid_pch,
       pp = htab_find_slot_with_hash (pfile->nonexistent_file_hash,
 				     copy, hv, INSERT);
       *pp = copy;
+      note_dir_miss (pfile, file->dir);
 
       file->path = file->name;
     }
@@ -804,6 +848,15 @@ is_known_idempotent_file (cpp_reader *pfile, _cpp_file *file, bool import)
 	return true;
     }
 
+  /* The same file may have been seen under a different name.  */
+  if (!file->cmacro && file->err_no == 0 && file->st.st_ino != 0)
+    {
+      _cpp_file *guarded
+	= (_cpp_file *) htab_find (pfile->guarded_file_hash, file);
+      if (guarded)
+	file->cmacro = guarded->cmacro;
+    }
+
   /* Skip if the file had a header guard and the macro is defined.
      PCH relies on this appearing before the PCH handler below.  */
   if (file->cmacro && cpp_macro_p (file->cmacro))
@@ -822,6 +875,88 @@ is_known_idempotent_file (cpp_reader *pfile, _cpp_file *file, bool import)
   return false;
 }
 
+/* Return the hash of the contents of FILE, which must have been read.  */
+
+static hashval_t
+file_content_hash (_cpp_file *file)
+{
+  if (!file->content_hash_valid)
+    {
+      file->content_hash = iterative_hash (file->buffer, file->st.st_size, 0);
+      file->content_hash_valid = true;
+    }
+  return file->content_hash;
+}
+
+/* Return TRUE if F, which has the same size and modification time as
+   FILE, also has the same contents.  The contents of FILE must already
+   have been read.  */
+
+static bool
+same_contents_p (cpp_reader *pfile, _cpp_file *f, _cpp_file *file,
+		 location_t loc)
+{
+  _cpp_file *ref_file;
+
+  /* Don't read F again if we know it differs.  */
+  if (f->content_hash_valid && f->content_hash != file_content_hash (file))
+    return false;
+
+  if (f->buffer && !f->buffer_valid)
+    {
+      /* We already have a buffer but it is not valid, because
+	 the file is still stacked.  Make a new one.  */
+      ref_file = make_cpp_file (pfile, f->dir, f->name);
+      ref_file->path = f->path;
+    }
+  else
+    /* The file is not stacked anymore.  We can reuse it.  */
+    ref_file = f;
+
+  bool same_file_p = (read_file (pfile, ref_file, loc)
+		      /* Size might have changed in read_file().  */
+		      && ref_file->st.st_size == file->st.st_size);
+  if (same_file_p)
+    {
+      if (!f->content_hash_valid)
+	{
+	  f->content_hash = file_content_hash (ref_file);
+	  f->content_hash_valid = true;
+	}
+      same_file_p = (f->content_hash == file_content_hash (file)
+		     && !memcmp (ref_file->buffer, file->buffer,
+				 file->st.st_size));
+    }
+
+  if (f->buffer && !f->buffer_valid)
+    {
+      ref_file->path = 0;
+      destroy_cpp_file (ref_file);
+    }
+
+  return same_file_p;
+}
+
+/* Enter the once-only files marked since the last call into the
+   once-only hash.  By now their contents have been read, so their
+   sizes are final.  */
+
+static void
+index_once_only_files (cpp_reader *pfile)
+{
+  _cpp_file *f, *next;
+
+  for (f = pfile->once_only_files; f; f = next)
+    {
+      void **slot = htab_find_slot (pfile->once_only_hash, f, INSERT);
+
+      next = f->next_once_only;
+      f->next_once_only = (_cpp_file *) *slot;
+      *slot = f;
+    }
+  pfile->once_only_files = NULL;
+}
+
 /* Return TRUE if file has unique contents, so we should read process
    it.  The file's contents must already have been read.  */
 
@@ -848,8 +983,21 @@ has_unique_contents (cpp_reader *pfile, _cpp_file *file, bool import,
     return true;
 
   /* We may have read the file under a different name.  Look
-     for likely candidates and compare file contents to be sure.  */
-  for (_cpp_file *f = pfile->all_files; f; f = f->next_file)
+     for likely candidates and compare file contents to be sure.  Only
+     once-only files can match a plain #include, so look up just those
+     with the same size and modification time unless this is a
+     #import.  */
+  _cpp_file *candidates;
+  if (import)
+    candidates = pfile->all_files;
+  else
+    {
+      index_once_only_files (pfile);
+      candidates = (_cpp_file *) htab_find (pfile->once_only_hash, file);
+    }
+
+  for (_cpp_file *f = candidates;
+       f; f = import ? f->next_file : f->next_once_only)
     {
       if (f == file)
 	continue; /* It'sa me!  */
@@ -857,37 +1005,10 @@ has_unique_contents (cpp_reader *pfile, _cpp_file *file, bool import,
       if ((import || f->once_only)
 	  && f->err_no == 0
 	  && f->st.st_mtime == file->st.st_mtime
-	  && f->st.st_size == file->st.st_size)
-	{
-	  _cpp_file *ref_file;
-
-	  if (f->buffer && !f->buffer_valid)
-	    {
-	      /* We already have a buffer but it is not valid, because
-		 the file is still stacked.  Make a new one.  */
-	      ref_file = make_cpp_file (pfile, f->dir, f->name);
-	      ref_file->path = f->path;
-	    }
-	  else
-	    /* The file is not stacked anymore.  We can reuse it.  */
-	    ref_file = f;
-
-	  bool same_file_p = (read_file (pfile, ref_file, loc)
-			      /* Size might have changed in read_file().  */
-			      && ref_file->st.st_size == file->st.st_size
-			      && !memcmp (ref_file->buffer, file->buffer,
-					  file->st.st_size));
-
-	  if (f->buffer && !f->buffer_valid)
-	    {
-	      ref_file->path = 0;
-	      destroy_cpp_file (ref_file);
-	    }
-
-	  if (same_file_p)
-	    /* Already seen under a different name.  */
-	    return false;
-	}
+	  && f->st.st_size == file->st.st_size
+	  && same_contents_p (pfile, f, file, loc))
+	/* Already seen under a different name.  */
+	return false;
     }
 
   return true;
@@ -960,7 +1081,12 @@ void
 _cpp_mark_file_once_only (cpp_reader *pfile, _cpp_file *file)
 {
   pfile->seen_once_only = true;
-  file->once_only = true;
+  if (!file->once_only)
+    {
+      file->once_only = true;
+      file->next_once_only = pfile->once_only_files;
+      pfile->once_only_files = file;
+    }
 }
 
 /* Return the directory from which searching for FNAME should start,
@@ -1276,6 +1402,54 @@ file_hash_hash (const void *p)
   return htab_hash_string (hname);
 }
 
+/* Hash function for the once-only hash: the size and modification
+   time of the _cpp_file P.  */
+static hashval_t
+once_only_hash_hash (const void *p)
+{
+  const _cpp_file *file = (const _cpp_file *) p;
+
+  return iterative_hash_object (file->st.st_size,
+				iterative_hash_object (file->st.st_mtime, 0));
+}
+
+/* Return nonzero if the _cpp_files P and Q have the same size and
+   modification time.  */
+static int
+once_only_hash_eq (const void *p, const void *q)
+{
+  const _cpp_file *f1 = (const _cpp_file *) p;
+  const _cpp_file *f2 = (const _cpp_file *) q;
+
+  return (f1->st.st_size == f2->st.st_size
+	  && f1->st.st_mtime == f2->st.st_mtime);
+}
+
+/* Hash function for the guarded file hash: the device and inode of
+   the _cpp_file P.  */
+static hashval_t
+guarded_file_hash_hash (const void *p)
+{
+  const _cpp_file *file = (const _cpp_file *) p;
+
+  return iterative_hash_object (file->st.st_ino,
+				iterative_hash_object (file->st.st_dev, 0));
+}
+
+/* Return nonzero if the _cpp_files P and Q are the same file, and it
+   hasn't changed in between.  */
+static int
+guarded_file_hash_eq (const void *p, const void *q)
+{
+  const _cpp_file *f1 = (const _cpp_file *) p;
+  const _cpp_file *f2 = (const _cpp_file *) q;
+
+  return (f1->st.st_ino == f2->st.st_ino
+	  && f1->st.st_dev == f2->st.st_dev
+	  && f1->st.st_size == f2->st.st_size
+	  && f1->st.st_mtime == f2->st.st_mtime);
+}
+
 /* Compare a string Q against a file hash entry P.  */
 static int
 file_hash_eq (const void *p, const void *q)
@@ -1300,20 +1474,192 @@ nonexistent_file_hash_eq (const void *p, const void *q)
   return filename_cmp ((const char *) p, (const char *) q) == 0;
 }
 
+/* After this many lookups in an include directory have found nothing,
+   the names of its entries are read once, so that later lookups of
+   names that are not there fail without any system call.  This is what
+   makes long include paths cheap, in particular on network file
+   systems.  */
+#define DIR_ENTRIES_MISS_THRESHOLD 16
+
+/* What is known about the entries of an include directory.  */
+struct dir_entries
+{
+  /* The directory described.  */
+  const cpp_dir *dir;
+
+  /* The number of lookups in DIR that have found nothing.  */
+  unsigned int misses;
+
+  /* True once reading the entries of DIR has been attempted.  */
+  bool read_p;
+
+  /* The names of the entries of DIR, or NULL if they are not known.  */
+  htab_t names;
+};
+
+/* Hash and compare entries in the directory entries hash table, which
+   is keyed by the cpp_dir.  */
+static hashval_t
+dir_entries_hash (const void *p)
+{
+  return htab_hash_pointer (((const struct dir_entries *) p)->dir);
+}
+
+static int
+dir_entries_eq (const void *p, const void *q)
+{
+  return ((const struct dir_entries *) p)->dir == (const cpp_dir *) q;
+}
+
+static void
+dir_entries_free (void *p)
+{
+  struct dir_entries *entries = (struct dir_entries *) p;
+
+  if (entries->names)
+    htab_delete (entries->names);
+  free (entries);
+}
+
+/* Compare entries in a table of directory entry names.  Unlike paths,
+   these are compared exactly, as only case sensitive hosts use them.  */
+static int
+dir_entry_name_eq (const void *p, const void *q)
+{
+  return strcmp ((const char *) p, (const char *) q) == 0;
+}
+
+/* Read the names of the entries of ENTRIES->dir.  */
+static void
+read_dir_entries (struct dir_entries *entries)
+{
+  const char *name = entries->dir->len ? entries->dir->name : ".";
+  DIR *dir;
+  struct dirent *d;
+
+  entries->read_p = true;
+  dir = opendir (name);
+  if (dir == NULL)
+    return;
+
+  entries->names = htab_create_alloc (127, htab_hash_string,
+				      dir_entry_name_eq, free,
+				      xcalloc, free);
+  while ((d = readdir (dir)) != NULL)
+    {
+      void **slot = htab_find_slot (entries->names, d->d_name, INSERT);
+      if (*slot == NULL)
+	*slot = xstrdup (d->d_name);
+    }
+  closedir (dir);
+}
+
+/* Record that a lookup in DIR found nothing.  */
+static void
+note_dir_miss (cpp_reader *pfile, const cpp_dir *dir)
+{
+  void **slot;
+  struct dir_entries *entries;
+
+  slot = htab_find_slot_with_hash (pfile->dir_entries_hash, dir,
+				   htab_hash_pointer (dir), INSERT);
+  if (*slot == NULL)
+    {
+      entries = XCNEW (struct dir_entries);
+      entries->dir = dir;
+      *slot = entries;
+    }
+  else
+    entries = (struct dir_entries *) *slot;
+
+  if (!entries->read_p && ++entries->misses >= DIR_ENTRIES_MISS_THRESHOLD)
+    read_dir_entries (entries);
+}
+
+/* Return false if FILE->name certainly does not exist in FILE->dir,
+   because the entries of that directory are known and do not include
+   its first component, true otherwise.  */
+static bool
+dir_may_contain_p (cpp_reader *pfile, _cpp_file *file)
+{
+#ifdef HAVE_CASE_INSENSITIVE_FILE_SYSTEM
+  return true;
+#else
+  const char *name = file->name;
+  const char *end;
+  struct dir_entries *entries;
+  char *component;
+  size_t len;
+
+  if (file->dir->construct
+      || CPP_OPTION (pfile, remap)
+      || IS_ABSOLUTE_PATH (name))
+    return true;
+
+  entries = (struct dir_entries *)
+    htab_find_with_hash (pfile->dir_entries_hash, file->dir,
+			 htab_hash_pointer (file->dir));
+  if (entries == NULL || entries->names == NULL)
+    return true;
+
+  for (end = name; *end && !IS_DIR_SEPARATOR (*end); end++)
+    ;
+  len = end - name;
+  if (len == 0
+      || (name[0] == '.' && (len == 1 || (len == 2 && name[1] == '.'))))
+    return true;
+
+  /* Leave room for a PCH extension.  */
+  component = (char *) alloca (len + sizeof (".gch"));
+  memcpy (component, name, len);
+  component[len] = '\0';
+  if (htab_find (entries->names, component) != NULL)
+    return true;
+
+  /* A precompiled header may be used even if the header itself is
+     missing.  */
+  if (*end == '\0' && pfile->cb.valid_pch)
+    {
+      memcpy (component + len, ".gch", sizeof (".gch"));
+      if (htab_find (entries->names, component) != NULL)
+	return true;
+    }
+
+  return false;
+#endif
+}
+
 /* Initialize everything in this source file.  */
 void
 _cpp_init_files (cpp_reader *pfile)
 {
-  pfile->file_hash = htab_create_alloc (127, file_hash_hash, file_hash_eq,
-					NULL, xcalloc, free);
-  pfile->dir_hash = htab_create_alloc (127, file_hash_hash, file_hash_eq,
-					NULL, xcalloc, free);
+  /* These tables are keyed by path names, so caching the hashes avoids
+     most of the string comparisons on probes.  */
+  pfile->file_hash = htab_create_alloc_flags (127, file_hash_hash,
+					      file_hash_eq, NULL, xcalloc, free,
+					      HTAB_CACHE_HASHES
+					      | HTAB_POWER_OF_2);
+  pfile->dir_hash = htab_create_alloc_flags (127, file_hash_hash,
+					     file_hash_eq, NULL, xcalloc, free,
+					     HTAB_CACHE_HASHES
+					     | HTAB_POWER_OF_2);
   allocate_file_hash_entries (pfile);
-  pfile->nonexistent_file_hash = htab_create_alloc (127, htab_hash_string,
-						    nonexistent_file_hash_eq,
-						    NULL, xcalloc, free);
+  pfile->nonexistent_file_hash
+    = htab_create_alloc_flags (127, htab_hash_string,
+			       nonexistent_file_hash_eq, NULL, xcalloc, free,
+			       HTAB_CACHE_HASHES | HTAB_POWER_OF_2);
   obstack_specify_allocation (&pfile->nonexistent_file_ob, 0, 0,
 			      xmalloc, free);
+  pfile->dir_entries_hash = htab_create_alloc (31, dir_entries_hash,
+					       dir_entries_eq,
+					       dir_entries_free,
+					       xcalloc, free);
+  pfile->once_only_hash = htab_create_alloc (31, once_only_hash_hash,
+					     once_only_hash_eq, NULL,
+					     xcalloc, free);
+  pfile->guarded_file_hash = htab_create_alloc (127, guarded_file_hash_hash,
+						guarded_file_hash_eq, NULL,
+						xcalloc, free);
 }
 
 /* Finalize everything in this source file.  */
@@ -1324,6 +1670,9 @@ _cpp_cleanup_files (cpp_reader *pfile)
   htab_delete (pfile->dir_hash);
   htab_delete (pfile->nonexistent_file_hash);
   obstack_free (&pfile->nonexistent_file_ob, 0);
+  htab_delete (pfile->dir_entries_hash);
+  htab_delete (pfile->once_only_hash);
+  htab_delete (pfile->guarded_file_hash);
   free_file_hash_entries (pfile);
   destroy_all_cpp_files (pfile);
 }
@@ -1336,6 +1685,7 @@ cpp_clear_file_cache (cpp_reader *pfile)
   _cpp_cleanup_files (pfile);
   pfile->file_hash_entries = NULL;
   pfile->all_files = NULL;
+  pfile->once_only_files = NULL;
   _cpp_init_files (pfile);
 }
 
@@ -1498,9 +1848,19 @@ _cpp_pop_file_buffer (cpp_reader *pfile, _cpp_file *file,
 		      const unsigned char *to_free)
 {
   /* Record the inclusion-preventing macro, which could be NULL
-     meaning no controlling macro.  */
+     meaning no controlling macro.  Remember it for the file itself
+     too, in case it is found again under a different name.  */
   if (pfile->mi_valid && file->cmacro == NULL)
-    file->cmacro = pfile->mi_cmacro;
+    {
+      file->cmacro = pfile->mi_cmacro;
+      if (file->cmacro && file->err_no == 0 && file->st.st_ino != 0)
+	{
+	  void **slot = htab_find_slot (pfile->guarded_file_hash, file,
+					INSERT);
+	  if (*slot == NULL)
+	    *slot = file;
+	}
+    }
 
   /* Invalidate control macros in the #including file.  */
   pfile->mi_valid = false;
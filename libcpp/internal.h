@@ -453,6 +453,19 @@ struct cpp_reader
   /* Chain of all hashed _cpp_file instances.  */
   struct _cpp_file *all_files;
 
+  /* Chain of the files in ALL_FILES marked once-only but not yet
+     entered in ONCE_ONLY_HASH, linked through their next_once_only
+     fields.  */
+  struct _cpp_file *once_only_files;
+
+  /* Once-only files by size and modification time.  Each entry heads
+     a chain of the files with that size and time, linked through
+     their next_once_only fields.  */
+  struct htab *once_only_hash;
+
+  /* Files with a multiple-include guard, by device and inode.  */
+  struct htab *guarded_file_hash;
+
   struct _cpp_file *main_file;
 
   /* File and directory hash table.  */
@@ -464,6 +477,9 @@ struct cpp_reader
   struct htab *nonexistent_file_hash;
   struct obstack nonexistent_file_ob;
 
+  /* Entries of include directories in which lookups keep failing.  */
+  struct htab *dir_entries_hash;
+
   /* Nonzero means don't look for #include "foo" the source-file
      directory.  */
   bool quote_ignores_source_dir;
@@ -509,6 +525,13 @@ struct cpp_reader
      wide execution character set.  */
   struct cset_converter wide_cset_desc;
 
+  /* Descriptor for converting from the input character set to the
+     source character set, shared by every file read, and the name of
+     the input character set it was opened for; NULL if not yet
+     opened.  */
+  struct cset_converter input_cset_desc;
+  char *input_cset_name;
+
   /* Date and time text.  Calculated together if either is requested.  */
   const unsigned char *date;
   const unsigned char *time;
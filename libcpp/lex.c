@@ -406,6 +406,68 @@ search_line_sse2 (const uchar *s, const uchar *end ATTRIBUTE_UNUSED)
   return (const uchar *)p + found;
 }
 
+#ifdef HAVE_AVX2
+/* A version of the fast scanner using AVX2 vectorized byte compare insns.
+   This is the SSE2 algorithm widened to 32-byte blocks; as there, the
+   aligned loads never cross a page boundary, so the guaranteed newline
+   at the end of the buffer stops the scan without reading past it.  */
+
+static const uchar *
+#ifndef __AVX2__
+__attribute__((__target__("avx2")))
+#endif
+search_line_avx2 (const uchar *s, const uchar *end ATTRIBUTE_UNUSED)
+{
+  typedef char v16qi __attribute__ ((__vector_size__ (16)));
+  typedef char v32qi __attribute__ ((__vector_size__ (32)));
+  typedef long long v2di __attribute__ ((__vector_size__ (16)));
+  typedef long long v4di __attribute__ ((__vector_size__ (32)));
+
+#define REPL_CHARS_256(N) \
+  ((v32qi) __builtin_ia32_vbroadcastsi256 ((v2di) *(const v16qi *)repl_chars[N]))
+  const v32qi repl_nl = REPL_CHARS_256 (0);
+  const v32qi repl_cr = REPL_CHARS_256 (1);
+  const v32qi repl_bs = REPL_CHARS_256 (2);
+  const v32qi repl_qm = REPL_CHARS_256 (3);
+#undef REPL_CHARS_256
+
+  unsigned int misalign, found, mask;
+  const v32qi *p;
+  v32qi data, t;
+
+  /* Align the source pointer.  */
+  misalign = (uintptr_t)s & 31;
+  p = (const v32qi *)((uintptr_t)s & -32);
+  data = *p;
+
+  /* Create a mask for the bytes that are valid within the first
+     32-byte block.  */
+  mask = -1u << misalign;
+
+  /* Main loop processing 32 bytes at a time.  */
+  goto start;
+  do
+    {
+      data = *++p;
+      mask = -1;
+
+    start:
+      t = __builtin_ia32_pcmpeqb256 (data, repl_nl);
+      t = (v32qi) ((v4di) t | (v4di) __builtin_ia32_pcmpeqb256 (data, repl_cr));
+      t = (v32qi) ((v4di) t | (v4di) __builtin_ia32_pcmpeqb256 (data, repl_bs));
+      t = (v32qi) ((v4di) t | (v4di) __builtin_ia32_pcmpeqb256 (data, repl_qm));
+      found = __builtin_ia32_pmovmskb256 (t);
+      found &= mask;
+    }
+  while (!found);
+
+  /* FOUND contains 1 in bits for which we matched a relevant
+     character.  Conversion to the byte index is trivial.  */
+  found = __builtin_ctz(found);
+  return (const uchar *)p + found;
+}
+#endif
+
 #ifdef HAVE_SSE4
 /* A version of the fast scanner using SSE 4.2 vectorized string insns.  */
 
@@ -502,7 +564,9 @@ init_vectorized_lexer (void)
   search_line_fast_type impl = search_line_acc_char;
   int minimum = 0;
 
-#if defined(__SSE4_2__)
+#if defined(__AVX2__)
+  minimum = 4;
+#elif defined(__SSE4_2__)
   minimum = 3;
 #elif defined(__SSE2__)
   minimum = 2;
@@ -510,7 +574,7 @@ init_vectorized_lexer (void)
   minimum = 1;
 #endif
 
-  if (minimum == 3)
+  if (minimum >= 3)
     impl = search_line_sse42;
   else if (__get_cpuid (1, &dummy, &dummy, &ecx, &edx) || minimum == 2)
     {
@@ -528,6 +592,25 @@ init_vectorized_lexer (void)
 	impl = search_line_mmx;
     }
 
+#ifdef HAVE_AVX2
+  /* AVX2 additionally needs the OS to save the YMM state, which we
+     check with XGETBV once OSXSAVE says it is available.  */
+  if (minimum == 4)
+    impl = search_line_avx2;
+  else if ((ecx & (bit_OSXSAVE | bit_AVX)) == (bit_OSXSAVE | bit_AVX))
+    {
+      unsigned int ebx = 0, xcrlow, xcrhigh;
+
+      /* XGETBV: XCR0 must enable both the SSE and the YMM state.  */
+      asm (".byte 0x0f, 0x01, 0xd0"
+	   : "=a" (xcrlow), "=d" (xcrhigh) : "c" (0));
+      if ((xcrlow & 6) == 6
+	  && __get_cpuid_count (7, 0, &dummy, &ebx, &dummy, &dummy)
+	  && (ebx & bit_AVX2))
+	impl = search_line_avx2;
+    }
+#endif
+
   search_line_fast = impl;
 }
 
@@ -3367,7 +3450,6 @@ cpp_output_token (const cpp_token *token, FILE *fp)
     case SPELL_OPERATOR:
       {
 	const unsigned char *spelling;
-	int c;
 
 	if (token->flags & DIGRAPH)
 	  spelling = cpp_digraph2name (token->type);
@@ -3376,28 +3458,29 @@ cpp_output_token (const cpp_token *token, FILE *fp)
 	else
 	  spelling = TOKEN_NAME (token);
 
-	c = *spelling;
-	do
-	  putc (c, fp);
-	while ((c = *++spelling) != '\0');
+	fputs ((const char *) spelling, fp);
       }
       break;
 
     spell_ident:
     case SPELL_IDENT:
       {
-	size_t i;
+	size_t i, start = 0;
 	const unsigned char * name = NODE_NAME (token->val.node.node);
-	
-	for (i = 0; i < NODE_LEN (token->val.node.node); i++)
+	size_t len = NODE_LEN (token->val.node.node);
+
+	/* Write runs of plain characters with a single fwrite; only
+	   extended characters need to be converted to UCNs.  */
+	for (i = 0; i < len; i++)
 	  if (name[i] & ~0x7F)
 	    {
 	      unsigned char buffer[10];
+	      fwrite (name + start, 1, i - start, fp);
 	      i += utf8_to_ucn (buffer, name + i) - 1;
 	      fwrite (buffer, 1, 10, fp);
+	      start = i + 1;
 	    }
-	  else
-	    fputc (NODE_NAME (token->val.node.node)[i], fp);
+	fwrite (name + start, 1, len - start, fp);
       }
       break;
 
@@ -972,6 +972,15 @@ linemap_ordinary_map_lookup (const line_maps *set, location_t line)
     {
       if (mn + 1 == mx || line < MAP_START_LOCATION (&cached[1]))
 	return cached;
+
+      /* Locations are very often looked up in the order they were
+	 allocated, so try the next map before searching.  */
+      if (mn + 2 == mx || line < MAP_START_LOCATION (&cached[2]))
+	{
+	  LINEMAPS_ORDINARY_CACHE (set) = mn + 1;
+	  return &cached[1];
+	}
+      mn += 2;
     }
   else
     {
@@ -1024,6 +1033,13 @@ linemap_macro_map_lookup (const line_maps *set, location_t line)
       mx = mn - 1;
       mn = 0;
     }
+  else if (mn + 1 < mx && line >= MAP_START_LOCATION (&cached[1]))
+    {
+      /* As for ordinary maps, try the map allocated after the cached
+	 one before searching.  */
+      LINEMAPS_MACRO_CACHE (set) = mn + 1;
+      return &cached[1];
+    }
 
   while (mn < mx)
     {
@@ -2440,6 +2440,28 @@ ensure_expanded_arg_room (cpp_reader *pfile, macro_arg *arg,
     }
 }
 
+/* Return TRUE if pre-expanding the argument ARG cannot change it:
+   none of its tokens names a macro or has to be pasted, and none is a
+   comment that cpp_get_token_1 drops inside a directive.  */
+static bool
+arg_expands_to_itself_p (cpp_reader *pfile, const macro_arg *arg)
+{
+  for (unsigned int i = 0; i < arg->count; i++)
+    {
+      const cpp_token *token = arg->first[i];
+
+      if (token->flags & PASTE_LEFT)
+	return false;
+      if (token->type == CPP_NAME
+	  && token->val.node.node->type != NT_VOID
+	  && !(token->flags & NO_EXPAND))
+	return false;
+      if (token->type == CPP_COMMENT && pfile->state.in_directive)
+	return false;
+    }
+  return true;
+}
+
 /* Expand an argument ARG before replacing parameters in a
    function-like macro.  This works by pushing a context with the
    argument's tokens, and then expanding that into a temporary buffer
@@ -2457,6 +2479,22 @@ expand_arg (cpp_reader *pfile, macro_arg *arg)
       || arg->expanded != NULL)
     return;
 
+  /* Arguments made only of literals, punctuators and identifiers
+     that are not macros are common (think of the arguments of
+     logging and assertion macros); their expansion is the argument
+     itself, so copy it rather than rescanning it token by token.  */
+  if (arg_expands_to_itself_p (pfile, arg))
+    {
+      alloc_expanded_arg_mem (pfile, arg, arg->count);
+      memcpy (arg->expanded, arg->first,
+	      arg->count * sizeof (const cpp_token *));
+      if (track_macro_exp_p)
+	memcpy (arg->expanded_virt_locs, arg->virt_locs,
+		arg->count * sizeof (location_t));
+      arg->expanded_count = arg->count;
+      return;
+    }
+
   /* Don't warn about funlike macros when pre-expanding.  */
   saved_warn_trad = CPP_WTRADITIONAL (pfile);
   CPP_WTRADITIONAL (pfile) = 0;
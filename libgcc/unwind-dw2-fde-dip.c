@@ -85,6 +85,9 @@
 #if defined(USE_PT_GNU_EH_FRAME)
 
 #include <link.h>
+#ifdef __GLIBC__
+#include <dlfcn.h>
+#endif
 
 #ifndef __RELOC_POINTER
 # define __RELOC_POINTER(ptr, base) ((ptr) + (base))
@@ -118,6 +121,7 @@ struct unw_eh_frame_hdr
   unsigned char table_enc;
 };
 
+#ifndef DLFO_STRUCT_HAS_EH_DBASE
 #define FRAME_HDR_CACHE_SIZE 8
 
 static struct frame_hdr_cache_element
@@ -135,6 +139,7 @@ static struct frame_hdr_cache_element
 } frame_hdr_cache[FRAME_HDR_CACHE_SIZE];
 
 static struct frame_hdr_cache_element *frame_hdr_cache_head;
+#endif
 
 /* Like base_of_encoded_value, but take the base from a struct
    unw_eh_callback_data instead of an _Unwind_Context.  */
@@ -161,6 +166,114 @@ base_from_cb_data (unsigned char encoding, struct unw_eh_callback_data *data)
     }
 }
 
+/* Find the FDE for DATA->pc in the object whose .eh_frame_hdr is HDR,
+   with DATA->tbase and DATA->dbase already set.  Set DATA->ret and
+   DATA->func if it is found.  Always return 1, telling the caller of
+   _Unwind_IteratePhdrCallback to stop looking at other objects.  */
+
+static int
+find_fde_tail (struct unw_eh_callback_data *data,
+	       const struct unw_eh_frame_hdr *hdr)
+{
+  const unsigned char *p;
+  _Unwind_Ptr eh_frame;
+  struct object ob;
+
+  if (hdr->version != 1)
+    return 1;
+
+  p = read_encoded_value_with_base (hdr->eh_frame_ptr_enc,
+				    base_from_cb_data (hdr->eh_frame_ptr_enc,
+						       data),
+				    (const unsigned char *) (hdr + 1),
+				    &eh_frame);
+
+  /* We require here specific table encoding to speed things up.
+     Also, DW_EH_PE_datarel here means using PT_GNU_EH_FRAME start
+     as base, not the processor specific DW_EH_PE_datarel.  */
+  if (hdr->fde_count_enc != DW_EH_PE_omit
+      && hdr->table_enc == (DW_EH_PE_datarel | DW_EH_PE_sdata4))
+    {
+      _Unwind_Ptr fde_count;
+
+      p = read_encoded_value_with_base (hdr->fde_count_enc,
+					base_from_cb_data (hdr->fde_count_enc,
+							   data),
+					p, &fde_count);
+      /* Shouldn't happen.  */
+      if (fde_count == 0)
+	return 1;
+      if ((((_Unwind_Ptr) p) & 3) == 0)
+	{
+	  struct fde_table {
+	    signed initial_loc __attribute__ ((mode (SI)));
+	    signed fde __attribute__ ((mode (SI)));
+	  };
+	  const struct fde_table *table = (const struct fde_table *) p;
+	  size_t lo, hi, mid;
+	  _Unwind_Ptr data_base = (_Unwind_Ptr) hdr;
+	  fde *f;
+	  unsigned int f_enc, f_enc_size;
+	  _Unwind_Ptr range;
+
+	  mid = fde_count - 1;
+	  if (data->pc < table[0].initial_loc + data_base)
+	    return 1;
+	  else if (data->pc < table[mid].initial_loc + data_base)
+	    {
+	      lo = 0;
+	      hi = mid;
+
+	      while (lo < hi)
+		{
+		  mid = (lo + hi) / 2;
+		  if (data->pc < table[mid].initial_loc + data_base)
+		    hi = mid;
+		  else if (data->pc >= table[mid + 1].initial_loc + data_base)
+		    lo = mid + 1;
+		  else
+		    break;
+		}
+
+	      gcc_assert (lo < hi);
+	    }
+
+	  f = (fde *) (table[mid].fde + data_base);
+	  f_enc = get_fde_encoding (f);
+	  f_enc_size = size_of_encoded_value (f_enc);
+	  read_encoded_value_with_base (f_enc & 0x0f, 0,
+					&f->pc_begin[f_enc_size], &range);
+	  if (data->pc < table[mid].initial_loc + data_base + range)
+	    data->ret = f;
+	  data->func = (void *) (table[mid].initial_loc + data_base);
+	  return 1;
+	}
+    }
+
+  /* We have no sorted search table, so need to go the slow way.
+     As soon as GLIBC will provide API so to notify that a library has been
+     removed, we could cache this (and thus use search_object).  */
+  ob.pc_begin = NULL;
+  ob.tbase = data->tbase;
+  ob.dbase = data->dbase;
+  ob.u.single = (fde *) eh_frame;
+  ob.s.i = 0;
+  ob.s.b.mixed_encoding = 1;  /* Need to assume worst case.  */
+  data->ret = linear_search_fdes (&ob, (fde *) eh_frame, (void *) data->pc);
+  if (data->ret != NULL)
+    {
+      _Unwind_Ptr func;
+      unsigned int encoding = get_fde_encoding (data->ret);
+
+      read_encoded_value_with_base (encoding,
+				    base_from_cb_data (encoding, data),
+				    data->ret->pc_begin, &func);
+      data->func = (void *) func;
+    }
+  return 1;
+}
+
+#ifndef DLFO_STRUCT_HAS_EH_DBASE
 static int
 _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 {
@@ -172,10 +285,7 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 #else
   _Unwind_Ptr load_base;
 #endif
-  const unsigned char *p;
   const struct unw_eh_frame_hdr *hdr;
-  _Unwind_Ptr eh_frame;
-  struct object ob;
   _Unwind_Ptr pc_low = 0, pc_high = 0;
 
   struct ext_dl_phdr_info
@@ -325,8 +435,6 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
   /* Read .eh_frame_hdr header.  */
   hdr = (const struct unw_eh_frame_hdr *)
     __RELOC_POINTER (p_eh_frame_hdr->p_vaddr, load_base);
-  if (hdr->version != 1)
-    return 1;
 
 #ifdef CRT_GET_RFIB_DATA
 # ifdef __i386__
@@ -358,96 +466,9 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 # endif
 #endif
 
-  p = read_encoded_value_with_base (hdr->eh_frame_ptr_enc,
-				    base_from_cb_data (hdr->eh_frame_ptr_enc,
-						       data),
-				    (const unsigned char *) (hdr + 1),
-				    &eh_frame);
-
-  /* We require here specific table encoding to speed things up.
-     Also, DW_EH_PE_datarel here means using PT_GNU_EH_FRAME start
-     as base, not the processor specific DW_EH_PE_datarel.  */
-  if (hdr->fde_count_enc != DW_EH_PE_omit
-      && hdr->table_enc == (DW_EH_PE_datarel | DW_EH_PE_sdata4))
-    {
-      _Unwind_Ptr fde_count;
-
-      p = read_encoded_value_with_base (hdr->fde_count_enc,
-					base_from_cb_data (hdr->fde_count_enc,
-							   data),
-					p, &fde_count);
-      /* Shouldn't happen.  */
-      if (fde_count == 0)
-	return 1;
-      if ((((_Unwind_Ptr) p) & 3) == 0)
-	{
-	  struct fde_table {
-	    signed initial_loc __attribute__ ((mode (SI)));
-	    signed fde __attribute__ ((mode (SI)));
-	  };
-	  const struct fde_table *table = (const struct fde_table *) p;
-	  size_t lo, hi, mid;
-	  _Unwind_Ptr data_base = (_Unwind_Ptr) hdr;
-	  fde *f;
-	  unsigned int f_enc, f_enc_size;
-	  _Unwind_Ptr range;
-
-	  mid = fde_count - 1;
-	  if (data->pc < table[0].initial_loc + data_base)
-	    return 1;
-	  else if (data->pc < table[mid].initial_loc + data_base)
-	    {
-	      lo = 0;
-	      hi = mid;
-
-	      while (lo < hi)
-		{
-		  mid = (lo + hi) / 2;
-		  if (data->pc < table[mid].initial_loc + data_base)
-		    hi = mid;
-		  else if (data->pc >= table[mid + 1].initial_loc + data_base)
-		    lo = mid + 1;
-		  else
-		    break;
-		}
-
-	      gcc_assert (lo < hi);
-	    }
-
-	  f = (fde *) (table[mid].fde + data_base);
-	  f_enc = get_fde_encoding (f);
-	  f_enc_size = size_of_encoded_value (f_enc);
-	  read_encoded_value_with_base (f_enc & 0x0f, 0,
-					&f->pc_begin[f_enc_size], &range);
-	  if (data->pc < table[mid].initial_loc + data_base + range)
-	    data->ret = f;
-	  data->func = (void *) (table[mid].initial_loc + data_base);
-	  return 1;
-	}
-    }
-
-  /* We have no sorted search table, so need to go the slow way.
-     As soon as GLIBC will provide API so to notify that a library has been
-     removed, we could cache this (and thus use search_object).  */
-  ob.pc_begin = NULL;
-  ob.tbase = data->tbase;
-  ob.dbase = data->dbase;
-  ob.u.single = (fde *) eh_frame;
-  ob.s.i = 0;
-  ob.s.b.mixed_encoding = 1;  /* Need to assume worst case.  */
-  data->ret = linear_search_fdes (&ob, (fde *) eh_frame, (void *) data->pc);
-  if (data->ret != NULL)
-    {
-      _Unwind_Ptr func;
-      unsigned int encoding = get_fde_encoding (data->ret);
-
-      read_encoded_value_with_base (encoding,
-				    base_from_cb_data (encoding, data),
-				    data->ret->pc_begin, &func);
-      data->func = (void *) func;
-    }
-  return 1;
+  return find_fde_tail (data, hdr);
 }
+#endif
 
 const fde *
 _Unwind_Find_FDE (void *pc, struct dwarf_eh_bases *bases)
@@ -466,8 +487,26 @@ _Unwind_Find_FDE (void *pc, struct dwarf_eh_bases *bases)
   data.ret = NULL;
   data.check_cache = 1;
 
+#ifdef DLFO_STRUCT_HAS_EH_DBASE
+  /* The dynamic linker keeps its own table of the loaded objects up to
+     date across dlopen and dlclose, and _dl_find_object searches it
+     without taking the loader lock, so concurrent unwinders in
+     different threads do not serialize here.  */
+  {
+    struct dl_find_object dlfo;
+
+    if (_dl_find_object (pc, &dlfo) != 0 || dlfo.dlfo_eh_frame == NULL)
+      return NULL;
+# if DLFO_STRUCT_HAS_EH_DBASE
+    data.dbase = dlfo.dlfo_eh_dbase;
+# endif
+    find_fde_tail (&data,
+		   (const struct unw_eh_frame_hdr *) dlfo.dlfo_eh_frame);
+  }
+#else
   if (dl_iterate_phdr (_Unwind_IteratePhdrCallback, &data) < 0)
     return NULL;
+#endif
 
   if (data.ret)
     {
@@ -1241,6 +1241,57 @@ execute_cfa_program (const unsigned char *insn_ptr,
     }
 }
 
+#if defined(HAVE_CC_TLS) && !defined(USE_EMUTLS)
+/* Interpreting the CIE and FDE programs is the bulk of the work of
+   uw_frame_state_for, and deep stacks and repeated throws or backtraces
+   through the same code do it for the same return addresses again and
+   again.  Each thread therefore keeps a small direct-mapped cache of
+   the decoded frame states, so it needs no locking.
+
+   An entry is only used if the FDE lookup, which is still done for
+   every frame, finds the same FDE at the same address with the same
+   length and CIE, so that an object unloaded and replaced by another
+   one at the same address is not mistaken for the old one.  */
+
+#define FRAME_STATE_CACHE_SIZE 16
+
+struct frame_state_cache_entry
+{
+  void *ra;
+  int signal_frame;
+  const struct dwarf_fde *fde;
+  uword fde_length;
+  sword fde_cie_delta;
+  void *lsda;
+  _Unwind_Word args_size;
+  _Unwind_FrameState fs;
+};
+
+static __thread struct frame_state_cache_entry
+  frame_state_cache[FRAME_STATE_CACHE_SIZE];
+
+static inline struct frame_state_cache_entry *
+frame_state_cache_slot (void *ra)
+{
+  _Unwind_Ptr h = (_Unwind_Ptr) ra;
+
+  h ^= h >> 4 ^ h >> 12;
+  return &frame_state_cache[h % FRAME_STATE_CACHE_SIZE];
+}
+
+static inline int
+frame_state_cache_match (const struct frame_state_cache_entry *e,
+			 struct _Unwind_Context *context,
+			 const struct dwarf_fde *fde)
+{
+  return (e->ra == context->ra
+	  && e->fde == fde
+	  && e->signal_frame == _Unwind_IsSignalFrame (context)
+	  && e->fde_length == fde->length
+	  && e->fde_cie_delta == fde->CIE_delta);
+}
+#endif
+
 /* Given the _Unwind_Context CONTEXT for a stack frame, look up the FDE for
    its caller and decode it into FS.  This function also sets the
    args_size and lsda members of CONTEXT, as they are really information
@@ -1274,6 +1325,18 @@ uw_frame_state_for (struct _Unwind_Context *context, _Unwind_FrameState *fs)
 #endif
     }
 
+#if defined(HAVE_CC_TLS) && !defined(USE_EMUTLS)
+  struct frame_state_cache_entry *cached = frame_state_cache_slot (context->ra);
+
+  if (frame_state_cache_match (cached, context, fde))
+    {
+      *fs = cached->fs;
+      context->lsda = cached->lsda;
+      context->args_size = cached->args_size;
+      return _URC_NO_REASON;
+    }
+#endif
+
   fs->pc = context->bases.func;
 
   cie = get_cie (fde);
@@ -1310,6 +1373,19 @@ uw_frame_state_for (struct _Unwind_Context *context, _Unwind_FrameState *fs)
   end = (const unsigned char *) next_fde (fde);
   execute_cfa_program (insn, end, context, fs);
 
+#if defined(HAVE_CC_TLS) && !defined(USE_EMUTLS)
+  /* The remembered states were on the stack of execute_cfa_program.  */
+  fs->regs.prev = NULL;
+  cached->ra = context->ra;
+  cached->signal_frame = _Unwind_IsSignalFrame (context);
+  cached->fde = fde;
+  cached->fde_length = fde->length;
+  cached->fde_cie_delta = fde->CIE_delta;
+  cached->lsda = context->lsda;
+  cached->args_size = context->args_size;
+  cached->fs = *fs;
+#endif
+
   return _URC_NO_REASON;
 }
 
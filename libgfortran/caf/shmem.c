@@ -0,0 +1,1582 @@
+/* Shared-memory implementation of GNU Fortran Coarray Library
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+This file is part of the GNU Fortran Coarray Runtime Library (libcaf).
+
+Libcaf is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+Libcaf is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<http://www.gnu.org/licenses/>.  */
+
+/* The images of a program linked against this library are processes on
+   the same node.  Before anything else runs, the program maps one block
+   of shared memory and forks one process per image, while the original
+   process waits for the images to terminate.  The mapping is at the same
+   address in every image, so pointers into it are valid everywhere.
+
+   Each image owns a segment of the mapping.  Coarrays are allocated by
+   all images in the same order from the first half of their segments,
+   so that the part of a coarray on image I is at a fixed distance from
+   the same part on image J.  Allocatable components, which images
+   allocate independently, come from the second half.  With that, the
+   data transfers of the single image library work unchanged, once the
+   token has been mapped to the other image's memory.
+
+   The number of images is given by GFORTRAN_NUM_IMAGES and defaults to
+   the number of processors; GFORTRAN_SHARED_MEMORY_SIZE sets the size
+   of each image's segment in bytes.  */
+
+#define CAF_SHMEM 1
+
+#include "libcaf.h"
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef HAVE_FORK
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "single.c"
+
+#if defined (HAVE_FORK) && defined (HAVE_WAITPID) && defined (MAP_SHARED)
+#define CAF_HAVE_PROCESSES 1
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#endif
+
+/* The default size of the segment of each image.  Only the memory that
+   is used takes up space.  */
+#define CAF_SEGMENT_SIZE_DEFAULT \
+  (sizeof (void *) >= 8 ? ((size_t) 1 << 30) : ((size_t) 64 << 20))
+
+/* How often to poll a word before sleeping on it.  */
+#define CAF_SPIN_COUNT 1000
+
+
+/* A first-fit allocator for one half of an image's segment.  Only the
+   owning image allocates from it, so it needs no locking, and the same
+   sequence of requests always gives the same offsets.  */
+
+struct heap_block
+{
+  /* The size of the block including this header.  */
+  size_t size;
+  /* The next free block by address, if this block is free.  */
+  struct heap_block *next;
+};
+
+#define HEAP_ALIGN 16
+#define HEAP_HEADER \
+  ((sizeof (struct heap_block) + HEAP_ALIGN - 1) & -HEAP_ALIGN)
+
+struct heap
+{
+  char *start, *end;
+  /* The first byte that has never been allocated.  */
+  char *brk;
+  struct heap_block *free_list;
+};
+
+static void
+heap_init (struct heap *heap, char *start, size_t size)
+{
+  heap->start = heap->brk = start;
+  heap->end = start + size;
+  heap->free_list = NULL;
+}
+
+static void *
+heap_alloc (struct heap *heap, size_t n)
+{
+  struct heap_block *b, **prev;
+  size_t size;
+
+  if (n > (size_t) (heap->end - heap->start))
+    return NULL;
+  size = (HEAP_HEADER + (n ? n : 1) + HEAP_ALIGN - 1) & -HEAP_ALIGN;
+
+  for (prev = &heap->free_list; (b = *prev) != NULL; prev = &b->next)
+    if (b->size >= size)
+      {
+	if (b->size - size >= HEAP_HEADER + HEAP_ALIGN)
+	  {
+	    struct heap_block *rest = (struct heap_block *) ((char *) b + size);
+	    rest->size = b->size - size;
+	    rest->next = b->next;
+	    *prev = rest;
+	    b->size = size;
+	  }
+	else
+	  *prev = b->next;
+	return (char *) b + HEAP_HEADER;
+      }
+
+  if (size > (size_t) (heap->end - heap->brk))
+    return NULL;
+  b = (struct heap_block *) heap->brk;
+  heap->brk += size;
+  b->size = size;
+  return (char *) b + HEAP_HEADER;
+}
+
+static void
+heap_free (struct heap *heap, void *p)
+{
+  struct heap_block *b = (struct heap_block *) ((char *) p - HEAP_HEADER);
+  struct heap_block *before = NULL, *after, **prev;
+
+  for (prev = &heap->free_list; (after = *prev) != NULL && after < b;
+       prev = &after->next)
+    before = after;
+
+  /* Merge with the neighbouring free blocks.  */
+  if (after && (char *) b + b->size == (char *) after)
+    {
+      b->size += after->size;
+      after = after->next;
+    }
+  b->next = after;
+  if (before && (char *) before + before->size == (char *) b)
+    {
+      before->size += b->size;
+      before->next = b->next;
+      b = before;
+    }
+  else
+    *prev = b;
+
+  /* Give the last block back to the unallocated part.  */
+  if ((char *) b + b->size == heap->brk)
+    {
+      heap->brk = (char *) b;
+      for (prev = &heap->free_list; *prev != b; prev = &(*prev)->next)
+	;
+      *prev = NULL;
+    }
+}
+
+
+/* Global variables.  */
+static int caf_this_image;
+static int caf_num_images;
+
+/* The shared mapping, and the size of each image's segment.  */
+static char *caf_region;
+static size_t caf_region_size;
+static char *caf_segments;
+static size_t caf_segment_size;
+
+/* The coarrays of this image, and its allocatable components.  */
+static struct heap caf_symmetric_heap;
+static struct heap caf_private_heap;
+
+/* The state shared between the images, at the start of the mapping.
+   For each image: its status (zero while it is running), the number of
+   SYNC ALL statements it has executed, and the buffer it contributes to
+   the current collective.  For each pair of images I and J, the number
+   of SYNC IMAGES statements I has executed that include J, at
+   [I * caf_num_images + J].  */
+static uint32_t *caf_status;
+static uint32_t *caf_sync_all_count;
+static uint32_t *caf_sync_images_count;
+static void **caf_coll_buf;
+/* Nonzero once an image has initiated error termination.  */
+static uint32_t *caf_error_stop;
+
+/* The number of SYNC ALL and SYNC IMAGES statements this image has
+   executed, as above.  */
+static uint32_t caf_sync_all_local;
+static uint32_t *caf_sync_images_local;
+
+
+/* Sleep until *ADDR might no longer be VAL.  Images wake the waiters
+   when they change a word, but also when they terminate, which the
+   waiter can miss; so sleep only for a limited time.  */
+
+static void
+caf_wait (uint32_t *addr, uint32_t val)
+{
+#if defined (__linux__) && defined (SYS_futex)
+  struct timespec timeout = { 0, 100000000 };
+  syscall (SYS_futex, addr, FUTEX_WAIT, val, &timeout, NULL, 0);
+#else
+  struct timespec timeout = { 0, 100000 };
+  (void) addr;
+  (void) val;
+  nanosleep (&timeout, NULL);
+#endif
+}
+
+static void
+caf_wake (uint32_t *addr)
+{
+#if defined (__linux__) && defined (SYS_futex)
+  syscall (SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+  (void) addr;
+#endif
+}
+
+
+/* Wait until *WORD, which image IMAGE (counting from zero) increments,
+   has reached TARGET.  Return zero, or the status of the image if it
+   has terminated without getting there.  */
+
+static int
+caf_wait_for (int image, uint32_t *word, uint32_t target)
+{
+  int spin = 0;
+
+  while (true)
+    {
+      uint32_t val = __atomic_load_n (word, __ATOMIC_ACQUIRE);
+      uint32_t status;
+
+      if ((int32_t) (val - target) >= 0)
+	return 0;
+      status = __atomic_load_n (&caf_status[image], __ATOMIC_ACQUIRE);
+      if (status != 0)
+	{
+	  val = __atomic_load_n (word, __ATOMIC_ACQUIRE);
+	  return (int32_t) (val - target) >= 0 ? 0 : (int) status;
+	}
+      if (spin < CAF_SPIN_COUNT)
+	spin++;
+      else
+	caf_wait (word, val);
+    }
+}
+
+
+/* Wait for all images to get here.  Return zero, or the status of an
+   image that terminated instead.  */
+
+static int
+caf_barrier (void)
+{
+  int me = caf_this_image - 1;
+  uint32_t count = ++caf_sync_all_local;
+  int i, ret = 0;
+
+  __atomic_store_n (&caf_sync_all_count[me], count, __ATOMIC_RELEASE);
+  caf_wake (&caf_sync_all_count[me]);
+
+  for (i = 0; i < caf_num_images; i++)
+    if (i != me)
+      {
+	int status = caf_wait_for (i, &caf_sync_all_count[i], count);
+	if (status != 0 && ret == 0)
+	  ret = status;
+      }
+  return ret;
+}
+
+
+/* Report the status CODE of an image control statement in STAT and
+   ERRMSG; without STAT, a nonzero CODE terminates the program.  */
+
+static void
+caf_set_stat (int code, const char *msg, int *stat, char *errmsg,
+	      size_t errmsg_len)
+{
+  if (stat)
+    {
+      *stat = code;
+      if (code != 0 && errmsg_len > 0)
+	{
+	  size_t len = strlen (msg);
+	  if (len > errmsg_len)
+	    len = errmsg_len;
+	  memcpy (errmsg, msg, len);
+	  if (errmsg_len > len)
+	    memset (&errmsg[len], ' ', errmsg_len - len);
+	}
+    }
+  else if (code != 0)
+    caf_runtime_error ("%s", msg);
+}
+
+static void
+caf_set_image_stat (int code, int *stat, char *errmsg, size_t errmsg_len)
+{
+  caf_set_stat (code, code == GFC_STAT_FAILED_IMAGE
+			? "An image has failed" : "An image has stopped",
+		stat, errmsg, errmsg_len);
+}
+
+
+/* Mark this image as terminated with STATUS, and wake any image that is
+   waiting for it.  */
+
+static void
+caf_terminate (uint32_t status)
+{
+  int me = caf_this_image - 1;
+  int i;
+
+  if (caf_status == NULL)
+    return;
+
+  __atomic_store_n (&caf_status[me], status, __ATOMIC_RELEASE);
+  caf_wake (&caf_sync_all_count[me]);
+  for (i = 0; i < caf_num_images; i++)
+    caf_wake (&caf_sync_images_count[me * caf_num_images + i]);
+}
+
+
+static size_t
+caf_getenv_size (const char *name, size_t dflt)
+{
+  const char *value = getenv (name);
+  char *end;
+  unsigned long long n;
+
+  if (value == NULL || *value == '\0')
+    return dflt;
+  errno = 0;
+  n = strtoull (value, &end, 10);
+  if (errno != 0 || *end != '\0' || n == 0 || n > SIZE_MAX)
+    caf_runtime_error ("Invalid value %s for environment variable %s",
+		       value, name);
+  return n;
+}
+
+
+#ifdef CAF_HAVE_PROCESSES
+
+/* Wait for the images with process IDs PIDS to terminate, and exit with
+   the first nonzero exit status.  If an image initiates error
+   termination, kill the others.  */
+
+static void __attribute__ ((noreturn))
+caf_supervise (pid_t *pids)
+{
+  int running = caf_num_images, exit_code = 0;
+  bool killing = false;
+
+  while (running > 0)
+    {
+      int status, code, i;
+      pid_t pid = waitpid (-1, &status, 0);
+
+      if (pid < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  break;
+	}
+      for (i = 0; i < caf_num_images; i++)
+	if (pids[i] == pid)
+	  break;
+      if (i == caf_num_images)
+	continue;
+      pids[i] = 0;
+      running--;
+
+      code = WIFEXITED (status) ? WEXITSTATUS (status)
+	     : WIFSIGNALED (status) ? 128 + WTERMSIG (status) : 1;
+      if (!killing
+	  && (code != 0 || __atomic_load_n (caf_error_stop, __ATOMIC_ACQUIRE)))
+	{
+	  exit_code = code;
+	  killing = true;
+	  for (i = 0; i < caf_num_images; i++)
+	    if (pids[i] != 0)
+	      kill (pids[i], SIGKILL);
+	}
+    }
+  exit (exit_code);
+}
+
+#endif
+
+
+/* Set up the shared memory and start the images.  This runs before the
+   constructors that register the static coarrays, but also from
+   _gfortran_caf_register in case those run first.  */
+
+static void
+caf_shmem_init (void)
+{
+  size_t state_size;
+  long page_size, nprocs;
+  char *p;
+  int n;
+
+  if (caf_num_images != 0)
+    return;
+
+#ifdef CAF_HAVE_PROCESSES
+  nprocs = sysconf (_SC_NPROCESSORS_ONLN);
+  n = caf_getenv_size ("GFORTRAN_NUM_IMAGES", nprocs > 0 ? nprocs : 1);
+  if (n > 65536)
+    caf_runtime_error ("Too many images (%d)", n);
+  page_size = sysconf (_SC_PAGESIZE);
+#else
+  n = 1;
+  page_size = 4096;
+#endif
+
+  caf_segment_size = caf_getenv_size ("GFORTRAN_SHARED_MEMORY_SIZE",
+				      CAF_SEGMENT_SIZE_DEFAULT);
+  caf_segment_size = ((caf_segment_size + 2 * page_size - 1)
+		      & -(size_t) (2 * page_size));
+
+  state_size = (3 * sizeof (uint32_t) + sizeof (void *)) * n
+	       + sizeof (uint32_t) * n * n + sizeof (uint32_t);
+  state_size = (state_size + page_size - 1) & -(size_t) page_size;
+  if ((SIZE_MAX - state_size) / n < caf_segment_size)
+    caf_runtime_error ("GFORTRAN_SHARED_MEMORY_SIZE is too large");
+  caf_region_size = state_size + n * caf_segment_size;
+
+#ifdef CAF_HAVE_PROCESSES
+  caf_region = mmap (NULL, caf_region_size, PROT_READ | PROT_WRITE,
+		     MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (caf_region == MAP_FAILED)
+    caf_runtime_error ("Cannot map %lu bytes of shared memory for %d images;"
+		       " try a smaller GFORTRAN_SHARED_MEMORY_SIZE",
+		       (unsigned long) caf_region_size, n);
+#else
+  caf_region = calloc (1, caf_region_size);
+  if (caf_region == NULL)
+    caf_runtime_error ("Cannot allocate %lu bytes for coarrays",
+		       (unsigned long) caf_region_size);
+#endif
+
+  p = caf_region;
+  caf_coll_buf = (void **) p;
+  p += sizeof (void *) * n;
+  caf_status = (uint32_t *) p;
+  caf_sync_all_count = caf_status + n;
+  caf_sync_images_count = caf_sync_all_count + n;
+  caf_error_stop = caf_sync_images_count + n * n;
+  caf_segments = caf_region + state_size;
+
+  caf_num_images = n;
+  caf_this_image = 1;
+
+#ifdef CAF_HAVE_PROCESSES
+  if (n > 1)
+    {
+      pid_t *pids = calloc (n, sizeof (pid_t));
+      pid_t parent = getpid ();
+      int i;
+
+      if (pids == NULL)
+	caf_runtime_error ("Cannot start %d images", n);
+
+      /* Nothing has been written to the standard streams yet, but make
+	 sure that no buffered output is duplicated.  */
+      fflush (NULL);
+
+      for (i = 0; i < n; i++)
+	{
+	  pid_t pid = fork ();
+	  if (pid == 0)
+	    {
+	      free (pids);
+	      caf_this_image = i + 1;
+#ifdef __linux__
+	      /* Don't outlive the original process.  */
+	      prctl (PR_SET_PDEATHSIG, SIGKILL);
+	      if (getppid () != parent)
+		_exit (EXIT_FAILURE);
+#endif
+	      break;
+	    }
+	  if (pid < 0)
+	    {
+	      int err = errno;
+	      while (i-- > 0)
+		kill (pids[i], SIGKILL);
+	      caf_runtime_error ("Cannot start image %d: %s", i + 1,
+				 strerror (err));
+	    }
+	  pids[i] = pid;
+	}
+      if (i == n)
+	caf_supervise (pids);
+      (void) parent;
+    }
+#endif
+
+  p = caf_segments + (caf_this_image - 1) * caf_segment_size;
+  heap_init (&caf_symmetric_heap, p, caf_segment_size / 2);
+  heap_init (&caf_private_heap, p + caf_segment_size / 2,
+	     caf_segment_size / 2);
+
+  caf_sync_images_local = calloc (n, sizeof (uint32_t));
+  if (caf_sync_images_local == NULL)
+    caf_runtime_error ("Cannot allocate memory for image %d",
+		       caf_this_image);
+}
+
+/* Start the images before the constructors that register the static
+   coarrays run.  */
+
+static void __attribute__ ((constructor (101)))
+caf_shmem_constructor (void)
+{
+  caf_shmem_init ();
+}
+
+
+/* Return true if P points into the shared mapping.  */
+
+static inline bool
+caf_shared_p (const void *p)
+{
+  return (const char *) p >= caf_region
+	 && (const char *) p < caf_region + caf_region_size;
+}
+
+
+static caf_token_t
+caf_image_token (caf_token_t token, int image_index,
+		 struct caf_image_view *view)
+{
+  caf_single_token_t local = TOKEN (token);
+  ptrdiff_t delta;
+
+  if (image_index == 0 || image_index == caf_this_image)
+    return token;
+  if (image_index < 0 || image_index > caf_num_images)
+    caf_runtime_error ("Image index %d is out of range 1 to %d",
+		       image_index, caf_num_images);
+
+  delta = (ptrdiff_t) (image_index - caf_this_image)
+	  * (ptrdiff_t) caf_segment_size;
+  view->token.memptr = local->memptr ? (char *) local->memptr + delta : NULL;
+  view->token.owning_memory = false;
+  view->token.desc = NULL;
+  if (local->desc)
+    {
+      /* The descriptor is the same on all images, except for the data
+	 pointer.  */
+      memcpy (&view->desc, local->desc,
+	      sizeof (gfc_descriptor_t) + GFC_DESCRIPTOR_RANK (local->desc)
+					  * sizeof (descriptor_dimension));
+      view->desc.base_addr = (char *) view->desc.base_addr + delta;
+      view->token.desc = (gfc_descriptor_t *) &view->desc;
+    }
+  return &view->token;
+}
+
+
+void
+_gfortran_caf_init (int *argc __attribute__ ((unused)),
+		    char ***argv __attribute__ ((unused)))
+{
+  caf_shmem_init ();
+}
+
+
+void
+_gfortran_caf_finalize (void)
+{
+  caf_terminate (GFC_STAT_STOPPED_IMAGE);
+}
+
+
+int
+_gfortran_caf_this_image (int distance __attribute__ ((unused)))
+{
+  return caf_this_image;
+}
+
+
+int
+_gfortran_caf_num_images (int distance __attribute__ ((unused)),
+			  int failed)
+{
+  int i, n = 0;
+
+  if (failed < 0)
+    return caf_num_images;
+
+  for (i = 0; i < caf_num_images; i++)
+    if ((__atomic_load_n (&caf_status[i], __ATOMIC_RELAXED)
+	 == GFC_STAT_FAILED_IMAGE) == (failed != 0))
+      n++;
+  return n;
+}
+
+
+void
+_gfortran_caf_register (size_t size, caf_register_t type, caf_token_t *token,
+			gfc_descriptor_t *data, int *stat, char *errmsg,
+			size_t errmsg_len)
+{
+  const char alloc_fail_msg[] = "Failed to allocate coarray";
+  struct heap *heap;
+  void *local;
+  caf_single_token_t shmem_token;
+
+  caf_shmem_init ();
+
+  /* The tokens of allocatable components are stored within the coarray
+     they belong to.  Each image allocates those on its own, so they
+     must not come from the symmetric heap.  */
+  heap = caf_shared_p (token) ? &caf_private_heap : &caf_symmetric_heap;
+
+  if (type == CAF_REGTYPE_LOCK_STATIC || type == CAF_REGTYPE_LOCK_ALLOC
+      || type == CAF_REGTYPE_CRITICAL || type == CAF_REGTYPE_EVENT_STATIC
+      || type == CAF_REGTYPE_EVENT_ALLOC)
+    {
+      /* Locks and events are words that the images wait on.  */
+      local = size <= SIZE_MAX / sizeof (uint32_t)
+	      ? heap_alloc (heap, size * sizeof (uint32_t)) : NULL;
+      if (local)
+	memset (local, 0, size * sizeof (uint32_t));
+    }
+  else if (type == CAF_REGTYPE_COARRAY_ALLOC_REGISTER_ONLY)
+    local = NULL;
+  else
+    local = heap_alloc (heap, size);
+
+  if (type != CAF_REGTYPE_COARRAY_ALLOC_ALLOCATE_ONLY)
+    *token = heap_alloc (&caf_private_heap,
+			 sizeof (struct caf_single_token));
+
+  if (unlikely (*token == NULL
+		|| (local == NULL
+		    && type != CAF_REGTYPE_COARRAY_ALLOC_REGISTER_ONLY)))
+    {
+      if (local)
+	heap_free (heap, local);
+      if (*token && type != CAF_REGTYPE_COARRAY_ALLOC_ALLOCATE_ONLY)
+	{
+	  heap_free (&caf_private_heap, *token);
+	  *token = NULL;
+	}
+      caf_internal_error (alloc_fail_msg, stat, errmsg, errmsg_len);
+      return;
+    }
+
+  shmem_token = TOKEN (*token);
+  shmem_token->memptr = local;
+  shmem_token->owning_memory = type != CAF_REGTYPE_COARRAY_ALLOC_REGISTER_ONLY;
+  /* The descriptors of static coarrays are temporaries.  */
+  shmem_token->desc = (GFC_DESCRIPTOR_RANK (data) > 0
+		       && type != CAF_REGTYPE_COARRAY_STATIC
+		       && type != CAF_REGTYPE_LOCK_STATIC
+		       && type != CAF_REGTYPE_EVENT_STATIC
+		       && type != CAF_REGTYPE_CRITICAL) ? data : NULL;
+  GFC_DESCRIPTOR_DATA (data) = local;
+
+  if (stat)
+    *stat = 0;
+
+  /* Allocating a coarray synchronizes all images.  */
+  if (heap == &caf_symmetric_heap
+      && (type == CAF_REGTYPE_COARRAY_ALLOC || type == CAF_REGTYPE_LOCK_ALLOC
+	  || type == CAF_REGTYPE_EVENT_ALLOC))
+    caf_set_image_stat (caf_barrier (), stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_deregister (caf_token_t *token, caf_deregister_t type, int *stat,
+			  char *errmsg, size_t errmsg_len)
+{
+  caf_single_token_t shmem_token = TOKEN (*token);
+  void *memptr = shmem_token->memptr;
+  int status = 0;
+
+  if (shmem_token->owning_memory && memptr)
+    {
+      if (memptr >= (void *) caf_symmetric_heap.start
+	  && memptr < (void *) caf_symmetric_heap.end)
+	{
+	  /* Deallocating a coarray synchronizes all images; don't free the
+	     memory while other images might still access it.  */
+	  status = caf_barrier ();
+	  heap_free (&caf_symmetric_heap, memptr);
+	}
+      else
+	heap_free (&caf_private_heap, memptr);
+    }
+
+  if (type != CAF_DEREGTYPE_COARRAY_DEALLOCATE_ONLY)
+    {
+      heap_free (&caf_private_heap, *token);
+      *token = NULL;
+    }
+  else
+    {
+      shmem_token->memptr = NULL;
+      shmem_token->owning_memory = false;
+    }
+
+  caf_set_image_stat (status, stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_sync_all (int *stat, char *errmsg, size_t errmsg_len)
+{
+  caf_set_image_stat (caf_barrier (), stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_sync_memory (int *stat,
+			   char *errmsg __attribute__ ((unused)),
+			   size_t errmsg_len __attribute__ ((unused)))
+{
+  __atomic_thread_fence (__ATOMIC_SEQ_CST);
+  if (stat)
+    *stat = 0;
+}
+
+
+void
+_gfortran_caf_sync_images (int count, int images[], int *stat, char *errmsg,
+			   size_t errmsg_len)
+{
+  int me = caf_this_image - 1;
+  bool all = count < 0;
+  int i, ret = 0;
+
+  /* A COUNT of -1 stands for all images.  */
+  if (all)
+    count = caf_num_images;
+
+  for (i = 0; i < count; i++)
+    {
+      int image = all ? i : images[i] - 1;
+      uint32_t *word;
+
+      if (image < 0 || image >= caf_num_images)
+	{
+	  char msg[80];
+	  snprintf (msg, sizeof (msg), "Invalid image index %d to SYNC IMAGES",
+		    image + 1);
+	  caf_set_stat (1, msg, stat, errmsg, errmsg_len);
+	  return;
+	}
+      if (image == me)
+	continue;
+      word = &caf_sync_images_count[me * caf_num_images + image];
+      __atomic_store_n (word, ++caf_sync_images_local[image],
+			__ATOMIC_RELEASE);
+      caf_wake (word);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      int image = all ? i : images[i] - 1;
+      int status;
+
+      if (image == me)
+	continue;
+      status = caf_wait_for (image,
+			     &caf_sync_images_count[image * caf_num_images
+						    + me],
+			     caf_sync_images_local[image]);
+      if (status != 0 && ret == 0)
+	ret = status;
+    }
+
+  caf_set_image_stat (ret, stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_stop_numeric (int stop_code, bool quiet)
+{
+  if (!quiet)
+    fprintf (stderr, "STOP %d\n", stop_code);
+  caf_terminate (GFC_STAT_STOPPED_IMAGE);
+  exit (0);
+}
+
+
+void
+_gfortran_caf_stop_str (const char *string, size_t len, bool quiet)
+{
+  if (!quiet)
+    {
+      fputs ("STOP ", stderr);
+      while (len--)
+	fputc (*(string++), stderr);
+      fputs ("\n", stderr);
+    }
+  caf_terminate (GFC_STAT_STOPPED_IMAGE);
+  exit (0);
+}
+
+
+/* Initiate error termination: the original process kills the other
+   images when this one exits.  */
+
+void
+_gfortran_caf_error_stop_str (const char *string, size_t len, bool quiet)
+{
+  if (caf_error_stop)
+    __atomic_store_n (caf_error_stop, 1, __ATOMIC_RELEASE);
+  if (!quiet)
+    {
+      fputs ("ERROR STOP ", stderr);
+      while (len--)
+	fputc (*(string++), stderr);
+      fputs ("\n", stderr);
+    }
+  exit (1);
+}
+
+
+void
+_gfortran_caf_error_stop (int error, bool quiet)
+{
+  if (caf_error_stop)
+    __atomic_store_n (caf_error_stop, 1, __ATOMIC_RELEASE);
+  if (!quiet)
+    fprintf (stderr, "ERROR STOP %d\n", error);
+  exit (error);
+}
+
+
+void
+_gfortran_caf_fail_image (void)
+{
+  fputs ("IMAGE FAILED!\n", stderr);
+  caf_terminate (GFC_STAT_FAILED_IMAGE);
+  exit (0);
+}
+
+
+int
+_gfortran_caf_image_status (int image,
+			    caf_team_t * team __attribute__ ((unused)))
+{
+  if (image < 1 || image > caf_num_images)
+    caf_runtime_error ("Image index %d is out of range 1 to %d", image,
+		       caf_num_images);
+  return __atomic_load_n (&caf_status[image - 1], __ATOMIC_ACQUIRE);
+}
+
+
+/* Set ARRAY to the indices of the images whose status is STATUS.  */
+
+static void
+images_with_status (gfc_descriptor_t *array, int *kind, uint32_t status)
+{
+  int local_kind = kind != NULL ? *kind : 4;
+  int i, n = 0;
+
+  array->base_addr = NULL;
+  array->dtype.type = BT_INTEGER;
+  array->dtype.elem_len = local_kind;
+  array->offset = 0;
+
+  for (i = 0; i < caf_num_images; i++)
+    if (__atomic_load_n (&caf_status[i], __ATOMIC_ACQUIRE) == status)
+      {
+	if (array->base_addr == NULL)
+	  {
+	    array->base_addr = malloc (caf_num_images * local_kind);
+	    if (array->base_addr == NULL)
+	      caf_runtime_error ("Cannot allocate memory for image list");
+	  }
+	switch (local_kind)
+	  {
+	  case 1:
+	    ((int8_t *) array->base_addr)[n] = i + 1;
+	    break;
+	  case 2:
+	    ((int16_t *) array->base_addr)[n] = i + 1;
+	    break;
+	  case 4:
+	    ((int32_t *) array->base_addr)[n] = i + 1;
+	    break;
+	  case 8:
+	    ((int64_t *) array->base_addr)[n] = i + 1;
+	    break;
+	  default:
+	    caf_runtime_error ("Unsupported integer kind %d", local_kind);
+	  }
+	n++;
+      }
+
+  /* Setting lower_bound higher then upper_bound is what the compiler does
+     to indicate an empty array.  */
+  array->dim[0].lower_bound = 0;
+  array->dim[0]._ubound = n - 1;
+  array->dim[0]._stride = 1;
+}
+
+void
+_gfortran_caf_failed_images (gfc_descriptor_t *array,
+			     caf_team_t * team __attribute__ ((unused)),
+			     int * kind)
+{
+  images_with_status (array, kind, GFC_STAT_FAILED_IMAGE);
+}
+
+void
+_gfortran_caf_stopped_images (gfc_descriptor_t *array,
+			      caf_team_t * team __attribute__ ((unused)),
+			      int * kind)
+{
+  images_with_status (array, kind, GFC_STAT_STOPPED_IMAGE);
+}
+
+
+/* Collectives.  Each image copies its argument to a buffer in its
+   segment; after a barrier, the images that need the result combine
+   the buffers of all images, in the order of the images so that they
+   all get the same result; a second barrier keeps the buffers alive
+   until everybody is done.  */
+
+typedef enum
+{
+  CO_SUM,
+  CO_MIN,
+  CO_MAX
+}
+co_op;
+
+static size_t
+co_num_elems (gfc_descriptor_t *a)
+{
+  size_t n = 1;
+  int i;
+
+  for (i = 0; i < GFC_DESCRIPTOR_RANK (a); i++)
+    {
+      index_type extent = GFC_DESCRIPTOR_EXTENT (a, i);
+      if (extent <= 0)
+	return 0;
+      n *= extent;
+    }
+  return n;
+}
+
+/* Copy the elements of A to the contiguous BUF, or back if !TO_BUF.  */
+
+static void
+co_copy (gfc_descriptor_t *a, char *buf, bool to_buf)
+{
+  size_t size = GFC_DESCRIPTOR_SIZE (a);
+  int rank = GFC_DESCRIPTOR_RANK (a);
+  index_type count[GFC_MAX_DIMENSIONS];
+  char *p = GFC_DESCRIPTOR_DATA (a);
+  int n;
+
+  if (rank == 0)
+    {
+      if (to_buf)
+	memcpy (buf, p, size);
+      else
+	memcpy (p, buf, size);
+      return;
+    }
+  if (co_num_elems (a) == 0)
+    return;
+
+  memset (count, 0, sizeof (count));
+  while (true)
+    {
+      if (to_buf)
+	memcpy (buf, p, size);
+      else
+	memcpy (p, buf, size);
+      buf += size;
+      p += GFC_DESCRIPTOR_STRIDE_BYTES (a, 0);
+      count[0]++;
+      n = 0;
+      while (count[n] == GFC_DESCRIPTOR_EXTENT (a, n))
+	{
+	  count[n] = 0;
+	  p -= GFC_DESCRIPTOR_STRIDE_BYTES (a, n) * GFC_DESCRIPTOR_EXTENT (a, n);
+	  if (++n == rank)
+	    return;
+	  count[n]++;
+	  p += GFC_DESCRIPTOR_STRIDE_BYTES (a, n);
+	}
+    }
+}
+
+/* Publish the elements of A to the other images.  */
+
+static int
+co_begin (gfc_descriptor_t *a)
+{
+  size_t bytes = co_num_elems (a) * GFC_DESCRIPTOR_SIZE (a);
+  void *buf = heap_alloc (&caf_private_heap, bytes);
+
+  if (buf == NULL)
+    caf_runtime_error ("Out of shared memory for a collective of %lu bytes",
+		       (unsigned long) bytes);
+  co_copy (a, buf, true);
+  caf_coll_buf[caf_this_image - 1] = buf;
+  return caf_barrier ();
+}
+
+static int
+co_end (int status)
+{
+  int end_status = caf_barrier ();
+
+  heap_free (&caf_private_heap, caf_coll_buf[caf_this_image - 1]);
+  return status != 0 ? status : end_status;
+}
+
+#define CO_SUM_LOOP(TYPE) \
+  do { \
+    for (i = 0; i < n; i++) \
+      ((TYPE *) res)[i] += ((TYPE *) src)[i]; \
+  } while (0)
+
+#define CO_MINMAX_LOOP(TYPE) \
+  do { \
+    for (i = 0; i < n; i++) \
+      if (op == CO_MIN ? ((TYPE *) src)[i] < ((TYPE *) res)[i] \
+		       : ((TYPE *) src)[i] > ((TYPE *) res)[i]) \
+	((TYPE *) res)[i] = ((TYPE *) src)[i]; \
+  } while (0)
+
+/* Combine the N elements of SRC into RES with OP.  Return false if
+   the type is not supported.  */
+
+static bool
+co_combine (void *res, void *src, size_t n, int type, size_t size,
+	    int a_len, co_op op)
+{
+  size_t i;
+
+  switch (type)
+    {
+    case BT_INTEGER:
+      switch (size)
+	{
+	case 1:
+	  if (op == CO_SUM) CO_SUM_LOOP (GFC_INTEGER_1);
+	  else CO_MINMAX_LOOP (GFC_INTEGER_1);
+	  return true;
+	case 2:
+	  if (op == CO_SUM) CO_SUM_LOOP (GFC_INTEGER_2);
+	  else CO_MINMAX_LOOP (GFC_INTEGER_2);
+	  return true;
+	case 4:
+	  if (op == CO_SUM) CO_SUM_LOOP (GFC_INTEGER_4);
+	  else CO_MINMAX_LOOP (GFC_INTEGER_4);
+	  return true;
+	case 8:
+	  if (op == CO_SUM) CO_SUM_LOOP (GFC_INTEGER_8);
+	  else CO_MINMAX_LOOP (GFC_INTEGER_8);
+	  return true;
+#ifdef HAVE_GFC_INTEGER_16
+	case 16:
+	  if (op == CO_SUM) CO_SUM_LOOP (GFC_INTEGER_16);
+	  else CO_MINMAX_LOOP (GFC_INTEGER_16);
+	  return true;
+#endif
+	}
+      return false;
+
+    case BT_REAL:
+      switch (size)
+	{
+	case 4:
+	  if (op == CO_SUM) CO_SUM_LOOP (GFC_REAL_4);
+	  else CO_MINMAX_LOOP (GFC_REAL_4);
+	  return true;
+	case 8:
+	  if (op == CO_SUM) CO_SUM_LOOP (GFC_REAL_8);
+	  else CO_MINMAX_LOOP (GFC_REAL_8);
+	  return true;
+	default:
+#if defined (HAVE_GFC_REAL_10) && defined (HAVE_GFC_REAL_16)
+	  /* The kinds can't be told apart if they have the same size.  */
+	  if (sizeof (GFC_REAL_10) == sizeof (GFC_REAL_16))
+	    return false;
+#endif
+#ifdef HAVE_GFC_REAL_10
+	  if (size == sizeof (GFC_REAL_10))
+	    {
+	      if (op == CO_SUM) CO_SUM_LOOP (GFC_REAL_10);
+	      else CO_MINMAX_LOOP (GFC_REAL_10);
+	      return true;
+	    }
+#endif
+#ifdef HAVE_GFC_REAL_16
+	  if (size == sizeof (GFC_REAL_16))
+	    {
+	      if (op == CO_SUM) CO_SUM_LOOP (GFC_REAL_16);
+	      else CO_MINMAX_LOOP (GFC_REAL_16);
+	      return true;
+	    }
+#endif
+	  return false;
+	}
+
+    case BT_COMPLEX:
+      if (op != CO_SUM)
+	return false;
+      switch (size)
+	{
+	case 8:
+	  CO_SUM_LOOP (GFC_COMPLEX_4);
+	  return true;
+	case 16:
+	  CO_SUM_LOOP (GFC_COMPLEX_8);
+	  return true;
+	default:
+#if defined (HAVE_GFC_COMPLEX_10) && defined (HAVE_GFC_COMPLEX_16)
+	  /* The kinds can't be told apart if they have the same size.  */
+	  if (sizeof (GFC_COMPLEX_10) == sizeof (GFC_COMPLEX_16))
+	    return false;
+#endif
+#ifdef HAVE_GFC_COMPLEX_10
+	  if (size == sizeof (GFC_COMPLEX_10))
+	    {
+	      CO_SUM_LOOP (GFC_COMPLEX_10);
+	      return true;
+	    }
+#endif
+#ifdef HAVE_GFC_COMPLEX_16
+	  if (size == sizeof (GFC_COMPLEX_16))
+	    {
+	      CO_SUM_LOOP (GFC_COMPLEX_16);
+	      return true;
+	    }
+#endif
+	  return false;
+	}
+
+    case BT_CHARACTER:
+      if (op == CO_SUM || a_len <= 0)
+	return false;
+      for (i = 0; i < n; i++)
+	{
+	  char *x = (char *) res + i * size, *y = (char *) src + i * size;
+	  int cmp;
+
+	  if (size == (size_t) a_len)
+	    cmp = memcmp (y, x, size);
+	  else
+	    {
+	      /* Kind 4 characters compare by code point.  */
+	      gfc_char4_t *x4 = (gfc_char4_t *) x, *y4 = (gfc_char4_t *) y;
+	      int j;
+
+	      cmp = 0;
+	      for (j = 0; j < a_len && cmp == 0; j++)
+		cmp = (y4[j] > x4[j]) - (y4[j] < x4[j]);
+	    }
+	  if (op == CO_MIN ? cmp < 0 : cmp > 0)
+	    memcpy (x, y, size);
+	}
+      return true;
+
+    default:
+      return false;
+    }
+}
+
+/* Reduce A over all images with OP, storing the result on image
+   RESULT_IMAGE or, if that is zero, on all of them.  */
+
+static void
+co_reduction (gfc_descriptor_t *a, co_op op, int result_image, int *stat,
+	      char *errmsg, int a_len, size_t errmsg_len)
+{
+  size_t n = co_num_elems (a);
+  size_t size = GFC_DESCRIPTOR_SIZE (a);
+  int status = co_begin (a);
+
+  if (status == 0 && (result_image == 0 || result_image == caf_this_image))
+    {
+      char *res = malloc (n * size + 1);
+      int i;
+
+      if (res == NULL)
+	caf_runtime_error ("Cannot allocate memory for a collective");
+      memcpy (res, caf_coll_buf[0], n * size);
+      for (i = 1; i < caf_num_images; i++)
+	if (!co_combine (res, caf_coll_buf[i], n, GFC_DESCRIPTOR_TYPE (a),
+			 size, a_len, op))
+	  caf_runtime_error ("Unsupported type in collective subroutine");
+      co_copy (a, res, false);
+      free (res);
+    }
+
+  caf_set_image_stat (co_end (status), stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_co_broadcast (gfc_descriptor_t *a, int source_image, int *stat,
+			    char *errmsg, size_t errmsg_len)
+{
+  int status;
+
+  if (source_image < 1 || source_image > caf_num_images)
+    caf_runtime_error ("Image index %d is out of range 1 to %d",
+		       source_image, caf_num_images);
+
+  status = co_begin (a);
+  if (status == 0 && source_image != caf_this_image)
+    co_copy (a, caf_coll_buf[source_image - 1], false);
+  caf_set_image_stat (co_end (status), stat, errmsg, errmsg_len);
+}
+
+void
+_gfortran_caf_co_sum (gfc_descriptor_t *a, int result_image, int *stat,
+		      char *errmsg, size_t errmsg_len)
+{
+  co_reduction (a, CO_SUM, result_image, stat, errmsg, 0, errmsg_len);
+}
+
+void
+_gfortran_caf_co_min (gfc_descriptor_t *a, int result_image, int *stat,
+		      char *errmsg, int a_len, size_t errmsg_len)
+{
+  co_reduction (a, CO_MIN, result_image, stat, errmsg, a_len, errmsg_len);
+}
+
+void
+_gfortran_caf_co_max (gfc_descriptor_t *a, int result_image, int *stat,
+		      char *errmsg, int a_len, size_t errmsg_len)
+{
+  co_reduction (a, CO_MAX, result_image, stat, errmsg, a_len, errmsg_len);
+}
+
+
+typedef void (*co_fn) (void);
+
+#define CO_REDUCE_LOOP(TYPE) \
+  do { \
+    if (opr_flags & GFC_CAF_ARG_VALUE) \
+      { \
+	TYPE (*f) (TYPE, TYPE) = (TYPE (*) (TYPE, TYPE)) (co_fn) opr; \
+	for (i = 0; i < n; i++) \
+	  ((TYPE *) res)[i] = f (((TYPE *) res)[i], ((TYPE *) src)[i]); \
+      } \
+    else \
+      { \
+	TYPE (*f) (TYPE *, TYPE *) = (TYPE (*) (TYPE *, TYPE *)) (co_fn) opr; \
+	for (i = 0; i < n; i++) \
+	  ((TYPE *) res)[i] = f (&((TYPE *) res)[i], &((TYPE *) src)[i]); \
+      } \
+  } while (0)
+
+/* Combine the N elements of SRC into RES with the user function OPR.
+   Functions returning character values and intrinsic types are
+   supported.  Return false for anything else.  */
+
+static bool
+co_reduce_combine (void *res, void *src, size_t n, int type, size_t size,
+		   void *(*opr) (void *, void *), int opr_flags, int a_len)
+{
+  size_t i;
+
+  if (type == BT_CHARACTER)
+    {
+      typedef void (*char_fn) (char *, gfc_charlen_type, char *, char *,
+			       gfc_charlen_type, gfc_charlen_type);
+      char_fn f = (char_fn) (co_fn) opr;
+      char *tmp;
+
+      if ((opr_flags & (GFC_CAF_BYREF | GFC_CAF_HIDDENLEN))
+	  != (GFC_CAF_BYREF | GFC_CAF_HIDDENLEN)
+	  || (opr_flags & GFC_CAF_ARG_VALUE) || a_len <= 0)
+	return false;
+      tmp = malloc (size);
+      if (tmp == NULL)
+	caf_runtime_error ("Cannot allocate memory for a collective");
+      for (i = 0; i < n; i++)
+	{
+	  char *x = (char *) res + i * size, *y = (char *) src + i * size;
+	  f (tmp, a_len, x, y, a_len, a_len);
+	  memcpy (x, tmp, size);
+	}
+      free (tmp);
+      return true;
+    }
+
+  if (opr_flags & (GFC_CAF_BYREF | GFC_CAF_HIDDENLEN | GFC_CAF_ARG_DESC))
+    return false;
+
+  switch (type)
+    {
+    case BT_INTEGER:
+    case BT_LOGICAL:
+      switch (size)
+	{
+	case 1:
+	  CO_REDUCE_LOOP (GFC_INTEGER_1);
+	  return true;
+	case 2:
+	  CO_REDUCE_LOOP (GFC_INTEGER_2);
+	  return true;
+	case 4:
+	  CO_REDUCE_LOOP (GFC_INTEGER_4);
+	  return true;
+	case 8:
+	  CO_REDUCE_LOOP (GFC_INTEGER_8);
+	  return true;
+#ifdef HAVE_GFC_INTEGER_16
+	case 16:
+	  CO_REDUCE_LOOP (GFC_INTEGER_16);
+	  return true;
+#endif
+	}
+      return false;
+
+    case BT_REAL:
+      switch (size)
+	{
+	case 4:
+	  CO_REDUCE_LOOP (GFC_REAL_4);
+	  return true;
+	case 8:
+	  CO_REDUCE_LOOP (GFC_REAL_8);
+	  return true;
+	default:
+#if defined (HAVE_GFC_REAL_10) && defined (HAVE_GFC_REAL_16)
+	  /* The kinds can't be told apart if they have the same size.  */
+	  if (sizeof (GFC_REAL_10) == sizeof (GFC_REAL_16))
+	    return false;
+#endif
+#ifdef HAVE_GFC_REAL_10
+	  if (size == sizeof (GFC_REAL_10))
+	    {
+	      CO_REDUCE_LOOP (GFC_REAL_10);
+	      return true;
+	    }
+#endif
+#ifdef HAVE_GFC_REAL_16
+	  if (size == sizeof (GFC_REAL_16))
+	    {
+	      CO_REDUCE_LOOP (GFC_REAL_16);
+	      return true;
+	    }
+#endif
+	  return false;
+	}
+
+    case BT_COMPLEX:
+      switch (size)
+	{
+	case 8:
+	  CO_REDUCE_LOOP (GFC_COMPLEX_4);
+	  return true;
+	case 16:
+	  CO_REDUCE_LOOP (GFC_COMPLEX_8);
+	  return true;
+	default:
+#if defined (HAVE_GFC_COMPLEX_10) && defined (HAVE_GFC_COMPLEX_16)
+	  /* The kinds can't be told apart if they have the same size.  */
+	  if (sizeof (GFC_COMPLEX_10) == sizeof (GFC_COMPLEX_16))
+	    return false;
+#endif
+#ifdef HAVE_GFC_COMPLEX_10
+	  if (size == sizeof (GFC_COMPLEX_10))
+	    {
+	      CO_REDUCE_LOOP (GFC_COMPLEX_10);
+	      return true;
+	    }
+#endif
+#ifdef HAVE_GFC_COMPLEX_16
+	  if (size == sizeof (GFC_COMPLEX_16))
+	    {
+	      CO_REDUCE_LOOP (GFC_COMPLEX_16);
+	      return true;
+	    }
+#endif
+	  return false;
+	}
+
+    default:
+      return false;
+    }
+}
+
+void
+_gfortran_caf_co_reduce (gfc_descriptor_t *a, void * (*opr) (void *, void *),
+			 int opr_flags, int result_image, int *stat,
+			 char *errmsg, int a_len, size_t errmsg_len)
+{
+  size_t n = co_num_elems (a);
+  size_t size = GFC_DESCRIPTOR_SIZE (a);
+  int status = co_begin (a);
+
+  if (status == 0 && (result_image == 0 || result_image == caf_this_image))
+    {
+      char *res = malloc (n * size + 1);
+      int i;
+
+      if (res == NULL)
+	caf_runtime_error ("Cannot allocate memory for a collective");
+      memcpy (res, caf_coll_buf[0], n * size);
+      for (i = 1; i < caf_num_images; i++)
+	if (!co_reduce_combine (res, caf_coll_buf[i], n,
+				GFC_DESCRIPTOR_TYPE (a), size, opr, opr_flags,
+				a_len))
+	  caf_runtime_error ("Unsupported type or function in CO_REDUCE");
+      co_copy (a, res, false);
+      free (res);
+    }
+
+  caf_set_image_stat (co_end (status), stat, errmsg, errmsg_len);
+}
+
+
+void
+_gfortran_caf_event_post (caf_token_t token, size_t index, int image_index,
+			  int *stat, char *errmsg __attribute__ ((unused)),
+			  size_t errmsg_len __attribute__ ((unused)))
+{
+  struct caf_image_view view;
+  uint32_t *event;
+
+  token = caf_image_token (token, image_index, &view);
+  event = (uint32_t *) MEMTOK (token) + index;
+  __atomic_fetch_add (event, 1, __ATOMIC_RELEASE);
+  caf_wake (event);
+
+  if (stat)
+    *stat = 0;
+}
+
+void
+_gfortran_caf_event_wait (caf_token_t token, size_t index, int until_count,
+			  int *stat, char *errmsg __attribute__ ((unused)),
+			  size_t errmsg_len __attribute__ ((unused)))
+{
+  uint32_t *event = (uint32_t *) MEMTOK (token) + index;
+  uint32_t until = until_count > 0 ? until_count : 1;
+  uint32_t count = __atomic_load_n (event, __ATOMIC_ACQUIRE);
+
+  while (true)
+    {
+      if (count < until)
+	{
+	  caf_wait (event, count);
+	  count = __atomic_load_n (event, __ATOMIC_ACQUIRE);
+	}
+      else if (__atomic_compare_exchange_n (event, &count, count - until,
+					    false, __ATOMIC_ACQ_REL,
+					    __ATOMIC_ACQUIRE))
+	break;
+    }
+
+  if (stat)
+    *stat = 0;
+}
+
+void
+_gfortran_caf_event_query (caf_token_t token, size_t index, int image_index,
+			   int *count, int *stat)
+{
+  struct caf_image_view view;
+  uint32_t *event;
+
+  token = caf_image_token (token, image_index, &view);
+  event = (uint32_t *) MEMTOK (token) + index;
+  *count = __atomic_load_n (event, __ATOMIC_ACQUIRE);
+
+  if (stat)
+    *stat = 0;
+}
+
+
+/* A lock holds the index of the image that has locked it, or zero.  */
+
+void
+_gfortran_caf_lock (caf_token_t token, size_t index, int image_index,
+		    int *aquired_lock, int *stat, char *errmsg,
+		    size_t errmsg_len)
+{
+  struct caf_image_view view;
+  uint32_t *lock, expected = 0;
+
+  token = caf_image_token (token, image_index, &view);
+  lock = (uint32_t *) MEMTOK (token) + index;
+
+  while (!__atomic_compare_exchange_n (lock, &expected, caf_this_image, false,
+				       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+      if (expected == (uint32_t) caf_this_image)
+	{
+	  caf_set_stat (GFC_STAT_LOCKED, "Already locked", stat, errmsg,
+			errmsg_len);
+	  return;
+	}
+      if (aquired_lock)
+	{
+	  *aquired_lock = (int) false;
+	  if (stat)
+	    *stat = 0;
+	  return;
+	}
+      caf_wait (lock, expected);
+      expected = 0;
+    }
+
+  if (aquired_lock)
+    *aquired_lock = (int) true;
+  if (stat)
+    *stat = 0;
+}
+
+
+void
+_gfortran_caf_unlock (caf_token_t token, size_t index, int image_index,
+		      int *stat, char *errmsg, size_t errmsg_len)
+{
+  struct caf_image_view view;
+  uint32_t *lock, expected = caf_this_image;
+
+  token = caf_image_token (token, image_index, &view);
+  lock = (uint32_t *) MEMTOK (token) + index;
+
+  if (!__atomic_compare_exchange_n (lock, &expected, 0, false,
+				    __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    {
+      if (expected == 0)
+	caf_set_stat (GFC_STAT_UNLOCKED, "Variable is not locked", stat,
+		      errmsg, errmsg_len);
+      else
+	caf_set_stat (GFC_STAT_LOCKED_OTHER_IMAGE,
+		      "Variable is locked by another image", stat, errmsg,
+		      errmsg_len);
+      return;
+    }
+  caf_wake (lock);
+
+  if (stat)
+    *stat = 0;
+}
@@ -50,6 +50,31 @@ typedef struct caf_single_token *caf_single_token_t;
 #define TOKEN(X) ((caf_single_token_t) (X))
 #define MEMTOK(X) ((caf_single_token_t) (X))->memptr
 
+/* The token and descriptor through which the part of a coarray on
+   another image is accessed.  */
+struct caf_image_view
+{
+  struct caf_single_token token;
+  GFC_FULL_ARRAY_DESCRIPTOR (GFC_MAX_DIMENSIONS, void) desc;
+};
+
+#ifdef CAF_SHMEM
+/* shmem.c includes this file for the data transfers, and provides the
+   image control functions itself.  */
+static caf_token_t caf_image_token (caf_token_t, int, struct caf_image_view *);
+#else
+/* Return the token for the part of the coarray described by TOKEN on
+   image IMAGE_INDEX, using VIEW for storage if needed.  With a single
+   image, that is always TOKEN.  */
+
+static inline caf_token_t
+caf_image_token (caf_token_t token, int image_index __attribute__ ((unused)),
+		 struct caf_image_view *view __attribute__ ((unused)))
+{
+  return token;
+}
+#endif
+
 /* Single-image implementation of the CAF library.
    Note: For performance reasons -fcoarry=single should be used
    rather than this library.  */
@@ -97,6 +122,8 @@ caf_internal_error (const char *msg, int *stat, char *errmsg,
 }
 
 
+#ifndef CAF_SHMEM
+
 void
 _gfortran_caf_init (int *argc __attribute__ ((unused)),
 		    char ***argv __attribute__ ((unused)))
@@ -437,6 +464,8 @@ _gfortran_caf_co_reduce (gfc_descriptor_t *a __attribute__ ((unused)),
      *stat = 0;
  }
 
+#endif /* !CAF_SHMEM  */
+
 
 static void
 assign_char4_from_char1 (size_t dst_size, size_t src_size, uint32_t *dst,
@@ -727,8 +756,7 @@ error:
 
 
 void
-_gfortran_caf_get (caf_token_t token, size_t offset,
-		   int image_index __attribute__ ((unused)),
+_gfortran_caf_get (caf_token_t token, size_t offset, int image_index,
 		   gfc_descriptor_t *src,
 		   caf_vector_t *src_vector __attribute__ ((unused)),
 		   gfc_descriptor_t *dest, int src_kind, int dst_kind,
@@ -740,10 +768,13 @@ _gfortran_caf_get (caf_token_t token, size_t offset,
   int rank = GFC_DESCRIPTOR_RANK (dest);
   size_t src_size = GFC_DESCRIPTOR_SIZE (src);
   size_t dst_size = GFC_DESCRIPTOR_SIZE (dest);
+  struct caf_image_view view;
 
   if (stat)
     *stat = 0;
 
+  token = caf_image_token (token, image_index, &view);
+
   if (rank == 0)
     {
       void *sr = (void *) ((char *) MEMTOK (token) + offset);
@@ -920,8 +951,7 @@ _gfortran_caf_get (caf_token_t token, size_t offset,
 
 
 void
-_gfortran_caf_send (caf_token_t token, size_t offset,
-		    int image_index __attribute__ ((unused)),
+_gfortran_caf_send (caf_token_t token, size_t offset, int image_index,
 		    gfc_descriptor_t *dest,
 		    caf_vector_t *dst_vector __attribute__ ((unused)),
 		    gfc_descriptor_t *src, int dst_kind, int src_kind,
@@ -933,10 +963,13 @@ _gfortran_caf_send (caf_token_t token, size_t offset,
   int rank = GFC_DESCRIPTOR_RANK (dest);
   size_t src_size = GFC_DESCRIPTOR_SIZE (src);
   size_t dst_size = GFC_DESCRIPTOR_SIZE (dest);
+  struct caf_image_view view;
 
   if (stat)
     *stat = 0;
 
+  token = caf_image_token (token, image_index, &view);
+
   if (rank == 0)
     {
       void *dst = (void *) ((char *) MEMTOK (token) + offset);
@@ -1132,8 +1165,7 @@ void
 _gfortran_caf_sendget (caf_token_t dst_token, size_t dst_offset,
 		       int dst_image_index, gfc_descriptor_t *dest,
 		       caf_vector_t *dst_vector, caf_token_t src_token,
-		       size_t src_offset,
-		       int src_image_index __attribute__ ((unused)),
+		       size_t src_offset, int src_image_index,
 		       gfc_descriptor_t *src,
 		       caf_vector_t *src_vector __attribute__ ((unused)),
 		       int dst_kind, int src_kind, bool may_require_tmp)
@@ -1141,7 +1173,9 @@ _gfortran_caf_sendget (caf_token_t dst_token, size_t dst_offset,
   /* FIXME: Handle vector subscript of 'src_vector'.  */
   /* For a single image, src->base_addr should be the same as src_token + offset
      but to play save, we do it properly.  */
+  struct caf_image_view view;
   void *src_base = GFC_DESCRIPTOR_DATA (src);
+  src_token = caf_image_token (src_token, src_image_index, &view);
   GFC_DESCRIPTOR_DATA (src) = (void *) ((char *) MEMTOK (src_token)
 					+ src_offset);
   _gfortran_caf_send (dst_token, dst_offset, dst_image_index, dest, dst_vector,
@@ -1539,8 +1573,7 @@ get_for_ref (caf_reference_t *ref, size_t *i, size_t *dst_index,
 
 
 void
-_gfortran_caf_get_by_ref (caf_token_t token,
-			  int image_index __attribute__ ((unused)),
+_gfortran_caf_get_by_ref (caf_token_t token, int image_index,
 			  gfc_descriptor_t *dst, caf_reference_t *refs,
 			  int dst_kind, int src_kind,
 			  bool may_require_tmp __attribute__ ((unused)),
@@ -1568,7 +1601,9 @@ _gfortran_caf_get_by_ref (caf_token_t token,
   int dst_rank = GFC_DESCRIPTOR_RANK (dst);
   int dst_cur_dim = 0;
   size_t src_size = 0;
-  caf_single_token_t single_token = TOKEN (token);
+  struct caf_image_view view;
+  caf_token_t image_token = caf_image_token (token, image_index, &view);
+  caf_single_token_t single_token = TOKEN (image_token);
   void *memptr = single_token->memptr;
   gfc_descriptor_t *src = single_token->desc;
   caf_reference_t *riter = refs;
@@ -2009,7 +2044,7 @@ _gfortran_caf_get_by_ref (caf_token_t token,
     }
 
   /* Reset the token.  */
-  single_token = TOKEN (token);
+  single_token = TOKEN (image_token);
   memptr = single_token->memptr;
   src = single_token->desc;
   memset(dst_index, 0, sizeof (dst_index));
@@ -2429,8 +2464,7 @@ send_by_ref (caf_reference_t *ref, size_t *i, size_t *src_index,
 
 
 void
-_gfortran_caf_send_by_ref (caf_token_t token,
-			   int image_index __attribute__ ((unused)),
+_gfortran_caf_send_by_ref (caf_token_t token, int image_index,
 			   gfc_descriptor_t *src, caf_reference_t *refs,
 			   int dst_kind, int src_kind,
 			   bool may_require_tmp __attribute__ ((unused)),
@@ -2457,7 +2491,9 @@ _gfortran_caf_send_by_ref (caf_token_t token,
   int src_rank = GFC_DESCRIPTOR_RANK (src);
   int src_cur_dim = 0;
   size_t src_size = 0;
-  caf_single_token_t single_token = TOKEN (token);
+  struct caf_image_view view;
+  caf_token_t image_token = caf_image_token (token, image_index, &view);
+  caf_single_token_t single_token = TOKEN (image_token);
   void *memptr = single_token->memptr;
   gfc_descriptor_t *dst = single_token->desc;
   caf_reference_t *riter = refs;
@@ -2785,7 +2821,7 @@ _gfortran_caf_send_by_ref (caf_token_t token,
   */
 
   /* Reset the token.  */
-  single_token = TOKEN (token);
+  single_token = TOKEN (image_token);
   memptr = single_token->memptr;
   dst = single_token->desc;
   memset (dst_index, 0, sizeof (dst_index));
@@ -2829,13 +2865,17 @@ _gfortran_caf_sendget_by_ref (caf_token_t dst_token, int dst_image_index,
 
 void
 _gfortran_caf_atomic_define (caf_token_t token, size_t offset,
-			     int image_index __attribute__ ((unused)),
+			     int image_index,
 			     void *value, int *stat,
 			     int type __attribute__ ((unused)), int kind)
 {
   assert(kind == 4);
 
-  uint32_t *atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
+  struct caf_image_view view;
+  uint32_t *atom;
+
+  token = caf_image_token (token, image_index, &view);
+  atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
 
   __atomic_store (atom, (uint32_t *) value, __ATOMIC_RELAXED);
 
@@ -2845,13 +2885,17 @@ _gfortran_caf_atomic_define (caf_token_t token, size_t offset,
 
 void
 _gfortran_caf_atomic_ref (caf_token_t token, size_t offset,
-			  int image_index __attribute__ ((unused)),
+			  int image_index,
 			  void *value, int *stat,
 			  int type __attribute__ ((unused)), int kind)
 {
   assert(kind == 4);
 
-  uint32_t *atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
+  struct caf_image_view view;
+  uint32_t *atom;
+
+  token = caf_image_token (token, image_index, &view);
+  atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
 
   __atomic_load (atom, (uint32_t *) value, __ATOMIC_RELAXED);
 
@@ -2862,13 +2906,17 @@ _gfortran_caf_atomic_ref (caf_token_t token, size_t offset,
 
 void
 _gfortran_caf_atomic_cas (caf_token_t token, size_t offset,
-			  int image_index __attribute__ ((unused)),
+			  int image_index,
 			  void *old, void *compare, void *new_val, int *stat,
 			  int type __attribute__ ((unused)), int kind)
 {
   assert(kind == 4);
 
-  uint32_t *atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
+  struct caf_image_view view;
+  uint32_t *atom;
+
+  token = caf_image_token (token, image_index, &view);
+  atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
 
   *(uint32_t *) old = *(uint32_t *) compare;
   (void) __atomic_compare_exchange_n (atom, (uint32_t *) old,
@@ -2881,14 +2929,18 @@ _gfortran_caf_atomic_cas (caf_token_t token, size_t offset,
 
 void
 _gfortran_caf_atomic_op (int op, caf_token_t token, size_t offset,
-			 int image_index __attribute__ ((unused)),
+			 int image_index,
 			 void *value, void *old, int *stat,
 			 int type __attribute__ ((unused)), int kind)
 {
   assert(kind == 4);
 
   uint32_t res;
-  uint32_t *atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
+  struct caf_image_view view;
+  uint32_t *atom;
+
+  token = caf_image_token (token, image_index, &view);
+  atom = (uint32_t *) ((char *) MEMTOK (token) + offset);
 
   switch (op)
     {
@@ -2915,6 +2967,8 @@ _gfortran_caf_atomic_op (int op, caf_token_t token, size_t offset,
     *stat = 0;
 }
 
+#ifndef CAF_SHMEM
+
 void
 _gfortran_caf_event_post (caf_token_t token, size_t index, 
 			  int image_index __attribute__ ((unused)), 
@@ -3034,9 +3088,11 @@ _gfortran_caf_unlock (caf_token_t token, size_t index,
   _gfortran_caf_error_stop_str (msg, strlen (msg), false);
 }
 
+#endif /* !CAF_SHMEM  */
+
+
 int
-_gfortran_caf_is_present (caf_token_t token,
-			  int image_index __attribute__ ((unused)),
+_gfortran_caf_is_present (caf_token_t token, int image_index,
 			  caf_reference_t *refs)
 {
   const char arraddressingnotallowed[] = "libcaf_single::caf_is_present(): "
@@ -3046,7 +3102,9 @@ _gfortran_caf_is_present (caf_token_t token,
   const char unknownarrreftype[] = "libcaf_single::caf_get_by_ref(): "
 				   "unknown array reference type.\n";
   size_t i;
-  caf_single_token_t single_token = TOKEN (token);
+  struct caf_image_view view;
+  caf_single_token_t single_token
+    = TOKEN (caf_image_token (token, image_index, &view));
   void *memptr = single_token->memptr;
   gfc_descriptor_t *src = single_token->desc;
   caf_reference_t *riter = refs;
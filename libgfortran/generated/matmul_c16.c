@@ -74,6 +74,21 @@ extern void matmul_c16 (gfc_array_c16 * const restrict retarray,
 	int blas_limit, blas_call gemm);
 export_proto(matmul_c16);
 
+typedef void (*matmul_c16_kernel) (gfc_array_c16 * const restrict retarray, 
+	gfc_array_c16 * const restrict a, gfc_array_c16 * const restrict b, int try_blas,
+	int blas_limit, blas_call gemm);
+
+/* Run the kernel pointed to by KERNEL on a slice of the result, for
+   matmul_threaded.  */
+
+static void
+matmul_c16_slice (void *kernel, gfc_array_void * const restrict retarray,
+	gfc_array_void * const restrict a, gfc_array_void * const restrict b)
+{
+  (*(matmul_c16_kernel *) kernel) ((gfc_array_c16 *) retarray, (gfc_array_c16 *) a,
+	(gfc_array_c16 *) b, 0, 0, NULL);
+}
+
 /* Put exhaustive list of possible architectures here here, ORed together.  */
 
 #if defined(HAVE_AVX) || defined(HAVE_AVX2) || defined(HAVE_AVX512F)
@@ -2438,13 +2453,16 @@ void matmul_c16 (gfc_array_c16 * const restrict retarray,
       __atomic_store_n (&matmul_p, matmul_fn, __ATOMIC_RELAXED);
    }
 
-   (*matmul_fn) (retarray, a, b, try_blas, blas_limit, gemm);
+   if (!matmul_threaded ((gfc_array_void *) retarray, (gfc_array_void *) a,
+			 (gfc_array_void *) b, sizeof (GFC_COMPLEX_16), try_blas,
+			 matmul_c16_slice, &matmul_fn))
+     (*matmul_fn) (retarray, a, b, try_blas, blas_limit, gemm);
 }
 
 #else  /* Just the vanilla function.  */
 
-void
-matmul_c16 (gfc_array_c16 * const restrict retarray, 
+static void
+matmul_c16_vanilla (gfc_array_c16 * const restrict retarray, 
 	gfc_array_c16 * const restrict a, gfc_array_c16 * const restrict b, int try_blas,
 	int blas_limit, blas_call gemm)
 {
@@ -3004,6 +3022,19 @@ matmul_c16 (gfc_array_c16 * const restrict retarray,
 #undef min
 #undef max
 
+void
+matmul_c16 (gfc_array_c16 * const restrict retarray, 
+	gfc_array_c16 * const restrict a, gfc_array_c16 * const restrict b, int try_blas,
+	int blas_limit, blas_call gemm)
+{
+  matmul_c16_kernel matmul_fn = matmul_c16_vanilla;
+
+  if (!matmul_threaded ((gfc_array_void *) retarray, (gfc_array_void *) a,
+			(gfc_array_void *) b, sizeof (GFC_COMPLEX_16), try_blas,
+			matmul_c16_slice, &matmul_fn))
+    matmul_c16_vanilla (retarray, a, b, try_blas, blas_limit, gemm);
+}
+
 #endif
 #endif
 
@@ -74,6 +74,21 @@ extern void matmul_i1 (gfc_array_i1 * const restrict retarray,
 	int blas_limit, blas_call gemm);
 export_proto(matmul_i1);
 
+typedef void (*matmul_i1_kernel) (gfc_array_i1 * const restrict retarray, 
+	gfc_array_i1 * const restrict a, gfc_array_i1 * const restrict b, int try_blas,
+	int blas_limit, blas_call gemm);
+
+/* Run the kernel pointed to by KERNEL on a slice of the result, for
+   matmul_threaded.  */
+
+static void
+matmul_i1_slice (void *kernel, gfc_array_void * const restrict retarray,
+	gfc_array_void * const restrict a, gfc_array_void * const restrict b)
+{
+  (*(matmul_i1_kernel *) kernel) ((gfc_array_i1 *) retarray, (gfc_array_i1 *) a,
+	(gfc_array_i1 *) b, 0, 0, NULL);
+}
+
 /* Put exhaustive list of possible architectures here here, ORed together.  */
 
 #if defined(HAVE_AVX) || defined(HAVE_AVX2) || defined(HAVE_AVX512F)
@@ -2438,13 +2453,16 @@ void matmul_i1 (gfc_array_i1 * const restrict retarray,
       __atomic_store_n (&matmul_p, matmul_fn, __ATOMIC_RELAXED);
    }
 
-   (*matmul_fn) (retarray, a, b, try_blas, blas_limit, gemm);
+   if (!matmul_threaded ((gfc_array_void *) retarray, (gfc_array_void *) a,
+			 (gfc_array_void *) b, sizeof (GFC_INTEGER_1), try_blas,
+			 matmul_i1_slice, &matmul_fn))
+     (*matmul_fn) (retarray, a, b, try_blas, blas_limit, gemm);
 }
 
 #else  /* Just the vanilla function.  */
 
-void
-matmul_i1 (gfc_array_i1 * const restrict retarray, 
+static void
+matmul_i1_vanilla (gfc_array_i1 * const restrict retarray, 
 	gfc_array_i1 * const restrict a, gfc_array_i1 * const restrict b, int try_blas,
 	int blas_limit, blas_call gemm)
 {
@@ -3004,6 +3022,19 @@ matmul_i1 (gfc_array_i1 * const restrict retarray,
 #undef min
 #undef max
 
+void
+matmul_i1 (gfc_array_i1 * const restrict retarray, 
+	gfc_array_i1 * const restrict a, gfc_array_i1 * const restrict b, int try_blas,
+	int blas_limit, blas_call gemm)
+{
+  matmul_i1_kernel matmul_fn = matmul_i1_vanilla;
+
+  if (!matmul_threaded ((gfc_array_void *) retarray, (gfc_array_void *) a,
+			(gfc_array_void *) b, sizeof (GFC_INTEGER_1), try_blas,
+			matmul_i1_slice, &matmul_fn))
+    matmul_i1_vanilla (retarray, a, b, try_blas, blas_limit, gemm);
+}
+
 #endif
 #endif
 
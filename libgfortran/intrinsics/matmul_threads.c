@@ -0,0 +1,177 @@
+/* Splitting the MATMUL intrinsic between threads.
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+This file is part of the GNU Fortran runtime library (libgfortran).
+
+Libgfortran is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public
+License as published by the Free Software Foundation; either
+version 3 of the License, or (at your option) any later version.
+
+Libgfortran is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<https://www.gnu.org/licenses/>.  */
+
+#include "libgfortran.h"
+#include <gthr.h>
+
+/* A thread is only worth starting for at least this many multiply-adds,
+   and each thread gets at least this many columns of the result, so
+   that the blocked kernels still work on whole blocks.  */
+
+#define MATMUL_THREAD_MIN_WORK (1 << 22)
+#define MATMUL_THREAD_MIN_COLUMNS 16
+
+#ifdef __GTHREADS_CXX0X
+
+typedef GFC_FULL_ARRAY_DESCRIPTOR (2, void) matmul_desc;
+
+/* The share of a MATMUL done by one thread: RET = MATMUL (A, B) for a
+   range of the columns of B and RET.  */
+
+typedef struct
+{
+  matmul_slice_fn slice;
+  void *kernel;
+  gfc_array_void *a;
+  matmul_desc b, ret;
+}
+matmul_job;
+
+static void *
+matmul_job_run (void *arg)
+{
+  matmul_job *job = arg;
+
+  job->slice (job->kernel, (gfc_array_void *) &job->ret, job->a,
+	      (gfc_array_void *) &job->b);
+  return NULL;
+}
+
+/* Set DEST to the COUNT columns of the rank 2 array SRC starting at
+   column START, where the elements are SIZE bytes long.  */
+
+static void
+column_section (matmul_desc *dest, const gfc_array_void *src,
+		index_type start, index_type count, size_t size)
+{
+  index_type stride = GFC_DESCRIPTOR_STRIDE (src, 1);
+
+  dest->base_addr = (char *) src->base_addr + start * stride * size;
+  dest->offset = 0;
+  dest->dtype = src->dtype;
+  dest->span = src->span;
+  dest->dim[0] = src->dim[0];
+  GFC_DIMENSION_SET (dest->dim[1], 0, count - 1, stride);
+}
+
+#endif
+
+/* Compute RETARRAY = MATMUL (A, B) for arrays with elements SIZE bytes
+   long, splitting the columns of the result between threads, each of
+   which calls SLICE with KERNEL and descriptors for its columns.
+   Return nonzero if that was done, or zero if the caller should do the
+   whole multiplication itself.
+
+   The multiplication is only split if GFORTRAN_MATMUL_THREADS allows
+   more than one thread, if both arguments have rank 2, if the arrays
+   are large enough to be worth it, and if the caller isn't going to use
+   BLAS (TRY_BLAS), which does its own threading.  Anything that the
+   kernel would report as an error is also left to the caller.  */
+
+int
+matmul_threaded (gfc_array_void * const restrict retarray,
+		 gfc_array_void * const restrict a,
+		 gfc_array_void * const restrict b, size_t size,
+		 int try_blas, matmul_slice_fn slice, void *kernel)
+{
+#ifdef __GTHREADS_CXX0X
+  index_type m, n, count, nthreads, i;
+  double work;
+  matmul_job *jobs;
+  __gthread_t *threads;
+  int *started;
+
+  if (options.matmul_threads <= 1 || try_blas
+      || GFC_DESCRIPTOR_RANK (a) != 2 || GFC_DESCRIPTOR_RANK (b) != 2)
+    return 0;
+
+  m = GFC_DESCRIPTOR_EXTENT (a, 0);
+  count = GFC_DESCRIPTOR_EXTENT (a, 1);
+  n = GFC_DESCRIPTOR_EXTENT (b, 1);
+  if (count != GFC_DESCRIPTOR_EXTENT (b, 0))
+    return 0;
+
+  nthreads = options.matmul_threads;
+  if (nthreads > n / MATMUL_THREAD_MIN_COLUMNS)
+    nthreads = n / MATMUL_THREAD_MIN_COLUMNS;
+  work = (double) m * (double) n * (double) count;
+  if (nthreads > work / MATMUL_THREAD_MIN_WORK)
+    nthreads = work / MATMUL_THREAD_MIN_WORK;
+  if (nthreads <= 1 || !__gthread_active_p ())
+    return 0;
+
+  if (retarray->base_addr == NULL)
+    {
+      GFC_DIMENSION_SET (retarray->dim[0], 0, m - 1, 1);
+      GFC_DIMENSION_SET (retarray->dim[1], 0, n - 1, m);
+      retarray->base_addr = xmallocarray (size0 ((array_t *) retarray), size);
+      retarray->offset = 0;
+    }
+  else if (GFC_DESCRIPTOR_EXTENT (retarray, 0) != m
+	   || GFC_DESCRIPTOR_EXTENT (retarray, 1) != n)
+    return 0;
+
+  jobs = xmallocarray (nthreads, sizeof (matmul_job));
+  threads = xmallocarray (nthreads, sizeof (__gthread_t));
+  started = xcalloc (nthreads, sizeof (int));
+
+  for (i = 0; i < nthreads; i++)
+    {
+      index_type start = n * i / nthreads;
+      index_type end = n * (i + 1) / nthreads;
+
+      jobs[i].slice = slice;
+      jobs[i].kernel = kernel;
+      jobs[i].a = a;
+      column_section (&jobs[i].b, b, start, end - start, size);
+      column_section (&jobs[i].ret, retarray, start, end - start, size);
+    }
+
+  /* This thread does the first share.  If a thread can't be started,
+     do its share here too.  */
+  for (i = 1; i < nthreads; i++)
+    started[i] = __gthread_create (&threads[i], matmul_job_run,
+				   &jobs[i]) == 0;
+  matmul_job_run (&jobs[0]);
+  for (i = 1; i < nthreads; i++)
+    if (started[i])
+      __gthread_join (threads[i], NULL);
+    else
+      matmul_job_run (&jobs[i]);
+
+  free (started);
+  free (threads);
+  free (jobs);
+  return 1;
+#else
+  (void) retarray;
+  (void) a;
+  (void) b;
+  (void) size;
+  (void) try_blas;
+  (void) slice;
+  (void) kernel;
+  return 0;
+#endif
+}
@@ -2519,6 +2519,24 @@ transfer_array_inner (st_parameter_dt *dtp, gfc_array_char *desc, int kind,
 	}
     }
 
+  /* Merge the leading dimensions that are contiguous with each other
+     into the first one, so that e.g. a whole contiguous array is
+     transferred as a single chunk.  Large unformatted chunks are then
+     read or written directly from the array, bypassing the buffer.  */
+  if (stride[0] == size)
+    {
+      index_type m = 1;
+
+      while (m < rank && stride[m] == stride[0] * extent[0])
+	extent[0] *= extent[m++];
+      for (n = m; n < rank; n++)
+	{
+	  stride[n - m + 1] = stride[n];
+	  extent[n - m + 1] = extent[n];
+	}
+      rank -= m - 1;
+    }
+
   stride0 = stride[0];
 
   /* If the innermost dimension has a stride of 1, we can do the transfer
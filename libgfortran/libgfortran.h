@@ -541,6 +541,7 @@ typedef struct
   int all_unbuffered, unbuffered_preconnected;
   int fpe, backtrace;
   int unformatted_buffer_size, formatted_buffer_size;
+  int matmul_threads;
 }
 options_t;
 
@@ -1385,6 +1386,18 @@ iexport_proto(size0);
 extern GFC_LOGICAL_4 is_contiguous0 (const array_t * const restrict array); 
 iexport_proto(is_contiguous0);
 
+/* matmul_threads.c */
+
+typedef void (*matmul_slice_fn) (void *, gfc_array_void * const restrict,
+				 gfc_array_void * const restrict,
+				 gfc_array_void * const restrict);
+
+extern int matmul_threaded (gfc_array_void * const restrict,
+			    gfc_array_void * const restrict,
+			    gfc_array_void * const restrict, size_t, int,
+			    matmul_slice_fn, void *);
+internal_proto(matmul_threaded);
+
 /* bounds.c */
 
 extern void bounds_equal_extents (array_t *, array_t *, const char *,
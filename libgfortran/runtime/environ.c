@@ -206,6 +206,9 @@ static variable variable_table[] = {
   { "GFORTRAN_FORMATTED_BUFFER_SIZE", 0, &options.formatted_buffer_size,
     init_integer },
 
+  /* Maximum number of threads for a MATMUL.  */
+  { "GFORTRAN_MATMUL_THREADS", 1, &options.matmul_threads, init_integer },
+
   { NULL, 0, NULL, NULL }
 };
 
@@ -178,6 +178,45 @@ find_option (st_parameter_common *cmp, const char *s1, gfc_charlen_type s1_len,
    in contrast to the *printf() family of functions, this ought to be
    async-signal-safe.  */
 
+/* The decimal digits of 0 to 99, two characters each.  */
+
+static const char digit_pairs[] =
+  "00010203040506070809101112131415161718192021222324252627282930313233"
+  "34353637383940414243444546474849505152535455565758596061626364656667"
+  "6869707172737475767778798081828384858687888990919293949596979899";
+
+/* Write the decimal digits of N backwards, ending just before P, and
+   return a pointer to the first digit.  If NDIGITS is nonzero, pad
+   with leading zeros to that many digits.  */
+
+static char *
+itoa_64 (uint64_t n, char *p, int ndigits)
+{
+  char *end = p;
+
+  while (n >= 100)
+    {
+      unsigned int i = (n % 100) * 2;
+      n /= 100;
+      p -= 2;
+      p[0] = digit_pairs[i];
+      p[1] = digit_pairs[i + 1];
+    }
+  if (n >= 10)
+    {
+      p -= 2;
+      p[0] = digit_pairs[n * 2];
+      p[1] = digit_pairs[n * 2 + 1];
+    }
+  else if (n != 0 || ndigits != 0)
+    *--p = '0' + n;
+
+  while (end - p < ndigits)
+    *--p = '0';
+
+  return p;
+}
+
 const char *
 gfc_itoa (GFC_INTEGER_LARGEST n, char *buffer, size_t len)
 {
@@ -202,11 +241,17 @@ gfc_itoa (GFC_INTEGER_LARGEST n, char *buffer, size_t len)
   p = buffer + GFC_ITOA_BUF_SIZE - 1;
   *p = '\0';
 
-  while (t != 0)
+#ifdef HAVE_GFC_INTEGER_16
+  /* Divisions of the widest type are slow, so only use them to split
+     the value into chunks of 19 digits that fit in 64 bits.  */
+  while (t > UINT64_MAX)
     {
-      *--p = '0' + (t % 10);
-      t /= 10;
+      const uint64_t ten19 = 10000000000000000000ULL;
+      p = itoa_64 (t % ten19, p, 19);
+      t /= ten19;
     }
+#endif
+  p = itoa_64 (t, p, 0);
 
   if (negative)
     *--p = '-';
@@ -119,6 +119,12 @@ gomp_affinity_print_place (void *p)
   (void) p;
 }
 
+unsigned long
+gomp_affinity_places_per_socket (void)
+{
+  return 0;
+}
+
 int
 omp_get_place_num_procs (int place_num)
 {
@@ -0,0 +1,491 @@
+/* Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of the GNU Offloading and Multi Processing Library
+   (libgomp).
+
+   Libgomp is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   Libgomp is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+   FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+   more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* This file contains the OpenMP 5.0 memory allocator routines.
+
+   Configurations can get memory for an allocator with traits from
+   somewhere other than malloc by defining MEMSPACE_ALLOC, MEMSPACE_FREE
+   and MEMSPACE_VALIDATE before including this file.  */
+
+#define _GNU_SOURCE
+#include "libgomp.h"
+#include <stdlib.h>
+
+#define omp_max_predefined_alloc omp_thread_mem_alloc
+
+/* Allocate SIZE bytes in MEMSPACE for an allocator with the PINNED and
+   PARTITION traits, return NULL on failure.  */
+#ifndef MEMSPACE_ALLOC
+#define MEMSPACE_ALLOC(MEMSPACE, SIZE, PINNED, PARTITION) malloc (SIZE)
+#endif
+/* Free memory returned by MEMSPACE_ALLOC with the same arguments.  */
+#ifndef MEMSPACE_FREE
+#define MEMSPACE_FREE(MEMSPACE, ADDR, SIZE, PINNED, PARTITION) free (ADDR)
+#endif
+/* Whether MEMSPACE_ALLOC supports the PINNED and PARTITION traits.  */
+#ifndef MEMSPACE_VALIDATE
+#define MEMSPACE_VALIDATE(MEMSPACE, PINNED, PARTITION) (!(PINNED))
+#endif
+
+/* Blocks of predefined allocators of up to GOMP_ALLOC_CACHE_CLASSES
+   * GOMP_ALLOC_CACHE_GRANULE bytes, header included, are rounded up to
+   a multiple of GOMP_ALLOC_CACHE_GRANULE.  omp_free keeps up to
+   GOMP_ALLOC_CACHE_DEPTH of them per size class in the freeing thread
+   for reuse by omp_alloc in that thread.  */
+#define GOMP_ALLOC_CACHE_GRANULE 32
+#define GOMP_ALLOC_CACHE_DEPTH 8
+#define GOMP_ALLOC_CACHE_MAX \
+  (GOMP_ALLOC_CACHE_CLASSES * GOMP_ALLOC_CACHE_GRANULE)
+
+struct omp_allocator_data
+{
+  omp_memspace_handle_t memspace;
+  omp_uintptr_t alignment;
+  omp_uintptr_t pool_size;
+  omp_uintptr_t used_pool_size;
+  omp_allocator_handle_t fb_data;
+  unsigned int sync_hint : 8;
+  unsigned int access : 8;
+  unsigned int fallback : 8;
+  unsigned int pinned : 1;
+  unsigned int partition : 7;
+#ifndef HAVE_SYNC_BUILTINS
+  gomp_mutex_t lock;
+#endif
+};
+
+struct omp_mem_header
+{
+  void *ptr;
+  size_t size;
+  omp_allocator_handle_t allocator;
+  void *pad;
+};
+
+omp_allocator_handle_t
+omp_init_allocator (omp_memspace_handle_t memspace, int ntraits,
+		    const omp_alloctrait_t traits[])
+{
+  struct omp_allocator_data data
+    = { memspace, 1, ~(uintptr_t) 0, 0, 0, omp_atv_contended, omp_atv_all,
+	omp_atv_default_mem_fb, omp_atv_false, omp_atv_environment };
+  struct omp_allocator_data *ret;
+  int i;
+
+  if (memspace > omp_low_lat_mem_space)
+    return omp_null_allocator;
+  for (i = 0; i < ntraits; i++)
+    switch (traits[i].key)
+      {
+      case omp_atk_sync_hint:
+	switch (traits[i].value)
+	  {
+	  case omp_atv_default:
+	    data.sync_hint = omp_atv_contended;
+	    break;
+	  case omp_atv_contended:
+	  case omp_atv_uncontended:
+	  case omp_atv_sequential:
+	  case omp_atv_private:
+	    data.sync_hint = traits[i].value;
+	    break;
+	  default:
+	    return omp_null_allocator;
+	  }
+	break;
+      case omp_atk_alignment:
+	if ((traits[i].value & (traits[i].value - 1)) != 0
+	    || !traits[i].value)
+	  return omp_null_allocator;
+	data.alignment = traits[i].value;
+	break;
+      case omp_atk_access:
+	switch (traits[i].value)
+	  {
+	  case omp_atv_default:
+	    data.access = omp_atv_all;
+	    break;
+	  case omp_atv_all:
+	  case omp_atv_cgroup:
+	  case omp_atv_pteam:
+	  case omp_atv_thread:
+	    data.access = traits[i].value;
+	    break;
+	  default:
+	    return omp_null_allocator;
+	  }
+	break;
+      case omp_atk_pool_size:
+	data.pool_size = traits[i].value;
+	break;
+      case omp_atk_fallback:
+	switch (traits[i].value)
+	  {
+	  case omp_atv_default:
+	    data.fallback = omp_atv_default_mem_fb;
+	    break;
+	  case omp_atv_default_mem_fb:
+	  case omp_atv_null_fb:
+	  case omp_atv_abort_fb:
+	  case omp_atv_allocator_fb:
+	    data.fallback = traits[i].value;
+	    break;
+	  default:
+	    return omp_null_allocator;
+	  }
+	break;
+      case omp_atk_fb_data:
+	data.fb_data = traits[i].value;
+	break;
+      case omp_atk_pinned:
+	switch (traits[i].value)
+	  {
+	  case omp_atv_default:
+	  case omp_atv_false:
+	    data.pinned = omp_atv_false;
+	    break;
+	  case omp_atv_true:
+	    data.pinned = omp_atv_true;
+	    break;
+	  default:
+	    return omp_null_allocator;
+	  }
+	break;
+      case omp_atk_partition:
+	switch (traits[i].value)
+	  {
+	  case omp_atv_default:
+	    data.partition = omp_atv_environment;
+	    break;
+	  case omp_atv_environment:
+	  case omp_atv_nearest:
+	  case omp_atv_blocked:
+	  case omp_atv_interleaved:
+	    data.partition = traits[i].value;
+	    break;
+	  default:
+	    return omp_null_allocator;
+	  }
+	break;
+      default:
+	return omp_null_allocator;
+      }
+
+  if (data.alignment < sizeof (void *))
+    data.alignment = sizeof (void *);
+
+  if (!MEMSPACE_VALIDATE (data.memspace, data.pinned, data.partition))
+    return omp_null_allocator;
+
+  ret = gomp_malloc (sizeof (struct omp_allocator_data));
+  *ret = data;
+#ifndef HAVE_SYNC_BUILTINS
+  gomp_mutex_init (&ret->lock);
+#endif
+  return (omp_allocator_handle_t) ret;
+}
+
+void
+omp_destroy_allocator (omp_allocator_handle_t allocator)
+{
+  if (allocator != omp_null_allocator)
+    {
+#ifndef HAVE_SYNC_BUILTINS
+      gomp_mutex_destroy (&((struct omp_allocator_data *) allocator)->lock);
+#endif
+      free ((void *) allocator);
+    }
+}
+
+void
+omp_set_default_allocator (omp_allocator_handle_t allocator)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  if (allocator == omp_null_allocator)
+    allocator = omp_default_mem_alloc;
+  thr->ts.def_allocator = (uintptr_t) allocator;
+}
+
+omp_allocator_handle_t
+omp_get_default_allocator (void)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  if (thr->ts.def_allocator == omp_null_allocator)
+    thr->ts.def_allocator = gomp_def_allocator;
+  return (omp_allocator_handle_t) thr->ts.def_allocator;
+}
+
+/* Memory space of predefined ALLOCATOR.  */
+
+static inline omp_memspace_handle_t
+predefined_alloc_memspace (omp_allocator_handle_t allocator)
+{
+  switch (allocator)
+    {
+    case omp_large_cap_mem_alloc:
+      return omp_large_cap_mem_space;
+    case omp_const_mem_alloc:
+      return omp_const_mem_space;
+    case omp_high_bw_mem_alloc:
+      return omp_high_bw_mem_space;
+    case omp_low_lat_mem_alloc:
+      return omp_low_lat_mem_space;
+    default:
+      return omp_default_mem_space;
+    }
+}
+
+void *
+omp_alloc (size_t size, omp_allocator_handle_t allocator)
+{
+  struct omp_allocator_data *allocator_data;
+  size_t alignment, new_size;
+  void *ptr, *ret;
+
+retry:
+  if (allocator == omp_null_allocator)
+    {
+      struct gomp_thread *thr = gomp_thread ();
+      if (thr->ts.def_allocator == omp_null_allocator)
+	thr->ts.def_allocator = gomp_def_allocator;
+      allocator = (omp_allocator_handle_t) thr->ts.def_allocator;
+    }
+
+  if (allocator > omp_max_predefined_alloc)
+    {
+      allocator_data = (struct omp_allocator_data *) allocator;
+      alignment = allocator_data->alignment;
+    }
+  else
+    {
+      allocator_data = NULL;
+      alignment = sizeof (void *);
+    }
+
+  new_size = sizeof (struct omp_mem_header);
+  if (alignment > sizeof (void *))
+    new_size += alignment - sizeof (void *);
+  if (__builtin_add_overflow (size, new_size, &new_size))
+    goto fail;
+
+  if (allocator_data == NULL)
+    {
+      if (new_size <= GOMP_ALLOC_CACHE_MAX)
+	{
+	  struct gomp_thread *thr = gomp_thread ();
+	  unsigned int c = (new_size - 1) / GOMP_ALLOC_CACHE_GRANULE;
+
+	  new_size = (c + 1) * GOMP_ALLOC_CACHE_GRANULE;
+	  ptr = thr->alloc_cache[c];
+	  if (ptr)
+	    {
+	      thr->alloc_cache[c] = *(void **) ptr;
+	      thr->alloc_cache_len[c]--;
+	      goto done;
+	    }
+	}
+      ptr = MEMSPACE_ALLOC (predefined_alloc_memspace (allocator), new_size,
+			    0, omp_atv_environment);
+      if (ptr == NULL)
+	goto fail;
+    }
+  else if (__builtin_expect (allocator_data->pool_size < ~(uintptr_t) 0, 0))
+    {
+      uintptr_t used_pool_size;
+      if (new_size > allocator_data->pool_size)
+	goto fail;
+#ifdef HAVE_SYNC_BUILTINS
+      used_pool_size = __atomic_load_n (&allocator_data->used_pool_size,
+					MEMMODEL_RELAXED);
+      do
+	{
+	  uintptr_t new_pool_size;
+	  if (__builtin_add_overflow (used_pool_size, new_size,
+				      &new_pool_size)
+	      || new_pool_size > allocator_data->pool_size)
+	    goto fail;
+	  if (__atomic_compare_exchange_n (&allocator_data->used_pool_size,
+					   &used_pool_size, new_pool_size,
+					   true, MEMMODEL_RELAXED,
+					   MEMMODEL_RELAXED))
+	    break;
+	}
+      while (1);
+#else
+      gomp_mutex_lock (&allocator_data->lock);
+      if (__builtin_add_overflow (allocator_data->used_pool_size, new_size,
+				  &used_pool_size)
+	  || used_pool_size > allocator_data->pool_size)
+	{
+	  gomp_mutex_unlock (&allocator_data->lock);
+	  goto fail;
+	}
+      allocator_data->used_pool_size = used_pool_size;
+      gomp_mutex_unlock (&allocator_data->lock);
+#endif
+      ptr = MEMSPACE_ALLOC (allocator_data->memspace, new_size,
+			    allocator_data->pinned, allocator_data->partition);
+      if (ptr == NULL)
+	{
+#ifdef HAVE_SYNC_BUILTINS
+	  __atomic_add_fetch (&allocator_data->used_pool_size, -new_size,
+			      MEMMODEL_RELAXED);
+#else
+	  gomp_mutex_lock (&allocator_data->lock);
+	  allocator_data->used_pool_size -= new_size;
+	  gomp_mutex_unlock (&allocator_data->lock);
+#endif
+	  goto fail;
+	}
+    }
+  else
+    {
+      ptr = MEMSPACE_ALLOC (allocator_data->memspace, new_size,
+			    allocator_data->pinned, allocator_data->partition);
+      if (ptr == NULL)
+	goto fail;
+    }
+
+done:
+  if (alignment > sizeof (void *))
+    ret = (void *) (((uintptr_t) ptr
+		     + sizeof (struct omp_mem_header)
+		     + alignment - sizeof (void *)) & ~(alignment - 1));
+  else
+    ret = (char *) ptr + sizeof (struct omp_mem_header);
+  ((struct omp_mem_header *) ret)[-1].ptr = ptr;
+  ((struct omp_mem_header *) ret)[-1].size = new_size;
+  ((struct omp_mem_header *) ret)[-1].allocator = allocator;
+  return ret;
+
+fail:
+  if (allocator_data)
+    {
+      switch (allocator_data->fallback)
+	{
+	case omp_atv_default_mem_fb:
+	  if (alignment > sizeof (void *)
+	      || allocator_data->pool_size < ~(uintptr_t) 0
+	      || allocator_data->pinned
+	      || allocator_data->partition != omp_atv_environment)
+	    {
+	      allocator = omp_default_mem_alloc;
+	      goto retry;
+	    }
+	  /* Otherwise, we've already performed default mem allocation
+	     and if that failed, it won't succeed again (unless it was
+	     intermittent).  Return NULL then, as that is the fallback.  */
+	  break;
+	case omp_atv_null_fb:
+	  break;
+	default:
+	case omp_atv_abort_fb:
+	  gomp_fatal ("Out of memory allocating %lu bytes",
+		      (unsigned long) size);
+	case omp_atv_allocator_fb:
+	  allocator = allocator_data->fb_data;
+	  goto retry;
+	}
+    }
+  return NULL;
+}
+
+void
+omp_free (void *ptr, omp_allocator_handle_t allocator)
+{
+  struct omp_mem_header *data;
+
+  if (ptr == NULL)
+    return;
+  (void) allocator;
+  data = &((struct omp_mem_header *) ptr)[-1];
+  if (data->allocator > omp_max_predefined_alloc)
+    {
+      struct omp_allocator_data *allocator_data
+	= (struct omp_allocator_data *) (data->allocator);
+      if (allocator_data->pool_size < ~(uintptr_t) 0)
+	{
+#ifdef HAVE_SYNC_BUILTINS
+	  __atomic_add_fetch (&allocator_data->used_pool_size, -data->size,
+			      MEMMODEL_RELAXED);
+#else
+	  gomp_mutex_lock (&allocator_data->lock);
+	  allocator_data->used_pool_size -= data->size;
+	  gomp_mutex_unlock (&allocator_data->lock);
+#endif
+	}
+      MEMSPACE_FREE (allocator_data->memspace, data->ptr, data->size,
+		     allocator_data->pinned, allocator_data->partition);
+      return;
+    }
+
+  if (data->size <= GOMP_ALLOC_CACHE_MAX)
+    {
+      struct gomp_thread *thr = gomp_thread ();
+      unsigned int c = data->size / GOMP_ALLOC_CACHE_GRANULE - 1;
+
+      /* Only threads with a thread pool are sure to release their
+	 cache through gomp_free_alloc_cache when they exit.  */
+      if (thr->thread_pool != NULL
+	  && thr->alloc_cache_len[c] < GOMP_ALLOC_CACHE_DEPTH)
+	{
+	  *(void **) data->ptr = thr->alloc_cache[c];
+	  thr->alloc_cache[c] = data->ptr;
+	  thr->alloc_cache_len[c]++;
+	  return;
+	}
+    }
+  MEMSPACE_FREE (predefined_alloc_memspace (data->allocator), data->ptr,
+		 data->size, 0, omp_atv_environment);
+}
+
+/* Release the blocks cached by omp_free in THR.  */
+
+void
+gomp_free_alloc_cache (struct gomp_thread *thr)
+{
+  unsigned int c;
+
+  for (c = 0; c < GOMP_ALLOC_CACHE_CLASSES; c++)
+    {
+      void *ptr = thr->alloc_cache[c];
+      while (ptr)
+	{
+	  void *next = *(void **) ptr;
+	  MEMSPACE_FREE (omp_default_mem_space, ptr,
+			 (c + 1) * GOMP_ALLOC_CACHE_GRANULE, 0,
+			 omp_atv_environment);
+	  ptr = next;
+	}
+      thr->alloc_cache[c] = NULL;
+      thr->alloc_cache_len[c] = 0;
+    }
+}
+
+ialias (omp_init_allocator)
+ialias (omp_destroy_allocator)
+ialias (omp_set_default_allocator)
+ialias (omp_get_default_allocator)
+ialias (omp_alloc)
+ialias (omp_free)
@@ -38,7 +38,11 @@ GOMP_barrier (void)
   if (team == NULL)
     return;
 
+  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_explicit,
+			      ompt_scope_begin);
   gomp_team_barrier_wait (&team->barrier);
+  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_explicit,
+			      ompt_scope_end);
 }
 
 bool
@@ -46,9 +50,15 @@ GOMP_barrier_cancel (void)
 {
   struct gomp_thread *thr = gomp_thread ();
   struct gomp_team *team = thr->ts.team;
+  bool ret;
 
   /* The compiler transforms to barrier_cancel when it sees that the
      barrier is within a construct that can cancel.  Thus we should
      never have an orphaned cancellable barrier.  */
-  return gomp_team_barrier_wait_cancel (&team->barrier);
+  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_explicit,
+			      ompt_scope_begin);
+  ret = gomp_team_barrier_wait_cancel (&team->barrier);
+  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_explicit,
+			      ompt_scope_end);
+  return ret;
 }
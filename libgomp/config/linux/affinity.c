@@ -360,6 +360,62 @@ gomp_affinity_print_place (void *p)
     fprintf (stderr, ":%lu", len);
 }
 
+/* Return the physical package id of the first CPU in place P, or -1
+   if it can't be determined.  */
+
+static long
+gomp_affinity_place_socket (void *p)
+{
+  char name[sizeof ("/sys/devices/system/cpu/cpu/topology/"
+		    "physical_package_id") + 3 * sizeof (unsigned long)];
+  cpu_set_t *cpusetp = (cpu_set_t *) p;
+  unsigned long i, max = 8 * gomp_cpuset_size;
+  long ret = -1;
+  FILE *f;
+
+  for (i = 0; i < max; i++)
+    if (CPU_ISSET_S (i, gomp_cpuset_size, cpusetp))
+      break;
+  if (i == max)
+    return -1;
+  sprintf (name, "/sys/devices/system/cpu/cpu%lu/topology/"
+		 "physical_package_id", i);
+  f = fopen (name, "r");
+  if (f == NULL)
+    return -1;
+  if (fscanf (f, "%ld", &ret) != 1)
+    ret = -1;
+  fclose (f);
+  return ret;
+}
+
+/* Return the number of consecutive places at the start of the places
+   list that are on the same socket, or 0 if unknown.  */
+
+unsigned long
+gomp_affinity_places_per_socket (void)
+{
+  static unsigned long cached;
+  unsigned long ret;
+  long socket;
+
+  ret = __atomic_load_n (&cached, MEMMODEL_RELAXED);
+  if (ret)
+    return ret - 1;
+  if (gomp_places_list == NULL)
+    return 0;
+
+  socket = gomp_affinity_place_socket (gomp_places_list[0]);
+  if (socket < 0)
+    ret = 0;
+  else
+    for (ret = 1; ret < gomp_places_list_len; ret++)
+      if (gomp_affinity_place_socket (gomp_places_list[ret]) != socket)
+	break;
+  __atomic_store_n (&cached, ret + 1, MEMMODEL_RELAXED);
+  return ret;
+}
+
 int
 omp_get_place_num_procs (int place_num)
 {
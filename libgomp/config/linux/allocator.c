@@ -0,0 +1,231 @@
+/* Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of the GNU Offloading and Multi Processing Library
+   (libgomp).
+
+   Libgomp is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   Libgomp is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+   FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+   more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* This is a Linux specific implementation of the memory of allocators
+   with the omp_atk_pinned or omp_atk_partition traits.  Such memory is
+   mapped separately, so that it can be locked with mlock and placed on
+   NUMA nodes with mbind.  Everything else comes from malloc and is
+   placed by first touch.  The high bandwidth and large capacity memory
+   spaces are not told apart from default memory.  */
+
+#define _GNU_SOURCE
+#include "libgomp.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#ifdef SYS_mbind
+
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED	1
+#endif
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE	3
+#endif
+
+/* Highest NUMA node number + 1 that allocators place memory on.  */
+#define GOMP_NUMA_MAX_NODES 1024
+#define GOMP_NUMA_MASK_LONGS \
+  (GOMP_NUMA_MAX_NODES / (8 * sizeof (unsigned long)))
+#define GOMP_NUMA_BITS (8 * sizeof (unsigned long))
+
+/* Online NUMA nodes, read from sysfs on first use.  gomp_numa_nnodes is
+   the number of bits set in gomp_numa_online plus one, zero until
+   initialized.  */
+static unsigned long gomp_numa_online[GOMP_NUMA_MASK_LONGS];
+static unsigned long gomp_numa_nnodes;
+
+static unsigned long
+gomp_numa_init (void)
+{
+  unsigned long mask[GOMP_NUMA_MASK_LONGS];
+  unsigned long nnodes = 0, i;
+  FILE *f = fopen ("/sys/devices/system/node/online", "r");
+  char *line = NULL;
+  size_t linelen = 0;
+
+  memset (mask, 0, sizeof (mask));
+  if (f != NULL)
+    {
+      if (getline (&line, &linelen, f) > 0)
+	{
+	  char *p = line;
+	  while (*p && *p != '\n')
+	    {
+	      unsigned long first, last;
+	      errno = 0;
+	      first = strtoul (p, &p, 10);
+	      if (errno)
+		break;
+	      last = first;
+	      if (*p == '-')
+		{
+		  errno = 0;
+		  last = strtoul (p + 1, &p, 10);
+		  if (errno || last < first)
+		    break;
+		}
+	      for (; first <= last && first < GOMP_NUMA_MAX_NODES; first++)
+		mask[first / GOMP_NUMA_BITS]
+		  |= 1UL << (first % GOMP_NUMA_BITS);
+	      if (*p == ',')
+		++p;
+	    }
+	}
+      free (line);
+      fclose (f);
+    }
+
+  /* Several threads may get here first, they all compute the same.  */
+  for (i = 0; i < GOMP_NUMA_MASK_LONGS; i++)
+    {
+      __atomic_store_n (&gomp_numa_online[i], mask[i], MEMMODEL_RELAXED);
+      nnodes += __builtin_popcountl (mask[i]);
+    }
+  __atomic_store_n (&gomp_numa_nnodes, nnodes + 1, MEMMODEL_RELEASE);
+  return nnodes;
+}
+
+/* Number of online NUMA nodes, 0 if unknown.  */
+
+static inline unsigned long
+gomp_numa_nodes (void)
+{
+  unsigned long n = __atomic_load_n (&gomp_numa_nnodes, MEMMODEL_ACQUIRE);
+  return n ? n - 1 : gomp_numa_init ();
+}
+
+/* Place the SIZE bytes at ADDR according to the PARTITION trait.  This
+   is only a hint, so failures are ignored.  */
+
+static void
+linux_memspace_place (void *addr, size_t size, int partition)
+{
+  unsigned long mask[GOMP_NUMA_MASK_LONGS];
+  unsigned long nnodes = gomp_numa_nodes (), node, i;
+  size_t pagesize, chunk;
+
+  switch (partition)
+    {
+    case omp_atv_nearest:
+      /* An empty node mask prefers the node of the allocating thread.  */
+      syscall (SYS_mbind, addr, size, MPOL_PREFERRED, NULL, 0, 0);
+      break;
+    case omp_atv_interleaved:
+      syscall (SYS_mbind, addr, size, MPOL_INTERLEAVE, gomp_numa_online,
+	       GOMP_NUMA_MAX_NODES + 1, 0);
+      break;
+    case omp_atv_blocked:
+      /* Give each node one contiguous block of whole pages.  */
+      pagesize = sysconf (_SC_PAGESIZE);
+      chunk = (size + pagesize - 1) / pagesize;
+      chunk = (chunk + nnodes - 1) / nnodes * pagesize;
+      for (node = 0, i = 0; node < GOMP_NUMA_MAX_NODES && i < size; node++)
+	if (gomp_numa_online[node / GOMP_NUMA_BITS]
+	    & (1UL << (node % GOMP_NUMA_BITS)))
+	  {
+	    memset (mask, 0, sizeof (mask));
+	    mask[node / GOMP_NUMA_BITS] = 1UL << (node % GOMP_NUMA_BITS);
+	    syscall (SYS_mbind, (char *) addr + i,
+		     chunk < size - i ? chunk : size - i, MPOL_PREFERRED,
+		     mask, GOMP_NUMA_MAX_NODES + 1, 0);
+	    i += chunk;
+	  }
+      break;
+    default:
+      break;
+    }
+}
+
+/* Whether memory with the PINNED and PARTITION traits is mapped
+   separately rather than taken from malloc.  */
+
+static inline bool
+linux_memspace_mapped_p (int pinned, int partition)
+{
+  return pinned || (partition != omp_atv_environment
+		    && gomp_numa_nodes () > 1);
+}
+
+#else
+
+static inline bool
+linux_memspace_mapped_p (int pinned, int partition)
+{
+  (void) partition;
+  return pinned;
+}
+
+#endif /* SYS_mbind */
+
+static void *
+linux_memspace_alloc (omp_memspace_handle_t memspace, size_t size,
+		      int pinned, int partition)
+{
+  void *addr;
+
+  (void) memspace;
+  if (!linux_memspace_mapped_p (pinned, partition))
+    return malloc (size);
+
+  addr = mmap (NULL, size, PROT_READ | PROT_WRITE,
+	       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (addr == MAP_FAILED)
+    return NULL;
+#ifdef SYS_mbind
+  if (partition != omp_atv_environment)
+    linux_memspace_place (addr, size, partition);
+#endif
+  if (pinned && mlock (addr, size) != 0)
+    {
+      /* Most likely over RLIMIT_MEMLOCK; let the fallback trait
+	 decide what to do.  */
+      munmap (addr, size);
+      return NULL;
+    }
+  return addr;
+}
+
+static void
+linux_memspace_free (omp_memspace_handle_t memspace, void *addr, size_t size,
+		     int pinned, int partition)
+{
+  (void) memspace;
+  if (!linux_memspace_mapped_p (pinned, partition))
+    free (addr);
+  else
+    munmap (addr, size);
+}
+
+#define MEMSPACE_ALLOC(MEMSPACE, SIZE, PINNED, PARTITION) \
+  linux_memspace_alloc (MEMSPACE, SIZE, PINNED, PARTITION)
+#define MEMSPACE_FREE(MEMSPACE, ADDR, SIZE, PINNED, PARTITION) \
+  linux_memspace_free (MEMSPACE, ADDR, SIZE, PINNED, PARTITION)
+#define MEMSPACE_VALIDATE(MEMSPACE, PINNED, PARTITION) 1
+
+#include "../../allocator.c"
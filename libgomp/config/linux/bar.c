@@ -30,6 +30,54 @@
 #include <limits.h>
 #include "wait.h"
 
+/* Team barriers of at least GOMP_BARRIER_GROUP_MIN_TEAM threads count
+   arrivals in groups, so that each cache line sees at most a group's
+   worth of atomic decrements.  Groups follow the sockets of the places
+   list when threads are bound to consecutive places, otherwise they
+   have GOMP_BARRIER_GROUP_SIZE threads.  */
+#define GOMP_BARRIER_GROUP_MIN_TEAM	16
+#define GOMP_BARRIER_GROUP_SIZE		8
+#define GOMP_BARRIER_GROUP_MAX_SIZE	32
+
+void
+gomp_barrier_init_groups (gomp_barrier_t *bar, unsigned count)
+{
+  unsigned long size;
+  unsigned i, ngroups;
+
+  if (count < GOMP_BARRIER_GROUP_MIN_TEAM)
+    return;
+
+  size = gomp_affinity_places_per_socket ();
+  if (size < 4 || size >= count)
+    size = GOMP_BARRIER_GROUP_SIZE;
+  else if (size > GOMP_BARRIER_GROUP_MAX_SIZE)
+    /* Split sockets evenly rather than letting groups straddle them.  */
+    size /= (size + GOMP_BARRIER_GROUP_MAX_SIZE - 1)
+	    / GOMP_BARRIER_GROUP_MAX_SIZE;
+
+  ngroups = (count + size - 1) / size;
+  bar->groups = gomp_aligned_alloc (__alignof__ (struct gomp_barrier_group),
+				    ngroups * sizeof (*bar->groups));
+  bar->group_size = size;
+  for (i = 0; i < ngroups; i++)
+    {
+      bar->groups[i].total = i == ngroups - 1 ? count - i * size : size;
+      bar->groups[i].awaited = bar->groups[i].total;
+    }
+}
+
+/* Rearm all the groups, which a cancelled barrier may have left with
+   only some of their threads arrived.  */
+
+static void
+gomp_barrier_reset_groups (gomp_barrier_t *bar)
+{
+  unsigned i, ngroups = (bar->total + bar->group_size - 1) / bar->group_size;
+
+  for (i = 0; i < ngroups; i++)
+    bar->groups[i].awaited = bar->groups[i].total;
+}
 
 void
 gomp_barrier_wait_end (gomp_barrier_t *bar, gomp_barrier_state_t state)
@@ -124,7 +172,8 @@ gomp_team_barrier_wait_end (gomp_barrier_t *bar, gomp_barrier_state_t state)
 void
 gomp_team_barrier_wait (gomp_barrier_t *bar)
 {
-  gomp_team_barrier_wait_end (bar, gomp_barrier_wait_start (bar));
+  unsigned id = gomp_thread ()->ts.team_id;
+  gomp_team_barrier_wait_end (bar, gomp_team_barrier_wait_start (bar, id));
 }
 
 void
@@ -132,7 +181,11 @@ gomp_team_barrier_wait_final (gomp_barrier_t *bar)
 {
   gomp_barrier_state_t state = gomp_barrier_wait_final_start (bar);
   if (__builtin_expect (state & BAR_WAS_LAST, 0))
-    bar->awaited_final = bar->total;
+    {
+      bar->awaited_final = bar->total;
+      if (bar->groups)
+	gomp_barrier_reset_groups (bar);
+    }
   gomp_team_barrier_wait_end (bar, state);
 }
 
@@ -193,7 +246,10 @@ gomp_team_barrier_wait_cancel_end (gomp_barrier_t *bar,
 bool
 gomp_team_barrier_wait_cancel (gomp_barrier_t *bar)
 {
-  return gomp_team_barrier_wait_cancel_end (bar, gomp_barrier_wait_start (bar));
+  unsigned id = gomp_thread ()->ts.team_id;
+  return gomp_team_barrier_wait_cancel_end (bar,
+					    gomp_team_barrier_wait_cancel_start
+					      (bar, id));
 }
 
 void
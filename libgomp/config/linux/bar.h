@@ -32,12 +32,25 @@
 
 #include "mutex.h"
 
+/* Arrival counter of one group of consecutive threads of a team
+   barrier, see gomp_team_barrier_wait_start.  */
+struct gomp_barrier_group
+{
+  unsigned awaited __attribute__((aligned (64)));
+  unsigned total;
+};
+
 typedef struct
 {
   /* Make sure total/generation is in a mostly read cacheline, while
      awaited in a separate cacheline.  */
   unsigned total __attribute__((aligned (64)));
   unsigned generation;
+  /* For large teams, thread TEAM_ID first arrives on
+     groups[TEAM_ID / group_size] and only the last thread of each
+     group decrements awaited.  GROUPS is NULL for small teams.  */
+  unsigned group_size;
+  struct gomp_barrier_group *groups;
   unsigned awaited __attribute__((aligned (64)));
   unsigned awaited_final;
 } gomp_barrier_t;
@@ -59,6 +72,20 @@ static inline void gomp_barrier_init (gomp_barrier_t *bar, unsigned count)
   bar->awaited = count;
   bar->awaited_final = count;
   bar->generation = 0;
+  bar->group_size = 0;
+  bar->groups = NULL;
+}
+
+extern void gomp_barrier_init_groups (gomp_barrier_t *, unsigned);
+
+/* Like gomp_barrier_init, for a barrier that is also waited on with
+   gomp_team_barrier_wait_start.  */
+
+static inline void
+gomp_team_barrier_init (gomp_barrier_t *bar, unsigned count)
+{
+  gomp_barrier_init (bar, count);
+  gomp_barrier_init_groups (bar, count);
 }
 
 static inline void gomp_barrier_reinit (gomp_barrier_t *bar, unsigned count)
@@ -69,6 +96,7 @@ static inline void gomp_barrier_reinit (gomp_barrier_t *bar, unsigned count)
 
 static inline void gomp_barrier_destroy (gomp_barrier_t *bar)
 {
+  gomp_aligned_free (bar->groups);
 }
 
 extern void gomp_barrier_wait (gomp_barrier_t *);
@@ -106,6 +134,40 @@ gomp_barrier_wait_cancel_start (gomp_barrier_t *bar)
   return gomp_barrier_wait_start (bar);
 }
 
+/* This is like gomp_barrier_wait_start, for a team barrier waited on
+   by thread ID of the team.  In teams with arrival groups, only the
+   last thread of each group touches bar->awaited.  */
+
+static inline gomp_barrier_state_t
+gomp_team_barrier_wait_start (gomp_barrier_t *bar, unsigned id)
+{
+  struct gomp_barrier_group *group;
+  unsigned int ret;
+
+  if (bar->groups == NULL)
+    return gomp_barrier_wait_start (bar);
+
+  group = &bar->groups[id / bar->group_size];
+  ret = __atomic_load_n (&bar->generation, MEMMODEL_ACQUIRE);
+  ret &= -BAR_INCR | BAR_CANCELLED;
+  if (__atomic_add_fetch (&group->awaited, -1, MEMMODEL_ACQ_REL) == 0)
+    {
+      /* Nobody in the group can arrive again before the whole team
+	 has arrived, so the group can be rearmed already.  */
+      group->awaited = group->total;
+      if (__atomic_add_fetch (&bar->awaited, -group->total,
+			      MEMMODEL_ACQ_REL) == 0)
+	ret |= BAR_WAS_LAST;
+    }
+  return ret;
+}
+
+static inline gomp_barrier_state_t
+gomp_team_barrier_wait_cancel_start (gomp_barrier_t *bar, unsigned id)
+{
+  return gomp_team_barrier_wait_start (bar, id);
+}
+
 /* This is like gomp_barrier_wait_start, except it decrements
    bar->awaited_final rather than bar->awaited and should be used
    for the gomp_team_end barrier only.  */
@@ -126,6 +188,16 @@ gomp_barrier_last_thread (gomp_barrier_state_t state)
   return state & BAR_WAS_LAST;
 }
 
+/* Whether tasks may be pending; unlike the inlines below this may be
+   called without team->task_lock held.  */
+
+static inline bool
+gomp_team_barrier_task_pending (gomp_barrier_t *bar)
+{
+  return (__atomic_load_n (&bar->generation, MEMMODEL_RELAXED)
+	  & BAR_TASK_PENDING) != 0;
+}
+
 /* All the inlines below must be called with team->task_lock
    held.  */
 
@@ -31,10 +31,314 @@
 #include <unistd.h>
 #include <sys/syscall.h>
 #include "wait.h"
+#if defined __x86_64__ || defined __i386__
+# include <cpuid.h>
+# include <immintrin.h>
+#endif
 
-/* Reuse the generic implementation in terms of gomp_mutex_t.  */
+/* Reuse the generic implementation of the nestable locks in terms of
+   gomp_mutex_t.  */
+#define GOMP_HAVE_LOCK_HINTS 1
 #include "../../lock.c"
 
+/* A lock initialized by omp_init_lock is a gomp_mutex_t, whose values are
+   0, 1 and -1.  omp_init_lock_with_hint can instead make it a tagged lock,
+   whose value is always greater than 1 so that the gomp_mutex_t fast
+   paths fail on it:
+
+   GOMP_LOCK_QUEUED | index: a contended lock.  The index is that of an MCS
+   queue lock in gomp_queued_locks, as an MCS lock doesn't fit in an int.
+
+   GOMP_LOCK_SPECULATIVE + 0, 1 or 2: a speculative lock, unlocked,
+   locked, or locked with waiters.  When the CPU has RTM, setting it first
+   tries to elide the lock in a transaction that only reads the lock.  */
+
+#define GOMP_LOCK_QUEUED	0x40000000
+#define GOMP_LOCK_SPECULATIVE	0x20000000
+
+/* gomp_queued_locks has up to GOMP_QUEUED_LOCK_CHUNKS chunks of
+   GOMP_QUEUED_LOCK_CHUNK locks, allocated when needed and never freed,
+   so that finding a lock by its index doesn't need any lock.  */
+#define GOMP_QUEUED_LOCK_CHUNK	1024
+#define GOMP_QUEUED_LOCK_CHUNKS	1024
+
+struct gomp_queued_lock
+{
+  /* The MCS lock, and the node of the thread that holds it.  */
+  struct gomp_mcs_node *tail;
+  struct gomp_mcs_node *holder;
+  /* Index of the next destroyed lock to reuse.  */
+  int next_free;
+} __attribute__((aligned (64)));
+
+static struct gomp_queued_lock *gomp_queued_locks[GOMP_QUEUED_LOCK_CHUNKS];
+static int gomp_queued_locks_used;
+static int gomp_queued_locks_free = -1;
+static gomp_mutex_t gomp_queued_locks_lock;
+
+static inline struct gomp_queued_lock *
+gomp_queued_lock (int val)
+{
+  int index = val & ~GOMP_LOCK_QUEUED;
+  return &gomp_queued_locks[index / GOMP_QUEUED_LOCK_CHUNK]
+			   [index % GOMP_QUEUED_LOCK_CHUNK];
+}
+
+/* Return the value of a new contended lock, or 0 for a plain one if there
+   are too many of them.  */
+
+static int
+gomp_queued_lock_new (void)
+{
+  struct gomp_queued_lock *q;
+  int index;
+
+  gomp_mutex_lock (&gomp_queued_locks_lock);
+  index = gomp_queued_locks_free;
+  if (index >= 0)
+    gomp_queued_locks_free = gomp_queued_lock (index)->next_free;
+  else if (gomp_queued_locks_used
+	   < GOMP_QUEUED_LOCK_CHUNK * GOMP_QUEUED_LOCK_CHUNKS)
+    {
+      index = gomp_queued_locks_used++;
+      if (index % GOMP_QUEUED_LOCK_CHUNK == 0)
+	gomp_queued_locks[index / GOMP_QUEUED_LOCK_CHUNK]
+	  = gomp_aligned_alloc (__alignof (struct gomp_queued_lock),
+				GOMP_QUEUED_LOCK_CHUNK
+				* sizeof (struct gomp_queued_lock));
+    }
+  gomp_mutex_unlock (&gomp_queued_locks_lock);
+  if (index < 0)
+    return 0;
+
+  q = gomp_queued_lock (index);
+  q->tail = NULL;
+  q->holder = NULL;
+  return GOMP_LOCK_QUEUED | index;
+}
+
+static void
+gomp_queued_lock_free (int val)
+{
+  struct gomp_queued_lock *q = gomp_queued_lock (val);
+
+  gomp_mutex_lock (&gomp_queued_locks_lock);
+  q->next_free = gomp_queued_locks_free;
+  gomp_queued_locks_free = val & ~GOMP_LOCK_QUEUED;
+  gomp_mutex_unlock (&gomp_queued_locks_lock);
+}
+
+static void
+gomp_set_speculative_lock_slow (omp_lock_t *lock)
+{
+  int oldval = GOMP_LOCK_SPECULATIVE;
+
+  if (__atomic_compare_exchange_n (lock, &oldval, GOMP_LOCK_SPECULATIVE + 1,
+				   false, MEMMODEL_ACQUIRE, MEMMODEL_RELAXED))
+    return;
+  while (__atomic_exchange_n (lock, GOMP_LOCK_SPECULATIVE + 2,
+			      MEMMODEL_ACQUIRE) != GOMP_LOCK_SPECULATIVE)
+    do_wait (lock, GOMP_LOCK_SPECULATIVE + 2);
+}
+
+static void
+gomp_unset_speculative_lock_slow (omp_lock_t *lock)
+{
+  if (__atomic_exchange_n (lock, GOMP_LOCK_SPECULATIVE, MEMMODEL_RELEASE)
+      == GOMP_LOCK_SPECULATIVE + 2)
+    futex_wake (lock, 1);
+}
+
+#if defined __x86_64__ || defined __i386__
+/* Number of times a transaction is retried when the CPU says it might
+   succeed next time.  */
+#define GOMP_SPECULATIVE_RETRIES 3
+/* Abort code of a transaction that found the lock held.  */
+#define GOMP_SPECULATIVE_BUSY 0xff
+
+static bool
+gomp_speculation_supported (void)
+{
+  static int rtm;
+  int val = __atomic_load_n (&rtm, MEMMODEL_RELAXED);
+
+  if (val == 0)
+    {
+      unsigned int eax, ebx, ecx, edx;
+      val = 1;
+      if (__get_cpuid_max (0, NULL) >= 7)
+	{
+	  __cpuid_count (7, 0, eax, ebx, ecx, edx);
+	  if (ebx & bit_RTM)
+	    val = 2;
+	}
+      __atomic_store_n (&rtm, val, MEMMODEL_RELAXED);
+    }
+  return val == 2;
+}
+
+static void __attribute__((target ("rtm")))
+gomp_set_speculative_lock (omp_lock_t *lock)
+{
+  int i;
+
+  for (i = 0; i < GOMP_SPECULATIVE_RETRIES; i++)
+    {
+      unsigned int status = _xbegin ();
+      if (status == _XBEGIN_STARTED)
+	{
+	  if (__atomic_load_n (lock, MEMMODEL_RELAXED) == GOMP_LOCK_SPECULATIVE)
+	    return;
+	  _xabort (GOMP_SPECULATIVE_BUSY);
+	}
+      /* If another thread really holds the lock, wait for it.  */
+      if ((status & _XABORT_EXPLICIT)
+	  || (status & _XABORT_RETRY) == 0)
+	break;
+    }
+  gomp_set_speculative_lock_slow (lock);
+}
+
+static void __attribute__((target ("rtm")))
+gomp_unset_speculative_lock (omp_lock_t *lock)
+{
+  if (__atomic_load_n (lock, MEMMODEL_RELAXED) == GOMP_LOCK_SPECULATIVE
+      && _xtest ())
+    _xend ();
+  else
+    gomp_unset_speculative_lock_slow (lock);
+}
+#else
+static inline bool
+gomp_speculation_supported (void)
+{
+  return false;
+}
+
+/* Not reached, no lock is made speculative.  */
+# define gomp_set_speculative_lock gomp_set_speculative_lock_slow
+# define gomp_unset_speculative_lock gomp_unset_speculative_lock_slow
+#endif
+
+static void
+gomp_set_tagged_lock (omp_lock_t *lock, int val)
+{
+  if (val & GOMP_LOCK_QUEUED)
+    {
+      struct gomp_queued_lock *q = gomp_queued_lock (val);
+      struct gomp_mcs_node *node = gomp_mcs_node_get (gomp_thread ());
+      gomp_mcs_lock (&q->tail, node);
+      q->holder = node;
+    }
+  else
+    gomp_set_speculative_lock (lock);
+}
+
+static void
+gomp_unset_tagged_lock (omp_lock_t *lock, int val)
+{
+  if (val & GOMP_LOCK_QUEUED)
+    {
+      struct gomp_queued_lock *q = gomp_queued_lock (val);
+      struct gomp_mcs_node *node = q->holder;
+      gomp_mcs_unlock (&q->tail, node);
+      gomp_mcs_node_put (gomp_thread (), node);
+    }
+  else
+    gomp_unset_speculative_lock (lock);
+}
+
+static int
+gomp_test_tagged_lock (omp_lock_t *lock, int val)
+{
+  if (val & GOMP_LOCK_QUEUED)
+    {
+      struct gomp_queued_lock *q = gomp_queued_lock (val);
+      struct gomp_thread *thr = gomp_thread ();
+      struct gomp_mcs_node *node = gomp_mcs_node_get (thr);
+      if (gomp_mcs_trylock (&q->tail, node))
+	{
+	  q->holder = node;
+	  return 1;
+	}
+      gomp_mcs_node_put (thr, node);
+      return 0;
+    }
+  else
+    {
+      int oldval = GOMP_LOCK_SPECULATIVE;
+      return __atomic_compare_exchange_n (lock, &oldval,
+					  GOMP_LOCK_SPECULATIVE + 1, false,
+					  MEMMODEL_ACQUIRE, MEMMODEL_RELAXED);
+    }
+}
+
+void
+gomp_init_lock_30 (omp_lock_t *lock)
+{
+  gomp_mutex_init (lock);
+}
+
+void
+gomp_destroy_lock_30 (omp_lock_t *lock)
+{
+  if (__builtin_expect (*lock & GOMP_LOCK_QUEUED, 0) && *lock > 1)
+    gomp_queued_lock_free (*lock);
+  gomp_mutex_destroy (lock);
+}
+
+void
+gomp_set_lock_30 (omp_lock_t *lock)
+{
+  int oldval = 0;
+
+  if (!__atomic_compare_exchange_n (lock, &oldval, 1, false,
+				    MEMMODEL_ACQUIRE, MEMMODEL_RELAXED))
+    {
+      if (__builtin_expect (oldval > 1, 0))
+	gomp_set_tagged_lock (lock, oldval);
+      else
+	gomp_mutex_lock_slow (lock, oldval);
+    }
+}
+
+void
+gomp_unset_lock_30 (omp_lock_t *lock)
+{
+  int val = __atomic_load_n (lock, MEMMODEL_RELAXED);
+
+  if (__builtin_expect (val > 1, 0))
+    gomp_unset_tagged_lock (lock, val);
+  else
+    gomp_mutex_unlock (lock);
+}
+
+int
+gomp_test_lock_30 (omp_lock_t *lock)
+{
+  int oldval = 0;
+
+  if (__atomic_compare_exchange_n (lock, &oldval, 1, false,
+				   MEMMODEL_ACQUIRE, MEMMODEL_RELAXED))
+    return 1;
+  if (__builtin_expect (oldval > 1, 0))
+    return gomp_test_tagged_lock (lock, oldval);
+  return 0;
+}
+
+void
+omp_init_lock_with_hint (omp_lock_t *lock, omp_sync_hint_t hint)
+{
+  gomp_mutex_init (lock);
+  if ((hint & omp_sync_hint_speculative)
+      && !(hint & omp_sync_hint_nonspeculative)
+      && gomp_speculation_supported ())
+    *lock = GOMP_LOCK_SPECULATIVE;
+  else if ((hint & omp_sync_hint_contended)
+	   && !(hint & omp_sync_hint_uncontended))
+    *lock = gomp_queued_lock_new ();
+}
+
 #ifdef LIBGOMP_GNU_SYMBOL_VERSIONING
 /* gomp_mutex_* can be safely locked in one thread and
    unlocked in another thread, so the OpenMP 2.5 and OpenMP 3.0
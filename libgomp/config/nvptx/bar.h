@@ -69,6 +69,14 @@ static inline void gomp_barrier_destroy (gomp_barrier_t *bar)
 {
 }
 
+/* Team barriers have nothing to set up beyond gomp_barrier_init here.  */
+
+static inline void
+gomp_team_barrier_init (gomp_barrier_t *bar, unsigned count)
+{
+  gomp_barrier_init (bar, count);
+}
+
 extern void gomp_barrier_wait (gomp_barrier_t *);
 extern void gomp_barrier_wait_last (gomp_barrier_t *);
 extern void gomp_barrier_wait_end (gomp_barrier_t *, gomp_barrier_state_t);
@@ -104,6 +112,23 @@ gomp_barrier_wait_cancel_start (gomp_barrier_t *bar)
   return gomp_barrier_wait_start (bar);
 }
 
+/* Thread ID of the team is not needed to arrive at a team barrier
+   here.  */
+
+static inline gomp_barrier_state_t
+gomp_team_barrier_wait_start (gomp_barrier_t *bar, unsigned id)
+{
+  (void) id;
+  return gomp_barrier_wait_start (bar);
+}
+
+static inline gomp_barrier_state_t
+gomp_team_barrier_wait_cancel_start (gomp_barrier_t *bar, unsigned id)
+{
+  (void) id;
+  return gomp_barrier_wait_cancel_start (bar);
+}
+
 /* This is like gomp_barrier_wait_start, except it decrements
    bar->awaited_final rather than bar->awaited and should be used
    for the gomp_team_end barrier only.  */
@@ -124,6 +149,16 @@ gomp_barrier_last_thread (gomp_barrier_state_t state)
   return state & BAR_WAS_LAST;
 }
 
+/* Whether tasks may be pending; unlike the inlines below this may be
+   called without team->task_lock held.  */
+
+static inline bool
+gomp_team_barrier_task_pending (gomp_barrier_t *bar)
+{
+  return (__atomic_load_n (&bar->generation, MEMMODEL_RELAXED)
+	  & BAR_TASK_PENDING) != 0;
+}
+
 /* All the inlines below must be called with team->task_lock
    held.  */
 
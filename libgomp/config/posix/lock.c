@@ -207,6 +207,25 @@ gomp_test_nest_lock_30 (omp_nest_lock_t *lock)
 }
 #endif
 
+/* Lock hints are ignored.  */
+
+void
+omp_init_lock_with_hint (omp_lock_t *lock, omp_sync_hint_t hint)
+{
+  (void) hint;
+  gomp_init_lock_30 (lock);
+}
+
+void
+omp_init_nest_lock_with_hint (omp_nest_lock_t *lock, omp_sync_hint_t hint)
+{
+  (void) hint;
+  gomp_init_nest_lock_30 (lock);
+}
+
+ialias (omp_init_lock_with_hint)
+ialias (omp_init_nest_lock_with_hint)
+
 #ifdef LIBGOMP_GNU_SYMBOL_VERSIONING
 void
 gomp_init_lock_25 (omp_lock_25_t *lock)
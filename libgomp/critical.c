@@ -26,9 +26,137 @@
 /* This file handles the CRITICAL construct.  */
 
 #include "libgomp.h"
+#include "doacross.h"
 #include <stdlib.h>
 
 
+struct gomp_mcs_node *
+gomp_mcs_node_alloc (void)
+{
+  struct gomp_mcs_node *node
+    = gomp_aligned_alloc (__alignof (struct gomp_mcs_node), sizeof (*node));
+  gomp_sem_init (&node->sem, 0);
+  return node;
+}
+
+void
+gomp_free_mcs_nodes (struct gomp_thread *thr)
+{
+  struct gomp_mcs_node *node, *next;
+
+  for (node = thr->mcs_free; node; node = next)
+    {
+      next = node->link;
+      gomp_sem_destroy (&node->sem);
+      gomp_aligned_free (node);
+    }
+  thr->mcs_free = NULL;
+}
+
+void
+gomp_mcs_lock (struct gomp_mcs_node **lock, struct gomp_mcs_node *node)
+{
+  struct gomp_mcs_node *prev;
+
+  node->next = NULL;
+  prev = __atomic_exchange_n (lock, node, MEMMODEL_ACQ_REL);
+  if (prev != NULL)
+    {
+      __atomic_store_n (&prev->next, node, MEMMODEL_RELEASE);
+      gomp_sem_wait (&node->sem);
+    }
+}
+
+bool
+gomp_mcs_trylock (struct gomp_mcs_node **lock, struct gomp_mcs_node *node)
+{
+  struct gomp_mcs_node *prev = NULL;
+
+  node->next = NULL;
+  return __atomic_compare_exchange_n (lock, &prev, node, false,
+				      MEMMODEL_ACQUIRE, MEMMODEL_RELAXED);
+}
+
+void
+gomp_mcs_unlock (struct gomp_mcs_node **lock, struct gomp_mcs_node *node)
+{
+  struct gomp_mcs_node *next = __atomic_load_n (&node->next,
+						MEMMODEL_ACQUIRE);
+
+  if (next == NULL)
+    {
+      struct gomp_mcs_node *expected = node;
+      if (__atomic_compare_exchange_n (lock, &expected, NULL, false,
+				       MEMMODEL_RELEASE, MEMMODEL_RELAXED))
+	return;
+      /* Another thread has swapped itself in as the tail, but hasn't
+	 linked itself after NODE yet.  */
+      while ((next = __atomic_load_n (&node->next, MEMMODEL_ACQUIRE)) == NULL)
+	cpu_relax ();
+    }
+  gomp_sem_post (&next->sem);
+}
+
+#ifdef LIBGOMP_USE_PTHREADS
+/* The critical regions are MCS queue locks, so that threads waiting for
+   a contended one sleep on their own node rather than all fighting over
+   one cache line, and get the lock in the order they asked for it.  The
+   space for a pointer of a named critical region is the lock.  As
+   critical regions are properly nested, a thread's nodes for them are
+   kept on its mcs_critical stack.  */
+
+static inline void
+gomp_critical_lock (struct gomp_mcs_node **lock)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_mcs_node *node = gomp_mcs_node_get (thr);
+
+  gomp_mcs_lock (lock, node);
+  node->link = thr->mcs_critical;
+  thr->mcs_critical = node;
+}
+
+static inline void
+gomp_critical_unlock (struct gomp_mcs_node **lock)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_mcs_node *node = thr->mcs_critical;
+
+  thr->mcs_critical = node->link;
+  gomp_mcs_unlock (lock, node);
+  gomp_mcs_node_put (thr, node);
+}
+
+static struct gomp_mcs_node *default_lock;
+
+void
+GOMP_critical_start (void)
+{
+  /* There is an implicit flush on entry to a critical region. */
+  __atomic_thread_fence (MEMMODEL_RELEASE);
+  gomp_critical_lock (&default_lock);
+}
+
+void
+GOMP_critical_end (void)
+{
+  gomp_critical_unlock (&default_lock);
+}
+
+void
+GOMP_critical_name_start (void **pptr)
+{
+  gomp_critical_lock ((struct gomp_mcs_node **) pptr);
+}
+
+void
+GOMP_critical_name_end (void **pptr)
+{
+  gomp_critical_unlock ((struct gomp_mcs_node **) pptr);
+}
+
+#else
+
 static gomp_mutex_t default_lock;
 
 void
@@ -125,3 +253,4 @@ initialize_critical (void)
 #endif
 }
 #endif
+#endif /* LIBGOMP_USE_PTHREADS */
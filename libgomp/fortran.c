@@ -46,6 +46,8 @@ ialias_redirect (omp_unset_nest_lock)
 ialias_redirect (omp_test_lock)
 ialias_redirect (omp_test_nest_lock)
 # endif
+ialias_redirect (omp_init_lock_with_hint)
+ialias_redirect (omp_init_nest_lock_with_hint)
 ialias_redirect (omp_set_dynamic)
 ialias_redirect (omp_set_nested)
 ialias_redirect (omp_set_num_threads)
@@ -119,6 +121,24 @@ gomp_init_nest_lock__30 (omp_nest_lock_arg_t lock)
   gomp_init_nest_lock_30 (omp_nest_lock_arg (lock));
 }
 
+void
+omp_init_lock_with_hint_ (omp_lock_arg_t lock, const int32_t *hint)
+{
+#ifndef OMP_LOCK_DIRECT
+  omp_lock_arg (lock) = malloc (sizeof (omp_lock_t));
+#endif
+  omp_init_lock_with_hint (omp_lock_arg (lock), *hint);
+}
+
+void
+omp_init_nest_lock_with_hint_ (omp_nest_lock_arg_t lock, const int32_t *hint)
+{
+#ifndef OMP_NEST_LOCK_DIRECT
+  omp_nest_lock_arg (lock) = malloc (sizeof (omp_nest_lock_t));
+#endif
+  omp_init_nest_lock_with_hint (omp_nest_lock_arg (lock), *hint);
+}
+
 void
 gomp_destroy_lock__30 (omp_lock_arg_t lock)
 {
@@ -29,6 +29,8 @@
 #include "libgomp.h"
 #include <stdlib.h>
 
+ialias_redirect (omp_get_wtime)
+
 
 /* This function implements the STATIC scheduling method.  The caller should
    iterate *pstart <= x < *pend.  Return zero if there are more iterations
@@ -336,3 +338,181 @@ gomp_iter_guided_next (long *pstart, long *pend)
   return true;
 }
 #endif /* HAVE_SYNC_BUILTINS */
+
+
+/* The AUTO scheduling method gives each thread a contiguous range of
+   iterations like schedule(static) does, and lets the thread take chunks
+   from it whose size follows the measured cost of the iterations.  Threads
+   that run out of work steal half of what is left of another thread's
+   range, so an imbalance between the ranges evens out without all threads
+   contending for one shared counter.
+
+   This is the time in seconds the chunks should take.  It is long enough
+   that taking a chunk and reading the clock don't matter, and short enough
+   that the threads finish their last chunks close together.  */
+
+#define GOMP_AUTO_CHUNK_TIME 20e-6
+
+/* Set up WS for the AUTO scheduling method of a loop with N iterations
+   run by NTHREADS threads.  */
+
+void
+gomp_iter_auto_init (struct gomp_work_share *ws, unsigned nthreads,
+		     unsigned long long n)
+{
+  struct gomp_auto_range *r;
+  unsigned long long q = n / nthreads, t = n % nthreads, s = 0;
+  unsigned i;
+
+  r = gomp_aligned_alloc (__alignof__ (struct gomp_auto_range),
+			  nthreads * sizeof (*r));
+  for (i = 0; i < nthreads; i++)
+    {
+      gomp_mutex_init (&r[i].lock);
+      r[i].next = s;
+      s += q + (i < t);
+      r[i].end = s;
+      r[i].last = 0;
+      r[i].stamp = 0;
+      r[i].victim = i + 1 < nthreads ? i + 1 : 0;
+    }
+  ws->chunk_size_ull = n;
+  ws->auto_ranges = r;
+}
+
+/* Move half of the iterations left in some other thread's range into
+   the empty range R.  Return false if no thread has more than one
+   iteration left.  */
+
+static bool
+gomp_iter_auto_steal (struct gomp_auto_range *ranges,
+		      struct gomp_auto_range *r, unsigned nthreads)
+{
+  unsigned i, v = r->victim;
+
+  for (i = 0; i < nthreads; i++, v = v + 1 < nthreads ? v + 1 : 0)
+    {
+      struct gomp_auto_range *vr = &ranges[v];
+      unsigned long long end, half = 0;
+
+      if (vr == r
+	  || (__atomic_load_n (&vr->end, MEMMODEL_RELAXED)
+	      - __atomic_load_n (&vr->next, MEMMODEL_RELAXED)) < 2)
+	continue;
+
+      gomp_mutex_lock (&vr->lock);
+      end = vr->end;
+      if (end - vr->next >= 2)
+	{
+	  half = (end - vr->next) / 2;
+	  vr->end = end - half;
+	}
+      gomp_mutex_unlock (&vr->lock);
+
+      if (half)
+	{
+	  gomp_mutex_lock (&r->lock);
+	  r->next = end - half;
+	  r->end = end;
+	  gomp_mutex_unlock (&r->lock);
+	  r->victim = v;
+	  return true;
+	}
+    }
+  return false;
+}
+
+/* This function implements the AUTO scheduling method in terms of
+   iteration numbers, which the caller should iterate *PSTART <= x < *PEND.
+   Returns true if there is work remaining to be performed.  */
+
+bool
+gomp_iter_auto_next_1 (unsigned long long *pstart, unsigned long long *pend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_team *team = thr->ts.team;
+  struct gomp_work_share *ws = thr->ts.work_share;
+  unsigned nthreads = team ? team->nthreads : 1;
+  struct gomp_auto_range *r = &ws->auto_ranges[thr->ts.team_id];
+  unsigned long long start, chunk;
+  double now = 0;
+
+  if (nthreads == 1)
+    chunk = ~0ULL;
+  else
+    {
+      /* Aim for chunks of GOMP_AUTO_CHUNK_TIME given how long the previous
+	 chunk took, but at most double the chunk size each time, as one
+	 quick chunk says little about the ones following it.  */
+      now = omp_get_wtime ();
+      if (r->last == 0)
+	chunk = 1;
+      else
+	{
+	  double t = now - r->stamp;
+	  if (t < GOMP_AUTO_CHUNK_TIME / 2)
+	    chunk = r->last < ~0ULL / 2 ? r->last * 2 : r->last;
+	  else
+	    {
+	      double c = r->last * (GOMP_AUTO_CHUNK_TIME / t);
+	      chunk = c < 1 ? 1 : (unsigned long long) c;
+	    }
+	}
+    }
+
+  while (1)
+    {
+      unsigned long long left;
+
+      gomp_mutex_lock (&r->lock);
+      start = r->next;
+      left = r->end - start;
+      if (left)
+	{
+	  /* Leave at least half of the range for the thieves, so that the
+	     chunks get smaller towards the end of the loop.  */
+	  if (nthreads > 1 && chunk > left - left / 2)
+	    chunk = left - left / 2;
+	  else if (chunk > left)
+	    chunk = left;
+	  r->next = start + chunk;
+	  gomp_mutex_unlock (&r->lock);
+	  break;
+	}
+      gomp_mutex_unlock (&r->lock);
+
+      if (nthreads == 1
+	  || !gomp_iter_auto_steal (ws->auto_ranges, r, nthreads))
+	{
+	  r->last = 0;
+	  return false;
+	}
+    }
+
+  r->last = chunk;
+  r->stamp = now;
+  *pstart = start;
+  *pend = start + chunk;
+  return true;
+}
+
+/* Similar, but returns the bounds of the iteration block like the other
+   gomp_iter_*_next functions.  */
+
+bool
+gomp_iter_auto_next (long *pstart, long *pend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_work_share *ws = thr->ts.work_share;
+  unsigned long long s, e;
+
+  if (!gomp_iter_auto_next_1 (&s, &e))
+    return false;
+
+  *pstart = (unsigned long) ws->next + s * (unsigned long) ws->incr;
+  if (e == ws->chunk_size_ull)
+    *pend = ws->end;
+  else
+    *pend = (unsigned long) ws->next + e * (unsigned long) ws->incr;
+  return true;
+}
@@ -343,3 +343,25 @@ gomp_iter_ull_guided_next (gomp_ull *pstart, gomp_ull *pend)
   return true;
 }
 #endif /* HAVE_SYNC_BUILTINS */
+
+
+/* This function implements the AUTO scheduling method, see
+   gomp_iter_auto_next_1.  Arguments are as for gomp_iter_ull_static_next.  */
+
+bool
+gomp_iter_ull_auto_next (gomp_ull *pstart, gomp_ull *pend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_work_share *ws = thr->ts.work_share;
+  gomp_ull s, e;
+
+  if (!gomp_iter_auto_next_1 (&s, &e))
+    return false;
+
+  *pstart = ws->next_ull + s * ws->incr_ull;
+  if (e == ws->chunk_size_ull)
+    *pend = ws->end_ull;
+  else
+    *pend = ws->next_ull + e * ws->incr_ull;
+  return true;
+}
@@ -45,6 +45,7 @@
 #include <stdint.h>
 #include "libgomp-plugin.h"
 #include "gomp-constants.h"
+#include "omp-tools.h"
 
 #ifdef HAVE_PTHREAD_H
 #include <pthread.h>
@@ -194,6 +195,25 @@ struct gomp_doacross_work_share
   unsigned int shift_counts[];
 };
 
+/* The part of the iteration space of a GFS_AUTO loop that one thread of
+   the team starts with.  Iterations are numbered from zero.  The owner
+   takes chunks from the front, other threads that ran out of work steal
+   from the back.  */
+
+struct gomp_auto_range
+{
+  /* This lock protects NEXT and END.  */
+  gomp_mutex_t lock;
+  /* Next iteration the owner will take and end of the range.  */
+  unsigned long long next, end;
+  /* Only used by the owner: the size of the chunk it took last, zero
+     before the first one, and the time at which it took it.  */
+  unsigned long long last;
+  double stamp;
+  /* Only used by the owner: the thread to try to steal from next.  */
+  unsigned victim;
+} __attribute__((aligned (64)));
+
 struct gomp_work_share
 {
   /* This member records the SCHEDULE clause to be used for this construct.
@@ -205,7 +225,8 @@ struct gomp_work_share
 
   union {
     struct {
-      /* This is the chunk_size argument to the SCHEDULE clause.  */
+      /* This is the chunk_size argument to the SCHEDULE clause.  For
+	 GFS_AUTO loops, this is the number of iterations instead.  */
       long chunk_size;
 
       /* This is the iteration end point.  If this is a SECTIONS construct,
@@ -294,6 +315,9 @@ struct gomp_work_share
   /* Task reductions for this work-sharing construct.  */
   uintptr_t *task_reductions;
 
+  /* For GFS_AUTO loops, one gomp_auto_range per thread in the team.  */
+  struct gomp_auto_range *auto_ranges;
+
   /* If only few threads are in the team, ordered_team_ids can point
      to this array which fills the padding at the end of this struct.  */
   unsigned inline_ordered_team_ids[0];
@@ -345,6 +369,13 @@ struct gomp_team_state
      is 1, etc.  This is unused when the compiler knows in advance that
      the loop is statically scheduled.  */
   unsigned long static_trip;
+
+  /* Def-allocator-var ICV, omp_null_allocator until first used.  */
+  uintptr_t def_allocator;
+
+  /* Kind of the worksharing construct an OMPT work begin callback was
+     dispatched for, 0 if none.  */
+  int ompt_work;
 };
 
 struct target_mem_desc;
@@ -387,6 +418,7 @@ extern int gomp_debug_var;
 extern bool gomp_display_affinity_var;
 extern char *gomp_affinity_format_var;
 extern size_t gomp_affinity_format_len;
+extern uintptr_t gomp_def_allocator;
 extern int goacc_device_num;
 extern char *goacc_device_type;
 extern int goacc_default_dims[GOMP_DIM_MAX];
@@ -460,6 +492,19 @@ struct gomp_task
      0, we have no unsatisfied dependencies, and this task can be put
      into the various queues to be scheduled.  */
   size_t num_dependees;
+  /* Number of children that went into a task deque and haven't
+     finished yet.  These are not in CHILDREN_QUEUE.  */
+  size_t num_stealable_children;
+  /* Index of the bottom of the running thread's task deque at the time
+     this task started running.  Entries at or above it that are still
+     in that deque are descendants of this task.  ~0UL if this task
+     hasn't been started by gomp_task_run_pre or the stealable task
+     path.  */
+  unsigned long deque_mark;
+  /* One reference for the task itself until it has finished, plus one
+     for each stealable child until that child has been freed, so that
+     stealable children can always access their parent.  */
+  unsigned int refcount;
 
   /* Priority of this task.  */
   int priority;
@@ -472,6 +517,8 @@ struct gomp_task
   struct gomp_task_icv icv;
   void (*fn) (void *);
   void *fn_data;
+  /* Task data of an attached OMPT tool.  */
+  ompt_data_t ompt_data;
   enum gomp_task_kind kind;
   bool in_tied_task;
   bool final_task;
@@ -480,11 +527,42 @@ struct gomp_task
      block further execution of their parent until the dependencies
      are satisfied.  */
   bool parent_depends_on;
+  /* Set for tasks that went into a task deque instead of the priority
+     queues.  */
+  bool stealable;
   /* Dependencies provided and/or needed for this task.  DEPEND_COUNT
      is the number of items available.  */
   struct gomp_task_depend_entry depend[];
 };
 
+/* Number of entries in each struct gomp_task_deque, must be a power
+   of 2.  */
+#define GOMP_TASK_DEQUE_SIZE 1024
+
+/* A Chase-Lev work-stealing deque of deferred tasks without priority or
+   dependencies, owned by one thread of a team.  The owner pushes and
+   takes tasks at the bottom without taking team->task_lock, other
+   threads in gomp_barrier_handle_tasks steal them from the top.  TOP and
+   BOTTOM only ever grow; only their difference matters.  */
+
+struct gomp_task_deque
+{
+  /* Index of the oldest task, advanced with a CAS by thieves and by the
+     owner taking the last task.  */
+  unsigned long top __attribute__((aligned (64)));
+  /* Index one past the newest task, only written by the owner.  */
+  unsigned long bottom __attribute__((aligned (64)));
+  /* Statistics reported when GOMP_DEBUG=1, only written by the owner:
+     tasks pushed, tasks that went through team->task_lock because the
+     deque was full, tasks stolen from other threads and steals lost
+     to a concurrent thief or owner.  */
+  unsigned long pushed;
+  unsigned long overflowed;
+  unsigned long stolen;
+  unsigned long steal_conflicts;
+  struct gomp_task *tasks[GOMP_TASK_DEQUE_SIZE];
+};
+
 /* This structure describes a single #pragma omp taskgroup.  */
 
 struct gomp_taskgroup
@@ -556,6 +634,11 @@ struct gomp_team
      of the threads in the team.  */
   gomp_sem_t **ordered_release;
 
+  /* This points to an array with a pointer to the task deque of each
+     thread in the team, allocated on first use and kept while the
+     team is reused.  */
+  struct gomp_task_deque **task_deques;
+
   /* List of work shares on which gomp_fini_work_share hasn't been
      called yet.  If the team hasn't been cancelled, this should be
      equal to each thr->ts.work_share, but otherwise it can be a possibly
@@ -594,7 +677,9 @@ struct gomp_team
   gomp_mutex_t task_lock;
   /* Scheduled tasks.  */
   struct priority_queue task_queue;
-  /* Number of all GOMP_TASK_{WAITING,TIED} tasks in the team.  */
+  /* Number of all GOMP_TASK_{WAITING,TIED} tasks in the team.
+     Modified atomically, as tasks in the task deques are counted
+     without holding task_lock.  */
   unsigned int task_count;
   /* Number of GOMP_TASK_WAITING tasks currently waiting to be scheduled.  */
   unsigned int task_queued_count;
@@ -604,11 +689,14 @@ struct gomp_team
      that is called from a task run from gomp_barrier_handle_tasks.
      task_running_count should be always <= team->nthreads,
      and if current task isn't in_tied_task, then it will be
-     even < team->nthreads.  */
+     even < team->nthreads.  Modified atomically.  */
   unsigned int task_running_count;
   int work_share_cancelled;
   int team_cancelled;
 
+  /* Parallel data of an attached OMPT tool.  */
+  ompt_data_t ompt_parallel_data;
+
   /* This array contains structures for implicit tasks.  */
   struct gomp_task implicit_task[];
 };
@@ -616,6 +704,12 @@ struct gomp_team
 /* This structure contains all data that is private to libgomp and is
    allocated per thread.  */
 
+/* Number of size classes of the per-thread omp_alloc cache.  */
+#define GOMP_ALLOC_CACHE_CLASSES 16
+
+/* Number of finished teams a thread keeps for reuse, see team.c.  */
+#define GOMP_TEAM_CACHE_SIZE 4
+
 struct gomp_thread
 {
   /* This is the function that the thread should run upon launch.  */
@@ -639,6 +733,26 @@ struct gomp_thread
   /* User pthread thread pool */
   struct gomp_thread_pool *thread_pool;
 
+  /* Small blocks of predefined allocators freed by omp_free, kept for
+     reuse by omp_alloc.  Singly linked by their first word per size
+     class, see allocator.c.  */
+  void *alloc_cache[GOMP_ALLOC_CACHE_CLASSES];
+  unsigned char alloc_cache_len[GOMP_ALLOC_CACHE_CLASSES];
+
+  /* Teams this thread created and ended, kept for reuse by gomp_new_team,
+     most recently ended first.  */
+  struct gomp_team *team_cache[GOMP_TEAM_CACHE_SIZE];
+
+  /* While the thread waits in gomp_thread_park to be reused for another
+     team, the next parked thread and the semaphore the thread sleeps on.  */
+  struct gomp_thread *parked_next;
+  gomp_sem_t parked_release;
+
+  /* MCS queue nodes this thread can use to wait for a lock, and the nodes
+     of the critical regions it is in, innermost first, see critical.c.  */
+  struct gomp_mcs_node *mcs_free;
+  struct gomp_mcs_node *mcs_critical;
+
 #if defined(LIBGOMP_USE_PTHREADS) \
     && (!defined(HAVE_TLS) \
 	|| !defined(__GLIBC__) \
@@ -730,6 +844,28 @@ extern pthread_key_t gomp_thread_destructor;
 
 /* Function prototypes.  */
 
+/* critical.c */
+
+/* A node of an MCS queue lock.  The lock itself is a pointer to the node
+   of the last thread in the queue, NULL if it is unlocked.  Each waiting
+   thread sleeps on the semaphore in its own node, which its predecessor
+   posts to hand the lock over.  */
+
+struct gomp_mcs_node
+{
+  struct gomp_mcs_node *next;
+  gomp_sem_t sem;
+  /* Link in a gomp_thread's mcs_free or mcs_critical list.  */
+  struct gomp_mcs_node *link;
+} __attribute__((aligned (64)));
+
+extern void gomp_mcs_lock (struct gomp_mcs_node **, struct gomp_mcs_node *);
+extern bool gomp_mcs_trylock (struct gomp_mcs_node **,
+			      struct gomp_mcs_node *);
+extern void gomp_mcs_unlock (struct gomp_mcs_node **, struct gomp_mcs_node *);
+extern struct gomp_mcs_node *gomp_mcs_node_alloc (void);
+extern void gomp_free_mcs_nodes (struct gomp_thread *);
+
 /* affinity.c */
 
 extern void gomp_init_affinity (void);
@@ -746,6 +882,7 @@ extern bool gomp_affinity_same_place (void *, void *);
 extern bool gomp_affinity_finalize_place_list (bool);
 extern bool gomp_affinity_init_level (int, unsigned long, bool);
 extern void gomp_affinity_print_place (void *);
+extern unsigned long gomp_affinity_places_per_socket (void);
 extern void gomp_get_place_proc_ids_8 (int, int64_t *);
 extern void gomp_display_affinity_place (char *, size_t, size_t *, int);
 
@@ -767,12 +904,22 @@ extern void gomp_display_affinity_thread (gomp_thread_handle,
 					  struct gomp_team_state *,
 					  unsigned int) __attribute__((cold));
 
+/* allocator.c */
+
+extern void gomp_free_alloc_cache (struct gomp_thread *);
+
 /* iter.c */
 
 extern int gomp_iter_static_next (long *, long *);
 extern bool gomp_iter_dynamic_next_locked (long *, long *);
 extern bool gomp_iter_guided_next_locked (long *, long *);
 
+extern void gomp_iter_auto_init (struct gomp_work_share *, unsigned,
+				 unsigned long long);
+extern bool gomp_iter_auto_next_1 (unsigned long long *,
+				   unsigned long long *);
+extern bool gomp_iter_auto_next (long *, long *);
+
 #ifdef HAVE_SYNC_BUILTINS
 extern bool gomp_iter_dynamic_next (long *, long *);
 extern bool gomp_iter_guided_next (long *, long *);
@@ -786,6 +933,8 @@ extern bool gomp_iter_ull_dynamic_next_locked (unsigned long long *,
 					       unsigned long long *);
 extern bool gomp_iter_ull_guided_next_locked (unsigned long long *,
 					      unsigned long long *);
+extern bool gomp_iter_ull_auto_next (unsigned long long *,
+				     unsigned long long *);
 
 #if defined HAVE_SYNC_BUILTINS && defined __LP64__
 extern bool gomp_iter_ull_dynamic_next (unsigned long long *,
@@ -806,6 +955,27 @@ extern void gomp_doacross_init (unsigned, long *, long, size_t);
 extern void gomp_doacross_ull_init (unsigned, unsigned long long *,
 				    unsigned long long, size_t);
 
+/* ompt.c */
+
+/* Callbacks registered by an OMPT tool, NULL if there is none.  Each
+   hook below tests its pointer with __builtin_expect, which is all the
+   interface costs when no tool is attached.  */
+
+struct gomp_ompt_callbacks
+{
+  ompt_callback_parallel_begin_t parallel_begin;
+  ompt_callback_parallel_end_t parallel_end;
+  ompt_callback_task_create_t task_create;
+  ompt_callback_task_schedule_t task_schedule;
+  ompt_callback_sync_region_t sync_region_wait;
+  ompt_callback_work_t work;
+};
+
+extern struct gomp_ompt_callbacks gomp_ompt_callbacks;
+extern const ompt_frame_t gomp_ompt_frame_none;
+
+extern void gomp_ompt_initialize (void);
+
 /* parallel.c */
 
 extern unsigned gomp_resolve_num_threads (unsigned, unsigned);
@@ -831,6 +1001,8 @@ extern struct gomp_taskgroup *gomp_parallel_reduction_register (uintptr_t *,
 								unsigned);
 extern void gomp_workshare_taskgroup_start (void);
 extern void gomp_workshare_task_reduction_register (uintptr_t *, uintptr_t *);
+extern void gomp_task_deques_report (struct gomp_team *);
+extern void gomp_task_deques_free (struct gomp_team *);
 
 static void inline
 gomp_finish_task (struct gomp_task *task)
@@ -1100,7 +1272,7 @@ extern bool gomp_remove_var (struct gomp_device_descr *, splay_tree_key);
 
 extern void gomp_init_work_share (struct gomp_work_share *, size_t, unsigned);
 extern void gomp_fini_work_share (struct gomp_work_share *);
-extern bool gomp_work_share_start (size_t);
+extern bool gomp_work_share_start (size_t, int);
 extern void gomp_work_share_end (void);
 extern bool gomp_work_share_end_cancel (void);
 extern void gomp_work_share_end_nowait (void);
@@ -1113,6 +1285,101 @@ gomp_work_share_init_done (void)
     gomp_ptrlock_set (&thr->ts.last_work_share->next_ws, thr->ts.work_share);
 }
 
+/* Take an MCS queue node from THR's free list, or put NODE back on it.  */
+
+static inline struct gomp_mcs_node *
+gomp_mcs_node_get (struct gomp_thread *thr)
+{
+  struct gomp_mcs_node *node = thr->mcs_free;
+  if (__builtin_expect (node == NULL, 0))
+    return gomp_mcs_node_alloc ();
+  thr->mcs_free = node->link;
+  return node;
+}
+
+static inline void
+gomp_mcs_node_put (struct gomp_thread *thr, struct gomp_mcs_node *node)
+{
+  node->link = thr->mcs_free;
+  thr->mcs_free = node;
+}
+
+/* OMPT hooks.  */
+
+static inline ompt_data_t *
+gomp_ompt_task_data (struct gomp_task *task)
+{
+  return task ? &task->ompt_data : NULL;
+}
+
+static inline ompt_data_t *
+gomp_ompt_parallel_data (struct gomp_team *team)
+{
+  return team ? &team->ompt_parallel_data : NULL;
+}
+
+static inline void
+gomp_ompt_task_create (struct gomp_task *parent, struct gomp_task *task,
+		       int flags, int has_dependences)
+{
+  if (__builtin_expect (gomp_ompt_callbacks.task_create != NULL, 0))
+    gomp_ompt_callbacks.task_create (gomp_ompt_task_data (parent),
+				     &gomp_ompt_frame_none, &task->ompt_data,
+				     flags, has_dependences, NULL);
+}
+
+static inline void
+gomp_ompt_task_schedule (struct gomp_task *prior, ompt_task_status_t status,
+			 struct gomp_task *next)
+{
+  if (__builtin_expect (gomp_ompt_callbacks.task_schedule != NULL, 0))
+    gomp_ompt_callbacks.task_schedule (gomp_ompt_task_data (prior), status,
+				       gomp_ompt_task_data (next));
+}
+
+static inline void
+gomp_ompt_sync_region_wait (ompt_sync_region_t kind,
+			    ompt_scope_endpoint_t endpoint)
+{
+  if (__builtin_expect (gomp_ompt_callbacks.sync_region_wait != NULL, 0))
+    {
+      struct gomp_thread *thr = gomp_thread ();
+      gomp_ompt_callbacks.sync_region_wait (kind, endpoint,
+					    gomp_ompt_parallel_data (thr->ts.team),
+					    gomp_ompt_task_data (thr->task),
+					    NULL);
+    }
+}
+
+/* Dispatch the work begin callback for a worksharing construct of kind
+   WSTYPE, or for nothing if WSTYPE is 0, and remember it so that
+   gomp_ompt_work_end can dispatch the matching end callback.  */
+
+static inline void
+gomp_ompt_work_begin (struct gomp_thread *thr, int wstype)
+{
+  if (__builtin_expect (gomp_ompt_callbacks.work != NULL, 0) && wstype)
+    {
+      thr->ts.ompt_work = wstype;
+      gomp_ompt_callbacks.work (wstype, ompt_scope_begin,
+				gomp_ompt_parallel_data (thr->ts.team),
+				gomp_ompt_task_data (thr->task), 0, NULL);
+    }
+}
+
+static inline void
+gomp_ompt_work_end (struct gomp_thread *thr)
+{
+  if (__builtin_expect (thr->ts.ompt_work != 0, 0))
+    {
+      if (gomp_ompt_callbacks.work != NULL)
+	gomp_ompt_callbacks.work (thr->ts.ompt_work, ompt_scope_end,
+				  gomp_ompt_parallel_data (thr->ts.team),
+				  gomp_ompt_task_data (thr->task), 0, NULL);
+      thr->ts.ompt_work = 0;
+    }
+}
+
 #ifdef HAVE_ATTRIBUTE_VISIBILITY
 # pragma GCC visibility pop
 #endif
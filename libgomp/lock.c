@@ -31,8 +31,11 @@
 #include "libgomp.h"
 
 /* The internal gomp_mutex_t and the external non-recursive omp_lock_t
-   have the same form.  Re-use it.  */
+   have the same form.  Re-use it.  A config that acts on lock hints
+   defines GOMP_HAVE_LOCK_HINTS and provides the non-recursive locks
+   itself.  */
 
+#ifndef GOMP_HAVE_LOCK_HINTS
 void
 gomp_init_lock_30 (omp_lock_t *lock)
 {
@@ -66,6 +69,14 @@ gomp_test_lock_30 (omp_lock_t *lock)
 				      MEMMODEL_ACQUIRE, MEMMODEL_RELAXED);
 }
 
+void
+omp_init_lock_with_hint (omp_lock_t *lock, omp_sync_hint_t hint)
+{
+  (void) hint;
+  gomp_init_lock_30 (lock);
+}
+#endif /* GOMP_HAVE_LOCK_HINTS */
+
 void
 gomp_init_nest_lock_30 (omp_nest_lock_t *lock)
 {
@@ -121,3 +132,13 @@ gomp_test_nest_lock_30 (omp_nest_lock_t *lock)
 
   return 0;
 }
+
+void
+omp_init_nest_lock_with_hint (omp_nest_lock_t *lock, omp_sync_hint_t hint)
+{
+  (void) hint;
+  gomp_init_nest_lock_30 (lock);
+}
+
+ialias (omp_init_lock_with_hint)
+ialias (omp_init_nest_lock_with_hint)
@@ -31,6 +31,7 @@
 #include "libgomp.h"
 
 
+ialias (GOMP_loop_runtime_start)
 ialias (GOMP_loop_runtime_next)
 ialias_redirect (GOMP_taskgroup_reduction_register)
 
@@ -82,6 +83,27 @@ gomp_loop_init (struct gomp_work_share *ws, long start, long end, long incr,
     }
 }
 
+/* Set up the GFS_AUTO loop in WS for a team of NTHREADS threads.  */
+
+static void
+gomp_loop_auto_init (struct gomp_work_share *ws, unsigned nthreads)
+{
+  unsigned long d, incr, n;
+
+  if (ws->incr > 0)
+    {
+      d = (unsigned long) ws->end - ws->next;
+      incr = ws->incr;
+    }
+  else
+    {
+      d = (unsigned long) ws->next - ws->end;
+      incr = -(unsigned long) ws->incr;
+    }
+  n = d ? (d - 1) / incr + 1 : 0;
+  gomp_iter_auto_init (ws, nthreads, n);
+}
+
 /* The *_start routines are called when first encountering a loop construct
    that is not bound directly to a parallel construct.  The first thread
    that arrives will create the work-share construct; subsequent threads
@@ -105,7 +127,7 @@ gomp_loop_static_start (long start, long end, long incr, long chunk_size,
   struct gomp_thread *thr = gomp_thread ();
 
   thr->ts.static_trip = 0;
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_init (thr->ts.work_share, start, end, incr,
 		      GFS_STATIC, chunk_size);
@@ -127,7 +149,7 @@ gomp_loop_dynamic_start (long start, long end, long incr, long chunk_size,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_init (thr->ts.work_share, start, end, incr,
 		      GFS_DYNAMIC, chunk_size);
@@ -155,7 +177,7 @@ gomp_loop_guided_start (long start, long end, long incr, long chunk_size,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_init (thr->ts.work_share, start, end, incr,
 		      GFS_GUIDED, chunk_size);
@@ -173,6 +195,28 @@ gomp_loop_guided_start (long start, long end, long incr, long chunk_size,
   return ret;
 }
 
+/* Schedule(auto) resolved at runtime, where the loop need not be
+   monotonic, splits the iterations like static but adapts the chunk sizes
+   to the cost of the iterations and lets threads steal from each other,
+   see gomp_iter_auto_next_1.  */
+
+static bool
+gomp_loop_auto_start (long start, long end, long incr,
+		      long *istart, long *iend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+
+  if (gomp_work_share_start (0, ompt_work_loop))
+    {
+      gomp_loop_init (thr->ts.work_share, start, end, incr, GFS_AUTO, 0);
+      gomp_loop_auto_init (thr->ts.work_share,
+			   thr->ts.team ? thr->ts.team->nthreads : 1);
+      gomp_work_share_init_done ();
+    }
+
+  return gomp_iter_auto_next (istart, iend);
+}
+
 bool
 GOMP_loop_runtime_start (long start, long end, long incr,
 			 long *istart, long *iend)
@@ -193,17 +237,34 @@ GOMP_loop_runtime_start (long start, long end, long incr,
 				     icv->run_sched_chunk_size,
 				     istart, iend);
     case GFS_AUTO:
-      /* For now map to schedule(static), later on we could play with feedback
-	 driven choice.  */
+      /* This entry point is monotonic, so map to schedule(static).  The
+	 nonmonotonic ones use gomp_loop_auto_start instead.  */
       return gomp_loop_static_start (start, end, incr, 0, istart, iend);
     default:
       abort ();
     }
 }
 
+/* Like GOMP_loop_runtime_start, but the schedule need not be monotonic, so
+   an auto schedule gets gomp_loop_auto_start unless the run-sched-var has
+   the monotonic modifier.  */
+
+static bool
+gomp_loop_nonmonotonic_runtime_start (long start, long end, long incr,
+				      long *istart, long *iend)
+{
+  struct gomp_task_icv *icv = gomp_icv (false);
+  if (icv->run_sched_var == GFS_AUTO)
+    return gomp_loop_auto_start (start, end, incr, istart, iend);
+  return ialias_call (GOMP_loop_runtime_start) (start, end, incr,
+						istart, iend);
+}
+
 static long
 gomp_adjust_sched (long sched, long *chunk_size)
 {
+  bool monotonic = (sched & GFS_MONOTONIC) != 0;
+
   sched &= ~GFS_MONOTONIC;
   switch (sched)
     {
@@ -230,7 +291,8 @@ gomp_adjust_sched (long sched, long *chunk_size)
 	    *chunk_size = icv->run_sched_chunk_size;
 	    break;
 	  case GFS_AUTO:
-	    sched = GFS_STATIC;
+	    if (monotonic || (icv->run_sched_var & GFS_MONOTONIC))
+	      sched = GFS_STATIC;
 	    *chunk_size = 0;
 	    break;
 	  default:
@@ -253,11 +315,14 @@ GOMP_loop_start (long start, long end, long incr, long sched,
   thr->ts.static_trip = 0;
   if (reductions)
     gomp_workshare_taskgroup_start ();
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       sched = gomp_adjust_sched (sched, &chunk_size);
       gomp_loop_init (thr->ts.work_share, start, end, incr,
 		      sched, chunk_size);
+      if (sched == GFS_AUTO)
+	gomp_loop_auto_init (thr->ts.work_share,
+			     thr->ts.team ? thr->ts.team->nthreads : 1);
       if (reductions)
 	{
 	  GOMP_taskgroup_reduction_register (reductions);
@@ -319,7 +384,7 @@ gomp_loop_ordered_static_start (long start, long end, long incr,
   struct gomp_thread *thr = gomp_thread ();
 
   thr->ts.static_trip = 0;
-  if (gomp_work_share_start (1))
+  if (gomp_work_share_start (1, ompt_work_loop))
     {
       gomp_loop_init (thr->ts.work_share, start, end, incr,
 		      GFS_STATIC, chunk_size);
@@ -337,7 +402,7 @@ gomp_loop_ordered_dynamic_start (long start, long end, long incr,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (1))
+  if (gomp_work_share_start (1, ompt_work_loop))
     {
       gomp_loop_init (thr->ts.work_share, start, end, incr,
 		      GFS_DYNAMIC, chunk_size);
@@ -362,7 +427,7 @@ gomp_loop_ordered_guided_start (long start, long end, long incr,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (1))
+  if (gomp_work_share_start (1, ompt_work_loop))
     {
       gomp_loop_init (thr->ts.work_share, start, end, incr,
 		      GFS_GUIDED, chunk_size);
@@ -423,9 +488,10 @@ GOMP_loop_ordered_start (long start, long end, long incr, long sched,
     gomp_workshare_taskgroup_start ();
   if (mem)
     ordered += (uintptr_t) *mem;
-  if (gomp_work_share_start (ordered))
+  if (gomp_work_share_start (ordered, ompt_work_loop))
     {
-      sched = gomp_adjust_sched (sched, &chunk_size);
+      /* Ordered loops are always monotonic.  */
+      sched = gomp_adjust_sched (sched | GFS_MONOTONIC, &chunk_size);
       gomp_loop_init (thr->ts.work_share, start, end, incr,
 		      sched, chunk_size);
       if (reductions)
@@ -497,7 +563,7 @@ gomp_loop_doacross_static_start (unsigned ncounts, long *counts,
   struct gomp_thread *thr = gomp_thread ();
 
   thr->ts.static_trip = 0;
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_init (thr->ts.work_share, 0, counts[0], 1,
 		      GFS_STATIC, chunk_size);
@@ -515,7 +581,7 @@ gomp_loop_doacross_dynamic_start (unsigned ncounts, long *counts,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_init (thr->ts.work_share, 0, counts[0], 1,
 		      GFS_DYNAMIC, chunk_size);
@@ -541,7 +607,7 @@ gomp_loop_doacross_guided_start (unsigned ncounts, long *counts,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_init (thr->ts.work_share, 0, counts[0], 1,
 		      GFS_GUIDED, chunk_size);
@@ -599,12 +665,12 @@ GOMP_loop_doacross_start (unsigned ncounts, long *counts, long sched,
   thr->ts.static_trip = 0;
   if (reductions)
     gomp_workshare_taskgroup_start ();
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       size_t extra = 0;
       if (mem)
 	extra = (uintptr_t) *mem;
-      sched = gomp_adjust_sched (sched, &chunk_size);
+      sched = gomp_adjust_sched (sched | GFS_MONOTONIC, &chunk_size);
       gomp_loop_init (thr->ts.work_share, 0, counts[0], 1,
 		      sched, chunk_size);
       gomp_doacross_init (ncounts, counts, chunk_size, extra);
@@ -691,8 +757,9 @@ GOMP_loop_runtime_next (long *istart, long *iend)
   switch (thr->ts.work_share->sched)
     {
     case GFS_STATIC:
-    case GFS_AUTO:
       return gomp_loop_static_next (istart, iend);
+    case GFS_AUTO:
+      return gomp_iter_auto_next (istart, iend);
     case GFS_DYNAMIC:
       return gomp_loop_dynamic_next (istart, iend);
     case GFS_GUIDED:
@@ -794,9 +861,34 @@ gomp_parallel_loop_start (void (*fn) (void *), void *data,
   num_threads = gomp_resolve_num_threads (num_threads, 0);
   team = gomp_new_team (num_threads);
   gomp_loop_init (&team->work_shares[0], start, end, incr, sched, chunk_size);
+  if (sched == GFS_AUTO)
+    gomp_loop_auto_init (&team->work_shares[0], num_threads);
   gomp_team_start (fn, data, num_threads, flags, team, NULL);
 }
 
+/* Similarly for the runtime schedule.  NONMONOTONIC is true if the loop
+   need not be monotonic, see gomp_loop_nonmonotonic_runtime_start.  */
+
+static void
+gomp_parallel_loop_runtime_start (void (*fn) (void *), void *data,
+				  unsigned num_threads, long start, long end,
+				  long incr, unsigned int flags,
+				  bool nonmonotonic)
+{
+  struct gomp_task_icv *icv = gomp_icv (false);
+  enum gomp_schedule_type sched = icv->run_sched_var & ~GFS_MONOTONIC;
+  long chunk_size = icv->run_sched_chunk_size;
+
+  if (sched == GFS_AUTO
+      && (!nonmonotonic || (icv->run_sched_var & GFS_MONOTONIC)))
+    {
+      sched = GFS_STATIC;
+      chunk_size = 0;
+    }
+  gomp_parallel_loop_start (fn, data, num_threads, start, end, incr,
+			    sched, chunk_size, flags);
+}
+
 void
 GOMP_parallel_loop_static_start (void (*fn) (void *), void *data,
 				 unsigned num_threads, long start, long end,
@@ -829,10 +921,8 @@ GOMP_parallel_loop_runtime_start (void (*fn) (void *), void *data,
 				  unsigned num_threads, long start, long end,
 				  long incr)
 {
-  struct gomp_task_icv *icv = gomp_icv (false);
-  gomp_parallel_loop_start (fn, data, num_threads, start, end, incr,
-			    icv->run_sched_var & ~GFS_MONOTONIC,
-			    icv->run_sched_chunk_size, 0);
+  gomp_parallel_loop_runtime_start (fn, data, num_threads, start, end, incr,
+				    0, false);
 }
 
 ialias_redirect (GOMP_parallel_end)
@@ -875,10 +965,19 @@ GOMP_parallel_loop_runtime (void (*fn) (void *), void *data,
 			    unsigned num_threads, long start, long end,
 			    long incr, unsigned flags)
 {
-  struct gomp_task_icv *icv = gomp_icv (false);
-  gomp_parallel_loop_start (fn, data, num_threads, start, end, incr,
-			    icv->run_sched_var & ~GFS_MONOTONIC,
-			    icv->run_sched_chunk_size, flags);
+  gomp_parallel_loop_runtime_start (fn, data, num_threads, start, end, incr,
+				    flags, false);
+  fn (data);
+  GOMP_parallel_end ();
+}
+
+static void
+gomp_parallel_loop_nonmonotonic_runtime (void (*fn) (void *), void *data,
+					 unsigned num_threads, long start,
+					 long end, long incr, unsigned flags)
+{
+  gomp_parallel_loop_runtime_start (fn, data, num_threads, start, end, incr,
+				    flags, true);
   fn (data);
   GOMP_parallel_end ();
 }
@@ -889,9 +988,9 @@ extern __typeof(GOMP_parallel_loop_dynamic) GOMP_parallel_loop_nonmonotonic_dyna
 extern __typeof(GOMP_parallel_loop_guided) GOMP_parallel_loop_nonmonotonic_guided
 	__attribute__((alias ("GOMP_parallel_loop_guided")));
 extern __typeof(GOMP_parallel_loop_runtime) GOMP_parallel_loop_nonmonotonic_runtime
-	__attribute__((alias ("GOMP_parallel_loop_runtime")));
+	__attribute__((alias ("gomp_parallel_loop_nonmonotonic_runtime")));
 extern __typeof(GOMP_parallel_loop_runtime) GOMP_parallel_loop_maybe_nonmonotonic_runtime
-	__attribute__((alias ("GOMP_parallel_loop_runtime")));
+	__attribute__((alias ("gomp_parallel_loop_nonmonotonic_runtime")));
 #else
 void
 GOMP_parallel_loop_nonmonotonic_dynamic (void (*fn) (void *), void *data,
@@ -922,12 +1021,8 @@ GOMP_parallel_loop_nonmonotonic_runtime (void (*fn) (void *), void *data,
 					 unsigned num_threads, long start,
 					 long end, long incr, unsigned flags)
 {
-  struct gomp_task_icv *icv = gomp_icv (false);
-  gomp_parallel_loop_start (fn, data, num_threads, start, end, incr,
-			    icv->run_sched_var & ~GFS_MONOTONIC,
-			    icv->run_sched_chunk_size, flags);
-  fn (data);
-  GOMP_parallel_end ();
+  gomp_parallel_loop_nonmonotonic_runtime (fn, data, num_threads, start, end,
+					   incr, flags);
 }
 
 void
@@ -936,12 +1031,8 @@ GOMP_parallel_loop_maybe_nonmonotonic_runtime (void (*fn) (void *), void *data,
 					       long end, long incr,
 					       unsigned flags)
 {
-  struct gomp_task_icv *icv = gomp_icv (false);
-  gomp_parallel_loop_start (fn, data, num_threads, start, end, incr,
-			    icv->run_sched_var & ~GFS_MONOTONIC,
-			    icv->run_sched_chunk_size, flags);
-  fn (data);
-  GOMP_parallel_end ();
+  gomp_parallel_loop_nonmonotonic_runtime (fn, data, num_threads, start, end,
+					   incr, flags);
 }
 #endif
 
@@ -984,10 +1075,10 @@ extern __typeof(gomp_loop_dynamic_start) GOMP_loop_nonmonotonic_dynamic_start
 	__attribute__((alias ("gomp_loop_dynamic_start")));
 extern __typeof(gomp_loop_guided_start) GOMP_loop_nonmonotonic_guided_start
 	__attribute__((alias ("gomp_loop_guided_start")));
-extern __typeof(GOMP_loop_runtime_start) GOMP_loop_nonmonotonic_runtime_start
-	__attribute__((alias ("GOMP_loop_runtime_start")));
-extern __typeof(GOMP_loop_runtime_start) GOMP_loop_maybe_nonmonotonic_runtime_start
-	__attribute__((alias ("GOMP_loop_runtime_start")));
+extern __typeof(gomp_loop_nonmonotonic_runtime_start) GOMP_loop_nonmonotonic_runtime_start
+	__attribute__((alias ("gomp_loop_nonmonotonic_runtime_start")));
+extern __typeof(gomp_loop_nonmonotonic_runtime_start) GOMP_loop_maybe_nonmonotonic_runtime_start
+	__attribute__((alias ("gomp_loop_nonmonotonic_runtime_start")));
 
 extern __typeof(gomp_loop_ordered_static_start) GOMP_loop_ordered_static_start
 	__attribute__((alias ("gomp_loop_ordered_static_start")));
@@ -1065,14 +1156,16 @@ bool
 GOMP_loop_nonmonotonic_runtime_start (long start, long end, long incr,
 				      long *istart, long *iend)
 {
-  return GOMP_loop_runtime_start (start, end, incr, istart, iend);
+  return gomp_loop_nonmonotonic_runtime_start (start, end, incr, istart,
+					       iend);
 }
 
 bool
 GOMP_loop_maybe_nonmonotonic_runtime_start (long start, long end, long incr,
 					    long *istart, long *iend)
 {
-  return GOMP_loop_runtime_start (start, end, incr, istart, iend);
+  return gomp_loop_nonmonotonic_runtime_start (start, end, incr, istart,
+					       iend);
 }
 
 bool
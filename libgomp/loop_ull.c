@@ -30,6 +30,7 @@
 #include <string.h>
 #include "libgomp.h"
 
+ialias (GOMP_loop_ull_runtime_start)
 ialias (GOMP_loop_ull_runtime_next)
 ialias_redirect (GOMP_taskgroup_reduction_register)
 
@@ -84,6 +85,26 @@ gomp_loop_ull_init (struct gomp_work_share *ws, bool up, gomp_ull start,
     ws->mode |= 2;
 }
 
+/* Set up the GFS_AUTO loop in WS for a team of NTHREADS threads.  */
+
+static void
+gomp_loop_ull_auto_init (struct gomp_work_share *ws, unsigned nthreads)
+{
+  gomp_ull d, incr;
+
+  if ((ws->mode & 2) == 0)
+    {
+      d = ws->end_ull - ws->next_ull;
+      incr = ws->incr_ull;
+    }
+  else
+    {
+      d = ws->next_ull - ws->end_ull;
+      incr = -ws->incr_ull;
+    }
+  gomp_iter_auto_init (ws, nthreads, d ? (d - 1) / incr + 1 : 0);
+}
+
 /* The *_start routines are called when first encountering a loop construct
    that is not bound directly to a parallel construct.  The first thread
    that arrives will create the work-share construct; subsequent threads
@@ -108,7 +129,7 @@ gomp_loop_ull_static_start (bool up, gomp_ull start, gomp_ull end,
   struct gomp_thread *thr = gomp_thread ();
 
   thr->ts.static_trip = 0;
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_ull_init (thr->ts.work_share, up, start, end, incr,
 			  GFS_STATIC, chunk_size);
@@ -126,7 +147,7 @@ gomp_loop_ull_dynamic_start (bool up, gomp_ull start, gomp_ull end,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_ull_init (thr->ts.work_share, up, start, end, incr,
 			  GFS_DYNAMIC, chunk_size);
@@ -152,7 +173,7 @@ gomp_loop_ull_guided_start (bool up, gomp_ull start, gomp_ull end,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_ull_init (thr->ts.work_share, up, start, end, incr,
 			  GFS_GUIDED, chunk_size);
@@ -170,6 +191,26 @@ gomp_loop_ull_guided_start (bool up, gomp_ull start, gomp_ull end,
   return ret;
 }
 
+/* See gomp_loop_auto_start.  */
+
+static bool
+gomp_loop_ull_auto_start (bool up, gomp_ull start, gomp_ull end,
+			  gomp_ull incr, gomp_ull *istart, gomp_ull *iend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+
+  if (gomp_work_share_start (0, ompt_work_loop))
+    {
+      gomp_loop_ull_init (thr->ts.work_share, up, start, end, incr,
+			  GFS_AUTO, 0);
+      gomp_loop_ull_auto_init (thr->ts.work_share,
+			       thr->ts.team ? thr->ts.team->nthreads : 1);
+      gomp_work_share_init_done ();
+    }
+
+  return gomp_iter_ull_auto_next (istart, iend);
+}
+
 bool
 GOMP_loop_ull_runtime_start (bool up, gomp_ull start, gomp_ull end,
 			     gomp_ull incr, gomp_ull *istart, gomp_ull *iend)
@@ -190,8 +231,8 @@ GOMP_loop_ull_runtime_start (bool up, gomp_ull start, gomp_ull end,
 					 icv->run_sched_chunk_size,
 					 istart, iend);
     case GFS_AUTO:
-      /* For now map to schedule(static), later on we could play with feedback
-	 driven choice.  */
+      /* This entry point is monotonic, so map to schedule(static).  The
+	 nonmonotonic ones use gomp_loop_auto_start instead.  */
       return gomp_loop_ull_static_start (up, start, end, incr,
 					 0, istart, iend);
     default:
@@ -199,9 +240,25 @@ GOMP_loop_ull_runtime_start (bool up, gomp_ull start, gomp_ull end,
     }
 }
 
+/* See gomp_loop_nonmonotonic_runtime_start.  */
+
+static bool
+gomp_loop_ull_nonmonotonic_runtime_start (bool up, gomp_ull start,
+					  gomp_ull end, gomp_ull incr,
+					  gomp_ull *istart, gomp_ull *iend)
+{
+  struct gomp_task_icv *icv = gomp_icv (false);
+  if (icv->run_sched_var == GFS_AUTO)
+    return gomp_loop_ull_auto_start (up, start, end, incr, istart, iend);
+  return ialias_call (GOMP_loop_ull_runtime_start) (up, start, end, incr,
+						    istart, iend);
+}
+
 static long
 gomp_adjust_sched (long sched, gomp_ull *chunk_size)
 {
+  bool monotonic = (sched & GFS_MONOTONIC) != 0;
+
   sched &= ~GFS_MONOTONIC;
   switch (sched)
     {
@@ -228,7 +285,8 @@ gomp_adjust_sched (long sched, gomp_ull *chunk_size)
 	    *chunk_size = icv->run_sched_chunk_size;
 	    break;
 	  case GFS_AUTO:
-	    sched = GFS_STATIC;
+	    if (monotonic || (icv->run_sched_var & GFS_MONOTONIC))
+	      sched = GFS_STATIC;
 	    *chunk_size = 0;
 	    break;
 	  default:
@@ -252,11 +310,14 @@ GOMP_loop_ull_start (bool up, gomp_ull start, gomp_ull end,
   thr->ts.static_trip = 0;
   if (reductions)
     gomp_workshare_taskgroup_start ();
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       sched = gomp_adjust_sched (sched, &chunk_size);
       gomp_loop_ull_init (thr->ts.work_share, up, start, end, incr,
       			  sched, chunk_size);
+      if (sched == GFS_AUTO)
+	gomp_loop_ull_auto_init (thr->ts.work_share,
+				 thr->ts.team ? thr->ts.team->nthreads : 1);
       if (reductions)
 	{
 	  GOMP_taskgroup_reduction_register (reductions);
@@ -317,7 +378,7 @@ gomp_loop_ull_ordered_static_start (bool up, gomp_ull start, gomp_ull end,
   struct gomp_thread *thr = gomp_thread ();
 
   thr->ts.static_trip = 0;
-  if (gomp_work_share_start (1))
+  if (gomp_work_share_start (1, ompt_work_loop))
     {
       gomp_loop_ull_init (thr->ts.work_share, up, start, end, incr,
 			  GFS_STATIC, chunk_size);
@@ -336,7 +397,7 @@ gomp_loop_ull_ordered_dynamic_start (bool up, gomp_ull start, gomp_ull end,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (1))
+  if (gomp_work_share_start (1, ompt_work_loop))
     {
       gomp_loop_ull_init (thr->ts.work_share, up, start, end, incr,
 			  GFS_DYNAMIC, chunk_size);
@@ -362,7 +423,7 @@ gomp_loop_ull_ordered_guided_start (bool up, gomp_ull start, gomp_ull end,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (1))
+  if (gomp_work_share_start (1, ompt_work_loop))
     {
       gomp_loop_ull_init (thr->ts.work_share, up, start, end, incr,
 			  GFS_GUIDED, chunk_size);
@@ -425,9 +486,10 @@ GOMP_loop_ull_ordered_start (bool up, gomp_ull start, gomp_ull end,
     gomp_workshare_taskgroup_start ();
   if (mem)
     ordered += (uintptr_t) *mem;
-  if (gomp_work_share_start (ordered))
+  if (gomp_work_share_start (ordered, ompt_work_loop))
     {
-      sched = gomp_adjust_sched (sched, &chunk_size);
+      /* Ordered loops are always monotonic.  */
+      sched = gomp_adjust_sched (sched | GFS_MONOTONIC, &chunk_size);
       gomp_loop_ull_init (thr->ts.work_share, up, start, end, incr,
 			  sched, chunk_size);
       if (reductions)
@@ -500,7 +562,7 @@ gomp_loop_ull_doacross_static_start (unsigned ncounts, gomp_ull *counts,
   struct gomp_thread *thr = gomp_thread ();
 
   thr->ts.static_trip = 0;
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_ull_init (thr->ts.work_share, true, 0, counts[0], 1,
 			  GFS_STATIC, chunk_size);
@@ -519,7 +581,7 @@ gomp_loop_ull_doacross_dynamic_start (unsigned ncounts, gomp_ull *counts,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_ull_init (thr->ts.work_share, true, 0, counts[0], 1,
 			  GFS_DYNAMIC, chunk_size);
@@ -546,7 +608,7 @@ gomp_loop_ull_doacross_guided_start (unsigned ncounts, gomp_ull *counts,
   struct gomp_thread *thr = gomp_thread ();
   bool ret;
 
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       gomp_loop_ull_init (thr->ts.work_share, true, 0, counts[0], 1,
 			  GFS_GUIDED, chunk_size);
@@ -605,12 +667,12 @@ GOMP_loop_ull_doacross_start (unsigned ncounts, gomp_ull *counts,
   thr->ts.static_trip = 0;
   if (reductions)
     gomp_workshare_taskgroup_start ();
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_loop))
     {
       size_t extra = 0;
       if (mem)
 	extra = (uintptr_t) *mem;
-      sched = gomp_adjust_sched (sched, &chunk_size);
+      sched = gomp_adjust_sched (sched | GFS_MONOTONIC, &chunk_size);
       gomp_loop_ull_init (thr->ts.work_share, true, 0, counts[0], 1,
 			  sched, chunk_size);
       gomp_doacross_ull_init (ncounts, counts, chunk_size, extra);
@@ -697,8 +759,9 @@ GOMP_loop_ull_runtime_next (gomp_ull *istart, gomp_ull *iend)
   switch (thr->ts.work_share->sched)
     {
     case GFS_STATIC:
-    case GFS_AUTO:
       return gomp_loop_ull_static_next (istart, iend);
+    case GFS_AUTO:
+      return gomp_iter_ull_auto_next (istart, iend);
     case GFS_DYNAMIC:
       return gomp_loop_ull_dynamic_next (istart, iend);
     case GFS_GUIDED:
@@ -802,10 +865,10 @@ extern __typeof(gomp_loop_ull_dynamic_start) GOMP_loop_ull_nonmonotonic_dynamic_
 	__attribute__((alias ("gomp_loop_ull_dynamic_start")));
 extern __typeof(gomp_loop_ull_guided_start) GOMP_loop_ull_nonmonotonic_guided_start
 	__attribute__((alias ("gomp_loop_ull_guided_start")));
-extern __typeof(GOMP_loop_ull_runtime_start) GOMP_loop_ull_nonmonotonic_runtime_start
-	__attribute__((alias ("GOMP_loop_ull_runtime_start")));
-extern __typeof(GOMP_loop_ull_runtime_start) GOMP_loop_ull_maybe_nonmonotonic_runtime_start
-	__attribute__((alias ("GOMP_loop_ull_runtime_start")));
+extern __typeof(gomp_loop_ull_nonmonotonic_runtime_start) GOMP_loop_ull_nonmonotonic_runtime_start
+	__attribute__((alias ("gomp_loop_ull_nonmonotonic_runtime_start")));
+extern __typeof(gomp_loop_ull_nonmonotonic_runtime_start) GOMP_loop_ull_maybe_nonmonotonic_runtime_start
+	__attribute__((alias ("gomp_loop_ull_nonmonotonic_runtime_start")));
 
 extern __typeof(gomp_loop_ull_ordered_static_start) GOMP_loop_ull_ordered_static_start
 	__attribute__((alias ("gomp_loop_ull_ordered_static_start")));
@@ -894,7 +957,8 @@ GOMP_loop_ull_nonmonotonic_runtime_start (bool up, gomp_ull start,
 					  gomp_ull end, gomp_ull incr,
 					  gomp_ull *istart, gomp_ull *iend)
 {
-  return GOMP_loop_ull_runtime_start (up, start, end, incr, istart, iend);
+  return gomp_loop_ull_nonmonotonic_runtime_start (up, start, end, incr,
+						   istart, iend);
 }
 
 bool
@@ -903,7 +967,8 @@ GOMP_loop_ull_maybe_nonmonotonic_runtime_start (bool up, gomp_ull start,
 						gomp_ull *istart,
 						gomp_ull *iend)
 {
-  return GOMP_loop_ull_runtime_start (up, start, end, incr, istart, iend);
+  return gomp_loop_ull_nonmonotonic_runtime_start (up, start, end, incr,
+						   istart, iend);
 }
 
 bool
@@ -80,6 +80,13 @@ lookup_goacc_asyncqueue (struct goacc_thread *thr, bool create, int async)
   struct goacc_asyncqueue *ret_aq = NULL;
   struct gomp_device_descr *dev = thr->dev;
 
+  /* Asyncqueues live until the device is shut down, so the one found last
+     time can be used without taking the lock.  */
+  if (thr->async_cache_aq
+      && thr->async_cache_dev == dev
+      && thr->async_cache_async == async)
+    return thr->async_cache_aq;
+
   gomp_mutex_lock (&dev->openacc.async.lock);
 
   if (!create
@@ -116,6 +123,9 @@ lookup_goacc_asyncqueue (struct goacc_thread *thr, bool create, int async)
     }
 
   ret_aq = dev->openacc.async.asyncqueue[async];
+  thr->async_cache_aq = ret_aq;
+  thr->async_cache_dev = dev;
+  thr->async_cache_async = async;
 
  end:
   gomp_mutex_unlock (&dev->openacc.async.lock);
@@ -339,6 +339,9 @@ acc_shutdown_1 (acc_device_t d)
 
       walk->target_tls = NULL;
 
+      /* The asyncqueues are destroyed below.  */
+      walk->async_cache_aq = NULL;
+
       /* This would mean the user is shutting down OpenACC in the middle of an
          "acc data" pragma.  Likely not intentional.  */
       if (walk->mapped_data)
@@ -394,6 +397,8 @@ goacc_new_thread (void)
 {
   struct goacc_thread *thr = gomp_malloc (sizeof (struct goacc_thread));
 
+  thr->async_cache_aq = NULL;
+
 #if defined HAVE_TLS || defined USE_EMUTLS
   goacc_tls_data = thr;
 #else
@@ -80,6 +80,13 @@ struct goacc_thread
 
   /* Target-specific data (used by plugin).  */
   void *target_tls;
+
+  /* The asyncqueue last returned by lookup_goacc_asyncqueue for this
+     thread, for the async-argument ASYNC_CACHE_ASYNC on device
+     ASYNC_CACHE_DEV, or NULL.  */
+  struct goacc_asyncqueue *async_cache_aq;
+  struct gomp_device_descr *async_cache_dev;
+  int async_cache_async;
 };
 
 #if defined HAVE_TLS || defined USE_EMUTLS
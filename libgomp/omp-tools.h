@@ -0,0 +1,219 @@
+/* OpenMP Tools Interface
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of the GNU Offloading and Multi Processing Library
+   (libgomp).
+
+   Libgomp is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   Libgomp is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+   FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+   more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* This is the subset of the OpenMP 5.0 OMPT interface that libgomp
+   implements: tool initialization, ompt_set_callback/ompt_get_callback
+   and the parallel, task, work and synchronization region callbacks.
+   The enumerators keep the values the specification gives them, so
+   tools written against a complete omp-tools.h work unchanged.  */
+
+#ifndef _OMP_TOOLS_H
+#define _OMP_TOOLS_H 1
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef union ompt_data_t
+{
+  uint64_t value;
+  void *ptr;
+} ompt_data_t;
+
+#define ompt_data_none {0}
+
+typedef struct ompt_frame_t
+{
+  ompt_data_t exit_frame;
+  ompt_data_t enter_frame;
+  int exit_frame_flags;
+  int enter_frame_flags;
+} ompt_frame_t;
+
+typedef enum ompt_callbacks_t
+{
+  ompt_callback_thread_begin = 1,
+  ompt_callback_thread_end = 2,
+  ompt_callback_parallel_begin = 3,
+  ompt_callback_parallel_end = 4,
+  ompt_callback_task_create = 5,
+  ompt_callback_task_schedule = 6,
+  ompt_callback_implicit_task = 7,
+  ompt_callback_target = 8,
+  ompt_callback_target_data_op = 9,
+  ompt_callback_target_submit = 10,
+  ompt_callback_control_tool = 11,
+  ompt_callback_device_initialize = 12,
+  ompt_callback_device_finalize = 13,
+  ompt_callback_device_load = 14,
+  ompt_callback_device_unload = 15,
+  ompt_callback_sync_region_wait = 16,
+  ompt_callback_mutex_released = 17,
+  ompt_callback_dependences = 18,
+  ompt_callback_task_dependence = 19,
+  ompt_callback_work = 20,
+  ompt_callback_master = 21,
+  ompt_callback_target_map = 22,
+  ompt_callback_sync_region = 23,
+  ompt_callback_lock_init = 24,
+  ompt_callback_lock_destroy = 25,
+  ompt_callback_mutex_acquire = 26,
+  ompt_callback_mutex_acquired = 27,
+  ompt_callback_nest_lock = 28,
+  ompt_callback_flush = 29,
+  ompt_callback_cancel = 30,
+  ompt_callback_reduction = 31,
+  ompt_callback_dispatch = 32
+} ompt_callbacks_t;
+
+typedef enum ompt_set_result_t
+{
+  ompt_set_error = 0,
+  ompt_set_never = 1,
+  ompt_set_impossible = 2,
+  ompt_set_sometimes = 3,
+  ompt_set_sometimes_paired = 4,
+  ompt_set_always = 5
+} ompt_set_result_t;
+
+typedef enum ompt_scope_endpoint_t
+{
+  ompt_scope_begin = 1,
+  ompt_scope_end = 2
+} ompt_scope_endpoint_t;
+
+typedef enum ompt_sync_region_t
+{
+  ompt_sync_region_barrier = 1,
+  ompt_sync_region_barrier_implicit = 2,
+  ompt_sync_region_barrier_explicit = 3,
+  ompt_sync_region_barrier_implementation = 4,
+  ompt_sync_region_taskwait = 5,
+  ompt_sync_region_taskgroup = 6,
+  ompt_sync_region_reduction = 7
+} ompt_sync_region_t;
+
+typedef enum ompt_work_t
+{
+  ompt_work_loop = 1,
+  ompt_work_sections = 2,
+  ompt_work_single_executor = 3,
+  ompt_work_single_other = 4,
+  ompt_work_workshare = 5,
+  ompt_work_distribute = 6,
+  ompt_work_taskloop = 7
+} ompt_work_t;
+
+typedef enum ompt_task_flag_t
+{
+  ompt_task_initial = 0x00000001,
+  ompt_task_implicit = 0x00000002,
+  ompt_task_explicit = 0x00000004,
+  ompt_task_target = 0x00000008,
+  ompt_task_undeferred = 0x08000000,
+  ompt_task_untied = 0x10000000,
+  ompt_task_final = 0x20000000,
+  ompt_task_mergeable = 0x40000000,
+  ompt_task_merged = 0x80000000
+} ompt_task_flag_t;
+
+typedef enum ompt_task_status_t
+{
+  ompt_task_complete = 1,
+  ompt_task_yield = 2,
+  ompt_task_cancel = 3,
+  ompt_task_detach = 4,
+  ompt_task_early_fulfill = 5,
+  ompt_task_late_fulfill = 6,
+  ompt_task_switch = 7
+} ompt_task_status_t;
+
+typedef enum ompt_parallel_flag_t
+{
+  ompt_parallel_invoker_program = 0x00000001,
+  ompt_parallel_invoker_runtime = 0x00000002,
+  ompt_parallel_league = 0x40000000,
+  ompt_parallel_team = 0x80000000
+} ompt_parallel_flag_t;
+
+/* Tool initialization.  */
+
+typedef void (*ompt_interface_fn_t) (void);
+typedef ompt_interface_fn_t (*ompt_function_lookup_t) (const char *);
+typedef int (*ompt_initialize_t) (ompt_function_lookup_t, int, ompt_data_t *);
+typedef void (*ompt_finalize_t) (ompt_data_t *);
+
+typedef struct ompt_start_tool_result_t
+{
+  ompt_initialize_t initialize;
+  ompt_finalize_t finalize;
+  ompt_data_t tool_data;
+} ompt_start_tool_result_t;
+
+/* Entry points, found through the lookup function passed to the tool's
+   initializer.  */
+
+typedef void (*ompt_callback_t) (void);
+typedef ompt_set_result_t (*ompt_set_callback_t) (ompt_callbacks_t,
+						  ompt_callback_t);
+typedef int (*ompt_get_callback_t) (ompt_callbacks_t, ompt_callback_t *);
+
+/* Callback signatures.  */
+
+typedef void (*ompt_callback_parallel_begin_t) (ompt_data_t *,
+						const ompt_frame_t *,
+						ompt_data_t *, unsigned int,
+						int, const void *);
+typedef void (*ompt_callback_parallel_end_t) (ompt_data_t *, ompt_data_t *,
+					      int, const void *);
+typedef void (*ompt_callback_task_create_t) (ompt_data_t *,
+					     const ompt_frame_t *,
+					     ompt_data_t *, int, int,
+					     const void *);
+typedef void (*ompt_callback_task_schedule_t) (ompt_data_t *,
+					       ompt_task_status_t,
+					       ompt_data_t *);
+typedef void (*ompt_callback_sync_region_t) (ompt_sync_region_t,
+					     ompt_scope_endpoint_t,
+					     ompt_data_t *, ompt_data_t *,
+					     const void *);
+typedef void (*ompt_callback_work_t) (ompt_work_t, ompt_scope_endpoint_t,
+				      ompt_data_t *, ompt_data_t *,
+				      uint64_t, const void *);
+
+/* Defined by a tool that wants to be activated; the runtime's own
+   definition is weak and returns NULL.  */
+
+extern ompt_start_tool_result_t *ompt_start_tool (unsigned int,
+						  const char *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OMP_TOOLS_H */
@@ -0,0 +1,223 @@
+/* Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of the GNU Offloading and Multi Processing Library
+   (libgomp).
+
+   Libgomp is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   Libgomp is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+   FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+   more details.
+
+   Under Section 7 of GPL version 3, you are granted additional
+   permissions described in the GCC Runtime Library Exception, version
+   3.1, as published by the Free Software Foundation.
+
+   You should have received a copy of the GNU General Public License and
+   a copy of the GCC Runtime Library Exception along with this program;
+   see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+   <http://www.gnu.org/licenses/>.  */
+
+/* This file handles the OMPT tool interface: finding and activating a
+   tool, and registering its callbacks.  The callbacks themselves are
+   dispatched by the inline hooks in libgomp.h.  */
+
+#define _GNU_SOURCE
+#include "libgomp.h"
+#include "secure_getenv.h"
+#include <string.h>
+#include <strings.h>
+#ifdef PLUGIN_SUPPORT
+# include <dlfcn.h>
+#endif
+
+/* OpenMP version passed to ompt_start_tool, and the runtime version.  */
+#define GOMP_OMPT_OMP_VERSION 201811
+#define GOMP_OMPT_RUNTIME_VERSION "GNU libgomp"
+
+struct gomp_ompt_callbacks gomp_ompt_callbacks;
+const ompt_frame_t gomp_ompt_frame_none;
+
+/* Result of the ompt_start_tool of the active tool, if any.  */
+static ompt_start_tool_result_t *gomp_ompt_tool;
+
+/* Programs and preloaded libraries activate a tool by defining
+   ompt_start_tool themselves, which takes precedence over this weak
+   definition.  */
+
+ompt_start_tool_result_t * __attribute__((weak))
+ompt_start_tool (unsigned int omp_version, const char *runtime_version)
+{
+  (void) omp_version;
+  (void) runtime_version;
+  return NULL;
+}
+
+static ompt_set_result_t
+gomp_ompt_set_callback (ompt_callbacks_t event, ompt_callback_t callback)
+{
+  switch (event)
+    {
+    case ompt_callback_parallel_begin:
+      gomp_ompt_callbacks.parallel_begin
+	= (ompt_callback_parallel_begin_t) callback;
+      return ompt_set_always;
+    case ompt_callback_parallel_end:
+      gomp_ompt_callbacks.parallel_end
+	= (ompt_callback_parallel_end_t) callback;
+      return ompt_set_always;
+    case ompt_callback_task_create:
+      gomp_ompt_callbacks.task_create
+	= (ompt_callback_task_create_t) callback;
+      return ompt_set_always;
+    case ompt_callback_task_schedule:
+      gomp_ompt_callbacks.task_schedule
+	= (ompt_callback_task_schedule_t) callback;
+      return ompt_set_always;
+    case ompt_callback_sync_region_wait:
+      gomp_ompt_callbacks.sync_region_wait
+	= (ompt_callback_sync_region_t) callback;
+      return ompt_set_always;
+    case ompt_callback_work:
+      /* Only worksharing constructs that go through
+	 gomp_work_share_start are reported.  */
+      gomp_ompt_callbacks.work = (ompt_callback_work_t) callback;
+      return ompt_set_sometimes_paired;
+    default:
+      if (event < ompt_callback_thread_begin
+	  || event > ompt_callback_dispatch)
+	return ompt_set_error;
+      return ompt_set_never;
+    }
+}
+
+static int
+gomp_ompt_get_callback (ompt_callbacks_t event, ompt_callback_t *callback)
+{
+  switch (event)
+    {
+    case ompt_callback_parallel_begin:
+      *callback = (ompt_callback_t) gomp_ompt_callbacks.parallel_begin;
+      break;
+    case ompt_callback_parallel_end:
+      *callback = (ompt_callback_t) gomp_ompt_callbacks.parallel_end;
+      break;
+    case ompt_callback_task_create:
+      *callback = (ompt_callback_t) gomp_ompt_callbacks.task_create;
+      break;
+    case ompt_callback_task_schedule:
+      *callback = (ompt_callback_t) gomp_ompt_callbacks.task_schedule;
+      break;
+    case ompt_callback_sync_region_wait:
+      *callback = (ompt_callback_t) gomp_ompt_callbacks.sync_region_wait;
+      break;
+    case ompt_callback_work:
+      *callback = (ompt_callback_t) gomp_ompt_callbacks.work;
+      break;
+    default:
+      return 0;
+    }
+  return *callback != NULL;
+}
+
+static ompt_interface_fn_t
+gomp_ompt_lookup (const char *name)
+{
+  if (strcmp (name, "ompt_set_callback") == 0)
+    return (ompt_interface_fn_t) gomp_ompt_set_callback;
+  if (strcmp (name, "ompt_get_callback") == 0)
+    return (ompt_interface_fn_t) gomp_ompt_get_callback;
+  return NULL;
+}
+
+#ifdef PLUGIN_SUPPORT
+/* Try the tools in the colon separated OMP_TOOL_LIBRARIES in turn, until
+   one of them returns non-NULL from its ompt_start_tool.  */
+
+static ompt_start_tool_result_t *
+gomp_ompt_load_tool_libraries (const char *libs)
+{
+  while (*libs)
+    {
+      const char *sep = strchr (libs, ':');
+      size_t len = sep ? (size_t) (sep - libs) : strlen (libs);
+      if (len)
+	{
+	  char *name = gomp_malloc (len + 1);
+	  void *handle;
+
+	  memcpy (name, libs, len);
+	  name[len] = '\0';
+	  gomp_debug (0, "%s: dlopen (\"%s\")\n", __FUNCTION__, name);
+	  handle = dlopen (name, RTLD_LAZY);
+	  if (handle != NULL)
+	    {
+	      typeof (&ompt_start_tool) start_tool
+		= dlsym (handle, "ompt_start_tool");
+	      ompt_start_tool_result_t *result
+		= (start_tool
+		   ? start_tool (GOMP_OMPT_OMP_VERSION,
+				 GOMP_OMPT_RUNTIME_VERSION)
+		   : NULL);
+	      if (result)
+		{
+		  free (name);
+		  return result;
+		}
+	      dlclose (handle);
+	    }
+	  free (name);
+	}
+      if (sep == NULL)
+	break;
+      libs = sep + 1;
+    }
+  return NULL;
+}
+#endif
+
+/* Activate a tool, unless OMP_TOOL is disabled.  Called once, when the
+   environment variables are parsed.  */
+
+void
+gomp_ompt_initialize (void)
+{
+  const char *env = getenv ("OMP_TOOL");
+  ompt_start_tool_result_t *result;
+
+  if (env && strcasecmp (env, "disabled") == 0)
+    return;
+
+  result = ompt_start_tool (GOMP_OMPT_OMP_VERSION, GOMP_OMPT_RUNTIME_VERSION);
+#ifdef PLUGIN_SUPPORT
+  if (result == NULL)
+    {
+      env = secure_getenv ("OMP_TOOL_LIBRARIES");
+      if (env)
+	result = gomp_ompt_load_tool_libraries (env);
+    }
+#endif
+  if (result == NULL)
+    return;
+
+  if (result->initialize (gomp_ompt_lookup, 0, &result->tool_data))
+    gomp_ompt_tool = result;
+  else
+    memset (&gomp_ompt_callbacks, 0, sizeof (gomp_ompt_callbacks));
+}
+
+static void __attribute__((destructor))
+ompt_destructor (void)
+{
+  if (gomp_ompt_tool == NULL)
+    return;
+
+  memset (&gomp_ompt_callbacks, 0, sizeof (gomp_ompt_callbacks));
+  if (gomp_ompt_tool->finalize)
+    gomp_ompt_tool->finalize (&gomp_ompt_tool->tool_data);
+  gomp_ompt_tool = NULL;
+}
@@ -273,6 +273,38 @@ struct ptx_free_block
   struct ptx_free_block *next;
 };
 
+/* Device memory is allocated in power of two size classes, from
+   1 << PTX_POOL_MIN_SHIFT to 1 << PTX_POOL_MAX_SHIFT bytes, and freed
+   blocks are kept in per-class lists for reuse, as cuMemFree
+   synchronizes the device.  Larger blocks are allocated and freed
+   directly.  */
+
+#define PTX_POOL_MIN_SHIFT	8
+#define PTX_POOL_MAX_SHIFT	26
+#define PTX_POOL_CLASSES	(PTX_POOL_MAX_SHIFT - PTX_POOL_MIN_SHIFT + 1)
+
+/* Maximum number of bytes kept in the lists of a device.  */
+#define PTX_POOL_MAX_CACHED	((size_t) 256 << 20)
+
+struct ptx_pool_stats
+{
+  unsigned long allocs;
+  unsigned long hits;
+  unsigned long frees;
+  unsigned long releases;
+  size_t in_use;
+  size_t max_in_use;
+  size_t max_cached;
+};
+
+/* A stream for asynchronous OpenMP target regions.  */
+
+struct ptx_stream
+{
+  CUstream stream;
+  struct ptx_stream *next;
+};
+
 struct ptx_device
 {
   CUcontext ctx;
@@ -300,6 +332,16 @@ struct ptx_device
   struct ptx_free_block *free_blocks;
   pthread_mutex_t free_blocks_lock;
 
+  /* Free blocks of each size class, and their total size.  */
+  struct ptx_free_block *pool[PTX_POOL_CLASSES];
+  size_t pool_cached;
+  struct ptx_pool_stats pool_stats;
+  pthread_mutex_t pool_lock;
+
+  /* Streams not used by any running asynchronous OpenMP target region.  */
+  struct ptx_stream *omp_streams;
+  pthread_mutex_t omp_streams_lock;
+
   struct ptx_device *next;
 };
 
@@ -497,6 +539,14 @@ nvptx_open_device (int n)
   ptx_dev->free_blocks = NULL;
   pthread_mutex_init (&ptx_dev->free_blocks_lock, NULL);
 
+  memset (ptx_dev->pool, 0, sizeof (ptx_dev->pool));
+  ptx_dev->pool_cached = 0;
+  memset (&ptx_dev->pool_stats, 0, sizeof (ptx_dev->pool_stats));
+  pthread_mutex_init (&ptx_dev->pool_lock, NULL);
+
+  ptx_dev->omp_streams = NULL;
+  pthread_mutex_init (&ptx_dev->omp_streams_lock, NULL);
+
   return ptx_dev;
 }
 
@@ -514,7 +564,32 @@ nvptx_close_device (struct ptx_device *ptx_dev)
       b = b_next;
     }
 
+  struct ptx_pool_stats *stats = &ptx_dev->pool_stats;
+  GOMP_PLUGIN_debug (0, "nvptx device %d memory pool: %lu allocations,"
+		     " %lu from the pool, %lu frees, %lu released;"
+		     " at most %zu bytes in use and %zu bytes cached\n",
+		     ptx_dev->ord, stats->allocs, stats->hits, stats->frees,
+		     stats->releases, stats->max_in_use, stats->max_cached);
+  for (int i = 0; i < PTX_POOL_CLASSES; i++)
+    for (struct ptx_free_block *b = ptx_dev->pool[i]; b;)
+      {
+	struct ptx_free_block *b_next = b->next;
+	CUDA_CALL (cuMemFree, (CUdeviceptr) b->ptr);
+	free (b);
+	b = b_next;
+      }
+
+  for (struct ptx_stream *s = ptx_dev->omp_streams; s;)
+    {
+      struct ptx_stream *s_next = s->next;
+      CUDA_CALL (cuStreamDestroy, s->stream);
+      free (s);
+      s = s_next;
+    }
+
   pthread_mutex_destroy (&ptx_dev->free_blocks_lock);
+  pthread_mutex_destroy (&ptx_dev->pool_lock);
+  pthread_mutex_destroy (&ptx_dev->omp_streams_lock);
   pthread_mutex_destroy (&ptx_dev->image_lock);
 
   if (!ptx_dev->ctx_shared)
@@ -981,19 +1056,149 @@ goacc_profiling_acc_ev_alloc (struct goacc_thread *thr, void *dp, size_t s)
   GOMP_PLUGIN_goacc_profiling_dispatch (prof_info, &data_event_info, api_info);
 }
 
+/* Return the size class of an allocation of S bytes, or -1 if it is too
+   large to be pooled.  */
+
+static inline int
+nvptx_pool_class (size_t s)
+{
+  int shift = PTX_POOL_MIN_SHIFT;
+
+  if (s > (size_t) 1 << PTX_POOL_MAX_SHIFT)
+    return -1;
+  if (s > (size_t) 1 << PTX_POOL_MIN_SHIFT)
+    shift = sizeof (long) * __CHAR_BIT__ - __builtin_clzl (s - 1);
+  return shift - PTX_POOL_MIN_SHIFT;
+}
+
+/* Release all the free blocks of PTX_DEV, which has its pool_lock
+   held.  */
+
+static bool
+nvptx_pool_release (struct ptx_device *ptx_dev)
+{
+  for (int i = 0; i < PTX_POOL_CLASSES; i++)
+    {
+      while (ptx_dev->pool[i])
+	{
+	  struct ptx_free_block *b = ptx_dev->pool[i];
+	  ptx_dev->pool[i] = b->next;
+	  ptx_dev->pool_cached -= (size_t) 1 << (i + PTX_POOL_MIN_SHIFT);
+	  ptx_dev->pool_stats.releases++;
+	  CUresult r = CUDA_CALL_NOCHECK (cuMemFree, (CUdeviceptr) b->ptr);
+	  free (b);
+	  if (r != CUDA_SUCCESS)
+	    {
+	      GOMP_PLUGIN_error ("cuMemFree error: %s", cuda_error (r));
+	      return false;
+	    }
+	}
+    }
+  return true;
+}
+
+/* Allocate S bytes of device memory on PTX_DEV, reusing a free block of
+   the right size class if there is one.  */
+
 static void *
-nvptx_alloc (size_t s)
+nvptx_pool_alloc (struct ptx_device *ptx_dev, size_t s)
 {
+  struct ptx_pool_stats *stats = &ptx_dev->pool_stats;
+  int c = nvptx_pool_class (s);
   CUdeviceptr d;
+  CUresult r;
+
+  if (c >= 0)
+    s = (size_t) 1 << (c + PTX_POOL_MIN_SHIFT);
+
+  pthread_mutex_lock (&ptx_dev->pool_lock);
+  stats->allocs++;
+  if (c >= 0 && ptx_dev->pool[c])
+    {
+      struct ptx_free_block *b = ptx_dev->pool[c];
+      ptx_dev->pool[c] = b->next;
+      ptx_dev->pool_cached -= s;
+      stats->hits++;
+      d = (CUdeviceptr) b->ptr;
+      free (b);
+    }
+  else
+    {
+      r = CUDA_CALL_NOCHECK (cuMemAlloc, &d, s);
+      /* Give the cached blocks back to the device if it is out of
+	 memory.  */
+      if (r == CUDA_ERROR_OUT_OF_MEMORY && ptx_dev->pool_cached)
+	{
+	  if (!nvptx_pool_release (ptx_dev))
+	    {
+	      pthread_mutex_unlock (&ptx_dev->pool_lock);
+	      return NULL;
+	    }
+	  r = CUDA_CALL_NOCHECK (cuMemAlloc, &d, s);
+	}
+      if (r != CUDA_SUCCESS)
+	{
+	  pthread_mutex_unlock (&ptx_dev->pool_lock);
+	  GOMP_PLUGIN_error ("cuMemAlloc error: %s", cuda_error (r));
+	  return NULL;
+	}
+    }
+  stats->in_use += s;
+  if (stats->in_use > stats->max_in_use)
+    stats->max_in_use = stats->in_use;
+  pthread_mutex_unlock (&ptx_dev->pool_lock);
+  return (void *) d;
+}
+
+/* Free the block P of S bytes on PTX_DEV, keeping it for reuse unless
+   the pool is full.  */
+
+static bool
+nvptx_pool_free (struct ptx_device *ptx_dev, void *p, size_t s)
+{
+  struct ptx_pool_stats *stats = &ptx_dev->pool_stats;
+  int c = nvptx_pool_class (s);
+
+  /* Only blocks of exactly a class size come from the pool.  */
+  if (c >= 0 && s != (size_t) 1 << (c + PTX_POOL_MIN_SHIFT))
+    c = -1;
+
+  pthread_mutex_lock (&ptx_dev->pool_lock);
+  stats->frees++;
+  stats->in_use -= s;
+  if (c >= 0 && ptx_dev->pool_cached + s <= PTX_POOL_MAX_CACHED)
+    {
+      struct ptx_free_block *b
+	= GOMP_PLUGIN_malloc (sizeof (struct ptx_free_block));
+      b->ptr = p;
+      b->next = ptx_dev->pool[c];
+      ptx_dev->pool[c] = b;
+      ptx_dev->pool_cached += s;
+      if (ptx_dev->pool_cached > stats->max_cached)
+	stats->max_cached = ptx_dev->pool_cached;
+      pthread_mutex_unlock (&ptx_dev->pool_lock);
+      return true;
+    }
+  stats->releases++;
+  pthread_mutex_unlock (&ptx_dev->pool_lock);
+  CUDA_CALL (cuMemFree, (CUdeviceptr) p);
+  return true;
+}
+
+static void *
+nvptx_alloc (size_t s, struct ptx_device *ptx_dev)
+{
+  void *d = nvptx_pool_alloc (ptx_dev, s);
+  if (d == NULL)
+    return NULL;
 
-  CUDA_CALL_ERET (NULL, cuMemAlloc, &d, s);
   struct goacc_thread *thr = GOMP_PLUGIN_goacc_thread ();
   bool profiling_p
     = __builtin_expect (thr != NULL && thr->prof_info != NULL, false);
   if (profiling_p)
-    goacc_profiling_acc_ev_alloc (thr, (void *) d, s);
+    goacc_profiling_acc_ev_alloc (thr, d, s);
 
-  return (void *) d;
+  return d;
 }
 
 static void
@@ -1023,9 +1228,15 @@ goacc_profiling_acc_ev_free (struct goacc_thread *thr, void *p)
 static bool
 nvptx_free (void *p, struct ptx_device *ptx_dev)
 {
-  /* Assume callback context if this is null.  */
-  if (GOMP_PLUGIN_acc_thread () == NULL)
+  CUdeviceptr pb;
+  size_t ps;
+
+  CUresult r = CUDA_CALL_NOCHECK (cuMemGetAddressRange, &pb, &ps,
+				  (CUdeviceptr) p);
+  if (r == CUDA_ERROR_NOT_PERMITTED)
     {
+      /* No CUDA functions may be called from a stream callback, so free
+	 the block in the next nvptx_alloc instead.  */
       struct ptx_free_block *n
 	= GOMP_PLUGIN_malloc (sizeof (struct ptx_free_block));
       n->ptr = p;
@@ -1035,18 +1246,19 @@ nvptx_free (void *p, struct ptx_device *ptx_dev)
       pthread_mutex_unlock (&ptx_dev->free_blocks_lock);
       return true;
     }
-
-  CUdeviceptr pb;
-  size_t ps;
-
-  CUDA_CALL (cuMemGetAddressRange, &pb, &ps, (CUdeviceptr) p);
+  else if (r != CUDA_SUCCESS)
+    {
+      GOMP_PLUGIN_error ("cuMemGetAddressRange error: %s", cuda_error (r));
+      return false;
+    }
   if ((CUdeviceptr) p != pb)
     {
       GOMP_PLUGIN_error ("invalid device address");
       return false;
     }
 
-  CUDA_CALL (cuMemFree, (CUdeviceptr) p);
+  if (!nvptx_pool_free (ptx_dev, p, ps))
+    return false;
   struct goacc_thread *thr = GOMP_PLUGIN_goacc_thread ();
   bool profiling_p
     = __builtin_expect (thr != NULL && thr->prof_info != NULL, false);
@@ -1334,7 +1546,7 @@ GOMP_OFFLOAD_alloc (int ord, size_t size)
       blocks = tmp;
     }
 
-  return nvptx_alloc (size);
+  return nvptx_alloc (size, ptx_dev);
 }
 
 bool
@@ -1770,35 +1982,38 @@ nvptx_stacks_size ()
   return 128 * 1024;
 }
 
-/* Return contiguous storage for NUM stacks, each SIZE bytes.  */
+/* Return contiguous storage for NUM stacks, each SIZE bytes, on
+   PTX_DEV.  */
 
 static void *
-nvptx_stacks_alloc (size_t size, int num)
+nvptx_stacks_alloc (struct ptx_device *ptx_dev, size_t size, int num)
 {
-  CUdeviceptr stacks;
-  CUresult r = CUDA_CALL_NOCHECK (cuMemAlloc, &stacks, size * num);
-  if (r != CUDA_SUCCESS)
-    GOMP_PLUGIN_fatal ("cuMemAlloc error: %s", cuda_error (r));
-  return (void *) stacks;
+  void *stacks = nvptx_alloc (size * num, ptx_dev);
+  if (stacks == NULL)
+    GOMP_PLUGIN_fatal ("cannot allocate the stacks of a target region");
+  return stacks;
 }
 
 /* Release storage previously allocated by nvptx_stacks_alloc.  */
 
 static void
-nvptx_stacks_free (void *p, int num)
+nvptx_stacks_free (struct ptx_device *ptx_dev, void *p, int num)
 {
-  CUresult r = CUDA_CALL_NOCHECK (cuMemFree, (CUdeviceptr) p);
-  if (r != CUDA_SUCCESS)
-    GOMP_PLUGIN_fatal ("cuMemFree error: %s", cuda_error (r));
+  if (!nvptx_free (p, ptx_dev))
+    GOMP_PLUGIN_fatal ("cannot free the stacks of a target region");
 }
 
-void
-GOMP_OFFLOAD_run (int ord, void *tgt_fn, void *tgt_vars, void **args)
+/* Launch the OpenMP target region TGT_FN on device ORD in STREAM, and
+   return the stacks allocated for it in *STACKS_P and their number in
+   *NUM_STACKS_P.  */
+
+static void
+nvptx_launch (int ord, void *tgt_fn, void *tgt_vars, void **args,
+	      CUstream stream, void **stacks_p, int *num_stacks_p)
 {
   CUfunction function = ((struct targ_fn_descriptor *) tgt_fn)->fn;
   CUresult r;
   struct ptx_device *ptx_dev = ptx_devices[ord];
-  const char *maybe_abort_msg = "(perhaps abort was called)";
   int teams = 0, threads = 0;
 
   if (!args)
@@ -1822,7 +2037,7 @@ GOMP_OFFLOAD_run (int ord, void *tgt_fn, void *tgt_vars, void **args)
   nvptx_adjust_launch_bounds (tgt_fn, ptx_dev, &teams, &threads);
 
   size_t stack_size = nvptx_stacks_size ();
-  void *stacks = nvptx_stacks_alloc (stack_size, teams * threads);
+  void *stacks = nvptx_stacks_alloc (ptx_dev, stack_size, teams * threads);
   void *fn_args[] = {tgt_vars, stacks, (void *) stack_size};
   size_t fn_args_size = sizeof fn_args;
   void *config[] = {
@@ -1831,22 +2046,120 @@ GOMP_OFFLOAD_run (int ord, void *tgt_fn, void *tgt_vars, void **args)
     CU_LAUNCH_PARAM_END
   };
   r = CUDA_CALL_NOCHECK (cuLaunchKernel, function, teams, 1, 1,
-			 32, threads, 1, 0, NULL, NULL, config);
+			 32, threads, 1, 0, stream, NULL, config);
   if (r != CUDA_SUCCESS)
     GOMP_PLUGIN_fatal ("cuLaunchKernel error: %s", cuda_error (r));
 
+  *stacks_p = stacks;
+  *num_stacks_p = teams * threads;
+}
+
+void
+GOMP_OFFLOAD_run (int ord, void *tgt_fn, void *tgt_vars, void **args)
+{
+  CUresult r;
+  const char *maybe_abort_msg = "(perhaps abort was called)";
+  void *stacks;
+  int num_stacks;
+
+  nvptx_launch (ord, tgt_fn, tgt_vars, args, NULL, &stacks, &num_stacks);
+
   r = CUDA_CALL_NOCHECK (cuCtxSynchronize, );
   if (r == CUDA_ERROR_LAUNCH_FAILED)
     GOMP_PLUGIN_fatal ("cuCtxSynchronize error: %s %s\n", cuda_error (r),
 		       maybe_abort_msg);
   else if (r != CUDA_SUCCESS)
     GOMP_PLUGIN_fatal ("cuCtxSynchronize error: %s", cuda_error (r));
-  nvptx_stacks_free (stacks, teams * threads);
+  nvptx_stacks_free (ptx_devices[ord], stacks, num_stacks);
+}
+
+/* An OpenMP target region running asynchronously.  */
+
+struct nvptx_async_run
+{
+  struct ptx_device *ptx_dev;
+  struct ptx_stream *s;
+  void *stacks;
+  void *async_data;
+};
+
+/* Called by CUDA when the target region in the stream of DATA has
+   finished.  No CUDA functions may be called here, so the stacks are
+   freed by a later GOMP_OFFLOAD_alloc, and the stream is kept for the
+   next asynchronous target region.  */
+
+static void
+nvptx_async_run_completion (CUstream stream, CUresult res, void *data)
+{
+  struct nvptx_async_run *run = (struct nvptx_async_run *) data;
+  struct ptx_device *ptx_dev = run->ptx_dev;
+  struct ptx_free_block *b;
+
+  if (res == CUDA_ERROR_LAUNCH_FAILED)
+    GOMP_PLUGIN_fatal ("asynchronous target region error: %s %s\n",
+		       cuda_error (res), "(perhaps abort was called)");
+  else if (res != CUDA_SUCCESS)
+    GOMP_PLUGIN_fatal ("asynchronous target region error: %s",
+		       cuda_error (res));
+
+  b = GOMP_PLUGIN_malloc (sizeof (struct ptx_free_block));
+  b->ptr = run->stacks;
+  pthread_mutex_lock (&ptx_dev->free_blocks_lock);
+  b->next = ptx_dev->free_blocks;
+  ptx_dev->free_blocks = b;
+  pthread_mutex_unlock (&ptx_dev->free_blocks_lock);
+
+  pthread_mutex_lock (&ptx_dev->omp_streams_lock);
+  run->s->next = ptx_dev->omp_streams;
+  ptx_dev->omp_streams = run->s;
+  pthread_mutex_unlock (&ptx_dev->omp_streams_lock);
+
+  GOMP_PLUGIN_target_task_completion (run->async_data);
+  free (run);
 }
 
+/* Run the target region in a stream of its own, so that it overlaps with
+   the host, with other asynchronous target regions, and with the host to
+   device copies that map the variables of the next ones.  The streams
+   don't synchronize with the NULL stream, in which those copies are
+   made, so the launch waits for the copies already made in it with an
+   event.  */
+
 void
 GOMP_OFFLOAD_async_run (int ord, void *tgt_fn, void *tgt_vars, void **args,
 			void *async_data)
 {
-  GOMP_PLUGIN_fatal ("GOMP_OFFLOAD_async_run unimplemented");
+  struct ptx_device *ptx_dev = ptx_devices[ord];
+  struct nvptx_async_run *run;
+  struct ptx_stream *s;
+  CUevent e;
+  int num_stacks;
+
+  if (!nvptx_attach_host_thread_to_device (ord))
+    GOMP_PLUGIN_fatal ("cannot attach to device %d", ord);
+
+  pthread_mutex_lock (&ptx_dev->omp_streams_lock);
+  s = ptx_dev->omp_streams;
+  if (s)
+    ptx_dev->omp_streams = s->next;
+  pthread_mutex_unlock (&ptx_dev->omp_streams_lock);
+  if (s == NULL)
+    {
+      s = GOMP_PLUGIN_malloc (sizeof (struct ptx_stream));
+      CUDA_CALL_ASSERT (cuStreamCreate, &s->stream, CU_STREAM_NON_BLOCKING);
+    }
+
+  CUDA_CALL_ASSERT (cuEventCreate, &e, CU_EVENT_DISABLE_TIMING);
+  CUDA_CALL_ASSERT (cuEventRecord, e, NULL);
+  CUDA_CALL_ASSERT (cuStreamWaitEvent, s->stream, e, 0);
+  CUDA_CALL_ASSERT (cuEventDestroy, e);
+
+  run = GOMP_PLUGIN_malloc (sizeof (struct nvptx_async_run));
+  run->ptx_dev = ptx_dev;
+  run->s = s;
+  run->async_data = async_data;
+  nvptx_launch (ord, tgt_fn, tgt_vars, args, s->stream, &run->stacks,
+		&num_stacks);
+  CUDA_CALL_ASSERT (cuStreamAddCallback, s->stream,
+		    nvptx_async_run_completion, (void *) run, 0);
 }
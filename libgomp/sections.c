@@ -75,7 +75,7 @@ GOMP_sections_start (unsigned count)
   struct gomp_thread *thr = gomp_thread ();
   long s, e, ret;
 
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_sections))
     {
       gomp_sections_init (thr->ts.work_share, count);
       gomp_work_share_init_done ();
@@ -106,7 +106,7 @@ GOMP_sections2_start (unsigned count, uintptr_t *reductions, void **mem)
 
   if (reductions)
     gomp_workshare_taskgroup_start ();
-  if (gomp_work_share_start (0))
+  if (gomp_work_share_start (0, ompt_work_sections))
     {
       gomp_sections_init (thr->ts.work_share, count);
       if (reductions)
@@ -81,11 +81,16 @@ gomp_init_task (struct gomp_task *task, struct gomp_task *parent_task,
   task->final_task = false;
   task->copy_ctors_done = false;
   task->parent_depends_on = false;
+  task->stealable = false;
+  task->num_stealable_children = 0;
+  task->deque_mark = ~0UL;
+  task->refcount = 1;
   priority_queue_init (&task->children_queue);
   task->taskgroup = NULL;
   task->dependers = NULL;
   task->depend_hash = NULL;
   task->depend_count = 0;
+  task->ompt_data.value = 0;
 }
 
 /* Clean up a task, after completing it.  */
@@ -155,6 +160,471 @@ gomp_clear_parent (struct priority_queue *q)
     gomp_clear_parent_in_list (&q->l);
 }
 
+/* Return true if TASK, which is about to run, has been cancelled
+   together with its team or taskgroup.  */
+
+static inline bool
+gomp_task_cancelled_p (struct gomp_team *team, struct gomp_task *task)
+{
+  struct gomp_taskgroup *taskgroup = task->taskgroup;
+
+  if (__builtin_expect (gomp_cancel_var, 0)
+      && !task->copy_ctors_done)
+    {
+      if (gomp_team_barrier_cancelled (&team->barrier))
+	return true;
+      if (taskgroup)
+	{
+	  if (taskgroup->cancelled)
+	    return true;
+	  if (taskgroup->workshare
+	      && taskgroup->prev
+	      && taskgroup->prev->cancelled)
+	    return true;
+	}
+    }
+  return false;
+}
+
+/* Drop the reference TASK holds on itself, or one held by a stealable
+   child of TASK.  Once the last one is gone free TASK, and if it was
+   stealable drop the reference it held on its parent in turn.  */
+
+static void
+gomp_task_release (struct gomp_task *task)
+{
+  /* Nothing else can take a reference on a finished task, so if ours
+     is the only one there is no need for an atomic decrement.  */
+  while (__atomic_load_n (&task->refcount, MEMMODEL_ACQUIRE) == 1
+	 || __atomic_sub_fetch (&task->refcount, 1, MEMMODEL_ACQ_REL) == 0)
+    {
+      struct gomp_task *parent = task->stealable ? task->parent : NULL;
+
+      gomp_finish_task (task);
+      free (task);
+      /* Implicit tasks live as long as their team.  */
+      if (parent == NULL || parent->kind == GOMP_TASK_IMPLICIT)
+	return;
+      task = parent;
+    }
+}
+
+/* Task deques.
+
+   Deferred tasks without dependencies and without priority are pushed
+   into the task deque of the thread creating them rather than into the
+   priority queues, so that creating and running them doesn't need
+   team->task_lock.  The owner of a deque takes tasks from the bottom,
+   newest first, both in gomp_barrier_handle_tasks and, limited to
+   descendants of the task it is waiting in, in GOMP_taskwait and
+   GOMP_taskgroup_end.  Threads in gomp_barrier_handle_tasks that run out
+   of work steal the oldest task from the top of other threads' deques.
+
+   Such tasks are counted in team->task_count, in their taskgroup's
+   num_children and in their parent's num_stealable_children, and hold
+   a reference on their parent (see gomp_task_release) instead of being
+   in its children_queue.  BAR_TASK_PENDING stays set while any deque
+   may be non-empty, see gomp_task_clear_pending.  */
+
+/* Allocate the task deque of thread TEAM_ID in TEAM.  */
+
+static struct gomp_task_deque *
+gomp_task_deque_alloc (struct gomp_team *team, unsigned team_id)
+{
+  struct gomp_task_deque *dq
+    = gomp_aligned_alloc (64, sizeof (struct gomp_task_deque));
+
+  dq->top = 0;
+  dq->bottom = 0;
+  dq->pushed = 0;
+  dq->overflowed = 0;
+  dq->stolen = 0;
+  dq->steal_conflicts = 0;
+  __atomic_store_n (&team->task_deques[team_id], dq, MEMMODEL_RELEASE);
+  return dq;
+}
+
+/* Return true if DQ, owned by the current thread, has no room for
+   another task.  */
+
+static inline bool
+gomp_task_deque_full_p (struct gomp_task_deque *dq)
+{
+  /* The acquire pairs with the CAS in gomp_task_deque_steal, so that
+     a slot is only reused once the thief has read it.  */
+  return (dq->bottom - __atomic_load_n (&dq->top, MEMMODEL_ACQUIRE)
+	  >= GOMP_TASK_DEQUE_SIZE);
+}
+
+/* Return true if DQ may contain a task.  */
+
+static inline bool
+gomp_task_deque_nonempty_p (struct gomp_task_deque *dq)
+{
+  return (long) (__atomic_load_n (&dq->bottom, MEMMODEL_RELAXED)
+		 - __atomic_load_n (&dq->top, MEMMODEL_RELAXED)) > 0;
+}
+
+/* Return true if any task deque of TEAM may contain a task.  */
+
+static bool
+gomp_task_deques_nonempty_p (struct gomp_team *team)
+{
+  unsigned i;
+
+  for (i = 0; i < team->nthreads; i++)
+    {
+      struct gomp_task_deque *dq
+	= __atomic_load_n (&team->task_deques[i], MEMMODEL_ACQUIRE);
+      if (dq && gomp_task_deque_nonempty_p (dq))
+	return true;
+    }
+  return false;
+}
+
+/* Take the newest task from DQ, owned by the current thread, if it was
+   pushed at index MARK or later.  A MARK of 0 accepts any task.  */
+
+static struct gomp_task *
+gomp_task_deque_take (struct gomp_task_deque *dq, unsigned long mark)
+{
+  unsigned long b = dq->bottom, t;
+  struct gomp_task *task;
+
+  if (b == __atomic_load_n (&dq->top, MEMMODEL_RELAXED)
+      || (mark != 0 && (long) (b - mark) <= 0))
+    return NULL;
+  b--;
+  __atomic_store_n (&dq->bottom, b, MEMMODEL_RELAXED);
+  __atomic_thread_fence (MEMMODEL_SEQ_CST);
+  t = __atomic_load_n (&dq->top, MEMMODEL_RELAXED);
+  if ((long) (b - t) < 0)
+    {
+      /* Thieves emptied the deque in the meantime.  */
+      __atomic_store_n (&dq->bottom, b + 1, MEMMODEL_RELAXED);
+      return NULL;
+    }
+  task = __atomic_load_n (&dq->tasks[b & (GOMP_TASK_DEQUE_SIZE - 1)],
+			  MEMMODEL_RELAXED);
+  if (b == t)
+    {
+      /* This is the last task, race with thieves for it.  */
+      if (!__atomic_compare_exchange_n (&dq->top, &t, t + 1, false,
+					MEMMODEL_SEQ_CST, MEMMODEL_RELAXED))
+	task = NULL;
+      __atomic_store_n (&dq->bottom, b + 1, MEMMODEL_RELAXED);
+    }
+  return task;
+}
+
+/* Steal the oldest task from DQ, owned by another thread.  Set
+   *CONFLICT if there was one but another thread took it first.  */
+
+static struct gomp_task *
+gomp_task_deque_steal (struct gomp_task_deque *dq, bool *conflict)
+{
+  unsigned long t = __atomic_load_n (&dq->top, MEMMODEL_ACQUIRE), b;
+  struct gomp_task *task;
+
+  __atomic_thread_fence (MEMMODEL_SEQ_CST);
+  b = __atomic_load_n (&dq->bottom, MEMMODEL_ACQUIRE);
+  if ((long) (b - t) <= 0)
+    return NULL;
+  task = __atomic_load_n (&dq->tasks[t & (GOMP_TASK_DEQUE_SIZE - 1)],
+			  MEMMODEL_RELAXED);
+  if (!__atomic_compare_exchange_n (&dq->top, &t, t + 1, false,
+				    MEMMODEL_SEQ_CST, MEMMODEL_RELAXED))
+    {
+      *conflict = true;
+      return NULL;
+    }
+  return task;
+}
+
+/* Clear BAR_TASK_PENDING unless some task deque may still contain a
+   task.  Called with team->task_lock held once team->task_queue is
+   empty.  */
+
+static inline void
+gomp_task_clear_pending (struct gomp_team *team)
+{
+  gomp_team_barrier_clear_task_pending (&team->barrier);
+  /* Pairs with the barrier in gomp_task_deque_push: either the pushing
+     thread sees the flag cleared and sets it again, or we see its
+     task.  */
+  __atomic_thread_fence (MEMMODEL_SEQ_CST);
+  if (gomp_task_deques_nonempty_p (team))
+    gomp_team_barrier_set_task_pending (&team->barrier);
+}
+
+/* Push TASK, a new child of the current task PARENT, into DQ, the task
+   deque of the current thread, which has room for it.  Make sure
+   threads waiting in the team barrier will look for it.  */
+
+static void
+gomp_task_deque_push (struct gomp_team *team, struct gomp_task_deque *dq,
+		      struct gomp_task *task, struct gomp_task *parent)
+{
+  unsigned long b = dq->bottom;
+  bool do_wake = b == __atomic_load_n (&dq->top, MEMMODEL_RELAXED);
+
+  __atomic_store_n (&dq->tasks[b & (GOMP_TASK_DEQUE_SIZE - 1)], task,
+		    MEMMODEL_RELAXED);
+  __atomic_store_n (&dq->bottom, b + 1, MEMMODEL_RELEASE);
+  dq->pushed++;
+
+  __atomic_thread_fence (MEMMODEL_SEQ_CST);
+  if (!gomp_team_barrier_task_pending (&team->barrier))
+    {
+      gomp_mutex_lock (&team->task_lock);
+      gomp_team_barrier_set_task_pending (&team->barrier);
+      gomp_mutex_unlock (&team->task_lock);
+      do_wake = true;
+    }
+  if (do_wake
+      && (__atomic_load_n (&team->task_running_count, MEMMODEL_RELAXED)
+	  + !parent->in_tied_task < team->nthreads))
+    gomp_team_barrier_wake (&team->barrier, 1);
+}
+
+/* Note that a stealable task in TASKGROUP has finished.  */
+
+static inline void
+gomp_taskgroup_stealable_done (struct gomp_team *team,
+			       struct gomp_taskgroup *taskgroup)
+{
+  size_t n = __atomic_load_n (&taskgroup->num_children, MEMMODEL_RELAXED);
+
+  while (n > 1)
+    if (__atomic_compare_exchange_n (&taskgroup->num_children, &n, n - 1,
+				     true, MEMMODEL_RELEASE,
+				     MEMMODEL_RELAXED))
+      return;
+
+  /* This may be the last child.  GOMP_taskgroup_end may free TASKGROUP
+     as soon as it sees num_children drop to 0, so check whether it is
+     waiting first, and do so under the lock it sets the flag under.  */
+  gomp_mutex_lock (&team->task_lock);
+  bool in_wait = taskgroup->in_taskgroup_wait;
+  if (__atomic_sub_fetch (&taskgroup->num_children, 1, MEMMODEL_RELEASE) == 0
+      && in_wait)
+    {
+      taskgroup->in_taskgroup_wait = false;
+      gomp_sem_post (&taskgroup->taskgroup_sem);
+    }
+  gomp_mutex_unlock (&team->task_lock);
+}
+
+/* Run CHILD_TASK, which the current thread has taken from a task deque,
+   and account for its completion.  DQ is the task deque of the current
+   thread.  IN_BARRIER is true when called from gomp_barrier_handle_tasks.
+   Return true if this was the last task of the team.  */
+
+static bool
+gomp_task_run_stealable (struct gomp_thread *thr, struct gomp_team *team,
+			 struct gomp_task_deque *dq,
+			 struct gomp_task *child_task, bool in_barrier)
+{
+  struct gomp_task *task = thr->task;
+  struct gomp_task *parent = child_task->parent;
+  struct gomp_taskgroup *taskgroup = child_task->taskgroup;
+
+  child_task->kind = GOMP_TASK_TIED;
+  child_task->deque_mark = dq->bottom;
+  if (in_barrier)
+    {
+      child_task->in_tied_task = true;
+      __atomic_add_fetch (&team->task_running_count, 1, MEMMODEL_RELAXED);
+    }
+  if (!gomp_task_cancelled_p (team, child_task))
+    {
+      thr->task = child_task;
+      gomp_ompt_task_schedule (task, ompt_task_switch, child_task);
+      child_task->fn (child_task->fn_data);
+      gomp_ompt_task_schedule (child_task, ompt_task_complete, task);
+      thr->task = task;
+    }
+  if (in_barrier)
+    __atomic_sub_fetch (&team->task_running_count, 1, MEMMODEL_RELAXED);
+
+  /* Only this thread can have added children to the queue, see the
+     comment in GOMP_task.  */
+  if (!priority_queue_empty_p (&child_task->children_queue,
+			       MEMMODEL_RELAXED))
+    {
+      gomp_mutex_lock (&team->task_lock);
+      gomp_clear_parent (&child_task->children_queue);
+      gomp_mutex_unlock (&team->task_lock);
+    }
+  if (taskgroup)
+    gomp_taskgroup_stealable_done (team, taskgroup);
+  /* Either GOMP_taskwait sees the count drop to 0 after publishing its
+     taskwait, or we see the taskwait and wake it.  The parent is kept
+     alive by our reference.  */
+  if (__atomic_sub_fetch (&parent->num_stealable_children, 1,
+			  MEMMODEL_SEQ_CST) == 0
+      && __atomic_load_n (&parent->taskwait, MEMMODEL_SEQ_CST) != NULL)
+    {
+      gomp_mutex_lock (&team->task_lock);
+      if (parent->taskwait && parent->taskwait->in_taskwait)
+	{
+	  parent->taskwait->in_taskwait = false;
+	  gomp_sem_post (&parent->taskwait->taskwait_sem);
+	}
+      gomp_mutex_unlock (&team->task_lock);
+    }
+  gomp_task_release (child_task);
+  return __atomic_sub_fetch (&team->task_count, 1, MEMMODEL_ACQ_REL) == 0;
+}
+
+/* Called from GOMP_taskwait and GOMP_taskgroup_end: run the newest task
+   in the current thread's task deque if it is a descendant of TASK, the
+   task that is waiting.  Return true if a task was run.  */
+
+static bool
+gomp_task_run_descendant (struct gomp_thread *thr, struct gomp_team *team,
+			  struct gomp_task *task)
+{
+  struct gomp_task_deque *dq = team->task_deques[thr->ts.team_id];
+  struct gomp_task *child_task;
+  unsigned long mark;
+
+  if (dq == NULL)
+    return false;
+  /* Everything in the deque of a thread that isn't in a barrier
+     descends from its implicit task.  Undeferred tasks have no
+     stealable descendants.  */
+  if (task->kind == GOMP_TASK_IMPLICIT)
+    mark = 0;
+  else if (task->deque_mark != ~0UL)
+    mark = task->deque_mark;
+  else
+    return false;
+  child_task = gomp_task_deque_take (dq, mark);
+  if (child_task == NULL)
+    return false;
+  gomp_task_run_stealable (thr, team, dq, child_task, false);
+  return true;
+}
+
+/* Called from gomp_barrier_handle_tasks without team->task_lock held:
+   run tasks from the current thread's task deque, and once it is empty
+   steal from the other threads, until no deque has a task left.  Return
+   true if the last task of the team has finished and the barrier is
+   done.  */
+
+static bool
+gomp_barrier_run_stealable_tasks (struct gomp_thread *thr,
+				  struct gomp_team *team,
+				  gomp_barrier_state_t state)
+{
+  unsigned nthreads = team->nthreads;
+  unsigned team_id = thr->ts.team_id;
+  struct gomp_task_deque *dq = team->task_deques[team_id];
+  struct gomp_task *child_task;
+
+  while (1)
+    {
+      child_task = dq ? gomp_task_deque_take (dq, 0) : NULL;
+      if (child_task == NULL)
+	{
+	  bool conflict = false;
+	  unsigned i;
+
+	  if (!gomp_task_deques_nonempty_p (team))
+	    return false;
+	  if (dq == NULL)
+	    dq = gomp_task_deque_alloc (team, team_id);
+	  for (i = 1; i < nthreads; i++)
+	    {
+	      struct gomp_task_deque *victim
+		= __atomic_load_n (&team->task_deques[(team_id + i) % nthreads],
+				   MEMMODEL_ACQUIRE);
+	      if (victim == NULL)
+		continue;
+	      child_task = gomp_task_deque_steal (victim, &conflict);
+	      if (child_task)
+		{
+		  /* Let one more thread join in while there is work.  */
+		  if (gomp_task_deque_nonempty_p (victim)
+		      && (__atomic_load_n (&team->task_running_count,
+					   MEMMODEL_RELAXED) + 1 < nthreads))
+		    gomp_team_barrier_wake (&team->barrier, 1);
+		  break;
+		}
+	    }
+	  if (conflict)
+	    dq->steal_conflicts++;
+	  if (child_task == NULL)
+	    continue;
+	  dq->stolen++;
+	}
+      if (gomp_task_run_stealable (thr, team, dq, child_task, true))
+	{
+	  gomp_mutex_lock (&team->task_lock);
+	  if (__atomic_load_n (&team->task_count, MEMMODEL_RELAXED) == 0
+	      && gomp_team_barrier_waiting_for_tasks (&team->barrier))
+	    {
+	      gomp_team_barrier_done (&team->barrier, state);
+	      gomp_mutex_unlock (&team->task_lock);
+	      gomp_team_barrier_wake (&team->barrier, 0);
+	      return true;
+	    }
+	  gomp_mutex_unlock (&team->task_lock);
+	}
+    }
+}
+
+/* Report the task deque statistics of TEAM if GOMP_DEBUG is set, then
+   reset them.  Called by the master thread at the end of the team.  */
+
+void
+gomp_task_deques_report (struct gomp_team *team)
+{
+  unsigned i;
+
+  if (__builtin_expect (!gomp_debug_var, 1))
+    return;
+  for (i = 0; i < team->nthreads; i++)
+    {
+      struct gomp_task_deque *dq = team->task_deques[i];
+
+      if (dq == NULL)
+	continue;
+      gomp_debug (0, "libgomp: team %p thread %u: %lu tasks pushed, "
+		  "%lu overflowed, %lu stolen, %lu steal conflicts\n",
+		  (void *) team, i, dq->pushed, dq->overflowed, dq->stolen,
+		  dq->steal_conflicts);
+      dq->pushed = 0;
+      dq->overflowed = 0;
+      dq->stolen = 0;
+      dq->steal_conflicts = 0;
+    }
+}
+
+/* Free the task deques of TEAM.  */
+
+void
+gomp_task_deques_free (struct gomp_team *team)
+{
+  unsigned i;
+
+  for (i = 0; i < team->nthreads; i++)
+    if (team->task_deques[i])
+      gomp_aligned_free (team->task_deques[i]);
+}
+
+/* OMPT task flags for an explicit task created with GOMP_TASK_FLAG_*
+   FLAGS.  */
+
+static inline int
+gomp_ompt_task_flags (unsigned flags, bool final_task)
+{
+  return (ompt_task_explicit
+	  | ((flags & GOMP_TASK_FLAG_UNTIED) ? ompt_task_untied : 0)
+	  | (final_task ? ompt_task_final : 0));
+}
+
 /* Helper function for GOMP_task and gomp_create_target_task.
 
    For a TASK with in/out dependencies, fill in the various dependency
@@ -409,6 +879,11 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	  task.in_tied_task = thr->task->in_tied_task;
 	  task.taskgroup = thr->task->taskgroup;
 	}
+      gomp_ompt_task_create (thr->task, &task,
+			     gomp_ompt_task_flags (flags, task.final_task)
+			     | ompt_task_undeferred,
+			     (flags & GOMP_TASK_FLAG_DEPEND) != 0);
+      gomp_ompt_task_schedule (thr->task, ompt_task_switch, &task);
       thr->task = &task;
       if (__builtin_expect (cpyfn != NULL, 0))
 	{
@@ -420,6 +895,7 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	}
       else
 	fn (data);
+      gomp_ompt_task_schedule (&task, ompt_task_complete, task.parent);
       /* Access to "children" is normally done inside a task_lock
 	 mutex region, but the only way this particular task.children
 	 can be set is if this thread's task work function (fn)
@@ -442,6 +918,7 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
       struct gomp_task *task;
       struct gomp_task *parent = thr->task;
       struct gomp_taskgroup *taskgroup = parent->taskgroup;
+      struct gomp_task_deque *dq = NULL;
       char *arg;
       bool do_wake;
       size_t depend_size = 0;
@@ -449,6 +926,24 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
       if (flags & GOMP_TASK_FLAG_DEPEND)
 	depend_size = ((uintptr_t) (depend[0] ? depend[0] : depend[1])
 		       * sizeof (struct gomp_task_depend_entry));
+      /* Tasks without dependencies or priority go into the task deque
+	 of this thread unless it is full.  Their parent must be a task
+	 that will stay alive as long as they need it.  */
+      if (depend_size == 0
+	  && priority == 0
+	  && team->nthreads > 1
+	  && (parent->kind == GOMP_TASK_IMPLICIT
+	      || parent->kind == GOMP_TASK_TIED))
+	{
+	  dq = team->task_deques[thr->ts.team_id];
+	  if (dq == NULL)
+	    dq = gomp_task_deque_alloc (team, thr->ts.team_id);
+	  else if (gomp_task_deque_full_p (dq))
+	    {
+	      dq->overflowed++;
+	      dq = NULL;
+	    }
+	}
       task = gomp_malloc (sizeof (*task) + depend_size
 			  + arg_size + arg_align - 1);
       arg = (char *) (((uintptr_t) (task + 1) + depend_size + arg_align - 1)
@@ -471,6 +966,24 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
       task->fn = fn;
       task->fn_data = arg;
       task->final_task = (flags & GOMP_TASK_FLAG_FINAL) >> 1;
+      gomp_ompt_task_create (parent, task,
+			     gomp_ompt_task_flags (flags, task->final_task),
+			     depend_size != 0);
+      if (dq)
+	{
+	  /* Cancellation is checked again before the task runs.  */
+	  task->stealable = true;
+	  if (taskgroup)
+	    __atomic_add_fetch (&taskgroup->num_children, 1,
+				MEMMODEL_RELAXED);
+	  __atomic_add_fetch (&parent->num_stealable_children, 1,
+			      MEMMODEL_RELAXED);
+	  if (parent->kind != GOMP_TASK_IMPLICIT)
+	    __atomic_add_fetch (&parent->refcount, 1, MEMMODEL_RELAXED);
+	  __atomic_add_fetch (&team->task_count, 1, MEMMODEL_RELAXED);
+	  gomp_task_deque_push (team, dq, task, parent);
+	  return;
+	}
       gomp_mutex_lock (&team->task_lock);
       /* If parallel or taskgroup has been cancelled, don't start new
 	 tasks.  */
@@ -496,7 +1009,7 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	    }
 	}
       if (taskgroup)
-	taskgroup->num_children++;
+	__atomic_add_fetch (&taskgroup->num_children, 1, MEMMODEL_RELAXED);
       if (depend_size)
 	{
 	  gomp_task_handle_depend (task, parent, depend);
@@ -532,7 +1045,7 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 			     /*adjust_parent_depends_on=*/false,
 			     task->parent_depends_on);
 
-      ++team->task_count;
+      __atomic_add_fetch (&team->task_count, 1, MEMMODEL_RELAXED);
       ++team->task_queued_count;
       gomp_team_barrier_set_task_pending (&team->barrier);
       do_wake = team->task_running_count + !parent->in_tied_task
@@ -543,6 +1056,7 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
     }
 }
 
+ialias (GOMP_task)
 ialias (GOMP_taskgroup_start)
 ialias (GOMP_taskgroup_end)
 ialias (GOMP_taskgroup_reduction_register)
@@ -558,10 +1072,18 @@ ialias (GOMP_taskgroup_reduction_register)
 #define TYPE unsigned long long
 #define UTYPE TYPE
 #define GOMP_taskloop GOMP_taskloop_ull
+#define gomp_taskloop_range gomp_taskloop_range_ull
+#define gomp_taskloop_data_offset gomp_taskloop_data_offset_ull
+#define gomp_taskloop_bound gomp_taskloop_bound_ull
+#define gomp_taskloop_split gomp_taskloop_split_ull
 #include "taskloop.c"
 #undef TYPE
 #undef UTYPE
 #undef GOMP_taskloop
+#undef gomp_taskloop_range
+#undef gomp_taskloop_data_offset
+#undef gomp_taskloop_bound
+#undef gomp_taskloop_split
 
 static void inline
 priority_queue_move_task_first (enum priority_queue_type type,
@@ -806,7 +1328,8 @@ gomp_create_target_task (struct gomp_device_descr *devicep,
       if (task->num_dependees)
 	{
 	  if (taskgroup)
-	    taskgroup->num_children++;
+	    __atomic_add_fetch (&taskgroup->num_children, 1,
+				MEMMODEL_RELAXED);
 	  gomp_mutex_unlock (&team->task_lock);
 	  return true;
 	}
@@ -820,7 +1343,7 @@ gomp_create_target_task (struct gomp_device_descr *devicep,
       return false;
     }
   if (taskgroup)
-    taskgroup->num_children++;
+    __atomic_add_fetch (&taskgroup->num_children, 1, MEMMODEL_RELAXED);
   /* For async offloading, if we don't need to wait for dependencies,
      run the gomp_target_task_fn right away, essentially schedule the
      mapping part of the task in the current thread.  */
@@ -839,7 +1362,7 @@ gomp_create_target_task (struct gomp_device_descr *devicep,
       task->pnode[PQ_TEAM].next = NULL;
       task->pnode[PQ_TEAM].prev = NULL;
       task->kind = GOMP_TASK_TIED;
-      ++team->task_count;
+      __atomic_add_fetch (&team->task_count, 1, MEMMODEL_RELAXED);
       gomp_mutex_unlock (&team->task_lock);
 
       thr->task = task;
@@ -871,7 +1394,7 @@ gomp_create_target_task (struct gomp_device_descr *devicep,
 			 PRIORITY_INSERT_END,
 			 /*adjust_parent_depends_on=*/false,
 			 task->parent_depends_on);
-  ++team->task_count;
+  __atomic_add_fetch (&team->task_count, 1, MEMMODEL_RELAXED);
   ++team->task_queued_count;
   gomp_team_barrier_set_task_pending (&team->barrier);
   do_wake = team->task_running_count + !parent->in_tied_task
@@ -1088,25 +1611,13 @@ gomp_task_run_pre (struct gomp_task *child_task, struct gomp_task *parent,
   child_task->pnode[PQ_TEAM].next = NULL;
   child_task->pnode[PQ_TEAM].prev = NULL;
   child_task->kind = GOMP_TASK_TIED;
+  /* Stealable children of CHILD_TASK will be pushed above this.  */
+  struct gomp_task_deque *dq = team->task_deques[gomp_thread ()->ts.team_id];
+  child_task->deque_mark = dq ? dq->bottom : 0;
 
   if (--team->task_queued_count == 0)
-    gomp_team_barrier_clear_task_pending (&team->barrier);
-  if (__builtin_expect (gomp_cancel_var, 0)
-      && !child_task->copy_ctors_done)
-    {
-      if (gomp_team_barrier_cancelled (&team->barrier))
-	return true;
-      if (taskgroup)
-	{
-	  if (taskgroup->cancelled)
-	    return true;
-	  if (taskgroup->workshare
-	      && taskgroup->prev
-	      && taskgroup->prev->cancelled)
-	    return true;
-	}
-    }
-  return false;
+    gomp_task_clear_pending (team);
+  return gomp_task_cancelled_p (team, child_task);
 }
 
 static void
@@ -1208,7 +1719,7 @@ gomp_task_run_post_handle_dependers (struct gomp_task *child_task,
 			     PRIORITY_INSERT_END,
 			     /*adjust_parent_depends_on=*/false,
 			     task->parent_depends_on);
-      ++team->task_count;
+      __atomic_add_fetch (&team->task_count, 1, MEMMODEL_RELAXED);
       ++team->task_queued_count;
       ++ret;
     }
@@ -1281,17 +1792,12 @@ gomp_task_run_post_remove_taskgroup (struct gomp_task *child_task)
 				      child_task, MEMMODEL_RELAXED);
   child_task->pnode[PQ_TASKGROUP].next = NULL;
   child_task->pnode[PQ_TASKGROUP].prev = NULL;
-  if (taskgroup->num_children > 1)
-    --taskgroup->num_children;
-  else
-    {
-      /* We access taskgroup->num_children in GOMP_taskgroup_end
-	 outside of the task lock mutex region, so
-	 need a release barrier here to ensure memory
-	 written by child_task->fn above is flushed
-	 before the NULL is written.  */
-      __atomic_store_n (&taskgroup->num_children, 0, MEMMODEL_RELEASE);
-    }
+  /* We access taskgroup->num_children in GOMP_taskgroup_end
+     outside of the task lock mutex region, so
+     need a release barrier here to ensure memory
+     written by child_task->fn above is flushed
+     before the 0 is written.  */
+  __atomic_sub_fetch (&taskgroup->num_children, 1, MEMMODEL_RELEASE);
   if (empty && taskgroup->in_taskgroup_wait)
     {
       taskgroup->in_taskgroup_wait = false;
@@ -1338,13 +1844,12 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 	    {
 	      if (to_free)
 		{
-		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_release (to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
 	    }
-	  team->task_running_count++;
+	  __atomic_add_fetch (&team->task_running_count, 1, MEMMODEL_RELAXED);
 	  child_task->in_tied_task = true;
 	}
       gomp_mutex_unlock (&team->task_lock);
@@ -1355,8 +1860,7 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 	}
       if (to_free)
 	{
-	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_release (to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -1369,7 +1873,8 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 		  thr->task = task;
 		  gomp_mutex_lock (&team->task_lock);
 		  child_task->kind = GOMP_TASK_ASYNC_RUNNING;
-		  team->task_running_count--;
+		  __atomic_sub_fetch (&team->task_running_count, 1,
+				      MEMMODEL_RELAXED);
 		  struct gomp_target_task *ttask
 		    = (struct gomp_target_task *) child_task->fn_data;
 		  /* If GOMP_PLUGIN_target_task_completion has run already
@@ -1384,11 +1889,30 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    {
+	      gomp_ompt_task_schedule (task, ompt_task_switch, child_task);
+	      child_task->fn (child_task->fn_data);
+	      gomp_ompt_task_schedule (child_task, ompt_task_complete, task);
+	    }
 	  thr->task = task;
 	}
       else
-	return;
+	{
+	  /* team->task_queue is empty, run tasks from the task deques.  */
+	  if (gomp_barrier_run_stealable_tasks (thr, team, state))
+	    return;
+	  gomp_mutex_lock (&team->task_lock);
+	  if (priority_queue_empty_p (&team->task_queue, MEMMODEL_RELAXED))
+	    {
+	      gomp_task_clear_pending (team);
+	      if (!gomp_team_barrier_task_pending (&team->barrier))
+		{
+		  gomp_mutex_unlock (&team->task_lock);
+		  return;
+		}
+	    }
+	  continue;
+	}
       gomp_mutex_lock (&team->task_lock);
       if (child_task)
 	{
@@ -1401,14 +1925,15 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 	  to_free = child_task;
 	  child_task = NULL;
 	  if (!cancelled)
-	    team->task_running_count--;
+	    __atomic_sub_fetch (&team->task_running_count, 1,
+				MEMMODEL_RELAXED);
 	  if (new_tasks > 1)
 	    {
 	      do_wake = team->nthreads - team->task_running_count;
 	      if (do_wake > new_tasks)
 		do_wake = new_tasks;
 	    }
-	  if (--team->task_count == 0
+	  if (__atomic_sub_fetch (&team->task_count, 1, MEMMODEL_ACQ_REL) == 0
 	      && gomp_team_barrier_waiting_for_tasks (&team->barrier))
 	    {
 	      gomp_team_barrier_done (&team->barrier, state);
@@ -1440,35 +1965,50 @@ GOMP_taskwait (void)
      not necessary that we synchronize with other non-NULL writes at
      this point, but we must ensure that all writes to memory by a
      child thread task work function are seen before we exit from
-     GOMP_taskwait.  */
-  if (task == NULL
-      || priority_queue_empty_p (&task->children_queue, MEMMODEL_ACQUIRE))
+     GOMP_taskwait.  The same goes for num_stealable_children and
+     gomp_task_run_stealable.  */
+  if (task == NULL)
+    return;
+  /* Stealable children that are still in our task deque can be run
+     without taking the lock.  */
+  if (team != NULL)
+    while (gomp_task_run_descendant (thr, team, task))
+      ;
+  if (priority_queue_empty_p (&task->children_queue, MEMMODEL_ACQUIRE)
+      && __atomic_load_n (&task->num_stealable_children,
+			  MEMMODEL_ACQUIRE) == 0)
     return;
 
   memset (&taskwait, 0, sizeof (taskwait));
   bool child_q = false;
+  gomp_ompt_sync_region_wait (ompt_sync_region_taskwait, ompt_scope_begin);
   gomp_mutex_lock (&team->task_lock);
   while (1)
     {
       bool cancelled = false;
-      if (priority_queue_empty_p (&task->children_queue, MEMMODEL_RELAXED))
+      bool stealable_only = false;
+      struct gomp_task *next_task = NULL;
+      if (!priority_queue_empty_p (&task->children_queue, MEMMODEL_RELAXED))
+	next_task
+	  = priority_queue_next_task (PQ_CHILDREN, &task->children_queue,
+				      PQ_TEAM, &team->task_queue, &child_q);
+      else if (__atomic_load_n (&task->num_stealable_children,
+				MEMMODEL_ACQUIRE) != 0)
+	stealable_only = true;
+      else
 	{
 	  bool destroy_taskwait = task->taskwait != NULL;
 	  task->taskwait = NULL;
 	  gomp_mutex_unlock (&team->task_lock);
 	  if (to_free)
-	    {
-	      gomp_finish_task (to_free);
-	      free (to_free);
-	    }
+	    gomp_task_release (to_free);
 	  if (destroy_taskwait)
 	    gomp_sem_destroy (&taskwait.taskwait_sem);
+	  gomp_ompt_sync_region_wait (ompt_sync_region_taskwait,
+				      ompt_scope_end);
 	  return;
 	}
-      struct gomp_task *next_task
-	= priority_queue_next_task (PQ_CHILDREN, &task->children_queue,
-				    PQ_TEAM, &team->task_queue, &child_q);
-      if (next_task->kind == GOMP_TASK_WAITING)
+      if (next_task && next_task->kind == GOMP_TASK_WAITING)
 	{
 	  child_task = next_task;
 	  cancelled
@@ -1477,8 +2017,7 @@ GOMP_taskwait (void)
 	    {
 	      if (to_free)
 		{
-		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_release (to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
@@ -1488,7 +2027,8 @@ GOMP_taskwait (void)
 	{
 	/* All tasks we are waiting for are either running in other
 	   threads, or they are tasks that have not had their
-	   dependencies met (so they're not even in the queue).  Wait
+	   dependencies met (so they're not even in the queue), or
+	   stealable tasks that aren't in the queue either.  Wait
 	   for them.  */
 	  if (task->taskwait == NULL)
 	    {
@@ -1506,8 +2046,7 @@ GOMP_taskwait (void)
 	}
       if (to_free)
 	{
-	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_release (to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -1534,11 +2073,24 @@ GOMP_taskwait (void)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    {
+	      gomp_ompt_task_schedule (task, ompt_task_switch, child_task);
+	      child_task->fn (child_task->fn_data);
+	      gomp_ompt_task_schedule (child_task, ompt_task_complete, task);
+	    }
 	  thr->task = task;
 	}
-      else
-	gomp_sem_wait (&taskwait.taskwait_sem);
+      else if (!gomp_task_run_descendant (thr, team, task))
+	{
+	  /* Pairs with the barrier in gomp_task_run_stealable: either
+	     it sees TASK->taskwait, or we see its stealable child done.
+	     If children_queue isn't empty, its children wake us.  */
+	  __atomic_thread_fence (MEMMODEL_SEQ_CST);
+	  if (!stealable_only
+	      || __atomic_load_n (&task->num_stealable_children,
+				  MEMMODEL_ACQUIRE) != 0)
+	    gomp_sem_wait (&taskwait.taskwait_sem);
+	}
       gomp_mutex_lock (&team->task_lock);
       if (child_task)
 	{
@@ -1560,7 +2112,7 @@ GOMP_taskwait (void)
 
 	  to_free = child_task;
 	  child_task = NULL;
-	  team->task_count--;
+	  __atomic_sub_fetch (&team->task_count, 1, MEMMODEL_RELAXED);
 	  if (new_tasks > 1)
 	    {
 	      do_wake = team->nthreads - team->task_running_count
@@ -1701,10 +2253,7 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 	  task->taskwait = NULL;
 	  gomp_mutex_unlock (&team->task_lock);
 	  if (to_free)
-	    {
-	      gomp_finish_task (to_free);
-	      free (to_free);
-	    }
+	    gomp_task_release (to_free);
 	  gomp_sem_destroy (&taskwait.taskwait_sem);
 	  return;
 	}
@@ -1736,8 +2285,7 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 	    {
 	      if (to_free)
 		{
-		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_release (to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
@@ -1757,8 +2305,7 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 	}
       if (to_free)
 	{
-	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_release (to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -1785,7 +2332,11 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    {
+	      gomp_ompt_task_schedule (task, ompt_task_switch, child_task);
+	      child_task->fn (child_task->fn_data);
+	      gomp_ompt_task_schedule (child_task, ompt_task_complete, task);
+	    }
 	  thr->task = task;
 	}
       else
@@ -1808,7 +2359,7 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 	  gomp_task_run_post_remove_taskgroup (child_task);
 	  to_free = child_task;
 	  child_task = NULL;
-	  team->task_count--;
+	  __atomic_sub_fetch (&team->task_count, 1, MEMMODEL_RELAXED);
 	  if (new_tasks > 1)
 	    {
 	      do_wake = team->nthreads - team->task_running_count
@@ -1886,8 +2437,14 @@ GOMP_taskgroup_end (void)
       return;
     }
 
+  /* Stealable tasks of the taskgroup that are still in our task deque
+     can be run without taking the lock.  */
+  while (gomp_task_run_descendant (thr, team, task))
+    ;
+
   /* The acquire barrier on load of taskgroup->num_children here
-     synchronizes with the write of 0 in gomp_task_run_post_remove_taskgroup.
+     synchronizes with the write of 0 in gomp_task_run_post_remove_taskgroup
+     and gomp_taskgroup_stealable_done.
      It is not necessary that we synchronize with other non-0 writes at
      this point, but we must ensure that all writes to memory by a
      child thread task work function are seen before we exit from
@@ -1896,6 +2453,7 @@ GOMP_taskgroup_end (void)
     goto finish;
 
   bool unused;
+  gomp_ompt_sync_region_wait (ompt_sync_region_taskgroup, ompt_scope_begin);
   gomp_mutex_lock (&team->task_lock);
   while (1)
     {
@@ -1903,7 +2461,7 @@ GOMP_taskgroup_end (void)
       if (priority_queue_empty_p (&taskgroup->taskgroup_queue,
 				  MEMMODEL_RELAXED))
 	{
-	  if (taskgroup->num_children)
+	  if (__atomic_load_n (&taskgroup->num_children, MEMMODEL_RELAXED))
 	    {
 	      if (priority_queue_empty_p (&task->children_queue,
 					  MEMMODEL_RELAXED))
@@ -1917,10 +2475,9 @@ GOMP_taskgroup_end (void)
 	    {
 	      gomp_mutex_unlock (&team->task_lock);
 	      if (to_free)
-		{
-		  gomp_finish_task (to_free);
-		  free (to_free);
-		}
+		gomp_task_release (to_free);
+	      gomp_ompt_sync_region_wait (ompt_sync_region_taskgroup,
+					  ompt_scope_end);
 	      goto finish;
 	    }
 	}
@@ -1936,8 +2493,7 @@ GOMP_taskgroup_end (void)
 	    {
 	      if (to_free)
 		{
-		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_release (to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
@@ -1961,8 +2517,7 @@ GOMP_taskgroup_end (void)
 	}
       if (to_free)
 	{
-	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_release (to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -1989,10 +2544,14 @@ GOMP_taskgroup_end (void)
 		}
 	    }
 	  else
-	    child_task->fn (child_task->fn_data);
+	    {
+	      gomp_ompt_task_schedule (task, ompt_task_switch, child_task);
+	      child_task->fn (child_task->fn_data);
+	      gomp_ompt_task_schedule (child_task, ompt_task_complete, task);
+	    }
 	  thr->task = task;
 	}
-      else
+      else if (!gomp_task_run_descendant (thr, team, task))
 	gomp_sem_wait (&taskgroup->taskgroup_sem);
       gomp_mutex_lock (&team->task_lock);
       if (child_task)
@@ -2005,7 +2564,7 @@ GOMP_taskgroup_end (void)
 	  gomp_task_run_post_remove_taskgroup (child_task);
 	  to_free = child_task;
 	  child_task = NULL;
-	  team->task_count--;
+	  __atomic_sub_fetch (&team->task_count, 1, MEMMODEL_RELAXED);
 	  if (new_tasks > 1)
 	    {
 	      do_wake = team->nthreads - team->task_running_count
@@ -26,6 +26,76 @@
 /* This file handles the taskloop construct.  It is included twice, once
    for the long and once for unsigned long long variant.  */
 
+/* The tasks LO to HI - 1 of a taskloop whose tasks are created by
+   recursive splitting.  Task I runs the iterations from
+   gomp_taskloop_bound (R, I) to gomp_taskloop_bound (R, I + 1).  */
+
+struct gomp_taskloop_range
+{
+  void (*fn) (void *);
+  TYPE start, task_step, step;
+  unsigned long lo, hi, nfirst;
+  unsigned flags;
+  int priority;
+  long arg_size, arg_align;
+  /* Followed by the data of the tasks, at gomp_taskloop_data_offset.  */
+};
+
+static inline size_t
+gomp_taskloop_data_offset (long arg_align)
+{
+  return ((sizeof (struct gomp_taskloop_range) + arg_align - 1)
+	  & ~(size_t) (arg_align - 1));
+}
+
+static inline TYPE
+gomp_taskloop_bound (struct gomp_taskloop_range *r, unsigned long i)
+{
+  /* The first NFIRST + 1 tasks have TASK_STEP iterations, the others
+     one iteration less.  */
+  if (i == 0 || i - 1 <= r->nfirst)
+    return (TYPE) ((UTYPE) r->start + (UTYPE) i * (UTYPE) r->task_step);
+  return (TYPE) ((UTYPE) r->start
+		 + (UTYPE) (r->nfirst + 1) * (UTYPE) r->task_step
+		 + (UTYPE) (i - r->nfirst - 1) * (UTYPE) (r->task_step
+							   - r->step));
+}
+
+/* Body of a task of a taskloop created by recursive splitting: split off
+   the upper half of the tasks it stands for as a new task until only one
+   is left, then run its iterations.  The new tasks go to the task deque
+   of the current thread, where idle threads steal the oldest, and thus
+   largest, ranges.  */
+
+static void
+gomp_taskloop_split (void *data)
+{
+  struct gomp_taskloop_range *r = (struct gomp_taskloop_range *) data;
+  size_t offset = gomp_taskloop_data_offset (r->arg_align);
+  size_t size = offset + r->arg_size;
+  long align = r->arg_align > __alignof__ (struct gomp_taskloop_range)
+	       ? r->arg_align : __alignof__ (struct gomp_taskloop_range);
+  char *arg = (char *) r + offset;
+
+  while (r->hi - r->lo > 1)
+    {
+      unsigned long mid = r->lo + (r->hi - r->lo) / 2;
+      /* GOMP_task may run the new task right away, so give it a copy.  */
+      char buf[size + align - 1];
+      struct gomp_taskloop_range *half
+	= (struct gomp_taskloop_range *) (((uintptr_t) buf + align - 1)
+					  & ~(uintptr_t) (align - 1));
+      memcpy (half, r, size);
+      half->lo = mid;
+      r->hi = mid;
+      ialias_call (GOMP_task) (gomp_taskloop_split, half, NULL, size, align,
+			       true, r->flags, NULL, r->priority);
+    }
+  ((TYPE *) arg)[0] = gomp_taskloop_bound (r, r->lo);
+  ((TYPE *) arg)[1] = gomp_taskloop_bound (r, r->lo + 1);
+  r->fn (arg);
+}
+
 /* Called when encountering an explicit task directive.  If IF_CLAUSE is
    false, then we must not delay in executing the task.  If UNTIED is true,
    then the task may be executed by any member of the team.  */
@@ -208,6 +278,12 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	  arg = orig_arg;
 	  for (i = 0; i < num_tasks; i++)
 	    {
+	      gomp_ompt_task_create (task[i].parent, &task[i],
+				     gomp_ompt_task_flags (flags,
+							   task[i].final_task)
+				     | ompt_task_undeferred, 0);
+	      gomp_ompt_task_schedule (task[i].parent, ompt_task_switch,
+				       &task[i]);
 	      thr->task = &task[i];
 	      ((TYPE *)arg)[0] = start;
 	      start += task_step;
@@ -215,6 +291,8 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	      if (i == nfirst)
 		task_step -= step;
 	      fn (arg);
+	      gomp_ompt_task_schedule (&task[i], ompt_task_complete,
+				       task[i].parent);
 	      arg += arg_size;
 	      if (!priority_queue_empty_p (&task[i].children_queue,
 					   MEMMODEL_RELAXED))
@@ -241,6 +319,10 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 		task.in_tied_task = thr->task->in_tied_task;
 		task.taskgroup = thr->task->taskgroup;
 	      }
+	    gomp_ompt_task_create (thr->task, &task,
+				   gomp_ompt_task_flags (flags, task.final_task)
+				   | ompt_task_undeferred, 0);
+	    gomp_ompt_task_schedule (thr->task, ompt_task_switch, &task);
 	    thr->task = &task;
 	    ((TYPE *)data)[0] = start;
 	    start += task_step;
@@ -248,6 +330,7 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	    if (i == nfirst)
 	      task_step -= step;
 	    fn (data);
+	    gomp_ompt_task_schedule (&task, ompt_task_complete, task.parent);
 	    if (!priority_queue_empty_p (&task.children_queue,
 					 MEMMODEL_RELAXED))
 	      {
@@ -258,6 +341,43 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	    gomp_end_task ();
 	  }
     }
+  else if (cpyfn == NULL
+	   && (flags & (GOMP_TASK_FLAG_NOGROUP | GOMP_TASK_FLAG_FINAL)) == 0
+	   && num_tasks > 2
+	   && team->nthreads > 1)
+    {
+      /* Rather than creating all the tasks here, create one that splits
+	 itself recursively, so that task creation is spread over the
+	 team.  The tasks it creates are children of the tasks they split
+	 off from rather than of the current task, so this relies on the
+	 taskgroup to wait for them and to keep DATA alive.  The copy
+	 constructors must run in the current task, so CPYFN rules it
+	 out.  */
+      size_t offset = gomp_taskloop_data_offset (arg_align);
+      size_t size = offset + arg_size;
+      long align = arg_align > __alignof__ (struct gomp_taskloop_range)
+		   ? arg_align : __alignof__ (struct gomp_taskloop_range);
+      char buf[size + align - 1];
+      struct gomp_taskloop_range *r
+	= (struct gomp_taskloop_range *) (((uintptr_t) buf + align - 1)
+					  & ~(uintptr_t) (align - 1));
+
+      r->fn = fn;
+      r->start = start;
+      r->task_step = task_step;
+      r->step = step;
+      r->lo = 0;
+      r->hi = num_tasks;
+      r->nfirst = nfirst;
+      r->flags = (flags & GOMP_TASK_FLAG_UNTIED)
+		 | (priority ? GOMP_TASK_FLAG_PRIORITY : 0);
+      r->priority = priority;
+      r->arg_size = arg_size;
+      r->arg_align = arg_align;
+      memcpy ((char *) r + offset, data, arg_size);
+      ialias_call (GOMP_task) (gomp_taskloop_split, r, NULL, size, align,
+			       true, r->flags, NULL, priority);
+    }
   else
     {
       struct gomp_task *tasks[num_tasks];
@@ -297,6 +417,9 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	  task->fn = fn;
 	  task->fn_data = arg;
 	  task->final_task = (flags & GOMP_TASK_FLAG_FINAL) >> 1;
+	  gomp_ompt_task_create (parent, task,
+				 gomp_ompt_task_flags (flags, task->final_task),
+				 0);
 	}
       gomp_mutex_lock (&team->task_lock);
       /* If parallel or taskgroup has been cancelled, don't start new
@@ -328,7 +451,8 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	    }
 	}
       if (taskgroup)
-	taskgroup->num_children += num_tasks;
+	__atomic_add_fetch (&taskgroup->num_children, num_tasks,
+			    MEMMODEL_RELAXED);
       for (i = 0; i < num_tasks; i++)
 	{
 	  struct gomp_task *task = tasks[i];
@@ -346,7 +470,7 @@ GOMP_taskloop (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 				 PRIORITY_INSERT_END,
 				 /*last_parent_depends_on=*/false,
 				 task->parent_depends_on);
-	  ++team->task_count;
+	  __atomic_add_fetch (&team->task_count, 1, MEMMODEL_RELAXED);
 	  ++team->task_queued_count;
 	}
       gomp_team_barrier_set_task_pending (&team->barrier);
@@ -31,6 +31,67 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Free a team data structure.  */
+
+static void
+free_team (struct gomp_team *team)
+{
+#ifndef HAVE_SYNC_BUILTINS
+  gomp_mutex_destroy (&team->work_share_list_free_lock);
+#endif
+  gomp_barrier_destroy (&team->barrier);
+  gomp_mutex_destroy (&team->task_lock);
+  priority_queue_free (&team->task_queue);
+  gomp_task_deques_free (team);
+  free (team);
+}
+
+/* Keep the finished TEAM for reuse by a gomp_new_team call of THR for the
+   same number of threads, so that nested parallel regions and regions
+   alternating between a few team sizes don't allocate a team each time.  */
+
+static void
+gomp_team_cache_put (struct gomp_thread *thr, struct gomp_team *team)
+{
+  struct gomp_team *last = thr->team_cache[GOMP_TEAM_CACHE_SIZE - 1];
+  int i;
+
+  if (last)
+    free_team (last);
+  for (i = GOMP_TEAM_CACHE_SIZE - 1; i > 0; i--)
+    thr->team_cache[i] = thr->team_cache[i - 1];
+  thr->team_cache[0] = team;
+}
+
+static struct gomp_team *
+gomp_team_cache_get (struct gomp_thread *thr, unsigned nthreads)
+{
+  int i;
+
+  for (i = 0; i < GOMP_TEAM_CACHE_SIZE && thr->team_cache[i]; i++)
+    if (thr->team_cache[i]->nthreads == nthreads)
+      {
+	struct gomp_team *team = thr->team_cache[i];
+	for (; i < GOMP_TEAM_CACHE_SIZE - 1; i++)
+	  thr->team_cache[i] = thr->team_cache[i + 1];
+	thr->team_cache[i] = NULL;
+	return team;
+      }
+  return NULL;
+}
+
+static void
+gomp_free_team_cache (struct gomp_thread *thr)
+{
+  int i;
+
+  for (i = 0; i < GOMP_TEAM_CACHE_SIZE && thr->team_cache[i]; i++)
+    {
+      free_team (thr->team_cache[i]);
+      thr->team_cache[i] = NULL;
+    }
+}
+
 #ifdef LIBGOMP_USE_PTHREADS
 pthread_attr_t gomp_thread_attr;
 
@@ -60,6 +121,85 @@ struct gomp_thread_start_data
   pthread_t handle;
 };
 
+/* Threads that finished a nested team, or that a non-nested team no
+   longer needed, wait in gomp_thread_park until gomp_team_start hands
+   them another team instead of exiting.  They are chained through
+   parked_next and protected by gomp_parked_lock.  */
+
+static struct gomp_thread *gomp_parked_threads;
+static unsigned long gomp_parked_count;
+static gomp_mutex_t gomp_parked_lock;
+
+/* Wait until gomp_team_start wants THR for another team and return the
+   start data for it, or return NULL if the thread should exit.  */
+
+static struct gomp_thread_start_data *
+gomp_thread_park (struct gomp_thread *thr)
+{
+  unsigned long max = 2 * gomp_available_cpus;
+
+  if (max < 16)
+    max = 16;
+  gomp_mutex_lock (&gomp_parked_lock);
+  if (gomp_parked_count >= max)
+    {
+      gomp_mutex_unlock (&gomp_parked_lock);
+      return NULL;
+    }
+  thr->data = NULL;
+  thr->parked_next = gomp_parked_threads;
+  gomp_parked_threads = thr;
+  gomp_parked_count++;
+  gomp_mutex_unlock (&gomp_parked_lock);
+
+  gomp_sem_wait (&thr->parked_release);
+  return thr->data;
+}
+
+/* Take a parked thread bound to PLACE off the list, if there is one.  The
+   caller must then store its start data in the thread's data member and
+   post its parked_release semaphore.  */
+
+static struct gomp_thread *
+gomp_thread_unpark (unsigned int place)
+{
+  struct gomp_thread *nthr, **p;
+
+  if (__atomic_load_n (&gomp_parked_threads, MEMMODEL_RELAXED) == NULL)
+    return NULL;
+
+  gomp_mutex_lock (&gomp_parked_lock);
+  for (p = &gomp_parked_threads; (nthr = *p) != NULL; p = &nthr->parked_next)
+    if (nthr->place == place)
+      {
+	*p = nthr->parked_next;
+	gomp_parked_count--;
+	break;
+      }
+  gomp_mutex_unlock (&gomp_parked_lock);
+  return nthr;
+}
+
+/* Make all parked threads exit.  */
+
+static void
+gomp_release_parked_threads (void)
+{
+  struct gomp_thread *nthr, *next;
+
+  gomp_mutex_lock (&gomp_parked_lock);
+  nthr = gomp_parked_threads;
+  gomp_parked_threads = NULL;
+  gomp_parked_count = 0;
+  gomp_mutex_unlock (&gomp_parked_lock);
+
+  for (; nthr != NULL; nthr = next)
+    {
+      next = nthr->parked_next;
+      gomp_sem_post (&nthr->parked_release);
+    }
+}
+
 
 /* This function is a pthread_create entry point.  This contains the idle
    loop in which a thread waits to be called up to become part of a team.  */
@@ -81,59 +221,78 @@ gomp_thread_start (void *xdata)
   pthread_setspecific (gomp_tls_key, thr);
 #endif
   gomp_sem_init (&thr->release, 0);
-
-  /* Extract what we need from data.  */
-  local_fn = data->fn;
-  local_data = data->fn_data;
-  thr->thread_pool = data->thread_pool;
-  thr->ts = data->ts;
-  thr->task = data->task;
-  thr->place = data->place;
+  gomp_sem_init (&thr->parked_release, 0);
 #ifdef GOMP_NEEDS_THREAD_HANDLE
   thr->handle = data->handle;
 #endif
 
-  thr->ts.team->ordered_release[thr->ts.team_id] = &thr->release;
-
-  /* Make thread pool local. */
-  pool = thr->thread_pool;
-
-  if (data->nested)
+  do
     {
-      struct gomp_team *team = thr->ts.team;
-      struct gomp_task *task = thr->task;
+      /* Extract what we need from data.  */
+      local_fn = data->fn;
+      local_data = data->fn_data;
+      thr->thread_pool = data->thread_pool;
+      thr->ts = data->ts;
+      thr->task = data->task;
+      thr->place = data->place;
 
-      gomp_barrier_wait (&team->barrier);
+      thr->ts.team->ordered_release[thr->ts.team_id] = &thr->release;
 
-      local_fn (local_data);
-      gomp_team_barrier_wait_final (&team->barrier);
-      gomp_finish_task (task);
-      gomp_barrier_wait_last (&team->barrier);
-    }
-  else
-    {
-      pool->threads[thr->ts.team_id] = thr;
+      /* Make thread pool local. */
+      pool = thr->thread_pool;
 
-      gomp_simple_barrier_wait (&pool->threads_dock);
-      do
+      if (data->nested)
 	{
 	  struct gomp_team *team = thr->ts.team;
 	  struct gomp_task *task = thr->task;
 
+	  gomp_barrier_wait (&team->barrier);
+
 	  local_fn (local_data);
+	  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_implicit,
+				      ompt_scope_begin);
 	  gomp_team_barrier_wait_final (&team->barrier);
+	  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_implicit,
+				      ompt_scope_end);
 	  gomp_finish_task (task);
+	  gomp_barrier_wait_last (&team->barrier);
+	}
+      else
+	{
+	  pool->threads[thr->ts.team_id] = thr;
 
 	  gomp_simple_barrier_wait (&pool->threads_dock);
-
-	  local_fn = thr->fn;
-	  local_data = thr->data;
-	  thr->fn = NULL;
+	  do
+	    {
+	      struct gomp_team *team = thr->ts.team;
+	      struct gomp_task *task = thr->task;
+
+	      local_fn (local_data);
+	      gomp_ompt_sync_region_wait (ompt_sync_region_barrier_implicit,
+					  ompt_scope_begin);
+	      gomp_team_barrier_wait_final (&team->barrier);
+	      gomp_ompt_sync_region_wait (ompt_sync_region_barrier_implicit,
+					  ompt_scope_end);
+	      gomp_finish_task (task);
+
+	      gomp_simple_barrier_wait (&pool->threads_dock);
+
+	      local_fn = thr->fn;
+	      local_data = thr->data;
+	      thr->fn = NULL;
+	    }
+	  while (local_fn);
 	}
-      while (local_fn);
+
+      data = gomp_thread_park (thr);
     }
+  while (data);
 
   gomp_sem_destroy (&thr->release);
+  gomp_sem_destroy (&thr->parked_release);
+  gomp_free_team_cache (thr);
+  gomp_free_alloc_cache (thr);
+  gomp_free_mcs_nodes (thr);
   pthread_detach (pthread_self ());
   thr->thread_pool = NULL;
   thr->task = NULL;
@@ -167,16 +326,23 @@ gomp_new_team (unsigned nthreads)
   int i;
 
   team = get_last_team (nthreads);
+  if (team == NULL)
+    team = gomp_team_cache_get (gomp_thread (), nthreads);
   if (team == NULL)
     {
       size_t extra = sizeof (team->ordered_release[0])
+		     + sizeof (team->task_deques[0])
 		     + sizeof (team->implicit_task[0]);
       team = gomp_malloc (sizeof (*team) + nthreads * extra);
+      team->task_deques
+	= (void *) ((gomp_sem_t **) &team->implicit_task[nthreads] + nthreads);
+      for (i = 0; i < nthreads; i++)
+	team->task_deques[i] = NULL;
 
 #ifndef HAVE_SYNC_BUILTINS
       gomp_mutex_init (&team->work_share_list_free_lock);
 #endif
-      gomp_barrier_init (&team->barrier, nthreads);
+      gomp_team_barrier_init (&team->barrier, nthreads);
       gomp_mutex_init (&team->task_lock);
 
       team->nthreads = nthreads;
@@ -210,20 +376,6 @@ gomp_new_team (unsigned nthreads)
 }
 
 
-/* Free a team data structure.  */
-
-static void
-free_team (struct gomp_team *team)
-{
-#ifndef HAVE_SYNC_BUILTINS
-  gomp_mutex_destroy (&team->work_share_list_free_lock);
-#endif
-  gomp_barrier_destroy (&team->barrier);
-  gomp_mutex_destroy (&team->task_lock);
-  priority_queue_free (&team->task_queue);
-  free (team);
-}
-
 static void
 gomp_free_pool_helper (void *thread_pool)
 {
@@ -232,6 +384,10 @@ gomp_free_pool_helper (void *thread_pool)
     = (struct gomp_thread_pool *) thread_pool;
   gomp_simple_barrier_wait_last (&pool->threads_dock);
   gomp_sem_destroy (&thr->release);
+  gomp_sem_destroy (&thr->parked_release);
+  gomp_free_team_cache (thr);
+  gomp_free_alloc_cache (thr);
+  gomp_free_mcs_nodes (thr);
   thr->thread_pool = NULL;
   thr->task = NULL;
 #ifdef LIBGOMP_USE_PTHREADS
@@ -295,6 +451,9 @@ gomp_free_thread (void *arg __attribute__((unused)))
       gomp_end_task ();
       free (task);
     }
+  gomp_free_team_cache (thr);
+  gomp_free_alloc_cache (thr);
+  gomp_free_mcs_nodes (thr);
 }
 
 /* Launch a team.  */
@@ -333,6 +492,14 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
 				      thr->place);
     }
 
+  team->ompt_parallel_data.value = 0;
+  if (__builtin_expect (gomp_ompt_callbacks.parallel_begin != NULL, 0))
+    gomp_ompt_callbacks.parallel_begin (gomp_ompt_task_data (task),
+					&gomp_ompt_frame_none,
+					&team->ompt_parallel_data, nthreads,
+					ompt_parallel_invoker_runtime
+					| ompt_parallel_team, NULL);
+
   /* Always save the previous state, even if this isn't a nested team.
      In particular, we should save any work share state from an outer
      orphaned work share construct.  */
@@ -349,6 +516,7 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
   thr->ts.single_count = 0;
 #endif
   thr->ts.static_trip = 0;
+  thr->ts.ompt_work = 0;
   thr->task = &team->implicit_task[0];
 #ifdef GOMP_NEEDS_THREAD_HANDLE
   thr->handle = pthread_self ();
@@ -446,7 +614,9 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
      regions.  This appears to be implied by the semantics of
      threadprivate variables, but perhaps that's reading too much into
      things.  Certainly it does prevent any locking problems, since
-     only the initial program thread will modify gomp_threads.  */
+     only the initial program thread will modify gomp_threads.  Nested
+     teams, and non-nested ones growing the pool, take parked threads
+     before creating new ones, see gomp_thread_park.  */
   if (!nested)
     {
       old_threads_used = pool->threads_used;
@@ -637,6 +807,8 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
 	  nthr->ts.single_count = 0;
 #endif
 	  nthr->ts.static_trip = 0;
+	  nthr->ts.ompt_work = 0;
+	  nthr->ts.def_allocator = thr->ts.def_allocator;
 	  nthr->task = &team->implicit_task[i];
 	  nthr->place = place;
 	  gomp_init_task (nthr->task, task, icv);
@@ -824,6 +996,8 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
       start_data->ts.single_count = 0;
 #endif
       start_data->ts.static_trip = 0;
+      start_data->ts.ompt_work = 0;
+      start_data->ts.def_allocator = thr->ts.def_allocator;
       start_data->task = &team->implicit_task[i];
       gomp_init_task (start_data->task, task, icv);
       team->implicit_task[i].icv.nthreads_var = nthreads_var;
@@ -832,6 +1006,16 @@ gomp_team_start (void (*fn) (void *), void *data, unsigned nthreads,
       start_data->thread_pool = pool;
       start_data->nested = nested;
 
+      /* Reuse a parked thread bound to the right place if there is one.  */
+      nthr = gomp_thread_unpark (start_data->place);
+      if (nthr != NULL)
+	{
+	  start_data->handle = gomp_thread_to_pthread_t (nthr);
+	  nthr->data = start_data++;
+	  gomp_sem_post (&nthr->parked_release);
+	  continue;
+	}
+
       attr = gomp_adjust_thread_attr (attr, &thread_attr);
       err = pthread_create (&start_data->handle, attr, gomp_thread_start,
 			    start_data);
@@ -931,7 +1115,11 @@ gomp_team_end (void)
      As #pragma omp cancel parallel might get awaited count in
      team->barrier in a inconsistent state, we need to use a different
      counter here.  */
+  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_implicit,
+			      ompt_scope_begin);
   gomp_team_barrier_wait_final (&team->barrier);
+  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_implicit,
+			      ompt_scope_end);
   if (__builtin_expect (team->team_cancelled, 0))
     {
       struct gomp_work_share *ws = team->work_shares_to_free;
@@ -948,8 +1136,14 @@ gomp_team_end (void)
   else
     gomp_fini_work_share (thr->ts.work_share);
 
+  gomp_task_deques_report (team);
   gomp_end_task ();
   thr->ts = team->prev_ts;
+  if (__builtin_expect (gomp_ompt_callbacks.parallel_end != NULL, 0))
+    gomp_ompt_callbacks.parallel_end (&team->ompt_parallel_data,
+				      gomp_ompt_task_data (thr->task),
+				      ompt_parallel_invoker_runtime
+				      | ompt_parallel_team, NULL);
 
   if (__builtin_expect (thr->ts.level != 0, 0))
     {
@@ -980,12 +1174,12 @@ gomp_team_end (void)
 
   if (__builtin_expect (thr->ts.team != NULL, 0)
       || __builtin_expect (team->nthreads == 1, 0))
-    free_team (team);
+    gomp_team_cache_put (thr, team);
   else
     {
       struct gomp_thread_pool *pool = thr->thread_pool;
       if (pool->last_team)
-	free_team (pool->last_team);
+	gomp_team_cache_put (thr, pool->last_team);
       pool->last_team = team;
       gomp_release_thread_pool (pool);
     }
@@ -1007,6 +1201,7 @@ initialize_team (void)
 
   if (pthread_key_create (&gomp_thread_destructor, gomp_free_thread) != 0)
     gomp_fatal ("could not create thread pool destructor.");
+  gomp_mutex_init (&gomp_parked_lock);
 }
 
 static void __attribute__((destructor))
@@ -1028,6 +1223,10 @@ gomp_pause_pool_helper (void *thread_pool)
     = (struct gomp_thread_pool *) thread_pool;
   gomp_simple_barrier_wait_last (&pool->threads_dock);
   gomp_sem_destroy (&thr->release);
+  gomp_sem_destroy (&thr->parked_release);
+  gomp_free_team_cache (thr);
+  gomp_free_alloc_cache (thr);
+  gomp_free_mcs_nodes (thr);
   thr->thread_pool = NULL;
   thr->task = NULL;
   pthread_exit (NULL);
@@ -1084,6 +1283,8 @@ gomp_pause_host (void)
 #endif
       thr->thread_pool = NULL;
     }
+  gomp_release_parked_threads ();
+  gomp_free_team_cache (thr);
   return 0;
 }
 #endif
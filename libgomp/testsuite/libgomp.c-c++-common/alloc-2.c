@@ -0,0 +1,78 @@
+/* Pinned and NUMA partitioned allocators.  These may be unable to pin
+   or place the memory, but must always hand out usable memory or, with
+   omp_atv_null_fb, NULL.  */
+
+#include <omp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void
+check (omp_allocator_handle_t a, size_t size, size_t align, int may_fail)
+{
+  char *p = (char *) omp_alloc (size, a);
+  if (p == NULL)
+    {
+      if (!may_fail)
+	abort ();
+      return;
+    }
+  if (((uintptr_t) p) % align != 0)
+    abort ();
+  memset (p, 0x5a, size);
+  if (p[0] != 0x5a || p[size - 1] != 0x5a)
+    abort ();
+  omp_free (p, a);
+}
+
+int
+main ()
+{
+  static const int partitions[]
+    = { omp_atv_environment, omp_atv_nearest, omp_atv_blocked,
+	omp_atv_interleaved };
+  omp_alloctrait_t traits[3];
+  omp_allocator_handle_t a;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      traits[0].key = omp_atk_partition;
+      traits[0].value = partitions[i];
+      traits[1].key = omp_atk_alignment;
+      traits[1].value = 64;
+      a = omp_init_allocator (omp_default_mem_space, 2, traits);
+      if (a == omp_null_allocator)
+	abort ();
+      check (a, 24, 64, 0);
+      check (a, 1 << 20, 64, 0);
+      #pragma omp parallel num_threads (3)
+      check (a, 1 << 16, 64, 0);
+      omp_destroy_allocator (a);
+    }
+
+  traits[0].key = omp_atk_pinned;
+  traits[0].value = omp_atv_true;
+  traits[1].key = omp_atk_fallback;
+  traits[1].value = omp_atv_null_fb;
+  a = omp_init_allocator (omp_default_mem_space, 2, traits);
+  if (a != omp_null_allocator)
+    {
+      check (a, 100, sizeof (void *), 1);
+      check (a, 1 << 16, sizeof (void *), 1);
+      omp_destroy_allocator (a);
+    }
+
+  /* With the default fallback, failing to pin falls back to default
+     memory.  */
+  traits[1].value = omp_atv_default_mem_fb;
+  traits[2].key = omp_atk_partition;
+  traits[2].value = omp_atv_interleaved;
+  a = omp_init_allocator (omp_high_bw_mem_space, 3, traits);
+  if (a != omp_null_allocator)
+    {
+      check (a, 1 << 24, sizeof (void *), 0);
+      omp_destroy_allocator (a);
+    }
+  return 0;
+}
@@ -0,0 +1,104 @@
+/* { dg-do run } */
+
+#include <omp.h>
+#include <stdlib.h>
+
+#define N 10007
+
+int a[N];
+
+/* Make the iterations in the middle of the space much more expensive, so
+   that threads run out of work at different times and steal.  */
+
+static void
+work (long i)
+{
+  volatile int j;
+  int n = (i > N / 3 && i < N / 2) ? 2000 : 10;
+  for (j = 0; j < n; j++)
+    ;
+}
+
+static void
+check (int cnt)
+{
+  int i;
+  for (i = 0; i < N; i++)
+    if (a[i] != cnt)
+      abort ();
+}
+
+int
+main ()
+{
+  long i, s = 0;
+  unsigned long long u;
+  int cnt = 0;
+
+  omp_set_schedule (omp_sched_auto, 0);
+
+  #pragma omp parallel for schedule(runtime)
+  for (i = 0; i < N; i++)
+    {
+      work (i);
+      a[i]++;
+    }
+  check (++cnt);
+
+  #pragma omp parallel for schedule(nonmonotonic: runtime)
+  for (i = N - 1; i >= 0; i--)
+    {
+      work (i);
+      a[i]++;
+    }
+  check (++cnt);
+
+  #pragma omp parallel
+  {
+    long j;
+    #pragma omp for schedule(runtime) nowait
+    for (j = 0; j < N; j += 3)
+      {
+	work (j);
+	a[j]++;
+      }
+    #pragma omp for schedule(nonmonotonic: runtime)
+    for (j = N - 1; j >= 0; j -= 3)
+      {
+	work (j);
+	a[N - 1 - j]++;
+      }
+    #pragma omp for schedule(runtime)
+    for (j = 0; j < N; j++)
+      if (j % 3)
+	a[j] += 2;
+    #pragma omp for schedule(runtime) reduction(task, +: s)
+    for (j = 0; j < N; j++)
+      {
+	work (j);
+	a[j]++;
+	s += j;
+      }
+    #pragma omp for schedule(monotonic: runtime)
+    for (j = 0; j < N; j++)
+      a[j]++;
+  }
+  cnt += 4;
+  check (cnt);
+  if (s != (long) N * (N - 1) / 2)
+    abort ();
+
+  #pragma omp parallel for schedule(runtime)
+  for (u = 3ULL * N + 0x100000000ULL; u > 0x100000000ULL; u -= 3)
+    {
+      work ((u - 0x100000000ULL) / 3 - 1);
+      a[(u - 0x100000000ULL) / 3 - 1]++;
+    }
+  check (++cnt);
+
+  /* A loop with no iterations.  */
+  #pragma omp parallel for schedule(runtime)
+  for (i = 0; i < -N; i++)
+    abort ();
+  return 0;
+}
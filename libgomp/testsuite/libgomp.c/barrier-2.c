@@ -0,0 +1,67 @@
+/* Barrier microbenchmark, also checking that no thread leaves a barrier
+   before all threads arrived, for team sizes with and without barrier
+   arrival groups.  Run with an argument to print the barrier latency.  */
+
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ITERS 2000
+
+static int slots[64];
+
+static double
+bench (int nthreads, int check)
+{
+  int err = 0;
+  double t = omp_get_wtime ();
+
+  #pragma omp parallel num_threads (nthreads) reduction (|:err)
+  {
+    int i, j, me = omp_get_thread_num (), n = omp_get_num_threads ();
+
+    for (i = 0; i < ITERS; i++)
+      {
+	__atomic_store_n (&slots[me], i, __ATOMIC_RELAXED);
+	if ((i & 1) == 0)
+	  {
+	    #pragma omp barrier
+	  }
+	else
+	  {
+	    /* Implicit barrier at the end of the worksharing construct.  */
+	    #pragma omp for schedule (static)
+	    for (j = 0; j < n; j++)
+	      ;
+	  }
+	if (check)
+	  for (j = 0; j < n; j++)
+	    if (__atomic_load_n (&slots[j], __ATOMIC_RELAXED) != i)
+	      err = 1;
+	#pragma omp barrier
+      }
+  }
+  if (err)
+    abort ();
+  return omp_get_wtime () - t;
+}
+
+int
+main (int argc, char **argv)
+{
+  static const int sizes[] = { 2, 4, 15, 16, 17, 33, 64 };
+  int i;
+
+  omp_set_dynamic (0);
+  for (i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++)
+    {
+      double t;
+
+      bench (sizes[i], 1);
+      t = bench (sizes[i], 0);
+      if (argc > 1)
+	printf ("%2d threads: %8.3f us per barrier\n", sizes[i],
+		t * 1e6 / (2 * ITERS));
+    }
+  return 0;
+}
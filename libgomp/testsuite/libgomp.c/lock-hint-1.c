@@ -0,0 +1,75 @@
+/* Locks initialized with each kind of hint, and named and unnamed
+   critical sections, protecting a shared histogram.  */
+
+#include <omp.h>
+#include <stdlib.h>
+
+#define N 4096
+#define BINS 16
+
+static const omp_sync_hint_t hints[] = {
+  omp_sync_hint_none,
+  omp_sync_hint_uncontended,
+  omp_sync_hint_contended,
+  omp_sync_hint_speculative,
+  omp_sync_hint_contended | omp_sync_hint_speculative,
+  omp_sync_hint_contended | omp_sync_hint_nonspeculative
+};
+
+int
+main (void)
+{
+  omp_lock_t locks[BINS];
+  omp_nest_lock_t nlock;
+  int hist[BINS], total, named, tests;
+  unsigned int h, i;
+
+  omp_init_nest_lock_with_hint (&nlock, omp_sync_hint_contended);
+  for (h = 0; h < sizeof (hints) / sizeof (hints[0]); h++)
+    {
+      for (i = 0; i < BINS; i++)
+	{
+	  omp_init_lock_with_hint (&locks[i], hints[h]);
+	  hist[i] = 0;
+	}
+      total = named = tests = 0;
+
+      #pragma omp parallel for num_threads (4) schedule (dynamic, 16)
+      for (i = 0; i < N; i++)
+	{
+	  unsigned int b = (i * 7) % BINS;
+	  omp_set_lock (&locks[b]);
+	  hist[b]++;
+	  omp_unset_lock (&locks[b]);
+	  if (omp_test_lock (&locks[0]))
+	    {
+	      tests++;
+	      omp_unset_lock (&locks[0]);
+	    }
+	  #pragma omp critical
+	  total++;
+	  #pragma omp critical (hist_named)
+	  {
+	    omp_set_nest_lock (&nlock);
+	    omp_set_nest_lock (&nlock);
+	    named++;
+	    omp_unset_nest_lock (&nlock);
+	    omp_unset_nest_lock (&nlock);
+	  }
+	}
+
+      for (i = 0; i < BINS; i++)
+	{
+	  if (hist[i] != N / BINS || omp_test_lock (&locks[i]) != 1)
+	    abort ();
+	  if (omp_test_lock (&locks[i]) != 0)
+	    abort ();
+	  omp_unset_lock (&locks[i]);
+	  omp_destroy_lock (&locks[i]);
+	}
+      if (total != N || named != N || tests == 0)
+	abort ();
+    }
+  omp_destroy_nest_lock (&nlock);
+  return 0;
+}
@@ -0,0 +1,50 @@
+/* Nested parallel regions and regions alternating between team sizes,
+   which reuse parked threads and cached teams.  */
+
+#include <omp.h>
+#include <stdlib.h>
+
+int
+main (void)
+{
+  static const int outer[] = { 2, 4, 3, 1, 4 };
+  static const int inner[] = { 3, 1, 5, 2 };
+  int i;
+
+  omp_set_nested (1);
+  omp_set_max_active_levels (2);
+  omp_set_dynamic (0);
+  for (i = 0; i < 200; i++)
+    {
+      int o = outer[i % 5], n = inner[i % 4], err = 0;
+      long sum = 0;
+
+      if (i == 100 && omp_pause_resource_all (omp_pause_soft) != 0)
+	abort ();
+
+      #pragma omp parallel num_threads (o) reduction (+:sum) reduction (|:err)
+      {
+	int tn1 = omp_get_thread_num ();
+	if (omp_get_num_threads () != o)
+	  err |= 1;
+	#pragma omp parallel num_threads (n) reduction (+:sum) reduction (|:err)
+	{
+	  int j;
+	  if (omp_get_num_threads () != n
+	      || omp_get_level () != 2
+	      || omp_get_ancestor_thread_num (1) != tn1
+	      || omp_get_team_size (1) != o)
+	    err |= 2;
+	  #pragma omp for schedule (dynamic)
+	  for (j = 0; j < 16; j++)
+	    sum += j;
+	  #pragma omp single
+	  #pragma omp task shared (sum)
+	  sum += 1000;
+	}
+      }
+      if (err || sum != o * (120L + 1000))
+	abort ();
+    }
+  return 0;
+}
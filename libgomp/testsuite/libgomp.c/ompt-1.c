@@ -0,0 +1,178 @@
+/* Check that a tool defined in the program is activated and sees paired
+   parallel, task, work and barrier wait events.  */
+
+#include <omp.h>
+#include <omp-tools.h>
+#include <stdlib.h>
+
+static int initialized;
+static int parallel_begin, parallel_end;
+static int task_create, task_switch, task_complete;
+static int work_begin, work_end;
+static int wait_begin, explicit_begin, explicit_end;
+
+#define INC(X) __atomic_add_fetch (&(X), 1, __ATOMIC_RELAXED)
+
+static void
+on_parallel_begin (ompt_data_t *encountering_task_data,
+		   const ompt_frame_t *encountering_task_frame,
+		   ompt_data_t *parallel_data, unsigned int requested,
+		   int flags, const void *codeptr_ra)
+{
+  if (parallel_data->value != 0 || (flags & ompt_parallel_team) == 0)
+    abort ();
+  parallel_data->value = 42;
+  INC (parallel_begin);
+}
+
+static void
+on_parallel_end (ompt_data_t *parallel_data,
+		 ompt_data_t *encountering_task_data, int flags,
+		 const void *codeptr_ra)
+{
+  if (parallel_data->value != 42)
+    abort ();
+  INC (parallel_end);
+}
+
+static void
+on_task_create (ompt_data_t *encountering_task_data,
+		const ompt_frame_t *encountering_task_frame,
+		ompt_data_t *new_task_data, int flags, int has_dependences,
+		const void *codeptr_ra)
+{
+  if ((flags & ompt_task_explicit) == 0)
+    abort ();
+  new_task_data->value = INC (task_create);
+}
+
+static void
+on_task_schedule (ompt_data_t *prior_task_data,
+		  ompt_task_status_t prior_task_status,
+		  ompt_data_t *next_task_data)
+{
+  if (prior_task_status == ompt_task_complete)
+    {
+      if (prior_task_data->value == 0)
+	abort ();
+      INC (task_complete);
+    }
+  else if (prior_task_status == ompt_task_switch)
+    {
+      if (next_task_data->value == 0)
+	abort ();
+      INC (task_switch);
+    }
+}
+
+static void
+on_work (ompt_work_t wstype, ompt_scope_endpoint_t endpoint,
+	 ompt_data_t *parallel_data, ompt_data_t *task_data,
+	 uint64_t count, const void *codeptr_ra)
+{
+  if (wstype != ompt_work_loop && wstype != ompt_work_sections)
+    abort ();
+  if (parallel_data->value != 42)
+    abort ();
+  if (endpoint == ompt_scope_begin)
+    INC (work_begin);
+  else
+    INC (work_end);
+}
+
+static void
+on_sync_region_wait (ompt_sync_region_t kind,
+		     ompt_scope_endpoint_t endpoint,
+		     ompt_data_t *parallel_data, ompt_data_t *task_data,
+		     const void *codeptr_ra)
+{
+  if (endpoint == ompt_scope_begin)
+    INC (wait_begin);
+  /* Threads other than the master may still be leaving the implicit
+     barrier at the end of a parallel region after it has finished, so
+     only count the waits that are complete by then.  */
+  if (kind == ompt_sync_region_barrier_explicit)
+    {
+      if (endpoint == ompt_scope_begin)
+	INC (explicit_begin);
+      else
+	INC (explicit_end);
+    }
+}
+
+static int
+tool_initialize (ompt_function_lookup_t lookup, int initial_device_num,
+		 ompt_data_t *tool_data)
+{
+  ompt_set_callback_t set_callback
+    = (ompt_set_callback_t) lookup ("ompt_set_callback");
+
+  if (set_callback == NULL || tool_data->value != 7)
+    abort ();
+  set_callback (ompt_callback_parallel_begin,
+		(ompt_callback_t) on_parallel_begin);
+  set_callback (ompt_callback_parallel_end,
+		(ompt_callback_t) on_parallel_end);
+  set_callback (ompt_callback_task_create, (ompt_callback_t) on_task_create);
+  set_callback (ompt_callback_task_schedule,
+		(ompt_callback_t) on_task_schedule);
+  set_callback (ompt_callback_work, (ompt_callback_t) on_work);
+  set_callback (ompt_callback_sync_region_wait,
+		(ompt_callback_t) on_sync_region_wait);
+  if (set_callback (ompt_callback_mutex_acquire, NULL) != ompt_set_never)
+    abort ();
+  initialized = 1;
+  return 1;
+}
+
+static void
+tool_finalize (ompt_data_t *tool_data)
+{
+}
+
+ompt_start_tool_result_t *
+ompt_start_tool (unsigned int omp_version, const char *runtime_version)
+{
+  static ompt_start_tool_result_t result
+    = { tool_initialize, tool_finalize, { 7 } };
+  return &result;
+}
+
+int
+main ()
+{
+  int i, j, a[64];
+
+  omp_set_dynamic (0);
+  for (i = 0; i < 3; i++)
+    #pragma omp parallel num_threads (4)
+    {
+      #pragma omp for schedule (dynamic)
+      for (j = 0; j < 64; j++)
+	a[j] = j;
+      #pragma omp sections
+      {
+	#pragma omp section
+	a[0]++;
+	#pragma omp section
+	a[1]++;
+      }
+      #pragma omp barrier
+      #pragma omp single
+      {
+	for (j = 0; j < 10; j++)
+	  #pragma omp task firstprivate (j)
+	  a[j] += j;
+	#pragma omp taskwait
+      }
+    }
+
+  if (!initialized
+      || parallel_begin != 3 || parallel_end != 3
+      || task_create != 30 || task_switch != 30 || task_complete != 30
+      || work_begin != 3 * 4 * 2 || work_end != work_begin
+      || explicit_begin < 3 * 4 || explicit_end != explicit_begin
+      || wait_begin <= explicit_begin)
+    abort ();
+  return 0;
+}
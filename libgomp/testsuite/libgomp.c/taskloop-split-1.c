@@ -0,0 +1,78 @@
+/* Taskloops whose tasks are created by recursive splitting must still
+   run every iteration exactly once, in num_tasks tasks or in tasks of
+   grainsize iterations.  */
+
+#include <omp.h>
+#include <stdlib.h>
+
+#define N 1000
+
+int cnt[N], first[N];
+
+static void
+check (int ntasks, int step)
+{
+  int i, chunks = 0;
+
+  for (i = 0; i < N; i++)
+    {
+      if (cnt[i] != (i % step == 0))
+	abort ();
+      if (cnt[i] && first[i] == i)
+	chunks++;
+      cnt[i] = 0;
+    }
+  if (ntasks && chunks != ntasks)
+    abort ();
+}
+
+int
+main ()
+{
+  static const int ntasks[] = { 3, 7, 64, 999, 1000 };
+  unsigned int t;
+  long i;
+  unsigned long long u;
+
+  #pragma omp parallel
+  #pragma omp single
+  for (t = 0; t < sizeof (ntasks) / sizeof (ntasks[0]); t++)
+    {
+      int f = -1;
+
+      #pragma omp taskloop num_tasks (ntasks[t]) firstprivate (f)
+      for (i = 0; i < N; i++)
+	{
+	  if (f == -1)
+	    f = i;
+	  first[i] = f;
+	  cnt[i]++;
+	}
+      check (ntasks[t], 1);
+
+      #pragma omp taskloop num_tasks (ntasks[t]) firstprivate (f)
+      for (i = N - 1; i >= 0; i -= 3)
+	{
+	  if (f == -1)
+	    f = i;
+	  first[i] = f;
+	  cnt[i]++;
+	}
+      for (i = 0; i < N; i++)
+	if (cnt[i] != ((N - 1 - i) % 3 == 0))
+	  abort ();
+	else
+	  cnt[i] = 0;
+
+      #pragma omp taskloop grainsize (ntasks[t]) firstprivate (f)
+      for (u = 0; u < N; u += 2)
+	{
+	  if (f == -1)
+	    f = u;
+	  first[u] = f;
+	  cnt[u]++;
+	}
+      check (0, 2);
+    }
+  return 0;
+}
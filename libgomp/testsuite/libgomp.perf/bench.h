@@ -0,0 +1,147 @@
+/* Common code for the libgomp overhead benchmarks.
+
+   Each benchmark measures the overhead of an OpenMP construct the way
+   the EPCC OpenMP microbenchmarks do: a test executes the construct
+   many times around a fixed amount of work (calls to delay), and the
+   time the same work takes without the construct is subtracted.  This
+   is repeated several times, and the median, minimum and maximum
+   overhead per construct are printed, one tab-separated line per test:
+
+     benchmark  test  threads  wait-policy  spincount  median  min  max
+
+   with the times in microseconds.  Lines starting with '#' are
+   comments.  The number of threads and the wait policy come from the
+   usual OMP_NUM_THREADS, OMP_WAIT_POLICY and GOMP_SPINCOUNT environment
+   variables; BENCH_OUTER_REPS, BENCH_TEST_TIME (in microseconds, the
+   time each repetition should take) and BENCH_DELAY override the
+   defaults below.  */
+
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int outer_reps = 20;
+static double test_time = 1000e-6;
+static int delay_length = 100;
+static int nthreads;
+
+static const char *benchmark_name;
+
+/* Do an amount of work proportional to N that can't be optimized
+   away.  */
+
+static void __attribute__((noinline))
+delay (int n)
+{
+  volatile float a = 0.0f;
+  int i;
+  for (i = 0; i < n; i++)
+    a += i;
+}
+
+static const char *
+env_or (const char *name, const char *dflt)
+{
+  const char *val = getenv (name);
+  return val && *val ? val : dflt;
+}
+
+static int
+compare_doubles (const void *a, const void *b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+  return x < y ? -1 : x > y;
+}
+
+/* Return the number of repetitions of TEST that take at least
+   test_time seconds.  */
+
+static int
+calibrate (void (*test) (int))
+{
+  int reps = 1;
+  while (1)
+    {
+      double start = omp_get_wtime ();
+      test (reps);
+      if (omp_get_wtime () - start >= test_time || reps >= (1 << 28))
+	return reps;
+      reps *= 2;
+    }
+}
+
+/* Return the median time per repetition of TEST, and store the minimum
+   and maximum in *MIN and *MAX.  */
+
+static double
+measure (void (*test) (int), double *min, double *max)
+{
+  int reps = calibrate (test);
+  double *times = malloc (outer_reps * sizeof (double));
+  double median;
+  int k;
+
+  if (times == NULL)
+    abort ();
+  for (k = 0; k < outer_reps; k++)
+    {
+      double start = omp_get_wtime ();
+      test (reps);
+      times[k] = (omp_get_wtime () - start) / reps;
+    }
+  qsort (times, outer_reps, sizeof (double), compare_doubles);
+  median = times[outer_reps / 2];
+  *min = times[0];
+  *max = times[outer_reps - 1];
+  free (times);
+  return median;
+}
+
+/* The time the delay takes on its own.  */
+static double reference_time;
+
+static void
+reference (int reps)
+{
+  int j;
+  for (j = 0; j < reps; j++)
+    delay (delay_length);
+}
+
+static void
+bench_init (const char *name)
+{
+  double min, max;
+
+  benchmark_name = name;
+  outer_reps = atoi (env_or ("BENCH_OUTER_REPS", "20"));
+  test_time = atof (env_or ("BENCH_TEST_TIME", "1000")) * 1e-6;
+  delay_length = atoi (env_or ("BENCH_DELAY", "100"));
+  if (outer_reps < 1)
+    outer_reps = 1;
+  nthreads = omp_get_max_threads ();
+
+  printf ("# %s: %d threads, OMP_WAIT_POLICY=%s, GOMP_SPINCOUNT=%s\n",
+	  name, nthreads, env_or ("OMP_WAIT_POLICY", "default"),
+	  env_or ("GOMP_SPINCOUNT", "default"));
+  reference_time = measure (reference, &min, &max);
+  printf ("# delay %d takes %.3f us\n", delay_length, reference_time * 1e6);
+}
+
+/* Measure TEST, which executes the construct COUNT times in each of
+   its repetitions, during which each thread calls delay DELAYS times,
+   and print the overhead of a construct.  */
+
+static void
+bench (const char *test_name, void (*test) (int), int count, int delays)
+{
+  double min, max;
+  double median = measure (test, &min, &max);
+  double work = delays * reference_time;
+
+  printf ("%s\t%s\t%d\t%s\t%s\t%.3f\t%.3f\t%.3f\n", benchmark_name,
+	  test_name, nthreads, env_or ("OMP_WAIT_POLICY", "default"),
+	  env_or ("GOMP_SPINCOUNT", "default"), (median - work) / count * 1e6,
+	  (min - work) / count * 1e6, (max - work) / count * 1e6);
+  fflush (stdout);
+}
@@ -0,0 +1,92 @@
+/* Overhead of the loop schedules: static, static with a chunk size,
+   dynamic and guided, for chunk sizes from 1 to ITERS_PER_THREAD.  */
+
+#include <string.h>
+#include "bench.h"
+
+#define ITERS_PER_THREAD 128
+
+static int chunk;
+
+static void
+test_static (int reps)
+{
+#pragma omp parallel
+  {
+    int j, i;
+    for (j = 0; j < reps; j++)
+      {
+#pragma omp for schedule(static)
+	for (i = 0; i < ITERS_PER_THREAD * nthreads; i++)
+	  delay (delay_length);
+      }
+  }
+}
+
+static void
+test_static_chunk (int reps)
+{
+#pragma omp parallel
+  {
+    int j, i;
+    for (j = 0; j < reps; j++)
+      {
+#pragma omp for schedule(static, chunk)
+	for (i = 0; i < ITERS_PER_THREAD * nthreads; i++)
+	  delay (delay_length);
+      }
+  }
+}
+
+static void
+test_dynamic (int reps)
+{
+#pragma omp parallel
+  {
+    int j, i;
+    for (j = 0; j < reps; j++)
+      {
+#pragma omp for schedule(dynamic, chunk)
+	for (i = 0; i < ITERS_PER_THREAD * nthreads; i++)
+	  delay (delay_length);
+      }
+  }
+}
+
+static void
+test_guided (int reps)
+{
+#pragma omp parallel
+  {
+    int j, i;
+    for (j = 0; j < reps; j++)
+      {
+#pragma omp for schedule(guided, chunk)
+	for (i = 0; i < ITERS_PER_THREAD * nthreads; i++)
+	  delay (delay_length);
+      }
+  }
+}
+
+int
+main (void)
+{
+  /* The loop bodies are short so that the scheduling dominates.  */
+  if (getenv ("BENCH_DELAY") == NULL)
+    setenv ("BENCH_DELAY", "15", 1);
+  bench_init ("schedbench");
+
+  bench ("static", test_static, 1, ITERS_PER_THREAD);
+  for (chunk = 1; chunk <= ITERS_PER_THREAD; chunk *= 2)
+    {
+      char name[32];
+
+      sprintf (name, "static %d", chunk);
+      bench (name, test_static_chunk, 1, ITERS_PER_THREAD);
+      sprintf (name, "dynamic %d", chunk);
+      bench (name, test_dynamic, 1, ITERS_PER_THREAD);
+      sprintf (name, "guided %d", chunk);
+      bench (name, test_guided, 1, ITERS_PER_THREAD);
+    }
+  return 0;
+}
@@ -0,0 +1,158 @@
+/* Overhead of the OpenMP synchronization constructs: parallel, for,
+   barrier, single, critical, locks, atomic and reduction.  */
+
+#include "bench.h"
+
+static omp_lock_t lock;
+
+static void
+test_parallel (int reps)
+{
+  int j;
+  for (j = 0; j < reps; j++)
+    {
+#pragma omp parallel
+      delay (delay_length);
+    }
+}
+
+static void
+test_for (int reps)
+{
+#pragma omp parallel
+  {
+    int j, i;
+    for (j = 0; j < reps; j++)
+      {
+#pragma omp for
+	for (i = 0; i < nthreads; i++)
+	  delay (delay_length);
+      }
+  }
+}
+
+static void
+test_parallel_for (int reps)
+{
+  int j, i;
+  for (j = 0; j < reps; j++)
+    {
+#pragma omp parallel for
+      for (i = 0; i < nthreads; i++)
+	delay (delay_length);
+    }
+}
+
+static void
+test_barrier (int reps)
+{
+#pragma omp parallel
+  {
+    int j;
+    for (j = 0; j < reps; j++)
+      {
+	delay (delay_length);
+#pragma omp barrier
+      }
+  }
+}
+
+static void
+test_single (int reps)
+{
+#pragma omp parallel
+  {
+    int j;
+    for (j = 0; j < reps; j++)
+      {
+#pragma omp single
+	delay (delay_length);
+      }
+  }
+}
+
+/* In the tests of mutual exclusion, each thread enters the critical
+   section REPS / nthreads times, so that the total work is the same as
+   that of the reference.  */
+
+static void
+test_critical (int reps)
+{
+#pragma omp parallel
+  {
+    int j;
+    for (j = 0; j < reps / nthreads; j++)
+      {
+#pragma omp critical
+	delay (delay_length);
+      }
+  }
+}
+
+static void
+test_lock (int reps)
+{
+#pragma omp parallel
+  {
+    int j;
+    for (j = 0; j < reps / nthreads; j++)
+      {
+	omp_set_lock (&lock);
+	delay (delay_length);
+	omp_unset_lock (&lock);
+      }
+  }
+}
+
+static void
+test_atomic (int reps)
+{
+  double a = 0.0;
+#pragma omp parallel
+  {
+    int j;
+    for (j = 0; j < reps / nthreads; j++)
+      {
+#pragma omp atomic
+	a += 1.0;
+      }
+  }
+  if (a < 0.0)
+    abort ();
+}
+
+static void
+test_reduction (int reps)
+{
+  int j, a = 0;
+  for (j = 0; j < reps; j++)
+    {
+#pragma omp parallel reduction(+:a)
+      {
+	delay (delay_length);
+	a += 1;
+      }
+    }
+  if (a < 0)
+    abort ();
+}
+
+int
+main (void)
+{
+  bench_init ("syncbench");
+  omp_init_lock (&lock);
+
+  bench ("parallel", test_parallel, 1, 1);
+  bench ("for", test_for, 1, 1);
+  bench ("parallel for", test_parallel_for, 1, 1);
+  bench ("barrier", test_barrier, 1, 1);
+  bench ("single", test_single, 1, 1);
+  bench ("critical", test_critical, 1, 1);
+  bench ("lock/unlock", test_lock, 1, 1);
+  bench ("atomic", test_atomic, 1, 0);
+  bench ("reduction", test_reduction, 1, 1);
+
+  omp_destroy_lock (&lock);
+  return 0;
+}
@@ -0,0 +1,153 @@
+/* Overhead of creating and waiting for explicit tasks.  */
+
+#include "bench.h"
+
+/* Number of tasks each thread creates in each repetition.  */
+#define TASKS_PER_THREAD 64
+
+/* Every thread creates tasks, and they are waited for at the barrier
+   at the end of the parallel region.  */
+
+static void
+test_parallel_task (int reps)
+{
+  int j;
+  for (j = 0; j < reps; j++)
+    {
+#pragma omp parallel
+      {
+	int i;
+	for (i = 0; i < TASKS_PER_THREAD; i++)
+	  {
+#pragma omp task
+	    delay (delay_length);
+	  }
+      }
+    }
+}
+
+/* One thread creates all the tasks and the others execute them.  */
+
+static void
+test_master_task (int reps)
+{
+#pragma omp parallel
+  {
+    int j, i;
+    for (j = 0; j < reps; j++)
+      {
+#pragma omp master
+	for (i = 0; i < TASKS_PER_THREAD * nthreads; i++)
+	  {
+#pragma omp task
+	    delay (delay_length);
+	  }
+#pragma omp barrier
+      }
+  }
+}
+
+/* Every thread creates tasks and waits for them with taskwait.  */
+
+static void
+test_taskwait (int reps)
+{
+#pragma omp parallel
+  {
+    int j, i;
+    for (j = 0; j < reps; j++)
+      {
+	for (i = 0; i < TASKS_PER_THREAD; i++)
+	  {
+#pragma omp task
+	    delay (delay_length);
+	  }
+#pragma omp taskwait
+      }
+  }
+}
+
+/* Every thread creates tasks in a taskgroup.  */
+
+static void
+test_taskgroup (int reps)
+{
+#pragma omp parallel
+  {
+    int j, i;
+    for (j = 0; j < reps; j++)
+      {
+#pragma omp taskgroup
+	for (i = 0; i < TASKS_PER_THREAD; i++)
+	  {
+#pragma omp task
+	    delay (delay_length);
+	  }
+      }
+  }
+}
+
+/* Tasks that create a task each, waited for with taskwait.  */
+
+static void
+test_nested_task (int reps)
+{
+#pragma omp parallel
+  {
+    int j, i;
+    for (j = 0; j < reps; j++)
+      {
+	for (i = 0; i < TASKS_PER_THREAD / 2; i++)
+	  {
+#pragma omp task
+	    {
+#pragma omp task
+	      delay (delay_length);
+	      delay (delay_length);
+#pragma omp taskwait
+	    }
+	  }
+#pragma omp taskwait
+      }
+  }
+}
+
+/* A loop split into tasks with taskloop.  */
+
+static void
+test_taskloop (int reps)
+{
+#pragma omp parallel
+  {
+    int j, i;
+#pragma omp single
+    for (j = 0; j < reps; j++)
+      {
+#pragma omp taskloop grainsize(1)
+	for (i = 0; i < TASKS_PER_THREAD * nthreads; i++)
+	  delay (delay_length);
+      }
+  }
+}
+
+int
+main (void)
+{
+  bench_init ("taskbench");
+
+  /* The overheads are per task: each thread executes TASKS_PER_THREAD
+     tasks in each repetition when the work is evenly spread.  */
+  bench ("parallel task", test_parallel_task, TASKS_PER_THREAD,
+	 TASKS_PER_THREAD);
+  bench ("master task", test_master_task, TASKS_PER_THREAD,
+	 TASKS_PER_THREAD);
+  bench ("taskwait", test_taskwait, TASKS_PER_THREAD,
+	 TASKS_PER_THREAD);
+  bench ("taskgroup", test_taskgroup, TASKS_PER_THREAD,
+	 TASKS_PER_THREAD);
+  bench ("nested task", test_nested_task, TASKS_PER_THREAD,
+	 TASKS_PER_THREAD);
+  bench ("taskloop", test_taskloop, TASKS_PER_THREAD,
+	 TASKS_PER_THREAD);
+  return 0;
+}
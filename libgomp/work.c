@@ -132,6 +132,7 @@ gomp_init_work_share (struct gomp_work_share *ws, size_t ordered,
     ws->ordered_team_ids = ws->inline_ordered_team_ids;
   gomp_ptrlock_init (&ws->next_ws, NULL);
   ws->threads_completed = 0;
+  ws->auto_ranges = NULL;
 }
 
 /* Do any needed destruction of gomp_work_share fields before it
@@ -143,6 +144,8 @@ gomp_fini_work_share (struct gomp_work_share *ws)
   gomp_mutex_destroy (&ws->lock);
   if (ws->ordered_team_ids != ws->inline_ordered_team_ids)
     free (ws->ordered_team_ids);
+  if (ws->auto_ranges)
+    gomp_aligned_free (ws->auto_ranges);
   gomp_ptrlock_destroy (&ws->next_ws);
 }
 
@@ -182,12 +185,14 @@ free_work_share (struct gomp_team *team, struct gomp_work_share *ws)
    if this was the first thread to reach this point.  */
 
 bool
-gomp_work_share_start (size_t ordered)
+gomp_work_share_start (size_t ordered, int wstype)
 {
   struct gomp_thread *thr = gomp_thread ();
   struct gomp_team *team = thr->ts.team;
   struct gomp_work_share *ws;
 
+  gomp_ompt_work_begin (thr, wstype);
+
   /* Work sharing constructs can be orphaned.  */
   if (team == NULL)
     {
@@ -225,6 +230,8 @@ gomp_work_share_end (void)
   struct gomp_team *team = thr->ts.team;
   gomp_barrier_state_t bstate;
 
+  gomp_ompt_work_end (thr);
+
   /* Work sharing constructs can be orphaned.  */
   if (team == NULL)
     {
@@ -233,7 +240,9 @@ gomp_work_share_end (void)
       return;
     }
 
-  bstate = gomp_barrier_wait_start (&team->barrier);
+  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_implicit,
+			      ompt_scope_begin);
+  bstate = gomp_team_barrier_wait_start (&team->barrier, thr->ts.team_id);
 
   if (gomp_barrier_last_thread (bstate))
     {
@@ -245,6 +254,8 @@ gomp_work_share_end (void)
     }
 
   gomp_team_barrier_wait_end (&team->barrier, bstate);
+  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_implicit,
+			      ompt_scope_end);
   thr->ts.last_work_share = NULL;
 }
 
@@ -257,9 +268,15 @@ gomp_work_share_end_cancel (void)
   struct gomp_thread *thr = gomp_thread ();
   struct gomp_team *team = thr->ts.team;
   gomp_barrier_state_t bstate;
+  bool ret;
+
+  gomp_ompt_work_end (thr);
 
   /* Cancellable work sharing constructs cannot be orphaned.  */
-  bstate = gomp_barrier_wait_cancel_start (&team->barrier);
+  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_implicit,
+			      ompt_scope_begin);
+  bstate = gomp_team_barrier_wait_cancel_start (&team->barrier,
+						 thr->ts.team_id);
 
   if (gomp_barrier_last_thread (bstate))
     {
@@ -271,7 +288,10 @@ gomp_work_share_end_cancel (void)
     }
   thr->ts.last_work_share = NULL;
 
-  return gomp_team_barrier_wait_cancel_end (&team->barrier, bstate);
+  ret = gomp_team_barrier_wait_cancel_end (&team->barrier, bstate);
+  gomp_ompt_sync_region_wait (ompt_sync_region_barrier_implicit,
+			      ompt_scope_end);
+  return ret;
 }
 
 /* The current thread is done with its current work sharing construct.
@@ -285,6 +305,8 @@ gomp_work_share_end_nowait (void)
   struct gomp_work_share *ws = thr->ts.work_share;
   unsigned completed;
 
+  gomp_ompt_work_end (thr);
+
   /* Work sharing constructs can be orphaned.  */
   if (team == NULL)
     {
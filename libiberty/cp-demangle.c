@@ -307,6 +307,22 @@ struct d_saved_scope
   struct d_print_template *templates;
 };
 
+/* Arrays kept by a struct demangle_workspace between calls to the
+   demangler, which are otherwise allocated on the stack for each
+   name.  */
+
+struct demangle_workspace
+{
+  struct demangle_component *comps;
+  int num_comps;
+  struct demangle_component **subs;
+  int num_subs;
+  struct d_saved_scope *saved_scopes;
+  int num_saved_scopes;
+  struct d_print_template *copy_templates;
+  int num_copy_templates;
+};
+
 /* Checkpoint structure to allow backtracking.  This holds copies
    of the fields of struct d_info that need to be restored
    if a trial parse needs to be backtracked over.  */
@@ -564,8 +580,13 @@ static void d_print_cast (struct d_print_info *, int,
 static void d_print_conversion (struct d_print_info *, int,
 				struct demangle_component *);
 
+static int d_print_callback (int, struct demangle_component *,
+			     demangle_callbackref, void *,
+			     struct demangle_workspace *);
+
 static int d_demangle_callback (const char *, int,
-                                demangle_callbackref, void *);
+                                demangle_callbackref, void *,
+                                struct demangle_workspace *);
 static char *d_demangle (const char *, int, size_t *);
 
 #define FNQUAL_COMPONENT_CASE				\
@@ -4319,6 +4340,42 @@ int
 cplus_demangle_print_callback (int options,
                                struct demangle_component *dc,
                                demangle_callbackref callback, void *opaque)
+{
+  return d_print_callback (options, dc, callback, opaque, NULL);
+}
+
+/* Make sure that ARRAY, which has room for *PNUM elements of SIZE
+   bytes, has room for COUNT of them.  Return the possibly moved
+   array, or NULL on allocation failure, in which case ARRAY is
+   unchanged.  */
+
+static void *
+d_workspace_reserve (void *array, int *pnum, int count, size_t size)
+{
+  int num;
+
+  if (array != NULL && count <= *pnum)
+    return array;
+
+  num = *pnum > 0 ? *pnum : 64;
+  while (num < count)
+    num = num > INT_MAX / 2 ? count : num * 2;
+  if ((size_t) num > (size_t) -1 / size)
+    return NULL;
+  array = realloc (array, num * size);
+  if (array != NULL)
+    *pnum = num;
+  return array;
+}
+
+/* Like cplus_demangle_print_callback, but if WS is not NULL, use its
+   arrays rather than the stack.  This returns 0 if they cannot be
+   allocated.  */
+
+static int
+d_print_callback (int options, struct demangle_component *dc,
+		  demangle_callbackref callback, void *opaque,
+		  struct demangle_workspace *ws)
 {
   struct d_print_info dpi;
 
@@ -4328,20 +4385,48 @@ cplus_demangle_print_callback (int options,
 #ifdef CP_DYNAMIC_ARRAYS
     /* Avoid zero-length VLAs, which are prohibited by the C99 standard
        and flagged as errors by Address Sanitizer.  */
-    __extension__ struct d_saved_scope scopes[(dpi.num_saved_scopes > 0)
+    __extension__ struct d_saved_scope scopes[(dpi.num_saved_scopes > 0
+					       && ws == NULL)
                                               ? dpi.num_saved_scopes : 1];
-    __extension__ struct d_print_template temps[(dpi.num_copy_templates > 0)
+    __extension__ struct d_print_template temps[(dpi.num_copy_templates > 0
+						 && ws == NULL)
                                                 ? dpi.num_copy_templates : 1];
 
     dpi.saved_scopes = scopes;
     dpi.copy_templates = temps;
 #else
-    dpi.saved_scopes = alloca (dpi.num_saved_scopes
-			       * sizeof (*dpi.saved_scopes));
-    dpi.copy_templates = alloca (dpi.num_copy_templates
-				 * sizeof (*dpi.copy_templates));
+    if (ws == NULL)
+      {
+	dpi.saved_scopes = alloca (dpi.num_saved_scopes
+				   * sizeof (*dpi.saved_scopes));
+	dpi.copy_templates = alloca (dpi.num_copy_templates
+				     * sizeof (*dpi.copy_templates));
+      }
 #endif
 
+    if (ws != NULL)
+      {
+	void *scopes_mem, *temps_mem;
+
+	scopes_mem = d_workspace_reserve (ws->saved_scopes,
+					  &ws->num_saved_scopes,
+					  dpi.num_saved_scopes,
+					  sizeof (*ws->saved_scopes));
+	if (scopes_mem == NULL)
+	  return 0;
+	ws->saved_scopes = (struct d_saved_scope *) scopes_mem;
+	temps_mem = d_workspace_reserve (ws->copy_templates,
+					 &ws->num_copy_templates,
+					 dpi.num_copy_templates,
+					 sizeof (*ws->copy_templates));
+	if (temps_mem == NULL)
+	  return 0;
+	ws->copy_templates = (struct d_print_template *) temps_mem;
+
+	dpi.saved_scopes = ws->saved_scopes;
+	dpi.copy_templates = ws->copy_templates;
+      }
+
     d_print_comp (&dpi, options, dc);
   }
 
@@ -6239,12 +6324,14 @@ cplus_demangle_init_info (const char *mangled, int options, size_t len,
 
 /* Internal implementation for the demangler.  If MANGLED is a g++ v3 ABI
    mangled name, return strings in repeated callback giving the demangled
-   name.  OPTIONS is the usual libiberty demangler options.  On success,
-   this returns 1.  On failure, returns 0.  */
+   name.  OPTIONS is the usual libiberty demangler options.  If WS is not
+   NULL, the working arrays come from it instead of the stack.  On
+   success, this returns 1.  On failure, returns 0.  */
 
 static int
 d_demangle_callback (const char *mangled, int options,
-                     demangle_callbackref callback, void *opaque)
+                     demangle_callbackref callback, void *opaque,
+                     struct demangle_workspace *ws)
 {
   enum
     {
@@ -6290,16 +6377,38 @@ d_demangle_callback (const char *mangled, int options,
 
   {
 #ifdef CP_DYNAMIC_ARRAYS
-    __extension__ struct demangle_component comps[di.num_comps];
-    __extension__ struct demangle_component *subs[di.num_subs];
+    __extension__ struct demangle_component comps[ws ? 1 : di.num_comps];
+    __extension__ struct demangle_component *subs[ws ? 1 : di.num_subs];
 
     di.comps = comps;
     di.subs = subs;
 #else
-    di.comps = alloca (di.num_comps * sizeof (*di.comps));
-    di.subs = alloca (di.num_subs * sizeof (*di.subs));
+    if (ws == NULL)
+      {
+	di.comps = alloca (di.num_comps * sizeof (*di.comps));
+	di.subs = alloca (di.num_subs * sizeof (*di.subs));
+      }
 #endif
 
+    if (ws != NULL)
+      {
+	void *comps_mem, *subs_mem;
+
+	comps_mem = d_workspace_reserve (ws->comps, &ws->num_comps,
+					 di.num_comps, sizeof (*ws->comps));
+	if (comps_mem == NULL)
+	  return 0;
+	ws->comps = (struct demangle_component *) comps_mem;
+	subs_mem = d_workspace_reserve (ws->subs, &ws->num_subs,
+					di.num_subs, sizeof (*ws->subs));
+	if (subs_mem == NULL)
+	  return 0;
+	ws->subs = (struct demangle_component **) subs_mem;
+
+	di.comps = ws->comps;
+	di.subs = ws->subs;
+      }
+
     switch (type)
       {
       case DCT_TYPE:
@@ -6335,7 +6444,7 @@ d_demangle_callback (const char *mangled, int options,
 #endif
 
     status = (dc != NULL)
-             ? cplus_demangle_print_callback (options, dc, callback, opaque)
+             ? d_print_callback (options, dc, callback, opaque, ws)
              : 0;
   }
 
@@ -6358,7 +6467,8 @@ d_demangle (const char *mangled, int options, size_t *palc)
   d_growable_string_init (&dgs, 0);
 
   status = d_demangle_callback (mangled, options,
-                                d_growable_string_callback_adapter, &dgs);
+                                d_growable_string_callback_adapter, &dgs,
+                                NULL);
   if (status == 0)
     {
       free (dgs.buf);
@@ -6496,7 +6606,7 @@ __gcclibcxx_demangle_callback (const char *mangled_name,
     return -3;
 
   status = d_demangle_callback (mangled_name, DMGL_PARAMS | DMGL_TYPES,
-                                callback, opaque);
+                                callback, opaque, NULL);
   if (status == 0)
     return -2;
 
@@ -6521,7 +6631,105 @@ int
 cplus_demangle_v3_callback (const char *mangled, int options,
                             demangle_callbackref callback, void *opaque)
 {
-  return d_demangle_callback (mangled, options, callback, opaque);
+  return d_demangle_callback (mangled, options, callback, opaque, NULL);
+}
+
+/* Return a new workspace for cplus_demangle_v3_workspace_callback and
+   cplus_demangle_v3_buffer, or NULL if out of memory.  */
+
+struct demangle_workspace *
+cplus_demangle_workspace_create (void)
+{
+  struct demangle_workspace *ws;
+
+  ws = (struct demangle_workspace *) malloc (sizeof (*ws));
+  if (ws != NULL)
+    {
+      ws->comps = NULL;
+      ws->num_comps = 0;
+      ws->subs = NULL;
+      ws->num_subs = 0;
+      ws->saved_scopes = NULL;
+      ws->num_saved_scopes = 0;
+      ws->copy_templates = NULL;
+      ws->num_copy_templates = 0;
+    }
+  return ws;
+}
+
+/* Free the workspace WS and everything it holds.  */
+
+void
+cplus_demangle_workspace_free (struct demangle_workspace *ws)
+{
+  if (ws == NULL)
+    return;
+  free (ws->comps);
+  free (ws->subs);
+  free (ws->saved_scopes);
+  free (ws->copy_templates);
+  free (ws);
+}
+
+/* Like cplus_demangle_v3_callback, but keep the working memory in WS,
+   which grows as needed and is reused by the next call, instead of
+   on the stack.  This also returns zero if that memory cannot be
+   allocated.  */
+
+int
+cplus_demangle_v3_workspace_callback (const char *mangled, int options,
+				      demangle_callbackref callback,
+				      void *opaque,
+				      struct demangle_workspace *ws)
+{
+  return d_demangle_callback (mangled, options, callback, opaque, ws);
+}
+
+/* Where cplus_demangle_v3_buffer puts the demangled name.  */
+
+struct d_buffer_sink
+{
+  char *buf;
+  size_t size;
+  /* The length of the demangled name so far, which may be more than
+     SIZE.  */
+  size_t len;
+};
+
+static void
+d_buffer_sink_callback (const char *s, size_t l, void *opaque)
+{
+  struct d_buffer_sink *sink = (struct d_buffer_sink *) opaque;
+
+  if (sink->len < sink->size)
+    memcpy (sink->buf + sink->len, s,
+	    l < sink->size - sink->len ? l : sink->size - sink->len);
+  sink->len += l;
+}
+
+/* Demangle MANGLED into BUF, which is SIZE bytes long, without
+   allocating memory beyond what WS, if not NULL, already holds.  Like
+   snprintf, this stores as much of the demangled name as fits
+   followed by a NUL, and returns the length of the whole name.  It
+   returns 0 if MANGLED is not a g++ v3 ABI mangled name.  */
+
+size_t
+cplus_demangle_v3_buffer (const char *mangled, int options, char *buf,
+			  size_t size, struct demangle_workspace *ws)
+{
+  struct d_buffer_sink sink;
+
+  sink.buf = buf;
+  sink.size = size;
+  sink.len = 0;
+
+  if (! d_demangle_callback (mangled, options, d_buffer_sink_callback,
+			     &sink, ws))
+    sink.len = 0;
+
+  if (size > 0)
+    buf[sink.len < size ? sink.len : size - 1] = '\0';
+  return sink.len;
 }
 
 /* Demangle a Java symbol.  Java uses a subset of the V3 ABI C++ mangling 
@@ -6544,7 +6752,7 @@ java_demangle_v3_callback (const char *mangled,
 {
   return d_demangle_callback (mangled,
                               DMGL_JAVA | DMGL_PARAMS | DMGL_RET_POSTFIX,
-                              callback, opaque);
+                              callback, opaque, NULL);
 }
 
 #endif /* IN_LIBGCC2 || IN_GLIBCPP_V3 */
@@ -70,6 +70,9 @@ static unsigned int higher_prime_index (unsigned long);
 static hashval_t htab_mod_1 (hashval_t, hashval_t, hashval_t, int);
 static hashval_t htab_mod (hashval_t, htab_t);
 static hashval_t htab_mod_m2 (hashval_t, htab_t);
+static size_t higher_pow2 (size_t, unsigned int *);
+static PTR htab_alloc_array (htab_t, size_t, size_t);
+static void htab_free_array (htab_t, PTR);
 static hashval_t hash_pointer (const void *);
 static int eq_pointer (const void *, const void *);
 static int htab_expand (htab_t);
@@ -273,6 +276,105 @@ htab_mod_m2 (hashval_t hash, htab_t htab)
   return 1 + htab_mod_1 (hash, p->prime - 2, p->inv_m2, p->shift);
 }
 
+/* Return the smallest power of two which is at least N and at least 8,
+   and store its base-2 logarithm in *LOG2.  */
+
+static size_t
+higher_pow2 (size_t n, unsigned int *log2)
+{
+  unsigned int l = 3;
+
+  while (((size_t) 1 << l) < n)
+    {
+      /* Probe indices are hashval_t, so stay within 32 bits.  */
+      if (++l > 31)
+	{
+	  fprintf (stderr, "Cannot find power of two bigger than %lu\n",
+		   (unsigned long) n);
+	  abort ();
+	}
+    }
+
+  *log2 = l;
+  return (size_t) 1 << l;
+}
+
+/* Compute the index of the first slot probed for HASH given HTAB's
+   current size.  Power-of-two tables use the high bits of a
+   multiplicative (Fibonacci) hash, so that hash functions with poor low
+   bits, such as htab_hash_pointer, still spread over the whole table.  */
+
+static inline hashval_t
+htab_first_index (hashval_t hash, htab_t htab)
+{
+  if (htab->flags & HTAB_POWER_OF_2)
+    return (((hash * 0x9e3779b9U) & 0xffffffffU)
+	    >> (32 - htab->size_prime_index));
+  return htab_mod (hash, htab);
+}
+
+/* Compute the initial probe step for HASH given HTAB's current size.  */
+
+static inline hashval_t
+htab_first_step (hashval_t hash, htab_t htab)
+{
+  if (htab->flags & HTAB_POWER_OF_2)
+    return 0;
+  return htab_mod_m2 (hash, htab);
+}
+
+/* Return the slot probed after INDEX, updating *STEP.  Prime-sized
+   tables use double hashing with a constant step.  Power-of-two tables
+   use quadratic probing by triangular numbers, which visits every slot
+   of the table.  */
+
+static inline hashval_t
+htab_next_index (htab_t htab, hashval_t index, hashval_t *step)
+{
+  if (htab->flags & HTAB_POWER_OF_2)
+    return (index + ++*step) & (htab->size - 1);
+
+  index += *step;
+  if (index >= htab->size)
+    index -= htab->size;
+  return index;
+}
+
+/* Return non-zero if ENTRY, found at INDEX in HTAB, is equal to ELEMENT
+   whose hash is HASH.  When HTAB caches hash values the equality
+   function is only called if the hashes match.  */
+
+static inline int
+htab_entry_eq (htab_t htab, hashval_t index, const PTR entry,
+	       const PTR element, hashval_t hash)
+{
+  if (htab->hashes != NULL && htab->hashes[index] != hash)
+    return 0;
+  return (*htab->eq_f) (entry, element);
+}
+
+/* Allocate an array of N elements of SIZE bytes each using HTAB's
+   allocator.  */
+
+static PTR
+htab_alloc_array (htab_t htab, size_t n, size_t size)
+{
+  if (htab->alloc_with_arg_f != NULL)
+    return (*htab->alloc_with_arg_f) (htab->alloc_arg, n, size);
+  return (*htab->alloc_f) (n, size);
+}
+
+/* Free an array allocated by htab_alloc_array.  */
+
+static void
+htab_free_array (htab_t htab, PTR p)
+{
+  if (htab->free_f != NULL)
+    (*htab->free_f) (p);
+  else if (htab->free_with_arg_f != NULL)
+    (*htab->free_with_arg_f) (htab->alloc_arg, p);
+}
+
 /* This function creates table with length slightly longer than given
    source length.  Created hash table is initiated as empty (all the
    hash table entries are HTAB_EMPTY_ENTRY).  The function returns the
@@ -374,6 +476,86 @@ htab_create_typed_alloc (size_t size, htab_hash hash_f, htab_eq eq_f,
   return result;
 }
 
+/*
+
+@deftypefn Supplemental htab_t htab_create_alloc_flags (size_t @var{size}, @
+htab_hash @var{hash_f}, htab_eq @var{eq_f}, htab_del @var{del_f}, @
+htab_alloc @var{alloc_f}, htab_free @var{free_f}, unsigned int @var{flags})
+
+This function is like @code{htab_create_alloc}, but selects the layout
+of the table with @var{flags}, a bitwise or of the following values:
+
+@table @code
+@item HTAB_CACHE_HASHES
+Store the hash value of every entry next to it.  Lookups then call
+@var{eq_f} only for entries whose hash matches, and expanding the table
+does not call @var{hash_f}.  The element stored in a slot returned by
+@code{htab_find_slot_with_hash} must have the hash value passed to it.
+
+@item HTAB_POWER_OF_2
+Use power-of-two table sizes with quadratic probing instead of prime
+sizes with double hashing.  This avoids the division needed to reduce
+a hash value to a table index.
+@end table
+
+The cached hash values are allocated with @var{alloc_f} as an array of
+@code{hashval_t}.  The function returns the created hash table, or
+@code{NULL} if memory allocation fails.
+
+@end deftypefn
+
+*/
+
+htab_t
+htab_create_alloc_flags (size_t size, htab_hash hash_f, htab_eq eq_f,
+			 htab_del del_f, htab_alloc alloc_f,
+			 htab_free free_f, unsigned int flags)
+{
+  htab_t result;
+  unsigned int size_index;
+
+  if (flags & HTAB_POWER_OF_2)
+    size = higher_pow2 (size, &size_index);
+  else
+    {
+      size_index = higher_prime_index (size);
+      size = prime_tab[size_index].prime;
+    }
+
+  result = (htab_t) (*alloc_f) (1, sizeof (struct htab));
+  if (result == NULL)
+    return NULL;
+  result->entries = (PTR *) (*alloc_f) (size, sizeof (PTR));
+  if (result->entries == NULL)
+    {
+      if (free_f != NULL)
+	(*free_f) (result);
+      return NULL;
+    }
+  if (flags & HTAB_CACHE_HASHES)
+    {
+      result->hashes = (hashval_t *) (*alloc_f) (size, sizeof (hashval_t));
+      if (result->hashes == NULL)
+	{
+	  if (free_f != NULL)
+	    {
+	      (*free_f) (result->entries);
+	      (*free_f) (result);
+	    }
+	  return NULL;
+	}
+    }
+  result->size = size;
+  result->size_prime_index = size_index;
+  result->flags = flags;
+  result->hash_f = hash_f;
+  result->eq_f = eq_f;
+  result->del_f = del_f;
+  result->alloc_f = alloc_f;
+  result->free_f = free_f;
+  return result;
+}
+
 
 /* Update the function pointers and allocation parameter in the htab_t.  */
 
@@ -420,6 +602,9 @@ htab_delete (htab_t htab)
       if (entries[i] != HTAB_EMPTY_ENTRY && entries[i] != HTAB_DELETED_ENTRY)
 	(*htab->del_f) (entries[i]);
 
+  if (htab->hashes != NULL)
+    htab_free_array (htab, htab->hashes);
+
   if (htab->free_f != NULL)
     {
       (*htab->free_f) (entries);
@@ -449,8 +634,16 @@ htab_empty (htab_t htab)
   /* Instead of clearing megabyte, downsize the table.  */
   if (size > 1024*1024 / sizeof (PTR))
     {
-      int nindex = higher_prime_index (1024 / sizeof (PTR));
-      int nsize = prime_tab[nindex].prime;
+      unsigned int nindex;
+      size_t nsize;
+
+      if (htab->flags & HTAB_POWER_OF_2)
+	nsize = higher_pow2 (1024 / sizeof (PTR), &nindex);
+      else
+	{
+	  nindex = higher_prime_index (1024 / sizeof (PTR));
+	  nsize = prime_tab[nindex].prime;
+	}
 
       if (htab->free_f != NULL)
 	(*htab->free_f) (htab->entries);
@@ -461,6 +654,12 @@ htab_empty (htab_t htab)
 						           sizeof (PTR *));
       else
 	htab->entries = (PTR *) (*htab->alloc_f) (nsize, sizeof (PTR *));
+      if (htab->hashes != NULL)
+	{
+	  htab_free_array (htab, htab->hashes);
+	  htab->hashes = (hashval_t *) htab_alloc_array (htab, nsize,
+							 sizeof (hashval_t));
+	}
      htab->size = nsize;
      htab->size_prime_index = nindex;
     }
@@ -480,8 +679,7 @@ htab_empty (htab_t htab)
 static PTR *
 find_empty_slot_for_expand (htab_t htab, hashval_t hash)
 {
-  hashval_t index = htab_mod (hash, htab);
-  size_t size = htab_size (htab);
+  hashval_t index = htab_first_index (hash, htab);
   PTR *slot = htab->entries + index;
   hashval_t hash2;
 
@@ -490,12 +688,10 @@ find_empty_slot_for_expand (htab_t htab, hashval_t hash)
   else if (*slot == HTAB_DELETED_ENTRY)
     abort ();
 
-  hash2 = htab_mod_m2 (hash, htab);
+  hash2 = htab_first_step (hash, htab);
   for (;;)
     {
-      index += hash2;
-      if (index >= size)
-	index -= size;
+      index = htab_next_index (htab, index, &hash2);
 
       slot = htab->entries + index;
       if (*slot == HTAB_EMPTY_ENTRY)
@@ -520,10 +716,12 @@ htab_expand (htab_t htab)
   PTR *olimit;
   PTR *p;
   PTR *nentries;
+  hashval_t *ohashes, *nhashes;
   size_t nsize, osize, elts;
   unsigned int oindex, nindex;
 
   oentries = htab->entries;
+  ohashes = htab->hashes;
   oindex = htab->size_prime_index;
   osize = htab->size;
   olimit = oentries + osize;
@@ -533,8 +731,13 @@ htab_expand (htab_t htab)
      too full or too empty.  */
   if (elts * 2 > osize || (elts * 8 < osize && osize > 32))
     {
-      nindex = higher_prime_index (elts * 2);
-      nsize = prime_tab[nindex].prime;
+      if (htab->flags & HTAB_POWER_OF_2)
+	nsize = higher_pow2 (elts * 2, &nindex);
+      else
+	{
+	  nindex = higher_prime_index (elts * 2);
+	  nsize = prime_tab[nindex].prime;
+	}
     }
   else
     {
@@ -549,7 +752,19 @@ htab_expand (htab_t htab)
     nentries = (PTR *) (*htab->alloc_f) (nsize, sizeof (PTR *));
   if (nentries == NULL)
     return 0;
+  nhashes = NULL;
+  if (ohashes != NULL)
+    {
+      nhashes = (hashval_t *) htab_alloc_array (htab, nsize,
+						sizeof (hashval_t));
+      if (nhashes == NULL)
+	{
+	  htab_free_array (htab, nentries);
+	  return 0;
+	}
+    }
   htab->entries = nentries;
+  htab->hashes = nhashes;
   htab->size = nsize;
   htab->size_prime_index = nindex;
   htab->n_elements -= htab->n_deleted;
@@ -562,9 +777,13 @@ htab_expand (htab_t htab)
 
       if (x != HTAB_EMPTY_ENTRY && x != HTAB_DELETED_ENTRY)
 	{
-	  PTR *q = find_empty_slot_for_expand (htab, (*htab->hash_f) (x));
+	  hashval_t hash = (ohashes != NULL
+			    ? ohashes[p - oentries] : (*htab->hash_f) (x));
+	  PTR *q = find_empty_slot_for_expand (htab, hash);
 
 	  *q = x;
+	  if (nhashes != NULL)
+	    nhashes[q - nentries] = hash;
 	}
 
       p++;
@@ -575,6 +794,8 @@ htab_expand (htab_t htab)
     (*htab->free_f) (oentries);
   else if (htab->free_with_arg_f != NULL)
     (*htab->free_with_arg_f) (htab->alloc_arg, oentries);
+  if (ohashes != NULL)
+    htab_free_array (htab, ohashes);
   return 1;
 }
 
@@ -585,29 +806,27 @@ PTR
 htab_find_with_hash (htab_t htab, const PTR element, hashval_t hash)
 {
   hashval_t index, hash2;
-  size_t size;
   PTR entry;
 
   htab->searches++;
-  size = htab_size (htab);
-  index = htab_mod (hash, htab);
+  index = htab_first_index (hash, htab);
 
   entry = htab->entries[index];
   if (entry == HTAB_EMPTY_ENTRY
-      || (entry != HTAB_DELETED_ENTRY && (*htab->eq_f) (entry, element)))
+      || (entry != HTAB_DELETED_ENTRY
+	  && htab_entry_eq (htab, index, entry, element, hash)))
     return entry;
 
-  hash2 = htab_mod_m2 (hash, htab);
+  hash2 = htab_first_step (hash, htab);
   for (;;)
     {
       htab->collisions++;
-      index += hash2;
-      if (index >= size)
-	index -= size;
+      index = htab_next_index (htab, index, &hash2);
 
       entry = htab->entries[index];
       if (entry == HTAB_EMPTY_ENTRY
-	  || (entry != HTAB_DELETED_ENTRY && (*htab->eq_f) (entry, element)))
+	  || (entry != HTAB_DELETED_ENTRY
+	      && htab_entry_eq (htab, index, entry, element, hash)))
 	return entry;
     }
 }
@@ -643,10 +862,9 @@ htab_find_slot_with_hash (htab_t htab, const PTR element,
     {
       if (htab_expand (htab) == 0)
 	return NULL;
-      size = htab_size (htab);
     }
 
-  index = htab_mod (hash, htab);
+  index = htab_first_index (hash, htab);
 
   htab->searches++;
   first_deleted_slot = NULL;
@@ -656,16 +874,14 @@ htab_find_slot_with_hash (htab_t htab, const PTR element,
     goto empty_entry;
   else if (entry == HTAB_DELETED_ENTRY)
     first_deleted_slot = &htab->entries[index];
-  else if ((*htab->eq_f) (entry, element))
+  else if (htab_entry_eq (htab, index, entry, element, hash))
     return &htab->entries[index];
       
-  hash2 = htab_mod_m2 (hash, htab);
+  hash2 = htab_first_step (hash, htab);
   for (;;)
     {
       htab->collisions++;
-      index += hash2;
-      if (index >= size)
-	index -= size;
+      index = htab_next_index (htab, index, &hash2);
       
       entry = htab->entries[index];
       if (entry == HTAB_EMPTY_ENTRY)
@@ -675,7 +891,7 @@ htab_find_slot_with_hash (htab_t htab, const PTR element,
 	  if (!first_deleted_slot)
 	    first_deleted_slot = &htab->entries[index];
 	}
-      else if ((*htab->eq_f) (entry, element))
+      else if (htab_entry_eq (htab, index, entry, element, hash))
 	return &htab->entries[index];
     }
 
@@ -687,10 +903,14 @@ htab_find_slot_with_hash (htab_t htab, const PTR element,
     {
       htab->n_deleted--;
       *first_deleted_slot = HTAB_EMPTY_ENTRY;
+      if (htab->hashes != NULL)
+	htab->hashes[first_deleted_slot - htab->entries] = hash;
       return first_deleted_slot;
     }
 
   htab->n_elements++;
+  if (htab->hashes != NULL)
+    htab->hashes[index] = hash;
   return &htab->entries[index];
 }
 
@@ -934,19 +1154,22 @@ iterative_hash (const PTR k_in /* the key */,
 
   /*---------------------------------------- handle most of the key */
 #ifndef WORDS_BIGENDIAN
-  /* On a little-endian machine, if the data is 4-byte aligned we can hash
-     by word for better speed.  This gives nondeterministic results on
-     big-endian machines.  */
-  if (sizeof (hashval_t) == 4 && (((size_t)k)&3) == 0)
-    while (len >= 12)    /* aligned */
+  /* On a little-endian machine we can hash by word for better speed,
+     whatever the alignment of the data; memcpy compiles to plain loads
+     on hosts that allow unaligned accesses.  This gives
+     nondeterministic results on big-endian machines.  */
+  if (sizeof (hashval_t) == 4)
+    while (len >= 12)
       {
-	a += *(hashval_t *)(k+0);
-	b += *(hashval_t *)(k+4);
-	c += *(hashval_t *)(k+8);
+	hashval_t w[3];
+	memcpy (w, k, sizeof (w));
+	a += w[0];
+	b += w[1];
+	c += w[2];
 	mix(a,b,c);
 	k += 12; len -= 12;
       }
-  else /* unaligned */
+  else
 #endif
     while (len >= 12)
       {
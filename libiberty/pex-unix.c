@@ -58,6 +58,11 @@ extern int errno;
 #ifdef HAVE_PROCESS_H
 #include <process.h>
 #endif
+#if defined (HAVE_SPAWN_H) && defined (HAVE_POSIX_SPAWN) \
+    && defined (HAVE_POSIX_SPAWNP)
+#include <spawn.h>
+#define PEX_USE_POSIX_SPAWN 1
+#endif
 
 #ifdef vfork /* Autoconf may define this to fork for us. */
 # define VFORK_STRING "fork"
@@ -563,10 +568,10 @@ pex_unix_exec_child (struct pex_obj *obj ATTRIBUTE_UNUSED,
 /* Implementation of pex->exec_child using standard vfork + exec.  */
 
 static pid_t
-pex_unix_exec_child (struct pex_obj *obj, int flags, const char *executable,
-		     char * const * argv, char * const * env,
-                     int in, int out, int errdes,
-		     int toclose, const char **errmsg, int *err)
+pex_unix_vfork_exec_child (struct pex_obj *obj, int flags,
+			   const char *executable, char * const * argv,
+			   char * const * env, int in, int out, int errdes,
+			   int toclose, const char **errmsg, int *err)
 {
   pid_t pid = -1;
   /* Tuple to communicate error from child to parent.  We can safely
@@ -762,6 +767,132 @@ pex_unix_exec_child (struct pex_obj *obj, int flags, const char *executable,
       return pid;
     }
 }
+
+#ifdef PEX_USE_POSIX_SPAWN
+/* Implementation of pex->exec_child using posix_spawn, which avoids
+   copying the page tables of a large parent process.  The descriptors
+   are moved into place in the child by file actions, in the same order
+   as in pex_unix_vfork_exec_child.  */
+
+static pid_t
+pex_unix_posix_spawn_child (int flags, const char *executable,
+			    char * const * argv, char * const * env,
+			    int in, int out, int errdes, int toclose,
+			    const char **errmsg, int *err)
+{
+  posix_spawn_file_actions_t actions;
+  const char *fn = NULL;
+  pid_t pid = -1;
+  int ret, retries;
+
+  ret = posix_spawn_file_actions_init (&actions);
+  if (ret != 0)
+    {
+      *err = ret;
+      *errmsg = "posix_spawn_file_actions_init";
+      return (pid_t) -1;
+    }
+
+  ret = 0;
+  if (ret == 0 && in != STDIN_FILE_NO)
+    {
+      ret = posix_spawn_file_actions_adddup2 (&actions, in, STDIN_FILE_NO);
+      if (ret == 0)
+	ret = posix_spawn_file_actions_addclose (&actions, in);
+    }
+  if (ret == 0 && out != STDOUT_FILE_NO)
+    {
+      ret = posix_spawn_file_actions_adddup2 (&actions, out, STDOUT_FILE_NO);
+      if (ret == 0)
+	ret = posix_spawn_file_actions_addclose (&actions, out);
+    }
+  if (ret == 0 && errdes != STDERR_FILE_NO)
+    {
+      ret = posix_spawn_file_actions_adddup2 (&actions, errdes,
+					      STDERR_FILE_NO);
+      if (ret == 0)
+	ret = posix_spawn_file_actions_addclose (&actions, errdes);
+    }
+  if (ret == 0 && toclose >= 0)
+    ret = posix_spawn_file_actions_addclose (&actions, toclose);
+  if (ret == 0 && (flags & PEX_STDERR_TO_STDOUT) != 0)
+    ret = posix_spawn_file_actions_adddup2 (&actions, STDOUT_FILE_NO,
+					    STDERR_FILE_NO);
+  if (ret != 0)
+    {
+      posix_spawn_file_actions_destroy (&actions);
+      *err = ret;
+      *errmsg = "posix_spawn_file_actions";
+      return (pid_t) -1;
+    }
+
+  /* If we were not given an environment, use the global environment.  */
+  if (env == NULL)
+    env = environ;
+
+  /* Retry a few times with increasing backoff times if we are out of
+     processes, as for vfork.  */
+  for (retries = 0; retries < 4; ++retries)
+    {
+      if ((flags & PEX_SEARCH) != 0)
+	{
+	  fn = "posix_spawnp";
+	  ret = posix_spawnp (&pid, executable, &actions, NULL, argv, env);
+	}
+      else
+	{
+	  fn = "posix_spawn";
+	  ret = posix_spawn (&pid, executable, &actions, NULL, argv, env);
+	}
+      if (ret != EAGAIN)
+	break;
+      sleep (1 << retries);
+    }
+
+  posix_spawn_file_actions_destroy (&actions);
+
+  if (ret != 0)
+    {
+      *err = ret;
+      *errmsg = fn;
+      return (pid_t) -1;
+    }
+
+  /* The child has its own copies of the descriptors now.  */
+  if (in != STDIN_FILE_NO && close (in) < 0)
+    fn = "close", ret = errno;
+  if (ret == 0 && out != STDOUT_FILE_NO && close (out) < 0)
+    fn = "close", ret = errno;
+  if (ret == 0 && errdes != STDERR_FILE_NO && close (errdes) < 0)
+    fn = "close", ret = errno;
+  if (ret != 0)
+    {
+      *err = ret;
+      *errmsg = fn;
+      return (pid_t) -1;
+    }
+
+  return pid;
+}
+#endif /* PEX_USE_POSIX_SPAWN */
+
+static pid_t
+pex_unix_exec_child (struct pex_obj *obj, int flags, const char *executable,
+		     char * const * argv, char * const * env,
+                     int in, int out, int errdes,
+		     int toclose, const char **errmsg, int *err)
+{
+#ifdef PEX_USE_POSIX_SPAWN
+  /* posix_spawnp searches the PATH of this process, while the child
+     of vfork searches the PATH of the environment it is given.  */
+  if (env == NULL || (flags & PEX_SEARCH) == 0)
+    return pex_unix_posix_spawn_child (flags, executable, argv, env, in, out,
+				       errdes, toclose, errmsg, err);
+#endif
+
+  return pex_unix_vfork_exec_child (obj, flags, executable, argv, env, in,
+				    out, errdes, toclose, errmsg, err);
+}
 #endif /* SPAWN */
 
 /* Wait for a child process to complete.  */
@@ -147,6 +147,13 @@ struct simple_object_functions
 					  simple_object_write *dobj,
 					  char *(*pfn) (const char *),
 					  int *err);
+
+  /* Implement simple_object_find_symbols, or NULL if the symbol table
+     can not be read.  */
+  const char *(*find_symbols) (simple_object_read *,
+			       int (*pfn) (void *, const char *),
+			       void *data,
+			       int *err);
 };
 
 /* The known object file formats.  */
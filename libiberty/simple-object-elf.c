@@ -655,6 +655,148 @@ simple_object_elf_find_sections (simple_object_read *sobj,
   return NULL;
 }
 
+/* Find all defined symbols in an ELF file.  */
+
+static const char *
+simple_object_elf_find_symbols (simple_object_read *sobj,
+				int (*pfn) (void *, const char *),
+				void *data,
+				int *err)
+{
+  struct simple_object_elf_read *eor =
+    (struct simple_object_elf_read *) sobj->data;
+  const struct elf_type_functions *type_functions = eor->type_functions;
+  unsigned char ei_class = eor->ei_class;
+  size_t shdr_size;
+  unsigned int shnum;
+  unsigned char *shdrs;
+  const char *errmsg;
+  unsigned int i;
+  int stop;
+
+  shdr_size = (ei_class == ELFCLASS32
+	       ? sizeof (Elf32_External_Shdr)
+	       : sizeof (Elf64_External_Shdr));
+
+  /* Read the section headers.  We skip section 0, which is not a
+     useful section.  */
+
+  shnum = eor->shnum;
+  shdrs = XNEWVEC (unsigned char, shdr_size * (shnum - 1));
+
+  if (!simple_object_internal_read (sobj->descriptor,
+				    sobj->offset + eor->shoff + shdr_size,
+				    shdrs,
+				    shdr_size * (shnum - 1),
+				    &errmsg, err))
+    {
+      XDELETEVEC (shdrs);
+      return errmsg;
+    }
+
+  stop = 0;
+  for (i = 1; i < shnum && !stop; ++i)
+    {
+      unsigned char *shdr;
+      unsigned char *strhdr;
+      unsigned int sh_link;
+      size_t entsize;
+      size_t length;
+      size_t str_length;
+      unsigned char *syms;
+      unsigned char *names;
+      unsigned char *ent;
+
+      shdr = shdrs + (i - 1) * shdr_size;
+      if (ELF_FETCH_FIELD (type_functions, ei_class, Shdr,
+			   shdr, sh_type, Elf_Word) != SHT_SYMTAB)
+	continue;
+
+      entsize = ELF_FETCH_FIELD (type_functions, ei_class, Shdr,
+				 shdr, sh_entsize, Elf_Addr);
+      length = ELF_FETCH_FIELD (type_functions, ei_class, Shdr,
+				shdr, sh_size, Elf_Addr);
+      sh_link = ELF_FETCH_FIELD (type_functions, ei_class, Shdr,
+				 shdr, sh_link, Elf_Word);
+      if (entsize < (ei_class == ELFCLASS32
+		     ? sizeof (Elf32_External_Sym)
+		     : sizeof (Elf64_External_Sym))
+	  || sh_link == 0
+	  || sh_link >= shnum)
+	{
+	  *err = 0;
+	  XDELETEVEC (shdrs);
+	  return "ELF symbol table is invalid";
+	}
+
+      strhdr = shdrs + (sh_link - 1) * shdr_size;
+      str_length = ELF_FETCH_FIELD (type_functions, ei_class, Shdr,
+				    strhdr, sh_size, Elf_Addr);
+
+      syms = XNEWVEC (unsigned char, length);
+      names = XNEWVEC (unsigned char, str_length + 1);
+      if (!simple_object_internal_read (sobj->descriptor,
+					sobj->offset
+					+ ELF_FETCH_FIELD (type_functions,
+							   ei_class, Shdr,
+							   shdr, sh_offset,
+							   Elf_Addr),
+					syms, length, &errmsg, err)
+	  || !simple_object_internal_read (sobj->descriptor,
+					   sobj->offset
+					   + ELF_FETCH_FIELD (type_functions,
+							      ei_class, Shdr,
+							      strhdr,
+							      sh_offset,
+							      Elf_Addr),
+					   names, str_length, &errmsg, err))
+	{
+	  XDELETEVEC (names);
+	  XDELETEVEC (syms);
+	  XDELETEVEC (shdrs);
+	  return errmsg;
+	}
+      names[str_length] = '\0';
+
+      /* Skip the null symbol at index 0.  */
+      for (ent = syms + entsize;
+	   ent + entsize <= syms + length;
+	   ent += entsize)
+	{
+	  unsigned int st_shndx;
+	  unsigned int st_name;
+
+	  st_shndx = ELF_FETCH_FIELD (type_functions, ei_class, Sym,
+				      ent, st_shndx, Elf_Half);
+	  st_name = ELF_FETCH_FIELD (type_functions, ei_class, Sym,
+				     ent, st_name, Elf_Word);
+	  if (st_shndx == SHN_UNDEF || st_name == 0)
+	    continue;
+	  if (st_name >= str_length)
+	    {
+	      *err = 0;
+	      XDELETEVEC (names);
+	      XDELETEVEC (syms);
+	      XDELETEVEC (shdrs);
+	      return "ELF symbol name out of range";
+	    }
+
+	  if (!(*pfn) (data, (const char *) names + st_name))
+	    {
+	      stop = 1;
+	      break;
+	    }
+	}
+
+      XDELETEVEC (names);
+      XDELETEVEC (syms);
+    }
+
+  XDELETEVEC (shdrs);
+
+  return NULL;
+}
+
 /* Fetch the attributes for an simple_object_read.  */
 
 static void *
@@ -1600,5 +1742,6 @@ const struct simple_object_functions simple_object_elf_functions =
   simple_object_elf_start_write,
   simple_object_elf_write_to_file,
   simple_object_elf_release_write,
-  simple_object_elf_copy_lto_debug_sections
+  simple_object_elf_copy_lto_debug_sections,
+  simple_object_elf_find_symbols
 };
@@ -1058,5 +1058,6 @@ const struct simple_object_functions simple_object_xcoff_functions =
   simple_object_xcoff_start_write,
   simple_object_xcoff_write_to_file,
   simple_object_xcoff_release_write,
+  NULL,
   NULL
 };
@@ -199,6 +199,23 @@ simple_object_find_sections (simple_object_read *sobj,
   return sobj->functions->find_sections (sobj, pfn, data, err);
 }
 
+/* Find all defined symbols.  */
+
+const char *
+simple_object_find_symbols (simple_object_read *sobj,
+			    int (*pfn) (void *, const char *),
+			    void *data,
+			    int *err)
+{
+  if (! sobj->functions->find_symbols)
+    {
+      *err = EINVAL;
+      return "simple_object_find_symbols not implemented";
+    }
+
+  return sobj->functions->find_symbols (sobj, pfn, data, err);
+}
+
 /* Internal data passed to find_one_section.  */
 
 struct find_one_section_data
@@ -149,6 +149,41 @@ exp: %s\n",
 	  lineno, opts, in, out != NULL ? out : "(null)", exp);
 }
 
+/* Check that cplus_demangle_v3_buffer, with and without the workspace
+   WS, agrees with cplus_demangle_v3 on IN with OPTIONS, including
+   when the buffer is too small.  Return nonzero if it does.  */
+
+static int
+check_v3_buffer (in, options, ws)
+     const char *in;
+     int options;
+     struct demangle_workspace *ws;
+{
+  char buf[8];
+  char *expect, *full;
+  size_t len, explen;
+  int ok;
+
+  expect = cplus_demangle_v3 (in, options);
+  explen = expect ? strlen (expect) : 0;
+  full = xmalloc (explen + 1);
+
+  len = cplus_demangle_v3_buffer (in, options, full, explen + 1, ws);
+  ok = (len == explen && strcmp (full, expect ? expect : "") == 0);
+
+  len = cplus_demangle_v3_buffer (in, options, full, explen + 1, NULL);
+  ok &= (len == explen && strcmp (full, expect ? expect : "") == 0);
+
+  len = cplus_demangle_v3_buffer (in, options, buf, sizeof buf, ws);
+  ok &= (len == explen
+	 && strncmp (buf, expect ? expect : "", sizeof buf - 1) == 0
+	 && strlen (buf) == (explen < sizeof buf ? explen : sizeof buf - 1));
+
+  free (full);
+  free (expect);
+  return ok;
+}
+
 /* The tester operates on a data file consisting of groups of lines:
    options
    input to be demangled
@@ -185,6 +220,7 @@ main(argc, argv)
   char *result;
   int failures = 0;
   int tests = 0;
+  struct demangle_workspace *ws;
 
   if (argc > 1)
     {
@@ -196,6 +232,8 @@ main(argc, argv)
   input.data = 0;
   expect.data = 0;
 
+  ws = cplus_demangle_workspace_create ();
+
   for (;;)
     {
       const char *inp;
@@ -327,6 +365,15 @@ main(argc, argv)
 	}
       free (result);
 
+      if (! check_v3_buffer (inp, (DMGL_PARAMS | DMGL_ANSI | DMGL_TYPES
+				   | (ret_postfix ? DMGL_RET_POSTFIX : 0)
+				   | (ret_drop ? DMGL_RET_DROP : 0)), ws))
+	{
+	  printf ("FAIL at line %d: cplus_demangle_v3_buffer differs"
+		  " for %s\n", lineno, input.data);
+	  failures++;
+	}
+
       if (no_params)
 	{
 	  get_line (&expect);
@@ -343,6 +390,7 @@ main(argc, argv)
 	}
     }
 
+  cplus_demangle_workspace_free (ws);
   free (format.data);
   free (input.data);
   free (expect.data);
@@ -0,0 +1,213 @@
+/* Test program for the hash table layouts of hashtab.c.
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of the libiberty library, which is part of GCC.
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   In addition to the permissions in the GNU General Public License, the
+   Free Software Foundation gives you unlimited permission to link the
+   compiled version of this file into combinations with other programs,
+   and to distribute those combinations without any restriction coming
+   from the use of this file.  (The General Public License restrictions
+   do apply in other respects; for example, they cover modification of
+   the file, and distribution when not linked into a combined
+   executable.)
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston, MA 02110-1301, USA. 
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include "libiberty.h"
+#include "hashtab.h"
+#include <stdio.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#ifndef EXIT_SUCCESS
+#define EXIT_SUCCESS 0
+#endif
+
+#ifndef EXIT_FAILURE
+#define EXIT_FAILURE 1
+#endif
+
+#define NELTS 5000
+
+static char *elts[NELTS];
+static int fails;
+
+/* A hash function whose low bits are always zero, to check that
+   power-of-two tables still spread the entries.  */
+
+static hashval_t
+bad_hash_string (const void *p)
+{
+  return htab_hash_string (p) << 8;
+}
+
+static int
+eq_string (const void *p1, const void *p2)
+{
+  return strcmp ((const char *) p1, (const char *) p2) == 0;
+}
+
+static int
+count_entry (void **slot ATTRIBUTE_UNUSED, void *info)
+{
+  ++*(size_t *) info;
+  return 1;
+}
+
+static void
+fail (const char *what, unsigned int flags, htab_hash hash_f)
+{
+  printf ("FAIL: hashtab: %s with flags %u%s\n", what, flags,
+	  hash_f == bad_hash_string ? " and bad hash" : "");
+  fails++;
+}
+
+/* Insert, look up, remove and traverse the strings in ELTS in a table
+   created with FLAGS and HASH_F.  */
+
+static void
+run_test (unsigned int flags, htab_hash hash_f)
+{
+  htab_t htab;
+  size_t count;
+  int i;
+
+  htab = htab_create_alloc_flags (7, hash_f, eq_string, NULL,
+				  xcalloc, free, flags);
+
+  for (i = 0; i < NELTS; i++)
+    {
+      void **slot = htab_find_slot_with_hash (htab, elts[i],
+					      (*hash_f) (elts[i]), INSERT);
+      if (*slot != HTAB_EMPTY_ENTRY)
+	fail ("duplicate insertion", flags, hash_f);
+      *slot = elts[i];
+    }
+  if (htab_elements (htab) != NELTS)
+    fail ("element count after insertion", flags, hash_f);
+
+  for (i = 0; i < NELTS; i += 2)
+    htab_remove_elt (htab, elts[i]);
+  if (htab_elements (htab) != NELTS / 2)
+    fail ("element count after removal", flags, hash_f);
+
+  for (i = 0; i < NELTS; i++)
+    {
+      void *found = htab_find (htab, elts[i]);
+      if (found != ((i & 1) ? elts[i] : NULL))
+	fail ("lookup", flags, hash_f);
+    }
+
+  /* Reinserting the removed strings reuses deleted slots, and enough
+     insertions force an expansion that moves the cached hashes.  */
+  for (i = 0; i < NELTS; i += 2)
+    *htab_find_slot (htab, elts[i], INSERT) = elts[i];
+  for (i = 0; i < NELTS; i++)
+    if (htab_find (htab, elts[i]) != elts[i])
+      fail ("lookup after reinsertion", flags, hash_f);
+
+  count = 0;
+  htab_traverse (htab, count_entry, &count);
+  if (count != NELTS)
+    fail ("traversal", flags, hash_f);
+
+  if ((flags & HTAB_POWER_OF_2)
+      && (htab_size (htab) & (htab_size (htab) - 1)) != 0)
+    fail ("power-of-two size", flags, hash_f);
+
+  htab_empty (htab);
+  if (htab_elements (htab) != 0 || htab_find (htab, elts[0]) != NULL)
+    fail ("emptying", flags, hash_f);
+  *htab_find_slot (htab, elts[0], INSERT) = elts[0];
+  if (htab_find (htab, elts[0]) != elts[0])
+    fail ("lookup after emptying", flags, hash_f);
+
+  htab_delete (htab);
+}
+
+/* Check that iterative_hash doesn't depend on the alignment of the
+   data it hashes.  */
+
+static void
+test_iterative_hash (void)
+{
+  unsigned char buf[64 + 4];
+  size_t len;
+  int i;
+
+  for (len = 0; len <= 64; len++)
+    {
+      hashval_t h0 = 0;
+
+      for (i = 0; i < 4; i++)
+	{
+	  size_t j;
+	  hashval_t h;
+
+	  for (j = 0; j < len; j++)
+	    buf[i + j] = (unsigned char) (j * 37 + len);
+	  h = iterative_hash (buf + i, len, 17);
+	  if (i == 0)
+	    h0 = h;
+	  else if (h != h0)
+	    {
+	      printf ("FAIL: hashtab: iterative_hash of %lu bytes "
+		      "at offset %d\n", (unsigned long) len, i);
+	      fails++;
+	    }
+	}
+    }
+}
+
+int
+main (void)
+{
+  static const unsigned int flags[] = {
+    0, HTAB_CACHE_HASHES, HTAB_POWER_OF_2,
+    HTAB_CACHE_HASHES | HTAB_POWER_OF_2
+  };
+  unsigned int i;
+  int j;
+
+  for (j = 0; j < NELTS; j++)
+    {
+      elts[j] = (char *) xmalloc (32);
+      sprintf (elts[j], "/usr/include/sys/%d.h", j);
+    }
+
+  for (i = 0; i < sizeof (flags) / sizeof (flags[0]); i++)
+    {
+      run_test (flags[i], htab_hash_string);
+      run_test (flags[i], bad_hash_string);
+    }
+  test_iterative_hash ();
+
+  for (j = 0; j < NELTS; j++)
+    free (elts[j]);
+
+  if (fails)
+    exit (EXIT_FAILURE);
+  printf ("PASS: hashtab\n");
+  return EXIT_SUCCESS;
+}
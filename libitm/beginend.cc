@@ -99,6 +99,23 @@ GTM::gtm_thread::~gtm_thread()
   if (nesting > 0)
     GTM_fatal("Thread exit while a transaction is still active.");
 
+  if (gtm_statistics)
+    GTM_error("thread %p: restarts: %u locked, %u validate, %u serial, "
+	      "%u other; HW transactions: %u committed, %u transient aborts, "
+	      "%u persistent aborts, %u fallbacks", (void *) this,
+	      restart_reason[RESTART_LOCKED_READ]
+	      + restart_reason[RESTART_LOCKED_WRITE],
+	      restart_reason[RESTART_VALIDATE_READ]
+	      + restart_reason[RESTART_VALIDATE_WRITE]
+	      + restart_reason[RESTART_VALIDATE_COMMIT],
+	      restart_reason[RESTART_SERIAL_IRR],
+	      restart_reason[RESTART_REALLOCATE]
+	      + restart_reason[RESTART_NOT_READONLY]
+	      + restart_reason[RESTART_CLOSED_NESTING]
+	      + restart_reason[RESTART_INIT_METHOD_GROUP],
+	      htm_outcome[HTM_COMMITTED], htm_outcome[HTM_ABORTED_RETRY],
+	      htm_outcome[HTM_ABORTED_PERSISTENT], htm_outcome[HTM_FELL_BACK]);
+
   // Deregister this transaction.
   serial_lock.write_lock ();
   gtm_thread **prev = &list_of_threads;
@@ -312,6 +329,63 @@ GTM::gtm_thread::begin_transaction (uint32_t prop, const gtm_jmpbuf *jb)
       set_gtm_thr(tx);
     }
 
+#ifdef USE_HTM_FASTPATH
+  // HW transactions of the hybrid method.  In contrast to the HTM fastpath
+  // above, these can run concurrently with software transactions of the
+  // hybrid method, so we cannot use the serial lock to tell whether we run
+  // a HW transaction; instead, we mark this in the transaction's state from
+  // within the HW transaction.  See method-gl.cc for how HW and software
+  // transactions synchronize.
+  if (unlikely(tx->state & STATE_HTM))
+    {
+      // Nested transactions are flattened into the HW transaction.  We
+      // cannot roll them back separately, so let the software fallback
+      // handle transactions that might get canceled.
+      if (!(prop & pr_hasNoAbort))
+	htm_abort();
+      tx->nesting++;
+      return (prop & pr_uninstrumentedCode) ?
+	  a_runUninstrumentedCode : a_runInstrumentedCode;
+    }
+  if (tx->nesting == 0 && (prop & pr_hasNoAbort)
+      && !(prop & pr_doesGoIrrevocable) && hybrid_htm_attempts())
+    {
+      for (uint32_t t = hybrid_htm_attempts(); t; t--)
+	{
+	  uint32_t ret = htm_begin();
+	  if (htm_begin_success(ret))
+	    {
+	      // Monitor both the serial lock and the software fallback's
+	      // ownership record.
+	      if (unlikely(serial_lock.has_writer() || !hybrid_htm_subscribe()))
+		htm_abort();
+	      // All of this is undone if the HW transaction aborts.
+	      tx->state = STATE_HTM;
+	      tx->prop = prop;
+	      tx->nesting = 1;
+	      // Instrumented code just accesses memory directly.
+	      set_abi_disp(dispatch_serialirr());
+	      return (prop & pr_uninstrumentedCode) ?
+		  a_runUninstrumentedCode : a_runInstrumentedCode;
+	    }
+	  if (!htm_abort_should_retry(ret))
+	    {
+	      tx->htm_outcome[HTM_ABORTED_PERSISTENT]++;
+	      break;
+	    }
+	  tx->htm_outcome[HTM_ABORTED_RETRY]++;
+	  // Wait until any concurrent serial-mode transactions have finished,
+	  // as in the HTM fastpath.
+	  if (serial_lock.has_writer())
+	    {
+	      serial_lock.read_lock(tx);
+	      serial_lock.read_unlock(tx);
+	    }
+	}
+      tx->htm_outcome[HTM_FELL_BACK]++;
+    }
+#endif
+
   if (tx->nesting > 0)
     {
       // This is a nested transaction.
@@ -570,6 +644,29 @@ _ITM_abortTransaction (_ITM_abortReason reason)
     }
 }
 
+// Waits until all other threads' shared_state is at least PRIV_TIME.  The
+// caller must prevent changes to the list of threads.
+static void
+wait_for_quiescence (gtm_thread *tx, gtm_word priv_time)
+{
+  // TODO Don't just spin but also block using cond vars / futexes
+  // here. Should probably be integrated with the serial lock code.
+  for (gtm_thread *it = gtm_thread::list_of_threads; it != 0;
+      it = it->next_thread)
+    {
+      if (it == tx) continue;
+      // We need to load other threads' shared_state using acquire
+      // semantics (matching the release semantics of the respective
+      // updates).  This is necessary to ensure that the other
+      // threads' memory accesses happen before our actions that
+      // assume privatization safety.
+      // TODO Are there any platform-specific optimizations (e.g.,
+      // merging barriers)?
+      while (it->shared_state.load(memory_order_acquire) < priv_time)
+	cpu_relax();
+    }
+}
+
 bool
 GTM::gtm_thread::trycommit ()
 {
@@ -649,22 +746,7 @@ GTM::gtm_thread::trycommit ()
 	  // issue the fence.
 	  if (do_read_unlock)
 	    atomic_thread_fence (memory_order_seq_cst);
-	  // TODO Don't just spin but also block using cond vars / futexes
-	  // here. Should probably be integrated with the serial lock code.
-	  for (gtm_thread *it = gtm_thread::list_of_threads; it != 0;
-	      it = it->next_thread)
-	    {
-	      if (it == this) continue;
-	      // We need to load other threads' shared_state using acquire
-	      // semantics (matching the release semantics of the respective
-	      // updates).  This is necessary to ensure that the other
-	      // threads' memory accesses happen before our actions that
-	      // assume privatization safety.
-	      // TODO Are there any platform-specific optimizations (e.g.,
-	      // merging barriers)?
-	      while (it->shared_state.load(memory_order_acquire) < priv_time)
-		cpu_relax();
-	    }
+	  wait_for_quiescence (this, priv_time);
 	}
 
       // After ensuring privatization safety, we are now truly inactive and
@@ -709,6 +791,38 @@ GTM::gtm_thread::restart (gtm_restart_reason r, bool finish_serial_upgrade)
 	       &jb, prop);
 }
 
+#ifdef USE_HTM_FASTPATH
+// Commits a HW transaction of the hybrid method.
+void
+GTM::gtm_thread::hybrid_commit ()
+{
+  if (--nesting > 0)
+    return;
+
+  gtm_word priv_time = hybrid_htm_publish (prop & pr_readOnly);
+  state = 0;
+  htm_commit ();
+  htm_outcome[HTM_COMMITTED]++;
+
+  // Our update of the orec might have invalidated the snapshots of software
+  // transactions.  Wait until they have noticed this before we do anything
+  // that assumes privatization safety, as trycommit does.  We become active
+  // to keep the list of threads stable, but use a maximum snapshot time so
+  // that others do not wait for us.
+  if (priv_time)
+    {
+      serial_lock.read_lock (this);
+      shared_state.store ((~(typeof gtm_thread::shared_state)0) - 1,
+	  memory_order_release);
+      atomic_thread_fence (memory_order_seq_cst);
+      wait_for_quiescence (this, priv_time);
+      serial_lock.read_unlock (this);
+    }
+  commit_user_actions ();
+  commit_allocations (false, 0);
+}
+#endif
+
 void ITM_REGPARM
 _ITM_commitTransaction(void)
 {
@@ -724,6 +838,13 @@ _ITM_commitTransaction(void)
     }
 #endif
   gtm_thread *tx = gtm_thr();
+#if defined(USE_HTM_FASTPATH)
+  if (unlikely(tx->state & gtm_thread::STATE_HTM))
+    {
+      tx->hybrid_commit();
+      return;
+    }
+#endif
   if (!tx->trycommit ())
     tx->restart (RESTART_VALIDATE_COMMIT);
 }
@@ -740,6 +861,13 @@ _ITM_commitTransactionEH(void *exc_ptr)
     }
 #endif
   gtm_thread *tx = gtm_thr();
+#if defined(USE_HTM_FASTPATH)
+  if (unlikely(tx->state & gtm_thread::STATE_HTM))
+    {
+      tx->hybrid_commit();
+      return;
+    }
+#endif
   if (!tx->trycommit ())
     {
       tx->eh_in_flight = exc_ptr;
@@ -97,6 +97,14 @@ class gtm_rwlock
 	|| htm_fastpath.load (memory_order_relaxed) == 0;
   }
 
+  // Returns true iff there is a concurrent active or waiting writer.  Like
+  // htm_fastpath_disabled, this is meant for HW transactions that monitor
+  // the serial lock.
+  bool has_writer ()
+  {
+    return (summary.load (memory_order_relaxed) & (a_writer | w_writer)) != 0;
+  }
+
   // This does not need to return an exact value, hence relaxed MO is
   // sufficient.
   uint32_t get_htm_fastpath ()
@@ -69,6 +69,17 @@ enum gtm_restart_reason
   NO_RESTART = NUM_RESTARTS
 };
 
+// Outcomes of attempts to run a transaction as a HW transaction of the
+// hybrid TM method, counted per thread for statistics.
+enum gtm_htm_outcome
+{
+  HTM_COMMITTED,
+  HTM_ABORTED_RETRY,
+  HTM_ABORTED_PERSISTENT,
+  HTM_FELL_BACK,
+  NUM_HTM_OUTCOMES
+};
+
 } // namespace GTM
 
 #include "target.h"
@@ -194,6 +205,13 @@ struct gtm_thread
   // Read and write logs.  Used by multi-lock TM methods.
   vector<gtm_rwlog_entry> readlog;
   vector<gtm_rwlog_entry> writelog;
+  // A Bloom filter over the orecs in readlog, and the most recent orec time
+  // of the orecs that were acquired without extending the snapshot because
+  // the filter showed that they had not been read.  Used by the ml_wt
+  // method.
+  static const unsigned READLOG_FILTER_WORDS = 4;
+  gtm_word readlog_filter[READLOG_FILTER_WORDS];
+  gtm_word readlog_pending_time;
 
   // Data used by alloc.c for the malloc/free undo log.
   aa_tree<uintptr_t, gtm_alloc_action> alloc_actions;
@@ -218,6 +236,9 @@ struct gtm_thread
   // Implies that no logging is being done, and abort is not possible.
   // Can be reset only when restarting the outermost transaction.
   static const uint32_t STATE_IRREVOCABLE	= 0x0002;
+  // Set if this transaction is a HW transaction of the hybrid method.  This
+  // is only ever set from within the HW transaction, so an abort resets it.
+  static const uint32_t STATE_HTM		= 0x0004;
 
   // A bitmask of the above.
   uint32_t state;
@@ -245,6 +266,7 @@ struct gtm_thread
   // restart_total is also used by the HTM fastpath in a different way.
   uint32_t restart_reason[NUM_RESTARTS];
   uint32_t restart_total;
+  uint32_t htm_outcome[NUM_HTM_OUTCOMES];
 
   // *** The shared part of gtm_thread starts here. ***
   // Shared state is on separate cachelines to avoid false sharing with
@@ -284,6 +306,7 @@ struct gtm_thread
   bool trycommit ();
   void restart (gtm_restart_reason, bool finish_serial_upgrade = false)
         ITM_NORETURN;
+  void hybrid_commit ();
 
   gtm_thread();
   ~gtm_thread();
@@ -343,6 +366,20 @@ extern abi_dispatch *dispatch_serialirr_onwrite();
 extern abi_dispatch *dispatch_gl_wt();
 extern abi_dispatch *dispatch_ml_wt();
 extern abi_dispatch *dispatch_htm();
+extern abi_dispatch *dispatch_hybrid();
+
+// The interface between HW transactions of the hybrid method, which are
+// started in beginend.cc, and its software fallback in method-gl.cc.
+// hybrid_htm_attempts returns how often to try a HW transaction before
+// falling back, or zero if they are disabled.  hybrid_htm_subscribe and
+// hybrid_htm_publish must be called from within the HW transaction, at its
+// start and right before its commit, respectively.
+extern uint32_t hybrid_htm_attempts();
+extern bool hybrid_htm_subscribe();
+extern gtm_word hybrid_htm_publish(bool read_only);
+
+// Set if per-thread statistics should be printed when threads exit.
+extern bool gtm_statistics;
 
 
 } // namespace GTM
@@ -55,6 +55,39 @@ struct gl_mg : public method_group
 
 static gl_mg o_gl_mg;
 
+// The hybrid TM method group.  Transactions first try to run as HW
+// transactions, and fall back to the gl_wt algorithm (see hybrid_dispatch).
+// Both kinds of transactions synchronize through o_gl_mg's orec, so this
+// group shares it with gl_mg; only one of the two groups is active at a time.
+// HW transactions monitor the orec, so they abort as soon as a software
+// transaction acquires it for writing.  Software transactions in turn need
+// to notice commits of HW transactions that overlap with them, so a HW
+// transaction increments the orec if software transactions are active,
+// which is what sw_active tracks.  Otherwise, HW transactions do not touch
+// the orec, and thus do not conflict with each other on it.
+struct hybrid_mg : public method_group
+{
+  // The number of software transactions that are currently active.  HW
+  // transactions load this, so it is on a separate cacheline.
+  atomic<gtm_word> sw_active __attribute__((aligned(HW_CACHELINE_SIZE)));
+  // How often to try a HW transaction before falling back to software.
+  atomic<uint32_t> htm_attempts;
+
+  virtual void init()
+  {
+    o_gl_mg.init();
+#ifdef USE_HTM_FASTPATH
+    htm_attempts.store(htm_init(), memory_order_relaxed);
+#endif
+  }
+  virtual void fini()
+  {
+    htm_attempts.store(0, memory_order_relaxed);
+  }
+};
+
+static hybrid_mg o_hybrid_mg;
+
 
 // The global lock, write-through TM method.
 // Acquires the orec eagerly before the first write, and then writes through.
@@ -358,14 +391,102 @@ public:
 
   gl_wt_dispatch() : abi_dispatch(false, true, false, false, 0, &o_gl_mg)
   { }
+
+protected:
+  gl_wt_dispatch(method_group* mg) :
+    abi_dispatch(false, true, false, false, 0, mg)
+  { }
+};
+
+
+// The software fallback of the hybrid method.  This is gl_wt, except that
+// outermost transactions announce themselves in hybrid_mg::sw_active while
+// they are active.
+class hybrid_dispatch : public gl_wt_dispatch
+{
+public:
+  virtual gtm_restart_reason begin_or_restart()
+  {
+    gtm_restart_reason r = gl_wt_dispatch::begin_or_restart();
+    // Make sure that concurrent HW transactions observe the increment
+    // before we load any data, so that they increment the orec when they
+    // commit.  A HW transaction that has already loaded sw_active will
+    // be aborted by this store.
+    if (r == NO_RESTART && gtm_thr()->parent_txns.size() == 0)
+      o_hybrid_mg.sw_active.fetch_add(1, memory_order_seq_cst);
+    return r;
+  }
+
+  virtual bool trycommit(gtm_word& priv_time)
+  {
+    bool ok = gl_wt_dispatch::trycommit(priv_time);
+    o_hybrid_mg.sw_active.fetch_sub(1, memory_order_release);
+    return ok;
+  }
+
+  virtual void rollback(gtm_transaction_cp *cp)
+  {
+    gl_wt_dispatch::rollback(cp);
+    if (cp == 0)
+      o_hybrid_mg.sw_active.fetch_sub(1, memory_order_release);
+  }
+
+  hybrid_dispatch() : gl_wt_dispatch(&o_hybrid_mg)
+  { }
 };
 
 } // anon namespace
 
 static const gl_wt_dispatch o_gl_wt_dispatch;
+static const hybrid_dispatch o_hybrid_dispatch;
 
 abi_dispatch *
 GTM::dispatch_gl_wt ()
 {
   return const_cast<gl_wt_dispatch *>(&o_gl_wt_dispatch);
 }
+
+abi_dispatch *
+GTM::dispatch_hybrid ()
+{
+  return const_cast<hybrid_dispatch *>(&o_hybrid_dispatch);
+}
+
+uint32_t
+GTM::hybrid_htm_attempts ()
+{
+  return o_hybrid_mg.htm_attempts.load(memory_order_relaxed);
+}
+
+#ifdef USE_HTM_FASTPATH
+bool
+GTM::hybrid_htm_subscribe ()
+{
+  // Adding the orec to the HW transaction's read set aborts it as soon as a
+  // software transaction acquires the orec.  Software writers write through
+  // while they own the orec, so we must not start while it is locked.
+  return !gl_mg::is_locked(o_gl_mg.orec.load(memory_order_relaxed));
+}
+
+gtm_word
+GTM::hybrid_htm_publish (bool read_only)
+{
+  // If there are no active software transactions, there is nobody whose
+  // snapshot we could invalidate.  Software transactions that start later
+  // will abort us because we have sw_active in our read set.
+  if (read_only || o_hybrid_mg.sw_active.load(memory_order_relaxed) == 0)
+    return 0;
+
+  // Let software transactions detect our updates just like they would
+  // detect those of another software transaction.  Leave version number
+  // overflows to the software fallback, which reinitializes the method
+  // group in serial mode.
+  gtm_word v = o_gl_mg.orec.load(memory_order_relaxed);
+  if (v >= gl_mg::VERSION_MAX - 1)
+    htm_abort();
+  o_gl_mg.orec.store(v + 1, memory_order_relaxed);
+  // Like for gl_wt's trycommit, ensure privatization safety for the
+  // software transactions after we have committed.
+  return v + 1;
+}
+#endif
@@ -65,40 +65,56 @@ struct ml_mg : public method_group
   // The shared time base.
   atomic<gtm_word> time __attribute__((aligned(HW_CACHELINE_SIZE)));
 
-  // The array of ownership records.
+  // The array of ownership records, and the number of bits of the hash
+  // that select an orec (see orec_iterator).  Both only change in serial
+  // mode.
   atomic<gtm_word>* orecs __attribute__((aligned(HW_CACHELINE_SIZE)));
-  char tailpadding[HW_CACHELINE_SIZE - sizeof(atomic<gtm_word>*)];
-
-  // Location-to-orec mapping.  Stripes of 32B mapped to 2^16 orecs using
-  // multiplicative hashing.  See Section 5.2.2 of Torvald Riegel's PhD thesis
-  // for the background on this choice of hash function and parameters:
+  gtm_word orecs_bits;
+  char tailpadding[HW_CACHELINE_SIZE - sizeof(atomic<gtm_word>*)
+		   - sizeof(gtm_word)];
+
+  // Set by transactions that restarted often, to request that the next
+  // reinit() grows the orec array to reduce false conflicts.
+  atomic<bool> grow_requested;
+
+  // Location-to-orec mapping.  Stripes of 32B mapped to 2^orecs_bits orecs
+  // using multiplicative hashing.  See Section 5.2.2 of Torvald Riegel's PhD
+  // thesis for the background on this choice of hash function and
+  // parameters:
   // http://nbn-resolving.de/urn:nbn:de:bsz:14-qucosa-115596
   // We pick the Mult32 hash because it works well with fewer orecs (i.e.,
   // less space overhead and just 32b multiplication).
+  // We start with 2^16 orecs.  Large transactions over large data can
+  // suffer from false conflicts with so few orecs, so the array doubles in
+  // size whenever a transaction restarts L2O_GROW_RESTARTS times, up to
+  // 2^L2O_ORECS_BITS_MAX orecs.
   // We may want to check and potentially change these settings once we get
   // better or just more benchmarks.
   static const gtm_word L2O_ORECS_BITS = 16;
-  static const gtm_word L2O_ORECS = 1 << L2O_ORECS_BITS;
+  static const gtm_word L2O_ORECS_BITS_MAX = 20;
+  static const uint32_t L2O_GROW_RESTARTS = 16;
   // An iterator over the orecs covering the region [addr,addr+len).
   struct orec_iterator
   {
     static const gtm_word L2O_SHIFT = 5;
     static const uint32_t L2O_MULT32 = 81007;
     uint32_t mult;
+    uint32_t shift;
     size_t orec;
     size_t orec_end;
-    orec_iterator (const void* addr, size_t len)
+    orec_iterator (const void* addr, size_t len, gtm_word bits)
     {
       uint32_t a = (uintptr_t) addr >> L2O_SHIFT;
       uint32_t ae = ((uintptr_t) addr + len + (1 << L2O_SHIFT) - 1)
 	  >> L2O_SHIFT;
+      shift = 32 - bits;
       mult = a * L2O_MULT32;
-      orec = mult >> (32 - L2O_ORECS_BITS);
+      orec = mult >> shift;
       // We can't really avoid this second multiplication unless we use a
       // branch instead or know more about the alignment of addr.  (We often
       // know len at compile time because of instantiations of functions
       // such as _ITM_RU* for accesses of specific lengths.
-      orec_end = (ae * L2O_MULT32) >> (32 - L2O_ORECS_BITS);
+      orec_end = (ae * L2O_MULT32) >> shift;
     }
     size_t get() { return orec; }
     void advance()
@@ -110,7 +126,7 @@ struct ml_mg : public method_group
       // fourth more orecs than necessary for regions covering more than orec.
       // Keeping mult around as extra state shouldn't matter much.
       mult += L2O_MULT32;
-      orec = mult >> (32 - L2O_ORECS_BITS);
+      orec = mult >> shift;
     }
     bool reached_end() { return orec == orec_end; }
   };
@@ -119,11 +135,13 @@ struct ml_mg : public method_group
   {
     // We assume that an atomic<gtm_word> is backed by just a gtm_word, so
     // starting with zeroed memory is fine.
+    orecs_bits = L2O_ORECS_BITS;
     orecs = (atomic<gtm_word>*) xcalloc(
-        sizeof(atomic<gtm_word>) * L2O_ORECS, true);
+        sizeof(atomic<gtm_word>) << orecs_bits, true);
     // This store is only executed while holding the serial lock, so relaxed
     // memory order is sufficient here.
     time.store(0, memory_order_relaxed);
+    grow_requested.store(false, memory_order_relaxed);
   }
 
   virtual void fini()
@@ -131,18 +149,33 @@ struct ml_mg : public method_group
     free(orecs);
   }
 
-  // We only re-initialize when our time base overflows.  Thus, only reset
-  // the time base and the orecs but do not re-allocate the orec array.
+  // We only re-initialize when our time base overflows or when the orec
+  // array should grow.  Thus, only reset the time base and the orecs but do
+  // not re-allocate the orec array unless we grow it.
   virtual void reinit()
   {
     // This store is only executed while holding the serial lock, so relaxed
-    // memory order is sufficient here.  Same holds for the memset.
+    // memory order is sufficient here.  Same holds for the memset, and for
+    // replacing the orec array: there are no active transactions, and
+    // none of them has any orecs in its logs.
     time.store(0, memory_order_relaxed);
-    // The memset below isn't strictly kosher because it bypasses
-    // the non-trivial assignment operator defined by std::atomic.  Using
-    // a local void* is enough to prevent GCC from warning for this.
-    void *p = orecs;
-    memset(p, 0, sizeof(atomic<gtm_word>) * L2O_ORECS);
+    if (grow_requested.load(memory_order_relaxed)
+	&& orecs_bits < L2O_ORECS_BITS_MAX)
+      {
+	free(orecs);
+	orecs_bits++;
+	orecs = (atomic<gtm_word>*) xcalloc(
+	    sizeof(atomic<gtm_word>) << orecs_bits, true);
+      }
+    else
+      {
+	// The memset below isn't strictly kosher because it bypasses
+	// the non-trivial assignment operator defined by std::atomic.  Using
+	// a local void* is enough to prevent GCC from warning for this.
+	void *p = orecs;
+	memset(p, 0, sizeof(atomic<gtm_word>) << orecs_bits);
+      }
+    grow_requested.store(false, memory_order_relaxed);
   }
 };
 
@@ -168,13 +201,43 @@ static ml_mg o_ml_mg;
 class ml_wt_dispatch : public abi_dispatch
 {
 protected:
+  // The read log filter has one bit per orec index modulo its size.  A clear
+  // bit means that the transaction has definitely not read from this orec.
+  static const size_t FILTER_BITS
+    = gtm_thread::READLOG_FILTER_WORDS * sizeof(gtm_word) * 8;
+
+  static void filter_add(gtm_thread *tx, size_t orec)
+  {
+    orec %= FILTER_BITS;
+    tx->readlog_filter[orec / (sizeof(gtm_word) * 8)]
+      |= (gtm_word) 1 << (orec % (sizeof(gtm_word) * 8));
+  }
+
+  static bool filter_contains(gtm_thread *tx, size_t orec)
+  {
+    orec %= FILTER_BITS;
+    return (tx->readlog_filter[orec / (sizeof(gtm_word) * 8)]
+	    >> (orec % (sizeof(gtm_word) * 8))) & 1;
+  }
+
+  // pre_write() does not extend the snapshot when acquiring orecs that we
+  // have not read from.  Before we read data covered by such orecs, the
+  // snapshot must be at least as recent as these orecs, or we could return
+  // data that is inconsistent with our earlier reads.
+  static void extend_for_pending(gtm_thread *tx)
+  {
+    if (unlikely (tx->readlog_pending_time
+		  > tx->shared_state.load(memory_order_relaxed)))
+      extend(tx);
+  }
+
   static void pre_write(gtm_thread *tx, const void *addr, size_t len)
   {
     gtm_word snapshot = tx->shared_state.load(memory_order_relaxed);
     gtm_word locked_by_tx = ml_mg::set_locked(tx);
 
     // Lock all orecs that cover the region.
-    ml_mg::orec_iterator oi(addr, len);
+    ml_mg::orec_iterator oi(addr, len, o_ml_mg.orecs_bits);
     do
       {
         // Load the orec.  Relaxed memory order is sufficient here because
@@ -196,9 +259,13 @@ protected:
                 // We only need to extend the snapshot if we have indeed read
                 // from this orec before.  Given that we are an update
                 // transaction, we will have to extend anyway during commit.
-                // ??? Scan the read log instead, aborting if we have read
-                // from data covered by this orec before?
-                snapshot = extend(tx);
+                // If the read log filter shows that we have not read from
+                // it, just remember the orec's time so that we extend before
+                // we read from it (see extend_for_pending()).
+                if (filter_contains(tx, oi.get()))
+                  snapshot = extend(tx);
+                else if (ml_mg::get_time(o) > tx->readlog_pending_time)
+                  tx->readlog_pending_time = ml_mg::get_time(o);
               }
 
             // We need acquire memory order here to synchronize with other
@@ -306,7 +373,7 @@ protected:
     gtm_word snapshot = tx->shared_state.load(memory_order_relaxed);
     gtm_word locked_by_tx = ml_mg::set_locked(tx);
 
-    ml_mg::orec_iterator oi(addr, len);
+    ml_mg::orec_iterator oi(addr, len, o_ml_mg.orecs_bits);
     do
       {
         // We need acquire memory order here so that this load will
@@ -322,6 +389,7 @@ protected:
             gtm_rwlog_entry *e = tx->readlog.push();
             e->orec = o_ml_mg.orecs + oi.get();
             e->value = o;
+            filter_add(tx, oi.get());
           }
         else if (!ml_mg::is_locked(o))
           {
@@ -334,9 +402,12 @@ protected:
         else
           {
             // If the orec is locked by us, just skip it because we can just
-            // read from it.  Otherwise, restart the transaction.
+            // read from it once our snapshot covers the time at which we
+            // acquired it.  Otherwise, restart the transaction.
             if (o != locked_by_tx)
               tx->restart(RESTART_LOCKED_READ);
+            if (unlikely (tx->readlog_pending_time > snapshot))
+              snapshot = extend(tx);
           }
         oi.advance();
       }
@@ -379,7 +450,9 @@ protected:
     // break later WaW optimizations.
     if (unlikely(mod == RfW))
       {
-	pre_write(addr, sizeof(V));
+	gtm_thread *tx = gtm_thr();
+	pre_write(tx, addr, sizeof(V));
+	extend_for_pending(tx);
 	return *addr;
       }
     if (unlikely(mod == RaW))
@@ -410,6 +483,15 @@ protected:
     // ??? Retry the whole load if it wasn't consistent?
     post_load(tx, log);
 
+    // Repeated loads from the same stripe (e.g., from several fields of the
+    // same object) would add the same entry again and again.  Drop it if
+    // it is a duplicate of the previous entry so that validation does not
+    // need to check it more than once.
+    size_t n = tx->readlog.size();
+    if (n >= 2 && log == &tx->readlog[n - 1]
+	&& log[-1].orec == log->orec && log[-1].value == log->value)
+      tx->readlog.set_size(n - 1);
+
     return v;
   }
 
@@ -441,6 +523,7 @@ public:
       {
         tx = gtm_thr();
         pre_write(tx, src, size);
+        extend_for_pending(tx);
       }
     else if (src_mod != RaW && src_mod != NONTXNAL)
       {
@@ -495,6 +578,19 @@ public:
     // Re-initialize method group on time overflow.
     if (snapshot >= o_ml_mg.TIME_MAX)
       return RESTART_INIT_METHOD_GROUP;
+    // If we keep restarting, we might suffer from false conflicts because
+    // too many locations map to the same orecs.  Grow the orec array, which
+    // requires re-initializing the method group.  Do this just once per
+    // transaction so that we do not end up in serial mode all the time.
+    if (unlikely (tx->restart_total == o_ml_mg.L2O_GROW_RESTARTS)
+	&& o_ml_mg.orecs_bits < o_ml_mg.L2O_ORECS_BITS_MAX)
+      {
+	o_ml_mg.grow_requested.store(true, memory_order_relaxed);
+	return RESTART_INIT_METHOD_GROUP;
+      }
+
+    ::memset(tx->readlog_filter, 0, sizeof(tx->readlog_filter));
+    tx->readlog_pending_time = 0;
 
     // We don't need to enforce any ordering for the following store. There
     // are no earlier data loads in this transaction, so the store cannot
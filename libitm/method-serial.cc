@@ -294,6 +294,9 @@ GTM::gtm_thread::serialirr_mode ()
   // continue.  See gtm_thread::begin_transaction.
   if (likely(!gtm_thread::serial_lock.htm_fastpath_disabled()))
     return;
+  // Likewise for HW transactions of the hybrid method.
+  if (this->state & STATE_HTM)
+    return;
 #endif
 
   if (this->state & STATE_SERIAL)
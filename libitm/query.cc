@@ -73,6 +73,11 @@ _ITM_getTransactionId (void)
     htm_abort();
 #endif
   struct gtm_thread *tx = gtm_thr();
+#if defined(USE_HTM_FASTPATH)
+  // HW transactions of the hybrid method do not get an ID.
+  if (tx && (tx->state & gtm_thread::STATE_HTM))
+    htm_abort();
+#endif
   return (tx && (tx->nesting > 0)) ? tx->id : _ITM_noTransactionId;
 }
 
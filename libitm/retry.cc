@@ -39,6 +39,8 @@
 static std::atomic<GTM::abi_dispatch*> default_dispatch;
 // The default TM method as requested by the user, if any.
 static GTM::abi_dispatch* default_dispatch_user = 0;
+// Set if ITM_STATISTICS is set in the environment.
+bool GTM::gtm_statistics = false;
 
 void
 GTM::gtm_thread::decide_retry_strategy (gtm_restart_reason r)
@@ -244,6 +246,11 @@ parse_default_method()
       disp = GTM::dispatch_serial();
       env += 6;
     }
+  else if (strncmp(env, "hybrid", 6) == 0)
+    {
+      disp = GTM::dispatch_hybrid();
+      env += 6;
+    }
   else if (strncmp(env, "gl_wt", 5) == 0)
     {
       disp = GTM::dispatch_gl_wt();
@@ -290,6 +297,7 @@ GTM::gtm_thread::number_of_threads_changed(unsigned previous, unsigned now)
 	  // Check for user preferences here.
 	  default_dispatch = 0;
 	  default_dispatch_user = parse_default_method();
+	  gtm_statistics = getenv("ITM_STATISTICS") != NULL;
 	}
     }
   else if (now == 0)
@@ -0,0 +1,59 @@
+/* { dg-do run } */
+/* { dg-options "-pthread" } */
+
+/* Check that transactions of the hybrid method synchronize correctly with
+   each other, whether they run as HW transactions or in software.  */
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#define NTHREADS 4
+#define NACCOUNTS 16
+#define ITERS 20000
+
+static int accounts[NACCOUNTS];
+static int counter;
+
+static void *
+thread (void *arg)
+{
+  unsigned int seed = (unsigned long) arg;
+  int i;
+
+  for (i = 0; i < ITERS; i++)
+    {
+      int from = rand_r (&seed) % NACCOUNTS;
+      int to = rand_r (&seed) % NACCOUNTS;
+      int sum = 0, j;
+
+      __transaction_atomic {
+	accounts[from]--;
+	accounts[to]++;
+	counter++;
+      }
+      __transaction_atomic {
+	for (j = 0; j < NACCOUNTS; j++)
+	  sum += accounts[j];
+      }
+      if (sum != 0)
+	abort ();
+    }
+  return 0;
+}
+
+int
+main ()
+{
+  pthread_t pt[NTHREADS];
+  int i;
+
+  setenv ("ITM_DEFAULT_METHOD", "hybrid", 1);
+  for (i = 0; i < NTHREADS; i++)
+    pthread_create (&pt[i], NULL, thread, (void *) (unsigned long) (i + 1));
+  for (i = 0; i < NTHREADS; i++)
+    pthread_join (pt[i], NULL);
+
+  if (counter != NTHREADS * ITERS)
+    abort ();
+  return 0;
+}
@@ -0,0 +1,101 @@
+/* { dg-do run } */
+/* { dg-options "-pthread" } */
+
+/* Check that the ml_wt method keeps a hash table consistent when
+   transactions read and write many locations, and when they keep
+   restarting because of conflicts.  */
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#define NTHREADS 4
+#define NBUCKETS 4096
+#define NKEYS 256
+#define ITERS 5000
+
+struct node
+{
+  int key;
+  int value;
+  struct node *next;
+};
+
+static struct node *buckets[NBUCKETS];
+static struct node nodes[NKEYS];
+static int total;
+
+static int
+lookup (int key)
+{
+  struct node *n;
+  __transaction_atomic {
+    for (n = buckets[(key * 61) % NBUCKETS]; n != 0; n = n->next)
+      if (n->key == key)
+	return n->value;
+  }
+  return -1;
+}
+
+static void *
+thread (void *arg)
+{
+  unsigned int seed = (unsigned long) arg;
+  int i;
+
+  for (i = 0; i < ITERS; i++)
+    {
+      int from = rand_r (&seed) % NKEYS;
+      int to = rand_r (&seed) % NKEYS;
+      int sum = 0, j;
+
+      __transaction_atomic {
+	struct node *a, *b;
+	for (a = buckets[(from * 61) % NBUCKETS]; a->key != from; a = a->next)
+	  ;
+	for (b = buckets[(to * 61) % NBUCKETS]; b->key != to; b = b->next)
+	  ;
+	a->value--;
+	b->value++;
+	total++;
+      }
+      if (i % 64 == 0)
+	{
+	  __transaction_atomic {
+	    for (j = 0; j < NKEYS; j++)
+	      sum += nodes[j].value;
+	  }
+	  if (sum != NKEYS)
+	    abort ();
+	}
+    }
+  return 0;
+}
+
+int
+main ()
+{
+  pthread_t pt[NTHREADS];
+  int i;
+
+  setenv ("ITM_DEFAULT_METHOD", "ml_wt", 1);
+  for (i = 0; i < NKEYS; i++)
+    {
+      int b = (i * 61) % NBUCKETS;
+      nodes[i].key = i;
+      nodes[i].value = 1;
+      nodes[i].next = buckets[b];
+      buckets[b] = &nodes[i];
+    }
+
+  for (i = 0; i < NTHREADS; i++)
+    pthread_create (&pt[i], NULL, thread, (void *) (unsigned long) (i + 1));
+  for (i = 0; i < NTHREADS; i++)
+    pthread_join (pt[i], NULL);
+
+  if (total != NTHREADS * ITERS)
+    abort ();
+  for (i = 0; i < NKEYS; i++)
+    if (lookup (i) != nodes[i].value)
+      abort ();
+  return 0;
+}
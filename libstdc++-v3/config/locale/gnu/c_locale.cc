@@ -37,6 +37,14 @@
 
 #include <backward/auto_ptr.h>
 
+namespace __gnu_internal _GLIBCXX_VISIBILITY(hidden)
+{
+  // Defined in src/c++17/floating_from_chars.cc, true if __s is entirely
+  // a number in the range of the type.
+  bool convert_from_chars_c(const char*, float&) throw();
+  bool convert_from_chars_c(const char*, double&) throw();
+}
+
 namespace std _GLIBCXX_VISIBILITY(default)
 {
 _GLIBCXX_BEGIN_NAMESPACE_VERSION
@@ -46,6 +54,11 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     __convert_to_v(const char* __s, float& __v, ios_base::iostate& __err,
 		   const __c_locale& __cloc) throw()
     {
+      // The string is always in the "C" locale, so the common case of a
+      // valid number in range can be done without strtof_l.
+      if (__gnu_internal::convert_from_chars_c(__s, __v))
+	return;
+
       char* __sanity;
       __v = __strtof_l(__s, &__sanity, __cloc);
 
@@ -73,6 +86,11 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     __convert_to_v(const char* __s, double& __v, ios_base::iostate& __err,
 		   const __c_locale& __cloc) throw()
     {
+      // The string is always in the "C" locale, so the common case of a
+      // valid number in range can be done without strtod_l.
+      if (__gnu_internal::convert_from_chars_c(__s, __v))
+	return;
+
       char* __sanity;
       __v = __strtod_l(__s, &__sanity, __cloc);
 
@@ -36,6 +36,7 @@
 #include <stdint.h>
 #include <bits/atomic_lockfree_defines.h>
 #include <bits/move.h>
+#include <bits/atomic_wait.h>
 
 #ifndef _GLIBCXX_ALWAYS_INLINE
 #define _GLIBCXX_ALWAYS_INLINE inline __attribute__((__always_inline__))
@@ -224,6 +225,24 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       __atomic_clear (&_M_i, int(__m));
     }
 
+#ifdef __cpp_lib_atomic_wait
+    void
+    wait(bool __old, memory_order __m = memory_order_seq_cst) const noexcept
+    {
+      const __atomic_flag_data_type __v = _S_init(__old);
+      std::__atomic_wait_address_v(&_M_i, __v,
+	  [__m, this] { return __atomic_load_n(&_M_i, int(__m)); });
+    }
+
+    void
+    notify_one() noexcept
+    { std::__atomic_notify_address(&_M_i, false); }
+
+    void
+    notify_all() noexcept
+    { std::__atomic_notify_address(&_M_i, true); }
+#endif // __cpp_lib_atomic_wait
+
   private:
     static constexpr __atomic_flag_data_type
     _S_init(bool __i)
@@ -430,6 +449,24 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	return __atomic_load_n(&_M_i, int(__m));
       }
 
+#ifdef __cpp_lib_atomic_wait
+      void
+      wait(__int_type __old,
+	   memory_order __m = memory_order_seq_cst) const noexcept
+      {
+	std::__atomic_wait_address_v(&_M_i, __old,
+	    [__m, this] { return this->load(__m); });
+      }
+
+      void
+      notify_one() noexcept
+      { std::__atomic_notify_address(&_M_i, false); }
+
+      void
+      notify_all() noexcept
+      { std::__atomic_notify_address(&_M_i, true); }
+#endif // __cpp_lib_atomic_wait
+
       _GLIBCXX_ALWAYS_INLINE __int_type
       exchange(__int_type __i,
 	       memory_order __m = memory_order_seq_cst) noexcept
@@ -751,6 +788,24 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	return __atomic_load_n(&_M_p, int(__m));
       }
 
+#ifdef __cpp_lib_atomic_wait
+      void
+      wait(__pointer_type __old,
+	   memory_order __m = memory_order_seq_cst) const noexcept
+      {
+	std::__atomic_wait_address_v(&_M_p, __old,
+	    [__m, this] { return this->load(__m); });
+      }
+
+      void
+      notify_one() noexcept
+      { std::__atomic_notify_address(&_M_p, false); }
+
+      void
+      notify_all() noexcept
+      { std::__atomic_notify_address(&_M_p, true); }
+#endif // __cpp_lib_atomic_wait
+
       _GLIBCXX_ALWAYS_INLINE __pointer_type
       exchange(__pointer_type __p,
 	       memory_order __m = memory_order_seq_cst) noexcept
@@ -844,11 +899,11 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       { __atomic_store(__ptr, std::__addressof(__t), int(__m)); }
 
     template<typename _Tp>
-      _GLIBCXX_ALWAYS_INLINE _Tp
-      load(_Tp* __ptr, memory_order __m) noexcept
+      _GLIBCXX_ALWAYS_INLINE _Val<_Tp>
+      load(const _Tp* __ptr, memory_order __m) noexcept
       {
 	alignas(_Tp) unsigned char __buf[sizeof(_Tp)];
-	_Tp* __dest = reinterpret_cast<_Tp*>(__buf);
+	auto* __dest = reinterpret_cast<_Val<_Tp>*>(__buf);
 	__atomic_load(__ptr, __dest, int(__m));
 	return *__dest;
       }
@@ -1049,6 +1104,23 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       load(memory_order __m = memory_order_seq_cst) const noexcept
       { return __atomic_impl::load(&_M_fp, __m); }
 
+#ifdef __cpp_lib_atomic_wait
+      void
+      wait(_Fp __old, memory_order __m = memory_order_seq_cst) const noexcept
+      {
+	std::__atomic_wait_address_v(&_M_fp, __old,
+	    [__m, this] { return this->load(__m); });
+      }
+
+      void
+      notify_one() noexcept
+      { std::__atomic_notify_address(&_M_fp, false); }
+
+      void
+      notify_all() noexcept
+      { std::__atomic_notify_address(&_M_fp, true); }
+#endif // __cpp_lib_atomic_wait
+
       operator _Fp() const volatile noexcept { return this->load(); }
       operator _Fp() const noexcept { return this->load(); }
 
@@ -1231,6 +1303,23 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       load(memory_order __m = memory_order_seq_cst) const noexcept
       { return __atomic_impl::load(_M_ptr, __m); }
 
+#ifdef __cpp_lib_atomic_wait
+      void
+      wait(_Tp __old, memory_order __m = memory_order_seq_cst) const noexcept
+      {
+	std::__atomic_wait_address_v(_M_ptr, __old,
+	    [__m, this] { return this->load(__m); });
+      }
+
+      void
+      notify_one() const noexcept
+      { std::__atomic_notify_address(_M_ptr, false); }
+
+      void
+      notify_all() const noexcept
+      { std::__atomic_notify_address(_M_ptr, true); }
+#endif // __cpp_lib_atomic_wait
+
       _Tp
       exchange(_Tp __desired, memory_order __m = memory_order_seq_cst)
       const noexcept
@@ -1326,6 +1415,23 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       load(memory_order __m = memory_order_seq_cst) const noexcept
       { return __atomic_impl::load(_M_ptr, __m); }
 
+#ifdef __cpp_lib_atomic_wait
+      void
+      wait(_Tp __old, memory_order __m = memory_order_seq_cst) const noexcept
+      {
+	std::__atomic_wait_address_v(_M_ptr, __old,
+	    [__m, this] { return this->load(__m); });
+      }
+
+      void
+      notify_one() const noexcept
+      { std::__atomic_notify_address(_M_ptr, false); }
+
+      void
+      notify_all() const noexcept
+      { std::__atomic_notify_address(_M_ptr, true); }
+#endif // __cpp_lib_atomic_wait
+
       _Tp
       exchange(_Tp __desired,
 	       memory_order __m = memory_order_seq_cst) const noexcept
@@ -1481,6 +1587,23 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       load(memory_order __m = memory_order_seq_cst) const noexcept
       { return __atomic_impl::load(_M_ptr, __m); }
 
+#ifdef __cpp_lib_atomic_wait
+      void
+      wait(_Fp __old, memory_order __m = memory_order_seq_cst) const noexcept
+      {
+	std::__atomic_wait_address_v(_M_ptr, __old,
+	    [__m, this] { return this->load(__m); });
+      }
+
+      void
+      notify_one() const noexcept
+      { std::__atomic_notify_address(_M_ptr, false); }
+
+      void
+      notify_all() const noexcept
+      { std::__atomic_notify_address(_M_ptr, true); }
+#endif // __cpp_lib_atomic_wait
+
       _Fp
       exchange(_Fp __desired,
 	       memory_order __m = memory_order_seq_cst) const noexcept
@@ -1590,6 +1713,23 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       load(memory_order __m = memory_order_seq_cst) const noexcept
       { return __atomic_impl::load(_M_ptr, __m); }
 
+#ifdef __cpp_lib_atomic_wait
+      void
+      wait(_Tp* __old, memory_order __m = memory_order_seq_cst) const noexcept
+      {
+	std::__atomic_wait_address_v(_M_ptr, __old,
+	    [__m, this] { return this->load(__m); });
+      }
+
+      void
+      notify_one() const noexcept
+      { std::__atomic_notify_address(_M_ptr, false); }
+
+      void
+      notify_all() const noexcept
+      { std::__atomic_notify_address(_M_ptr, true); }
+#endif // __cpp_lib_atomic_wait
+
       _Tp*
       exchange(_Tp* __desired,
 	       memory_order __m = memory_order_seq_cst) const noexcept
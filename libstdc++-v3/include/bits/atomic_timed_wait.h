@@ -0,0 +1,133 @@
+// -*- C++ -*- header.
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file bits/atomic_timed_wait.h
+ *  This is an internal header file, included by other library headers.
+ *  Do not attempt to use it directly. @headername{semaphore}
+ */
+
+#ifndef _GLIBCXX_ATOMIC_TIMED_WAIT_H
+#define _GLIBCXX_ATOMIC_TIMED_WAIT_H 1
+
+#pragma GCC system_header
+
+#include <bits/atomic_base.h>
+
+#ifdef __cpp_lib_atomic_wait
+#include <chrono>
+
+namespace std _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  namespace __detail
+  {
+    // As __waiter::_M_do_wait, but give up after __rtime.
+    inline void
+    __platform_wait_for(__waiter& __w [[maybe_unused]],
+			const __platform_wait_t* __addr,
+			__platform_wait_t __val,
+			chrono::nanoseconds __rtime) noexcept
+    {
+      auto __s = chrono::duration_cast<chrono::seconds>(__rtime);
+      auto __ns = chrono::duration_cast<chrono::nanoseconds>(__rtime - __s);
+#ifdef _GLIBCXX_HAVE_LINUX_FUTEX
+      struct timespec __rt =
+	{
+	  static_cast<std::time_t>(__s.count()),
+	  static_cast<long>(__ns.count())
+	};
+      ::syscall(SYS_futex, __addr, __futex_wait_private, __val, &__rt);
+#else
+      auto __now = chrono::system_clock::now().time_since_epoch();
+      auto __now_s = chrono::duration_cast<chrono::seconds>(__now);
+      auto __now_ns = chrono::duration_cast<chrono::nanoseconds>(__now
+								 - __now_s);
+      __gthread_time_t __ts =
+	{
+	  static_cast<std::time_t>(__now_s.count() + __s.count()),
+	  static_cast<long>(__now_ns.count() + __ns.count())
+	};
+      if (__ts.tv_nsec >= 1000000000)
+	{
+	  __ts.tv_nsec -= 1000000000;
+	  ++__ts.tv_sec;
+	}
+      __gthread_mutex_lock(&__w._M_mtx);
+      if (__atomic_load_n(__addr, __ATOMIC_RELAXED) == __val)
+	__gthread_cond_timedwait(&__w._M_cv, &__w._M_mtx, &__ts);
+      __gthread_mutex_unlock(&__w._M_mtx);
+#endif
+    }
+  } // namespace __detail
+
+  // As __atomic_wait_address_v, but return false if __vfn() is still
+  // equal to __old at __atime.
+  template<typename _Tp, typename _ValFn, typename _Clock, typename _Dur>
+    bool
+    __atomic_wait_address_until_v(const _Tp* __addr, _Tp __old, _ValFn __vfn,
+			const chrono::time_point<_Clock, _Dur>& __atime)
+    noexcept
+    {
+      auto __pred = [&] { return !__detail::__atomic_compare(__old, __vfn()); };
+      if (__detail::__atomic_spin(__pred))
+	return true;
+
+      auto& __w = __detail::__waiter::_S_for(__addr);
+      __atomic_fetch_add(&__w._M_wait, 1, __ATOMIC_SEQ_CST);
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+      bool __res;
+      while (!(__res = __pred()))
+	{
+	  const auto __rtime = __atime - _Clock::now();
+	  if (__rtime <= __rtime.zero())
+	    break;
+	  // Wake at least once a day, to avoid overflowing nanoseconds.
+	  const auto __ns = __rtime < chrono::hours(24)
+	    ? chrono::ceil<chrono::nanoseconds>(__rtime)
+	    : chrono::nanoseconds(chrono::hours(24));
+	  if constexpr (__detail::__platform_wait_uses_type<_Tp>)
+	    {
+	      __detail::__platform_wait_t __val;
+	      __builtin_memcpy(&__val, std::__addressof(__old), sizeof(__val));
+	      __detail::__platform_wait_for(__w,
+		reinterpret_cast<const __detail::__platform_wait_t*>(__addr),
+		__val, __ns);
+	    }
+	  else
+	    {
+	      auto __ver = __atomic_load_n(&__w._M_ver, __ATOMIC_ACQUIRE);
+	      if ((__res = __pred()))
+		break;
+	      __detail::__platform_wait_for(__w, &__w._M_ver, __ver, __ns);
+	    }
+	}
+      __atomic_fetch_sub(&__w._M_wait, 1, __ATOMIC_RELEASE);
+      return __res;
+    }
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace std
+#endif // __cpp_lib_atomic_wait
+#endif // _GLIBCXX_ATOMIC_TIMED_WAIT_H
@@ -0,0 +1,236 @@
+// -*- C++ -*- header.
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file bits/atomic_wait.h
+ *  This is an internal header file, included by other library headers.
+ *  Do not attempt to use it directly. @headername{atomic}
+ */
+
+#ifndef _GLIBCXX_ATOMIC_WAIT_H
+#define _GLIBCXX_ATOMIC_WAIT_H 1
+
+#pragma GCC system_header
+
+#include <bits/c++config.h>
+
+#if __cplusplus > 201703L && defined _GLIBCXX_HAS_GTHREADS
+#include <bits/gthr.h>
+#include <bits/move.h>
+
+#ifdef _GLIBCXX_HAVE_LINUX_FUTEX
+# include <syscall.h>
+# include <unistd.h>
+# define __cpp_lib_atomic_wait 201907L
+#elif defined __GTHREAD_MUTEX_INIT && defined __GTHREAD_COND_INIT
+# define __cpp_lib_atomic_wait 201907L
+#endif
+
+#ifdef __cpp_lib_atomic_wait
+namespace std _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  // Waiting on an atomic object spins briefly, then blocks on a futex.
+  // A 32-bit object is its own futex word.  Any other object is waited
+  // on through the version counter of an entry in a small table indexed
+  // by the object's address, and every notification for an address that
+  // hashes to that entry wakes all of its waiters.  Each table entry also
+  // counts its waiters, so that notifying when nobody is blocked costs a
+  // fence and a load instead of a system call.
+  //
+  // Without futexes every object uses the table, and each entry blocks
+  // waiters on its own mutex and condition variable.
+  namespace __detail
+  {
+    using __platform_wait_t = int;
+
+#ifdef _GLIBCXX_HAVE_LINUX_FUTEX
+    // FUTEX_WAIT_PRIVATE and FUTEX_WAKE_PRIVATE.
+    constexpr int __futex_wait_private = 128;
+    constexpr int __futex_wake_private = 129;
+#endif
+
+    // True if waiting on a _Tp can block on the object itself.
+    template<typename _Tp>
+      inline constexpr bool __platform_wait_uses_type
+#ifdef _GLIBCXX_HAVE_LINUX_FUTEX
+	= sizeof(_Tp) == sizeof(__platform_wait_t)
+	  && alignof(_Tp) >= alignof(__platform_wait_t);
+#else
+	= false;
+#endif
+
+    // Number of times to check the value before blocking, and how many of
+    // those checks are separated by a pause rather than by a yield.
+    constexpr int __atomic_spin_count_relax = 12;
+    constexpr int __atomic_spin_count = 16;
+
+    inline void
+    __thread_relax() noexcept
+    {
+#if defined __i386__ || defined __x86_64__
+      __builtin_ia32_pause();
+#else
+      __gthread_yield();
+#endif
+    }
+
+    template<typename _Pred>
+      bool
+      __atomic_spin(_Pred& __pred) noexcept
+      {
+	for (int __i = 0; __i < __atomic_spin_count; ++__i)
+	  {
+	    if (__pred())
+	      return true;
+	    if (__i < __atomic_spin_count_relax)
+	      __detail::__thread_relax();
+	    else
+	      __gthread_yield();
+	  }
+	return false;
+      }
+
+    template<typename _Tp>
+      inline bool
+      __atomic_compare(const _Tp& __a, const _Tp& __b) noexcept
+      {
+	return __builtin_memcmp(std::__addressof(__a), std::__addressof(__b),
+				sizeof(_Tp)) == 0;
+      }
+
+    struct __waiter
+    {
+      // Threads blocked, or about to block, on any address in this entry.
+      alignas(64) __platform_wait_t _M_wait = 0;
+      // Incremented by every notification of an address in this entry.
+      __platform_wait_t _M_ver = 0;
+#ifndef _GLIBCXX_HAVE_LINUX_FUTEX
+      __gthread_mutex_t _M_mtx = __GTHREAD_MUTEX_INIT;
+      __gthread_cond_t _M_cv = __GTHREAD_COND_INIT;
+#endif
+
+      // Block until *__addr might no longer be equal to __val.
+      void
+      _M_do_wait(const __platform_wait_t* __addr,
+		 __platform_wait_t __val) noexcept
+      {
+#ifdef _GLIBCXX_HAVE_LINUX_FUTEX
+	// EINTR and EAGAIN are spurious wake-ups, the caller checks again.
+	::syscall(SYS_futex, __addr, __futex_wait_private, __val, nullptr);
+#else
+	__gthread_mutex_lock(&_M_mtx);
+	while (__atomic_load_n(__addr, __ATOMIC_RELAXED) == __val)
+	  __gthread_cond_wait(&_M_cv, &_M_mtx);
+	__gthread_mutex_unlock(&_M_mtx);
+#endif
+      }
+
+      void
+      _M_do_notify(const __platform_wait_t* __addr, bool __all) noexcept
+      {
+#ifdef _GLIBCXX_HAVE_LINUX_FUTEX
+	::syscall(SYS_futex, __addr, __futex_wake_private,
+		  __all ? __INT_MAX__ : 1);
+#else
+	// Taking the mutex means that a waiter which saw the old version
+	// is already blocked on the condition variable.
+	__gthread_mutex_lock(&_M_mtx);
+	__gthread_mutex_unlock(&_M_mtx);
+	__gthread_cond_broadcast(&_M_cv);
+#endif
+      }
+
+      static __waiter&
+      _S_for(const void* __addr) noexcept
+      {
+	constexpr __UINTPTR_TYPE__ __ct = 16;
+	static __waiter __w[__ct];
+	auto __key = (reinterpret_cast<__UINTPTR_TYPE__>(__addr) >> 2) % __ct;
+	return __w[__key];
+      }
+    };
+  } // namespace __detail
+
+  // Return when __vfn() is no longer equal to __old and a notification
+  // for __addr has been made, or spuriously after a notification.
+  template<typename _Tp, typename _ValFn>
+    void
+    __atomic_wait_address_v(const _Tp* __addr, _Tp __old,
+			    _ValFn __vfn) noexcept
+    {
+      auto __pred = [&] { return !__detail::__atomic_compare(__old, __vfn()); };
+      if (__detail::__atomic_spin(__pred))
+	return;
+
+      auto& __w = __detail::__waiter::_S_for(__addr);
+      __atomic_fetch_add(&__w._M_wait, 1, __ATOMIC_SEQ_CST);
+      // Pairs with the fence in __atomic_notify_address.
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+      while (!__pred())
+	{
+	  if constexpr (__detail::__platform_wait_uses_type<_Tp>)
+	    {
+	      __detail::__platform_wait_t __val;
+	      __builtin_memcpy(&__val, std::__addressof(__old), sizeof(__val));
+	      __w._M_do_wait(
+		reinterpret_cast<const __detail::__platform_wait_t*>(__addr),
+		__val);
+	    }
+	  else
+	    {
+	      auto __ver = __atomic_load_n(&__w._M_ver, __ATOMIC_ACQUIRE);
+	      if (__pred())
+		break;
+	      __w._M_do_wait(&__w._M_ver, __ver);
+	    }
+	}
+      __atomic_fetch_sub(&__w._M_wait, 1, __ATOMIC_RELEASE);
+    }
+
+  template<typename _Tp>
+    void
+    __atomic_notify_address(const _Tp* __addr, bool __all) noexcept
+    {
+      auto& __w = __detail::__waiter::_S_for(__addr);
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+      if (__atomic_load_n(&__w._M_wait, __ATOMIC_RELAXED) == 0)
+	return;
+
+      if constexpr (__detail::__platform_wait_uses_type<_Tp>)
+	__w._M_do_notify(
+	  reinterpret_cast<const __detail::__platform_wait_t*>(__addr), __all);
+      else
+	{
+	  // Other addresses share the counter, so every waiter must wake.
+	  __atomic_fetch_add(&__w._M_ver, 1, __ATOMIC_SEQ_CST);
+	  __w._M_do_notify(&__w._M_ver, true);
+	}
+    }
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace std
+#endif // __cpp_lib_atomic_wait
+#endif // C++20 && _GLIBCXX_HAS_GTHREADS
+#endif // _GLIBCXX_ATOMIC_WAIT_H
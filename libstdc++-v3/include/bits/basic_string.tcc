@@ -1286,6 +1286,115 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       return npos;
     }
 
+  /**
+   *  Lookup table for the characters of a set, used by the find_*_of
+   *  members of basic_string<char>.  Building it costs one pass over the
+   *  set, after which each character of the string is tested with a
+   *  single load instead of a search of the whole set.
+   */
+  struct __str_char_set
+  {
+    unsigned char _M_bits[(1 << __CHAR_BIT__) / __CHAR_BIT__];
+
+    __str_char_set(const char* __s, size_t __n) _GLIBCXX_NOEXCEPT
+    {
+      __builtin_memset(_M_bits, 0, sizeof(_M_bits));
+      for (; __n; --__n, ++__s)
+	{
+	  const unsigned char __c = *__s;
+	  _M_bits[__c / __CHAR_BIT__] |= 1 << (__c % __CHAR_BIT__);
+	}
+    }
+
+    bool
+    _M_test(char __ch) const _GLIBCXX_NOEXCEPT
+    {
+      const unsigned char __c = __ch;
+      return _M_bits[__c / __CHAR_BIT__] & (1 << (__c % __CHAR_BIT__));
+    }
+  };
+
+  // Search a string for a character that is (__in) or is not (!__in) in
+  // the set [__s, __s + __n), from __pos forwards or from __pos backwards.
+  // The generic version looks each character up in the set with
+  // _Traits::find.
+  template<typename _Traits>
+    struct __str_find_of
+    {
+      typedef typename _Traits::char_type _CharT;
+
+      static size_t
+      _S_first(const _CharT* __data, size_t __pos, size_t __size,
+	       const _CharT* __s, size_t __n, bool __in) _GLIBCXX_NOEXCEPT
+      {
+	for (; __pos < __size; ++__pos)
+	  if ((_Traits::find(__s, __n, __data[__pos]) != 0) == __in)
+	    return __pos;
+	return size_t(-1);
+      }
+
+      static size_t
+      _S_last(const _CharT* __data, size_t __pos,
+	      const _CharT* __s, size_t __n, bool __in) _GLIBCXX_NOEXCEPT
+      {
+	do
+	  if ((_Traits::find(__s, __n, __data[__pos]) != 0) == __in)
+	    return __pos;
+	while (__pos-- != 0);
+	return size_t(-1);
+      }
+    };
+
+  // char_traits<char>::eq is plain equality of the characters, so a set
+  // of more than a couple of characters can be tested with a table.
+  template<>
+    struct __str_find_of<char_traits<char> >
+    {
+      // Sets this small are cheaper to search with memchr than to
+      // copy into a table.
+      enum { _S_small_set = 2 };
+
+      static size_t
+      _S_first(const char* __data, size_t __pos, size_t __size,
+	       const char* __s, size_t __n, bool __in) _GLIBCXX_NOEXCEPT
+      {
+	if (__n <= _S_small_set || __pos + 1 >= __size)
+	  {
+	    for (; __pos < __size; ++__pos)
+	      if ((char_traits<char>::find(__s, __n, __data[__pos]) != 0)
+		  == __in)
+		return __pos;
+	    return size_t(-1);
+	  }
+	const __str_char_set __set(__s, __n);
+	for (; __pos < __size; ++__pos)
+	  if (__set._M_test(__data[__pos]) == __in)
+	    return __pos;
+	return size_t(-1);
+      }
+
+      static size_t
+      _S_last(const char* __data, size_t __pos,
+	      const char* __s, size_t __n, bool __in) _GLIBCXX_NOEXCEPT
+      {
+	if (__n <= _S_small_set || __pos == 0)
+	  {
+	    do
+	      if ((char_traits<char>::find(__s, __n, __data[__pos]) != 0)
+		  == __in)
+		return __pos;
+	    while (__pos-- != 0);
+	    return size_t(-1);
+	  }
+	const __str_char_set __set(__s, __n);
+	do
+	  if (__set._M_test(__data[__pos]) == __in)
+	    return __pos;
+	while (__pos-- != 0);
+	return size_t(-1);
+      }
+    };
+
   template<typename _CharT, typename _Traits, typename _Alloc>
     typename basic_string<_CharT, _Traits, _Alloc>::size_type
     basic_string<_CharT, _Traits, _Alloc>::
@@ -1293,13 +1402,10 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     _GLIBCXX_NOEXCEPT
     {
       __glibcxx_requires_string_len(__s, __n);
-      for (; __n && __pos < this->size(); ++__pos)
-	{
-	  const _CharT* __p = traits_type::find(__s, __n, _M_data()[__pos]);
-	  if (__p)
-	    return __pos;
-	}
-      return npos;
+      if (__n == 0)
+	return npos;
+      return __str_find_of<_Traits>::_S_first(_M_data(), __pos, this->size(),
+					      __s, __n, true);
     }
 
   template<typename _CharT, typename _Traits, typename _Alloc>
@@ -1314,12 +1420,8 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	{
 	  if (--__size > __pos)
 	    __size = __pos;
-	  do
-	    {
-	      if (traits_type::find(__s, __n, _M_data()[__size]))
-		return __size;
-	    }
-	  while (__size-- != 0);
+	  return __str_find_of<_Traits>::_S_last(_M_data(), __size,
+						 __s, __n, true);
 	}
       return npos;
     }
@@ -1331,10 +1433,8 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     _GLIBCXX_NOEXCEPT
     {
       __glibcxx_requires_string_len(__s, __n);
-      for (; __pos < this->size(); ++__pos)
-	if (!traits_type::find(__s, __n, _M_data()[__pos]))
-	  return __pos;
-      return npos;
+      return __str_find_of<_Traits>::_S_first(_M_data(), __pos, this->size(),
+					      __s, __n, false);
     }
 
   template<typename _CharT, typename _Traits, typename _Alloc>
@@ -1360,12 +1460,8 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	{
 	  if (--__size > __pos)
 	    __size = __pos;
-	  do
-	    {
-	      if (!traits_type::find(__s, __n, _M_data()[__size]))
-		return __size;
-	    }
-	  while (__size--);
+	  return __str_find_of<_Traits>::_S_last(_M_data(), __size,
+						 __s, __n, false);
 	}
       return npos;
     }
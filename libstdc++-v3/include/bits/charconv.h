@@ -100,6 +100,54 @@ namespace __detail
     }
 
 } // namespace __detail
+
+#if __cplusplus > 201402L
+  // Floating-point std::to_chars and std::from_chars, defined in the
+  // library.  The result types and chars_format are defined in <charconv>.
+  struct to_chars_result;
+  struct from_chars_result;
+  enum class chars_format;
+
+  to_chars_result to_chars(char* __first, char* __last, float __value)
+    noexcept;
+  to_chars_result to_chars(char* __first, char* __last, float __value,
+			   chars_format __fmt) noexcept;
+  to_chars_result to_chars(char* __first, char* __last, float __value,
+			   chars_format __fmt, int __precision) noexcept;
+
+  to_chars_result to_chars(char* __first, char* __last, double __value)
+    noexcept;
+  to_chars_result to_chars(char* __first, char* __last, double __value,
+			   chars_format __fmt) noexcept;
+  to_chars_result to_chars(char* __first, char* __last, double __value,
+			   chars_format __fmt, int __precision) noexcept;
+
+  to_chars_result to_chars(char* __first, char* __last, long double __value)
+    noexcept;
+  to_chars_result to_chars(char* __first, char* __last, long double __value,
+			   chars_format __fmt) noexcept;
+  to_chars_result to_chars(char* __first, char* __last, long double __value,
+			   chars_format __fmt, int __precision) noexcept;
+
+  // chars_format::general cannot be named here, so the default argument
+  // of the standard signatures is provided by separate overloads.
+  from_chars_result from_chars(const char* __first, const char* __last,
+			       float& __value) noexcept;
+  from_chars_result from_chars(const char* __first, const char* __last,
+			       float& __value, chars_format __fmt) noexcept;
+
+  from_chars_result from_chars(const char* __first, const char* __last,
+			       double& __value) noexcept;
+  from_chars_result from_chars(const char* __first, const char* __last,
+			       double& __value, chars_format __fmt) noexcept;
+
+  from_chars_result from_chars(const char* __first, const char* __last,
+			       long double& __value) noexcept;
+  from_chars_result from_chars(const char* __first, const char* __last,
+			       long double& __value,
+			       chars_format __fmt) noexcept;
+#endif // C++17
+
 _GLIBCXX_END_NAMESPACE_VERSION
 } // namespace std
 #endif // C++11
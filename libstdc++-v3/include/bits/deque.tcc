@@ -1116,6 +1116,95 @@ _GLIBCXX_BEGIN_NAMESPACE_CONTAINER
 #endif
 
 _GLIBCXX_END_NAMESPACE_CONTAINER
+
+  // Copy or move a range of deque iterators one node at a time, so that
+  // each node's buffer is handled as a contiguous range (with memmove for
+  // trivially copyable types) and not element by element.
+  template<bool _IsMove, typename _Tp, typename _Ref, typename _Ptr,
+	   typename _OI>
+    _OI
+    __copy_move_dit(_GLIBCXX_STD_C::_Deque_iterator<_Tp, _Ref, _Ptr> __first,
+		    _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Ref, _Ptr> __last,
+		    _OI __result)
+    {
+      typedef _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Ref, _Ptr> _Iter;
+
+      if (__first._M_node == __last._M_node)
+	return std::__copy_move_a2<_IsMove>(__first._M_cur, __last._M_cur,
+					    __result);
+
+      __result = std::__copy_move_a2<_IsMove>(__first._M_cur,
+					      __first._M_last, __result);
+      for (typename _Iter::_Map_pointer __node = __first._M_node + 1;
+	   __node != __last._M_node; ++__node)
+	__result = std::__copy_move_a2<_IsMove>(*__node,
+						*__node
+						+ _Iter::_S_buffer_size(),
+						__result);
+      return std::__copy_move_a2<_IsMove>(__last._M_first, __last._M_cur,
+					  __result);
+    }
+
+  template<bool _IsMove, typename _Tp, typename _Ref, typename _Ptr,
+	   typename _OI>
+    _OI
+    __copy_move_a2(_GLIBCXX_STD_C::_Deque_iterator<_Tp, _Ref, _Ptr> __first,
+		   _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Ref, _Ptr> __last,
+		   _OI __result)
+    { return std::__copy_move_dit<_IsMove>(__first, __last, __result); }
+
+  template<bool _IsMove, typename _ITp, typename _IRef, typename _IPtr,
+	   typename _OTp>
+    _GLIBCXX_STD_C::_Deque_iterator<_OTp, _OTp&, _OTp*>
+    __copy_move_a2(_GLIBCXX_STD_C::_Deque_iterator<_ITp, _IRef, _IPtr> __first,
+		   _GLIBCXX_STD_C::_Deque_iterator<_ITp, _IRef, _IPtr> __last,
+		   _GLIBCXX_STD_C::_Deque_iterator<_OTp, _OTp&, _OTp*>
+		   __result)
+    { return std::__copy_move_dit<_IsMove>(__first, __last, __result); }
+
+  // Copy or move a random access range into a deque one node at a time.
+  template<bool _IsMove, typename _II, typename _Tp>
+    _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Tp&, _Tp*>
+    __copy_move_to_dit(_II __first, _II __last,
+		       _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Tp&, _Tp*>
+		       __result, random_access_iterator_tag)
+    {
+      typedef typename iterator_traits<_II>::difference_type difference_type;
+
+      difference_type __len = __last - __first;
+      while (__len > 0)
+	{
+	  const difference_type __clen
+	    = std::min<difference_type>(__len,
+					__result._M_last - __result._M_cur);
+	  std::__copy_move_a2<_IsMove>(__first, __first + __clen,
+				       __result._M_cur);
+	  __first += __clen;
+	  __result += __clen;
+	  __len -= __clen;
+	}
+      return __result;
+    }
+
+  template<bool _IsMove, typename _II, typename _Tp>
+    inline _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Tp&, _Tp*>
+    __copy_move_to_dit(_II __first, _II __last,
+		       _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Tp&, _Tp*>
+		       __result, input_iterator_tag)
+    {
+      return std::__copy_move_a<_IsMove>(std::__niter_base(__first),
+					 std::__niter_base(__last), __result);
+    }
+
+  template<bool _IsMove, typename _II, typename _Tp>
+    inline _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Tp&, _Tp*>
+    __copy_move_a2(_II __first, _II __last,
+		   _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Tp&, _Tp*> __result)
+    {
+      return std::__copy_move_to_dit<_IsMove>
+	(__first, __last, __result, std::__iterator_category(__first));
+    }
+
 _GLIBCXX_END_NAMESPACE_VERSION
 } // namespace std
 
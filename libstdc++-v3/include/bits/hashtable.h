@@ -1043,6 +1043,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	    {
 	      // Replacement allocator cannot free existing storage.
 	      this->_M_deallocate_nodes(_M_begin());
+	      this->_M_release_free_nodes();
 	      _M_before_begin._M_nxt = nullptr;
 	      _M_deallocate_buckets();
 	      _M_buckets = nullptr;
@@ -1205,6 +1206,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     _M_move_assign(_Hashtable&& __ht, true_type)
     {
       this->_M_deallocate_nodes(_M_begin());
+      this->_M_release_free_nodes();
       _M_deallocate_buckets();
       __hashtable_base::operator=(std::move(__ht));
       _M_rehash_policy = __ht._M_rehash_policy;
@@ -1397,6 +1399,7 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       this->_M_swap(__x);
 
       std::__alloc_on_swap(this->_M_node_allocator(), __x._M_node_allocator());
+      this->_M_swap_free_nodes(__x);
       std::swap(_M_rehash_policy, __x._M_rehash_policy);
 
       // Deal properly with potentially moved instances.
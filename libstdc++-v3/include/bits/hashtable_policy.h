@@ -1978,6 +1978,12 @@ namespace __detail
   /**
    * This type deals with all allocation and keeps an allocator instance
    * through inheritance to benefit from EBO when possible.
+   *
+   * When _GLIBCXX_HASHTABLE_NODE_POOL is defined to a positive number,
+   * up to that many nodes of erased elements are kept to be reused by
+   * later insertions instead of being given back to the allocator.  This
+   * changes the layout of all unordered containers, so every translation
+   * unit sharing them must be built with the same value.
    */
   template<typename _NodeAlloc>
     struct _Hashtable_alloc : private _Hashtable_ebo_helper<0, _NodeAlloc>
@@ -2000,8 +2006,22 @@ namespace __detail
       using __bucket_alloc_traits = std::allocator_traits<__bucket_alloc_type>;
 
       _Hashtable_alloc() = default;
+#if _GLIBCXX_HASHTABLE_NODE_POOL > 0
+      // The free nodes stay with their owner.
+      _Hashtable_alloc(const _Hashtable_alloc& __x)
+      : __ebo_node_alloc(static_cast<const __ebo_node_alloc&>(__x))
+      { }
+
+      _Hashtable_alloc(_Hashtable_alloc&& __x)
+      : __ebo_node_alloc(static_cast<__ebo_node_alloc&&>(__x))
+      { }
+
+      ~_Hashtable_alloc()
+      { _M_release_free_nodes(); }
+#else
       _Hashtable_alloc(const _Hashtable_alloc&) = default;
       _Hashtable_alloc(_Hashtable_alloc&&) = default;
+#endif
 
       template<typename _Alloc>
 	_Hashtable_alloc(_Alloc&& __a)
@@ -2034,11 +2054,27 @@ namespace __detail
       void
       _M_deallocate_nodes(__node_type* __n);
 
+      // Deallocate the nodes kept for reuse, before the allocator
+      // changes or goes away.
+      void
+      _M_release_free_nodes();
+
+      // Exchange the nodes kept for reuse, along with the allocators.
+      void
+      _M_swap_free_nodes(_Hashtable_alloc& __x) noexcept;
+
       __bucket_type*
       _M_allocate_buckets(std::size_t __bkt_count);
 
       void
       _M_deallocate_buckets(__bucket_type*, std::size_t __bkt_count);
+
+#if _GLIBCXX_HASHTABLE_NODE_POOL > 0
+    private:
+      // Nodes whose element has been destroyed, linked through _M_nxt.
+      __node_type* _M_free_nodes = nullptr;
+      std::size_t _M_free_count = 0;
+#endif
     };
 
   // Definitions of class template _Hashtable_alloc's out-of-line member
@@ -2049,6 +2085,28 @@ namespace __detail
       _Hashtable_alloc<_NodeAlloc>::_M_allocate_node(_Args&&... __args)
       -> __node_type*
       {
+#if _GLIBCXX_HASHTABLE_NODE_POOL > 0
+	if (__node_type* __n = _M_free_nodes)
+	  {
+	    _M_free_nodes = __n->_M_next();
+	    --_M_free_count;
+	    __n->_M_nxt = nullptr;
+	    __try
+	      {
+		__node_alloc_traits::construct(_M_node_allocator(),
+					       __n->_M_valptr(),
+					       std::forward<_Args>(__args)...);
+		return __n;
+	      }
+	    __catch(...)
+	      {
+		__n->_M_nxt = _M_free_nodes;
+		_M_free_nodes = __n;
+		++_M_free_count;
+		__throw_exception_again;
+	      }
+	  }
+#endif
 	auto __nptr = __node_alloc_traits::allocate(_M_node_allocator(), 1);
 	__node_type* __n = std::__to_address(__nptr);
 	__try
@@ -2071,6 +2129,15 @@ namespace __detail
     _Hashtable_alloc<_NodeAlloc>::_M_deallocate_node(__node_type* __n)
     {
       __node_alloc_traits::destroy(_M_node_allocator(), __n->_M_valptr());
+#if _GLIBCXX_HASHTABLE_NODE_POOL > 0
+      if (_M_free_count < _GLIBCXX_HASHTABLE_NODE_POOL)
+	{
+	  __n->_M_nxt = _M_free_nodes;
+	  _M_free_nodes = __n;
+	  ++_M_free_count;
+	  return;
+	}
+#endif
       _M_deallocate_node_ptr(__n);
     }
 
@@ -2096,6 +2163,32 @@ namespace __detail
 	}
     }
 
+  template<typename _NodeAlloc>
+    void
+    _Hashtable_alloc<_NodeAlloc>::_M_release_free_nodes()
+    {
+#if _GLIBCXX_HASHTABLE_NODE_POOL > 0
+      while (__node_type* __n = _M_free_nodes)
+	{
+	  _M_free_nodes = __n->_M_next();
+	  _M_deallocate_node_ptr(__n);
+	}
+      _M_free_count = 0;
+#endif
+    }
+
+  template<typename _NodeAlloc>
+    void
+    _Hashtable_alloc<_NodeAlloc>::
+    _M_swap_free_nodes(_Hashtable_alloc& __x __attribute__((__unused__)))
+    noexcept
+    {
+#if _GLIBCXX_HASHTABLE_NODE_POOL > 0
+      std::swap(_M_free_nodes, __x._M_free_nodes);
+      std::swap(_M_free_count, __x._M_free_count);
+#endif
+    }
+
   template<typename _NodeAlloc>
     typename _Hashtable_alloc<_NodeAlloc>::__bucket_type*
     _Hashtable_alloc<_NodeAlloc>::_M_allocate_buckets(std::size_t __bkt_count)
@@ -31,6 +31,7 @@
 #define _RANDOM_TCC 1
 
 #include <numeric> // std::accumulate and std::partial_sum
+#include <bits/simd_algo.h>
 
 namespace std _GLIBCXX_VISIBILITY(default)
 {
@@ -387,6 +388,42 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 	_M_p = state_size;
       }
 
+#ifdef _GLIBCXX_SIMD_ALGORITHMS
+  namespace __detail
+  {
+    template<typename _UIntType, _UIntType __a>
+      inline size_t
+      __mt_twist_simd(_UIntType*, size_t __k, size_t, size_t, _UIntType,
+		      __false_type)
+      { return __k; }
+
+    // Compute __x[__i] = __x[__i + __off] ^ twist(__x[__i], __x[__i + 1])
+    // for __i in [__k, __end) a vector at a time, and return the first
+    // __i left for the scalar loop.  The caller ensures that no element
+    // read through __off is written by the same vector step.
+    template<typename _UIntType, _UIntType __a>
+      inline size_t
+      __mt_twist_simd(_UIntType* __x, size_t __k, size_t __end, size_t __off,
+		      _UIntType __upper, __true_type)
+      {
+	typedef _UIntType _Vec
+	  __attribute__((__vector_size__(_GLIBCXX_SIMD_ALGORITHMS)));
+	const size_t __lanes = sizeof(_Vec) / sizeof(_UIntType);
+	for (; __k + __lanes <= __end; __k += __lanes)
+	  {
+	    _Vec __x0, __x1, __xm;
+	    __builtin_memcpy(&__x0, __x + __k, sizeof(_Vec));
+	    __builtin_memcpy(&__x1, __x + __k + 1, sizeof(_Vec));
+	    __builtin_memcpy(&__xm, __x + (__k + __off), sizeof(_Vec));
+	    const _Vec __y = (__x0 & __upper) | (__x1 & ~__upper);
+	    __x0 = __xm ^ (__y >> 1) ^ (-(__y & 1) & __a);
+	    __builtin_memcpy(__x + __k, &__x0, sizeof(_Vec));
+	  }
+	return __k;
+      }
+  } // namespace __detail
+#endif
+
   template<typename _UIntType, size_t __w,
 	   size_t __n, size_t __m, size_t __r,
 	   _UIntType __a, size_t __u, _UIntType __d, size_t __s,
@@ -400,7 +437,23 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       const _UIntType __upper_mask = (~_UIntType()) << __r;
       const _UIntType __lower_mask = ~__upper_mask;
 
-      for (size_t __k = 0; __k < (__n - __m); ++__k)
+      size_t __k = 0;
+#ifdef _GLIBCXX_SIMD_ALGORITHMS
+      // The first loop only reads elements that have not been updated yet
+      // and the second only reads elements updated __n - __m steps
+      // before, so both can be done a vector at a time if those distances
+      // are at least one vector.
+      typedef typename __truth_type<sizeof(_UIntType) >= 4
+	&& sizeof(_UIntType) <= 8
+	&& __m >= _GLIBCXX_SIMD_ALGORITHMS / sizeof(_UIntType)
+	&& __n - __m >= _GLIBCXX_SIMD_ALGORITHMS / sizeof(_UIntType)
+	>::__type _Simd;
+      __k = __detail::__mt_twist_simd<_UIntType, __a>(_M_x, __k, __n - __m,
+						      __m, __upper_mask,
+						      _Simd());
+#endif
+
+      for (; __k < (__n - __m); ++__k)
         {
 	  _UIntType __y = ((_M_x[__k] & __upper_mask)
 			   | (_M_x[__k + 1] & __lower_mask));
@@ -408,7 +461,13 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 		       ^ ((__y & 0x01) ? __a : 0));
         }
 
-      for (size_t __k = (__n - __m); __k < (__n - 1); ++__k)
+#ifdef _GLIBCXX_SIMD_ALGORITHMS
+      __k = __detail::__mt_twist_simd<_UIntType, __a>(_M_x, __k, __n - 1,
+						      __m - __n, __upper_mask,
+						      _Simd());
+#endif
+
+      for (; __k < (__n - 1); ++__k)
 	{
 	  _UIntType __y = ((_M_x[__k] & __upper_mask)
 			   | (_M_x[__k + 1] & __lower_mask));
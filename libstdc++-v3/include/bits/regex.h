@@ -55,6 +55,14 @@ namespace __detail
 		      const basic_regex<_CharT, _TraitsT>& __re,
 		      regex_constants::match_flag_type     __flags);
 
+  template<typename _BiIter, typename _CharT, typename _TraitsT,
+	   bool __match_mode>
+    bool
+    __regex_algo_test(_BiIter			      __s,
+		      _BiIter			      __e,
+		      const basic_regex<_CharT, _TraitsT>& __re,
+		      regex_constants::match_flag_type     __flags);
+
   template<typename, typename, typename, bool>
     class _Executor;
 }
@@ -769,6 +777,11 @@ _GLIBCXX_BEGIN_NAMESPACE_CXX11
 				    const basic_regex<_Cp, _Rp>&,
 				    regex_constants::match_flag_type);
 
+      template<typename _Bp, typename _Cp, typename _Rp, bool>
+	friend bool
+	__detail::__regex_algo_test(_Bp, _Bp, const basic_regex<_Cp, _Rp>&,
+				    regex_constants::match_flag_type);
+
       template<typename, typename, typename, bool>
 	friend class __detail::_Executor;
 
@@ -2116,8 +2129,8 @@ _GLIBCXX_END_NAMESPACE_CXX11
 		regex_constants::match_flag_type __flags
 		= regex_constants::match_default)
     {
-      match_results<_Bi_iter> __what;
-      return regex_match(__first, __last, __what, __re, __flags);
+      return __detail::__regex_algo_test<_Bi_iter, _Ch_type, _Rx_traits,
+	true>(__first, __last, __re, __flags);
     }
 
   /**
@@ -2270,8 +2283,8 @@ _GLIBCXX_END_NAMESPACE_CXX11
 		 regex_constants::match_flag_type __flags
 		 = regex_constants::match_default)
     {
-      match_results<_Bi_iter> __what;
-      return regex_search(__first, __last, __what, __re, __flags);
+      return __detail::__regex_algo_test<_Bi_iter, _Ch_type, _Rx_traits,
+	false>(__first, __last, __re, __flags);
     }
 
   /**
@@ -60,6 +60,17 @@ namespace __detail
       __m._M_begin = __s;
       __m._M_resize(__re._M_automaton->_M_sub_count());
 
+      // The DFA cannot tell where the match is, but it is much faster
+      // than the executors at telling that there is none.
+      const _DFA* __dfa = __re._M_automaton->_M_dfa.get();
+      if (__policy == _RegexExecutorPolicy::_S_auto
+	  && __dfa && __dfa->_M_applies(__flags)
+	  && !__dfa->_M_run(__s, __e, __flags, __match_mode))
+	{
+	  __m._M_establish_failed_match(__e);
+	  return false;
+	}
+
       bool __ret;
       if ((__re.flags() & regex_constants::__polynomial)
 	  || (__policy == _RegexExecutorPolicy::_S_alternate
@@ -113,6 +124,31 @@ namespace __detail
 	}
       return __ret;
     }
+
+  // regex_match and regex_search without match_results. These only need
+  // to know whether there is a match, which the DFA tells by itself.
+  template<typename _BiIter, typename _CharT, typename _TraitsT,
+	   bool __match_mode>
+    bool
+    __regex_algo_test(_BiIter                              __s,
+		      _BiIter                              __e,
+		      const basic_regex<_CharT, _TraitsT>& __re,
+		      regex_constants::match_flag_type     __flags)
+    {
+      if (__re._M_automaton == nullptr)
+	return false;
+
+      const _DFA* __dfa = __re._M_automaton->_M_dfa.get();
+      if (__dfa && __dfa->_M_applies(__flags))
+	return __dfa->_M_run(__s, __e, __flags, __match_mode);
+
+      match_results<_BiIter> __what;
+      return __regex_algo_impl<_BiIter,
+			       typename match_results<_BiIter>::allocator_type,
+			       _CharT, _TraitsT,
+			       _RegexExecutorPolicy::_S_auto, __match_mode>
+	(__s, __e, __what, __re, __flags);
+    }
   /// @endcond
 } // namespace __detail
 
@@ -33,6 +33,13 @@
 #define _GLIBCXX_REGEX_STATE_LIMIT 100000
 #endif
 
+// This macro defines the maximal state number of the DFA built for a
+// narrow character regex. NFAs with more states than this are never
+// converted, and a conversion needing more DFA states is abandoned.
+#ifndef _GLIBCXX_REGEX_DFA_STATE_LIMIT
+#define _GLIBCXX_REGEX_DFA_STATE_LIMIT 512
+#endif
+
 namespace std _GLIBCXX_VISIBILITY(default)
 {
 _GLIBCXX_BEGIN_NAMESPACE_VERSION
@@ -181,6 +188,68 @@ namespace __detail
       }
     };
 
+  /// A DFA answering whether a narrow character regex matches, built
+  /// from an NFA that has no backreferences, word boundaries or
+  /// lookaheads. It reports neither the position of the match nor
+  /// submatches, so it is used to decide regex_match and regex_search
+  /// calls that don't ask for them, and to reject input quickly
+  /// before the executor runs on it.
+  struct _DFA
+  {
+    typedef regex_constants::match_flag_type _FlagT;
+
+    enum : unsigned char
+    {
+      // The accepting state of the NFA has been reached.
+      _S_accept_now = 1,
+      // The accepting state is reached if "$" matches here.
+      _S_accept_at_end = 2,
+    };
+
+    static const int _S_dead = -1;
+
+    // Whether _M_run() gives the right answer under __flags.
+    static bool
+    _M_applies(_FlagT __flags)
+    { return !(__flags & regex_constants::match_not_null); }
+
+    template<typename _BiIter>
+      bool
+      _M_run(_BiIter __s, _BiIter __e, _FlagT __flags,
+	     bool __match_mode) const
+      {
+	bool __bol = !(__flags & (regex_constants::match_not_bol
+				  | regex_constants::match_prev_avail));
+	bool __search = !__match_mode
+	  && !(__flags & regex_constants::match_continuous);
+	int __state = _M_start[__search][__bol];
+	for (; __s != __e; ++__s)
+	  {
+	    if (!__match_mode && (_M_accept[__state] & _S_accept_now))
+	      return true;
+	    __state = _M_next[__state * _M_class_count
+			      + _M_class[static_cast<unsigned char>(*__s)]];
+	    if (__state == _S_dead)
+	      return false;
+	  }
+	return (_M_accept[__state] & _S_accept_now)
+	  || ((_M_accept[__state] & _S_accept_at_end)
+	      && !(__flags & regex_constants::match_not_eol));
+      }
+
+    // Equivalence class of each byte; bytes in the same class are
+    // accepted by the same NFA matchers.
+    unsigned char			_M_class[256];
+    size_t				_M_class_count;
+    // _M_next[__s * _M_class_count + __c] is the state following __s
+    // on a byte of class __c, or _S_dead.
+    _GLIBCXX_STD_C::vector<int>		_M_next;
+    _GLIBCXX_STD_C::vector<unsigned char> _M_accept;
+    // Initial states, indexed by whether the DFA searches (rather than
+    // matching a prefix) and whether "^" matches at the start.
+    int					_M_start[2][2];
+  };
+
   struct _NFA_base
   {
     typedef size_t                              _SizeT;
@@ -215,6 +284,8 @@ namespace __detail
     _StateIdT                 _M_start_state;
     _SizeT                    _M_subexpr_count;
     bool                      _M_has_backref;
+    // Set by _NFA::_M_build_dfa() when a DFA could be built.
+    unique_ptr<const _DFA>    _M_dfa;
   };
 
   template<typename _TraitsT>
@@ -340,6 +411,10 @@ namespace __detail
       void
       _M_eliminate_dummy();
 
+      // Build _M_dfa, if this NFA allows it.
+      void
+      _M_build_dfa();
+
 #ifdef _GLIBCXX_DEBUG
       std::ostream&
       _M_dot(std::ostream& __ostr) const;
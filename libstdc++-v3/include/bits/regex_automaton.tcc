@@ -189,6 +189,178 @@ namespace __detail
 	}
     }
 
+  // Subset construction. A DFA state stands for the set of matchers,
+  // "$" assertions and the accepting state reachable from where the
+  // input has been read to without consuming anything. Bytes are
+  // grouped into classes accepted by the same matchers first, so that
+  // each DFA state needs one transition per class instead of per byte.
+  //
+  // States of a searching DFA also contain the states reachable from
+  // the NFA start, because a match may begin at every position.
+  //
+  // The whole DFA is built here rather than lazily while matching,
+  // because a compiled regex is shared between threads and copies of
+  // the basic_regex.
+  template<typename _TraitsT>
+    void
+    _NFA<_TraitsT>::_M_build_dfa()
+    {
+      if (sizeof(_Char_type) != 1 || this->_M_has_backref
+	  || this->size() > _GLIBCXX_REGEX_DFA_STATE_LIMIT)
+	return;
+
+      typedef _GLIBCXX_STD_C::vector<_StateIdT> _SetT;
+      // (set, 2 * searching + "^" matches)
+      typedef pair<_SetT, int>			_KeyT;
+
+      const size_t __n = this->size();
+      _GLIBCXX_STD_C::vector<int> __matcher(__n, -1);
+      _GLIBCXX_STD_C::vector<bitset<256>> __bytes;
+      for (size_t __i = 0; __i < __n; ++__i)
+	switch ((*this)[__i]._M_opcode())
+	  {
+	  case _S_opcode_backref:
+	  case _S_opcode_word_boundary:
+	  case _S_opcode_subexpr_lookahead:
+	    return;
+	  case _S_opcode_match:
+	    __matcher[__i] = __bytes.size();
+	    __bytes.emplace_back();
+	    for (unsigned __c = 0; __c < 256; ++__c)
+	      if ((*this)[__i]._M_matches(static_cast<_Char_type>(__c)))
+		__bytes.back().set(__c);
+	    break;
+	  default:
+	    break;
+	  }
+
+      unique_ptr<_DFA> __dfa(new _DFA);
+      unsigned char __rep[256];
+      __dfa->_M_class_count = 0;
+      for (unsigned __c = 0; __c < 256; ++__c)
+	{
+	  size_t __k = 0;
+	  for (; __k < __dfa->_M_class_count; ++__k)
+	    {
+	      bool __same = true;
+	      for (const auto& __b : __bytes)
+		if (__b[__c] != __b[__rep[__k]])
+		  {
+		    __same = false;
+		    break;
+		  }
+	      if (__same)
+		break;
+	    }
+	  if (__k == __dfa->_M_class_count)
+	    __rep[__dfa->_M_class_count++] = __c;
+	  __dfa->_M_class[__c] = __k;
+	}
+
+      // Add the epsilon closure of __from to __set. States already in
+      // __seen are skipped, so that one closure can be the union of
+      // several calls.
+      _GLIBCXX_STD_C::vector<bool> __seen(__n);
+      _GLIBCXX_STD_C::vector<_StateIdT> __stack;
+      auto __closure = [&](_SetT& __set, _StateIdT __from,
+			   bool __bol, bool __eol)
+	{
+	  __stack.push_back(__from);
+	  while (!__stack.empty())
+	    {
+	      _StateIdT __i = __stack.back();
+	      __stack.pop_back();
+	      if (__i < 0 || __seen[__i])
+		continue;
+	      __seen[__i] = true;
+	      const auto& __state = (*this)[__i];
+	      switch (__state._M_opcode())
+		{
+		case _S_opcode_alternative:
+		case _S_opcode_repeat:
+		  __stack.push_back(__state._M_next);
+		  __stack.push_back(__state._M_alt);
+		  break;
+		case _S_opcode_line_begin_assertion:
+		  if (__bol)
+		    __stack.push_back(__state._M_next);
+		  break;
+		case _S_opcode_line_end_assertion:
+		  if (__eol)
+		    __stack.push_back(__state._M_next);
+		  else
+		    __set.push_back(__i);
+		  break;
+		case _S_opcode_match:
+		case _S_opcode_accept:
+		  __set.push_back(__i);
+		  break;
+		default:
+		  __stack.push_back(__state._M_next);
+		  break;
+		}
+	    }
+	};
+
+      std::map<_KeyT, int> __ids;
+      _GLIBCXX_STD_C::vector<_KeyT> __keys;
+      auto __intern = [&](_SetT& __set, int __how)
+	{
+	  std::sort(__set.begin(), __set.end());
+	  auto __ins = __ids.emplace(_KeyT(std::move(__set), __how),
+				     __keys.size());
+	  if (__ins.second)
+	    __keys.push_back(__ins.first->first);
+	  return __ins.first->second;
+	};
+
+      for (int __search = 0; __search < 2; ++__search)
+	for (int __bol = 0; __bol < 2; ++__bol)
+	  {
+	    _SetT __set;
+	    std::fill(__seen.begin(), __seen.end(), false);
+	    __closure(__set, _M_start(), __bol, false);
+	    __dfa->_M_start[__search][__bol]
+	      = __intern(__set, 2 * __search + __bol);
+	  }
+
+      for (size_t __i = 0; __i < __keys.size(); ++__i)
+	{
+	  if (__keys.size() > _GLIBCXX_REGEX_DFA_STATE_LIMIT)
+	    return;
+	  const _SetT __set = __keys[__i].first;
+	  const bool __search = __keys[__i].second & 2;
+	  const bool __bol = __keys[__i].second & 1;
+
+	  unsigned char __accept = 0;
+	  _SetT __at_end;
+	  std::fill(__seen.begin(), __seen.end(), false);
+	  for (auto __j : __set)
+	    if ((*this)[__j]._M_opcode() == _S_opcode_accept)
+	      __accept |= _DFA::_S_accept_now;
+	    else if ((*this)[__j]._M_opcode() == _S_opcode_line_end_assertion)
+	      __closure(__at_end, (*this)[__j]._M_next, __bol, true);
+	  for (auto __j : __at_end)
+	    if ((*this)[__j]._M_opcode() == _S_opcode_accept)
+	      __accept |= _DFA::_S_accept_at_end;
+	  __dfa->_M_accept.push_back(__accept);
+
+	  for (size_t __k = 0; __k < __dfa->_M_class_count; ++__k)
+	    {
+	      _SetT __next;
+	      std::fill(__seen.begin(), __seen.end(), false);
+	      for (auto __j : __set)
+		if (__matcher[__j] >= 0 && __bytes[__matcher[__j]][__rep[__k]])
+		  __closure(__next, (*this)[__j]._M_next, false, false);
+	      if (__search)
+		__closure(__next, _M_start(), false, false);
+	      __dfa->_M_next.push_back(__next.empty() ? _DFA::_S_dead
+				       : __intern(__next, __search ? 2 : 0));
+	    }
+	}
+      this->_M_dfa = std::move(__dfa);
+    }
+
   // Just apply DFS on the sequence and re-link their links.
   template<typename _TraitsT>
     _StateSeq<_TraitsT>
@@ -89,6 +89,7 @@ namespace __detail
       __r._M_append(_M_nfa->_M_insert_subexpr_end());
       __r._M_append(_M_nfa->_M_insert_accept());
       _M_nfa->_M_eliminate_dummy();
+      _M_nfa->_M_build_dfa();
     }
 
   template<typename _TraitsT>
@@ -0,0 +1,125 @@
+// -*- C++ -*- header.
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file bits/semaphore_base.h
+ *  This is an internal header file, included by other library headers.
+ *  Do not attempt to use it directly. @headername{semaphore}
+ */
+
+#ifndef _GLIBCXX_SEMAPHORE_BASE_H
+#define _GLIBCXX_SEMAPHORE_BASE_H 1
+
+#pragma GCC system_header
+
+#include <bits/atomic_base.h>
+
+#ifdef __cpp_lib_atomic_wait
+#include <bits/atomic_timed_wait.h>
+#include <ext/numeric_traits.h>
+
+namespace std _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  // A semaphore whose count is an atomic _Tp.  Threads that find the count
+  // at zero wait for it to change, and release only makes a system call
+  // when a thread is blocked.
+  template<typename _Tp>
+    struct __atomic_semaphore
+    {
+      static constexpr ptrdiff_t _S_max
+	= __gnu_cxx::__numeric_traits<_Tp>::__max;
+
+      explicit
+      __atomic_semaphore(_Tp __count) noexcept
+      : _M_counter(__count)
+      { __glibcxx_assert(__count >= 0 && __count <= _S_max); }
+
+      __atomic_semaphore(const __atomic_semaphore&) = delete;
+      __atomic_semaphore& operator=(const __atomic_semaphore&) = delete;
+
+      bool
+      _M_try_acquire() noexcept
+      {
+	auto __old = __atomic_load_n(&_M_counter, __ATOMIC_RELAXED);
+	while (__old > 0)
+	  if (__atomic_compare_exchange_n(&_M_counter, &__old, __old - 1,
+					  true, __ATOMIC_ACQUIRE,
+					  __ATOMIC_RELAXED))
+	    return true;
+	return false;
+      }
+
+      void
+      _M_acquire() noexcept
+      {
+	while (!_M_try_acquire())
+	  std::__atomic_wait_address_v(&_M_counter, _Tp(0), _M_load());
+      }
+
+      template<typename _Clock, typename _Duration>
+	bool
+	_M_try_acquire_until(const chrono::time_point<_Clock, _Duration>&
+			     __atime) noexcept
+	{
+	  while (!_M_try_acquire())
+	    if (!std::__atomic_wait_address_until_v(&_M_counter, _Tp(0),
+						    _M_load(), __atime))
+	      return false;
+	  return true;
+	}
+
+      template<typename _Rep, typename _Period>
+	bool
+	_M_try_acquire_for(const chrono::duration<_Rep, _Period>& __rtime)
+	noexcept
+	{
+	  using __dur = chrono::steady_clock::duration;
+	  return _M_try_acquire_until(chrono::steady_clock::now()
+				      + chrono::ceil<__dur>(__rtime));
+	}
+
+      void
+      _M_release(ptrdiff_t __update) noexcept
+      {
+	__atomic_fetch_add(&_M_counter, _Tp(__update), __ATOMIC_RELEASE);
+	std::__atomic_notify_address(&_M_counter, __update > 1);
+      }
+
+    private:
+      auto
+      _M_load() const noexcept
+      {
+	return [this] {
+	  return __atomic_load_n(&_M_counter, __ATOMIC_RELAXED);
+	};
+      }
+
+      alignas(_Tp) _Tp _M_counter;
+    };
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace std
+#endif // __cpp_lib_atomic_wait
+#endif // _GLIBCXX_SEMAPHORE_BASE_H
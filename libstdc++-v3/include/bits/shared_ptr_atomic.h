@@ -328,6 +328,354 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
   // @}
 
   // @} relates shared_ptr
+
+#if __cplusplus > 201703L
+#define __cpp_lib_atomic_shared_ptr 201711L
+
+  /// @cond undocumented
+
+  template<typename _Tp>
+    struct __sp_is_shared_ptr : false_type
+    { };
+
+  template<typename _Tp>
+    struct __sp_is_shared_ptr<shared_ptr<_Tp>> : true_type
+    { };
+
+  // The state shared by atomic<shared_ptr<T>> and atomic<weak_ptr<T>>.
+  // Instead of taking one of the mutexes behind _Sp_locker, each object
+  // protects itself with a spin lock in the low bit of its control block
+  // pointer, which is always clear since the control block is aligned.
+  // Loads only hold the lock for as long as it takes to copy the stored
+  // pointer and add a reference, so nothing contends on unrelated
+  // objects.
+  template<typename _Tp>
+    class _Sp_atomic
+    {
+      using value_type = _Tp;
+
+      template<typename> friend struct atomic;
+
+      // Either __shared_count<_Lp> or __weak_count<_Lp>.
+      using __count_type = decltype(_Tp::_M_refcount);
+      // _Sp_counted_base<_Lp>*
+      using __pointer = decltype(__count_type::_M_pi);
+
+      static constexpr bool _S_is_shared = __sp_is_shared_ptr<_Tp>::value;
+
+      static_assert(alignof(remove_pointer_t<__pointer>) > 1,
+		    "the low bit of a control block pointer must be clear");
+
+      static constexpr uintptr_t _S_lock_bit = 1;
+
+      // Spin until the lock bit of _M_val is clear, then set it.  Return
+      // the control block pointer.
+      __pointer
+      _M_lock(memory_order __o) const noexcept
+      {
+	uintptr_t __cur = _M_val.load(memory_order_relaxed);
+	for (;;)
+	  {
+	    while (__cur & _S_lock_bit)
+	      {
+		_S_relax();
+		__cur = _M_val.load(memory_order_relaxed);
+	      }
+	    if (_M_val.compare_exchange_weak(__cur, __cur | _S_lock_bit, __o,
+					     memory_order_relaxed))
+	      return reinterpret_cast<__pointer>(__cur);
+	  }
+      }
+
+      // Clear the lock bit, leaving the control block pointer alone.
+      void
+      _M_unlock(memory_order __o) const noexcept
+      { _M_val.fetch_sub(_S_lock_bit, __o); }
+
+      // Store the control block of __c and take the one that was locked
+      // into __c, releasing the lock.
+      void
+      _M_swap_unlock(__count_type& __c, memory_order __o) noexcept
+      {
+	if (__o != memory_order_seq_cst)
+	  __o = memory_order_release;
+	uintptr_t __x = reinterpret_cast<uintptr_t>(__c._M_pi);
+	__x = _M_val.exchange(__x, __o);
+	__c._M_pi = reinterpret_cast<__pointer>(__x & ~_S_lock_bit);
+      }
+
+      static void
+      _S_relax() noexcept
+      {
+#if defined __i386__ || defined __x86_64__
+	__builtin_ia32_pause();
+#elif defined __GTHREADS && defined _GLIBCXX_USE_SCHED_YIELD
+	__gthread_yield();
+#endif
+      }
+
+      static __pointer
+      _S_add_ref(__pointer __pi) noexcept
+      {
+	if (__pi)
+	  {
+	    if constexpr (_S_is_shared)
+	      __pi->_M_add_ref_copy();
+	    else
+	      __pi->_M_weak_add_ref();
+	  }
+	return __pi;
+      }
+
+      constexpr _Sp_atomic() noexcept = default;
+
+      explicit
+      _Sp_atomic(value_type __r) noexcept
+      : _M_ptr(__r._M_ptr),
+	_M_val(reinterpret_cast<uintptr_t>(__r._M_refcount._M_pi))
+      {
+	__r._M_ptr = nullptr;
+	__r._M_refcount._M_pi = nullptr;
+      }
+
+      ~_Sp_atomic()
+      {
+	uintptr_t __val = _M_val.load(memory_order_relaxed);
+	__glibcxx_assert(!(__val & _S_lock_bit));
+	if (__pointer __pi = reinterpret_cast<__pointer>(__val))
+	  {
+	    if constexpr (_S_is_shared)
+	      __pi->_M_release();
+	    else
+	      __pi->_M_weak_release();
+	  }
+      }
+
+      _Sp_atomic(const _Sp_atomic&) = delete;
+      void operator=(const _Sp_atomic&) = delete;
+
+      value_type
+      load(memory_order __o) const noexcept
+      {
+	__glibcxx_assert(__o != memory_order_release
+			 && __o != memory_order_acq_rel);
+	// The stored pointer must be read after the lock is taken.
+	if (__o != memory_order_seq_cst)
+	  __o = memory_order_acquire;
+
+	value_type __ret;
+	__pointer __pi = _M_lock(__o);
+	__ret._M_ptr = _M_ptr;
+	__ret._M_refcount._M_pi = _S_add_ref(__pi);
+	// And before it is released.
+	_M_unlock(memory_order_release);
+	return __ret;
+      }
+
+      // Exchange the stored value with __r.  The old value is destroyed
+      // by the caller, outside the lock.
+      void
+      swap(value_type& __r, memory_order __o) noexcept
+      {
+	_M_lock(memory_order_acquire);
+	std::swap(_M_ptr, __r._M_ptr);
+	_M_swap_unlock(__r._M_refcount, __o);
+      }
+
+      bool
+      compare_exchange_strong(value_type& __expected, value_type __desired,
+			      memory_order __o, memory_order __o2) noexcept
+      {
+	__pointer __pi = _M_lock(memory_order_acquire);
+	if (_M_ptr == __expected._M_ptr
+	    && __pi == __expected._M_refcount._M_pi)
+	  {
+	    _M_ptr = __desired._M_ptr;
+	    _M_swap_unlock(__desired._M_refcount, __o);
+	    return true;
+	  }
+	// Release the old value of __expected after unlocking.
+	value_type __old = std::move(__expected);
+	__expected._M_ptr = _M_ptr;
+	__expected._M_refcount._M_pi = _S_add_ref(__pi);
+	_M_unlock(__o2 == memory_order_seq_cst ? __o2
+		  : memory_order_release);
+	return false;
+      }
+
+      typename _Tp::element_type* _M_ptr = nullptr;
+      mutable __atomic_base<uintptr_t> _M_val{0};
+    };
+
+  /// @endcond
+
+  /// Partial specialization of std::atomic for std::shared_ptr.
+  template<typename _Tp>
+    struct atomic<shared_ptr<_Tp>>
+    {
+    public:
+      using value_type = shared_ptr<_Tp>;
+
+      static constexpr bool is_always_lock_free = false;
+
+      bool
+      is_lock_free() const noexcept
+      { return false; }
+
+      constexpr atomic() noexcept = default;
+
+      atomic(shared_ptr<_Tp> __r) noexcept
+      : _M_impl(std::move(__r))
+      { }
+
+      atomic(const atomic&) = delete;
+      void operator=(const atomic&) = delete;
+
+      shared_ptr<_Tp>
+      load(memory_order __o = memory_order_seq_cst) const noexcept
+      { return _M_impl.load(__o); }
+
+      operator shared_ptr<_Tp>() const noexcept
+      { return _M_impl.load(memory_order_seq_cst); }
+
+      void
+      store(shared_ptr<_Tp> __desired,
+	    memory_order __o = memory_order_seq_cst) noexcept
+      { _M_impl.swap(__desired, __o); }
+
+      void
+      operator=(shared_ptr<_Tp> __desired) noexcept
+      { _M_impl.swap(__desired, memory_order_seq_cst); }
+
+      shared_ptr<_Tp>
+      exchange(shared_ptr<_Tp> __desired,
+	       memory_order __o = memory_order_seq_cst) noexcept
+      {
+	_M_impl.swap(__desired, __o);
+	return __desired;
+      }
+
+      bool
+      compare_exchange_strong(shared_ptr<_Tp>& __expected,
+			      shared_ptr<_Tp> __desired,
+			      memory_order __o, memory_order __o2) noexcept
+      {
+	return _M_impl.compare_exchange_strong(__expected,
+					       std::move(__desired),
+					       __o, __o2);
+      }
+
+      bool
+      compare_exchange_strong(value_type& __expected, value_type __desired,
+			      memory_order __o = memory_order_seq_cst) noexcept
+      {
+	return compare_exchange_strong(__expected, std::move(__desired), __o,
+				       __cmpexch_failure_order(__o));
+      }
+
+      bool
+      compare_exchange_weak(value_type& __expected, value_type __desired,
+			    memory_order __o, memory_order __o2) noexcept
+      {
+	return compare_exchange_strong(__expected, std::move(__desired),
+				       __o, __o2);
+      }
+
+      bool
+      compare_exchange_weak(value_type& __expected, value_type __desired,
+			    memory_order __o = memory_order_seq_cst) noexcept
+      {
+	return compare_exchange_strong(__expected, std::move(__desired), __o);
+      }
+
+    private:
+      _Sp_atomic<shared_ptr<_Tp>> _M_impl;
+    };
+
+  /// Partial specialization of std::atomic for std::weak_ptr.
+  template<typename _Tp>
+    struct atomic<weak_ptr<_Tp>>
+    {
+    public:
+      using value_type = weak_ptr<_Tp>;
+
+      static constexpr bool is_always_lock_free = false;
+
+      bool
+      is_lock_free() const noexcept
+      { return false; }
+
+      constexpr atomic() noexcept = default;
+
+      atomic(weak_ptr<_Tp> __r) noexcept
+      : _M_impl(std::move(__r))
+      { }
+
+      atomic(const atomic&) = delete;
+      void operator=(const atomic&) = delete;
+
+      weak_ptr<_Tp>
+      load(memory_order __o = memory_order_seq_cst) const noexcept
+      { return _M_impl.load(__o); }
+
+      operator weak_ptr<_Tp>() const noexcept
+      { return _M_impl.load(memory_order_seq_cst); }
+
+      void
+      store(weak_ptr<_Tp> __desired,
+	    memory_order __o = memory_order_seq_cst) noexcept
+      { _M_impl.swap(__desired, __o); }
+
+      void
+      operator=(weak_ptr<_Tp> __desired) noexcept
+      { _M_impl.swap(__desired, memory_order_seq_cst); }
+
+      weak_ptr<_Tp>
+      exchange(weak_ptr<_Tp> __desired,
+	       memory_order __o = memory_order_seq_cst) noexcept
+      {
+	_M_impl.swap(__desired, __o);
+	return __desired;
+      }
+
+      bool
+      compare_exchange_strong(weak_ptr<_Tp>& __expected,
+			      weak_ptr<_Tp> __desired,
+			      memory_order __o, memory_order __o2) noexcept
+      {
+	return _M_impl.compare_exchange_strong(__expected,
+					       std::move(__desired),
+					       __o, __o2);
+      }
+
+      bool
+      compare_exchange_strong(value_type& __expected, value_type __desired,
+			      memory_order __o = memory_order_seq_cst) noexcept
+      {
+	return compare_exchange_strong(__expected, std::move(__desired), __o,
+				       __cmpexch_failure_order(__o));
+      }
+
+      bool
+      compare_exchange_weak(value_type& __expected, value_type __desired,
+			    memory_order __o, memory_order __o2) noexcept
+      {
+	return compare_exchange_strong(__expected, std::move(__desired),
+				       __o, __o2);
+      }
+
+      bool
+      compare_exchange_weak(value_type& __expected, value_type __desired,
+			    memory_order __o = memory_order_seq_cst) noexcept
+      {
+	return compare_exchange_strong(__expected, std::move(__desired), __o);
+      }
+
+    private:
+      _Sp_atomic<weak_ptr<_Tp>> _M_impl;
+    };
+#endif // C++20
+
   // @} group pointer_abstractions
 
 _GLIBCXX_END_NAMESPACE_VERSION
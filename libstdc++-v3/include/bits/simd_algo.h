@@ -0,0 +1,336 @@
+// Vectorized kernels for non-modifying algorithms -*- C++ -*-
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file bits/simd_algo.h
+ *  This is an internal header file, included by other library headers.
+ *  Do not attempt to use it directly. @headername{algorithm}
+ */
+
+#ifndef _GLIBCXX_SIMD_ALGO_H
+#define _GLIBCXX_SIMD_ALGO_H 1
+
+#pragma GCC system_header
+
+#include <bits/c++config.h>
+#include <bits/cpp_type_traits.h>
+#include <ext/type_traits.h>
+
+// The kernels below are written with the GCC vector extensions and used by
+// find, count, min_element, max_element, mismatch and equal on contiguous
+// ranges of integers and floating-point numbers.  The loops in the generic
+// algorithms exit early and are not vectorized by the compiler.  They are
+// only enabled for targets where the vector operations are native.
+//
+// Since C++14 some of the algorithms are constexpr and the kernels must be
+// skipped during constant evaluation, which needs
+// __builtin_is_constant_evaluated.
+#if !defined _GLIBCXX_SIMD_ALGORITHMS && defined __GNUC__ \
+  && (defined __SSE2__ || defined __aarch64__) \
+  && (__cplusplus < 201402L \
+      || defined _GLIBCXX_HAVE_BUILTIN_IS_CONSTANT_EVALUATED)
+# ifdef __AVX2__
+#  define _GLIBCXX_SIMD_ALGORITHMS 32
+# else
+#  define _GLIBCXX_SIMD_ALGORITHMS 16
+# endif
+// Comparisons of 64-bit integers need SSE4.2.
+# if defined __aarch64__ || defined __SSE4_2__
+#  define _GLIBCXX_SIMD_ALGORITHMS_INT64 1
+# endif
+#endif
+
+namespace std _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+#ifdef _GLIBCXX_SIMD_ALGORITHMS
+  template<typename _Tp>
+    struct __simd_algo_scalar
+    { typedef _Tp __type; };
+
+  template<typename _Tp>
+    struct __simd_algo_scalar<const _Tp>
+    { typedef _Tp __type; };
+
+  // Whether the kernels handle elements of type _Tp.
+  template<typename _Tp>
+    struct __is_simd_algo_type
+    {
+      enum
+	{
+	  __value = (__is_integer<_Tp>::__value
+		     || __is_floating<_Tp>::__value)
+	    && !__are_same<_Tp, bool>::__value
+	    && !__are_same<_Tp, long double>::__value
+#ifdef _GLIBCXX_SIMD_ALGORITHMS_INT64
+	    && sizeof(_Tp) <= 8
+#else
+	    && (sizeof(_Tp) < 8 || __is_floating<_Tp>::__value)
+#endif
+	};
+    };
+
+  // Whether *__p == __val, with __p a pointer to _Tp and __val of type
+  // _Val, can be computed as a comparison of two _Tp values when
+  // _Tp(__val) == __val.  This is true if the types are the same, or if
+  // they are integers of the same signedness and _Val is not wider than
+  // _Tp, or if _Val is int and _Tp is an integer that promotes to int.
+  template<typename _Tp, typename _Val>
+    struct __is_simd_algo_value
+    {
+      typedef typename __simd_algo_scalar<_Tp>::__type _Tp1;
+      typedef typename __simd_algo_scalar<_Val>::__type _Val1;
+
+      enum
+	{
+	  __value = __is_simd_algo_type<_Tp1>::__value
+	    && (__are_same<_Tp1, _Val1>::__value
+		|| (__is_integer<_Tp1>::__value
+		    && __is_integer<_Val1>::__value
+		    && !__are_same<_Val1, bool>::__value
+		    && sizeof(_Val1) <= sizeof(_Tp1)
+		    && (_Tp1(-1) < _Tp1(0)) == (_Val1(-1) < _Val1(0)))
+		|| (__is_integer<_Tp1>::__value
+		    && sizeof(_Tp1) < sizeof(int)
+		    && __are_same<_Val1, int>::__value))
+	};
+    };
+
+  // True unless the caller is being evaluated as a constant expression.
+  _GLIBCXX_CONSTEXPR inline bool
+  __use_simd_algo() _GLIBCXX_NOEXCEPT
+  {
+#ifdef _GLIBCXX_HAVE_BUILTIN_IS_CONSTANT_EVALUATED
+    return !__builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+  }
+
+  template<typename _Tp>
+    struct __simd_algo_traits
+    {
+      typedef typename __simd_algo_scalar<_Tp>::__type _Scalar;
+      typedef _Scalar _Vector
+	__attribute__((__vector_size__(_GLIBCXX_SIMD_ALGORITHMS)));
+      // An unsigned integer of the same size as _Tp.
+      typedef typename __gnu_cxx::__conditional_type<sizeof(_Tp) == 1,
+	unsigned char,
+	typename __gnu_cxx::__conditional_type<sizeof(_Tp) == 2,
+	  unsigned short,
+	  typename __gnu_cxx::__conditional_type<sizeof(_Tp) == 4,
+	    unsigned int, unsigned long long>::__type>::__type>::__type
+	_Counter;
+      // Number of elements in a vector.
+      enum { _S_lanes = _GLIBCXX_SIMD_ALGORITHMS / sizeof(_Tp) };
+      // Number of vectors tested at once.
+      enum { _S_unroll = 4 };
+      enum { _S_block = _S_lanes * _S_unroll };
+    };
+
+  template<typename _Vector, typename _Tp>
+    inline _Vector
+    __simd_load(const _Tp* __p) _GLIBCXX_NOEXCEPT
+    {
+      _Vector __v;
+      __builtin_memcpy(&__v, __p, sizeof(__v));
+      return __v;
+    }
+
+  template<typename _Vector, typename _Tp>
+    inline _Vector
+    __simd_splat(_Tp __x) _GLIBCXX_NOEXCEPT
+    {
+      _Vector __v;
+      for (size_t __i = 0; __i < sizeof(__v) / sizeof(_Tp); ++__i)
+	__v[__i] = __x;
+      return __v;
+    }
+
+  // Whether any bit of a comparison result is set.
+  template<typename _Mask>
+    inline bool
+    __simd_any(_Mask __m) _GLIBCXX_NOEXCEPT
+    {
+      unsigned long long __w[sizeof(__m) / sizeof(long long)];
+      __builtin_memcpy(__w, &__m, sizeof(__m));
+      unsigned long long __r = 0;
+      for (size_t __i = 0; __i < sizeof(__m) / sizeof(long long); ++__i)
+	__r |= __w[__i];
+      return __r != 0;
+    }
+
+  /// Find the first element equal to @a __val.
+  template<typename _Tp>
+    _Tp*
+    __simd_find(_Tp* __first, _Tp* __last,
+		typename __simd_algo_traits<_Tp>::_Scalar __val)
+    _GLIBCXX_NOEXCEPT
+    {
+      typedef __simd_algo_traits<_Tp> _Traits;
+      typedef typename _Traits::_Vector _Vector;
+      const _Vector __v = std::__simd_splat<_Vector>(__val);
+
+      while (__last - __first >= _Traits::_S_block)
+	{
+	  const _Tp* __p = __first;
+	  if (std::__simd_any(
+		(std::__simd_load<_Vector>(__p) == __v)
+		| (std::__simd_load<_Vector>(__p + _Traits::_S_lanes) == __v)
+		| (std::__simd_load<_Vector>(__p + 2 * _Traits::_S_lanes)
+		   == __v)
+		| (std::__simd_load<_Vector>(__p + 3 * _Traits::_S_lanes)
+		   == __v)))
+	    break;
+	  __first += _Traits::_S_block;
+	}
+      // Either the match is in the next block, or this is the tail.
+      for (; __first != __last; ++__first)
+	if (*__first == __val)
+	  return __first;
+      return __last;
+    }
+
+  /// Count the elements equal to @a __val.
+  template<typename _Tp>
+    ptrdiff_t
+    __simd_count(const _Tp* __first, const _Tp* __last,
+		 typename __simd_algo_traits<_Tp>::_Scalar __val)
+    _GLIBCXX_NOEXCEPT
+    {
+      typedef __simd_algo_traits<_Tp> _Traits;
+      typedef typename _Traits::_Vector _Vector;
+      typedef typename _Traits::_Counter _Counter;
+      typedef _Counter _Counters
+	__attribute__((__vector_size__(_GLIBCXX_SIMD_ALGORITHMS)));
+      const _Vector __v = std::__simd_splat<_Vector>(__val);
+
+      ptrdiff_t __n = 0;
+      while (__last - __first >= _Traits::_S_block)
+	{
+	  // A match is -1 in the result of the comparison, so subtracting
+	  // it increments the lane.  Each lane goes up by at most _S_unroll
+	  // per iteration, so flush the counters before an 8-bit lane wraps.
+	  _Counters __acc = _Counters();
+	  for (int __i = 0;
+	       __i < 255 / _Traits::_S_unroll
+		 && __last - __first >= _Traits::_S_block;
+	       ++__i, __first += _Traits::_S_block)
+	    {
+	      __acc -= (_Counters)(std::__simd_load<_Vector>(__first) == __v);
+	      __acc -= (_Counters)(std::__simd_load<_Vector>(__first
+							   + _Traits::_S_lanes)
+				   == __v);
+	      __acc -= (_Counters)(std::__simd_load<_Vector>(__first
+						+ 2 * _Traits::_S_lanes)
+				   == __v);
+	      __acc -= (_Counters)(std::__simd_load<_Vector>(__first
+						+ 3 * _Traits::_S_lanes)
+				   == __v);
+	    }
+	  size_t __sum = 0;
+	  for (int __i = 0; __i < _Traits::_S_lanes; ++__i)
+	    __sum += __acc[__i];
+	  __n += __sum;
+	}
+      for (; __first != __last; ++__first)
+	if (*__first == __val)
+	  ++__n;
+      return __n;
+    }
+
+  /// Find the first smallest element, or the first largest if @a _Max.
+  /// The range must not be empty.  Only for integers, because NaN is not
+  /// ordered.
+  template<bool _Max, typename _Tp>
+    _Tp*
+    __simd_min_element(_Tp* __first, _Tp* __last) _GLIBCXX_NOEXCEPT
+    {
+      typedef __simd_algo_traits<_Tp> _Traits;
+      typedef typename _Traits::_Scalar _Scalar;
+      typedef typename _Traits::_Vector _Vector;
+      typedef __typeof__(_Vector() < _Vector()) _Mask;
+
+      // Find the smallest value, then its first position.
+      _Scalar __m = *__first;
+      _Tp* __p = __first;
+      if (__last - __p >= _Traits::_S_lanes)
+	{
+	  _Vector __vm = std::__simd_load<_Vector>(__p);
+	  for (; __last - __p >= _Traits::_S_lanes; __p += _Traits::_S_lanes)
+	    {
+	      const _Vector __x = std::__simd_load<_Vector>(__p);
+	      const _Mask __sel = _Max ? __vm < __x : __x < __vm;
+	      __vm = (_Vector)(((_Mask)__x & __sel) | ((_Mask)__vm & ~__sel));
+	    }
+	  for (int __i = 0; __i < _Traits::_S_lanes; ++__i)
+	    if (_Max ? __m < __vm[__i] : __vm[__i] < __m)
+	      __m = __vm[__i];
+	}
+      for (; __p != __last; ++__p)
+	if (_Max ? __m < *__p : *__p < __m)
+	  __m = *__p;
+      return std::__simd_find(__first, __last, __m);
+    }
+
+  /// Find the first position where the ranges differ.
+  template<typename _Tp>
+    _Tp*
+    __simd_mismatch(_Tp* __first1, _Tp* __last1,
+		    const typename __simd_algo_traits<_Tp>::_Scalar* __first2)
+    _GLIBCXX_NOEXCEPT
+    {
+      typedef __simd_algo_traits<_Tp> _Traits;
+      typedef typename _Traits::_Vector _Vector;
+
+      while (__last1 - __first1 >= _Traits::_S_block)
+	{
+	  const _Tp* __p = __first1;
+	  const _Tp* __q = __first2;
+	  // Comparing with == rather than != means NaN is a mismatch, as
+	  // in the scalar loop.
+	  if (std::__simd_any(~(
+		(std::__simd_load<_Vector>(__p)
+		 == std::__simd_load<_Vector>(__q))
+		& (std::__simd_load<_Vector>(__p + _Traits::_S_lanes)
+		   == std::__simd_load<_Vector>(__q + _Traits::_S_lanes))
+		& (std::__simd_load<_Vector>(__p + 2 * _Traits::_S_lanes)
+		   == std::__simd_load<_Vector>(__q + 2 * _Traits::_S_lanes))
+		& (std::__simd_load<_Vector>(__p + 3 * _Traits::_S_lanes)
+		   == std::__simd_load<_Vector>(__q + 3 * _Traits::_S_lanes)))))
+	    break;
+	  __first1 += _Traits::_S_block;
+	  __first2 += _Traits::_S_block;
+	}
+      for (; __first1 != __last1; ++__first1, (void)++__first2)
+	if (!(*__first1 == *__first2))
+	  break;
+      return __first1;
+    }
+#endif // _GLIBCXX_SIMD_ALGORITHMS
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace std
+
+#endif // _GLIBCXX_SIMD_ALGO_H
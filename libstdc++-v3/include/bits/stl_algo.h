@@ -166,6 +166,64 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
 		       std::__iterator_category(__first));
     }
 
+  /// This is an overload used by find algos for deque iterators, which
+  /// searches each node's buffer as a contiguous range.
+  template<typename _Tp, typename _Ref, typename _Ptr, typename _Predicate>
+    _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Ref, _Ptr>
+    __find_if(_GLIBCXX_STD_C::_Deque_iterator<_Tp, _Ref, _Ptr> __first,
+	      _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Ref, _Ptr> __last,
+	      _Predicate __pred)
+    {
+      for (; __first._M_node != __last._M_node;
+	   __first._M_set_node(__first._M_node + 1),
+	   __first._M_cur = __first._M_first)
+	{
+	  __first._M_cur = std::__find_if(__first._M_cur, __first._M_last,
+					  __pred);
+	  if (__first._M_cur != __first._M_last)
+	    return __first;
+	}
+      __first._M_cur = std::__find_if(__first._M_cur, __last._M_cur, __pred);
+      return __first;
+    }
+
+#ifdef _GLIBCXX_SIMD_ALGORITHMS
+  /// This is an overload used by find for contiguous ranges of arithmetic
+  /// types.
+  template<typename _Tp, typename _Value>
+    _GLIBCXX20_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_algo_value<_Tp, _Value>::__value, _Tp*>::__type
+    __find_if(_Tp* __first, _Tp* __last,
+	      __gnu_cxx::__ops::_Iter_equals_val<_Value> __pred)
+    {
+      if (std::__use_simd_algo())
+	{
+	  typedef typename __simd_algo_scalar<_Tp>::__type _Scalar;
+	  // No element is equal to a value that _Tp cannot represent.
+	  if (_Scalar(__pred._M_value) != __pred._M_value)
+	    return __last;
+	  return std::__simd_find(__first, __last, _Scalar(__pred._M_value));
+	}
+      return std::__find_if(__first, __last, __pred,
+			    std::random_access_iterator_tag());
+    }
+
+  template<typename _Tp, typename _Container, typename _Value>
+    _GLIBCXX20_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_algo_value<_Tp, _Value>::__value,
+      __gnu_cxx::__normal_iterator<_Tp*, _Container> >::__type
+    __find_if(__gnu_cxx::__normal_iterator<_Tp*, _Container> __first,
+	      __gnu_cxx::__normal_iterator<_Tp*, _Container> __last,
+	      __gnu_cxx::__ops::_Iter_equals_val<_Value> __pred)
+    {
+      return std::__niter_wrap(__first,
+			       std::__find_if(__first.base(), __last.base(),
+					      __pred));
+    }
+#endif
+
   /// Provided for stable_partition to use.
   template<typename _InputIterator, typename _Predicate>
     _GLIBCXX20_CONSTEXPR
@@ -1944,22 +2002,17 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
   */
   enum { _S_threshold = 16 };
 
-  /// This is a helper function for the sort routine.
-  template<typename _RandomAccessIterator, typename _Compare>
-    _GLIBCXX20_CONSTEXPR
-    void
-    __final_insertion_sort(_RandomAccessIterator __first,
-			   _RandomAccessIterator __last, _Compare __comp)
-    {
-      if (__last - __first > int(_S_threshold))
-	{
-	  std::__insertion_sort(__first, __first + int(_S_threshold), __comp);
-	  std::__unguarded_insertion_sort(__first + int(_S_threshold), __last,
-					  __comp);
-	}
-      else
-	std::__insertion_sort(__first, __last, __comp);
-    }
+  // Further tuning for the sort routine: ranges longer than
+  // _S_ninther_threshold take their pivot from nine elements instead of
+  // three, an insertion sort used to detect sorted input gives up after
+  // moving _S_partial_insertion_limit elements, and block partitioning
+  // scans _S_block_size elements at a time from each end.
+  enum
+  {
+    _S_ninther_threshold = 128,
+    _S_partial_insertion_limit = 8,
+    _S_block_size = 64
+  };
 
   /// This is a helper function...
   template<typename _RandomAccessIterator, typename _Compare>
@@ -2009,25 +2062,423 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     }
 
   /// This is a helper function for the sort routine.
-  template<typename _RandomAccessIterator, typename _Size, typename _Compare>
+  // Sort *__a, *__b and *__c in place.
+  template<typename _RandomAccessIterator, typename _Compare>
+    _GLIBCXX20_CONSTEXPR
+    inline void
+    __sort3(_RandomAccessIterator __a, _RandomAccessIterator __b,
+	    _RandomAccessIterator __c, _Compare __comp)
+    {
+      if (__comp(__b, __a))
+	std::iter_swap(__a, __b);
+      if (__comp(__c, __b))
+	{
+	  std::iter_swap(__b, __c);
+	  if (__comp(__b, __a))
+	    std::iter_swap(__a, __b);
+	}
+    }
+
+  /// This is a helper function for the sort routine.
+  // Insertion sort that gives up and returns false as soon as more than
+  // _S_partial_insertion_limit elements have been moved, so that a range
+  // which is nearly sorted is finished off cheaply.
+  template<typename _RandomAccessIterator, typename _Compare>
+    _GLIBCXX20_CONSTEXPR
+    bool
+    __partial_insertion_sort(_RandomAccessIterator __first,
+			     _RandomAccessIterator __last, _Compare __comp)
+    {
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+      typedef typename iterator_traits<_RandomAccessIterator>::difference_type
+	_DistanceType;
+
+      if (__first == __last)
+	return true;
+
+      _DistanceType __moved = 0;
+      for (_RandomAccessIterator __i = __first + 1; __i != __last; ++__i)
+	{
+	  _RandomAccessIterator __prev = __i - 1;
+	  if (__comp(__i, __prev))
+	    {
+	      _ValueType __val = _GLIBCXX_MOVE(*__i);
+	      _RandomAccessIterator __hole = __i;
+	      do
+		{
+		  *__hole = _GLIBCXX_MOVE(*__prev);
+		  __hole = __prev;
+		}
+	      while (__hole != __first
+		     && __gnu_cxx::__ops::__val_comp_iter(__comp)(__val,
+								  --__prev));
+	      *__hole = _GLIBCXX_MOVE(__val);
+	      __moved += __i - __hole;
+	    }
+	  if (__moved > int(_S_partial_insertion_limit))
+	    return false;
+	}
+      return true;
+    }
+
+  /// This is a helper function for the sort routine.
+  // Partition [__first, __last) around the pivot *__first, putting the
+  // elements equivalent to the pivot on the right, and return the final
+  // position of the pivot.  __already is set if no elements had to be
+  // swapped.  There must be an element not less than the pivot in
+  // (__first, __last).
+  template<typename _RandomAccessIterator, typename _Compare>
+    _GLIBCXX20_CONSTEXPR
+    _RandomAccessIterator
+    __partition_right(_RandomAccessIterator __first,
+		      _RandomAccessIterator __last, _Compare __comp,
+		      bool& __already, __false_type)
+    {
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+
+      _ValueType __pivot = _GLIBCXX_MOVE(*__first);
+      _RandomAccessIterator __begin = __first;
+      __decltype(__gnu_cxx::__ops::__iter_comp_val(__comp)) __less
+	= __gnu_cxx::__ops::__iter_comp_val(__comp);
+
+      while (__less(++__first, __pivot))
+	{ }
+      if (__first - 1 == __begin)
+	while (__first < __last && !__less(--__last, __pivot))
+	  { }
+      else
+	while (!__less(--__last, __pivot))
+	  { }
+
+      __already = !(__first < __last);
+      while (__first < __last)
+	{
+	  std::iter_swap(__first, __last);
+	  while (__less(++__first, __pivot))
+	    { }
+	  while (!__less(--__last, __pivot))
+	    { }
+	}
+
+      _RandomAccessIterator __pivot_pos = __first - 1;
+      *__begin = _GLIBCXX_MOVE(*__pivot_pos);
+      *__pivot_pos = _GLIBCXX_MOVE(__pivot);
+      return __pivot_pos;
+    }
+
+  /// This is a helper function for the sort routine.
+  // As __partition_right, but without data-dependent branches in the inner
+  // loop, for arithmetic types compared with operator<.  Blocks of up to
+  // _S_block_size elements are scanned from each end, recording the
+  // offsets of the elements on the wrong side, and then the misplaced
+  // elements are swapped pairwise.  This is the technique described in
+  // Edelkamp and Weiss, "BlockQuicksort: How Branch Mispredictions don't
+  // affect Quicksort".
+  template<typename _RandomAccessIterator>
+    _RandomAccessIterator
+    __partition_right_branchless(_RandomAccessIterator __first,
+				 _RandomAccessIterator __last,
+				 bool& __already)
+    {
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+      typedef typename iterator_traits<_RandomAccessIterator>::difference_type
+	_DistanceType;
+
+      const _ValueType __pivot = *__first;
+      _RandomAccessIterator __begin = __first;
+
+      while (*++__first < __pivot)
+	{ }
+      if (__first - 1 == __begin)
+	while (__first < __last && !(*--__last < __pivot))
+	  { }
+      else
+	while (!(*--__last < __pivot))
+	  { }
+
+      __already = !(__first < __last);
+      if (!__already)
+	{
+	  std::iter_swap(__first, __last);
+	  ++__first;
+	}
+
+      unsigned char __offsets_l[_S_block_size];
+      unsigned char __offsets_r[_S_block_size];
+      _RandomAccessIterator __base_l = __first;
+      _RandomAccessIterator __base_r = __last;
+      _DistanceType __num_l = 0, __num_r = 0;
+      _DistanceType __start_l = 0, __start_r = 0;
+
+      while (__first < __last)
+	{
+	  // Fill whichever offset buffers are empty, from the unscanned
+	  // elements between __first and __last.
+	  const _DistanceType __unknown = __last - __first;
+	  _DistanceType __split_l = 0, __split_r = 0;
+	  if (__num_l == 0)
+	    __split_l = __num_r == 0 ? __unknown / 2 : __unknown;
+	  if (__num_r == 0)
+	    __split_r = __unknown - __split_l;
+	  if (__split_l > _DistanceType(_S_block_size))
+	    __split_l = _S_block_size;
+	  if (__split_r > _DistanceType(_S_block_size))
+	    __split_r = _S_block_size;
+
+	  for (_DistanceType __i = 0; __i < __split_l; ++__i)
+	    {
+	      __offsets_l[__num_l] = __i;
+	      __num_l += !(*__first < __pivot);
+	      ++__first;
+	    }
+	  for (_DistanceType __i = 0; __i < __split_r;)
+	    {
+	      __offsets_r[__num_r] = ++__i;
+	      __num_r += *--__last < __pivot;
+	    }
+
+	  // Swap as many misplaced pairs as possible.  A cyclic permutation
+	  // needs fewer moves than swapping, but is only correct if it does
+	  // not leave elements behind in either buffer.
+	  const _DistanceType __num = std::min(__num_l, __num_r);
+	  const unsigned char* __l = __offsets_l + __start_l;
+	  const unsigned char* __r = __offsets_r + __start_r;
+	  if (__num_l == __num_r)
+	    for (_DistanceType __i = 0; __i < __num; ++__i)
+	      std::iter_swap(__base_l + __l[__i], __base_r - __r[__i]);
+	  else if (__num > 0)
+	    {
+	      _RandomAccessIterator __pl = __base_l + __l[0];
+	      _RandomAccessIterator __pr = __base_r - __r[0];
+	      _ValueType __tmp = *__pl;
+	      *__pl = *__pr;
+	      for (_DistanceType __i = 1; __i < __num; ++__i)
+		{
+		  __pl = __base_l + __l[__i];
+		  *__pr = *__pl;
+		  __pr = __base_r - __r[__i];
+		  *__pl = *__pr;
+		}
+	      *__pr = __tmp;
+	    }
+
+	  __num_l -= __num;
+	  __num_r -= __num;
+	  __start_l += __num;
+	  __start_r += __num;
+	  if (__num_l == 0)
+	    {
+	      __start_l = 0;
+	      __base_l = __first;
+	    }
+	  if (__num_r == 0)
+	    {
+	      __start_r = 0;
+	      __base_r = __last;
+	    }
+	}
+
+      // Every element has been scanned; move the misplaced elements still
+      // recorded in one of the buffers to the boundary.
+      if (__num_l)
+	{
+	  while (__num_l--)
+	    std::iter_swap(__base_l + __offsets_l[__start_l + __num_l],
+			   --__last);
+	  __first = __last;
+	}
+      if (__num_r)
+	{
+	  while (__num_r--)
+	    {
+	      std::iter_swap(__base_r - __offsets_r[__start_r + __num_r],
+			     __first);
+	      ++__first;
+	    }
+	}
+
+      _RandomAccessIterator __pivot_pos = __first - 1;
+      *__begin = *__pivot_pos;
+      *__pivot_pos = __pivot;
+      return __pivot_pos;
+    }
+
+  template<typename _RandomAccessIterator>
+    _GLIBCXX20_CONSTEXPR
+    inline _RandomAccessIterator
+    __partition_right(_RandomAccessIterator __first,
+		      _RandomAccessIterator __last,
+		      __gnu_cxx::__ops::_Iter_less_iter,
+		      bool& __already, __true_type)
+    {
+#ifdef _GLIBCXX_HAVE_BUILTIN_IS_CONSTANT_EVALUATED
+      if (__builtin_is_constant_evaluated())
+	return std::__partition_right(__first, __last,
+				      __gnu_cxx::__ops::__iter_less_iter(),
+				      __already, __false_type());
+#endif
+      return std::__partition_right_branchless(__first, __last, __already);
+    }
+
+  /// This is a helper function for the sort routine.
+  // Partition [__first, __last) around the pivot *__first, putting the
+  // elements equivalent to the pivot on the left, and return the final
+  // position of the pivot.  There must be an element not greater than the
+  // pivot in (__first, __last).
+  template<typename _RandomAccessIterator, typename _Compare>
+    _GLIBCXX20_CONSTEXPR
+    _RandomAccessIterator
+    __partition_left(_RandomAccessIterator __first,
+		     _RandomAccessIterator __last, _Compare __comp)
+    {
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+
+      _ValueType __pivot = _GLIBCXX_MOVE(*__first);
+      _RandomAccessIterator __begin = __first;
+      _RandomAccessIterator __end = __last;
+      __decltype(__gnu_cxx::__ops::__val_comp_iter(__comp)) __less
+	= __gnu_cxx::__ops::__val_comp_iter(__comp);
+
+      while (__less(__pivot, --__last))
+	{ }
+      if (__last + 1 == __end)
+	while (__first < __last && !__less(__pivot, ++__first))
+	  { }
+      else
+	while (!__less(__pivot, ++__first))
+	  { }
+
+      while (__first < __last)
+	{
+	  std::iter_swap(__first, __last);
+	  while (__less(__pivot, --__last))
+	    { }
+	  while (!__less(__pivot, ++__first))
+	    { }
+	}
+
+      *__begin = _GLIBCXX_MOVE(*__last);
+      *__last = _GLIBCXX_MOVE(__pivot);
+      return __last;
+    }
+
+  /// This is a helper function for the sort routine.
+  // Pattern-defeating quicksort, after Orson Peters' pdqsort.  Compared
+  // with introsort it adds:
+  //  - a pseudomedian of nine for the pivot of large ranges;
+  //  - a partition that puts elements equal to the previous pivot on the
+  //    left, so that ranges with many equal keys take linear time;
+  //  - an attempt to finish with a bounded insertion sort when partitioning
+  //    moved nothing, so that sorted and nearly sorted input takes linear
+  //    time;
+  //  - shuffling a few elements after an unbalanced partition to break up
+  //    patterns, and a fallback to heapsort after __bad_allowed of them,
+  //    which keeps the worst case O(N log N).
+  // If __leftmost is false the element before __first is not greater than
+  // any element in the range.
+  template<typename _RandomAccessIterator, typename _Compare,
+	   typename _Branchless>
     _GLIBCXX20_CONSTEXPR
     void
-    __introsort_loop(_RandomAccessIterator __first,
-		     _RandomAccessIterator __last,
-		     _Size __depth_limit, _Compare __comp)
+    __pdqsort_loop(_RandomAccessIterator __first,
+		   _RandomAccessIterator __last, _Compare __comp,
+		   int __bad_allowed, bool __leftmost, _Branchless __tag)
     {
-      while (__last - __first > int(_S_threshold))
+      typedef typename iterator_traits<_RandomAccessIterator>::difference_type
+	_DistanceType;
+
+      while (true)
 	{
-	  if (__depth_limit == 0)
+	  const _DistanceType __size = __last - __first;
+	  if (__size < int(_S_threshold))
 	    {
-	      std::__partial_sort(__first, __last, __last, __comp);
+	      if (__leftmost)
+		std::__insertion_sort(__first, __last, __comp);
+	      else
+		std::__unguarded_insertion_sort(__first, __last, __comp);
 	      return;
 	    }
-	  --__depth_limit;
-	  _RandomAccessIterator __cut =
-	    std::__unguarded_partition_pivot(__first, __last, __comp);
-	  std::__introsort_loop(__cut, __last, __depth_limit, __comp);
-	  __last = __cut;
+
+	  // Put the pivot at __first.
+	  const _DistanceType __half = __size / 2;
+	  if (__size > int(_S_ninther_threshold))
+	    {
+	      std::__sort3(__first, __first + __half, __last - 1, __comp);
+	      std::__sort3(__first + 1, __first + (__half - 1), __last - 2,
+			   __comp);
+	      std::__sort3(__first + 2, __first + (__half + 1), __last - 3,
+			   __comp);
+	      std::__sort3(__first + (__half - 1), __first + __half,
+			   __first + (__half + 1), __comp);
+	      std::iter_swap(__first, __first + __half);
+	    }
+	  else
+	    std::__sort3(__first + __half, __first, __last - 1, __comp);
+
+	  // If the pivot is equal to the previous one, which is not greater
+	  // than anything in the range, all the elements equal to it are
+	  // already sorted once they are moved to the left.
+	  if (!__leftmost && !__comp(__first - 1, __first))
+	    {
+	      __first = std::__partition_left(__first, __last, __comp) + 1;
+	      continue;
+	    }
+
+	  bool __already = false;
+	  _RandomAccessIterator __pivot_pos
+	    = std::__partition_right(__first, __last, __comp, __already, __tag);
+
+	  const _DistanceType __l_size = __pivot_pos - __first;
+	  const _DistanceType __r_size = __last - (__pivot_pos + 1);
+	  if (__l_size < __size / 8 || __r_size < __size / 8)
+	    {
+	      if (--__bad_allowed == 0)
+		{
+		  std::__partial_sort(__first, __last, __last, __comp);
+		  return;
+		}
+
+	      if (__l_size >= int(_S_threshold))
+		{
+		  const _DistanceType __q = __l_size / 4;
+		  std::iter_swap(__first, __first + __q);
+		  std::iter_swap(__pivot_pos - 1, __pivot_pos - __q);
+		  if (__l_size > int(_S_ninther_threshold))
+		    {
+		      std::iter_swap(__first + 1, __first + (__q + 1));
+		      std::iter_swap(__first + 2, __first + (__q + 2));
+		      std::iter_swap(__pivot_pos - 2, __pivot_pos - (__q + 1));
+		      std::iter_swap(__pivot_pos - 3, __pivot_pos - (__q + 2));
+		    }
+		}
+	      if (__r_size >= int(_S_threshold))
+		{
+		  const _DistanceType __q = __r_size / 4;
+		  std::iter_swap(__pivot_pos + 1, __pivot_pos + (1 + __q));
+		  std::iter_swap(__last - 1, __last - __q);
+		  if (__r_size > int(_S_ninther_threshold))
+		    {
+		      std::iter_swap(__pivot_pos + 2, __pivot_pos + (2 + __q));
+		      std::iter_swap(__pivot_pos + 3, __pivot_pos + (3 + __q));
+		      std::iter_swap(__last - 2, __last - (1 + __q));
+		      std::iter_swap(__last - 3, __last - (2 + __q));
+		    }
+		}
+	    }
+	  else if (__already
+		   && std::__partial_insertion_sort(__first, __pivot_pos, __comp)
+		   && std::__partial_insertion_sort(__pivot_pos + 1, __last,
+						    __comp))
+	    return;
+
+	  std::__pdqsort_loop(__first, __pivot_pos, __comp, __bad_allowed,
+			      __leftmost, __tag);
+	  __first = __pivot_pos + 1;
+	  __leftmost = false;
 	}
     }
 
@@ -2039,13 +2490,23 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     __sort(_RandomAccessIterator __first, _RandomAccessIterator __last,
 	   _Compare __comp)
     {
+      typedef typename iterator_traits<_RandomAccessIterator>::value_type
+	_ValueType;
+#if __cplusplus > 201703L && !defined _GLIBCXX_HAVE_BUILTIN_IS_CONSTANT_EVALUATED
+      // Block partitioning cannot be used in constant expressions.
+      typedef __false_type _Branchless;
+#else
+      // When comparing is just operator< on an arithmetic type the cost of
+      // partitioning is mostly mispredicted branches, so avoid them.
+      typedef typename std::__truth_type<
+	__is_arithmetic<_ValueType>::__value
+	&& __are_same<_Compare, __gnu_cxx::__ops::_Iter_less_iter>::__value
+	>::__type _Branchless;
+#endif
+
       if (__first != __last)
-	{
-	  std::__introsort_loop(__first, __last,
-				std::__lg(__last - __first) * 2,
-				__comp);
-	  std::__final_insertion_sort(__first, __last, __comp);
-	}
+	std::__pdqsort_loop(__first, __last, __comp,
+			    std::__lg(__last - __first), true, _Branchless());
     }
 
   template<typename _RandomAccessIterator, typename _Size, typename _Compare>
@@ -3291,6 +3752,41 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       return __n;
     }
 
+#ifdef _GLIBCXX_SIMD_ALGORITHMS
+  /// This is an overload used by count for contiguous ranges of arithmetic
+  /// types.
+  template<typename _Tp, typename _Value>
+    _GLIBCXX20_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_algo_value<_Tp, _Value>::__value, ptrdiff_t>::__type
+    __count_if(_Tp* __first, _Tp* __last,
+	       __gnu_cxx::__ops::_Iter_equals_val<_Value> __pred)
+    {
+      if (std::__use_simd_algo())
+	{
+	  typedef typename __simd_algo_scalar<_Tp>::__type _Scalar;
+	  // No element is equal to a value that _Tp cannot represent.
+	  if (_Scalar(__pred._M_value) != __pred._M_value)
+	    return 0;
+	  return std::__simd_count(__first, __last, _Scalar(__pred._M_value));
+	}
+      ptrdiff_t __n = 0;
+      for (; __first != __last; ++__first)
+	if (__pred(__first))
+	  ++__n;
+      return __n;
+    }
+
+  template<typename _Tp, typename _Container, typename _Value>
+    _GLIBCXX20_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_algo_value<_Tp, _Value>::__value, ptrdiff_t>::__type
+    __count_if(__gnu_cxx::__normal_iterator<_Tp*, _Container> __first,
+	       __gnu_cxx::__normal_iterator<_Tp*, _Container> __last,
+	       __gnu_cxx::__ops::_Iter_equals_val<_Value> __pred)
+    { return std::__count_if(__first.base(), __last.base(), __pred); }
+#endif
+
 #if __cplusplus >= 201103L
   /**
    *  @brief  Determines whether the elements of a sequence are sorted.
@@ -5786,6 +6282,47 @@ _GLIBCXX_BEGIN_NAMESPACE_ALGO
       return __result;
     }
 
+#ifdef _GLIBCXX_SIMD_ALGORITHMS
+  /// This is an overload used by min_element for contiguous ranges of
+  /// integers.  With floating-point types the result depends on the
+  /// order of the comparisons when there are NaNs.
+  template<typename _Tp>
+    _GLIBCXX14_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_algo_value<_Tp, _Tp>::__value
+      && __is_integer<typename __simd_algo_scalar<_Tp>::__type>::__value,
+      _Tp*>::__type
+    __min_element(_Tp* __first, _Tp* __last,
+		  __gnu_cxx::__ops::_Iter_less_iter __comp)
+    {
+      if (__first == __last)
+	return __first;
+      if (std::__use_simd_algo())
+	return std::__simd_min_element<false>(__first, __last);
+      _Tp* __result = __first;
+      while (++__first != __last)
+	if (__comp(__first, __result))
+	  __result = __first;
+      return __result;
+    }
+
+  template<typename _Tp, typename _Container>
+    _GLIBCXX14_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_algo_value<_Tp, _Tp>::__value
+      && __is_integer<typename __simd_algo_scalar<_Tp>::__type>::__value,
+      __gnu_cxx::__normal_iterator<_Tp*, _Container> >::__type
+    __min_element(__gnu_cxx::__normal_iterator<_Tp*, _Container> __first,
+		  __gnu_cxx::__normal_iterator<_Tp*, _Container> __last,
+		  __gnu_cxx::__ops::_Iter_less_iter __comp)
+    {
+      return std::__niter_wrap(__first,
+			       _GLIBCXX_STD_A::__min_element(__first.base(),
+							     __last.base(),
+							     __comp));
+    }
+#endif
+
   /**
    *  @brief  Return the minimum element in a range.
    *  @ingroup sorting_algorithms
@@ -5850,6 +6387,47 @@ _GLIBCXX_BEGIN_NAMESPACE_ALGO
       return __result;
     }
 
+#ifdef _GLIBCXX_SIMD_ALGORITHMS
+  /// This is an overload used by max_element for contiguous ranges of
+  /// integers.  With floating-point types the result depends on the
+  /// order of the comparisons when there are NaNs.
+  template<typename _Tp>
+    _GLIBCXX14_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_algo_value<_Tp, _Tp>::__value
+      && __is_integer<typename __simd_algo_scalar<_Tp>::__type>::__value,
+      _Tp*>::__type
+    __max_element(_Tp* __first, _Tp* __last,
+		  __gnu_cxx::__ops::_Iter_less_iter __comp)
+    {
+      if (__first == __last)
+	return __first;
+      if (std::__use_simd_algo())
+	return std::__simd_min_element<true>(__first, __last);
+      _Tp* __result = __first;
+      while (++__first != __last)
+	if (__comp(__result, __first))
+	  __result = __first;
+      return __result;
+    }
+
+  template<typename _Tp, typename _Container>
+    _GLIBCXX14_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_algo_value<_Tp, _Tp>::__value
+      && __is_integer<typename __simd_algo_scalar<_Tp>::__type>::__value,
+      __gnu_cxx::__normal_iterator<_Tp*, _Container> >::__type
+    __max_element(__gnu_cxx::__normal_iterator<_Tp*, _Container> __first,
+		  __gnu_cxx::__normal_iterator<_Tp*, _Container> __last,
+		  __gnu_cxx::__ops::_Iter_less_iter __comp)
+    {
+      return std::__niter_wrap(__first,
+			       _GLIBCXX_STD_A::__max_element(__first.base(),
+							     __last.base(),
+							     __comp));
+    }
+#endif
+
   /**
    *  @brief  Return the maximum element in a range.
    *  @ingroup sorting_algorithms
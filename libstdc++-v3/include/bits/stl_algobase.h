@@ -69,6 +69,7 @@
 #include <debug/debug.h>
 #include <bits/move.h> // For std::swap
 #include <bits/predefined_ops.h>
+#include <bits/simd_algo.h>
 #if __cplusplus >= 201103L
 # include <type_traits>
 #endif
@@ -496,6 +497,32 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
     __copy_move_a2(istreambuf_iterator<_CharT, char_traits<_CharT> >,
 		   istreambuf_iterator<_CharT, char_traits<_CharT> >, _CharT*);
 
+_GLIBCXX_BEGIN_NAMESPACE_CONTAINER
+
+  template<typename _Tp, typename _Ref, typename _Ptr>
+    struct _Deque_iterator;
+
+_GLIBCXX_END_NAMESPACE_CONTAINER
+
+  // Helpers for deque iterators, copying one node's buffer at a time.
+  // Defined in <bits/deque.tcc>.
+  template<bool _IsMove, typename _Tp, typename _Ref, typename _Ptr,
+	   typename _OI>
+    _OI
+    __copy_move_a2(_GLIBCXX_STD_C::_Deque_iterator<_Tp, _Ref, _Ptr>,
+		   _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Ref, _Ptr>, _OI);
+
+  template<bool _IsMove, typename _II, typename _Tp>
+    _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Tp&, _Tp*>
+    __copy_move_a2(_II, _II, _GLIBCXX_STD_C::_Deque_iterator<_Tp, _Tp&, _Tp*>);
+
+  template<bool _IsMove, typename _ITp, typename _IRef, typename _IPtr,
+	   typename _OTp>
+    _GLIBCXX_STD_C::_Deque_iterator<_OTp, _OTp&, _OTp*>
+    __copy_move_a2(_GLIBCXX_STD_C::_Deque_iterator<_ITp, _IRef, _IPtr>,
+		   _GLIBCXX_STD_C::_Deque_iterator<_ITp, _IRef, _IPtr>,
+		   _GLIBCXX_STD_C::_Deque_iterator<_OTp, _OTp&, _OTp*>);
+
   template<bool _IsMove, typename _II, typename _OI>
     _GLIBCXX20_CONSTEXPR
     inline _OI
@@ -1001,6 +1028,24 @@ _GLIBCXX_BEGIN_NAMESPACE_VERSION
       return std::__equal<__simple>::equal(__first1, __last1, __first2);
     }
 
+#ifdef _GLIBCXX_SIMD_ALGORITHMS
+  // Integers are compared with memcmp, but that is wrong for -0.0 and NaN.
+  template<typename _Tp, typename _Up>
+    _GLIBCXX20_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<__is_floating<
+      typename __simd_algo_scalar<_Tp>::__type>::__value
+      && __is_simd_algo_type<typename __simd_algo_scalar<_Tp>::__type>::__value
+      && __are_same<typename __simd_algo_scalar<_Tp>::__type,
+		    typename __simd_algo_scalar<_Up>::__type>::__value,
+      bool>::__type
+    __equal_aux(_Tp* __first1, _Tp* __last1, _Up* __first2)
+    {
+      if (std::__use_simd_algo())
+	return std::__simd_mismatch(__first1, __last1, __first2) == __last1;
+      return std::__equal<false>::equal(__first1, __last1, __first2);
+    }
+#endif
+
   template<typename, typename>
     struct __lc_rai
     {
@@ -1471,6 +1516,63 @@ _GLIBCXX_BEGIN_NAMESPACE_ALGO
       return pair<_InputIterator1, _InputIterator2>(__first1, __first2);
     }
 
+#ifdef _GLIBCXX_SIMD_ALGORITHMS
+  template<typename _Tp, typename _Up>
+    struct __is_simd_mismatch
+    {
+      typedef typename __simd_algo_scalar<_Tp>::__type _Tp1;
+
+      enum
+	{
+	  __value = __is_simd_algo_type<_Tp1>::__value
+	    && __are_same<_Tp1,
+			  typename __simd_algo_scalar<_Up>::__type>::__value
+	};
+    };
+
+  /// This is an overload used by mismatch for contiguous ranges of
+  /// arithmetic types.
+  template<typename _Tp, typename _Up>
+    _GLIBCXX20_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_mismatch<_Tp, _Up>::__value, pair<_Tp*, _Up*> >::__type
+    __mismatch(_Tp* __first1, _Tp* __last1, _Up* __first2,
+	       __gnu_cxx::__ops::_Iter_equal_to_iter __binary_pred)
+    {
+      if (!std::__use_simd_algo())
+	{
+	  while (__first1 != __last1 && __binary_pred(__first1, __first2))
+	    {
+	      ++__first1;
+	      ++__first2;
+	    }
+	  return pair<_Tp*, _Up*>(__first1, __first2);
+	}
+      _Tp* __mid = std::__simd_mismatch(__first1, __last1, __first2);
+      return pair<_Tp*, _Up*>(__mid, __first2 + (__mid - __first1));
+    }
+
+  template<typename _Tp, typename _Up, typename _Cont1, typename _Cont2>
+    _GLIBCXX20_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_mismatch<_Tp, _Up>::__value,
+      pair<__gnu_cxx::__normal_iterator<_Tp*, _Cont1>,
+	   __gnu_cxx::__normal_iterator<_Up*, _Cont2> > >::__type
+    __mismatch(__gnu_cxx::__normal_iterator<_Tp*, _Cont1> __first1,
+	       __gnu_cxx::__normal_iterator<_Tp*, _Cont1> __last1,
+	       __gnu_cxx::__normal_iterator<_Up*, _Cont2> __first2,
+	       __gnu_cxx::__ops::_Iter_equal_to_iter __binary_pred)
+    {
+      pair<_Tp*, _Up*> __res
+	= _GLIBCXX_STD_A::__mismatch(__first1.base(), __last1.base(),
+				     __first2.base(), __binary_pred);
+      return pair<__gnu_cxx::__normal_iterator<_Tp*, _Cont1>,
+		  __gnu_cxx::__normal_iterator<_Up*, _Cont2> >
+	(std::__niter_wrap(__first1, __res.first),
+	 std::__niter_wrap(__first2, __res.second));
+    }
+#endif
+
   /**
    *  @brief Finds the places in ranges which don't match.
    *  @ingroup non_mutating_algorithms
@@ -1553,6 +1655,39 @@ _GLIBCXX_BEGIN_NAMESPACE_ALGO
       return pair<_InputIterator1, _InputIterator2>(__first1, __first2);
     }
 
+#ifdef _GLIBCXX_SIMD_ALGORITHMS
+  template<typename _Tp, typename _Up>
+    _GLIBCXX20_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_mismatch<_Tp, _Up>::__value, pair<_Tp*, _Up*> >::__type
+    __mismatch(_Tp* __first1, _Tp* __last1, _Up* __first2, _Up* __last2,
+	       __gnu_cxx::__ops::_Iter_equal_to_iter __binary_pred)
+    {
+      if (__last2 - __first2 < __last1 - __first1)
+	__last1 = __first1 + (__last2 - __first2);
+      return _GLIBCXX_STD_A::__mismatch(__first1, __last1, __first2,
+					__binary_pred);
+    }
+
+  template<typename _Tp, typename _Up, typename _Cont1, typename _Cont2>
+    _GLIBCXX20_CONSTEXPR
+    inline typename __gnu_cxx::__enable_if<
+      __is_simd_mismatch<_Tp, _Up>::__value,
+      pair<__gnu_cxx::__normal_iterator<_Tp*, _Cont1>,
+	   __gnu_cxx::__normal_iterator<_Up*, _Cont2> > >::__type
+    __mismatch(__gnu_cxx::__normal_iterator<_Tp*, _Cont1> __first1,
+	       __gnu_cxx::__normal_iterator<_Tp*, _Cont1> __last1,
+	       __gnu_cxx::__normal_iterator<_Up*, _Cont2> __first2,
+	       __gnu_cxx::__normal_iterator<_Up*, _Cont2> __last2,
+	       __gnu_cxx::__ops::_Iter_equal_to_iter __binary_pred)
+    {
+      if (__last2 - __first2 < __last1 - __first1)
+	__last1 = __first1 + (__last2 - __first2);
+      return _GLIBCXX_STD_A::__mismatch(__first1, __last1, __first2,
+					__binary_pred);
+    }
+#endif
+
   /**
    *  @brief Finds the places in ranges which don't match.
    *  @ingroup non_mutating_algorithms
@@ -0,0 +1,1287 @@
+// B-tree implementation -*- C++ -*-
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/btree.h
+ *  This is an internal header file, included by other library headers.
+ *  Do not attempt to use it directly. @headername{ext/btree_map,
+ *  ext/btree_set}
+ */
+
+#ifndef _EXT_BTREE_H
+#define _EXT_BTREE_H 1
+
+#pragma GCC system_header
+
+#if __cplusplus < 201103L
+# include <bits/c++0x_warning.h>
+#else
+
+#include <type_traits>
+#include <initializer_list>
+#include <bits/stl_function.h>
+#include <bits/stl_iterator_base_types.h>
+#include <bits/stl_iterator_base_funcs.h>
+#include <bits/stl_iterator.h>
+#include <bits/stl_algobase.h>
+#include <bits/functexcept.h>
+#include <bits/allocator.h>
+#include <bits/alloc_traits.h>
+#include <bits/ptr_traits.h>
+#include <ext/aligned_buffer.h>
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  // Every node holds up to _S_slots values in sorted order, and an
+  // internal node also holds _S_slots + 1 pointers to its children, the
+  // values of child N sorting between values N - 1 and N of the node.
+  // All leaves are at the same depth, and every node but the root holds
+  // at least one value.
+  //
+  // The number of slots is chosen so that a leaf takes about
+  // __btree_node_size bytes, four cache lines, so that a search reads a
+  // few contiguous lines per level instead of one node per comparison.
+  //
+  // Inserting into a full node splits it, moving one value up to its
+  // parent and the values after it to a new sibling.  The split is at the
+  // middle, or next to the new value when that is first or last, so that
+  // inserting in ascending or descending order fills the nodes, but this
+  // can leave a node with a single value.  Erasing from a node
+  // that then holds fewer than _S_min_values values merges it with a
+  // sibling when their values fit in one node, or moves a value from a
+  // sibling otherwise.
+
+  constexpr std::size_t __btree_node_size = 256;
+
+  template<typename _Value>
+    struct __btree_node
+    {
+      static constexpr std::size_t _S_fit
+	= (__btree_node_size - 2 * sizeof(void*)) / sizeof(_Value);
+
+      static constexpr unsigned _S_slots
+	= _S_fit < 3 ? 3 : _S_fit > 255 ? 255 : _S_fit;
+
+      static constexpr unsigned _S_min_values = _S_slots / 2;
+
+      _Value*
+      _M_valptr(unsigned __i) noexcept
+      { return _M_slots[__i]._M_ptr(); }
+
+      const _Value*
+      _M_valptr(unsigned __i) const noexcept
+      { return _M_slots[__i]._M_ptr(); }
+
+      __btree_node* _M_parent;
+      // The index of this node in the children of its parent.
+      unsigned short _M_pos;
+      unsigned short _M_count;
+      bool _M_leaf;
+      __aligned_membuf<_Value> _M_slots[_S_slots];
+    };
+
+  template<typename _Value>
+    struct __btree_internal : __btree_node<_Value>
+    {
+      __btree_node<_Value>* _M_children[__btree_node<_Value>::_S_slots + 1];
+    };
+
+  template<typename _Value>
+    inline __btree_node<_Value>*&
+    __btree_child(__btree_node<_Value>* __n, unsigned __i) noexcept
+    { return static_cast<__btree_internal<_Value>*>(__n)->_M_children[__i]; }
+
+  // Whether _Compare allows heterogeneous lookup.
+  template<typename _Compare, typename = void>
+    struct __btree_is_transparent : std::false_type
+    { };
+
+  template<typename _Compare>
+    struct __btree_is_transparent<_Compare,
+				  std::__void_t<typename
+						_Compare::is_transparent>>
+    : std::true_type
+    { };
+
+  // An iterator is a node and the index of a value in it.  The end
+  // iterator is the position after the last value of the rightmost leaf.
+  template<bool _Const, typename _Value>
+    class __btree_iterator
+    {
+      template<typename, typename, typename, typename, typename>
+	friend class __btree;
+      friend class __btree_iterator<!_Const, _Value>;
+
+      typedef __btree_node<_Value> _Node;
+
+    public:
+      typedef std::bidirectional_iterator_tag iterator_category;
+      typedef _Value value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef typename std::conditional<_Const, const _Value*,
+					_Value*>::type pointer;
+      typedef typename std::conditional<_Const, const _Value&,
+					_Value&>::type reference;
+
+      __btree_iterator() noexcept
+      : _M_node(nullptr), _M_pos(0)
+      { }
+
+      template<bool _OtherConst,
+	       typename = typename std::enable_if<_Const && !_OtherConst>::type>
+	__btree_iterator(const __btree_iterator<_OtherConst, _Value>& __x)
+	noexcept
+	: _M_node(__x._M_node), _M_pos(__x._M_pos)
+	{ }
+
+      reference
+      operator*() const noexcept
+      { return *_M_node->_M_valptr(_M_pos); }
+
+      pointer
+      operator->() const noexcept
+      { return _M_node->_M_valptr(_M_pos); }
+
+      __btree_iterator&
+      operator++() noexcept
+      {
+	if (!_M_node->_M_leaf)
+	  {
+	    // The next value is the first one of the right subtree.
+	    _M_node = __btree_child(_M_node, _M_pos + 1);
+	    while (!_M_node->_M_leaf)
+	      _M_node = __btree_child(_M_node, 0);
+	    _M_pos = 0;
+	  }
+	else if (++_M_pos == _M_node->_M_count)
+	  {
+	    // The next value is in the first ancestor that is not left by
+	    // its last child.  Stay at the end if there is none.
+	    _Node* __n = _M_node;
+	    unsigned __pos = _M_pos;
+	    while (__pos == __n->_M_count && __n->_M_parent)
+	      {
+		__pos = __n->_M_pos;
+		__n = __n->_M_parent;
+	      }
+	    if (__pos != __n->_M_count)
+	      {
+		_M_node = __n;
+		_M_pos = __pos;
+	      }
+	  }
+	return *this;
+      }
+
+      __btree_iterator
+      operator++(int) noexcept
+      {
+	__btree_iterator __tmp(*this);
+	++*this;
+	return __tmp;
+      }
+
+      __btree_iterator&
+      operator--() noexcept
+      {
+	if (!_M_node->_M_leaf)
+	  {
+	    // The previous value is the last one of the left subtree.
+	    _M_node = __btree_child(_M_node, _M_pos);
+	    while (!_M_node->_M_leaf)
+	      _M_node = __btree_child(_M_node, _M_node->_M_count);
+	    _M_pos = _M_node->_M_count - 1;
+	  }
+	else if (_M_pos > 0)
+	  --_M_pos;
+	else
+	  {
+	    while (_M_pos == 0)
+	      {
+		_M_pos = _M_node->_M_pos;
+		_M_node = _M_node->_M_parent;
+	      }
+	    --_M_pos;
+	  }
+	return *this;
+      }
+
+      __btree_iterator
+      operator--(int) noexcept
+      {
+	__btree_iterator __tmp(*this);
+	--*this;
+	return __tmp;
+      }
+
+      friend bool
+      operator==(const __btree_iterator& __x, const __btree_iterator& __y)
+      noexcept
+      { return __x._M_node == __y._M_node && __x._M_pos == __y._M_pos; }
+
+      friend bool
+      operator!=(const __btree_iterator& __x, const __btree_iterator& __y)
+      noexcept
+      { return !(__x == __y); }
+
+    private:
+      __btree_iterator(_Node* __n, unsigned __pos) noexcept
+      : _M_node(__n), _M_pos(__pos)
+      { }
+
+      _Node* _M_node;
+      unsigned _M_pos;
+    };
+
+  // The tree behind btree_map and btree_set, with unique keys.
+  // _KeyOfValue obtains the key of a _Value.
+  template<typename _Key, typename _Value, typename _KeyOfValue,
+	   typename _Compare, typename _Alloc>
+    class __btree
+    {
+      typedef __btree_node<_Value> _Node;
+      typedef __btree_internal<_Value> _Internal;
+
+      typedef std::allocator_traits<_Alloc> _Alloc_traits0;
+      typedef typename _Alloc_traits0::template rebind_alloc<_Value>
+	_Value_alloc_type;
+      typedef std::allocator_traits<_Value_alloc_type> _Alloc_traits;
+      typedef typename _Alloc_traits::template rebind_alloc<_Node>
+	_Leaf_alloc_type;
+      typedef std::allocator_traits<_Leaf_alloc_type> _Leaf_alloc_traits;
+      typedef typename _Alloc_traits::template rebind_alloc<_Internal>
+	_Internal_alloc_type;
+      typedef std::allocator_traits<_Internal_alloc_type>
+	_Internal_alloc_traits;
+
+      static constexpr unsigned _S_slots = _Node::_S_slots;
+      static constexpr unsigned _S_min_values = _Node::_S_min_values;
+
+      template<typename _Kt>
+	using __if_transparent = typename std::enable_if<
+	  __btree_is_transparent<_Compare>::value
+	  && !std::is_void<_Kt>::value>::type;
+
+    public:
+      typedef _Key key_type;
+      typedef _Value value_type;
+      typedef _Compare key_compare;
+      typedef _Alloc allocator_type;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef value_type& reference;
+      typedef const value_type& const_reference;
+      typedef typename _Alloc_traits::pointer pointer;
+      typedef typename _Alloc_traits::const_pointer const_pointer;
+      // The values of a set are its keys, which must not be modified.
+      typedef __btree_iterator<std::is_same<_Key, _Value>::value, _Value>
+	iterator;
+      typedef __btree_iterator<true, _Value> const_iterator;
+      typedef std::reverse_iterator<iterator> reverse_iterator;
+      typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+      explicit
+      __btree(const key_compare& __comp = key_compare(),
+	      const allocator_type& __a = allocator_type())
+      : _M_cmp(__comp), _M_alloc(__a)
+      { _M_init_empty(); }
+
+      __btree(const __btree& __x)
+      : _M_cmp(__x._M_cmp),
+	_M_alloc(_Alloc_traits::select_on_container_copy_construction
+		 (__x._M_alloc))
+      {
+	_M_init_empty();
+	_M_copy_elements(__x);
+      }
+
+      __btree(const __btree& __x, const allocator_type& __a)
+      : _M_cmp(__x._M_cmp), _M_alloc(__a)
+      {
+	_M_init_empty();
+	_M_copy_elements(__x);
+      }
+
+      __btree(__btree&& __x)
+      noexcept(std::is_nothrow_move_constructible<_Compare>::value)
+      : _M_cmp(std::move(__x._M_cmp)), _M_alloc(std::move(__x._M_alloc))
+      { _M_steal(__x); }
+
+      __btree(__btree&& __x, const allocator_type& __a)
+      : _M_cmp(__x._M_cmp), _M_alloc(__a)
+      {
+	if (_M_alloc == __x._M_alloc)
+	  _M_steal(__x);
+	else
+	  {
+	    _M_init_empty();
+	    _M_move_elements(__x);
+	  }
+      }
+
+      ~__btree()
+      { clear(); }
+
+      __btree&
+      operator=(const __btree& __x)
+      {
+	if (this != std::__addressof(__x))
+	  {
+	    clear();
+	    if (_Alloc_traits::propagate_on_container_copy_assignment::value)
+	      _M_alloc = __x._M_alloc;
+	    _M_cmp = __x._M_cmp;
+	    _M_copy_elements(__x);
+	  }
+	return *this;
+      }
+
+      __btree&
+      operator=(__btree&& __x)
+      noexcept(_Alloc_traits::propagate_on_container_move_assignment::value
+	       && std::is_nothrow_move_assignable<_Compare>::value)
+      {
+	if (this == std::__addressof(__x))
+	  return *this;
+	clear();
+	_M_cmp = std::move(__x._M_cmp);
+	if (_Alloc_traits::propagate_on_container_move_assignment::value
+	    || _M_alloc == __x._M_alloc)
+	  {
+	    if (_Alloc_traits::propagate_on_container_move_assignment::value)
+	      _M_alloc = std::move(__x._M_alloc);
+	    _M_steal(__x);
+	  }
+	else
+	  _M_move_elements(__x);
+	return *this;
+      }
+
+      allocator_type
+      get_allocator() const noexcept
+      { return allocator_type(_M_alloc); }
+
+      key_compare
+      key_comp() const
+      { return _M_cmp; }
+
+      // Iterators.
+
+      iterator
+      begin() noexcept
+      { return iterator(_M_leftmost, 0); }
+
+      const_iterator
+      begin() const noexcept
+      { return const_iterator(_M_leftmost, 0); }
+
+      const_iterator
+      cbegin() const noexcept
+      { return begin(); }
+
+      iterator
+      end() noexcept
+      { return _M_end(); }
+
+      const_iterator
+      end() const noexcept
+      { return _M_end(); }
+
+      const_iterator
+      cend() const noexcept
+      { return end(); }
+
+      reverse_iterator
+      rbegin() noexcept
+      { return reverse_iterator(end()); }
+
+      const_reverse_iterator
+      rbegin() const noexcept
+      { return const_reverse_iterator(end()); }
+
+      const_reverse_iterator
+      crbegin() const noexcept
+      { return rbegin(); }
+
+      reverse_iterator
+      rend() noexcept
+      { return reverse_iterator(begin()); }
+
+      const_reverse_iterator
+      rend() const noexcept
+      { return const_reverse_iterator(begin()); }
+
+      const_reverse_iterator
+      crend() const noexcept
+      { return rend(); }
+
+      // Capacity.
+
+      bool
+      empty() const noexcept
+      { return _M_size == 0; }
+
+      size_type
+      size() const noexcept
+      { return _M_size; }
+
+      size_type
+      max_size() const noexcept
+      { return _Alloc_traits::max_size(_M_alloc); }
+
+      // Lookup.
+
+      iterator
+      find(const key_type& __k)
+      { return _M_find(__k); }
+
+      const_iterator
+      find(const key_type& __k) const
+      { return _M_find(__k); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	iterator
+	find(const _Kt& __k)
+	{ return _M_find(__k); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	const_iterator
+	find(const _Kt& __k) const
+	{ return _M_find(__k); }
+
+      size_type
+      count(const key_type& __k) const
+      { return _M_find(__k) != end(); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	size_type
+	count(const _Kt& __k) const
+	{ return _M_find(__k) != end(); }
+
+      bool
+      contains(const key_type& __k) const
+      { return _M_find(__k) != end(); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	bool
+	contains(const _Kt& __k) const
+	{ return _M_find(__k) != end(); }
+
+      iterator
+      lower_bound(const key_type& __k)
+      { return _M_lower_bound(__k); }
+
+      const_iterator
+      lower_bound(const key_type& __k) const
+      { return _M_lower_bound(__k); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	iterator
+	lower_bound(const _Kt& __k)
+	{ return _M_lower_bound(__k); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	const_iterator
+	lower_bound(const _Kt& __k) const
+	{ return _M_lower_bound(__k); }
+
+      iterator
+      upper_bound(const key_type& __k)
+      { return _M_upper_bound(__k); }
+
+      const_iterator
+      upper_bound(const key_type& __k) const
+      { return _M_upper_bound(__k); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	iterator
+	upper_bound(const _Kt& __k)
+	{ return _M_upper_bound(__k); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	const_iterator
+	upper_bound(const _Kt& __k) const
+	{ return _M_upper_bound(__k); }
+
+      std::pair<iterator, iterator>
+      equal_range(const key_type& __k)
+      { return _M_equal_range(__k); }
+
+      std::pair<const_iterator, const_iterator>
+      equal_range(const key_type& __k) const
+      { return _M_equal_range(__k); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	std::pair<iterator, iterator>
+	equal_range(const _Kt& __k)
+	{ return _M_equal_range(__k); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	std::pair<const_iterator, const_iterator>
+	equal_range(const _Kt& __k) const
+	{ return _M_equal_range(__k); }
+
+      // Modifiers.
+
+      std::pair<iterator, bool>
+      insert(const value_type& __v)
+      { return _M_try_emplace(_KeyOfValue()(__v), __v); }
+
+      std::pair<iterator, bool>
+      insert(value_type&& __v)
+      { return _M_try_emplace(_KeyOfValue()(__v), std::move(__v)); }
+
+      iterator
+      insert(const_iterator __hint, const value_type& __v)
+      { return _M_try_emplace_hint(__hint, _KeyOfValue()(__v), __v); }
+
+      iterator
+      insert(const_iterator __hint, value_type&& __v)
+      {
+	return _M_try_emplace_hint(__hint, _KeyOfValue()(__v),
+				   std::move(__v));
+      }
+
+      // Sorted input is appended to the rightmost leaf.
+      template<typename _InputIterator>
+	void
+	insert(_InputIterator __first, _InputIterator __last)
+	{
+	  for (; __first != __last; ++__first)
+	    emplace_hint(cend(), *__first);
+	}
+
+      void
+      insert(std::initializer_list<value_type> __l)
+      { insert(__l.begin(), __l.end()); }
+
+      // Construct a value from __args first, since its key is not known
+      // until then, and move it into the tree if its key is new.
+      template<typename... _Args>
+	std::pair<iterator, bool>
+	emplace(_Args&&... __args)
+	{
+	  _Scoped_value __buf(*this, std::forward<_Args>(__args)...);
+	  return _M_try_emplace(_KeyOfValue()(__buf._M_value()),
+				std::move(__buf._M_value()));
+	}
+
+      template<typename... _Args>
+	iterator
+	emplace_hint(const_iterator __hint, _Args&&... __args)
+	{
+	  _Scoped_value __buf(*this, std::forward<_Args>(__args)...);
+	  return _M_try_emplace_hint(__hint, _KeyOfValue()(__buf._M_value()),
+				     std::move(__buf._M_value()));
+	}
+
+      // Insert the value constructed from __args unless an element with
+      // key __k exists, in which case nothing is constructed.
+      template<typename _Kt, typename... _Args>
+	std::pair<iterator, bool>
+	_M_try_emplace(const _Kt& __k, _Args&&... __args)
+	{
+	  _Node* __n = _M_root;
+	  unsigned __i = 0;
+	  while (__n)
+	    {
+	      __i = _M_lower_index(__n, __k);
+	      if (__i < __n->_M_count
+		  && !_M_cmp(__k, _KeyOfValue()(*__n->_M_valptr(__i))))
+		return std::make_pair(iterator(__n, __i), false);
+	      if (__n->_M_leaf)
+		break;
+	      __n = __btree_child(__n, __i);
+	    }
+	  return std::make_pair(_M_insert_at(__n, __i,
+					     std::forward<_Args>(__args)...),
+				true);
+	}
+
+      // As _M_try_emplace, but only search the tree if __k does not sort
+      // just before __hint.
+      template<typename _Kt, typename... _Args>
+	iterator
+	_M_try_emplace_hint(const_iterator __hint, const _Kt& __k,
+			    _Args&&... __args)
+	{
+	  if ((__hint == cbegin()
+	       || _M_cmp(_KeyOfValue()(*std::prev(__hint)), __k))
+	      && (__hint == cend() || _M_cmp(__k, _KeyOfValue()(*__hint))))
+	    {
+	      // Insert at the leaf position just before __hint.
+	      _Node* __n = __hint._M_node;
+	      unsigned __i = __hint._M_pos;
+	      if (__n && !__n->_M_leaf)
+		{
+		  __n = __btree_child(__n, __i);
+		  while (!__n->_M_leaf)
+		    __n = __btree_child(__n, __n->_M_count);
+		  __i = __n->_M_count;
+		}
+	      return _M_insert_at(__n, __i, std::forward<_Args>(__args)...);
+	    }
+	  return _M_try_emplace(__k, std::forward<_Args>(__args)...).first;
+	}
+
+      iterator
+      erase(const_iterator __pos)
+      { return _M_erase(__pos._M_node, __pos._M_pos); }
+
+      // Erasing invalidates iterators, so count the elements to erase
+      // and erase them one after the other from the returned iterator.
+      iterator
+      erase(const_iterator __first, const_iterator __last)
+      {
+	if (__first == cbegin() && __last == cend())
+	  {
+	    clear();
+	    return end();
+	  }
+	iterator __it(__first._M_node, __first._M_pos);
+	for (size_type __n = std::distance(__first, __last); __n; --__n)
+	  __it = erase(__it);
+	return __it;
+      }
+
+      size_type
+      erase(const key_type& __k)
+      {
+	const_iterator __it = find(__k);
+	if (__it == cend())
+	  return 0;
+	erase(__it);
+	return 1;
+      }
+
+      void
+      clear() noexcept
+      {
+	if (_M_root)
+	  _M_destroy_subtree(_M_root);
+	_M_init_empty();
+      }
+
+      void
+      swap(__btree& __x)
+      noexcept(std::__is_nothrow_swappable<_Compare>::value)
+      {
+	using std::swap;
+	swap(_M_cmp, __x._M_cmp);
+	if (_Alloc_traits::propagate_on_container_swap::value)
+	  swap(_M_alloc, __x._M_alloc);
+	swap(_M_root, __x._M_root);
+	swap(_M_leftmost, __x._M_leftmost);
+	swap(_M_rightmost, __x._M_rightmost);
+	swap(_M_size, __x._M_size);
+      }
+
+      friend bool
+      operator==(const __btree& __x, const __btree& __y)
+      {
+	return __x.size() == __y.size()
+	  && std::equal(__x.begin(), __x.end(), __y.begin());
+      }
+
+      friend bool
+      operator!=(const __btree& __x, const __btree& __y)
+      { return !(__x == __y); }
+
+      friend bool
+      operator<(const __btree& __x, const __btree& __y)
+      {
+	return std::lexicographical_compare(__x.begin(), __x.end(),
+					    __y.begin(), __y.end());
+      }
+
+      friend bool
+      operator>(const __btree& __x, const __btree& __y)
+      { return __y < __x; }
+
+      friend bool
+      operator<=(const __btree& __x, const __btree& __y)
+      { return !(__y < __x); }
+
+      friend bool
+      operator>=(const __btree& __x, const __btree& __y)
+      { return !(__x < __y); }
+
+    private:
+      // Storage for a value constructed before it is moved into the tree.
+      struct _Scoped_value
+      {
+	template<typename... _Args>
+	  _Scoped_value(__btree& __t, _Args&&... __args)
+	  : _M_t(__t)
+	  {
+	    _Alloc_traits::construct(_M_t._M_alloc, _M_addr(),
+				     std::forward<_Args>(__args)...);
+	  }
+
+	~_Scoped_value()
+	{ _Alloc_traits::destroy(_M_t._M_alloc, _M_addr()); }
+
+	_Value*
+	_M_addr() noexcept
+	{ return static_cast<_Value*>(static_cast<void*>(&_M_storage)); }
+
+	_Value&
+	_M_value() noexcept
+	{ return *_M_addr(); }
+
+	__btree& _M_t;
+	typename std::aligned_storage<sizeof(_Value),
+				      alignof(_Value)>::type _M_storage;
+      };
+
+      iterator
+      _M_end() const noexcept
+      {
+	return iterator(_M_rightmost,
+			_M_rightmost ? _M_rightmost->_M_count : 0);
+      }
+
+      void
+      _M_init_empty() noexcept
+      {
+	_M_root = _M_leftmost = _M_rightmost = nullptr;
+	_M_size = 0;
+      }
+
+      // Take over the nodes of __x, leaving it empty.
+      void
+      _M_steal(__btree& __x) noexcept
+      {
+	_M_root = __x._M_root;
+	_M_leftmost = __x._M_leftmost;
+	_M_rightmost = __x._M_rightmost;
+	_M_size = __x._M_size;
+	__x._M_init_empty();
+      }
+
+      void
+      _M_copy_elements(const __btree& __x)
+      {
+	__try
+	  {
+	    for (const_iterator __it = __x.begin(); __it != __x.end(); ++__it)
+	      _M_insert_at(_M_rightmost,
+			   _M_rightmost ? _M_rightmost->_M_count : 0, *__it);
+	  }
+	__catch(...)
+	  {
+	    clear();
+	    __throw_exception_again;
+	  }
+      }
+
+      void
+      _M_move_elements(__btree& __x)
+      {
+	for (iterator __it = __x.begin(); __it != __x.end(); ++__it)
+	  _M_insert_at(_M_rightmost,
+		       _M_rightmost ? _M_rightmost->_M_count : 0,
+		       std::move(*__it));
+	__x.clear();
+      }
+
+      _Node*
+      _M_create_node(bool __leaf)
+      {
+	_Node* __n;
+	if (__leaf)
+	  {
+	    _Leaf_alloc_type __a(_M_alloc);
+	    auto __p = _Leaf_alloc_traits::allocate(__a, 1);
+	    __n = ::new (std::__to_address(__p)) _Node;
+	  }
+	else
+	  {
+	    _Internal_alloc_type __a(_M_alloc);
+	    auto __p = _Internal_alloc_traits::allocate(__a, 1);
+	    __n = ::new (std::__to_address(__p)) _Internal;
+	  }
+	__n->_M_parent = nullptr;
+	__n->_M_pos = 0;
+	__n->_M_count = 0;
+	__n->_M_leaf = __leaf;
+	return __n;
+      }
+
+      void
+      _M_free_node(_Node* __n) noexcept
+      {
+	if (__n->_M_leaf)
+	  {
+	    _Leaf_alloc_type __a(_M_alloc);
+	    _Leaf_alloc_traits::deallocate(__a,
+	      std::pointer_traits<typename _Leaf_alloc_traits::pointer>
+	      ::pointer_to(*__n), 1);
+	  }
+	else
+	  {
+	    _Internal_alloc_type __a(_M_alloc);
+	    _Internal_alloc_traits::deallocate(__a,
+	      std::pointer_traits<typename _Internal_alloc_traits::pointer>
+	      ::pointer_to(*static_cast<_Internal*>(__n)), 1);
+	  }
+      }
+
+      void
+      _M_destroy_subtree(_Node* __n) noexcept
+      {
+	for (unsigned __i = 0; __i < __n->_M_count; ++__i)
+	  _Alloc_traits::destroy(_M_alloc, __n->_M_valptr(__i));
+	if (!__n->_M_leaf)
+	  for (unsigned __i = 0; __i <= __n->_M_count; ++__i)
+	    _M_destroy_subtree(__btree_child(__n, __i));
+	_M_free_node(__n);
+      }
+
+      // Move the value at __src to the uninitialized slot __dst.  Values
+      // are relocated when nodes are split, merged or shifted, which
+      // cannot be undone if a move constructor throws.
+      void
+      _M_relocate(_Value* __dst, _Value* __src) noexcept
+      {
+	_Alloc_traits::construct(_M_alloc, __dst, std::move(*__src));
+	_Alloc_traits::destroy(_M_alloc, __src);
+      }
+
+      static void
+      _S_set_child(_Node* __n, unsigned __i, _Node* __c) noexcept
+      {
+	__btree_child(__n, __i) = __c;
+	__c->_M_parent = __n;
+	__c->_M_pos = __i;
+      }
+
+      // Open a gap at value __i of __n, and at child __i + 1 if __n is
+      // an internal node.  The count of __n is not changed.
+      void
+      _M_shift_right(_Node* __n, unsigned __i) noexcept
+      {
+	for (unsigned __j = __n->_M_count; __j > __i; --__j)
+	  _M_relocate(__n->_M_valptr(__j), __n->_M_valptr(__j - 1));
+	if (!__n->_M_leaf)
+	  for (unsigned __j = __n->_M_count + 1; __j > __i + 1; --__j)
+	    _S_set_child(__n, __j, __btree_child(__n, __j - 1));
+      }
+
+      // Close the gap at value __i of __n, and at child __i + 1 if __n is
+      // an internal node.  The count of __n is not changed.
+      void
+      _M_shift_left(_Node* __n, unsigned __i) noexcept
+      {
+	for (unsigned __j = __i + 1; __j < __n->_M_count; ++__j)
+	  _M_relocate(__n->_M_valptr(__j - 1), __n->_M_valptr(__j));
+	if (!__n->_M_leaf)
+	  for (unsigned __j = __i + 2; __j <= __n->_M_count; ++__j)
+	    _S_set_child(__n, __j - 1, __btree_child(__n, __j));
+      }
+
+      // The key of value __i of __n.
+      static const _Key&
+      _S_key(const _Node* __n, unsigned __i) noexcept
+      { return _KeyOfValue()(*__n->_M_valptr(__i)); }
+
+      // The index of the first value of __n whose key is not less than __k.
+      template<typename _Kt>
+	unsigned
+	_M_lower_index(const _Node* __n, const _Kt& __k) const
+	{
+	  unsigned __lo = 0, __hi = __n->_M_count;
+	  while (__lo < __hi)
+	    {
+	      const unsigned __mid = (__lo + __hi) / 2;
+	      if (_M_cmp(_S_key(__n, __mid), __k))
+		__lo = __mid + 1;
+	      else
+		__hi = __mid;
+	    }
+	  return __lo;
+	}
+
+      // The index of the first value of __n whose key is greater than __k.
+      template<typename _Kt>
+	unsigned
+	_M_upper_index(const _Node* __n, const _Kt& __k) const
+	{
+	  unsigned __lo = 0, __hi = __n->_M_count;
+	  while (__lo < __hi)
+	    {
+	      const unsigned __mid = (__lo + __hi) / 2;
+	      if (!_M_cmp(__k, _S_key(__n, __mid)))
+		__lo = __mid + 1;
+	      else
+		__hi = __mid;
+	    }
+	  return __lo;
+	}
+
+      template<typename _Kt>
+	iterator
+	_M_find(const _Kt& __k) const
+	{
+	  for (_Node* __n = _M_root; __n; )
+	    {
+	      const unsigned __i = _M_lower_index(__n, __k);
+	      if (__i < __n->_M_count && !_M_cmp(__k, _S_key(__n, __i)))
+		return iterator(__n, __i);
+	      if (__n->_M_leaf)
+		break;
+	      __n = __btree_child(__n, __i);
+	    }
+	  return _M_end();
+	}
+
+      // The lower bound is either in the subtree left of the first value
+      // of a node that is not less than __k, or is that value.
+      template<typename _Kt>
+	iterator
+	_M_lower_bound(const _Kt& __k) const
+	{
+	  iterator __res = _M_end();
+	  for (_Node* __n = _M_root; __n; )
+	    {
+	      const unsigned __i = _M_lower_index(__n, __k);
+	      if (__i < __n->_M_count)
+		__res = iterator(__n, __i);
+	      if (__n->_M_leaf)
+		break;
+	      __n = __btree_child(__n, __i);
+	    }
+	  return __res;
+	}
+
+      template<typename _Kt>
+	iterator
+	_M_upper_bound(const _Kt& __k) const
+	{
+	  iterator __res = _M_end();
+	  for (_Node* __n = _M_root; __n; )
+	    {
+	      const unsigned __i = _M_upper_index(__n, __k);
+	      if (__i < __n->_M_count)
+		__res = iterator(__n, __i);
+	      if (__n->_M_leaf)
+		break;
+	      __n = __btree_child(__n, __i);
+	    }
+	  return __res;
+	}
+
+      template<typename _Kt>
+	std::pair<iterator, iterator>
+	_M_equal_range(const _Kt& __k) const
+	{
+	  iterator __first = _M_lower_bound(__k), __last = __first;
+	  if (__first != _M_end() && !_M_cmp(__k, _KeyOfValue()(*__first)))
+	    ++__last;
+	  return std::make_pair(__first, __last);
+	}
+
+      // Construct a value from __args at index __i of the leaf __n, or in
+      // a new root if the tree is empty.
+      template<typename... _Args>
+	iterator
+	_M_insert_at(_Node* __n, unsigned __i, _Args&&... __args)
+	{
+	  if (!__n)
+	    {
+	      __n = _M_root = _M_leftmost = _M_rightmost = _M_create_node(true);
+	      __try
+		{
+		  _Alloc_traits::construct(_M_alloc, __n->_M_valptr(0),
+					   std::forward<_Args>(__args)...);
+		}
+	      __catch(...)
+		{
+		  _M_free_node(__n);
+		  _M_init_empty();
+		  __throw_exception_again;
+		}
+	      __n->_M_count = 1;
+	      _M_size = 1;
+	      return iterator(__n, 0);
+	    }
+
+	  if (__n->_M_count == _S_slots)
+	    _M_split(__n, __i);
+	  _M_shift_right(__n, __i);
+	  __try
+	    {
+	      _Alloc_traits::construct(_M_alloc, __n->_M_valptr(__i),
+				       std::forward<_Args>(__args)...);
+	    }
+	  __catch(...)
+	    {
+	      for (unsigned __j = __i; __j < __n->_M_count; ++__j)
+		_M_relocate(__n->_M_valptr(__j), __n->_M_valptr(__j + 1));
+	      __throw_exception_again;
+	    }
+	  ++__n->_M_count;
+	  ++_M_size;
+	  return iterator(__n, __i);
+	}
+
+      // Split the full node __n, moving its upper values to a new right
+      // sibling and the value before them to its parent, and update __n
+      // and __i to the position where a value is about to be inserted.
+      // Both halves keep at least one value.
+      void
+      _M_split(_Node*& __n, unsigned& __i)
+      {
+	if (!__n->_M_parent)
+	  {
+	    _Node* __root = _M_create_node(false);
+	    _S_set_child(__root, 0, __n);
+	    _M_root = __root;
+	  }
+	else if (__n->_M_parent->_M_count == _S_slots)
+	  {
+	    _Node* __p = __n->_M_parent;
+	    unsigned __pi = __n->_M_pos;
+	    _M_split(__p, __pi);
+	  }
+	_Node* __parent = __n->_M_parent;
+	_Node* __r = _M_create_node(__n->_M_leaf);
+
+	const unsigned __count = __n->_M_count;
+	unsigned __right;
+	if (__i == 0)
+	  __right = __count - 2;
+	else if (__i == __count)
+	  __right = 1;
+	else
+	  __right = __count / 2;
+	const unsigned __left = __count - __right - 1;
+
+	for (unsigned __j = 0; __j < __right; ++__j)
+	  _M_relocate(__r->_M_valptr(__j), __n->_M_valptr(__left + 1 + __j));
+	if (!__n->_M_leaf)
+	  for (unsigned __j = 0; __j <= __right; ++__j)
+	    _S_set_child(__r, __j, __btree_child(__n, __left + 1 + __j));
+	__r->_M_count = __right;
+
+	const unsigned __pi = __n->_M_pos;
+	_M_shift_right(__parent, __pi);
+	_M_relocate(__parent->_M_valptr(__pi), __n->_M_valptr(__left));
+	_S_set_child(__parent, __pi + 1, __r);
+	++__parent->_M_count;
+	__n->_M_count = __left;
+
+	if (__n == _M_rightmost)
+	  _M_rightmost = __r;
+	if (__i > __left)
+	  {
+	    __n = __r;
+	    __i -= __left + 1;
+	  }
+      }
+
+      // Erase value __i of __n and return an iterator to the next value.
+      iterator
+      _M_erase(_Node* __n, unsigned __i) noexcept
+      {
+	_Alloc_traits::destroy(_M_alloc, __n->_M_valptr(__i));
+	const bool __internal = !__n->_M_leaf;
+	if (__internal)
+	  {
+	    // Fill the slot with the previous value, the last one of the
+	    // rightmost leaf of the left subtree, and erase that from its
+	    // leaf instead.
+	    _Node* __leaf = __btree_child(__n, __i);
+	    while (!__leaf->_M_leaf)
+	      __leaf = __btree_child(__leaf, __leaf->_M_count);
+	    _M_relocate(__n->_M_valptr(__i),
+			__leaf->_M_valptr(__leaf->_M_count - 1));
+	    __n = __leaf;
+	    __i = __leaf->_M_count - 1;
+	  }
+	else
+	  _M_shift_left(__n, __i);
+	--__n->_M_count;
+	--_M_size;
+
+	// Index __i of the leaf __n is now the position after the erased
+	// value, or after the value that replaced it.
+	iterator __res = _M_rebalance(__n, __i);
+	if (__internal)
+	  ++__res;
+	return __res;
+      }
+
+      // Restore the minimum number of values in __n and its ancestors
+      // after a value was erased from the leaf __n, and return an iterator
+      // to the position __i of __n, which may be its count.
+      iterator
+      _M_rebalance(_Node* __n, unsigned __i) noexcept
+      {
+	if (_M_size == 0)
+	  {
+	    _M_free_node(_M_root);
+	    _M_init_empty();
+	    return end();
+	  }
+
+	_Node* __c = __n;
+	unsigned __ci = __i;
+	while (__n != _M_root && __n->_M_count < _S_min_values)
+	  {
+	    _Node* __p = __n->_M_parent;
+	    const unsigned __k = __n->_M_pos;
+	    _Node* __left = __k > 0 ? __btree_child(__p, __k - 1) : nullptr;
+	    _Node* __right = __k < __p->_M_count
+	      ? __btree_child(__p, __k + 1) : nullptr;
+	    if (__left && __left->_M_count + __n->_M_count < _S_slots)
+	      {
+		if (__c == __n)
+		  {
+		    __c = __left;
+		    __ci += __left->_M_count + 1;
+		  }
+		_M_merge(__left, __n);
+	      }
+	    else if (__right && __n->_M_count + __right->_M_count < _S_slots)
+	      _M_merge(__n, __right);
+	    else
+	      {
+		// A sibling has values to spare, since it did not fit.
+		if (__right)
+		  _M_rotate_left(__n, __right);
+		else
+		  {
+		    _M_rotate_right(__left, __n);
+		    if (__c == __n)
+		      ++__ci;
+		  }
+		break;
+	      }
+	    __n = __p;
+	  }
+
+	if (!_M_root->_M_leaf && _M_root->_M_count == 0)
+	  {
+	    _Node* __old = _M_root;
+	    _M_root = __btree_child(__old, 0);
+	    _M_root->_M_parent = nullptr;
+	    _M_root->_M_pos = 0;
+	    _M_free_node(__old);
+	  }
+
+	// Climb to the next value if __ci is past the end of __c.
+	while (__ci == __c->_M_count && __c->_M_parent)
+	  {
+	    __ci = __c->_M_pos;
+	    __c = __c->_M_parent;
+	  }
+	if (__ci == __c->_M_count)
+	  return end();
+	return iterator(__c, __ci);
+      }
+
+      // Move the separator between __l and its right sibling __r, and all
+      // the values and children of __r, to the end of __l, and free __r.
+      void
+      _M_merge(_Node* __l, _Node* __r) noexcept
+      {
+	_Node* __p = __l->_M_parent;
+	const unsigned __k = __l->_M_pos;
+	const unsigned __lc = __l->_M_count;
+	_M_relocate(__l->_M_valptr(__lc), __p->_M_valptr(__k));
+	for (unsigned __j = 0; __j < __r->_M_count; ++__j)
+	  _M_relocate(__l->_M_valptr(__lc + 1 + __j), __r->_M_valptr(__j));
+	if (!__l->_M_leaf)
+	  for (unsigned __j = 0; __j <= __r->_M_count; ++__j)
+	    _S_set_child(__l, __lc + 1 + __j, __btree_child(__r, __j));
+	__l->_M_count += 1 + __r->_M_count;
+
+	// The separator has been moved out already.
+	for (unsigned __j = __k + 1; __j < __p->_M_count; ++__j)
+	  _M_relocate(__p->_M_valptr(__j - 1), __p->_M_valptr(__j));
+	for (unsigned __j = __k + 2; __j <= __p->_M_count; ++__j)
+	  _S_set_child(__p, __j - 1, __btree_child(__p, __j));
+	--__p->_M_count;
+
+	if (__r == _M_rightmost)
+	  _M_rightmost = __l;
+	_M_free_node(__r);
+      }
+
+      // Move the separator after __n to its end, and the first value of
+      // its right sibling __r to the separator.
+      void
+      _M_rotate_left(_Node* __n, _Node* __r) noexcept
+      {
+	_Node* __p = __n->_M_parent;
+	const unsigned __k = __n->_M_pos;
+	_M_relocate(__n->_M_valptr(__n->_M_count), __p->_M_valptr(__k));
+	_M_relocate(__p->_M_valptr(__k), __r->_M_valptr(0));
+	if (!__n->_M_leaf)
+	  {
+	    _S_set_child(__n, __n->_M_count + 1, __btree_child(__r, 0));
+	    _S_set_child(__r, 0, __btree_child(__r, 1));
+	  }
+	// Value 0 of __r has been moved out already.
+	_M_shift_left(__r, 0);
+	++__n->_M_count;
+	--__r->_M_count;
+      }
+
+      // Move the separator before __n to its start, and the last value of
+      // its left sibling __l to the separator.
+      void
+      _M_rotate_right(_Node* __l, _Node* __n) noexcept
+      {
+	_Node* __p = __n->_M_parent;
+	const unsigned __k = __l->_M_pos;
+	const unsigned __lc = __l->_M_count;
+	_M_shift_right(__n, 0);
+	_M_relocate(__n->_M_valptr(0), __p->_M_valptr(__k));
+	_M_relocate(__p->_M_valptr(__k), __l->_M_valptr(__lc - 1));
+	if (!__n->_M_leaf)
+	  {
+	    _S_set_child(__n, 1, __btree_child(__n, 0));
+	    _S_set_child(__n, 0, __btree_child(__l, __lc));
+	  }
+	++__n->_M_count;
+	--__l->_M_count;
+      }
+
+      _Compare _M_cmp;
+      _Value_alloc_type _M_alloc;
+      _Node* _M_root;
+      _Node* _M_leftmost;
+      _Node* _M_rightmost;
+      size_type _M_size;
+    };
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace __gnu_cxx
+
+#endif // C++11
+
+#endif // _EXT_BTREE_H
@@ -0,0 +1,1049 @@
+// Open-addressing hash table implementation -*- C++ -*-
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/flat_hashtable.h
+ *  This is an internal header file, included by other library headers.
+ *  Do not attempt to use it directly. @headername{ext/flat_hash_map,
+ *  ext/flat_hash_set}
+ */
+
+#ifndef _EXT_FLAT_HASHTABLE_H
+#define _EXT_FLAT_HASHTABLE_H 1
+
+#pragma GCC system_header
+
+#if __cplusplus < 201103L
+# include <bits/c++0x_warning.h>
+#else
+
+#include <type_traits>
+#include <initializer_list>
+#include <bits/stl_function.h>
+#include <bits/functional_hash.h>
+#include <bits/functexcept.h>
+#include <bits/stl_algobase.h>
+#include <bits/allocator.h>
+#include <bits/alloc_traits.h>
+#include <bits/ptr_traits.h>
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  // The table keeps a power of two number of slots, divided into groups
+  // of __flat_group::_S_width consecutive slots, and a separate array
+  // with one control byte per slot.  A control byte is either one of
+  // the special values below or, for a full slot, seven bits of the
+  // hash of its key.  A lookup loads the control bytes of a whole group
+  // at once, compares them against the seven bits of the hash it looks
+  // for and only then compares keys; a group with an empty slot ends
+  // the search.  Groups are probed quadratically, which visits every
+  // group since their number is a power of two.
+
+  typedef signed char __flat_ctrl_t;
+
+  constexpr __flat_ctrl_t __flat_ctrl_empty = -128;
+  constexpr __flat_ctrl_t __flat_ctrl_deleted = -2;
+  // Follows the last control byte, to stop iterators.
+  constexpr __flat_ctrl_t __flat_ctrl_sentinel = -1;
+
+#if defined __SSE2__ && defined __GNUC__
+  // The control bytes of a group, compared with SSE2 instructions.
+  // Bit N of a mask is set for slot N of the group.
+  struct __flat_group
+  {
+    typedef char __v16qi __attribute__((__vector_size__(16)));
+    typedef unsigned int __mask_type;
+
+    static constexpr std::size_t _S_width = 16;
+    static constexpr int _S_shift = 0;
+
+    explicit
+    __flat_group(const __flat_ctrl_t* __ctrl) noexcept
+    { __builtin_memcpy(&_M_ctrl, __ctrl, sizeof(_M_ctrl)); }
+
+    // The slots whose control byte is __h2.
+    __mask_type
+    _M_match(__flat_ctrl_t __h2) const noexcept
+    {
+      const __v16qi __v = { __h2, __h2, __h2, __h2, __h2, __h2, __h2, __h2,
+			    __h2, __h2, __h2, __h2, __h2, __h2, __h2, __h2 };
+      return __builtin_ia32_pmovmskb128((__v16qi)(_M_ctrl == __v));
+    }
+
+    // The empty slots.
+    __mask_type
+    _M_match_empty() const noexcept
+    { return _M_match(__flat_ctrl_empty); }
+
+    // The empty and deleted slots, whose control byte is negative.
+    __mask_type
+    _M_match_empty_or_deleted() const noexcept
+    { return __builtin_ia32_pmovmskb128(_M_ctrl); }
+
+    __v16qi _M_ctrl;
+  };
+#else
+  // The control bytes of a group, compared as a 64-bit word.
+  // Bit 8 * N + 7 of a mask is set for slot N of the group.
+  struct __flat_group
+  {
+    typedef unsigned long long __mask_type;
+
+    static constexpr std::size_t _S_width = 8;
+    static constexpr int _S_shift = 3;
+
+    explicit
+    __flat_group(const __flat_ctrl_t* __ctrl) noexcept
+    : _M_ctrl(0)
+    {
+      for (std::size_t __i = 0; __i < _S_width; ++__i)
+	_M_ctrl |= (__mask_type)(unsigned char)__ctrl[__i] << (__i * 8);
+    }
+
+    // The slots whose control byte is __h2.  This can report full slots
+    // with another control byte too, which are weeded out when the keys
+    // are compared, but never empty or deleted slots.
+    __mask_type
+    _M_match(__flat_ctrl_t __h2) const noexcept
+    {
+      const __mask_type __x = _M_ctrl ^ (_S_lsbs * (unsigned char)__h2);
+      return (__x - _S_lsbs) & ~__x & _S_msbs;
+    }
+
+    // The empty slots, the only ones with their sign bit set and their
+    // second lowest bit clear.
+    __mask_type
+    _M_match_empty() const noexcept
+    { return _M_ctrl & (~_M_ctrl << 6) & _S_msbs; }
+
+    // The empty and deleted slots, whose control byte is negative.
+    __mask_type
+    _M_match_empty_or_deleted() const noexcept
+    { return _M_ctrl & _S_msbs; }
+
+    static constexpr __mask_type _S_lsbs = 0x0101010101010101ULL;
+    static constexpr __mask_type _S_msbs = 0x8080808080808080ULL;
+
+    __mask_type _M_ctrl;
+  };
+#endif
+
+  // The index within its group of the first slot in __mask.
+  inline std::size_t
+  __flat_group_first(__flat_group::__mask_type __mask) noexcept
+  { return __builtin_ctzll(__mask) >> __flat_group::_S_shift; }
+
+  // Whether _Hash and _Equal both allow heterogeneous lookup with keys
+  // of type _Kt.
+  template<typename _Hash, typename _Equal, typename _Kt, typename = void>
+    struct __flat_is_transparent : std::false_type
+    { };
+
+  template<typename _Hash, typename _Equal, typename _Kt>
+    struct __flat_is_transparent<_Hash, _Equal, _Kt,
+				 std::__void_t<typename _Hash::is_transparent,
+					       typename _Equal::is_transparent>>
+    : std::true_type
+    { };
+
+  template<bool _Const, typename _Value>
+    class __flat_iterator
+    {
+      template<typename, typename, typename, typename, typename, typename>
+	friend class __flat_hashtable;
+      friend class __flat_iterator<!_Const, _Value>;
+
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef _Value value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef typename std::conditional<_Const, const _Value*,
+					_Value*>::type pointer;
+      typedef typename std::conditional<_Const, const _Value&,
+					_Value&>::type reference;
+
+      __flat_iterator() noexcept
+      : _M_ctrl(nullptr), _M_slot(nullptr)
+      { }
+
+      template<bool _OtherConst,
+	       typename = typename std::enable_if<_Const && !_OtherConst>::type>
+	__flat_iterator(const __flat_iterator<_OtherConst, _Value>& __x)
+	noexcept
+	: _M_ctrl(__x._M_ctrl), _M_slot(__x._M_slot)
+	{ }
+
+      reference
+      operator*() const noexcept
+      { return *_M_slot; }
+
+      pointer
+      operator->() const noexcept
+      { return _M_slot; }
+
+      __flat_iterator&
+      operator++() noexcept
+      {
+	++_M_ctrl;
+	++_M_slot;
+	_M_skip_free();
+	return *this;
+      }
+
+      __flat_iterator
+      operator++(int) noexcept
+      {
+	__flat_iterator __tmp(*this);
+	++*this;
+	return __tmp;
+      }
+
+      friend bool
+      operator==(const __flat_iterator& __x, const __flat_iterator& __y)
+      noexcept
+      { return __x._M_ctrl == __y._M_ctrl; }
+
+      friend bool
+      operator!=(const __flat_iterator& __x, const __flat_iterator& __y)
+      noexcept
+      { return __x._M_ctrl != __y._M_ctrl; }
+
+    private:
+      __flat_iterator(const __flat_ctrl_t* __ctrl, _Value* __slot) noexcept
+      : _M_ctrl(__ctrl), _M_slot(__slot)
+      { }
+
+      // Advance to the next full slot or to the sentinel.
+      void
+      _M_skip_free() noexcept
+      {
+	while (*_M_ctrl < __flat_ctrl_sentinel)
+	  {
+	    ++_M_ctrl;
+	    ++_M_slot;
+	  }
+      }
+
+      const __flat_ctrl_t* _M_ctrl;
+      _Value* _M_slot;
+    };
+
+  // The table behind flat_hash_map and flat_hash_set.  _ExtractKey
+  // obtains the key of a _Value.
+  template<typename _Key, typename _Value, typename _ExtractKey,
+	   typename _Hash, typename _Equal, typename _Alloc>
+    class __flat_hashtable
+    {
+      typedef std::allocator_traits<_Alloc> _Alloc_traits0;
+      typedef typename _Alloc_traits0::template rebind_alloc<_Value>
+	_Value_alloc_type;
+      typedef std::allocator_traits<_Value_alloc_type> _Alloc_traits;
+      typedef typename _Alloc_traits::template rebind_alloc<__flat_ctrl_t>
+	_Ctrl_alloc_type;
+      typedef std::allocator_traits<_Ctrl_alloc_type> _Ctrl_alloc_traits;
+      typedef typename _Alloc_traits::pointer _Slot_pointer;
+      typedef typename _Ctrl_alloc_traits::pointer _Ctrl_pointer;
+
+      template<typename _Kt>
+	using __if_transparent = typename std::enable_if<
+	  __flat_is_transparent<_Hash, _Equal, _Kt>::value>::type;
+
+    public:
+      typedef _Key key_type;
+      typedef _Value value_type;
+      typedef _Hash hasher;
+      typedef _Equal key_equal;
+      typedef _Alloc allocator_type;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef value_type& reference;
+      typedef const value_type& const_reference;
+      typedef typename _Alloc_traits::pointer pointer;
+      typedef typename _Alloc_traits::const_pointer const_pointer;
+      typedef __flat_iterator<false, _Value> iterator;
+      typedef __flat_iterator<true, _Value> const_iterator;
+
+      explicit
+      __flat_hashtable(size_type __n = 0, const hasher& __hf = hasher(),
+		       const key_equal& __eql = key_equal(),
+		       const allocator_type& __a = allocator_type())
+      : _M_hash(__hf), _M_eq(__eql), _M_alloc(__a)
+      {
+	_M_init_empty();
+	if (__n)
+	  reserve(__n);
+      }
+
+      __flat_hashtable(const __flat_hashtable& __x)
+      : _M_hash(__x._M_hash), _M_eq(__x._M_eq),
+	_M_alloc(_Alloc_traits::select_on_container_copy_construction
+		 (__x._M_alloc))
+      {
+	_M_init_empty();
+	_M_copy_elements(__x);
+      }
+
+      __flat_hashtable(const __flat_hashtable& __x, const allocator_type& __a)
+      : _M_hash(__x._M_hash), _M_eq(__x._M_eq), _M_alloc(__a)
+      {
+	_M_init_empty();
+	_M_copy_elements(__x);
+      }
+
+      __flat_hashtable(__flat_hashtable&& __x)
+      noexcept(std::is_nothrow_move_constructible<_Hash>::value
+	       && std::is_nothrow_move_constructible<_Equal>::value)
+      : _M_hash(std::move(__x._M_hash)), _M_eq(std::move(__x._M_eq)),
+	_M_alloc(std::move(__x._M_alloc))
+      {
+	_M_steal(__x);
+      }
+
+      __flat_hashtable(__flat_hashtable&& __x, const allocator_type& __a)
+      : _M_hash(__x._M_hash), _M_eq(__x._M_eq), _M_alloc(__a)
+      {
+	if (_M_alloc == __x._M_alloc)
+	  _M_steal(__x);
+	else
+	  {
+	    _M_init_empty();
+	    _M_move_elements(__x);
+	  }
+      }
+
+      ~__flat_hashtable()
+      { _M_destroy(); }
+
+      __flat_hashtable&
+      operator=(const __flat_hashtable& __x)
+      {
+	if (this != std::__addressof(__x))
+	  {
+	    clear();
+	    if (_Alloc_traits::propagate_on_container_copy_assignment::value
+		&& _M_alloc != __x._M_alloc)
+	      {
+		_M_destroy();
+		_M_init_empty();
+		_M_alloc = __x._M_alloc;
+	      }
+	    _M_hash = __x._M_hash;
+	    _M_eq = __x._M_eq;
+	    _M_copy_elements(__x);
+	  }
+	return *this;
+      }
+
+      __flat_hashtable&
+      operator=(__flat_hashtable&& __x)
+      noexcept(_Alloc_traits::propagate_on_container_move_assignment::value
+	       && std::is_nothrow_move_assignable<_Hash>::value
+	       && std::is_nothrow_move_assignable<_Equal>::value)
+      {
+	if (this == std::__addressof(__x))
+	  return *this;
+	_M_hash = std::move(__x._M_hash);
+	_M_eq = std::move(__x._M_eq);
+	if (_Alloc_traits::propagate_on_container_move_assignment::value
+	    || _M_alloc == __x._M_alloc)
+	  {
+	    _M_destroy();
+	    if (_Alloc_traits::propagate_on_container_move_assignment::value)
+	      _M_alloc = std::move(__x._M_alloc);
+	    _M_steal(__x);
+	  }
+	else
+	  {
+	    clear();
+	    _M_move_elements(__x);
+	  }
+	return *this;
+      }
+
+      allocator_type
+      get_allocator() const noexcept
+      { return allocator_type(_M_alloc); }
+
+      hasher
+      hash_function() const
+      { return _M_hash; }
+
+      key_equal
+      key_eq() const
+      { return _M_eq; }
+
+      // Iterators.
+
+      iterator
+      begin() noexcept
+      {
+	iterator __it(_M_ctrl_ptr(), _M_slot_ptr());
+	__it._M_skip_free();
+	return __it;
+      }
+
+      const_iterator
+      begin() const noexcept
+      {
+	const_iterator __it(_M_ctrl_ptr(), _M_slot_ptr());
+	__it._M_skip_free();
+	return __it;
+      }
+
+      const_iterator
+      cbegin() const noexcept
+      { return begin(); }
+
+      iterator
+      end() noexcept
+      { return _M_iterator_at(_M_capacity); }
+
+      const_iterator
+      end() const noexcept
+      { return _M_iterator_at(_M_capacity); }
+
+      const_iterator
+      cend() const noexcept
+      { return end(); }
+
+      // Capacity.
+
+      bool
+      empty() const noexcept
+      { return _M_size == 0; }
+
+      size_type
+      size() const noexcept
+      { return _M_size; }
+
+      size_type
+      max_size() const noexcept
+      { return _Alloc_traits::max_size(_M_alloc); }
+
+      // Lookup.
+
+      iterator
+      find(const key_type& __k)
+      { return _M_iterator_at(_M_find(__k)); }
+
+      const_iterator
+      find(const key_type& __k) const
+      { return _M_iterator_at(_M_find(__k)); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	iterator
+	find(const _Kt& __k)
+	{ return _M_iterator_at(_M_find(__k)); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	const_iterator
+	find(const _Kt& __k) const
+	{ return _M_iterator_at(_M_find(__k)); }
+
+      size_type
+      count(const key_type& __k) const
+      { return _M_find(__k) != _M_capacity; }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	size_type
+	count(const _Kt& __k) const
+	{ return _M_find(__k) != _M_capacity; }
+
+      bool
+      contains(const key_type& __k) const
+      { return _M_find(__k) != _M_capacity; }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	bool
+	contains(const _Kt& __k) const
+	{ return _M_find(__k) != _M_capacity; }
+
+      std::pair<iterator, iterator>
+      equal_range(const key_type& __k)
+      { return _M_equal_range(_M_find(__k)); }
+
+      std::pair<const_iterator, const_iterator>
+      equal_range(const key_type& __k) const
+      { return _M_equal_range(_M_find(__k)); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	std::pair<iterator, iterator>
+	equal_range(const _Kt& __k)
+	{ return _M_equal_range(_M_find(__k)); }
+
+      template<typename _Kt, typename = __if_transparent<_Kt>>
+	std::pair<const_iterator, const_iterator>
+	equal_range(const _Kt& __k) const
+	{ return _M_equal_range(_M_find(__k)); }
+
+      // Modifiers.
+
+      std::pair<iterator, bool>
+      insert(const value_type& __v)
+      { return _M_try_emplace(_ExtractKey()(__v), __v); }
+
+      std::pair<iterator, bool>
+      insert(value_type&& __v)
+      { return _M_try_emplace(_ExtractKey()(__v), std::move(__v)); }
+
+      iterator
+      insert(const_iterator, const value_type& __v)
+      { return insert(__v).first; }
+
+      iterator
+      insert(const_iterator, value_type&& __v)
+      { return insert(std::move(__v)).first; }
+
+      template<typename _InputIterator>
+	void
+	insert(_InputIterator __first, _InputIterator __last)
+	{
+	  for (; __first != __last; ++__first)
+	    emplace(*__first);
+	}
+
+      void
+      insert(std::initializer_list<value_type> __l)
+      { insert(__l.begin(), __l.end()); }
+
+      // Construct a value from __args first, since its key is not known
+      // until then, and move it into the table if its key is new.
+      template<typename... _Args>
+	std::pair<iterator, bool>
+	emplace(_Args&&... __args)
+	{
+	  _Scoped_value __buf(*this, std::forward<_Args>(__args)...);
+	  return _M_try_emplace(_ExtractKey()(__buf._M_value()),
+				std::move(__buf._M_value()));
+	}
+
+      template<typename... _Args>
+	iterator
+	emplace_hint(const_iterator, _Args&&... __args)
+	{ return emplace(std::forward<_Args>(__args)...).first; }
+
+      // Insert the value constructed from __args unless an element with
+      // key __k exists, in which case nothing is constructed.
+      template<typename _Kt, typename... _Args>
+	std::pair<iterator, bool>
+	_M_try_emplace(const _Kt& __k, _Args&&... __args)
+	{
+	  const std::size_t __hash = _M_hash(__k);
+	  size_type __i = _M_find(__k, __hash);
+	  if (__i != _M_capacity)
+	    return std::make_pair(_M_iterator_at(__i), false);
+	  __i = _M_prepare_insert(__hash);
+	  _Alloc_traits::construct(_M_alloc, _M_slot_ptr() + __i,
+				   std::forward<_Args>(__args)...);
+	  _M_set_full(__i, __hash);
+	  return std::make_pair(_M_iterator_at(__i), true);
+	}
+
+      iterator
+      erase(const_iterator __pos)
+      {
+	iterator __next(__pos._M_ctrl, const_cast<_Value*>(__pos._M_slot));
+	_M_erase_at(__pos._M_ctrl - _M_ctrl_ptr());
+	++__next;
+	return __next;
+      }
+
+      iterator
+      erase(iterator __pos)
+      { return erase(const_iterator(__pos)); }
+
+      iterator
+      erase(const_iterator __first, const_iterator __last)
+      {
+	while (__first != __last)
+	  __first = erase(__first);
+	return iterator(__last._M_ctrl, const_cast<_Value*>(__last._M_slot));
+      }
+
+      size_type
+      erase(const key_type& __k)
+      {
+	size_type __i = _M_find(__k);
+	if (__i == _M_capacity)
+	  return 0;
+	_M_erase_at(__i);
+	return 1;
+      }
+
+      void
+      clear() noexcept
+      {
+	if (_M_size == 0 && _M_growth_left == _S_max_load(_M_capacity))
+	  return;
+	_M_destroy_elements();
+	if (_M_capacity)
+	  std::fill_n(_M_ctrl_ptr(), _M_capacity, __flat_ctrl_empty);
+	_M_size = 0;
+	_M_growth_left = _S_max_load(_M_capacity);
+      }
+
+      void
+      swap(__flat_hashtable& __x)
+      noexcept(std::__is_nothrow_swappable<_Hash>::value
+	       && std::__is_nothrow_swappable<_Equal>::value)
+      {
+	using std::swap;
+	swap(_M_hash, __x._M_hash);
+	swap(_M_eq, __x._M_eq);
+	if (_Alloc_traits::propagate_on_container_swap::value)
+	  swap(_M_alloc, __x._M_alloc);
+	swap(_M_ctrl, __x._M_ctrl);
+	swap(_M_slots, __x._M_slots);
+	swap(_M_capacity, __x._M_capacity);
+	swap(_M_size, __x._M_size);
+	swap(_M_growth_left, __x._M_growth_left);
+      }
+
+      // Hash policy.
+
+      size_type
+      bucket_count() const noexcept
+      { return _M_capacity; }
+
+      float
+      load_factor() const noexcept
+      { return _M_capacity ? (float)_M_size / _M_capacity : 0.0f; }
+
+      float
+      max_load_factor() const noexcept
+      { return 0.875f; }
+
+      // Make room for at least __n buckets, and at least as many as
+      // needed for the current elements.
+      void
+      rehash(size_type __n)
+      {
+	if (__n == 0 && _M_size == 0)
+	  {
+	    // Give the memory back.
+	    _M_destroy();
+	    _M_init_empty();
+	    return;
+	  }
+	size_type __cap = _S_capacity_for(std::max(__n * 7 / 8, _M_size));
+	if (__cap != _M_capacity)
+	  _M_resize(__cap);
+      }
+
+      // Make room for __n elements without rehashing.
+      void
+      reserve(size_type __n)
+      {
+	if (__n > _M_size + _M_growth_left)
+	  _M_resize(_S_capacity_for(__n));
+      }
+
+      friend bool
+      operator==(const __flat_hashtable& __x, const __flat_hashtable& __y)
+      {
+	if (__x.size() != __y.size())
+	  return false;
+	for (const_iterator __it = __x.begin(); __it != __x.end(); ++__it)
+	  {
+	    const_iterator __ity = __y.find(_ExtractKey()(*__it));
+	    if (__ity == __y.end() || !bool(*__ity == *__it))
+	      return false;
+	  }
+	return true;
+      }
+
+      friend bool
+      operator!=(const __flat_hashtable& __x, const __flat_hashtable& __y)
+      { return !(__x == __y); }
+
+    private:
+      // Storage for a value constructed before it is moved into the table.
+      struct _Scoped_value
+      {
+	template<typename... _Args>
+	  _Scoped_value(__flat_hashtable& __ht, _Args&&... __args)
+	  : _M_ht(__ht)
+	  {
+	    _Alloc_traits::construct(_M_ht._M_alloc, _M_addr(),
+				     std::forward<_Args>(__args)...);
+	  }
+
+	~_Scoped_value()
+	{ _Alloc_traits::destroy(_M_ht._M_alloc, _M_addr()); }
+
+	_Value*
+	_M_addr() noexcept
+	{ return static_cast<_Value*>(static_cast<void*>(&_M_storage)); }
+
+	_Value&
+	_M_value() noexcept
+	{ return *_M_addr(); }
+
+	__flat_hashtable& _M_ht;
+	typename std::aligned_storage<sizeof(_Value),
+				      alignof(_Value)>::type _M_storage;
+      };
+
+      // The most slots of a table of capacity __cap that are ever full
+      // or deleted, so that searches soon meet an empty slot.
+      static size_type
+      _S_max_load(size_type __cap) noexcept
+      { return __cap - __cap / 8; }
+
+      // The smallest valid capacity with room for __n elements.
+      static size_type
+      _S_capacity_for(size_type __n) noexcept
+      {
+	size_type __cap = __flat_group::_S_width;
+	while (_S_max_load(__cap) < __n)
+	  __cap *= 2;
+	return __cap;
+      }
+
+      // Mix __hash so that all of its bits affect the bits used below.
+      static unsigned long long
+      _S_mix(std::size_t __hash) noexcept
+      { return (unsigned long long)__hash * 0x9e3779b97f4a7c15ULL; }
+
+      // The seven bits of the mixed hash __m that are kept in the control
+      // bytes, and the group at which probing for __m starts.
+      static __flat_ctrl_t
+      _S_h2(unsigned long long __m) noexcept
+      { return __m >> 57; }
+
+      size_type
+      _M_h1(unsigned long long __m) const noexcept
+      { return (__m >> 25) & (_M_capacity / __flat_group::_S_width - 1); }
+
+      // The control bytes of a table without slots: just the sentinel.
+      static __flat_ctrl_t*
+      _S_empty_ctrl() noexcept
+      {
+	static __flat_ctrl_t __sentinel = __flat_ctrl_sentinel;
+	return &__sentinel;
+      }
+
+      __flat_ctrl_t*
+      _M_ctrl_ptr() const noexcept
+      { return _M_ctrl; }
+
+      _Value*
+      _M_slot_ptr() const noexcept
+      { return _M_capacity ? std::__to_address(_M_slots) : nullptr; }
+
+      iterator
+      _M_iterator_at(size_type __i) noexcept
+      { return iterator(_M_ctrl_ptr() + __i, _M_slot_ptr() + __i); }
+
+      const_iterator
+      _M_iterator_at(size_type __i) const noexcept
+      { return const_iterator(_M_ctrl_ptr() + __i, _M_slot_ptr() + __i); }
+
+      std::pair<iterator, iterator>
+      _M_equal_range(size_type __i) noexcept
+      {
+	iterator __first = _M_iterator_at(__i), __last = __first;
+	if (__i != _M_capacity)
+	  ++__last;
+	return std::make_pair(__first, __last);
+      }
+
+      std::pair<const_iterator, const_iterator>
+      _M_equal_range(size_type __i) const noexcept
+      {
+	const_iterator __first = _M_iterator_at(__i), __last = __first;
+	if (__i != _M_capacity)
+	  ++__last;
+	return std::make_pair(__first, __last);
+      }
+
+      void
+      _M_init_empty() noexcept
+      {
+	_M_ctrl = _S_empty_ctrl();
+	_M_slots = _Slot_pointer();
+	_M_capacity = 0;
+	_M_size = 0;
+	_M_growth_left = 0;
+      }
+
+      // Take over the storage of __x, leaving it empty.
+      void
+      _M_steal(__flat_hashtable& __x) noexcept
+      {
+	_M_ctrl = __x._M_ctrl;
+	_M_slots = __x._M_slots;
+	_M_capacity = __x._M_capacity;
+	_M_size = __x._M_size;
+	_M_growth_left = __x._M_growth_left;
+	__x._M_init_empty();
+      }
+
+      void
+      _M_copy_elements(const __flat_hashtable& __x)
+      {
+	reserve(__x.size());
+	for (const_iterator __it = __x.begin(); __it != __x.end(); ++__it)
+	  _M_try_emplace(_ExtractKey()(*__it), *__it);
+      }
+
+      void
+      _M_move_elements(__flat_hashtable& __x)
+      {
+	reserve(__x.size());
+	for (iterator __it = __x.begin(); __it != __x.end(); ++__it)
+	  _M_try_emplace(_ExtractKey()(*__it), std::move(*__it));
+	__x.clear();
+      }
+
+      void
+      _M_destroy_elements() noexcept
+      {
+	if (_M_size == 0)
+	  return;
+	_Value* __slots = _M_slot_ptr();
+	for (size_type __i = 0; __i < _M_capacity; ++__i)
+	  if (_M_ctrl[__i] >= 0)
+	    _Alloc_traits::destroy(_M_alloc, __slots + __i);
+      }
+
+      void
+      _M_deallocate(_Ctrl_pointer __ctrl, _Slot_pointer __slots,
+		    size_type __cap) noexcept
+      {
+	if (!__cap)
+	  return;
+	_Ctrl_alloc_type __ctrl_alloc(_M_alloc);
+	_Ctrl_alloc_traits::deallocate(__ctrl_alloc, __ctrl, __cap + 1);
+	_Alloc_traits::deallocate(_M_alloc, __slots, __cap);
+      }
+
+      void
+      _M_destroy() noexcept
+      {
+	_M_destroy_elements();
+	if (_M_capacity)
+	  _M_deallocate(std::pointer_traits<_Ctrl_pointer>::pointer_to
+			(*_M_ctrl), _M_slots, _M_capacity);
+      }
+
+      // Return the index of the element with key __k, which has hash
+      // __hash, or _M_capacity if there is none.
+      template<typename _Kt>
+	size_type
+	_M_find(const _Kt& __k, std::size_t __hash) const
+	{
+	  if (_M_size == 0)
+	    return _M_capacity;
+	  const unsigned long long __m = _S_mix(__hash);
+	  const __flat_ctrl_t __h2 = _S_h2(__m);
+	  const size_type __mask = _M_capacity / __flat_group::_S_width - 1;
+	  const _Value* __slots = _M_slot_ptr();
+	  size_type __group = _M_h1(__m);
+	  for (size_type __stride = 1;; ++__stride)
+	    {
+	      const size_type __base = __group * __flat_group::_S_width;
+	      const __flat_group __g(_M_ctrl + __base);
+	      for (__flat_group::__mask_type __match = __g._M_match(__h2);
+		   __match; __match &= __match - 1)
+		{
+		  const size_type __i = __base + __flat_group_first(__match);
+		  if (_M_eq(__k, _ExtractKey()(__slots[__i])))
+		    return __i;
+		}
+	      if (__g._M_match_empty())
+		return _M_capacity;
+	      __group = (__group + __stride) & __mask;
+	    }
+	}
+
+      template<typename _Kt>
+	size_type
+	_M_find(const _Kt& __k) const
+	{
+	  if (_M_size == 0)
+	    return _M_capacity;
+	  return _M_find(__k, _M_hash(__k));
+	}
+
+      // Return the index of the first empty or deleted slot on the probe
+      // sequence of __hash.
+      size_type
+      _M_find_free(std::size_t __hash) const noexcept
+      {
+	const unsigned long long __m = _S_mix(__hash);
+	const size_type __mask = _M_capacity / __flat_group::_S_width - 1;
+	size_type __group = _M_h1(__m);
+	for (size_type __stride = 1;; ++__stride)
+	  {
+	    const size_type __base = __group * __flat_group::_S_width;
+	    const __flat_group __g(_M_ctrl + __base);
+	    if (__flat_group::__mask_type __free
+		= __g._M_match_empty_or_deleted())
+	      return __base + __flat_group_first(__free);
+	    __group = (__group + __stride) & __mask;
+	  }
+      }
+
+      // Return the index of a free slot for a new element with hash
+      // __hash, growing the table or dropping its deleted slots first
+      // if it is too full.
+      size_type
+      _M_prepare_insert(std::size_t __hash)
+      {
+	size_type __i = _M_capacity ? _M_find_free(__hash) : 0;
+	if (_M_capacity == 0
+	    || (_M_growth_left == 0 && _M_ctrl[__i] == __flat_ctrl_empty))
+	  {
+	    // Rehash in place when at most half of the full slots would
+	    // be left after dropping the deleted ones, grow otherwise.
+	    if (_M_capacity && _M_size < _S_max_load(_M_capacity) / 2)
+	      _M_resize(_M_capacity);
+	    else
+	      _M_resize(_S_capacity_for(_M_size + 1));
+	    __i = _M_find_free(__hash);
+	  }
+	return __i;
+      }
+
+      // Mark slot __i, into which an element with hash __hash has just
+      // been constructed, as full.
+      void
+      _M_set_full(size_type __i, std::size_t __hash) noexcept
+      {
+	if (_M_ctrl[__i] == __flat_ctrl_empty)
+	  --_M_growth_left;
+	_M_ctrl[__i] = _S_h2(_S_mix(__hash));
+	++_M_size;
+      }
+
+      // Destroy the element in slot __i.  If the group of the slot has
+      // an empty slot, no search can have gone past it, so the slot can
+      // be made empty rather than deleted.
+      void
+      _M_erase_at(size_type __i) noexcept
+      {
+	_Alloc_traits::destroy(_M_alloc, _M_slot_ptr() + __i);
+	--_M_size;
+	const size_type __base = __i & ~(__flat_group::_S_width - 1);
+	if (__flat_group(_M_ctrl + __base)._M_match_empty())
+	  {
+	    _M_ctrl[__i] = __flat_ctrl_empty;
+	    ++_M_growth_left;
+	  }
+	else
+	  _M_ctrl[__i] = __flat_ctrl_deleted;
+      }
+
+      // Move the elements into a new table of __cap slots, dropping the
+      // deleted slots.
+      void
+      _M_resize(size_type __cap)
+      {
+	_Ctrl_alloc_type __ctrl_alloc(_M_alloc);
+	_Ctrl_pointer __new_ctrl_p
+	  = _Ctrl_alloc_traits::allocate(__ctrl_alloc, __cap + 1);
+	_Slot_pointer __new_slots_p;
+	__try
+	  {
+	    __new_slots_p = _Alloc_traits::allocate(_M_alloc, __cap);
+	  }
+	__catch(...)
+	  {
+	    _Ctrl_alloc_traits::deallocate(__ctrl_alloc, __new_ctrl_p,
+					   __cap + 1);
+	    __throw_exception_again;
+	  }
+
+	__flat_ctrl_t* __new_ctrl = std::__to_address(__new_ctrl_p);
+	_Value* __new_slots = std::__to_address(__new_slots_p);
+	std::fill_n(__new_ctrl, __cap, __flat_ctrl_empty);
+	__new_ctrl[__cap] = __flat_ctrl_sentinel;
+
+	__flat_ctrl_t* __old_ctrl = _M_ctrl;
+	_Slot_pointer __old_slots_p = _M_slots;
+	_Value* __old_slots = _M_slot_ptr();
+	const size_type __old_cap = _M_capacity;
+	const size_type __old_growth_left = _M_growth_left;
+
+	_M_ctrl = __new_ctrl;
+	_M_slots = __new_slots_p;
+	_M_capacity = __cap;
+	_M_growth_left = _S_max_load(__cap);
+	const size_type __size = _M_size;
+	_M_size = 0;
+
+	__try
+	  {
+	    for (size_type __i = 0; __i < __old_cap; ++__i)
+	      if (__old_ctrl[__i] >= 0)
+		{
+		  const std::size_t __hash
+		    = _M_hash(_ExtractKey()(__old_slots[__i]));
+		  const size_type __j = _M_find_free(__hash);
+		  _Alloc_traits::construct(_M_alloc, __new_slots + __j,
+					   std::move_if_noexcept
+					   (__old_slots[__i]));
+		  _M_set_full(__j, __hash);
+		}
+	  }
+	__catch(...)
+	  {
+	    // Give up on the new table and go back to the old one.
+	    _M_destroy();
+	    _M_ctrl = __old_ctrl;
+	    _M_slots = __old_slots_p;
+	    _M_capacity = __old_cap;
+	    _M_size = __size;
+	    _M_growth_left = __old_growth_left;
+	    __throw_exception_again;
+	  }
+
+	for (size_type __i = 0; __i < __old_cap; ++__i)
+	  if (__old_ctrl[__i] >= 0)
+	    _Alloc_traits::destroy(_M_alloc, __old_slots + __i);
+	if (__old_cap)
+	  _M_deallocate(std::pointer_traits<_Ctrl_pointer>::pointer_to
+			(*__old_ctrl), __old_slots_p, __old_cap);
+      }
+
+      _Hash _M_hash;
+      _Equal _M_eq;
+      _Value_alloc_type _M_alloc;
+      __flat_ctrl_t* _M_ctrl;
+      _Slot_pointer _M_slots;
+      size_type _M_capacity;
+      size_type _M_size;
+      // The number of empty slots that can still be filled before the
+      // table has to be rehashed.
+      size_type _M_growth_left;
+    };
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace __gnu_cxx
+
+#endif // C++11
+
+#endif // _EXT_FLAT_HASHTABLE_H
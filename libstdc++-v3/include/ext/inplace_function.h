@@ -0,0 +1,332 @@
+// Polymorphic function wrapper with inline storage -*- C++ -*-
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/inplace_function.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _EXT_INPLACE_FUNCTION_H
+#define _EXT_INPLACE_FUNCTION_H 1
+
+#pragma GCC system_header
+
+#if __cplusplus >= 201703L
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <bits/move.h>
+#include <bits/invoke.h>
+#include <bits/std_function.h>	// bad_function_call
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  template<typename _Signature,
+	   std::size_t _Capacity = 4 * sizeof(void*),
+	   std::size_t _Alignment = alignof(std::max_align_t)>
+    class inplace_function;
+
+  /**
+   *  @brief A polymorphic function wrapper that never allocates.
+   *  @ingroup functors
+   *
+   *  Like std::function, but the target is always stored in a buffer of
+   *  @a _Capacity bytes aligned to @a _Alignment inside the wrapper, and
+   *  a target that does not fit is rejected at compile time instead of
+   *  being allocated on the heap.  Each target type has one static table
+   *  of operations, and targets that are trivially copyable are copied,
+   *  moved and destroyed without calling through it.
+   *
+   *  Calling an empty inplace_function throws std::bad_function_call.
+   *  Only the unqualified signature form @c R(Args...) is supported.
+   */
+  template<typename _Res, typename... _ArgTypes,
+	   std::size_t _Capacity, std::size_t _Alignment>
+    class inplace_function<_Res(_ArgTypes...), _Capacity, _Alignment>
+    {
+      struct _Ops
+      {
+	_Res (*_M_invoke)(void*, _ArgTypes&&...);
+	// Null for trivially copyable targets.
+	void (*_M_copy)(void*, const void*);
+	void (*_M_relocate)(void*, void*) noexcept;
+	void (*_M_destroy)(void*) noexcept;
+      };
+
+      template<typename _Fn>
+	static _Res
+	_S_invoke(void* __p, _ArgTypes&&... __args)
+	{
+	  return std::__invoke_r<_Res>(*static_cast<_Fn*>(__p),
+				       std::forward<_ArgTypes>(__args)...);
+	}
+
+      template<typename _Fn>
+	static void
+	_S_copy(void* __dst, const void* __src)
+	{ ::new (__dst) _Fn(*static_cast<const _Fn*>(__src)); }
+
+      // Move the target at __src to __dst and destroy the original.
+      template<typename _Fn>
+	static void
+	_S_relocate(void* __dst, void* __src) noexcept
+	{
+	  _Fn* __p = static_cast<_Fn*>(__src);
+	  ::new (__dst) _Fn(std::move(*__p));
+	  __p->~_Fn();
+	}
+
+      template<typename _Fn>
+	static void
+	_S_destroy(void* __p) noexcept
+	{ static_cast<_Fn*>(__p)->~_Fn(); }
+
+      [[noreturn]] static _Res
+      _S_empty_invoke(void*, _ArgTypes&&...)
+      { std::__throw_bad_function_call(); }
+
+      static constexpr _Ops _S_empty_ops
+	= { &_S_empty_invoke, nullptr, nullptr, nullptr };
+
+      template<typename _Fn>
+	static constexpr bool __trivial = std::is_trivially_copyable_v<_Fn>;
+
+      template<typename _Fn>
+	static constexpr _Ops _S_ops = {
+	  &_S_invoke<_Fn>,
+	  __trivial<_Fn> ? nullptr : &_S_copy<_Fn>,
+	  __trivial<_Fn> ? nullptr : &_S_relocate<_Fn>,
+	  __trivial<_Fn> ? nullptr : &_S_destroy<_Fn>
+	};
+
+      template<typename _Fn>
+	static bool
+	_S_not_empty(const _Fn& __f)
+	{
+	  if constexpr (std::is_pointer_v<_Fn>
+			|| std::is_member_pointer_v<_Fn>)
+	    return __f != nullptr;
+	  else
+	    return true;
+	}
+
+      template<typename _Fn>
+	using _Callable = std::__and_<
+	  std::__not_<std::is_same<std::decay_t<_Fn>, inplace_function>>,
+	  std::is_invocable_r<_Res, std::decay_t<_Fn>&, _ArgTypes...>,
+	  std::is_copy_constructible<std::decay_t<_Fn>>>;
+
+    public:
+      typedef _Res result_type;
+
+      /// The number of bytes available for a target.
+      static constexpr std::size_t capacity = _Capacity;
+
+      inplace_function() noexcept
+      : _M_ops(&_S_empty_ops)
+      { }
+
+      inplace_function(std::nullptr_t) noexcept
+      : inplace_function()
+      { }
+
+      inplace_function(const inplace_function& __x)
+      : _M_ops(__x._M_ops)
+      { _M_copy_from(__x); }
+
+      /// The target of @a __x is moved, @a __x is left empty.
+      inplace_function(inplace_function&& __x) noexcept
+      : _M_ops(__x._M_ops)
+      { _M_move_from(__x); }
+
+      /**
+       *  @brief Store a copy of a callable object.
+       *
+       *  The callable object must fit in @a _Capacity bytes and must not
+       *  require more alignment than @a _Alignment, and moving it must
+       *  not throw.  A null pointer to function or to member makes an
+       *  empty wrapper.
+       */
+      template<typename _Functor,
+	       typename = std::enable_if_t<_Callable<_Functor>::value>>
+	inplace_function(_Functor&& __f)
+	: inplace_function()
+	{
+	  using _Fn = std::decay_t<_Functor>;
+	  static_assert(sizeof(_Fn) <= _Capacity,
+			"callable object fits in the inplace_function");
+	  static_assert(alignof(_Fn) <= _Alignment,
+			"callable object alignment is supported by the"
+			" inplace_function");
+	  static_assert(std::is_nothrow_move_constructible_v<_Fn>,
+			"callable object is nothrow move constructible");
+	  if (_S_not_empty(__f))
+	    {
+	      ::new (_M_addr()) _Fn(std::forward<_Functor>(__f));
+	      _M_ops = &_S_ops<_Fn>;
+	    }
+	}
+
+      ~inplace_function()
+      { _M_destroy(); }
+
+      inplace_function&
+      operator=(const inplace_function& __x)
+      {
+	if (this != &__x)
+	  {
+	    inplace_function __tmp(__x);
+	    *this = std::move(__tmp);
+	  }
+	return *this;
+      }
+
+      inplace_function&
+      operator=(inplace_function&& __x) noexcept
+      {
+	if (this != &__x)
+	  {
+	    _M_destroy();
+	    _M_ops = __x._M_ops;
+	    _M_move_from(__x);
+	  }
+	return *this;
+      }
+
+      inplace_function&
+      operator=(std::nullptr_t) noexcept
+      {
+	_M_destroy();
+	_M_ops = &_S_empty_ops;
+	return *this;
+      }
+
+      template<typename _Functor>
+	std::enable_if_t<_Callable<_Functor>::value, inplace_function&>
+	operator=(_Functor&& __f)
+	{ return *this = inplace_function(std::forward<_Functor>(__f)); }
+
+      void
+      swap(inplace_function& __x) noexcept
+      {
+	inplace_function __tmp(std::move(__x));
+	__x = std::move(*this);
+	*this = std::move(__tmp);
+      }
+
+      explicit operator bool() const noexcept
+      { return _M_ops != &_S_empty_ops; }
+
+      _Res
+      operator()(_ArgTypes... __args) const
+      {
+	return _M_ops->_M_invoke(const_cast<void*>(_M_addr()),
+				 std::forward<_ArgTypes>(__args)...);
+      }
+
+    private:
+      void*
+      _M_addr() noexcept
+      { return _M_storage; }
+
+      const void*
+      _M_addr() const noexcept
+      { return _M_storage; }
+
+      // _M_ops has already been copied from __x.
+      void
+      _M_copy_from(const inplace_function& __x)
+      {
+	if (_M_ops->_M_copy)
+	  _M_ops->_M_copy(_M_addr(), __x._M_addr());
+	else
+	  __builtin_memcpy(_M_storage, __x._M_storage, _Capacity);
+      }
+
+      // _M_ops has already been copied from __x.
+      void
+      _M_move_from(inplace_function& __x) noexcept
+      {
+	if (_M_ops->_M_relocate)
+	  _M_ops->_M_relocate(_M_addr(), __x._M_addr());
+	else
+	  __builtin_memcpy(_M_storage, __x._M_storage, _Capacity);
+	__x._M_ops = &_S_empty_ops;
+      }
+
+      void
+      _M_destroy() noexcept
+      {
+	if (_M_ops->_M_destroy)
+	  _M_ops->_M_destroy(_M_addr());
+      }
+
+      alignas(_Alignment) unsigned char _M_storage[_Capacity];
+      const _Ops* _M_ops;
+    };
+
+  template<typename _Res, typename... _Args,
+	   std::size_t _Capacity, std::size_t _Alignment>
+    inline void
+    swap(inplace_function<_Res(_Args...), _Capacity, _Alignment>& __x,
+	 inplace_function<_Res(_Args...), _Capacity, _Alignment>& __y) noexcept
+    { __x.swap(__y); }
+
+  template<typename _Res, typename... _Args,
+	   std::size_t _Capacity, std::size_t _Alignment>
+    inline bool
+    operator==(const inplace_function<_Res(_Args...), _Capacity, _Alignment>&
+	       __f, std::nullptr_t) noexcept
+    { return !static_cast<bool>(__f); }
+
+  template<typename _Res, typename... _Args,
+	   std::size_t _Capacity, std::size_t _Alignment>
+    inline bool
+    operator==(std::nullptr_t, const inplace_function<_Res(_Args...),
+						      _Capacity, _Alignment>&
+	       __f) noexcept
+    { return !static_cast<bool>(__f); }
+
+  template<typename _Res, typename... _Args,
+	   std::size_t _Capacity, std::size_t _Alignment>
+    inline bool
+    operator!=(const inplace_function<_Res(_Args...), _Capacity, _Alignment>&
+	       __f, std::nullptr_t) noexcept
+    { return static_cast<bool>(__f); }
+
+  template<typename _Res, typename... _Args,
+	   std::size_t _Capacity, std::size_t _Alignment>
+    inline bool
+    operator!=(std::nullptr_t, const inplace_function<_Res(_Args...),
+						      _Capacity, _Alignment>&
+	       __f) noexcept
+    { return static_cast<bool>(__f); }
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace __gnu_cxx
+
+#endif // C++17
+#endif // _EXT_INPLACE_FUNCTION_H
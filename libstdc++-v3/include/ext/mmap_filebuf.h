@@ -0,0 +1,204 @@
+// Memory-mapped input file buffer -*- C++ -*-
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/mmap_filebuf.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _EXT_MMAP_FILEBUF_H
+#define _EXT_MMAP_FILEBUF_H 1
+
+#pragma GCC system_header
+
+#if __cplusplus < 201103L
+# include <bits/c++0x_warning.h>
+#else
+
+#include <streambuf>
+#include <string>
+
+#if defined _GLIBCXX_HAVE_UNISTD_H && __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  /**
+   *  @brief A read-only stream buffer whose get area is a mapping of a
+   *  whole file.
+   *  @ingroup io
+   *
+   *  This GNU extension maps the file with mmap and makes the get area
+   *  point straight at the mapping, so that reading through it, e.g.
+   *  from a std::istream constructed with it, never copies the file into
+   *  an intermediate buffer or calls read.  There is no code conversion:
+   *  the characters are the bytes of the file, so @a _CharT must be a
+   *  single-byte character type.  The file must not be truncated while
+   *  it is mapped.
+  */
+  template<typename _CharT, typename _Traits = std::char_traits<_CharT> >
+    class basic_mmap_filebuf : public std::basic_streambuf<_CharT, _Traits>
+    {
+      static_assert(sizeof(_CharT) == 1,
+		    "basic_mmap_filebuf requires a single-byte character type");
+
+    public:
+      // Types:
+      typedef _CharT					char_type;
+      typedef _Traits					traits_type;
+      typedef typename traits_type::int_type		int_type;
+      typedef typename traits_type::pos_type		pos_type;
+      typedef typename traits_type::off_type		off_type;
+
+      basic_mmap_filebuf() = default;
+
+      basic_mmap_filebuf(const basic_mmap_filebuf&) = delete;
+      basic_mmap_filebuf& operator=(const basic_mmap_filebuf&) = delete;
+
+      ~basic_mmap_filebuf()
+      { close(); }
+
+      bool
+      is_open() const noexcept
+      { return _M_open; }
+
+      /**
+       *  @brief  Map a file for reading.
+       *  @param  __s  The name of the file.
+       *  @return  @c this on success, NULL on failure.
+       *
+       *  Fails if a file is already open, or if the file cannot be opened
+       *  or mapped.
+      */
+      basic_mmap_filebuf*
+      open(const char* __s)
+      {
+	if (_M_open)
+	  return 0;
+	const int __fd = ::open(__s, O_RDONLY);
+	if (__fd < 0)
+	  return 0;
+	struct stat __st;
+	void* __addr = 0;
+	const bool __ok = ::fstat(__fd, &__st) == 0
+	  && (__st.st_size == 0
+	      || (__addr = ::mmap(0, __st.st_size, PROT_READ, MAP_PRIVATE,
+				  __fd, 0)) != MAP_FAILED);
+	::close(__fd);
+	if (!__ok)
+	  return 0;
+
+	_M_len = __st.st_size;
+#ifdef MADV_SEQUENTIAL
+	if (_M_len)
+	  ::madvise(__addr, _M_len, MADV_SEQUENTIAL);
+#endif
+	char_type* __p = static_cast<char_type*>(__addr);
+	this->setg(__p, __p, __p + _M_len);
+	_M_open = true;
+	return this;
+      }
+
+      basic_mmap_filebuf*
+      open(const std::string& __s)
+      { return open(__s.c_str()); }
+
+      /**
+       *  @brief  Unmap the file.
+       *  @return  @c this on success, NULL if no file was open.
+      */
+      basic_mmap_filebuf*
+      close()
+      {
+	if (!_M_open)
+	  return 0;
+	if (_M_len)
+	  ::munmap(this->eback(), _M_len);
+	this->setg(0, 0, 0);
+	_M_len = 0;
+	_M_open = false;
+	return this;
+      }
+
+    protected:
+      // The whole file is in the get area, so there is nothing to refill.
+      int_type
+      underflow() override
+      {
+	if (this->gptr() < this->egptr())
+	  return traits_type::to_int_type(*this->gptr());
+	return traits_type::eof();
+      }
+
+      std::streamsize
+      showmanyc() override
+      {
+	if (this->gptr() < this->egptr())
+	  return this->egptr() - this->gptr();
+	return -1;
+      }
+
+      pos_type
+      seekoff(off_type __off, std::ios_base::seekdir __way,
+	      std::ios_base::openmode __mode
+	      = std::ios_base::in | std::ios_base::out) override
+      {
+	if (!_M_open || !(__mode & std::ios_base::in))
+	  return pos_type(off_type(-1));
+
+	off_type __base = 0;
+	if (__way == std::ios_base::cur)
+	  __base = this->gptr() - this->eback();
+	else if (__way == std::ios_base::end)
+	  __base = _M_len;
+	const off_type __newoff = __base + __off;
+	if (__newoff < 0 || __newoff > off_type(_M_len))
+	  return pos_type(off_type(-1));
+	this->setg(this->eback(), this->eback() + __newoff, this->egptr());
+	return pos_type(__newoff);
+      }
+
+      pos_type
+      seekpos(pos_type __pos,
+	      std::ios_base::openmode __mode
+	      = std::ios_base::in | std::ios_base::out) override
+      { return seekoff(off_type(__pos), std::ios_base::beg, __mode); }
+
+    private:
+      std::size_t _M_len = 0;
+      bool _M_open = false;
+    };
+
+  typedef basic_mmap_filebuf<char> mmap_filebuf;
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace __gnu_cxx
+
+#endif // unistd.h && sys/mman.h
+#endif // C++11
+#endif // _EXT_MMAP_FILEBUF_H
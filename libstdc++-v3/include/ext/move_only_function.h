@@ -0,0 +1,333 @@
+// Move-only polymorphic function wrapper -*- C++ -*-
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/move_only_function.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _EXT_MOVE_ONLY_FUNCTION_H
+#define _EXT_MOVE_ONLY_FUNCTION_H 1
+
+#pragma GCC system_header
+
+#if __cplusplus >= 201703L
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>		// in_place_type_t
+#include <bits/invoke.h>
+#include <bits/std_function.h>	// bad_function_call
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  template<typename _Signature>
+    class move_only_function;
+
+  /**
+   *  @brief A polymorphic function wrapper for callable objects that
+   *  cannot be copied.
+   *  @ingroup functors
+   *
+   *  Like std::function, but the wrapper can only be moved, so its target
+   *  only has to be move constructible and there is no copy operation to
+   *  dispatch to.  A target of at most three pointers that is nothrow
+   *  move constructible is stored inside the wrapper, anything else is
+   *  allocated with new.  Targets that are trivially copyable, and all
+   *  targets on the heap, are moved by copying the buffer without calling
+   *  through the table of operations.
+   *
+   *  As for std::move_only_function in C++23 the call operator is not
+   *  const, but calling an empty wrapper throws std::bad_function_call
+   *  instead of being undefined.  Only the unqualified signature form
+   *  @c R(Args...) is supported.
+   */
+  template<typename _Res, typename... _ArgTypes>
+    class move_only_function<_Res(_ArgTypes...)>
+    {
+      union _Storage
+      {
+	void* _M_p;
+	alignas(void*) unsigned char _M_bytes[3 * sizeof(void*)];
+      };
+
+      struct _Ops
+      {
+	_Res (*_M_invoke)(_Storage&, _ArgTypes&&...);
+	// Null when the storage can be copied with memcpy.
+	void (*_M_relocate)(_Storage&, _Storage&) noexcept;
+	// Null when there is nothing to destroy.
+	void (*_M_destroy)(_Storage&) noexcept;
+      };
+
+      template<typename _Fn>
+	static constexpr bool __stored_locally
+	  = sizeof(_Fn) <= sizeof(_Storage)
+	    && alignof(_Fn) <= alignof(_Storage)
+	    && std::is_nothrow_move_constructible_v<_Fn>;
+
+      template<typename _Fn>
+	static _Fn*
+	_S_target(_Storage& __s) noexcept
+	{
+	  if constexpr (__stored_locally<_Fn>)
+	    return static_cast<_Fn*>(static_cast<void*>(__s._M_bytes));
+	  else
+	    return static_cast<_Fn*>(__s._M_p);
+	}
+
+      template<typename _Fn>
+	static _Res
+	_S_invoke(_Storage& __s, _ArgTypes&&... __args)
+	{
+	  return std::__invoke_r<_Res>(*_S_target<_Fn>(__s),
+				       std::forward<_ArgTypes>(__args)...);
+	}
+
+      // Move the local target in __src to __dst and destroy the original.
+      template<typename _Fn>
+	static void
+	_S_relocate(_Storage& __dst, _Storage& __src) noexcept
+	{
+	  _Fn* __p = _S_target<_Fn>(__src);
+	  ::new (__dst._M_bytes) _Fn(std::move(*__p));
+	  __p->~_Fn();
+	}
+
+      template<typename _Fn>
+	static void
+	_S_destroy(_Storage& __s) noexcept
+	{
+	  if constexpr (__stored_locally<_Fn>)
+	    _S_target<_Fn>(__s)->~_Fn();
+	  else
+	    delete _S_target<_Fn>(__s);
+	}
+
+      [[noreturn]] static _Res
+      _S_empty_invoke(_Storage&, _ArgTypes&&...)
+      { std::__throw_bad_function_call(); }
+
+      static constexpr _Ops _S_empty_ops
+	= { &_S_empty_invoke, nullptr, nullptr };
+
+      template<typename _Fn>
+	static constexpr bool __trivial
+	  = __stored_locally<_Fn> && std::is_trivially_copyable_v<_Fn>;
+
+      template<typename _Fn>
+	static constexpr _Ops _S_ops = {
+	  &_S_invoke<_Fn>,
+	  __stored_locally<_Fn> && !__trivial<_Fn>
+	    ? &_S_relocate<_Fn> : nullptr,
+	  __trivial<_Fn> ? nullptr : &_S_destroy<_Fn>
+	};
+
+      template<typename _Fn>
+	static bool
+	_S_not_empty(const _Fn& __f)
+	{
+	  if constexpr (std::is_pointer_v<_Fn>
+			|| std::is_member_pointer_v<_Fn>)
+	    return __f != nullptr;
+	  else
+	    return true;
+	}
+
+      template<typename _Fn, typename... _Args>
+	void
+	_M_init(_Args&&... __args)
+	{
+	  if constexpr (__stored_locally<_Fn>)
+	    ::new (_M_storage._M_bytes) _Fn(std::forward<_Args>(__args)...);
+	  else
+	    _M_storage._M_p = new _Fn(std::forward<_Args>(__args)...);
+	  _M_ops = &_S_ops<_Fn>;
+	}
+
+      template<typename _Tp>
+	struct __is_in_place_type : std::false_type { };
+
+      template<typename _Tp>
+	struct __is_in_place_type<std::in_place_type_t<_Tp>> : std::true_type
+	{ };
+
+      template<typename _Fn>
+	using _Callable = std::__and_<
+	  std::__not_<std::is_same<std::decay_t<_Fn>, move_only_function>>,
+	  std::__not_<__is_in_place_type<std::decay_t<_Fn>>>,
+	  std::is_invocable_r<_Res, std::decay_t<_Fn>&, _ArgTypes...>,
+	  std::is_constructible<std::decay_t<_Fn>, _Fn>>;
+
+    public:
+      typedef _Res result_type;
+
+      move_only_function() noexcept
+      : _M_ops(&_S_empty_ops)
+      { }
+
+      move_only_function(std::nullptr_t) noexcept
+      : move_only_function()
+      { }
+
+      /// The target of @a __x is moved, @a __x is left empty.
+      move_only_function(move_only_function&& __x) noexcept
+      : _M_ops(__x._M_ops)
+      { _M_move_from(__x); }
+
+      move_only_function(const move_only_function&) = delete;
+
+      /**
+       *  @brief Store a callable object.
+       *
+       *  A null pointer to function or to member makes an empty wrapper.
+       */
+      template<typename _Functor,
+	       typename = std::enable_if_t<_Callable<_Functor>::value>>
+	move_only_function(_Functor&& __f)
+	: move_only_function()
+	{
+	  if (_S_not_empty(__f))
+	    _M_init<std::decay_t<_Functor>>(std::forward<_Functor>(__f));
+	}
+
+      /// Construct a target of type @a _Tp from @a __args.
+      template<typename _Tp, typename... _Args>
+	explicit
+	move_only_function(std::in_place_type_t<_Tp>, _Args&&... __args)
+	: move_only_function()
+	{
+	  static_assert(std::is_same_v<std::decay_t<_Tp>, _Tp>);
+	  static_assert(std::is_invocable_r_v<_Res, _Tp&, _ArgTypes...>);
+	  _M_init<_Tp>(std::forward<_Args>(__args)...);
+	}
+
+      ~move_only_function()
+      { _M_destroy(); }
+
+      move_only_function&
+      operator=(move_only_function&& __x) noexcept
+      {
+	if (this != &__x)
+	  {
+	    _M_destroy();
+	    _M_ops = __x._M_ops;
+	    _M_move_from(__x);
+	  }
+	return *this;
+      }
+
+      move_only_function& operator=(const move_only_function&) = delete;
+
+      move_only_function&
+      operator=(std::nullptr_t) noexcept
+      {
+	_M_destroy();
+	_M_ops = &_S_empty_ops;
+	return *this;
+      }
+
+      template<typename _Functor>
+	std::enable_if_t<_Callable<_Functor>::value, move_only_function&>
+	operator=(_Functor&& __f)
+	{ return *this = move_only_function(std::forward<_Functor>(__f)); }
+
+      void
+      swap(move_only_function& __x) noexcept
+      {
+	move_only_function __tmp(std::move(__x));
+	__x = std::move(*this);
+	*this = std::move(__tmp);
+      }
+
+      explicit operator bool() const noexcept
+      { return _M_ops != &_S_empty_ops; }
+
+      _Res
+      operator()(_ArgTypes... __args)
+      {
+	return _M_ops->_M_invoke(_M_storage,
+				 std::forward<_ArgTypes>(__args)...);
+      }
+
+    private:
+      // _M_ops has already been copied from __x.
+      void
+      _M_move_from(move_only_function& __x) noexcept
+      {
+	if (_M_ops->_M_relocate)
+	  _M_ops->_M_relocate(_M_storage, __x._M_storage);
+	else
+	  _M_storage = __x._M_storage;
+	__x._M_ops = &_S_empty_ops;
+      }
+
+      void
+      _M_destroy() noexcept
+      {
+	if (_M_ops->_M_destroy)
+	  _M_ops->_M_destroy(_M_storage);
+      }
+
+      _Storage _M_storage;
+      const _Ops* _M_ops;
+    };
+
+  template<typename _Res, typename... _Args>
+    inline void
+    swap(move_only_function<_Res(_Args...)>& __x,
+	 move_only_function<_Res(_Args...)>& __y) noexcept
+    { __x.swap(__y); }
+
+  template<typename _Res, typename... _Args>
+    inline bool
+    operator==(const move_only_function<_Res(_Args...)>& __f,
+	       std::nullptr_t) noexcept
+    { return !static_cast<bool>(__f); }
+
+  template<typename _Res, typename... _Args>
+    inline bool
+    operator==(std::nullptr_t,
+	       const move_only_function<_Res(_Args...)>& __f) noexcept
+    { return !static_cast<bool>(__f); }
+
+  template<typename _Res, typename... _Args>
+    inline bool
+    operator!=(const move_only_function<_Res(_Args...)>& __f,
+	       std::nullptr_t) noexcept
+    { return static_cast<bool>(__f); }
+
+  template<typename _Res, typename... _Args>
+    inline bool
+    operator!=(std::nullptr_t,
+	       const move_only_function<_Res(_Args...)>& __f) noexcept
+    { return static_cast<bool>(__f); }
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace __gnu_cxx
+
+#endif // C++17
+#endif // _EXT_MOVE_ONLY_FUNCTION_H
@@ -0,0 +1,302 @@
+// Memory resource recording allocation statistics -*- C++ -*-
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/stats_resource.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _EXT_STATS_RESOURCE_H
+#define _EXT_STATS_RESOURCE_H 1
+
+#pragma GCC system_header
+
+#if __cplusplus >= 201703L
+
+#include <memory_resource>
+#include <atomic>
+#include <bit>			// __log2p1
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  /**
+   *  @brief A memory resource that forwards to an upstream resource and
+   *  records how it is used.
+   *
+   *  It counts allocations and deallocations, the bytes in use and their
+   *  peak, a histogram of allocation sizes by powers of two, and the
+   *  number of allocations made from each call site.  All counters are
+   *  relaxed atomics, so a stats_resource can be shared between threads
+   *  if its upstream resource can.
+   *
+   *  A call site is the return address of do_allocate, which is usually
+   *  in the function that called memory_resource::allocate.  At most
+   *  @c max_call_sites distinct sites are recorded, later ones are only
+   *  counted in other_call_sites().
+   */
+  class stats_resource : public std::pmr::memory_resource
+  {
+  public:
+    /// Number of buckets in the size histogram.
+    static constexpr int histogram_buckets
+      = std::numeric_limits<std::size_t>::digits + 1;
+
+    /// Number of distinct call sites that are recorded.
+    static constexpr std::size_t max_call_sites = 64;
+
+    /// Counters for one call site.
+    struct call_site
+    {
+      const void* address;
+      std::size_t allocations;
+      std::size_t bytes;
+    };
+
+    stats_resource() noexcept
+    : stats_resource(std::pmr::get_default_resource())
+    { }
+
+    explicit
+    stats_resource(std::pmr::memory_resource* __upstream) noexcept
+    : _M_upstream(__upstream)
+    { }
+
+    stats_resource(const stats_resource&) = delete;
+    stats_resource& operator=(const stats_resource&) = delete;
+
+    std::pmr::memory_resource*
+    upstream_resource() const noexcept
+    { return _M_upstream; }
+
+    /// Number of successful calls to allocate.
+    std::size_t
+    allocations() const noexcept
+    { return _M_allocations.load(std::memory_order_relaxed); }
+
+    /// Number of calls to deallocate.
+    std::size_t
+    deallocations() const noexcept
+    { return _M_deallocations.load(std::memory_order_relaxed); }
+
+    /// Total number of bytes allocated.
+    std::size_t
+    bytes_allocated() const noexcept
+    { return _M_bytes_allocated.load(std::memory_order_relaxed); }
+
+    /// Number of bytes allocated and not yet deallocated.
+    std::size_t
+    bytes_in_use() const noexcept
+    { return _M_bytes_in_use.load(std::memory_order_relaxed); }
+
+    /// Largest value of bytes_in_use() seen.
+    std::size_t
+    peak_bytes() const noexcept
+    { return _M_peak_bytes.load(std::memory_order_relaxed); }
+
+    /**
+     *  Number of allocations in histogram bucket @a __i.  Bucket 0 counts
+     *  allocations of zero bytes and bucket @a __i > 0 counts sizes in
+     *  [2^(i-1), 2^i).
+     */
+    std::size_t
+    histogram(int __i) const noexcept
+    { return _M_histogram[__i].load(std::memory_order_relaxed); }
+
+    /**
+     *  Copy the counters of up to @a __n recorded call sites to
+     *  @a __out, and return the number of call sites copied.
+     */
+    std::size_t
+    call_sites(call_site* __out, std::size_t __n) const noexcept
+    {
+      std::size_t __copied = 0;
+      for (std::size_t __i = 0; __i < max_call_sites && __copied < __n; ++__i)
+	if (const void* __addr = _M_sites[__i]._M_address.load(__relaxed))
+	  __out[__copied++] = {
+	    __addr,
+	    _M_sites[__i]._M_allocations.load(__relaxed),
+	    _M_sites[__i]._M_bytes.load(__relaxed)
+	  };
+      return __copied;
+    }
+
+    /// Number of allocations from call sites that were not recorded.
+    std::size_t
+    other_call_sites() const noexcept
+    { return _M_other_sites.load(std::memory_order_relaxed); }
+
+    /**
+     *  Reset every counter except bytes_in_use(), and make the peak equal
+     *  to the bytes currently in use.
+     */
+    void
+    reset() noexcept
+    {
+      _M_allocations.store(0, __relaxed);
+      _M_deallocations.store(0, __relaxed);
+      _M_bytes_allocated.store(0, __relaxed);
+      _M_peak_bytes.store(_M_bytes_in_use.load(__relaxed), __relaxed);
+      for (auto& __h : _M_histogram)
+	__h.store(0, __relaxed);
+      for (auto& __s : _M_sites)
+	{
+	  __s._M_address.store(nullptr, __relaxed);
+	  __s._M_allocations.store(0, __relaxed);
+	  __s._M_bytes.store(0, __relaxed);
+	}
+      _M_other_sites.store(0, __relaxed);
+    }
+
+    /**
+     *  Write the counters to @a __os as a JSON object, with members
+     *  "allocations", "deallocations", "bytes_allocated", "bytes_in_use",
+     *  "peak_bytes", "histogram" (the non-empty buckets, each with the
+     *  exclusive upper bound of its sizes), "call_sites" and
+     *  "other_call_sites".
+     */
+    template<typename _CharT, typename _Traits>
+      void
+      write_json(std::basic_ostream<_CharT, _Traits>& __os) const
+      {
+	__os << "{\"allocations\":" << allocations()
+	     << ",\"deallocations\":" << deallocations()
+	     << ",\"bytes_allocated\":" << bytes_allocated()
+	     << ",\"bytes_in_use\":" << bytes_in_use()
+	     << ",\"peak_bytes\":" << peak_bytes()
+	     << ",\"histogram\":[";
+	const char* __sep = "";
+	for (int __i = 0; __i < histogram_buckets; ++__i)
+	  if (std::size_t __n = histogram(__i))
+	    {
+	      __os << __sep << "{\"below\":";
+	      if (__i < std::numeric_limits<std::size_t>::digits)
+		__os << (std::size_t(1) << __i);
+	      else
+		__os << "null";
+	      __os << ",\"count\":" << __n << '}';
+	      __sep = ",";
+	    }
+	__os << "],\"call_sites\":[";
+	__sep = "";
+	call_site __sites[max_call_sites];
+	const std::size_t __nsites = call_sites(__sites, max_call_sites);
+	for (std::size_t __i = 0; __i < __nsites; ++__i)
+	  {
+	    __os << __sep << "{\"address\":\"" << __sites[__i].address
+		 << "\",\"allocations\":" << __sites[__i].allocations
+		 << ",\"bytes\":" << __sites[__i].bytes << '}';
+	    __sep = ",";
+	  }
+	__os << "],\"other_call_sites\":" << other_call_sites() << '}';
+      }
+
+  protected:
+    void*
+    do_allocate(std::size_t __bytes, std::size_t __alignment) override
+    {
+      void* __p = _M_upstream->allocate(__bytes, __alignment);
+      _M_record_allocation(__bytes, __builtin_return_address(0));
+      return __p;
+    }
+
+    void
+    do_deallocate(void* __p, std::size_t __bytes,
+		  std::size_t __alignment) override
+    {
+      _M_upstream->deallocate(__p, __bytes, __alignment);
+      _M_deallocations.fetch_add(1, __relaxed);
+      _M_bytes_in_use.fetch_sub(__bytes, __relaxed);
+    }
+
+    bool
+    do_is_equal(const std::pmr::memory_resource& __other) const noexcept
+    override
+    { return this == &__other; }
+
+  private:
+    static constexpr std::memory_order __relaxed = std::memory_order_relaxed;
+
+    void
+    _M_record_allocation(std::size_t __bytes, const void* __site) noexcept
+    {
+      _M_allocations.fetch_add(1, __relaxed);
+      _M_bytes_allocated.fetch_add(__bytes, __relaxed);
+      const std::size_t __in_use
+	= _M_bytes_in_use.fetch_add(__bytes, __relaxed) + __bytes;
+      std::size_t __peak = _M_peak_bytes.load(__relaxed);
+      while (__in_use > __peak
+	     && !_M_peak_bytes.compare_exchange_weak(__peak, __in_use,
+						     __relaxed))
+	{ }
+      _M_histogram[std::__log2p1(__bytes)].fetch_add(1, __relaxed);
+
+      // Open addressing with linear probing.  Sites are never removed
+      // except by reset, so a null slot ends the search.
+      std::size_t __i = (reinterpret_cast<std::uintptr_t>(__site) >> 2)
+	* 0x9e3779b9u;
+      for (std::size_t __probe = 0; __probe < max_call_sites; ++__probe, ++__i)
+	{
+	  _Site& __s = _M_sites[__i % max_call_sites];
+	  const void* __addr = __s._M_address.load(__relaxed);
+	  if (__addr == nullptr
+	      && __s._M_address.compare_exchange_strong(__addr, __site,
+							__relaxed))
+	    __addr = __site;
+	  if (__addr == __site)
+	    {
+	      __s._M_allocations.fetch_add(1, __relaxed);
+	      __s._M_bytes.fetch_add(__bytes, __relaxed);
+	      return;
+	    }
+	}
+      _M_other_sites.fetch_add(1, __relaxed);
+    }
+
+    struct _Site
+    {
+      std::atomic<const void*> _M_address{nullptr};
+      std::atomic<std::size_t> _M_allocations{0};
+      std::atomic<std::size_t> _M_bytes{0};
+    };
+
+    std::pmr::memory_resource* _M_upstream;
+    std::atomic<std::size_t> _M_allocations{0};
+    std::atomic<std::size_t> _M_deallocations{0};
+    std::atomic<std::size_t> _M_bytes_allocated{0};
+    std::atomic<std::size_t> _M_bytes_in_use{0};
+    std::atomic<std::size_t> _M_peak_bytes{0};
+    std::atomic<std::size_t> _M_histogram[histogram_buckets] = { };
+    _Site _M_sites[max_call_sites];
+    std::atomic<std::size_t> _M_other_sites{0};
+  };
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace __gnu_cxx
+
+#endif // C++17
+#endif // _EXT_STATS_RESOURCE_H
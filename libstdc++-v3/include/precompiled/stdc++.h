@@ -134,11 +134,14 @@
 #endif
 
 #if __cplusplus > 201703L
+#include <barrier>
 #include <bit>
 // #include <compare>
 #include <concepts>
+#include <latch>
 #include <numbers>
 // #include <ranges>
+#include <semaphore>
 #include <span>
 // #include <syncstream>
 #include <version>
@@ -26,6 +26,83 @@
 namespace __cxxabiv1 {
 
 
+namespace {
+
+// Walk the hierarchy of WHOLE_TYPE, the type of the complete object at
+// WHOLE_PTR, for __dynamic_cast.
+void *
+dyncast_walk (const void *src_ptr, const __class_type_info *src_type,
+	      const __class_type_info *dst_type, ptrdiff_t src2dst,
+	      const void *whole_ptr, const __class_type_info *whole_type)
+{
+  __class_type_info::__dyncast_result result;
+
+  whole_type->__do_dyncast (src2dst, __class_type_info::__contained_public,
+                            dst_type, whole_ptr, src_type, src_ptr, result);
+  if (!result.dst_ptr)
+    return NULL;
+  if (contained_public_p (result.dst2src))
+    // Src is known to be a public base of dst.
+    return const_cast <void *> (result.dst_ptr);
+  if (contained_public_p (__class_type_info::__sub_kind (result.whole2src & result.whole2dst)))
+    // Both src and dst are known to be public bases of whole. Found a valid
+    // cross cast.
+    return const_cast <void *> (result.dst_ptr);
+  if (contained_nonvirtual_p (result.whole2src))
+    // Src is known to be a non-public nonvirtual base of whole, and not a
+    // base of dst. Found an invalid cross cast, which cannot also be a down
+    // cast
+    return NULL;
+  if (result.dst2src == __class_type_info::__unknown)
+    result.dst2src = dst_type->__find_public_src (src2dst, result.dst_ptr,
+                                                  src_type, src_ptr);
+  if (contained_public_p (result.dst2src))
+    // Found a valid down cast
+    return const_cast <void *> (result.dst_ptr);
+  // Must be an invalid down cast, or the cross cast wasn't bettered
+  return NULL;
+}
+
+#if _GLIBCXX_HAVE_TLS
+// The outcome of a cast depends only on the layout of the complete
+// object, which its vtables describe, and not on where the object is.
+// So each thread remembers the outcomes of its recent casts, keyed by
+// the vtables of the source subobject and of the complete object, and
+// repeating a cast costs a lookup here instead of a walk of the class
+// hierarchy.  The complete object's type is part of the key too, so
+// that a vtable at the address of one in an unloaded library is not
+// mistaken for it.
+
+struct dyncast_cache_entry
+{
+  const void *src_vtable;
+  const void *whole_vtable;
+  const __class_type_info *whole_type;
+  const __class_type_info *src_type;
+  const __class_type_info *dst_type;
+  ptrdiff_t src2dst;
+  // Offset of the result from the source, valid if FOUND.
+  ptrdiff_t offset;
+  bool found;
+};
+
+const unsigned dyncast_cache_size = 64;
+
+__thread dyncast_cache_entry dyncast_cache[dyncast_cache_size];
+
+inline dyncast_cache_entry *
+dyncast_cache_slot (const void *src_vtable,
+		    const __class_type_info *dst_type)
+{
+  __UINTPTR_TYPE__ h = (__UINTPTR_TYPE__) src_vtable
+		       ^ (__UINTPTR_TYPE__) dst_type >> 3;
+  h ^= h >> 7;
+  return &dyncast_cache[(h >> 3) % dyncast_cache_size];
+}
+#endif
+
+}
+
 // this is the external interface to the dynamic cast machinery
 /* sub: source address to be adjusted; nonnull, and since the
  *      source object is polymorphic, *(void**)sub is a virtual pointer.
@@ -54,7 +131,6 @@ __dynamic_cast (const void *src_ptr,    // object started from
   const void *whole_ptr =
       adjust_pointer <void> (src_ptr, prefix->whole_object);
   const __class_type_info *whole_type = prefix->whole_type;
-  __class_type_info::__dyncast_result result;
 
   // If the whole object vptr doesn't refer to the whole object type, we're
   // in the middle of constructing a primary base, and src is a separate
@@ -67,31 +143,38 @@ __dynamic_cast (const void *src_ptr,    // object started from
 				    -offsetof (vtable_prefix, origin));
   if (whole_prefix->whole_type != whole_type)
     return NULL;
-  
-  whole_type->__do_dyncast (src2dst, __class_type_info::__contained_public,
-                            dst_type, whole_ptr, src_type, src_ptr, result);
-  if (!result.dst_ptr)
-    return NULL;
-  if (contained_public_p (result.dst2src))
-    // Src is known to be a public base of dst.
-    return const_cast <void *> (result.dst_ptr);
-  if (contained_public_p (__class_type_info::__sub_kind (result.whole2src & result.whole2dst)))
-    // Both src and dst are known to be public bases of whole. Found a valid
-    // cross cast.
-    return const_cast <void *> (result.dst_ptr);
-  if (contained_nonvirtual_p (result.whole2src))
-    // Src is known to be a non-public nonvirtual base of whole, and not a
-    // base of dst. Found an invalid cross cast, which cannot also be a down
-    // cast
-    return NULL;
-  if (result.dst2src == __class_type_info::__unknown)
-    result.dst2src = dst_type->__find_public_src (src2dst, result.dst_ptr,
-                                                  src_type, src_ptr);
-  if (contained_public_p (result.dst2src))
-    // Found a valid down cast
-    return const_cast <void *> (result.dst_ptr);
-  // Must be an invalid down cast, or the cross cast wasn't bettered
-  return NULL;
+
+#if _GLIBCXX_HAVE_TLS
+  dyncast_cache_entry *entry = dyncast_cache_slot (vtable, dst_type);
+  if (entry->src_vtable == vtable
+      && entry->whole_vtable == whole_vtable
+      && entry->whole_type == whole_type
+      && entry->src_type == src_type
+      && entry->dst_type == dst_type
+      && entry->src2dst == src2dst)
+    return (entry->found
+	    ? const_cast <void *> (adjust_pointer <void> (src_ptr,
+							  entry->offset))
+	    : NULL);
+#endif
+
+  void *dst_ptr = dyncast_walk (src_ptr, src_type, dst_type, src2dst,
+				whole_ptr, whole_type);
+
+#if _GLIBCXX_HAVE_TLS
+  entry->src_vtable = vtable;
+  entry->whole_vtable = whole_vtable;
+  entry->whole_type = whole_type;
+  entry->src_type = src_type;
+  entry->dst_type = dst_type;
+  entry->src2dst = src2dst;
+  entry->found = dst_ptr != NULL;
+  entry->offset = (dst_ptr
+		   ? (static_cast <const char *> (dst_ptr)
+		      - static_cast <const char *> (src_ptr))
+		   : 0);
+#endif
+  return dst_ptr;
 }
 
 }
@@ -73,6 +73,19 @@ using namespace __cxxabiv1;
 # define EMERGENCY_OBJ_COUNT	4
 #endif
 
+// The number of objects can also be chosen when building the library,
+// with -D_GLIBCXX_EH_POOL_NOBJS=N.  With -D_GLIBCXX_EH_POOL_STATIC the
+// arena is a static buffer instead of being allocated at startup, so
+// it is there even if malloc fails that early and takes no heap.
+#ifdef _GLIBCXX_EH_POOL_NOBJS
+# undef EMERGENCY_OBJ_COUNT
+# define EMERGENCY_OBJ_COUNT	_GLIBCXX_EH_POOL_NOBJS
+#endif
+
+#define EMERGENCY_ARENA_SIZE(OBJ_SIZE, OBJ_COUNT) \
+  ((OBJ_SIZE) * (OBJ_COUNT) \
+   + (OBJ_COUNT) * sizeof (__cxa_dependent_exception))
+
 namespace __gnu_cxx
 {
   void __freeres();
@@ -114,13 +127,75 @@ namespace
       friend void __gnu_cxx::__freeres();
     };
 
+#if _GLIBCXX_HOSTED
+  // Set *OBJ_SIZE and *OBJ_COUNT from the GLIBCXX_TUNABLES environment
+  // variable, which holds colon separated settings such as
+  // glibcxx.eh_pool.obj_count=16:glibcxx.eh_pool.obj_size=256.
+  // A count of zero disables the emergency pool.
+  void
+  get_pool_tunables (std::size_t *obj_size, std::size_t *obj_count)
+    {
+      static const char prefix[] = "glibcxx.eh_pool.";
+      const char *str = std::getenv ("GLIBCXX_TUNABLES");
+
+      while (str && *str)
+	{
+	  const char *end = std::strchr (str, ':');
+	  if (!end)
+	    end = str + std::strlen (str);
+	  if (std::strncmp (str, prefix, sizeof (prefix) - 1) == 0)
+	    {
+	      const char *name = str + sizeof (prefix) - 1;
+	      const char *eq = std::strchr (name, '=');
+	      if (eq && eq < end)
+		{
+		  char *num_end;
+		  unsigned long val = std::strtoul (eq + 1, &num_end, 10);
+		  if (num_end == end && num_end != eq + 1)
+		    {
+		      if (eq - name == 8 && !std::strncmp (name, "obj_size", 8))
+			*obj_size = val;
+		      else if (eq - name == 9
+			       && !std::strncmp (name, "obj_count", 9))
+			*obj_count = val;
+		    }
+		}
+	    }
+	  str = *end ? end + 1 : end;
+	}
+    }
+#endif
+
+#ifdef _GLIBCXX_EH_POOL_STATIC
+  char static_arena[EMERGENCY_ARENA_SIZE (EMERGENCY_OBJ_SIZE,
+					  EMERGENCY_OBJ_COUNT)]
+    __attribute__((aligned));
+#endif
+
   pool::pool()
     {
-      // Allocate the arena - we could add a GLIBCXX_EH_ARENA_SIZE environment
-      // to make this tunable.
-      arena_size = (EMERGENCY_OBJ_SIZE * EMERGENCY_OBJ_COUNT
-		    + EMERGENCY_OBJ_COUNT * sizeof (__cxa_dependent_exception));
-      arena = (char *)malloc (arena_size);
+      std::size_t obj_size = EMERGENCY_OBJ_SIZE;
+      std::size_t obj_count = EMERGENCY_OBJ_COUNT;
+#if _GLIBCXX_HOSTED
+      get_pool_tunables (&obj_size, &obj_count);
+#endif
+      // Allocate the arena.  A static arena can only be made smaller.
+      if (obj_count
+	  && obj_size > ((std::size_t) -1 / obj_count
+			 - sizeof (__cxa_dependent_exception)))
+	arena_size = (std::size_t) -1;
+      else
+	arena_size = EMERGENCY_ARENA_SIZE (obj_size, obj_count);
+      arena = NULL;
+#ifdef _GLIBCXX_EH_POOL_STATIC
+      if (arena_size > sizeof (static_arena))
+	arena_size = sizeof (static_arena);
+      if (arena_size >= sizeof (free_entry))
+	arena = static_arena;
+#else
+      if (arena_size >= sizeof (free_entry))
+	arena = (char *)malloc (arena_size);
+#endif
       if (!arena)
 	{
 	  // If the allocation failed go without an emergency pool.
@@ -262,16 +337,135 @@ namespace
   pool emergency_pool;
 }
 
+#if _GLIBCXX_HOSTED && _GLIBCXX_HAVE_TLS
+# define EH_ALLOC_CACHE 1
+#endif
+
+#ifdef EH_ALLOC_CACHE
+namespace
+{
+  // Each thread keeps a few of the exception objects it freed, in size
+  // classes, and reuses them for the next exceptions it allocates, so
+  // that a loop which throws and catches does not call malloc and free
+  // every time.  Objects from malloc get a small header in front of
+  // the exception header, which records their size class so that
+  // __cxa_free_exception knows where to put them back.
+
+  const std::size_t cache_header_size
+    = __alignof__ (__cxa_refcounted_exception) > sizeof (std::size_t)
+      ? __alignof__ (__cxa_refcounted_exception) : sizeof (std::size_t);
+
+  // Sizes of the classes, including the exception header.  Bigger
+  // objects are not cached.
+  const std::size_t cache_class_size[] = { 256, 512, 1024 };
+  const unsigned cache_classes
+    = sizeof (cache_class_size) / sizeof (cache_class_size[0]);
+  const unsigned cache_depth = 4;
+  const std::size_t cache_no_class = cache_classes;
+
+  struct eh_alloc_cache
+  {
+    void *objs[cache_classes][cache_depth];
+    unsigned count[cache_classes];
+    // Set once the thread has destroyed its cache, after which objects
+    // go straight back to malloc and free.
+    bool dead;
+
+    void flush ()
+      {
+	for (unsigned c = 0; c < cache_classes; c++)
+	  {
+	    while (count[c])
+	      free (objs[c][--count[c]]);
+	  }
+      }
+
+    ~eh_alloc_cache ()
+      {
+	flush ();
+	dead = true;
+      }
+  };
+
+  thread_local eh_alloc_cache eh_cache;
+
+  void
+  flush_eh_alloc_cache ()
+    {
+      eh_cache.flush ();
+    }
+
+  // Return memory for an exception object or dependent exception of
+  // SIZE bytes from malloc, or from this thread's cache.
+  void *
+  cache_allocate (std::size_t size)
+    {
+      std::size_t c;
+      for (c = 0; c < cache_classes; c++)
+	if (size <= cache_class_size[c])
+	  break;
+
+      char *block;
+      if (c == cache_no_class)
+	{
+	  if (size > (std::size_t) -1 - cache_header_size)
+	    return NULL;
+	  block = (char *) malloc (size + cache_header_size);
+	}
+      else
+	{
+	  eh_alloc_cache &cache = eh_cache;
+	  if (!cache.dead && cache.count[c])
+	    block = (char *) cache.objs[c][--cache.count[c]];
+	  else
+	    block = (char *) malloc (cache_class_size[c] + cache_header_size);
+	}
+      if (!block)
+	return NULL;
+
+      *reinterpret_cast <std::size_t *> (block) = c;
+      return block + cache_header_size;
+    }
+
+  // Give back memory from cache_allocate.
+  void
+  cache_free (void *ptr)
+    {
+      char *block = (char *) ptr - cache_header_size;
+      std::size_t c = *reinterpret_cast <std::size_t *> (block);
+
+      if (c != cache_no_class)
+	{
+	  eh_alloc_cache &cache = eh_cache;
+	  if (!cache.dead && cache.count[c] < cache_depth)
+	    {
+	      cache.objs[c][cache.count[c]++] = block;
+	      return;
+	    }
+	}
+      free (block);
+    }
+}
+#else
+# define cache_allocate malloc
+# define cache_free free
+#endif
+
 namespace __gnu_cxx
 {
   void
   __freeres()
   {
+#ifdef EH_ALLOC_CACHE
+    flush_eh_alloc_cache ();
+#endif
+#ifndef _GLIBCXX_EH_POOL_STATIC
     if (emergency_pool.arena)
       {
 	::free(emergency_pool.arena);
 	emergency_pool.arena = 0;
       }
+#endif
   }
 }
 
@@ -281,7 +475,7 @@ __cxxabiv1::__cxa_allocate_exception(std::size_t thrown_size) _GLIBCXX_NOTHROW
   void *ret;
 
   thrown_size += sizeof (__cxa_refcounted_exception);
-  ret = malloc (thrown_size);
+  ret = cache_allocate (thrown_size);
 
   if (!ret)
     ret = emergency_pool.allocate (thrown_size);
@@ -302,7 +496,7 @@ __cxxabiv1::__cxa_free_exception(void *vptr) _GLIBCXX_NOTHROW
   if (emergency_pool.in_pool (ptr))
     emergency_pool.free (ptr);
   else
-    free (ptr);
+    cache_free (ptr);
 }
 
 
@@ -312,7 +506,7 @@ __cxxabiv1::__cxa_allocate_dependent_exception() _GLIBCXX_NOTHROW
   __cxa_dependent_exception *ret;
 
   ret = static_cast<__cxa_dependent_exception*>
-    (malloc (sizeof (__cxa_dependent_exception)));
+    (cache_allocate (sizeof (__cxa_dependent_exception)));
 
   if (!ret)
     ret = static_cast <__cxa_dependent_exception*>
@@ -334,5 +528,5 @@ __cxxabiv1::__cxa_free_dependent_exception
   if (emergency_pool.in_pool (vptr))
     emergency_pool.free (vptr);
   else
-    free (vptr);
+    cache_free (vptr);
 }
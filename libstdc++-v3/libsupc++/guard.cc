@@ -49,35 +49,59 @@
 # ifndef _GLIBCXX_USE_FUTEX
 namespace
 {
-  // A single mutex controlling all static initializations.
-  static __gnu_cxx::__recursive_mutex* static_mutex;  
+#  ifdef __GTHREAD_HAS_COND
+  // The mutexes and condition variables controlling static
+  // initializations.  They are only held while a guard is tested or
+  // changed, never while a static is being initialized, so the guards
+  // can be spread over several of them by address, and threads
+  // initializing unrelated statics seldom contend.
+  const unsigned static_lock_count = 16;
+#  else
+  // A single mutex controlling all static initializations.  Without
+  // condition variables it is held for the whole of an initialization,
+  // and nested initializations could deadlock on several mutexes.
+  const unsigned static_lock_count = 1;
+#  endif
+
+  // The mutex or condition variable for guard G.
+  inline unsigned
+  static_lock_index(__cxxabiv1::__guard* g)
+  { return (reinterpret_cast<__UINTPTR_TYPE__>(g) >> 3) % static_lock_count; }
+
+  static __gnu_cxx::__recursive_mutex* static_mutex;
 
   typedef char fake_recursive_mutex[sizeof(__gnu_cxx::__recursive_mutex)]
   __attribute__ ((aligned(__alignof__(__gnu_cxx::__recursive_mutex))));
-  fake_recursive_mutex fake_mutex;
+  fake_recursive_mutex fake_mutex[static_lock_count];
 
   static void init()
-  { static_mutex =  new (&fake_mutex) __gnu_cxx::__recursive_mutex(); }
+  {
+    for (unsigned i = 0; i < static_lock_count; i++)
+      new (&fake_mutex[i]) __gnu_cxx::__recursive_mutex();
+    static_mutex = reinterpret_cast<__gnu_cxx::__recursive_mutex*>(fake_mutex);
+  }
 
   __gnu_cxx::__recursive_mutex&
-  get_static_mutex()
+  get_static_mutex(__cxxabiv1::__guard* g)
   {
     static __gthread_once_t once = __GTHREAD_ONCE_INIT;
     __gthread_once(&once, init);
-    return *static_mutex;
+    return static_mutex[static_lock_index(g)];
   }
 
   // Simple wrapper for exception safety.
   struct mutex_wrapper
   {
+    __gnu_cxx::__recursive_mutex& mutex;
     bool unlock;
-    mutex_wrapper() : unlock(true)
-    { get_static_mutex().lock(); }
+    mutex_wrapper(__cxxabiv1::__guard* g)
+    : mutex(get_static_mutex(g)), unlock(true)
+    { mutex.lock(); }
 
     ~mutex_wrapper()
     {
       if (unlock)
-	static_mutex->unlock();
+	mutex.unlock();
     }
   };
 }
@@ -86,23 +110,27 @@ namespace
 # if defined(__GTHREAD_HAS_COND) && !defined(_GLIBCXX_USE_FUTEX)
 namespace
 {
-  // A single condition variable controlling all static initializations.
-  static __gnu_cxx::__cond* static_cond;  
+  // The condition variables going with the mutexes above.
+  static __gnu_cxx::__cond* static_cond;
 
   // using a fake type to avoid initializing a static class.
   typedef char fake_cond_t[sizeof(__gnu_cxx::__cond)]
   __attribute__ ((aligned(__alignof__(__gnu_cxx::__cond))));
-  fake_cond_t fake_cond;
+  fake_cond_t fake_cond[static_lock_count];
 
   static void init_static_cond()
-  { static_cond =  new (&fake_cond) __gnu_cxx::__cond(); }
+  {
+    for (unsigned i = 0; i < static_lock_count; i++)
+      new (&fake_cond[i]) __gnu_cxx::__cond();
+    static_cond = reinterpret_cast<__gnu_cxx::__cond*>(fake_cond);
+  }
 
   __gnu_cxx::__cond&
-  get_static_cond()
+  get_static_cond(__cxxabiv1::__guard* g)
   {
     static __gthread_once_t once = __GTHREAD_ONCE_INIT;
     __gthread_once(&once, init_static_cond);
-    return *static_cond;
+    return static_cond[static_lock_index(g)];
   }
 }
 # endif
@@ -305,7 +333,7 @@ namespace __cxxabiv1
 # else
     if (__gthread_active_p ())
       {
-	mutex_wrapper mw;
+	mutex_wrapper mw(g);
 
 	while (1)	// When this loop is executing, mutex is locked.
 	  {
@@ -320,7 +348,7 @@ namespace __cxxabiv1
 		// another thread, so we release mutex and wait for the
 		// condition variable. We will lock the mutex again after
 		// this.
-		get_static_cond().wait_recursive(&get_static_mutex());
+		get_static_cond(g).wait_recursive(&mw.mutex);
 	      }
 	    else
 	      {
@@ -364,13 +392,13 @@ namespace __cxxabiv1
 #elif defined(__GTHREAD_HAS_COND)
     if (__gthread_active_p())
       {	
-	mutex_wrapper mw;
+	mutex_wrapper mw(g);
 
 	set_init_in_progress_flag(g, 0);
 
 	// If we abort, we still need to wake up all other threads waiting for
 	// the condition variable.
-        get_static_cond().broadcast();
+        get_static_cond(g).broadcast();
 	return;
       }	
 #endif
@@ -380,7 +408,7 @@ namespace __cxxabiv1
     // This provides compatibility with older systems not supporting POSIX like
     // condition variables.
     if (__gthread_active_p ())
-      static_mutex->unlock();
+      static_mutex[static_lock_index(g)].unlock();
 #endif
   }
 
@@ -404,12 +432,12 @@ namespace __cxxabiv1
 #elif defined(__GTHREAD_HAS_COND)
     if (__gthread_active_p())
       {
-	mutex_wrapper mw;
+	mutex_wrapper mw(g);
 
 	set_init_in_progress_flag(g, 0);
 	_GLIBCXX_GUARD_SET_AND_RELEASE(g);
 
-        get_static_cond().broadcast();
+        get_static_cond(g).broadcast();
 	return;
       }	
 #endif
@@ -421,7 +449,7 @@ namespace __cxxabiv1
     // This provides compatibility with older systems not supporting POSIX like
     // condition variables.
     if (__gthread_active_p())
-      static_mutex->unlock();
+      static_mutex[static_lock_index(g)].unlock();
 #endif
   }
 }
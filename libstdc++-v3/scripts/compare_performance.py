@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+
+# Compare two sets of libstdc++ performance testsuite results.
+
+# Copyright (C) 2019 Free Software Foundation, Inc.
+#
+# This file is part of the GNU ISO C++ Library.  This library is free
+# software; you can redistribute it and/or modify it under the
+# terms of the GNU General Public License as published by the
+# Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License along
+# with this library; see the file COPYING3.  If not see
+# <http://www.gnu.org/licenses/>.
+
+""" Compare two libstdc++-performance.json files.
+
+Each line of the files is a result written by report_performance in
+testsuite_performance.h.  When a test was run several times, the
+median of its results is used.  A result is reported as a regression
+if its median user+system time grew by more than --percent and by more
+than --min-seconds, or its allocated memory grew by more than --percent
+and by more than a page.  The exit status is 1 if there are
+regressions.
+
+  compare_performance.py old/libstdc++-performance.json \\
+      new/libstdc++-performance.json
+"""
+
+import argparse
+import json
+import sys
+
+
+def median(values):
+    values = sorted(values)
+    n = len(values)
+    if n % 2:
+        return values[n // 2]
+    return (values[n // 2 - 1] + values[n // 2]) / 2.0
+
+
+def read_results(filename):
+    """ Return a dictionary mapping (test, comment) to the medians of
+    the CPU time and the allocated memory of its results in FILENAME.
+    """
+    runs = {}
+    with open(filename) as f:
+        for line in f:
+            if not line.strip():
+                continue
+            result = json.loads(line)
+            key = (result['test'], result['comment'].strip())
+            runs.setdefault(key, []).append(result)
+    return dict((key, (median([r['user'] + r['system'] for r in results]),
+                       median([r['memory'] for r in results]),
+                       len(results)))
+                for key, results in runs.items())
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument('baseline')
+parser.add_argument('current')
+parser.add_argument('--percent', type=float, default=5.0,
+                    help='smallest relative increase to report')
+parser.add_argument('--min-seconds', type=float, default=0.05,
+                    help='smallest time increase to report')
+parser.add_argument('--all', action='store_true',
+                    help='list every result, not just the regressions')
+args = parser.parse_args()
+
+old = read_results(args.baseline)
+new = read_results(args.current)
+regressions = 0
+for key in sorted(new):
+    test, comment = key
+    time, memory, runs = new[key]
+    if key not in old:
+        print('%s %s: not in %s' % (test, comment, args.baseline))
+        continue
+    old_time, old_memory, old_runs = old[key]
+    slower = (time - old_time > args.min_seconds
+              and time > old_time * (1 + args.percent / 100))
+    bigger = (memory - old_memory > 4096
+              and memory > max(old_memory, 0) * (1 + args.percent / 100))
+    if slower or bigger:
+        regressions += 1
+    if slower or bigger or args.all:
+        print('%s %s: %.2fs -> %.2fs, %d -> %d bytes (%d/%d runs)%s'
+              % (test, comment, old_time, time, old_memory, memory,
+                 old_runs, runs, ' REGRESSION' if slower or bigger else ''))
+
+for key in sorted(set(old) - set(new)):
+    print('%s %s: not in %s' % (key[0], key[1], args.current))
+
+if regressions:
+    print('%d regressions' % regressions)
+    sys.exit(1)
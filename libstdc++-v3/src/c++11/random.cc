@@ -65,7 +65,17 @@
 # include <stdlib.h>
 #endif
 
-#if defined USE_RDRAND || defined USE_RDSEED \
+#if defined __linux__ && defined __has_include
+# if __has_include(<sys/random.h>)
+#  include <sys/random.h>
+#  ifdef GRND_NONBLOCK
+#   define USE_GETRANDOM 1
+#   include <pthread.h>
+#  endif
+# endif
+#endif
+
+#if defined USE_RDRAND || defined USE_RDSEED || defined USE_GETRANDOM \
   || defined _GLIBCXX_USE_CRT_RAND_S || defined _GLIBCXX_USE_DEV_RANDOM
 # pragma GCC poison _M_mt
 #else
@@ -112,6 +122,70 @@ namespace std _GLIBCXX_VISIBILITY(default)
     }
 #endif
 
+#if USE_GETRANDOM
+    void
+    __getrandom_fill(void* p, size_t n)
+    {
+      do
+	{
+	  const ssize_t e = ::getrandom(p, n, 0);
+	  if (e > 0)
+	    {
+	      n -= e;
+	      p = static_cast<char*>(p) + e;
+	    }
+	  else if (e != -1 || errno != EINTR)
+	    std::__throw_runtime_error(__N("random_device: getrandom failed"));
+	}
+      while (n > 0);
+    }
+
+#ifdef _GLIBCXX_HAVE_TLS
+    // Values are handed out from a per-thread buffer that is refilled by a
+    // single getrandom call, so most calls make no system call and take no
+    // lock.  Each value is cleared once it has been used.  The buffer is
+    // refilled after fork, so that the parent and the child never return
+    // the same values.
+    struct getrandom_reservoir
+    {
+      unsigned int buf[64];	// 256 bytes is the largest uninterruptible read
+      unsigned int avail;	// number of unused values at the start of buf
+      unsigned int forks;	// value of getrandom_forks when buf was filled
+    };
+
+    __thread getrandom_reservoir getrandom_buf;
+    unsigned int getrandom_forks;
+
+    void
+    getrandom_child()
+    { __atomic_fetch_add(&getrandom_forks, 1, __ATOMIC_RELAXED); }
+#endif
+
+    unsigned int
+    __getrandom(void*)
+    {
+#ifdef _GLIBCXX_HAVE_TLS
+      getrandom_reservoir& r = getrandom_buf;
+      const unsigned int forks
+	= __atomic_load_n(&getrandom_forks, __ATOMIC_RELAXED);
+      if (r.avail == 0 || r.forks != forks)
+	{
+	  __getrandom_fill(r.buf, sizeof(r.buf));
+	  r.avail = sizeof(r.buf) / sizeof(r.buf[0]);
+	  r.forks = forks;
+	}
+      unsigned int& slot = r.buf[--r.avail];
+      const unsigned int val = slot;
+      slot = 0;
+      return val;
+#else
+      unsigned int val;
+      __getrandom_fill(&val, sizeof(val));
+      return val;
+#endif
+    }
+#endif
+
 #ifdef _GLIBCXX_USE_CRT_RAND_S
     unsigned int
     __winxp_rand_s(void*)
@@ -140,7 +214,7 @@ namespace std _GLIBCXX_VISIBILITY(default)
     const char* fname [[gnu::unused]] = nullptr;
     bool default_token [[gnu::unused]] = false;
 
-    enum { rand_s, rdseed, rdrand, device_file } which;
+    enum { rand_s, getrandom, rdseed, rdrand, device_file } which;
 
     if (token == "default")
       {
@@ -148,6 +222,8 @@ namespace std _GLIBCXX_VISIBILITY(default)
 	fname = "/dev/urandom";
 #if defined _GLIBCXX_USE_CRT_RAND_S
 	which = rand_s;
+#elif defined USE_GETRANDOM
+	which = getrandom;
 #elif defined USE_RDSEED
 	which = rdseed;
 #elif defined USE_RDRAND
@@ -158,6 +234,10 @@ namespace std _GLIBCXX_VISIBILITY(default)
 # error "either define USE_MT19937 above or set the default device here"
 #endif
       }
+#ifdef USE_GETRANDOM
+    else if (token == "getrandom")
+      which = getrandom;
+#endif // USE_GETRANDOM
 #ifdef USE_RDSEED
     else if (token == "rdseed")
       which = rdseed;
@@ -191,6 +271,27 @@ namespace std _GLIBCXX_VISIBILITY(default)
 	return;
       }
 #endif // _GLIBCXX_USE_CRT_RAND_S
+#ifdef USE_GETRANDOM
+      case getrandom:
+      {
+	// Check that the kernel supports the system call.
+	char c;
+	if (::getrandom(&c, 0, GRND_NONBLOCK) == 0)
+	  {
+#ifdef _GLIBCXX_HAVE_TLS
+	    static int atfork [[gnu::unused]]
+	      = ::pthread_atfork(nullptr, nullptr, &getrandom_child);
+#endif
+	    _M_func = &__getrandom;
+	    return;
+	  }
+	// If getrandom was explicitly requested then we're done here.
+	if (!default_token)
+	  break;
+	// Otherwise fall through to try the next available option.
+	[[gnu::fallthrough]];
+      }
+#endif // USE_GETRANDOM
 #ifdef USE_RDSEED
       case rdseed:
       {
@@ -328,7 +429,8 @@ namespace std _GLIBCXX_VISIBILITY(default)
     return _M_mt();
 #else
 
-#if defined USE_RDRAND || defined USE_RDSEED || defined _GLIBCXX_USE_CRT_RAND_S
+#if defined USE_RDRAND || defined USE_RDSEED || defined USE_GETRANDOM \
+  || defined _GLIBCXX_USE_CRT_RAND_S
     if (_M_func)
       return _M_func(nullptr);
 #endif
@@ -368,6 +470,12 @@ namespace std _GLIBCXX_VISIBILITY(default)
   double
   random_device::_M_getentropy() const noexcept
   {
+#ifdef USE_GETRANDOM
+    // getrandom blocks until the kernel's generator has been seeded.
+    if (_M_func == &__getrandom)
+      return static_cast<double>(sizeof(result_type) * __CHAR_BIT__);
+#endif
+
 #if defined _GLIBCXX_USE_DEV_RANDOM \
     && defined _GLIBCXX_HAVE_SYS_IOCTL_H && defined RNDGETENTCNT
     if (!_M_file)
@@ -0,0 +1,79 @@
+// Helpers for the floating-point <charconv> implementation -*- C++ -*-
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <cstdint>
+#include <cstring>
+#include <locale.h>
+
+namespace std _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+namespace __floating_charconv
+{
+  // Layout of the IEEE binary formats of float and double.
+  template<typename _Tp>
+    struct ieee_traits;
+
+  template<>
+    struct ieee_traits<float>
+    {
+      using uint_type = uint32_t;
+      static constexpr int mantissa_bits = 23;
+      static constexpr int exponent_bits = 8;
+      static constexpr int bias = 127;
+    };
+
+  template<>
+    struct ieee_traits<double>
+    {
+      using uint_type = uint64_t;
+      static constexpr int mantissa_bits = 52;
+      static constexpr int exponent_bits = 11;
+      static constexpr int bias = 1023;
+    };
+
+  // The C library functions used as fallbacks must behave as in the "C"
+  // locale, whatever the global locale is.  Switch the calling thread
+  // to the "C" locale for the lifetime of this object.
+  struct c_locale_scope
+  {
+#ifdef __GLIBC__
+    c_locale_scope() : _M_old(::uselocale(_S_c_locale())) { }
+
+    ~c_locale_scope() { ::uselocale(_M_old); }
+
+    static locale_t
+    _S_c_locale()
+    {
+      static const locale_t __loc
+	= ::newlocale(LC_ALL_MASK, "C", locale_t());
+      return __loc;
+    }
+
+    locale_t _M_old;
+#endif
+  };
+} // namespace __floating_charconv
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace std
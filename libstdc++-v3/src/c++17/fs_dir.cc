@@ -53,6 +53,15 @@ struct fs::_Dir : _Dir_base
 
   _Dir(posix::DIR* dirp, const path& p) : _Dir_base(dirp), path(p) { }
 
+  // Open the directory that parent.entry refers to.
+  _Dir(const _Dir& parent, bool skip_permission_denied, error_code& ec)
+  : _Dir_base(parent, parent.entry.path().filename().c_str(),
+	      parent.entry.path().c_str(), skip_permission_denied, ec)
+  {
+    if (!ec)
+      path = parent.entry.path();
+  }
+
   _Dir(_Dir&&) = default;
 
   // Returns false when the end of the directory entries is reached.
@@ -291,7 +300,7 @@ fs::recursive_directory_iterator::increment(error_code& ec)
 
   if (std::exchange(_M_dirs->pending, true) && top.should_recurse(follow, ec))
     {
-      _Dir dir(top.entry.path(), skip_permission_denied, ec);
+      _Dir dir(top, skip_permission_denied, ec);
       if (ec)
 	{
 	  _M_dirs.reset();
@@ -1041,7 +1041,10 @@ namespace pmr
    * or _M_tpools[0] or any other thread's _M_tpools[_M_key] requires an
    * exclusive lock.
    * The upstream_resource() pointer can be obtained without a lock, but
-   * any dereference of that pointer requires an exclusive lock.
+   * any dereference of that pointer requires an exclusive lock, or a
+   * shared lock together with _M_tpools[0].upstream_mx.  The latter is
+   * used to replenish a thread's own pools, so that one thread going
+   * upstream does not stop every other thread from using its pools.
    * The _M_impl._M_opts and _M_impl._M_npools members are immutable,
    * and can safely be accessed concurrently.
    */
@@ -1098,6 +1101,9 @@ namespace pmr
     __pool_resource::_Pool* pools = nullptr;
     _TPools* prev = nullptr;
     _TPools* next = nullptr;
+    // Serializes use of the upstream resource by threads holding a
+    // shared lock.  Only the one in _M_tpools[0] is used.
+    mutex upstream_mx;
 
     static void destroy(_TPools* p)
     {
@@ -1191,13 +1197,16 @@ namespace pmr
 	  shared_lock l(_M_mx);
 	  if (auto pools = _M_thread_specific_pools()) // [[likely]]
 	    {
-	      // Need exclusive lock to replenish so use try_allocate:
 	      if (void* p = pools[index].try_allocate())
 		return p;
-	      // Need to take exclusive lock and replenish pool.
+	      // No other thread can use this thread's pools while the
+	      // shared lock is held, so replenishing only needs the
+	      // calls to the upstream resource to be serialized.
+	      lock_guard<mutex> ul(_M_tpools->upstream_mx);
+	      return pools[index].allocate(r, opts);
 	    }
-	  // Need to allocate or replenish thread-specific pools using
-	  // upstream resource, so need to hold exclusive lock.
+	  // Need to allocate thread-specific pools using upstream
+	  // resource, so need to hold exclusive lock.
 	}
 	// N.B. Another thread could call release() now lock is not held.
 	exclusive_lock excl(_M_mx);
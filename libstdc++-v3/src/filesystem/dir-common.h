@@ -36,6 +36,13 @@
 # endif
 # include <dirent.h>
 #endif
+#if defined _GLIBCXX_HAVE_OPENAT && defined _GLIBCXX_HAVE_FDOPENDIR \
+  && defined _GLIBCXX_HAVE_DIRFD && defined _GLIBCXX_HAVE_FCNTL_H \
+  && defined _GLIBCXX_HAVE_UNISTD_H
+# include <fcntl.h>  // openat, O_DIRECTORY
+# include <unistd.h> // close
+# define _GLIBCXX_USE_OPENAT_DIR 1
+#endif
 
 namespace std _GLIBCXX_VISIBILITY(default)
 {
@@ -80,18 +87,21 @@ struct _Dir_base
   _Dir_base(const posix::char_type* pathname, bool skip_permission_denied,
 	    error_code& ec) noexcept
   : dirp(posix::opendir(pathname))
-  {
-    if (dirp)
-      ec.clear();
-    else
-    {
-      const int err = errno;
-      if (err == EACCES && skip_permission_denied)
-	ec.clear();
-      else
-	ec.assign(err, std::generic_category());
-    }
-  }
+  { set_open_error(skip_permission_denied, ec); }
+
+  // As above, but open the entry called name in the directory parent.
+  // When openat is available the name is resolved relative to parent's
+  // file descriptor, so the kernel does not walk pathname again.
+  _Dir_base(const _Dir_base& parent [[gnu::unused]],
+	    const posix::char_type* name [[gnu::unused]],
+	    const posix::char_type* pathname,
+	    bool skip_permission_denied, error_code& ec) noexcept
+#ifdef _GLIBCXX_USE_OPENAT_DIR
+  : dirp(openat(parent.dirp, name))
+#else
+  : dirp(posix::opendir(pathname))
+#endif
+  { set_open_error(skip_permission_denied, ec); }
 
   _Dir_base(_Dir_base&& d) : dirp(std::exchange(d.dirp, nullptr)) { }
 
@@ -130,6 +140,41 @@ struct _Dir_base
       }
   }
 
+  void
+  set_open_error(bool skip_permission_denied, error_code& ec) noexcept
+  {
+    if (dirp)
+      ec.clear();
+    else
+    {
+      const int err = errno;
+      if (err == EACCES && skip_permission_denied)
+	ec.clear();
+      else
+	ec.assign(err, std::generic_category());
+    }
+  }
+
+#ifdef _GLIBCXX_USE_OPENAT_DIR
+  static posix::DIR*
+  openat(posix::DIR* parent, const char* name) noexcept
+  {
+    int flags = O_RDONLY | O_DIRECTORY;
+#ifdef O_CLOEXEC
+    flags |= O_CLOEXEC;
+#endif
+    const int fd = ::openat(::dirfd(parent), name, flags);
+    if (fd == -1)
+      return nullptr;
+    if (posix::DIR* d = ::fdopendir(fd))
+      return d;
+    const int err = errno;
+    ::close(fd);
+    errno = err;
+    return nullptr;
+  }
+#endif
+
   static bool is_dot_or_dotdot(const char* s) noexcept
   { return !strcmp(s, ".") || !strcmp(s, ".."); }
 
@@ -51,6 +51,10 @@
 # ifdef _GLIBCXX_USE_SENDFILE
 #  include <sys/sendfile.h> // sendfile
 # endif
+# if defined _GLIBCXX_HAVE_LINUX_FS_H && defined _GLIBCXX_HAVE_SYS_IOCTL_H
+#  include <sys/ioctl.h>    // ioctl
+#  include <linux/fs.h>     // FICLONE
+# endif
 #endif
 
 namespace std _GLIBCXX_VISIBILITY(default)
@@ -444,15 +448,57 @@ _GLIBCXX_BEGIN_NAMESPACE_FILESYSTEM
       }
 
     size_t count = from_st->st_size;
-#if defined _GLIBCXX_USE_SENDFILE && ! defined _GLIBCXX_FILESYSTEM_IS_WINDOWS
     off_t offset = 0;
-    ssize_t n = ::sendfile(out.fd, in.fd, &offset, count);
-    if (n < 0 && errno != ENOSYS && errno != EINVAL)
+#if defined FICLONE && ! defined _GLIBCXX_FILESYSTEM_IS_WINDOWS
+    // On filesystems that support it, share the source file's extents
+    // instead of copying any data.
+    if (count && ::ioctl(out.fd, FICLONE, in.fd) == 0)
       {
-	ec.assign(errno, std::generic_category());
-	return false;
+	offset = count;
+	count = 0;
       }
-    if ((size_t)n == count)
+#endif
+
+#if defined _GLIBCXX_HAVE_COPY_FILE_RANGE \
+  && ! defined _GLIBCXX_FILESYSTEM_IS_WINDOWS
+    // Copy within the kernel, which can also reflink or do a server-side
+    // copy.  Fall back to sendfile if the files are on different
+    // filesystems or the filesystem does not support it.
+    while (count)
+      {
+	ssize_t n = ::copy_file_range(in.fd, nullptr, out.fd, nullptr,
+				      count, 0);
+	if (n < 0)
+	  {
+	    const int err = errno;
+	    if (err == ENOSYS || err == EXDEV || err == EINVAL
+		|| err == EOPNOTSUPP || err == EBADF)
+	      break;
+	    ec.assign(err, std::generic_category());
+	    return false;
+	  }
+	if (n == 0)
+	  break;
+	offset += n;
+	count -= n;
+      }
+#endif // _GLIBCXX_HAVE_COPY_FILE_RANGE
+
+#if defined _GLIBCXX_USE_SENDFILE && ! defined _GLIBCXX_FILESYSTEM_IS_WINDOWS
+    if (count)
+      {
+	ssize_t n = ::sendfile(out.fd, in.fd, &offset, count);
+	if (n < 0 && errno != ENOSYS && errno != EINVAL)
+	  {
+	    ec.assign(errno, std::generic_category());
+	    return false;
+	  }
+	else if (n > 0)
+	  count -= n;
+      }
+#endif // _GLIBCXX_USE_SENDFILE
+
+    if (count == 0)
       {
 	if (!out.close() || !in.close())
 	  {
@@ -462,9 +508,6 @@ _GLIBCXX_BEGIN_NAMESPACE_FILESYSTEM
 	ec.clear();
 	return true;
       }
-    else if (n > 0)
-      count -= n;
-#endif // _GLIBCXX_USE_SENDFILE
 
     using std::ios;
     __gnu_cxx::stdio_filebuf<char> sbin(in.fd, ios::in|ios::binary);
@@ -475,14 +518,10 @@ _GLIBCXX_BEGIN_NAMESPACE_FILESYSTEM
     if (sbout.is_open())
       out.fd = -1;
 
-#ifdef _GLIBCXX_USE_SENDFILE
-    if (n != 0)
+    if (offset != 0)
       {
-	if (n < 0)
-	  n = 0;
-
-	const auto p1 = sbin.pubseekoff(n, ios::beg, ios::in);
-	const auto p2 = sbout.pubseekoff(n, ios::beg, ios::out);
+	const auto p1 = sbin.pubseekoff(offset, ios::beg, ios::in);
+	const auto p2 = sbout.pubseekoff(offset, ios::beg, ios::out);
 
 	const std::streampos errpos(std::streamoff(-1));
 	if (p1 == errpos || p2 == errpos)
@@ -491,7 +530,6 @@ _GLIBCXX_BEGIN_NAMESPACE_FILESYSTEM
 	    return false;
 	  }
       }
-#endif
 
     if (count && !(std::ostream(&sbout) << &sbin))
       {
@@ -0,0 +1,108 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// __dynamic_cast remembers the outcome of recent casts.  Check that
+// repeating casts, from the same subobject types in different objects
+// and during construction, still gives the right answers.
+
+#include <testsuite_hooks.h>
+
+struct A { virtual ~A() { } int a; };
+struct B : virtual A { int b; };
+struct C : virtual A { int c; };
+struct D : B, C { int d; };
+struct E { virtual ~E() { } int e; };
+struct F : D, E { int f; };
+struct G : A { int g; };
+struct X1 : A { };
+struct X2 : A { };
+struct Amb : X1, X2 { };
+
+struct K;
+K* in_ctor_k;
+B* in_ctor_b;
+
+struct KB : B
+{
+  KB();
+};
+
+struct K : KB, E { };
+
+KB::KB()
+{
+  A* a = this;
+  // The K is not constructed yet, only its B and A bases.
+  in_ctor_k = dynamic_cast<K*>(a);
+  in_ctor_b = dynamic_cast<B*>(a);
+}
+
+void
+test01()
+{
+  F f1, f2;
+  G g;
+  D d;
+  Amb amb;
+
+  for (int i = 0; i < 3; i++)
+    {
+      A* a1 = static_cast<B*>(&f1);
+      A* a2 = static_cast<B*>(&f2);
+      VERIFY( dynamic_cast<F*>(a1) == &f1 );
+      VERIFY( dynamic_cast<F*>(a2) == &f2 );
+      VERIFY( dynamic_cast<C*>(a1) == static_cast<C*>(&f1) );
+      VERIFY( dynamic_cast<E*>(a2) == static_cast<E*>(&f2) );
+      VERIFY( dynamic_cast<G*>(a1) == 0 );
+
+      A* ad = static_cast<C*>(&d);
+      VERIFY( dynamic_cast<D*>(ad) == &d );
+      VERIFY( dynamic_cast<F*>(ad) == 0 );
+      VERIFY( dynamic_cast<E*>(ad) == 0 );
+
+      A* ag = &g;
+      VERIFY( dynamic_cast<G*>(ag) == &g );
+      VERIFY( dynamic_cast<B*>(ag) == 0 );
+
+      A* ax = static_cast<X1*>(&amb);
+      VERIFY( dynamic_cast<Amb*>(ax) == &amb );
+      VERIFY( dynamic_cast<X2*>(ax) == static_cast<X2*>(&amb) );
+      A* ay = static_cast<X2*>(&amb);
+      VERIFY( dynamic_cast<X1*>(ay) == static_cast<X1*>(&amb) );
+    }
+}
+
+void
+test02()
+{
+  for (int i = 0; i < 3; i++)
+    {
+      K k;
+      VERIFY( in_ctor_k == 0 );
+      VERIFY( in_ctor_b == static_cast<B*>(&k) );
+      A* a = &k;
+      VERIFY( dynamic_cast<K*>(a) == &k );
+      VERIFY( dynamic_cast<E*>(a) == static_cast<E*>(&k) );
+    }
+}
+
+int
+main()
+{
+  test01();
+  test02();
+}
@@ -0,0 +1,115 @@
+// { dg-do run { target c++11 } }
+// { dg-options "-pthread" }
+// { dg-require-effective-target pthread }
+// { dg-set-target-env-var GLIBCXX_TUNABLES "glibcxx.eh_pool.obj_count=4:glibcxx.eh_pool.obj_size=128" }
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Exception objects are reused through a per-thread cache, including
+// ones freed by a different thread from the one that allocated them.
+
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <testsuite_hooks.h>
+
+template<int N>
+  struct sized
+  {
+    char buf[N];
+    int value;
+  };
+
+template<int N>
+  void
+  throw_sized(int i)
+  {
+    try
+      {
+	sized<N> s;
+	s.value = i;
+	throw s;
+      }
+    catch (const sized<N>& s)
+      {
+	VERIFY( s.value == i );
+      }
+  }
+
+void
+test01()
+{
+  for (int i = 0; i < 100; i++)
+    {
+      throw_sized<1>(i);
+      throw_sized<200>(i);
+      throw_sized<600>(i);
+      throw_sized<4000>(i);
+      try
+	{
+	  try
+	    {
+	      throw i;
+	    }
+	  catch (...)
+	    {
+	      std::throw_with_nested(std::logic_error("nested"));
+	    }
+	}
+      catch (const std::logic_error&)
+	{
+	}
+    }
+}
+
+void
+test02()
+{
+  std::vector<std::exception_ptr> ptrs;
+  for (int i = 0; i < 20; i++)
+    ptrs.push_back(std::make_exception_ptr(i));
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+    threads.emplace_back([&ptrs, t] {
+      test01();
+      for (int i = 0; i < 20; i++)
+	try
+	  {
+	    std::rethrow_exception(ptrs[(i + t) % 20]);
+	  }
+	catch (int k)
+	  {
+	    VERIFY( k == (i + t) % 20 );
+	  }
+    });
+  for (auto& t : threads)
+    t.join();
+
+  // The last references are dropped here, on another thread.
+  ptrs.clear();
+  test01();
+}
+
+int
+main()
+{
+  test01();
+  test02();
+}
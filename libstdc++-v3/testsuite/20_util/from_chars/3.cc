@@ -0,0 +1,120 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-options "-std=gnu++17" }
+// { dg-do run { target c++17 } }
+
+// Floating-point std::from_chars.
+
+#include <charconv>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+#include <testsuite_hooks.h>
+
+template<typename T>
+bool
+check(std::string_view s, T expected, std::size_t len,
+      std::chars_format fmt = std::chars_format::general)
+{
+  T val = 99;
+  std::from_chars_result r = std::from_chars(s.begin(), s.end(), val, fmt);
+  return r.ec == std::errc{} && r.ptr == s.begin() + len
+    && std::memcmp(&val, &expected, sizeof(T)) == 0;
+}
+
+template<typename T>
+bool
+check_error(std::string_view s, std::errc ec, std::size_t len,
+	    std::chars_format fmt = std::chars_format::general)
+{
+  T val = 99;
+  std::from_chars_result r = std::from_chars(s.begin(), s.end(), val, fmt);
+  return r.ec == ec && r.ptr == s.begin() + len && val == 99;
+}
+
+void
+test01()
+{
+  using std::chars_format;
+  VERIFY( check("0", 0.0, 1) );
+  VERIFY( check("-0", -0.0, 2) );
+  VERIFY( check("1.5", 1.5, 3) );
+  VERIFY( check(".5", 0.5, 2) );
+  VERIFY( check("5.", 5.0, 2) );
+  VERIFY( check("0.1", 0.1, 3) );
+  VERIFY( check("0.1", 0.1f, 3) );
+  VERIFY( check("1e3x", 1000.0, 3) );
+  VERIFY( check("1e", 1.0, 1) );
+  VERIFY( check("1e+", 1.0, 1) );
+  VERIFY( check("1.7976931348623157e308", DBL_MAX, 22) );
+  VERIFY( check("2.2250738585072014e-308", DBL_MIN, 23) );
+  VERIFY( check("4.9406564584124654e-324", 5e-324, 23) );
+  VERIFY( check("9007199254740993", 9007199254740992.0, 16) );
+  VERIFY( check("9007199254740995", 9007199254740996.0, 16) );
+  // Needs more than 19 digits to be rounded correctly.
+  VERIFY( check("9007199254740993.00000000000000000001",
+		9007199254740994.0, 37) );
+  VERIFY( check("3.4028235e38", FLT_MAX, 12) );
+  VERIFY( check("0.5", 0.5L, 3) );
+  VERIFY( check("1e3", 1.0, 1, chars_format::fixed) );
+  VERIFY( check("1e3", 1000.0, 3, chars_format::scientific) );
+  VERIFY( check("1.8p1", 3.0, 5, chars_format::hex) );
+  VERIFY( check("0x1", 0.0, 1, chars_format::hex) );
+  VERIFY( check("-ff", -255.0, 3, chars_format::hex) );
+}
+
+void
+test02()
+{
+  VERIFY( check("inf", (double)INFINITY, 3) );
+  VERIFY( check("-INFINITY", -(double)INFINITY, 9) );
+  VERIFY( check("infinit", (double)INFINITY, 3) );
+  double d;
+  std::string_view s = "nan(123)";
+  std::from_chars_result r = std::from_chars(s.begin(), s.end(), d);
+  VERIFY( r.ec == std::errc{} && r.ptr == s.end() && std::isnan(d) );
+  s = "NaN(";
+  r = std::from_chars(s.begin(), s.end(), d);
+  VERIFY( r.ec == std::errc{} && r.ptr == s.begin() + 3 && std::isnan(d) );
+}
+
+void
+test03()
+{
+  using std::chars_format;
+  using std::errc;
+  VERIFY( check_error<double>("", errc::invalid_argument, 0) );
+  VERIFY( check_error<double>("-", errc::invalid_argument, 0) );
+  VERIFY( check_error<double>("+1", errc::invalid_argument, 0) );
+  VERIFY( check_error<double>(".", errc::invalid_argument, 0) );
+  VERIFY( check_error<double>("e5", errc::invalid_argument, 0) );
+  VERIFY( check_error<double>("1", errc::invalid_argument, 0,
+			      chars_format::scientific) );
+  VERIFY( check_error<double>("1e309", errc::result_out_of_range, 5) );
+  VERIFY( check_error<double>("1e-400", errc::result_out_of_range, 6) );
+  VERIFY( check_error<float>("1e39", errc::result_out_of_range, 4) );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
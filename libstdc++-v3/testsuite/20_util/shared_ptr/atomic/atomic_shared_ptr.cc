@@ -0,0 +1,117 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-options "-std=gnu++2a -pthread" }
+// { dg-do run { target c++2a } }
+// { dg-require-effective-target pthread }
+// { dg-require-gthreads "" }
+
+#include <memory>
+#include <thread>
+#include <testsuite_hooks.h>
+
+#ifndef __cpp_lib_atomic_shared_ptr
+# error "Feature-test macro for atomic<shared_ptr<T>> missing"
+#endif
+
+void
+test01()
+{
+  std::atomic<std::shared_ptr<int>> a;
+  VERIFY( !a.load() );
+  VERIFY( !a.is_lock_free() );
+
+  a = std::make_shared<int>(1);
+  std::shared_ptr<int> p = a;
+  VERIFY( *p == 1 );
+  VERIFY( p.use_count() == 2 );
+
+  auto q = std::make_shared<int>(2);
+  VERIFY( a.compare_exchange_strong(p, q) );
+  VERIFY( a.load() == q );
+  VERIFY( p.use_count() == 1 );
+  VERIFY( !a.compare_exchange_weak(p, nullptr) );
+  VERIFY( p == q );
+
+  // Same pointer, different owner: not equivalent.
+  std::shared_ptr<int> alias(std::make_shared<int>(3), q.get());
+  VERIFY( !a.compare_exchange_strong(alias, nullptr) );
+  VERIFY( alias == q && !alias.owner_before(q) && !q.owner_before(alias) );
+
+  auto old = a.exchange(nullptr);
+  VERIFY( old == q );
+  VERIFY( !a.load() );
+  VERIFY( q.use_count() == 4 );
+}
+
+void
+test02()
+{
+  auto p = std::make_shared<int>(4);
+  std::atomic<std::weak_ptr<int>> w(p);
+  VERIFY( w.load().lock() == p );
+  VERIFY( p.use_count() == 1 );
+
+  std::weak_ptr<int> e = w;
+  VERIFY( w.compare_exchange_strong(e, std::weak_ptr<int>()) );
+  VERIFY( w.load().expired() );
+  p.reset();
+  VERIFY( e.expired() );
+}
+
+struct counted
+{
+  static std::atomic<int> live;
+  int val;
+  explicit counted(int v) : val(v) { ++live; }
+  ~counted() { --live; }
+};
+
+std::atomic<int> counted::live{0};
+
+// Readers and writers racing on one object must neither leak nor free
+// an object that is still in use.
+void
+test03()
+{
+  {
+    std::atomic<std::shared_ptr<counted>> a(std::make_shared<counted>(0));
+    std::thread t[4];
+    for (int n = 0; n < 4; ++n)
+      t[n] = std::thread([&a, n] {
+	for (int i = 0; i < 10000; ++i)
+	  {
+	    std::shared_ptr<counted> p = a.load();
+	    VERIFY( p && p->val >= 0 );
+	    if (i % 16 == n)
+	      a.store(std::make_shared<counted>(i));
+	  }
+      });
+    for (auto& th : t)
+      th.join();
+    VERIFY( counted::live == 1 );
+  }
+  VERIFY( counted::live == 0 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
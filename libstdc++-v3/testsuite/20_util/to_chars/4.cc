@@ -0,0 +1,145 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-options "-std=gnu++17" }
+// { dg-do run { target c++17 } }
+// { dg-require-string-conversions "" }
+
+// Floating-point std::to_chars.
+
+#include <charconv>
+#include <cfloat>
+#include <cmath>
+#include <string_view>
+#include <testsuite_hooks.h>
+
+template<typename T>
+std::string_view
+to_chars(char (&buf)[400], T val)
+{
+  std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), val);
+  VERIFY( r.ec == std::errc{} );
+  return std::string_view(buf, r.ptr - buf);
+}
+
+template<typename T>
+std::string_view
+to_chars(char (&buf)[400], T val, std::chars_format fmt)
+{
+  std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), val, fmt);
+  VERIFY( r.ec == std::errc{} );
+  return std::string_view(buf, r.ptr - buf);
+}
+
+template<typename T>
+std::string_view
+to_chars(char (&buf)[400], T val, std::chars_format fmt, int precision)
+{
+  std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), val, fmt,
+					 precision);
+  VERIFY( r.ec == std::errc{} );
+  return std::string_view(buf, r.ptr - buf);
+}
+
+void
+test01()
+{
+  // Shortest round trip, choosing the shorter of fixed and scientific.
+  char buf[400];
+  VERIFY( to_chars(buf, 0.0) == "0" );
+  VERIFY( to_chars(buf, -0.0) == "-0" );
+  VERIFY( to_chars(buf, 1.0) == "1" );
+  VERIFY( to_chars(buf, 0.1) == "0.1" );
+  VERIFY( to_chars(buf, 0.3) == "0.3" );
+  VERIFY( to_chars(buf, 1.0 / 3) == "0.3333333333333333" );
+  VERIFY( to_chars(buf, 123456.0) == "123456" );
+  VERIFY( to_chars(buf, 1e22) == "1e+22" );
+  VERIFY( to_chars(buf, 1e-7) == "1e-07" );
+  VERIFY( to_chars(buf, 5e-324) == "5e-324" );
+  VERIFY( to_chars(buf, DBL_MAX) == "1.7976931348623157e+308" );
+  VERIFY( to_chars(buf, DBL_MIN) == "2.2250738585072014e-308" );
+  VERIFY( to_chars(buf, 9007199254740993.0) == "9007199254740992" );
+  VERIFY( to_chars(buf, 0.1f) == "0.1" );
+  VERIFY( to_chars(buf, 16777216.0f) == "16777216" );
+  VERIFY( to_chars(buf, FLT_MAX) == "3.4028235e+38" );
+  VERIFY( to_chars(buf, -INFINITY) == "-inf" );
+  VERIFY( to_chars(buf, NAN) == "nan" );
+  VERIFY( to_chars(buf, 0.5L) == "0.5" );
+}
+
+void
+test02()
+{
+  // Shortest round trip in a given format.
+  using std::chars_format;
+  char buf[400];
+  VERIFY( to_chars(buf, 1.0, chars_format::scientific) == "1e+00" );
+  VERIFY( to_chars(buf, 1234.5, chars_format::scientific) == "1.2345e+03" );
+  VERIFY( to_chars(buf, 1e22, chars_format::fixed)
+	  == "10000000000000000000000" );
+  // Padding the digits "1" with zeros would not be the closest.
+  VERIFY( to_chars(buf, 1e23, chars_format::fixed)
+	  == "99999999999999991611392" );
+  VERIFY( to_chars(buf, 1.5e-5, chars_format::fixed) == "0.000015" );
+  VERIFY( to_chars(buf, 1920.0, chars_format::general) == "1920" );
+  VERIFY( to_chars(buf, 1234567.0, chars_format::general) == "1.234567e+06" );
+  VERIFY( to_chars(buf, 1e-5, chars_format::general) == "1e-05" );
+  VERIFY( to_chars(buf, 1.0, chars_format::hex) == "1p+0" );
+  VERIFY( to_chars(buf, 0.1, chars_format::hex) == "1.999999999999ap-4" );
+  VERIFY( to_chars(buf, 0.1f, chars_format::hex) == "1.99999ap-4" );
+  VERIFY( to_chars(buf, -0.0, chars_format::hex) == "-0p+0" );
+}
+
+void
+test03()
+{
+  // Given precision.
+  using std::chars_format;
+  char buf[400];
+  VERIFY( to_chars(buf, 0.1, chars_format::fixed, 3) == "0.100" );
+  VERIFY( to_chars(buf, 2.5, chars_format::fixed, 0) == "2" );
+  VERIFY( to_chars(buf, 0.1, chars_format::scientific, 20)
+	  == "1.00000000000000005551e-01" );
+  VERIFY( to_chars(buf, 1e10, chars_format::general, 3) == "1e+10" );
+  VERIFY( to_chars(buf, 1.0, chars_format::hex, 2) == "1.00p+0" );
+  VERIFY( to_chars(buf, -INFINITY, chars_format::fixed, 2) == "-inf" );
+}
+
+void
+test04()
+{
+  // Not enough room.
+  char buf[8];
+  std::to_chars_result r = std::to_chars(buf, buf + 3, 1.25);
+  VERIFY( r.ec == std::errc::value_too_large );
+  VERIFY( r.ptr == buf + 3 );
+  r = std::to_chars(buf, buf + 4, 1.25);
+  VERIFY( r.ec == std::errc{} );
+  VERIFY( r.ptr == buf + 4 );
+  r = std::to_chars(buf, buf + 2, 1e300, std::chars_format::fixed, 2);
+  VERIFY( r.ec == std::errc::value_too_large );
+  VERIFY( r.ptr == buf + 2 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+  test04();
+}
@@ -0,0 +1,71 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// 21.3.6.3-21.3.6.6 basic_string find_*_of with sets of several
+// characters, including characters with the top bit set.
+
+#include <string>
+#include <testsuite_hooks.h>
+
+void
+test01()
+{
+  typedef std::string::size_type csize_type;
+  const csize_type npos = std::string::npos;
+
+  const std::string hdr("Content-Type: text/html; charset=\xe9\xff\r\n");
+  const std::string sep(";:\r\n");
+  const std::string hi("\xff\xe9\x80");
+
+  VERIFY( hdr.find_first_of(sep) == 12 );
+  VERIFY( hdr.find_first_of(sep, 13) == 23 );
+  VERIFY( hdr.find_first_of(sep, 24) == 35 );
+  VERIFY( hdr.find_first_of(sep, 37) == npos );
+  VERIFY( hdr.find_first_of(hi) == 33 );
+  VERIFY( hdr.find_first_of(hi, 34) == 34 );
+
+  VERIFY( hdr.find_last_of(sep) == 36 );
+  VERIFY( hdr.find_last_of(sep, 34) == 23 );
+  VERIFY( hdr.find_last_of(sep, 11) == npos );
+  VERIFY( hdr.find_last_of(hi) == 34 );
+  VERIFY( hdr.find_last_of(hi, 33) == 33 );
+  VERIFY( hdr.find_last_of(hi, 32) == npos );
+
+  const std::string lower("abcdefghijklmnopqrstuvwxyz");
+  VERIFY( hdr.find_first_not_of(lower) == 0 );
+  VERIFY( hdr.find_first_not_of(lower, 1) == 7 );
+  VERIFY( hdr.find_first_not_of(lower + "-: ", 1) == 8 );
+  VERIFY( hdr.find_first_not_of(hdr) == npos );
+  VERIFY( hdr.find_first_not_of(hi, 33) == 35 );
+
+  VERIFY( hdr.find_last_not_of(sep) == 34 );
+  VERIFY( hdr.find_last_not_of(sep + hi) == 32 );
+  VERIFY( hdr.find_last_not_of(lower, 32) == 32 );
+  VERIFY( hdr.find_last_not_of(lower, 31) == 24 );
+  VERIFY( hdr.find_last_not_of(hdr) == npos );
+
+  // A single remaining character.
+  VERIFY( hdr.find_first_of(sep, hdr.size() - 1) == hdr.size() - 1 );
+  VERIFY( hdr.find_last_of(hi, 0) == npos );
+  VERIFY( hdr.find_last_not_of(hi, 0) == 0 );
+}
+
+int
+main()
+{
+  test01();
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// 22.2.2.1.1  num_get members
+
+#include <locale>
+#include <sstream>
+#include <limits>
+#include <testsuite_hooks.h>
+
+// Signs, rounding, underflow and overflow of floating-point extraction.
+template<typename T>
+  T
+  get(const char* s, std::ios_base::iostate& err)
+  {
+    typedef std::istreambuf_iterator<char> iterator_type;
+    std::istringstream ss(s);
+    const std::num_get<char>& ng
+      = std::use_facet<std::num_get<char> >(ss.getloc());
+    T v = T(1);
+    err = std::ios_base::goodbit;
+    ng.get(iterator_type(ss), iterator_type(), ss, err, v);
+    return v;
+  }
+
+void test01()
+{
+  using namespace std;
+  ios_base::iostate err;
+  double d;
+  float f;
+
+  d = get<double>("+1.5", err);
+  VERIFY( err == ios_base::eofbit );
+  VERIFY( d == 1.5 );
+
+  d = get<double>("-0.1e1", err);
+  VERIFY( err == ios_base::eofbit );
+  VERIFY( d == -1.0 );
+
+  d = get<double>("0.1", err);
+  VERIFY( err == ios_base::eofbit );
+  VERIFY( d == 0.1 );
+
+  d = get<double>("9007199254740993", err);
+  VERIFY( err == ios_base::eofbit );
+  VERIFY( d == 9007199254740992.0 );
+
+  d = get<double>("123456789012345678901234567890e-10", err);
+  VERIFY( err == ios_base::eofbit );
+  VERIFY( d == 12345678901234567890.1234567890 );
+
+  f = get<float>("3.4028235e38", err);
+  VERIFY( err == ios_base::eofbit );
+  VERIFY( f == numeric_limits<float>::max() );
+
+  // Out of range input still sets failbit, as required by DR 23.
+  d = get<double>("1e400", err);
+  VERIFY( err == (ios_base::failbit | ios_base::eofbit) );
+  VERIFY( d == numeric_limits<double>::max() );
+
+  d = get<double>("-1e400", err);
+  VERIFY( err == (ios_base::failbit | ios_base::eofbit) );
+  VERIFY( d == -numeric_limits<double>::max() );
+
+  f = get<float>("1e39", err);
+  VERIFY( err == (ios_base::failbit | ios_base::eofbit) );
+  VERIFY( f == numeric_limits<float>::max() );
+
+  // Underflow is not an error.
+  d = get<double>("1e-400", err);
+  VERIFY( !(err & ios_base::failbit) );
+  VERIFY( d == 0.0 );
+
+  d = get<double>("1e", err);
+  VERIFY( err == (ios_base::failbit | ios_base::eofbit) );
+  VERIFY( d == 0.0 );
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
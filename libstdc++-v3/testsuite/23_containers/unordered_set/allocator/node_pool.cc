@@ -0,0 +1,96 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+// { dg-options "-D_GLIBCXX_HASHTABLE_NODE_POOL=4" }
+
+#include <unordered_set>
+#include <testsuite_hooks.h>
+#include <testsuite_allocator.h>
+
+struct T { int i; };
+
+struct hash
+{
+  std::size_t operator()(const T t) const noexcept
+  { return t.i; }
+};
+
+struct equal_to
+{
+  bool operator()(const T& lhs, const T& rhs) const noexcept
+  { return lhs.i == rhs.i; }
+};
+
+using __gnu_test::propagating_allocator;
+
+typedef propagating_allocator<T, true> alloc_type;
+typedef std::unordered_set<T, hash, equal_to, alloc_type> test_type;
+
+// Leave some free nodes behind in V.
+void
+churn(test_type& v)
+{
+  for (int i = 0; i < 10; ++i)
+    v.insert(T{i});
+  for (int i = 0; i < 10; i += 2)
+    v.erase(T{i});
+  VERIFY( v.size() == 5 );
+}
+
+// Freed nodes must only be handed back to the allocator that allocated
+// them, which uneq_allocator::deallocate checks.
+void
+test01()
+{
+  test_type v1(alloc_type(1));
+  churn(v1);
+  test_type v2(alloc_type(2));
+  churn(v2);
+  std::swap(v1, v2);
+  churn(v1);
+  churn(v2);
+  VERIFY( 2 == v1.get_allocator().get_personality() );
+  VERIFY( 1 == v2.get_allocator().get_personality() );
+}
+
+void
+test02()
+{
+  test_type v1(alloc_type(1));
+  churn(v1);
+  test_type v2(alloc_type(2));
+  churn(v2);
+  v1 = std::move(v2);
+  VERIFY( 2 == v1.get_allocator().get_personality() );
+  churn(v1);
+  test_type v3(alloc_type(3));
+  churn(v3);
+  v3 = v1;
+  VERIFY( 2 == v3.get_allocator().get_personality() );
+  churn(v3);
+  test_type v4(std::move(v3));
+  churn(v4);
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  return 0;
+}
@@ -0,0 +1,115 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Copies between deques and other ranges, crossing node boundaries.
+
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <vector>
+#include <testsuite_hooks.h>
+
+void test01()
+{
+  using namespace std;
+
+  deque<int> data(1000);
+  for (unsigned i = 0; i < data.size(); ++i)
+    data[i] = i;
+
+  for (unsigned i = 0; i < data.size(); i += 97)
+    for (unsigned j = i; j <= data.size(); j += 131)
+      {
+	// deque to vector
+	vector<int> v(j - i + 2, -1);
+	VERIFY( copy(data.begin() + i, data.begin() + j, v.begin() + 1)
+		== v.begin() + 1 + (j - i) );
+	VERIFY( equal(data.begin() + i, data.begin() + j, v.begin() + 1) );
+	VERIFY( v.front() == -1 && v.back() == -1 );
+
+	// vector to deque
+	deque<int> d(data.size(), -1);
+	VERIFY( copy(v.begin() + 1, v.end() - 1, d.begin() + i)
+		== d.begin() + j );
+	VERIFY( equal(data.begin() + i, data.begin() + j, d.begin() + i) );
+	VERIFY( count(d.begin(), d.end(), -1) == long(d.size() - (j - i)) );
+
+	// deque<int> to deque<long>
+	deque<long> dl(data.size(), -1);
+	copy(data.begin() + i, data.begin() + j, dl.begin() + (1000 - j));
+	VERIFY( equal(data.begin() + i, data.begin() + j,
+		      dl.begin() + (1000 - j)) );
+
+	// list to deque
+	list<int> l(data.begin() + i, data.begin() + j);
+	deque<int> d2(j - i);
+	VERIFY( copy(l.begin(), l.end(), d2.begin()) == d2.end() );
+	VERIFY( equal(d2.begin(), d2.end(), data.begin() + i) );
+      }
+}
+
+void test02()
+{
+  using namespace std;
+
+  deque<int> data(1000);
+  for (unsigned i = 0; i < data.size(); ++i)
+    data[i] = i;
+
+  const deque<int>& cdata = data;
+  for (unsigned i = 0; i < data.size(); i += 37)
+    {
+      VERIFY( find(data.begin(), data.end(), int(i)) == data.begin() + i );
+      VERIFY( find(cdata.begin(), cdata.end(), int(i)) == cdata.begin() + i );
+      VERIFY( find(data.begin() + i + 1, data.end(), int(i)) == data.end() );
+      VERIFY( find(data.begin(), data.begin() + i, int(i))
+	      == data.begin() + i );
+    }
+  VERIFY( find(data.begin(), data.end(), -1) == data.end() );
+}
+
+#if __cplusplus >= 201103L
+#include <memory>
+
+void test03()
+{
+  using namespace std;
+
+  deque<unique_ptr<int>> d(700);
+  for (unsigned i = 0; i < d.size(); ++i)
+    d[i].reset(new int(i));
+
+  vector<unique_ptr<int>> v(d.size());
+  move(d.begin(), d.end(), v.begin());
+  for (unsigned i = 0; i < v.size(); ++i)
+    VERIFY( *v[i] == int(i) && !d[i] );
+
+  move(v.begin(), v.end(), d.begin());
+  for (unsigned i = 0; i < d.size(); ++i)
+    VERIFY( *d[i] == int(i) && !v[i] );
+}
+#endif
+
+int main()
+{
+  test01();
+  test02();
+#if __cplusplus >= 201103L
+  test03();
+#endif
+  return 0;
+}
@@ -0,0 +1,81 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+// Check count on contiguous ranges of arithmetic types, for which it uses
+// vectorized code.
+
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <testsuite_hooks.h>
+
+template<typename T>
+void
+test01()
+{
+  for (int n = 0; n < 2000; n += 1 + n / 4)
+    {
+      std::vector<T> v(n);
+      long expected = 0;
+      for (int i = 0; i < n; ++i)
+	{
+	  v[i] = T(i % 7 == 3 ? 2 : i % 5);
+	  if (v[i] == T(2))
+	    ++expected;
+	}
+      VERIFY( std::count(v.begin(), v.end(), T(2)) == expected );
+      const T* p = v.data();
+      VERIFY( std::count(p, p + n, T(2)) == expected );
+    }
+}
+
+// More equal elements than fit in an 8-bit counter.
+void
+test02()
+{
+  std::vector<unsigned char> v(100000, 7);
+  VERIFY( std::count(v.begin(), v.end(), 7) == 100000 );
+  VERIFY( std::count(v.begin(), v.end(), 7 + 256) == 0 );
+  std::vector<signed char> w(5000, -1);
+  VERIFY( std::count(w.begin(), w.end(), -1) == 5000 );
+}
+
+void
+test03()
+{
+  std::vector<double> d(100, 1.0);
+  d[5] = NAN;
+  VERIFY( std::count(d.begin(), d.end(), NAN) == 0 );
+  VERIFY( std::count(d.begin(), d.end(), 1.0) == 99 );
+}
+
+int
+main()
+{
+  test01<char>();
+  test01<unsigned char>();
+  test01<short>();
+  test01<int>();
+  test01<unsigned long>();
+  test01<long long>();
+  test01<float>();
+  test01<double>();
+  test02();
+  test03();
+}
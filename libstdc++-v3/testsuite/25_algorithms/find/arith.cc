@@ -0,0 +1,97 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+// Check find on contiguous ranges of arithmetic types, for which it uses
+// vectorized code.
+
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <testsuite_hooks.h>
+
+template<typename T>
+void
+test01()
+{
+  for (int n = 0; n < 300; n += 1 + n / 8)
+    for (int pos = 0; pos <= n; ++pos)
+      {
+	std::vector<T> v(n, T(1));
+	if (pos < n)
+	  {
+	    v[pos] = T(2);
+	    if (pos + 1 < n)
+	      v[n - 1] = T(2);
+	  }
+	VERIFY( std::find(v.begin(), v.end(), T(2)) - v.begin() == pos );
+	const T* p = v.data();
+	VERIFY( std::find(p, p + n, T(2)) - p == pos );
+	VERIFY( std::find(v.begin(), v.end(), T(3)) == v.end() );
+      }
+}
+
+// Values of a different type are compared after the usual conversions.
+void
+test02()
+{
+  std::vector<unsigned char> uc(200, 5);
+  uc[150] = 255;
+  VERIFY( std::find(uc.begin(), uc.end(), -1) == uc.end() );
+  VERIFY( std::find(uc.begin(), uc.end(), 255) - uc.begin() == 150 );
+  VERIFY( std::find(uc.begin(), uc.end(), 255 + 5) == uc.end() );
+
+  std::vector<short> s(300, 1);
+  s[280] = -2;
+  VERIFY( std::find(s.begin(), s.end(), -2) - s.begin() == 280 );
+  VERIFY( std::find(s.begin(), s.end(), 65534) == s.end() );
+
+  std::vector<unsigned> u(100, 5);
+  u[70] = ~0u;
+  VERIFY( std::find(u.begin(), u.end(), -1) - u.begin() == 70 );
+
+  std::vector<long long> ll(100, 5);
+  ll[60] = -1;
+  VERIFY( std::find(ll.begin(), ll.end(), -1) - ll.begin() == 60 );
+}
+
+void
+test03()
+{
+  std::vector<double> d(100, 1.0);
+  d[5] = NAN;
+  d[40] = -0.0;
+  VERIFY( std::find(d.begin(), d.end(), NAN) == d.end() );
+  VERIFY( std::find(d.begin(), d.end(), 0.0) - d.begin() == 40 );
+}
+
+int
+main()
+{
+  test01<char>();
+  test01<unsigned char>();
+  test01<short>();
+  test01<int>();
+  test01<unsigned long>();
+  test01<long long>();
+  test01<float>();
+  test01<double>();
+  test01<char32_t>();
+  test02();
+  test03();
+}
@@ -0,0 +1,73 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+// Check min_element and max_element on contiguous ranges of integers, for
+// which they use vectorized code.
+
+#include <algorithm>
+#include <vector>
+#include <testsuite_hooks.h>
+
+template<typename T>
+void
+test01()
+{
+  unsigned x = 1;
+  for (int n = 1; n < 500; n += 1 + n / 8)
+    for (int k = 0; k < 10; ++k)
+      {
+	std::vector<T> v(n);
+	for (auto& e : v)
+	  {
+	    x = x * 1103515245 + 12345;
+	    e = T(x >> 16) % T(k + 2);
+	  }
+	int min = 0, max = 0;
+	for (int i = 1; i < n; ++i)
+	  {
+	    if (v[i] < v[min])
+	      min = i;
+	    if (v[max] < v[i])
+	      max = i;
+	  }
+	VERIFY( std::min_element(v.begin(), v.end()) - v.begin() == min );
+	VERIFY( std::max_element(v.begin(), v.end()) - v.begin() == max );
+	const T* p = v.data();
+	VERIFY( std::min_element(p, p + n) - p == min );
+	VERIFY( std::max_element(p, p + n) - p == max );
+      }
+
+  std::vector<T> e;
+  VERIFY( std::min_element(e.begin(), e.end()) == e.end() );
+  VERIFY( std::max_element(e.begin(), e.end()) == e.end() );
+}
+
+int
+main()
+{
+  test01<char>();
+  test01<signed char>();
+  test01<unsigned char>();
+  test01<short>();
+  test01<unsigned short>();
+  test01<int>();
+  test01<unsigned>();
+  test01<long>();
+  test01<unsigned long long>();
+}
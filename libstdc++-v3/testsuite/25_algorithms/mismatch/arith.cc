@@ -0,0 +1,74 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+// Check mismatch and equal on contiguous ranges of arithmetic types, for
+// which they use vectorized code.
+
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <testsuite_hooks.h>
+
+template<typename T>
+void
+test01()
+{
+  for (int n = 0; n < 300; n += 1 + n / 8)
+    for (int pos = 0; pos <= n; ++pos)
+      {
+	std::vector<T> v(n, T(1)), w(v);
+	if (pos < n)
+	  w[pos] = T(2);
+	auto r = std::mismatch(v.begin(), v.end(), w.begin());
+	VERIFY( r.first - v.begin() == pos );
+	VERIFY( r.second - w.begin() == pos );
+	const T* p = v.data();
+	VERIFY( std::mismatch(p, p + n, w.data()).first - p == pos );
+	VERIFY( std::equal(v.begin(), v.end(), w.begin()) == (pos == n) );
+#if __cplusplus > 201103L
+	int m = n / 2;
+	r = std::mismatch(v.begin(), v.end(), w.begin(), w.begin() + m);
+	VERIFY( r.first - v.begin() == std::min(pos, m) );
+#endif
+      }
+}
+
+void
+test02()
+{
+  std::vector<double> d(100, 0.0), d2(100, -0.0);
+  VERIFY( std::equal(d.begin(), d.end(), d2.begin()) );
+  d[60] = NAN;
+  d2[60] = NAN;
+  VERIFY( !std::equal(d.begin(), d.end(), d2.begin()) );
+  VERIFY( std::mismatch(d.begin(), d.end(), d2.begin()).first - d.begin()
+	  == 60 );
+}
+
+int
+main()
+{
+  test01<char>();
+  test01<short>();
+  test01<int>();
+  test01<unsigned long>();
+  test01<float>();
+  test01<double>();
+  test02();
+}
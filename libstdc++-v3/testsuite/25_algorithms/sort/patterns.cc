@@ -0,0 +1,100 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+// Check std::sort on inputs that exercise the pattern detection and the
+// block partitioning of the implementation.
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+#include <testsuite_hooks.h>
+
+template<typename T, typename Compare>
+void
+check(std::vector<T> v, Compare comp)
+{
+  std::vector<T> expected(v);
+  std::stable_sort(expected.begin(), expected.end(), comp);
+  std::sort(v.begin(), v.end(), comp);
+  for (std::size_t i = 0; i < v.size(); ++i)
+    VERIFY( !comp(v[i], expected[i]) && !comp(expected[i], v[i]) );
+}
+
+template<typename T>
+void
+check(const std::vector<T>& v)
+{
+  check(v, std::less<T>());
+  check(v, std::greater<T>());
+
+  // Also use a comparison that sort cannot recognise as operator<.
+  check(v, [](const T& x, const T& y) { return x < y; });
+}
+
+template<typename T, typename Gen>
+void
+test_patterns(int n, Gen gen)
+{
+  std::vector<T> v(n);
+
+  // random
+  for (auto& x : v)
+    x = gen();
+  check(v);
+
+  // sorted, reversed, and sorted with a few elements out of place
+  std::sort(v.begin(), v.end());
+  check(v);
+  std::reverse(v.begin(), v.end());
+  check(v);
+  std::reverse(v.begin(), v.end());
+  if (n > 4)
+    {
+      std::swap(v[1], v[n - 2]);
+      std::swap(v[n / 2], v[n / 2 + 1]);
+    }
+  check(v);
+
+  // organ pipe and sawtooth
+  std::vector<T> w(v);
+  for (int i = 0; i < n; ++i)
+    v[i] = w[i < n / 2 ? i : n - 1 - i];
+  check(v);
+  for (int i = 0; i < n; ++i)
+    v[i] = w[i % 64];
+  check(v);
+}
+
+int
+main()
+{
+  std::mt19937 rng;
+  for (int n : { 0, 1, 2, 15, 16, 17, 100, 128, 129, 1000, 5000, 100000 })
+    for (unsigned range : { 1u, 2u, 10u, 1000u, 1u << 30 })
+      {
+	test_patterns<int>(n, [&] { return int(rng() % range); });
+	test_patterns<unsigned char>(n, [&] { return rng() % range; });
+	test_patterns<double>(n, [&] { return (rng() % range) * 0.25; });
+	test_patterns<std::pair<int, int>>(n, [&] {
+	  return std::make_pair(int(rng() % range), int(rng() % 3));
+	});
+      }
+}
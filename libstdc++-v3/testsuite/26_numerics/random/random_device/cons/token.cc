@@ -50,7 +50,7 @@ test03()
 {
   // At least one of these tokens should be valid.
   const std::string tokens[] = {
-    "rdseed", "rdrand", "rand_s", "/dev/urandom", "/dev/random", "mt19937"
+    "getrandom", "rdseed", "rdrand", "rand_s", "/dev/urandom", "/dev/random", "mt19937"
   };
   int count = 0;
   for (const std::string& token : tokens)
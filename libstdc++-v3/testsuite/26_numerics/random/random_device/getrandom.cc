@@ -0,0 +1,109 @@
+// { dg-do run { target *-*-linux* } }
+// { dg-options "-pthread" }
+// { dg-require-effective-target c++11 }
+// { dg-require-effective-target pthread }
+// { dg-require-fork "" }
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// The "getrandom" token hands out values from a per-thread buffer.
+
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <testsuite_hooks.h>
+
+typedef std::random_device::result_type result_type;
+
+std::set<result_type>
+draw(std::random_device& rd, int n)
+{
+  std::set<result_type> s;
+  for (int i = 0; i < n; ++i)
+    s.insert(rd());
+  return s;
+}
+
+// Values must not repeat when the buffer is refilled.
+void
+test01(std::random_device& rd)
+{
+  VERIFY( draw(rd, 1000).size() > 990 );
+  VERIFY( rd.entropy() > 0.0 );
+}
+
+// Each thread has its own buffer.
+void
+test02(std::random_device& rd)
+{
+  std::set<result_type> s1, s2;
+  std::thread t1([&] { s1 = draw(rd, 100); });
+  std::thread t2([&] { s2 = draw(rd, 100); });
+  t1.join();
+  t2.join();
+  int common = 0;
+  for (result_type v : s1)
+    common += s2.count(v);
+  VERIFY( common < 2 );
+}
+
+// The child of fork must not return the values buffered by the parent.
+void
+test03(std::random_device& rd)
+{
+  rd();
+  int fds[2];
+  VERIFY( ::pipe(fds) == 0 );
+  pid_t pid = ::fork();
+  VERIFY( pid != -1 );
+  if (pid == 0)
+    {
+      result_type v[4] = { rd(), rd(), rd(), rd() };
+      ::_exit(::write(fds[1], v, sizeof(v)) == sizeof(v) ? 0 : 1);
+    }
+  result_type c[4], p[4] = { rd(), rd(), rd(), rd() };
+  VERIFY( ::read(fds[0], c, sizeof(c)) == sizeof(c) );
+  int status;
+  VERIFY( ::waitpid(pid, &status, 0) == pid );
+  VERIFY( WIFEXITED(status) && WEXITSTATUS(status) == 0 );
+  int same = 0;
+  for (int i = 0; i < 4; ++i)
+    same += c[i] == p[i];
+  VERIFY( same < 2 );
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+int
+main()
+{
+  try
+  {
+    std::random_device rd("getrandom");
+    test01(rd);
+    test02(rd);
+    test03(rd);
+  }
+  catch (const std::runtime_error&)
+  {
+    // getrandom is not supported on this system.
+  }
+}
@@ -23,6 +23,8 @@
 
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <string>
 #include <testsuite_fs.h>
 #include <testsuite_hooks.h>
 
@@ -77,8 +79,38 @@ test01()
   remove(to);
 }
 
+void
+test02()
+{
+  using std::filesystem::copy_options;
+
+  auto from = __gnu_test::nonexistent_path();
+  auto to = __gnu_test::nonexistent_path();
+
+  // test a file large enough to need several kernel copies, and
+  // overwriting a longer file
+  std::string s;
+  for (int i = 0; i < (1 << 22); ++i)
+    s += char(i * 7 + i / 13);
+  std::ofstream{from, std::ios::binary} << s;
+  std::ofstream{to, std::ios::binary} << s << s;
+
+  bool b = copy_file(from, to, copy_options::overwrite_existing);
+  VERIFY( b );
+  VERIFY( file_size(to) == s.size() );
+  std::ifstream in{to, std::ios::binary};
+  std::string t{std::istreambuf_iterator<char>(in),
+		std::istreambuf_iterator<char>()};
+  VERIFY( t == s );
+  in.close();
+
+  remove(from);
+  remove(to);
+}
+
 int
 main()
 {
   test01();
+  test02();
 }
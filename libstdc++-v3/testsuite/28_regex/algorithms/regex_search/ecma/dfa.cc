@@ -0,0 +1,103 @@
+// { dg-do run { target c++11 } }
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// 28.11.3 regex_search
+// Tests that the DFA used when no match_results are requested agrees
+// with the executors.
+
+#include <regex>
+#include <testsuite_hooks.h>
+
+using namespace std;
+
+// Whether the BFS executor finds a match.
+template<bool __match_mode>
+  bool
+  executor_finds(const string& s, const regex& re,
+		 regex_constants::match_flag_type f)
+  {
+    smatch m;
+    return __detail::__regex_algo_impl<string::const_iterator,
+				       smatch::allocator_type,
+				       char, regex_traits<char>,
+				       __detail::_RegexExecutorPolicy::_S_alternate,
+				       __match_mode>
+      (s.begin(), s.end(), m, re, f);
+  }
+
+const char* patterns[] =
+{
+  "", "a", "ab|b", "a*b+", "(a|b)*abb", "^a", "b$", "^(ab)*$", "$^",
+  "(a*)*", "a?b?a?", "[^a]{2,3}", ".b.", "(a|ab)(c|bcd)?", "a{2}|b{3}",
+};
+
+const regex_constants::match_flag_type flags[] =
+{
+  regex_constants::match_default,
+  regex_constants::match_not_bol,
+  regex_constants::match_not_eol,
+  regex_constants::match_continuous,
+  regex_constants::match_prev_avail,
+};
+
+void
+test01()
+{
+  for (auto __p : patterns)
+    for (auto __g : { regex_constants::ECMAScript, regex_constants::extended })
+      {
+	regex re(__p, __g);
+	// All strings over "ab" shorter than 7 characters.
+	for (unsigned len = 0; len < 7; ++len)
+	  for (unsigned bits = 0; bits < (1u << len); ++bits)
+	    {
+	      string s;
+	      for (unsigned i = 0; i < len; ++i)
+		s += (bits & (1u << i)) ? 'b' : 'a';
+	      for (auto f : flags)
+		{
+		  VERIFY( regex_search(s, re, f)
+			  == executor_finds<false>(s, re, f) );
+		  VERIFY( regex_match(s, re, f)
+			  == executor_finds<true>(s, re, f) );
+		}
+	    }
+      }
+}
+
+void
+test02()
+{
+  // Backreferences and word boundaries are left to the executors.
+  VERIFY( regex_search("xabab", regex("(ab)\\1")) );
+  VERIFY( !regex_search("xabba", regex("(ab)\\1")) );
+  VERIFY( regex_search("a b", regex("\\bb")) );
+  VERIFY( !regex_search("ab", regex("\\bb")) );
+  VERIFY( regex_search("ab", regex("a(?=b)")) );
+  VERIFY( !regex_search("", regex(""), regex_constants::match_not_null) );
+  VERIFY( regex_match("HeLLo", regex("hello", regex_constants::icase)) );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  return 0;
+}
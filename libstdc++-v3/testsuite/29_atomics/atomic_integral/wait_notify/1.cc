@@ -0,0 +1,88 @@
+// { dg-options "-std=gnu++2a -pthread" }
+// { dg-do run { target c++2a } }
+// { dg-require-effective-target pthread }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <thread>
+#include <testsuite_hooks.h>
+
+template<typename T>
+  void
+  test(T a, T b)
+  {
+    std::atomic<T> x(a);
+    std::thread t([&] {
+      x.wait(a);
+      VERIFY( x.load() == b );
+      x.store(a);
+      x.notify_one();
+    });
+    x.store(b);
+    x.notify_one();
+    x.wait(b);
+    t.join();
+    VERIFY( x.load() == a );
+  }
+
+void
+test01()
+{
+  test<char>('a', 'b');
+  test<short>(1, 2);
+  test<int>(1, 2);
+  test<unsigned>(1, 2);
+  test<long>(1, 2);
+  test<long long>(1, 2);
+}
+
+void
+test02()
+{
+  // Many waiters on one object are all woken by notify_all.
+  std::atomic<int> x(0);
+  std::atomic<int> woken(0);
+  std::thread t[8];
+  for (auto& th : t)
+    th = std::thread([&] { x.wait(0); ++woken; });
+  x.store(1);
+  x.notify_all();
+  for (auto& th : t)
+    th.join();
+  VERIFY( woken == 8 );
+}
+
+void
+test03()
+{
+  std::atomic_flag f = ATOMIC_FLAG_INIT;
+  std::thread t([&] { f.wait(false); });
+  f.test_and_set();
+  f.notify_all();
+  t.join();
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
@@ -0,0 +1,98 @@
+// { dg-options "-std=gnu++2a -pthread" }
+// { dg-do run { target c++2a } }
+// { dg-require-effective-target pthread }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <barrier>
+#include <atomic>
+#include <thread>
+#include <testsuite_hooks.h>
+
+#ifndef __cpp_lib_barrier
+# error "Feature-test macro for barrier missing in <barrier>"
+#endif
+
+void
+test01()
+{
+  const int n = 8, phases = 1000;
+  int completions = 0;
+  std::atomic<int> done(0);
+  std::barrier b(n, [&]() noexcept {
+    // Every thread has arrived, and none has started the next phase.
+    VERIFY( done == (completions + 1) * n );
+    ++completions;
+  });
+  std::thread t[n];
+  for (auto& th : t)
+    th = std::thread([&] {
+      for (int i = 0; i < phases; ++i)
+	{
+	  ++done;
+	  b.arrive_and_wait();
+	}
+    });
+  for (auto& th : t)
+    th.join();
+  VERIFY( completions == phases );
+}
+
+void
+test02()
+{
+  // Threads that drop out reduce the count for the following phases.
+  const int n = 4;
+  int completions = 0;
+  std::barrier b(n, [&]() noexcept { ++completions; });
+  std::thread t[n];
+  for (int j = 0; j < n; ++j)
+    t[j] = std::thread([&, j] {
+      for (int i = 0; i < 100; ++i)
+	{
+	  if (i == 10 * j + 10)
+	    {
+	      b.arrive_and_drop();
+	      return;
+	    }
+	  b.arrive_and_wait();
+	}
+    });
+  for (auto& th : t)
+    th.join();
+  VERIFY( completions == 41 );
+}
+
+void
+test03()
+{
+  std::barrier b(2);
+  auto tok = b.arrive();
+  std::thread t([&] { b.arrive_and_wait(); });
+  b.wait(std::move(tok));
+  t.join();
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
@@ -0,0 +1,79 @@
+// { dg-options "-std=gnu++2a -pthread" }
+// { dg-do run { target c++2a } }
+// { dg-require-effective-target pthread }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <latch>
+#include <atomic>
+#include <thread>
+#include <testsuite_hooks.h>
+
+#ifndef __cpp_lib_latch
+# error "Feature-test macro for latch missing in <latch>"
+#endif
+
+void
+test01()
+{
+  static_assert(std::latch::max() > 0);
+
+  std::latch l(0);
+  VERIFY( l.try_wait() );
+  l.wait();
+}
+
+void
+test02()
+{
+  const int n = 8;
+  std::latch l(n);
+  std::atomic<int> arrived(0);
+  std::thread t[n];
+  for (auto& th : t)
+    th = std::thread([&] {
+      ++arrived;
+      l.arrive_and_wait();
+      VERIFY( arrived == n );
+    });
+  for (auto& th : t)
+    th.join();
+  VERIFY( l.try_wait() );
+}
+
+void
+test03()
+{
+  std::latch l(3);
+  VERIFY( !l.try_wait() );
+  l.count_down(2);
+  VERIFY( !l.try_wait() );
+  std::thread t([&] { l.wait(); });
+  l.count_down();
+  t.join();
+  VERIFY( l.try_wait() );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
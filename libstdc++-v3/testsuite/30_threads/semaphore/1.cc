@@ -0,0 +1,93 @@
+// { dg-options "-std=gnu++2a -pthread" }
+// { dg-do run { target c++2a } }
+// { dg-require-effective-target pthread }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <semaphore>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <testsuite_hooks.h>
+
+#ifndef __cpp_lib_semaphore
+# error "Feature-test macro for semaphore missing in <semaphore>"
+#endif
+
+void
+test01()
+{
+  static_assert(std::binary_semaphore::max() >= 1);
+  static_assert(std::counting_semaphore<(1LL << 40)>::max() >= (1LL << 40));
+
+  std::counting_semaphore<10> s(2);
+  VERIFY( s.try_acquire() );
+  VERIFY( s.try_acquire() );
+  VERIFY( !s.try_acquire() );
+  s.release(2);
+  s.acquire();
+  s.acquire();
+  VERIFY( !s.try_acquire() );
+}
+
+void
+test02()
+{
+  const int n = 8, m = 10000;
+  std::counting_semaphore<> s(0);
+  std::atomic<int> acquired(0);
+  std::thread t[n];
+  for (auto& th : t)
+    th = std::thread([&] {
+      for (int i = 0; i < m; ++i)
+	{
+	  s.acquire();
+	  ++acquired;
+	}
+    });
+  for (int i = 0; i < n * m; ++i)
+    s.release();
+  for (auto& th : t)
+    th.join();
+  VERIFY( acquired == n * m );
+  VERIFY( !s.try_acquire() );
+}
+
+void
+test03()
+{
+  using namespace std::chrono;
+  std::binary_semaphore s(0);
+  auto start = steady_clock::now();
+  VERIFY( !s.try_acquire_for(milliseconds(10)) );
+  VERIFY( steady_clock::now() - start >= milliseconds(10) );
+  VERIFY( !s.try_acquire_until(system_clock::now() + milliseconds(10)) );
+
+  std::thread t([&] { s.release(); });
+  VERIFY( s.try_acquire_for(seconds(100)) );
+  t.join();
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
@@ -0,0 +1,220 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+#include <ext/btree_map>
+#include <map>
+#include <string>
+#include <stdexcept>
+#include <testsuite_hooks.h>
+
+typedef __gnu_cxx::btree_map<int, int> map_type;
+
+void
+test01()
+{
+  map_type m;
+  VERIFY( m.empty() );
+  VERIFY( m.begin() == m.end() );
+  VERIFY( m.find(1) == m.end() );
+
+  for (int i = 0; i < 10000; ++i)
+    VERIFY( m.insert(std::make_pair(i, i * 2)).second );
+  VERIFY( m.size() == 10000 );
+  VERIFY( !m.insert(std::make_pair(5, 0)).second );
+  VERIFY( m[5] == 10 );
+
+  for (int i = 0; i < 10000; i += 2)
+    VERIFY( m.erase(i) == 1 );
+  VERIFY( m.erase(0) == 0 );
+  VERIFY( m.size() == 5000 );
+  for (int i = 0; i < 10000; ++i)
+    VERIFY( m.count(i) == (i & 1) );
+
+  int prev = -1;
+  for (map_type::const_iterator it = m.cbegin(); it != m.cend(); ++it)
+    {
+      VERIFY( it->first == prev + 2 );
+      prev = it->first;
+    }
+  for (map_type::const_reverse_iterator it = m.crbegin(); it != m.crend();
+       ++it)
+    {
+      VERIFY( it->first == prev );
+      prev -= 2;
+    }
+  VERIFY( prev == -1 );
+
+  for (map_type::iterator it = m.begin(); it != m.end(); )
+    if (it->first % 3 == 0)
+      it = m.erase(it);
+    else
+      ++it;
+  for (int i = 0; i < 10000; ++i)
+    VERIFY( m.contains(i) == ((i & 1) && i % 3 != 0) );
+
+  VERIFY( m.lower_bound(3)->first == 5 );
+  VERIFY( m.upper_bound(5)->first == 7 );
+  VERIFY( m.lower_bound(9998) == m.end() );
+  VERIFY( m.equal_range(6).first == m.equal_range(6).second );
+  VERIFY( m.equal_range(7).first->first == 7 );
+
+  m.clear();
+  VERIFY( m.empty() );
+  VERIFY( m.begin() == m.end() );
+}
+
+// Compare random insertions and erasures with std::map.
+void
+test02()
+{
+  map_type m;
+  std::map<int, int> ref;
+  unsigned long x = 1;
+  for (int i = 0; i < 200000; ++i)
+    {
+      x = x * 6364136223846793005UL + 1442695040888963407UL;
+      const int k = (x >> 33) % 5000;
+      switch ((x >> 20) % 4)
+	{
+	case 0:
+	case 1:
+	  VERIFY( m.emplace(k, i).second == ref.emplace(k, i).second );
+	  break;
+	case 2:
+	  VERIFY( m.erase(k) == ref.erase(k) );
+	  break;
+	default:
+	  {
+	    // Erase a range and check the returned iterator.
+	    auto first = m.lower_bound(k), last = m.lower_bound(k + 20);
+	    auto it = m.erase(first, last);
+	    auto rit = ref.erase(ref.lower_bound(k), ref.lower_bound(k + 20));
+	    VERIFY( (it == m.end()) == (rit == ref.end()) );
+	    if (rit != ref.end())
+	      VERIFY( it->first == rit->first );
+	  }
+	}
+      VERIFY( m.size() == ref.size() );
+    }
+  auto it = m.begin();
+  for (auto& e : ref)
+    {
+      VERIFY( it->first == e.first && it->second == e.second );
+      ++it;
+    }
+  VERIFY( it == m.end() );
+}
+
+// Descending and hinted insertions.
+void
+test03()
+{
+  map_type m;
+  for (int i = 10000; i > 0; --i)
+    m.emplace_hint(m.begin(), i, i);
+  for (int i = 10001; i < 20000; ++i)
+    m.emplace_hint(m.end(), i, i);
+  m.insert(m.find(5000), std::make_pair(0, 0));
+  VERIFY( m.size() == 20000 );
+  int n = 0;
+  for (auto& e : m)
+    VERIFY( e.first == n++ );
+  VERIFY( m.at(19999) == 19999 );
+  bool caught = false;
+  try
+    {
+      m.at(20000);
+    }
+  catch (const std::out_of_range&)
+    {
+      caught = true;
+    }
+  VERIFY( caught );
+}
+
+struct string_less
+{
+  typedef void is_transparent;
+  bool operator()(const std::string& a, const std::string& b) const
+  { return a < b; }
+  bool operator()(const char* a, const std::string& b) const
+  { return b.compare(a) > 0; }
+  bool operator()(const std::string& a, const char* b) const
+  { return a.compare(b) < 0; }
+};
+
+// Heterogeneous lookup, and elements that are not trivially copyable.
+void
+test04()
+{
+  __gnu_cxx::btree_map<std::string, std::string, string_less> m;
+  for (int i = 0; i < 1000; ++i)
+    m.try_emplace(std::to_string(i), std::to_string(i * i));
+  VERIFY( m.find("12") != m.end() );
+  VERIFY( m.find("12")->second == "144" );
+  VERIFY( m.count("1000") == 0 );
+  VERIFY( m.contains("999") );
+  VERIFY( m.equal_range("7").first->second == "49" );
+  VERIFY( m.lower_bound("99")->first == "99" );
+
+  std::string key = "7";
+  VERIFY( !m.try_emplace(std::move(key), "x").second );
+  VERIFY( !key.empty() );
+  VERIFY( !m.insert_or_assign("7", std::string("y")).second );
+  VERIFY( m.at("7") == "y" );
+
+  decltype(m) m2 = m;
+  VERIFY( m2 == m );
+  m2.erase("7");
+  VERIFY( m2 != m );
+  VERIFY( m2 > m );
+  decltype(m) m3 = std::move(m2);
+  VERIFY( m2.empty() );
+  VERIFY( m3.size() == 999 );
+  swap(m3, m2);
+  VERIFY( m3.empty() );
+  VERIFY( m2.size() == 999 );
+  m3 = m2;
+  VERIFY( m3 == m2 );
+  while (!m3.empty())
+    m3.erase(--m3.end());
+  VERIFY( m3.begin() == m3.end() );
+}
+
+void
+test05()
+{
+  map_type m = { { 3, 4 }, { 1, 2 }, { 1, 5 } };
+  VERIFY( m.size() == 2 );
+  VERIFY( m.begin()->first == 1 && m.begin()->second == 2 );
+  VERIFY( m.value_comp()(*m.begin(), *std::next(m.begin())) );
+  static_assert( std::is_same<std::iterator_traits<map_type::iterator>
+			      ::iterator_category,
+			      std::bidirectional_iterator_tag>::value, "" );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+  test04();
+  test05();
+}
@@ -0,0 +1,88 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+#include <ext/btree_set>
+#include <set>
+#include <testsuite_hooks.h>
+
+typedef __gnu_cxx::btree_set<int> set_type;
+
+void
+test01()
+{
+  set_type s = { 5, 1, 3, 1 };
+  VERIFY( s.size() == 3 );
+  VERIFY( *s.begin() == 1 );
+  VERIFY( *s.rbegin() == 5 );
+  VERIFY( s.insert(2).second );
+  VERIFY( !s.insert(2).second );
+  VERIFY( s.erase(1) == 1 );
+  VERIFY( *s.begin() == 2 );
+  static_assert( std::is_same<set_type::iterator,
+			      set_type::const_iterator>::value, "" );
+}
+
+// Compare random insertions and erasures with std::set, with a value
+// type that does not fit many times in a node.
+void
+test02()
+{
+  struct big
+  {
+    int key;
+    char pad[60];
+    bool operator<(const big& b) const { return key < b.key; }
+    bool operator==(const big& b) const { return key == b.key; }
+  };
+
+  __gnu_cxx::btree_set<big> s;
+  std::set<big> ref;
+  unsigned long x = 1;
+  for (int i = 0; i < 100000; ++i)
+    {
+      x = x * 6364136223846793005UL + 1442695040888963407UL;
+      big b = { int((x >> 33) % 2000), { } };
+      if ((x >> 20) % 3)
+	VERIFY( s.insert(b).second == ref.insert(b).second );
+      else
+	{
+	  auto it = s.find(b);
+	  auto rit = ref.find(b);
+	  VERIFY( (it == s.end()) == (rit == ref.end()) );
+	  if (rit != ref.end())
+	    {
+	      it = s.erase(it);
+	      rit = ref.erase(rit);
+	      VERIFY( (it == s.end()) == (rit == ref.end()) );
+	      if (rit != ref.end())
+		VERIFY( it->key == rit->key );
+	    }
+	}
+    }
+  VERIFY( s.size() == ref.size() );
+  VERIFY( std::equal(s.begin(), s.end(), ref.begin()) );
+  VERIFY( std::equal(s.rbegin(), s.rend(), ref.rbegin()) );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+}
@@ -0,0 +1,170 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+#include <ext/flat_hash_map>
+#include <string>
+#include <stdexcept>
+#include <testsuite_hooks.h>
+
+typedef __gnu_cxx::flat_hash_map<int, int> map_type;
+
+void
+test01()
+{
+  map_type m;
+  VERIFY( m.empty() );
+  VERIFY( m.begin() == m.end() );
+  VERIFY( m.find(1) == m.end() );
+
+  for (int i = 0; i < 10000; ++i)
+    VERIFY( m.insert(std::make_pair(i, i * 2)).second );
+  VERIFY( m.size() == 10000 );
+  VERIFY( !m.insert(std::make_pair(5, 0)).second );
+  VERIFY( m[5] == 10 );
+  VERIFY( (m.bucket_count() & (m.bucket_count() - 1)) == 0 );
+  VERIFY( m.load_factor() <= m.max_load_factor() );
+
+  for (int i = 0; i < 10000; i += 2)
+    VERIFY( m.erase(i) == 1 );
+  VERIFY( m.erase(0) == 0 );
+  VERIFY( m.size() == 5000 );
+  for (int i = 0; i < 10000; ++i)
+    VERIFY( m.count(i) == (i & 1) );
+
+  long sum = 0;
+  for (map_type::const_iterator it = m.cbegin(); it != m.cend(); ++it)
+    sum += it->first;
+  VERIFY( sum == 25000000L );
+
+  for (map_type::iterator it = m.begin(); it != m.end(); )
+    if (it->first % 3 == 0)
+      it = m.erase(it);
+    else
+      ++it;
+  for (int i = 0; i < 10000; ++i)
+    VERIFY( m.contains(i) == ((i & 1) && i % 3 != 0) );
+
+  m.clear();
+  VERIFY( m.empty() );
+  VERIFY( m.begin() == m.end() );
+}
+
+// Repeated insertion and erasure must not fill the table up with
+// deleted slots.
+void
+test02()
+{
+  map_type m;
+  for (int i = 0; i < 100000; ++i)
+    {
+      m[i] = i;
+      if (i >= 10)
+	m.erase(i - 10);
+    }
+  VERIFY( m.size() == 10 );
+  VERIFY( m.bucket_count() <= 64 );
+  VERIFY( m.at(99999) == 99999 );
+  bool caught = false;
+  try
+    {
+      m.at(0);
+    }
+  catch (const std::out_of_range&)
+    {
+      caught = true;
+    }
+  VERIFY( caught );
+}
+
+struct string_hash
+{
+  typedef void is_transparent;
+  std::size_t operator()(const std::string& s) const
+  { return std::hash<std::string>()(s); }
+  std::size_t operator()(const char* s) const
+  { return std::hash<std::string>()(s); }
+};
+
+struct string_equal
+{
+  typedef void is_transparent;
+  bool operator()(const std::string& a, const std::string& b) const
+  { return a == b; }
+  bool operator()(const char* a, const std::string& b) const
+  { return b == a; }
+};
+
+// Heterogeneous lookup, and elements that must be moved when the table
+// grows.
+void
+test03()
+{
+  __gnu_cxx::flat_hash_map<std::string, std::string,
+			   string_hash, string_equal> m;
+  for (int i = 0; i < 1000; ++i)
+    m.try_emplace(std::to_string(i), std::to_string(i * i));
+  VERIFY( m.find("12") != m.end() );
+  VERIFY( m.find("12")->second == "144" );
+  VERIFY( m.count("1000") == 0 );
+  VERIFY( m.contains("999") );
+  VERIFY( m.equal_range("7").first->second == "49" );
+
+  std::string key = "7";
+  VERIFY( !m.try_emplace(std::move(key), "x").second );
+  VERIFY( !key.empty() );
+  VERIFY( !m.insert_or_assign("7", std::string("y")).second );
+  VERIFY( m.at("7") == "y" );
+
+  decltype(m) m2 = m;
+  VERIFY( m2 == m );
+  m2.erase("7");
+  VERIFY( m2 != m );
+  decltype(m) m3 = std::move(m2);
+  VERIFY( m2.empty() );
+  VERIFY( m3.size() == 999 );
+  swap(m3, m2);
+  VERIFY( m3.empty() );
+  VERIFY( m2.size() == 999 );
+}
+
+void
+test04()
+{
+  map_type m = { { 1, 2 }, { 3, 4 }, { 1, 5 } };
+  VERIFY( m.size() == 2 );
+  VERIFY( m[1] == 2 );
+  m.reserve(1000);
+  std::size_t n = m.bucket_count();
+  VERIFY( n >= 1000 );
+  for (int i = 0; i < 1000; ++i)
+    m.emplace(i, i);
+  VERIFY( m.bucket_count() == n );
+  m.clear();
+  m.rehash(0);
+  VERIFY( m.bucket_count() == 0 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+  test04();
+}
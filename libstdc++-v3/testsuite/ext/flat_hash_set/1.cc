@@ -0,0 +1,90 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+#include <ext/flat_hash_set>
+#include <memory>
+#include <testsuite_hooks.h>
+
+void
+test01()
+{
+  __gnu_cxx::flat_hash_set<int> s = { 3, 1, 4, 1, 5, 9, 2, 6 };
+  VERIFY( s.size() == 7 );
+  VERIFY( s.count(1) == 1 );
+  VERIFY( s.count(7) == 0 );
+
+  for (int i = -5000; i < 5000; ++i)
+    s.insert(i * 7);
+  VERIFY( s.size() == 10000 + 7 );
+  int n = 0;
+  for (int x : s)
+    {
+      VERIFY( s.find(x) != s.end() );
+      ++n;
+    }
+  VERIFY( n == 10007 );
+
+  __gnu_cxx::flat_hash_set<int> s2(s.begin(), s.end());
+  VERIFY( s2 == s );
+  s2.erase(s2.begin(), s2.end());
+  VERIFY( s2.empty() );
+}
+
+// Move-only elements.
+void
+test02()
+{
+  __gnu_cxx::flat_hash_set<std::unique_ptr<int>> s;
+  for (int i = 0; i < 100; ++i)
+    s.emplace(new int(i));
+  VERIFY( s.size() == 100 );
+  int sum = 0;
+  for (const auto& p : s)
+    sum += *p;
+  VERIFY( sum == 4950 );
+}
+
+// Colliding hashes.
+struct bad_hash
+{
+  std::size_t operator()(int x) const { return x & 1; }
+};
+
+void
+test03()
+{
+  __gnu_cxx::flat_hash_set<int, bad_hash> s;
+  for (int i = 0; i < 500; ++i)
+    VERIFY( s.insert(i).second );
+  for (int i = 0; i < 500; i += 2)
+    VERIFY( s.erase(i) == 1 );
+  for (int i = 0; i < 500; ++i)
+    VERIFY( s.count(i) == (i & 1) );
+  for (int i = 0; i < 500; i += 2)
+    VERIFY( s.insert(i).second );
+  VERIFY( s.size() == 500 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
@@ -26,6 +26,10 @@
 #include <ext/algorithm>
 #include <ext/atomicity.h>
 #include <ext/bitmap_allocator.h>
+#if __cplusplus >= 201103L
+#include <ext/btree_map>
+#include <ext/btree_set>
+#endif
 #if _GLIBCXX_HAVE_ICONV
 #include <ext/codecvt_specializations.h>
 #endif
@@ -34,10 +38,23 @@
 #if _GLIBCXX_HAVE_ICONV
 #include <ext/enc_filebuf.h>
 #endif
+#if __cplusplus >= 201103L
+#include <ext/flat_hash_map>
+#include <ext/flat_hash_set>
+#endif
 #include <ext/functional>
+#if __cplusplus >= 201703L
+#include <ext/inplace_function.h>
+#endif
 #include <ext/iterator>
 #include <ext/malloc_allocator.h>
 #include <ext/memory>
+#if __cplusplus >= 201103L
+#include <ext/mmap_filebuf.h>
+#endif
+#if __cplusplus >= 201703L
+#include <ext/move_only_function.h>
+#endif
 #include <ext/mt_allocator.h>
 #include <ext/new_allocator.h>
 #include <ext/numeric>
@@ -46,6 +63,9 @@
 #include <ext/rb_tree>
 #include <ext/rope>
 #include <ext/slist>
+#if __cplusplus >= 201703L
+#include <ext/stats_resource.h>
+#endif
 #include <ext/stdio_filebuf.h>
 #include <ext/stdio_sync_filebuf.h>
 #include <ext/throw_allocator.h>
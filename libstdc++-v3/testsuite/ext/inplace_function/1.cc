@@ -0,0 +1,138 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-options "-std=gnu++17" }
+// { dg-do run { target c++17 } }
+
+#include <ext/inplace_function.h>
+#include <memory>
+#include <string>
+#include <testsuite_hooks.h>
+
+using __gnu_cxx::inplace_function;
+
+int add(int a, int b) { return a + b; }
+
+struct counted
+{
+  static int live;
+  int value;
+  counted(int v) : value(v) { ++live; }
+  counted(const counted& c) noexcept : value(c.value) { ++live; }
+  ~counted() { --live; }
+  int operator()(int a, int) const { return a * value; }
+};
+
+int counted::live = 0;
+
+void
+test01()
+{
+  inplace_function<int(int, int)> f;
+  VERIFY( !f );
+  VERIFY( f == nullptr );
+  bool caught = false;
+  try
+  {
+    f(1, 2);
+  }
+  catch (const std::bad_function_call&)
+  {
+    caught = true;
+  }
+  VERIFY( caught );
+
+  f = add;
+  VERIFY( f );
+  VERIFY( f(1, 2) == 3 );
+
+  int (*null)(int, int) = nullptr;
+  f = null;
+  VERIFY( !f );
+
+  long bias = 10;
+  f = [bias](int a, int b) { return a + b + bias; };
+  VERIFY( f(1, 2) == 13 );
+  inplace_function<int(int, int)> g = f;
+  VERIFY( g(3, 4) == 17 );
+  inplace_function<int(int, int)> h = std::move(g);
+  VERIFY( !g );
+  VERIFY( h(0, 0) == 10 );
+  swap(g, h);
+  VERIFY( g && !h );
+}
+
+void
+test02()
+{
+  {
+    inplace_function<int(int, int)> f = counted(3);
+    VERIFY( counted::live == 1 );
+    VERIFY( f(2, 0) == 6 );
+    inplace_function<int(int, int)> g = f;
+    VERIFY( counted::live == 2 );
+    inplace_function<int(int, int)> h = std::move(f);
+    VERIFY( counted::live == 2 );
+    VERIFY( h(2, 0) == 6 );
+    g = nullptr;
+    VERIFY( counted::live == 1 );
+    h = add;
+    VERIFY( counted::live == 0 );
+    h = counted(4);
+    g = h;
+    g = g;
+    VERIFY( counted::live == 2 );
+    VERIFY( g(1, 1) == 4 );
+  }
+  VERIFY( counted::live == 0 );
+}
+
+void
+test03()
+{
+  // A larger buffer holds captures that std::function would allocate.
+  std::string s = "a string that does not use the small string buffer";
+  inplace_function<std::size_t(), 64> f = [s] { return s.size(); };
+  VERIFY( f() == s.size() );
+  static_assert( sizeof(f) >= 64 );
+  static_assert( decltype(f)::capacity == 64 );
+
+  // The result is converted, and discarded for void.
+  inplace_function<void(int)> g = [](int i) { return i; };
+  g(1);
+  inplace_function<long()> h = [] { return 'a'; };
+  VERIFY( h() == 'a' );
+
+  struct S { int i; int get() const { return i; } };
+  inplace_function<int(const S&)> m = &S::get;
+  VERIFY( m(S{5}) == 5 );
+  inplace_function<int(const S&)> d = &S::i;
+  VERIFY( d(S{6}) == 6 );
+
+  static_assert( !std::is_constructible_v<inplace_function<int()>,
+					   int(*)(int)> );
+  static_assert( !std::is_constructible_v<inplace_function<int()>,
+					   std::unique_ptr<int>> );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
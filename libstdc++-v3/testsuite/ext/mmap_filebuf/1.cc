@@ -0,0 +1,95 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target { c++11 && { *-*-linux* *-*-gnu* } } } }
+// { dg-require-fileio "" }
+
+#include <ext/mmap_filebuf.h>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <testsuite_hooks.h>
+
+const char name[] = "tmp_mmap_filebuf_1";
+
+void
+test01()
+{
+  {
+    std::ofstream out(name);
+    out << "first line\n" << 12345 << ' ' << 6.5 << "\nlast";
+  }
+
+  __gnu_cxx::mmap_filebuf buf;
+  VERIFY( !buf.is_open() );
+  VERIFY( buf.open(name) == &buf );
+  VERIFY( buf.is_open() );
+  VERIFY( buf.open(name) == nullptr );
+  VERIFY( buf.in_avail() == 25 );
+
+  std::istream in(&buf);
+  std::string s;
+  std::getline(in, s);
+  VERIFY( s == "first line" );
+  int i;
+  double d;
+  in >> i >> d;
+  VERIFY( i == 12345 && d == 6.5 );
+  VERIFY( in.get() == '\n' );
+  VERIFY( in.putback('\n') );
+  in >> s;
+  VERIFY( s == "last" );
+  VERIFY( in.eof() );
+
+  in.clear();
+  VERIFY( in.seekg(6).tellg() == 6 );
+  in >> s;
+  VERIFY( s == "line" );
+  VERIFY( in.seekg(-4, std::ios_base::end).tellg() == 21 );
+  char c[4];
+  VERIFY( in.read(c, 4).gcount() == 4 );
+  VERIFY( std::string(c, 4) == "last" );
+  VERIFY( in.get() == std::char_traits<char>::eof() );
+  in.clear();
+  VERIFY( !in.seekg(-1, std::ios_base::beg) );
+
+  VERIFY( buf.close() == &buf );
+  VERIFY( !buf.is_open() );
+  VERIFY( buf.close() == nullptr );
+}
+
+void
+test02()
+{
+  std::ofstream(name).close();
+
+  __gnu_cxx::mmap_filebuf buf;
+  VERIFY( buf.open(name) == &buf );
+  std::istream in(&buf);
+  VERIFY( in.get() == std::char_traits<char>::eof() );
+  VERIFY( buf.close() == &buf );
+
+  VERIFY( buf.open("tmp_mmap_filebuf_nonexistent") == nullptr );
+  VERIFY( !buf.is_open() );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+}
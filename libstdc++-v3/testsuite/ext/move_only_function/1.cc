@@ -0,0 +1,126 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-options "-std=gnu++17" }
+// { dg-do run { target c++17 } }
+
+#include <ext/move_only_function.h>
+#include <memory>
+#include <testsuite_hooks.h>
+
+using __gnu_cxx::move_only_function;
+
+struct counted
+{
+  static int live;
+  int value;
+  counted(int v) : value(v) { ++live; }
+  counted(counted&& c) noexcept : value(c.value) { ++live; }
+  ~counted() { --live; }
+  int operator()(int a) { return a * value; }
+};
+
+int counted::live = 0;
+
+// Too large to be stored in the wrapper.
+struct big
+{
+  long data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  std::unique_ptr<int> p;
+  int operator()(int a) { return a + data[7] + *p; }
+};
+
+void
+test01()
+{
+  move_only_function<int(int)> f;
+  VERIFY( !f );
+  VERIFY( f == nullptr );
+  bool caught = false;
+  try
+  {
+    f(1);
+  }
+  catch (const std::bad_function_call&)
+  {
+    caught = true;
+  }
+  VERIFY( caught );
+
+  auto p = std::make_unique<int>(3);
+  f = [p = std::move(p)](int i) { return i + *p; };
+  VERIFY( f(1) == 4 );
+  move_only_function<int(int)> g = std::move(f);
+  VERIFY( !f );
+  VERIFY( g(2) == 5 );
+
+  static_assert( !std::is_copy_constructible_v<move_only_function<int()>> );
+  static_assert( std::is_nothrow_move_constructible_v<
+		   move_only_function<int()>> );
+
+  int (*null)(int) = nullptr;
+  g = null;
+  VERIFY( !g );
+}
+
+void
+test02()
+{
+  {
+    move_only_function<int(int)> f = counted(3);
+    VERIFY( counted::live == 1 );
+    VERIFY( f(2) == 6 );
+    move_only_function<int(int)> g = std::move(f);
+    VERIFY( counted::live == 1 );
+    VERIFY( g(2) == 6 );
+    swap(f, g);
+    VERIFY( counted::live == 1 );
+    VERIFY( f(1) == 3 );
+    f = nullptr;
+    VERIFY( counted::live == 0 );
+    g = move_only_function<int(int)>(std::in_place_type<counted>, 5);
+    VERIFY( counted::live == 1 );
+    VERIFY( g(2) == 10 );
+  }
+  VERIFY( counted::live == 0 );
+}
+
+void
+test03()
+{
+  big b;
+  b.p = std::make_unique<int>(100);
+  move_only_function<int(int)> f = std::move(b);
+  VERIFY( f(1) == 109 );
+  move_only_function<int(int)> g = std::move(f);
+  VERIFY( g(1) == 109 );
+  g = [](int i) { return -i; };
+  VERIFY( g(1) == -1 );
+
+  // The call operator is not const, so the target can keep state.
+  move_only_function<int()> c = [n = 0] () mutable { return ++n; };
+  c();
+  VERIFY( c() == 2 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+}
@@ -0,0 +1,91 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-options "-std=gnu++17" }
+// { dg-do run { target c++17 } }
+
+#include <ext/stats_resource.h>
+#include <sstream>
+#include <vector>
+#include <testsuite_hooks.h>
+
+void
+test01()
+{
+  __gnu_cxx::stats_resource r;
+  VERIFY( r.upstream_resource() == std::pmr::get_default_resource() );
+  VERIFY( r.is_equal(r) );
+
+  void* p = r.allocate(24);
+  void* q = r.allocate(100, 16);
+  VERIFY( r.allocations() == 2 );
+  VERIFY( r.bytes_allocated() == 124 );
+  VERIFY( r.bytes_in_use() == 124 );
+  VERIFY( r.histogram(5) == 1 );	// [16, 32)
+  VERIFY( r.histogram(7) == 1 );	// [64, 128)
+  r.deallocate(q, 100, 16);
+  VERIFY( r.deallocations() == 1 );
+  VERIFY( r.bytes_in_use() == 24 );
+  VERIFY( r.peak_bytes() == 124 );
+
+  r.reset();
+  VERIFY( r.allocations() == 0 );
+  VERIFY( r.bytes_in_use() == 24 );
+  VERIFY( r.peak_bytes() == 24 );
+  VERIFY( r.histogram(5) == 0 );
+  r.deallocate(p, 24);
+  VERIFY( r.bytes_in_use() == 0 );
+}
+
+void
+test02()
+{
+  __gnu_cxx::stats_resource r(std::pmr::new_delete_resource());
+  {
+    std::pmr::vector<int> v(&r);
+    for (int i = 0; i < 100; ++i)
+      v.push_back(i);
+  }
+  VERIFY( r.allocations() > 1 );
+  VERIFY( r.allocations() == r.deallocations() );
+  VERIFY( r.bytes_in_use() == 0 );
+  VERIFY( r.peak_bytes() >= 100 * sizeof(int) );
+
+  __gnu_cxx::stats_resource::call_site sites[4];
+  const auto n = r.call_sites(sites, 4);
+  VERIFY( n >= 1 );
+  std::size_t total = r.other_call_sites();
+  for (std::size_t i = 0; i < n; ++i)
+    total += sites[i].allocations;
+  VERIFY( total == r.allocations() );
+
+  std::ostringstream s;
+  r.write_json(s);
+  const std::string json = s.str();
+  VERIFY( json.front() == '{' && json.back() == '}' );
+  VERIFY( json.find("\"allocations\":" + std::to_string(r.allocations()))
+	  != std::string::npos );
+  VERIFY( json.find("\"bytes_in_use\":0,") != std::string::npos );
+  VERIFY( json.find("\"call_sites\":[{\"address\":") != std::string::npos );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+}
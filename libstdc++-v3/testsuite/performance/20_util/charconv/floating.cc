@@ -0,0 +1,86 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-options "-std=gnu++17" }
+// { dg-do run { target c++17 } }
+
+#include <charconv>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include <testsuite_performance.h>
+
+using namespace __gnu_test;
+
+// Compare floating-point std::to_chars and std::from_chars with the
+// C library's snprintf and strtod.
+int main()
+{
+  time_counter time;
+  resource_counter resource;
+
+  std::mt19937_64 gen;
+  std::uniform_real_distribution<double> dist(-1e6, 1e6);
+  std::vector<double> values;
+  for (int i = 0; i < 100000; ++i)
+    values.push_back(i % 2 ? dist(gen) : std::ldexp(dist(gen), i % 600 - 300));
+
+  char buf[64];
+  std::vector<std::string> strings;
+  for (double d : values)
+    strings.emplace_back(buf, std::to_chars(buf, buf + sizeof(buf), d).ptr);
+
+  std::size_t len = 0;
+  start_counters(time, resource);
+  for (int i = 0; i < 10; ++i)
+    for (double d : values)
+      len += std::to_chars(buf, buf + sizeof(buf), d).ptr - buf;
+  stop_counters(time, resource);
+  report_performance(__FILE__, "to_chars", time, resource);
+
+  start_counters(time, resource);
+  for (int i = 0; i < 10; ++i)
+    for (double d : values)
+      len += std::snprintf(buf, sizeof(buf), "%.17g", d);
+  stop_counters(time, resource);
+  report_performance(__FILE__, "snprintf %.17g", time, resource);
+
+  int mismatches = 0;
+  start_counters(time, resource);
+  for (int i = 0; i < 10; ++i)
+    for (std::size_t j = 0; j < strings.size(); ++j)
+      {
+	double d;
+	const std::string& s = strings[j];
+	std::from_chars(s.data(), s.data() + s.size(), d);
+	mismatches += d != values[j];
+      }
+  stop_counters(time, resource);
+  report_performance(__FILE__, "from_chars", time, resource);
+
+  start_counters(time, resource);
+  for (int i = 0; i < 10; ++i)
+    for (std::size_t j = 0; j < strings.size(); ++j)
+      mismatches += std::strtod(strings[j].c_str(), nullptr) != values[j];
+  stop_counters(time, resource);
+  report_performance(__FILE__, "strtod", time, resource);
+
+  return mismatches == 0 && len != 0 ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-options "-std=gnu++17" }
+// { dg-do run { target c++17 } }
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <ext/inplace_function.h>
+#include <ext/move_only_function.h>
+#include <testsuite_performance.h>
+
+using namespace __gnu_test;
+
+// A callable object of four pointers, too large for std::function to
+// store without allocating.
+struct functor
+{
+  const int* a;
+  const int* b;
+  long c;
+  long d;
+  long operator()(long x) const { return x + *a + *b + c + d; }
+};
+
+template<typename Function>
+  void
+  run(const char* name)
+  {
+    time_counter time;
+    resource_counter resource;
+    const int n = 1000000;
+    int one = 1;
+    int two = 2;
+
+    std::vector<Function> v;
+    v.reserve(n);
+    start_counters(time, resource);
+    for (int i = 0; i < n; ++i)
+      v.emplace_back(functor{&one, &two, i, i});
+    stop_counters(time, resource);
+    report_performance(__FILE__, std::string(name) + " construct",
+		       time, resource);
+
+    long sum = 0;
+    start_counters(time, resource);
+    for (int j = 0; j < 10; ++j)
+      for (auto& f : v)
+	sum += f(j);
+    stop_counters(time, resource);
+    report_performance(__FILE__, std::string(name) + " call", time, resource);
+
+    start_counters(time, resource);
+    std::vector<Function> w;
+    w.reserve(n);
+    for (auto& f : v)
+      w.push_back(std::move(f));
+    stop_counters(time, resource);
+    report_performance(__FILE__, std::string(name) + " move", time, resource);
+
+    start_counters(time, resource);
+    v.clear();
+    w.clear();
+    stop_counters(time, resource);
+    report_performance(__FILE__, std::string(name) + " destroy",
+		       time, resource);
+    if (sum == 0)
+      __builtin_abort();
+  }
+
+// Compare std::function with the inline and move-only wrappers.
+int main()
+{
+  run<std::function<long(long)>>("std::function");
+  run<__gnu_cxx::inplace_function<long(long)>>("inplace_function");
+  run<__gnu_cxx::move_only_function<long(long)>>("move_only_function");
+}
@@ -0,0 +1,82 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Override the -std flag in the check_performance script: STD=gnu++17
+
+#include <memory_resource>
+#include <list>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <testsuite_performance.h>
+
+// Allocate and free list nodes of two sizes, growing the lists so that
+// every thread keeps replenishing its pools from the upstream resource.
+void
+churn(std::pmr::memory_resource* r, int n)
+{
+  struct size24 { char c[24]; };
+  std::pmr::list<int> l4(r);
+  std::pmr::list<size24> l24(r);
+
+  for (int k = 0; k < 20; ++k)
+    {
+      for (int i = 0; i < n; ++i)
+	{
+	  l4.emplace_back();
+	  l24.emplace_back();
+	}
+      for (int i = 0; i < n / 2; ++i)
+	{
+	  l4.pop_front();
+	  l24.pop_front();
+	}
+    }
+}
+
+// Scaling of one synchronized_pool_resource shared by 1 to 128 threads,
+// doing the same total amount of work for each thread count.
+int
+main()
+{
+  const int total = 1 << 20;
+
+  for (int nthreads = 1; nthreads <= 128; nthreads *= 2)
+    {
+      std::pmr::synchronized_pool_resource sync;
+      std::mutex mx;
+      std::unique_lock<std::mutex> gate(mx);
+      std::vector<std::thread> threads;
+
+      __gnu_test::time_counter time;
+      __gnu_test::resource_counter resource;
+      for (int i = 0; i < nthreads; ++i)
+	threads.emplace_back([&] {
+	  std::lock_guard<std::mutex>{mx};  // block until the gate opens
+	  churn(&sync, total / 20 / nthreads);
+	});
+      start_counters(time, resource);
+      gate.unlock(); // let the threads run
+      for (auto& t : threads)
+	t.join();
+      stop_counters(time, resource);
+      report_performance(__FILE__,
+			 "sync-pool shared by " + std::to_string(nthreads)
+			 + " threads", time, resource);
+    }
+}
@@ -0,0 +1,106 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-options "-std=gnu++2a -pthread" }
+// { dg-do run { target c++2a } }
+// { dg-require-effective-target pthread }
+// { dg-require-gthreads "" }
+
+#include <memory>
+#include <thread>
+#include <sstream>
+#include <testsuite_performance.h>
+
+// Many threads loading a read-mostly shared_ptr, as a configuration
+// snapshot would be, and one in 1000 loads replacing it.  Each thread
+// uses its own object for the "private" runs, so that only the
+// contention on the implementation is measured, and the same one
+// otherwise.
+
+const int iterations = 1000000;
+
+struct free_functions
+{
+  std::shared_ptr<int> p = std::make_shared<int>(0);
+
+  std::shared_ptr<int> load() { return std::atomic_load(&p); }
+  void store(std::shared_ptr<int> r) { std::atomic_store(&p, std::move(r)); }
+};
+
+struct atomic_specialization
+{
+  std::atomic<std::shared_ptr<int>> p{std::make_shared<int>(0)};
+
+  std::shared_ptr<int> load() { return p.load(); }
+  void store(std::shared_ptr<int> r) { p.store(std::move(r)); }
+};
+
+template<typename Holder>
+  void
+  run(Holder& h)
+  {
+    long sum = 0;
+    for (int i = 0; i < iterations; ++i)
+      {
+	sum += *h.load();
+	if (i % 1000 == 0)
+	  h.store(std::make_shared<int>(i));
+      }
+    if (sum < 0)
+      __builtin_abort();
+  }
+
+template<typename Holder>
+  void
+  bench(const char* desc, unsigned nthreads, bool shared)
+  {
+    using namespace __gnu_test;
+
+    time_counter time;
+    resource_counter resource;
+
+    std::unique_ptr<Holder[]> holders(new Holder[shared ? 1 : nthreads]);
+    std::unique_ptr<std::thread[]> threads(new std::thread[nthreads]);
+
+    start_counters(time, resource);
+    for (unsigned n = 0; n < nthreads; ++n)
+      threads[n] = std::thread(run<Holder>,
+			       std::ref(holders[shared ? 0 : n]));
+    for (unsigned n = 0; n < nthreads; ++n)
+      threads[n].join();
+    stop_counters(time, resource);
+
+    std::ostringstream ostr;
+    ostr << desc << ' ' << nthreads << " threads, "
+	 << (shared ? "shared" : "private") << " object";
+    report_performance(__FILE__, ostr.str().c_str(), time, resource);
+  }
+
+int
+main()
+{
+  unsigned max_threads = std::thread::hardware_concurrency();
+  if (max_threads < 2)
+    max_threads = 2;
+  for (unsigned n = 1; n <= max_threads; n *= 2)
+    for (bool shared : { false, true })
+      {
+	bench<free_functions>("std::atomic_load", n, shared);
+	bench<atomic_specialization>("std::atomic<shared_ptr>", n, shared);
+      }
+  return 0;
+}
@@ -0,0 +1,102 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+#include <testsuite_performance.h>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <ext/btree_map>
+
+// Order-book style use of an ordered map: random insertions, lookups,
+// walks from the best price, and erasures.
+template<typename Map>
+  void
+  bench(const char* name, const std::vector<int>& keys)
+  {
+    using namespace __gnu_test;
+
+    time_counter time;
+    resource_counter resource;
+    std::ostringstream ostr;
+
+    Map m;
+    start_counters(time, resource);
+    for (int k : keys)
+      m[k] = k;
+    stop_counters(time, resource);
+    ostr << name << ' ' << keys.size() << " random insertions";
+    report_performance(__FILE__, ostr.str().c_str(), time, resource);
+
+    long found = 0;
+    start_counters(time, resource);
+    for (int j = 0; j != 10; ++j)
+      for (int k : keys)
+	found += m.count(k + j);
+    stop_counters(time, resource);
+    ostr.str("");
+    ostr << name << ' ' << 10 * keys.size() << " finds, " << found << " hits";
+    report_performance(__FILE__, ostr.str().c_str(), time, resource);
+
+    long sum = 0;
+    start_counters(time, resource);
+    for (std::size_t i = 0; i != keys.size(); i += 16)
+      {
+	auto it = m.lower_bound(keys[i]);
+	for (int j = 0; j != 16 && it != m.end(); ++j, ++it)
+	  sum += it->second;
+      }
+    stop_counters(time, resource);
+    ostr.str("");
+    ostr << name << ' ' << keys.size() / 16 << " walks of 16 elements";
+    report_performance(__FILE__, ostr.str().c_str(), time, resource);
+
+    start_counters(time, resource);
+    for (int j = 0; j != 10; ++j)
+      for (auto& e : m)
+	sum += e.second;
+    stop_counters(time, resource);
+    ostr.str("");
+    ostr << name << " 10 iterations over " << m.size() << " elements";
+    report_performance(__FILE__, ostr.str().c_str(), time, resource);
+
+    start_counters(time, resource);
+    for (int k : keys)
+      m.erase(k);
+    stop_counters(time, resource);
+    ostr.str("");
+    ostr << name << ' ' << keys.size() << " random erasures";
+    report_performance(__FILE__, ostr.str().c_str(), time, resource);
+    if (sum == 0)
+      __builtin_abort();
+  }
+
+int
+main()
+{
+  std::vector<int> keys;
+  unsigned long x = 1;
+  for (int i = 0; i != 1000000; ++i)
+    {
+      x = x * 6364136223846793005UL + 1442695040888963407UL;
+      keys.push_back(x >> 34);
+    }
+  bench<std::map<int, int>>("std::map", keys);
+  bench<__gnu_cxx::btree_map<int, int>>("__gnu_cxx::btree_map", keys);
+  return 0;
+}
@@ -0,0 +1,63 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-do run { target c++11 } }
+
+#include <testsuite_performance.h>
+#include <sstream>
+#include <unordered_map>
+#include <ext/flat_hash_map>
+
+template<typename Map>
+  void
+  bench(const char* name, int sz)
+  {
+    using namespace __gnu_test;
+
+    time_counter time;
+    resource_counter resource;
+
+    Map m;
+    start_counters(time, resource);
+    for (int i = 0; i != sz; ++i)
+      m[i * 7] = i;
+    stop_counters(time, resource);
+
+    std::ostringstream ostr;
+    ostr << name << ' ' << sz << " insertions";
+    report_performance(__FILE__, ostr.str().c_str(), time, resource);
+
+    long found = 0;
+    start_counters(time, resource);
+    for (int j = 0; j != 10; ++j)
+      for (int i = 0; i != sz; ++i)
+	found += m.count(i);
+    stop_counters(time, resource);
+
+    ostr.str("");
+    ostr << name << ' ' << 10 * sz << " finds, " << found << " hits";
+    report_performance(__FILE__, ostr.str().c_str(), time, resource);
+  }
+
+int
+main()
+{
+  const int sz = 1000000;
+  bench<std::unordered_map<int, int>>("std::unordered_map", sz);
+  bench<__gnu_cxx::flat_hash_map<int, int>>("__gnu_cxx::flat_hash_map", sz);
+  return 0;
+}
@@ -0,0 +1,100 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <vector>
+#include <algorithm>
+#include <testsuite_performance.h>
+
+// Scans of contiguous ranges of arithmetic types, which use vectorized code.
+
+const int size = 100000;
+const int iterations = 2000;
+
+// Stop the compiler from hoisting the scans out of the loops.
+inline void
+clobber()
+{ __asm__ __volatile__("" : : : "memory"); }
+
+template<typename T>
+  void
+  bench(const char* type)
+  {
+    using namespace __gnu_test;
+
+    time_counter time;
+    resource_counter resource;
+    char desc[64];
+
+    std::vector<T> v(size, T(1)), w(v);
+    v.back() = T(2);
+    w.back() = T(3);
+    long sink = 0;
+
+    start_counters(time, resource);
+    for (int i = 0; i < iterations; ++i, clobber())
+      sink += std::find(v.begin(), v.end(), T(2)) - v.begin();
+    stop_counters(time, resource);
+    __builtin_sprintf(desc, "find %s", type);
+    report_performance(__FILE__, desc, time, resource);
+    clear_counters(time, resource);
+
+    start_counters(time, resource);
+    for (int i = 0; i < iterations; ++i, clobber())
+      sink += std::count(v.begin(), v.end(), T(1));
+    stop_counters(time, resource);
+    __builtin_sprintf(desc, "count %s", type);
+    report_performance(__FILE__, desc, time, resource);
+    clear_counters(time, resource);
+
+    start_counters(time, resource);
+    for (int i = 0; i < iterations; ++i, clobber())
+      sink += std::max_element(v.begin(), v.end()) - v.begin();
+    stop_counters(time, resource);
+    __builtin_sprintf(desc, "max_element %s", type);
+    report_performance(__FILE__, desc, time, resource);
+    clear_counters(time, resource);
+
+    start_counters(time, resource);
+    for (int i = 0; i < iterations; ++i, clobber())
+      sink += std::mismatch(v.begin(), v.end(), w.begin()).first - v.begin();
+    stop_counters(time, resource);
+    __builtin_sprintf(desc, "mismatch %s", type);
+    report_performance(__FILE__, desc, time, resource);
+    clear_counters(time, resource);
+
+    start_counters(time, resource);
+    for (int i = 0; i < iterations; ++i, clobber())
+      sink += std::equal(v.begin(), v.end() - 1, w.begin());
+    stop_counters(time, resource);
+    __builtin_sprintf(desc, "equal %s", type);
+    report_performance(__FILE__, desc, time, resource);
+
+    if (sink == 0)
+      __builtin_abort();
+  }
+
+int
+main()
+{
+  bench<char>("char");
+  bench<short>("short");
+  bench<int>("int");
+  bench<long long>("long long");
+  bench<float>("float");
+  bench<double>("double");
+  return 0;
+}
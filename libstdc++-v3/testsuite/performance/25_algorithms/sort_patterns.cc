@@ -0,0 +1,93 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <testsuite_performance.h>
+
+const int max_size = 4000000;
+
+template<typename T, typename Compare>
+  void
+  bench(const char* desc, const std::vector<T>& src, Compare comp)
+  {
+    using namespace __gnu_test;
+
+    time_counter time;
+    resource_counter resource;
+
+    std::vector<T> v(src);
+    start_counters(time, resource);
+    std::sort(v.begin(), v.end(), comp);
+    stop_counters(time, resource);
+    report_performance(__FILE__, desc, time, resource);
+  }
+
+template<typename T>
+  void
+  bench(const char* desc, const std::vector<T>& src)
+  { bench(desc, src, std::less<T>()); }
+
+int main()
+{
+  // a simple psuedo-random series which does not rely on rand() and friends
+  std::vector<int> random(max_size);
+  random[0] = 0;
+  for (int i = 1; i < max_size; ++i)
+    random[i] = (random[i-1] + 110211473) * 745988807;
+
+  std::vector<int> v(max_size);
+
+  bench("int random", random);
+  bench("int random, function object",
+	random, [](int x, int y) { return x < y; });
+
+  for (int i = 0; i < max_size; ++i)
+    v[i] = i;
+  bench("int sorted", v);
+  v[max_size / 3] = -1;
+  v[max_size / 2] = max_size;
+  bench("int nearly sorted", v);
+
+  for (int i = 0; i < max_size; ++i)
+    v[i] = -i;
+  bench("int reversed", v);
+
+  for (int i = 0; i < max_size; ++i)
+    v[i] = i < max_size / 2 ? i : max_size - i;
+  bench("int organ pipe", v);
+
+  for (int i = 0; i < max_size; ++i)
+    v[i] = i % 1000;
+  bench("int sawtooth", v);
+
+  for (int i = 0; i < max_size; ++i)
+    v[i] = random[i] & 15;
+  bench("int few unique", v);
+
+  std::vector<double> d(random.begin(), random.end());
+  bench("double random", d);
+
+  std::vector<std::pair<int, int>> p(max_size);
+  for (int i = 0; i < max_size; ++i)
+    p[i] = std::make_pair(random[i] & 0xffff, i);
+  bench("pair<int, int> random", p);
+
+  return 0;
+}
@@ -0,0 +1,65 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <testsuite_performance.h>
+
+template<typename _Engine>
+  void
+  bench(const char* name, _Engine& e, unsigned long n)
+  {
+    using namespace __gnu_test;
+    time_counter time;
+    resource_counter resource;
+
+    typename _Engine::result_type sum = 0;
+    start_counters(time, resource);
+    for (unsigned long i = 0; i < n; ++i)
+      sum += e();
+    stop_counters(time, resource);
+    std::string s(name);
+    if (sum == 0)
+      s += " ";
+    report_performance(__FILE__, s, time, resource);
+  }
+
+int main()
+{
+  const char* tokens[] = {
+    "default", "getrandom", "rdrand", "rdseed", "/dev/urandom"
+  };
+  for (const char* token : tokens)
+    {
+      try
+	{
+	  std::random_device rd(token);
+	  bench(token, rd, 1000000);
+	}
+      catch (const std::runtime_error&)
+	{
+	}
+    }
+
+  std::mt19937 mt;
+  bench("mt19937", mt, 200000000);
+  std::mt19937_64 mt64;
+  bench("mt19937_64", mt64, 200000000);
+
+  return 0;
+}
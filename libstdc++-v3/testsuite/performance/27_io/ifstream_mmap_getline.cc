@@ -0,0 +1,72 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Override the -std flag in the check_performance script: STD=gnu++11
+
+#include <fstream>
+#include <cstdlib>
+#include <ext/mmap_filebuf.h>
+#include <testsuite_performance.h>
+
+// Read a file line by line through std::filebuf and through
+// __gnu_cxx::mmap_filebuf.
+int main ()
+{
+  using namespace std;
+  using namespace __gnu_test;
+
+  time_counter time;
+  resource_counter resource;
+
+  const char* name = "/usr/share/dict/words";
+  {
+    ifstream test(name);
+    if (!test.is_open())
+      name = "/usr/share/dict/linux.words";
+  }
+
+  const int iterations = 20;
+  char buffer[BUFSIZ];
+
+  start_counters(time, resource);
+  for (int i = 0; i < iterations; ++i)
+    {
+      ifstream in(name);
+      if (!in.is_open())
+	exit(1);
+      while (in.good())
+	in.getline(buffer, BUFSIZ);
+    }
+  stop_counters(time, resource);
+  report_performance(__FILE__, "filebuf", time, resource);
+  clear_counters(time, resource);
+
+  start_counters(time, resource);
+  for (int i = 0; i < iterations; ++i)
+    {
+      __gnu_cxx::mmap_filebuf buf;
+      if (!buf.open(name))
+	exit(1);
+      istream in(&buf);
+      while (in.good())
+	in.getline(buffer, BUFSIZ);
+    }
+  stop_counters(time, resource);
+  report_performance(__FILE__, "mmap_filebuf", time, resource);
+
+  return 0;
+}
@@ -0,0 +1,79 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-options "-std=gnu++17" }
+// { dg-require-filesystem-ts "" }
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <testsuite_performance.h>
+
+namespace fs = std::filesystem;
+
+// Build a tree of depth levels with fanout subdirectories and files in
+// each directory, nested under long directory names.
+void
+make_tree(const fs::path& dir, int depth, int fanout)
+{
+  fs::create_directory(dir);
+  for (int i = 0; i < fanout; ++i)
+    std::ofstream(dir / ("file" + std::to_string(i)));
+  if (depth > 0)
+    for (int i = 0; i < fanout; ++i)
+      make_tree(dir / ("a_rather_long_directory_name_" + std::to_string(i)),
+		depth - 1, fanout);
+}
+
+int main()
+{
+  using namespace __gnu_test;
+
+  time_counter time;
+  resource_counter resource;
+
+  const fs::path root = fs::temp_directory_path()
+    / ("filesystem-perf-" + std::to_string(::getpid()));
+  make_tree(root, 4, 8);
+
+  const int iterations = 20;
+  unsigned long n = 0;
+
+  start_counters(time, resource);
+  for (int i = 0; i < iterations; ++i)
+    for (auto& e : fs::recursive_directory_iterator(root))
+      n += e.is_directory();
+  stop_counters(time, resource);
+  report_performance(__FILE__, "recursive_directory_iterator", time,
+		     resource);
+  clear_counters(time, resource);
+
+  start_counters(time, resource);
+  for (int i = 0; i < iterations; ++i)
+    {
+      fs::recursive_directory_iterator it(root), end;
+      for (; it != end; ++it)
+	n += it->is_symlink();
+    }
+  stop_counters(time, resource);
+  report_performance(__FILE__, "recursive_directory_iterator symlink", time,
+		     resource);
+
+  fs::remove_all(root);
+  return n == 0;
+}
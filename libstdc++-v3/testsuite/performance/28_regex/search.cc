@@ -0,0 +1,57 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <regex>
+#include <string>
+#include <vector>
+#include <testsuite_performance.h>
+
+using namespace __gnu_test;
+
+// Filter log lines, most of which don't match.
+int main()
+{
+  time_counter time;
+  resource_counter resource;
+
+  std::vector<std::string> lines;
+  for (int i = 0; i < 1000; ++i)
+    lines.push_back("2019-06-01 12:00:" + std::to_string(i % 60)
+		    + " worker " + std::to_string(i)
+		    + (i % 100 ? " request served in 3ms"
+		       : " error: upstream timed out (110)"));
+  const std::regex re("error: .*(timed out|refused)");
+
+  int found = 0;
+  start_counters(time, resource);
+  for (int i = 0; i < 100; ++i)
+    for (const auto& line : lines)
+      found += std::regex_search(line, re);
+  stop_counters(time, resource);
+  report_performance(__FILE__, "regex_search", time, resource);
+
+  std::smatch m;
+  start_counters(time, resource);
+  for (int i = 0; i < 100; ++i)
+    for (const auto& line : lines)
+      found += std::regex_search(line, m, re);
+  stop_counters(time, resource);
+  report_performance(__FILE__, "regex_search with match_results",
+		     time, resource);
+
+  return found == 2000 ? 0 : 1;
+}
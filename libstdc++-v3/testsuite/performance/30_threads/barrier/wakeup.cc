@@ -0,0 +1,158 @@
+// Copyright (C) 2019 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// { dg-options "-std=gnu++2a -pthread" }
+// { dg-require-effective-target pthread }
+// { dg-require-gthreads "" }
+
+#include <algorithm>
+#include <barrier>
+#include <condition_variable>
+#include <mutex>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+#include <testsuite_performance.h>
+
+// A barrier built on a mutex and a condition variable, for comparison.
+class cv_barrier
+{
+public:
+  explicit cv_barrier(int n) : n(n), remaining(n) { }
+
+  void
+  arrive_and_wait()
+  {
+    std::unique_lock<std::mutex> l(m);
+    const unsigned p = phase;
+    if (--remaining == 0)
+      {
+	remaining = n;
+	++phase;
+	cv.notify_all();
+      }
+    else
+      cv.wait(l, [&] { return phase != p; });
+  }
+
+private:
+  std::mutex m;
+  std::condition_variable cv;
+  const int n;
+  int remaining;
+  unsigned phase = 0;
+};
+
+template<typename Barrier>
+  void
+  run_barrier(const char* name, int nthreads, int phases)
+  {
+    using namespace __gnu_test;
+    time_counter time;
+    resource_counter resource;
+
+    Barrier b(nthreads);
+    std::vector<std::thread> threads;
+    start_counters(time, resource);
+    for (int i = 0; i < nthreads; ++i)
+      threads.emplace_back([&] {
+	for (int j = 0; j < phases; ++j)
+	  b.arrive_and_wait();
+      });
+    for (auto& t : threads)
+      t.join();
+    stop_counters(time, resource);
+    std::string desc = name;
+    desc += ' ' + std::to_string(nthreads) + " threads";
+    report_performance(__FILE__, desc, time, resource);
+  }
+
+// Two threads passing a token back and forth, the wake-up latency of a
+// thread pool that hands one task at a time to a sleeping worker.
+void
+ping_pong_semaphore(int rounds)
+{
+  using namespace __gnu_test;
+  time_counter time;
+  resource_counter resource;
+
+  std::binary_semaphore ping(0), pong(0);
+  start_counters(time, resource);
+  std::thread t([&] {
+    for (int i = 0; i < rounds; ++i)
+      {
+	ping.acquire();
+	pong.release();
+      }
+  });
+  for (int i = 0; i < rounds; ++i)
+    {
+      ping.release();
+      pong.acquire();
+    }
+  t.join();
+  stop_counters(time, resource);
+  report_performance(__FILE__, "ping-pong binary_semaphore", time, resource);
+}
+
+void
+ping_pong_condvar(int rounds)
+{
+  using namespace __gnu_test;
+  time_counter time;
+  resource_counter resource;
+
+  std::mutex m;
+  std::condition_variable cv;
+  int turn = 0;
+  start_counters(time, resource);
+  std::thread t([&] {
+    for (int i = 0; i < rounds; ++i)
+      {
+	std::unique_lock<std::mutex> l(m);
+	cv.wait(l, [&] { return turn == 1; });
+	turn = 0;
+	cv.notify_one();
+      }
+  });
+  for (int i = 0; i < rounds; ++i)
+    {
+      std::unique_lock<std::mutex> l(m);
+      turn = 1;
+      cv.notify_one();
+      cv.wait(l, [&] { return turn == 0; });
+    }
+  t.join();
+  stop_counters(time, resource);
+  report_performance(__FILE__, "ping-pong condition_variable", time,
+		     resource);
+}
+
+int
+main()
+{
+  const int max_threads = std::max(2u, std::thread::hardware_concurrency());
+  for (int n = 2; n <= max_threads; n *= 2)
+    {
+      run_barrier<std::barrier<>>("std::barrier", n, 20000);
+      run_barrier<cv_barrier>("condition_variable barrier", n, 20000);
+    }
+  ping_pong_semaphore(200000);
+  ping_pong_condvar(200000);
+  return 0;
+}
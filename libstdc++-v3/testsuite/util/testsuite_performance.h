@@ -24,6 +24,10 @@
 
 #include <sys/times.h>
 #include <sys/resource.h>
+#include <unistd.h>
+#if defined (__linux__)
+#include <sched.h>
+#endif
 #include <cstdlib>
 #include <cstring>
 #include <string>
@@ -138,7 +142,7 @@ namespace __gnu_test
 
     std::size_t
     system_time() const
-    { return (tms_end.tms_stime - tms_begin.tms_stime) + splits[1]; }
+    { return (tms_end.tms_stime - tms_begin.tms_stime) + splits[2]; }
   };
 
   class resource_counter
@@ -214,6 +218,73 @@ namespace __gnu_test
     r.clear();
   }
 
+  // If GLIBCXX_PERFORMANCE_CPUS is set to a comma-separated list of CPU
+  // numbers, run the test on those CPUs only, so that migrations between
+  // CPUs don't show up in the timings.
+  struct cpu_pinning
+  {
+    cpu_pinning()
+    {
+#if defined (__linux__) && defined (CPU_SET)
+      const char* cpus = std::getenv("GLIBCXX_PERFORMANCE_CPUS");
+      if (!cpus || !*cpus)
+	return;
+
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (char* end; *cpus; cpus = end)
+	{
+	  long cpu = std::strtol(cpus, &end, 10);
+	  if (end == cpus || cpu < 0 || cpu >= CPU_SETSIZE)
+	    return;
+	  CPU_SET(cpu, &set);
+	  if (*end == ',')
+	    ++end;
+	}
+      sched_setaffinity(0, sizeof(set), &set);
+#endif
+    }
+  };
+
+  static cpu_pinning pin_cpus;
+
+  std::string
+  json_string(const std::string& s)
+  {
+    std::string result(1, '"');
+    for (std::string::const_iterator i = s.begin(); i != s.end(); ++i)
+      {
+	if (*i == '"' || *i == '\\')
+	  result += '\\';
+	if (static_cast<unsigned char>(*i) >= ' ')
+	  result += *i;
+      }
+    result += '"';
+    return result;
+  }
+
+  // Append the result to libstdc++-performance.json as well, one JSON
+  // object per line, with the times in seconds.  Running a test several
+  // times appends a line per run; scripts/compare_performance.py compares
+  // the medians of two such files.
+  void
+  report_json(const std::string& testname, const std::string& comment,
+	      const time_counter& t, const resource_counter& r)
+  {
+    const char* name = "libstdc++-performance.json";
+    const double ticks = sysconf(_SC_CLK_TCK);
+
+    std::ofstream out(name, std::ios_base::app);
+    out << "{\"test\": " << json_string(testname)
+	<< ", \"comment\": " << json_string(comment)
+	<< ", \"real\": " << t.real_time() / ticks
+	<< ", \"user\": " << t.user_time() / ticks
+	<< ", \"system\": " << t.system_time() / ticks
+	<< ", \"memory\": " << r.allocated_memory()
+	<< ", \"page_faults\": " << r.hard_page_fault()
+	<< "}" << std::endl;
+  }
+
   void
   report_performance(const std::string file, const std::string comment,
 		     const time_counter& t, const resource_counter& r)
@@ -244,6 +315,8 @@ namespace __gnu_test
 
     out << std::endl;
     out.close();
+
+    report_json(testname, comment, t, r);
   }
 
   void
@@ -33,7 +33,8 @@ along with this program; see the file COPYING3.  If not see
    only works if the input files are hybrid. 
    -linker-output-known: Do not determine linker output
    -sym-style={none,win32,underscore|uscore}
-   -pass-through  */
+   -pass-through
+   -symtab-cache=DIR: Cache the IL symbol tables of the input files in DIR.  */
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -121,6 +122,12 @@ struct plugin_objfile
   simple_object_read *objfile;
   struct plugin_symtab *out;
   const struct ld_plugin_input_file *file;
+  /* The symbol table sections in the format of the symbol table cache,
+     when there is one.  */
+  char *cache_data;
+  size_t cache_len;
+  /* Nonzero if the file was found to be corrupt.  */
+  int corrupt;
 };
 
 /* All that we have to remember about a file. */
@@ -339,6 +346,264 @@ translate (char *data, char *end, struct plugin_symtab *out)
   out->aux = aux;
 }
 
+/* Symbol table cache.  With -symtab-cache=DIR the raw IL symbol tables of
+   the claimed files are kept in DIR, one cache file per input file or
+   archive, so that linking against the same archives again does not need
+   to parse the object files.  A cache file is only used if the size,
+   modification time, inode and device of the input file it was built
+   from still match; its members are found by their offset in the file.
+
+   A cache file consists of a header (magic, stamp and the name of the
+   input file) followed by records of struct symtab_cache_member, each
+   followed by the symbol table sections of the member: a 64-bit section
+   id, a 64-bit length and the contents of the section.  */
+
+#define SYMTAB_CACHE_MAGIC "LTOSYMC1"
+
+struct symtab_cache_stamp
+{
+  uint64_t size;
+  int64_t mtime;
+  uint64_t ino;
+  uint64_t dev;
+};
+
+struct symtab_cache_member
+{
+  int64_t offset;
+  int64_t filesize;
+  uint32_t found;
+  uint32_t offload;
+  uint64_t len;
+};
+
+/* A member of an input file and its symbol table sections.  */
+
+struct symtab_cache_entry
+{
+  struct symtab_cache_member m;
+  char *data;
+};
+
+/* The cache of one input file.  */
+
+struct symtab_cache
+{
+  char *name;
+  char *cache_name;
+  struct symtab_cache_stamp stamp;
+  htab_t members;
+  /* The data read from the cache file, pointed to by the entries.  */
+  char *contents;
+  int dirty;
+  struct symtab_cache *next;
+};
+
+static char *symtab_cache_dir;
+static struct symtab_cache *symtab_caches;
+
+static hashval_t
+hash_cache_entry (const void *p)
+{
+  const struct symtab_cache_entry *e = (const struct symtab_cache_entry *) p;
+  return (hashval_t) (e->m.offset ^ (e->m.offset >> 32));
+}
+
+static int
+eq_cache_entry (const void *a, const void *b)
+{
+  const struct symtab_cache_entry *ea = (const struct symtab_cache_entry *) a;
+  const struct symtab_cache_entry *eb = (const struct symtab_cache_entry *) b;
+  return ea->m.offset == eb->m.offset;
+}
+
+/* Read the cache file of CACHE, dropping it if it does not match the
+   stamp or the name of the input file.  */
+
+static void
+read_symtab_cache (struct symtab_cache *cache)
+{
+  struct symtab_cache_stamp stamp;
+  struct stat st;
+  char *p, *end;
+  size_t name_len = strlen (cache->name);
+  FILE *f = fopen (cache->cache_name, "rb");
+
+  if (!f)
+    return;
+  if (fstat (fileno (f), &st) != 0
+      || st.st_size < (off_t) (sizeof SYMTAB_CACHE_MAGIC + sizeof stamp))
+    goto fail;
+  cache->contents = xmalloc (st.st_size);
+  if (fread (cache->contents, 1, st.st_size, f) != (size_t) st.st_size)
+    goto fail;
+
+  p = cache->contents;
+  end = p + st.st_size;
+  if (memcmp (p, SYMTAB_CACHE_MAGIC, sizeof SYMTAB_CACHE_MAGIC) != 0)
+    goto fail;
+  p += sizeof SYMTAB_CACHE_MAGIC;
+  memcpy (&stamp, p, sizeof stamp);
+  p += sizeof stamp;
+  if (memcmp (&stamp, &cache->stamp, sizeof stamp) != 0
+      || (size_t) (end - p) < name_len + 1
+      || memcmp (p, cache->name, name_len + 1) != 0)
+    goto fail;
+  p += name_len + 1;
+
+  while (p < end)
+    {
+      struct symtab_cache_entry *e;
+      void **slot;
+
+      if ((size_t) (end - p) < sizeof e->m)
+	goto fail;
+      e = xmalloc (sizeof *e);
+      memcpy (&e->m, p, sizeof e->m);
+      p += sizeof e->m;
+      e->data = p;
+      if ((uint64_t) (end - p) < e->m.len)
+	{
+	  free (e);
+	  goto fail;
+	}
+      p += e->m.len;
+      slot = htab_find_slot (cache->members, e, INSERT);
+      free (*slot);
+      *slot = e;
+    }
+  fclose (f);
+  return;
+
+ fail:
+  fclose (f);
+  htab_empty (cache->members);
+  free (cache->contents);
+  cache->contents = NULL;
+}
+
+/* Return the cache of the input FILE, reading its cache file if needed.  */
+
+static struct symtab_cache *
+get_symtab_cache (const struct ld_plugin_input_file *file)
+{
+  struct symtab_cache *cache;
+  struct stat st;
+
+  if (fstat (file->fd, &st) != 0)
+    return NULL;
+
+  for (cache = symtab_caches; cache; cache = cache->next)
+    if (strcmp (cache->name, file->name) == 0)
+      return cache;
+
+  cache = xcalloc (1, sizeof *cache);
+  cache->name = xstrdup (file->name);
+  cache->cache_name = xasprintf ("%s/%08lx.symtab", symtab_cache_dir,
+				 (unsigned long) htab_hash_string (file->name));
+  cache->stamp.size = st.st_size;
+  cache->stamp.mtime = st.st_mtime;
+  cache->stamp.ino = st.st_ino;
+  cache->stamp.dev = st.st_dev;
+  cache->members = htab_create (37, hash_cache_entry, eq_cache_entry, free);
+  read_symtab_cache (cache);
+  cache->next = symtab_caches;
+  symtab_caches = cache;
+  return cache;
+}
+
+/* Return the cached symbol tables of the input FILE, or NULL.  */
+
+static struct symtab_cache_entry *
+lookup_symtab_cache (const struct ld_plugin_input_file *file)
+{
+  struct symtab_cache_entry key, *e;
+  struct symtab_cache *cache = get_symtab_cache (file);
+
+  if (!cache)
+    return NULL;
+  key.m.offset = file->offset;
+  e = htab_find (cache->members, &key);
+  if (e && e->m.filesize != file->filesize)
+    return NULL;
+  return e;
+}
+
+/* Record in the cache that the input FILE has the symbol table sections
+   in DATA, LEN bytes in the format of the cache file, and FOUND and
+   OFFLOAD as computed by claim_file_handler.  */
+
+static void
+add_symtab_cache (const struct ld_plugin_input_file *file, int found,
+		  int offload, char *data, size_t len)
+{
+  struct symtab_cache_entry *e;
+  void **slot;
+  struct symtab_cache *cache = get_symtab_cache (file);
+
+  if (!cache)
+    return;
+  e = xmalloc (sizeof *e);
+  e->m.offset = file->offset;
+  e->m.filesize = file->filesize;
+  e->m.found = found;
+  e->m.offload = offload;
+  e->m.len = len;
+  e->data = xmalloc (len + 1);
+  memcpy (e->data, data, len);
+  slot = htab_find_slot (cache->members, e, INSERT);
+  free (*slot);
+  *slot = e;
+  cache->dirty = 1;
+}
+
+/* Write one member of a cache; called through htab_traverse.  */
+
+static int
+write_symtab_cache_member (void **slot, void *data)
+{
+  struct symtab_cache_entry *e = (struct symtab_cache_entry *) *slot;
+  FILE *f = (FILE *) data;
+
+  fwrite (&e->m, sizeof e->m, 1, f);
+  fwrite (e->data, 1, e->m.len, f);
+  return 1;
+}
+
+/* Write out the caches that gained members during this link.  */
+
+static void
+write_symtab_caches (void)
+{
+  struct symtab_cache *cache;
+
+  for (cache = symtab_caches; cache; cache = cache->next)
+    {
+      char *tmp;
+      FILE *f;
+
+      if (!cache->dirty)
+	continue;
+      cache->dirty = 0;
+      /* Write to a temporary file and rename it so that concurrent links
+	 never see a partial cache file.  */
+      tmp = xasprintf ("%s.%ld", cache->cache_name, (long) getpid ());
+      f = fopen (tmp, "wb");
+      if (!f)
+	{
+	  free (tmp);
+	  continue;
+	}
+      fwrite (SYMTAB_CACHE_MAGIC, sizeof SYMTAB_CACHE_MAGIC, 1, f);
+      fwrite (&cache->stamp, sizeof cache->stamp, 1, f);
+      fwrite (cache->name, strlen (cache->name) + 1, 1, f);
+      htab_traverse_noresize (cache->members, write_symtab_cache_member, f);
+      if (fclose (f) != 0 || rename (tmp, cache->cache_name) != 0)
+	unlink (tmp);
+      free (tmp);
+    }
+}
+
 /* Free all memory that is no longer needed after writing the symbol
    resolution. */
 
@@ -665,6 +930,9 @@ all_symbols_read_handler (void)
   char **lto_argv;
   const char *linker_output_str = NULL;
   const char **lto_arg_ptr;
+
+  write_symtab_caches ();
+
   if (num_claimed_files + num_offload_files == 0)
     return LDPS_OK;
 
@@ -807,6 +1075,8 @@ cleanup_handler (void)
 {
   unsigned int i;
 
+  write_symtab_caches ();
+
   if (debug)
     return LDPS_OK;
 
@@ -983,6 +1253,17 @@ process_symtab (void *data, const char *name, off_t offset, off_t length)
 
   translate (secdatastart, secdata, obj->out);
   obj->found++;
+  if (symtab_cache_dir)
+    {
+      uint64_t id = obj->out->id, len = secdata - secdatastart;
+      obj->cache_data = xrealloc (obj->cache_data,
+				  obj->cache_len + 2 * sizeof (uint64_t) + len);
+      memcpy (obj->cache_data + obj->cache_len, &id, sizeof id);
+      memcpy (obj->cache_data + obj->cache_len + sizeof id, &len, sizeof len);
+      memcpy (obj->cache_data + obj->cache_len + 2 * sizeof id,
+	      secdatastart, len);
+      obj->cache_len += 2 * sizeof (uint64_t) + len;
+    }
   free (secdatastart);
   return 1;
 
@@ -991,6 +1272,7 @@ err:
     message (LDPL_FATAL, "%s: corrupt object file", obj->file->name);
   /* Force claim_file_handler to abandon this file.  */
   obj->found = 0;
+  obj->corrupt = 1;
   free (secdatastart);
   return 0;
 }
@@ -1019,6 +1301,7 @@ claim_file_handler (const struct ld_plugin_input_file *file, int *claimed)
   enum ld_plugin_status status;
   struct plugin_objfile obj;
   struct plugin_file_info lto_file;
+  struct symtab_cache_entry *cached = NULL;
   int err;
   const char *errmsg;
 
@@ -1048,32 +1331,68 @@ claim_file_handler (const struct ld_plugin_input_file *file, int *claimed)
   obj.found = 0;
   obj.offload = 0;
   obj.out = &lto_file.symtab;
+  obj.objfile = NULL;
+  obj.cache_data = NULL;
+  obj.cache_len = 0;
+  obj.corrupt = 0;
   errmsg = NULL;
-  obj.objfile = simple_object_start_read (file->fd, file->offset, LTO_SEGMENT_NAME,
-			&errmsg, &err);
-  /* No file, but also no error code means unrecognized format; just skip it.  */
-  if (!obj.objfile && !err)
-    goto err;
-
-  if (obj.objfile)
-    errmsg = simple_object_find_sections (obj.objfile, process_symtab, &obj, &err);
 
-  if (!obj.objfile || errmsg)
+  if (symtab_cache_dir)
+    cached = lookup_symtab_cache (file);
+  if (cached)
     {
-      if (err && message)
-	message (LDPL_FATAL, "%s: %s: %s", file->name, errmsg,
-		xstrerror (err));
-      else if (message)
-	message (LDPL_FATAL, "%s: %s", file->name, errmsg);
-      goto err;
+      /* Replay the symbol table sections recorded in the cache.  */
+      char *p = cached->data, *end = p + cached->m.len;
+      while (p < end)
+	{
+	  uint64_t id, len;
+	  memcpy (&id, p, sizeof id);
+	  memcpy (&len, p + sizeof id, sizeof len);
+	  p += 2 * sizeof (uint64_t);
+	  obj.out->id = id;
+	  translate (p, p + len, obj.out);
+	  p += len;
+	}
+      obj.found = cached->m.found;
+      obj.offload = cached->m.offload;
+      if (obj.found == 0 && obj.offload == 0)
+	goto err;
     }
+  else
+    {
+      obj.objfile = simple_object_start_read (file->fd, file->offset,
+					      LTO_SEGMENT_NAME,
+					      &errmsg, &err);
+      /* No file, but also no error code means unrecognized format; just
+	 skip it.  */
+      if (!obj.objfile && !err)
+	goto err;
 
-  if (obj.objfile)
-    simple_object_find_sections (obj.objfile, process_offload_section,
-				 &obj, &err);
+      if (obj.objfile)
+	errmsg = simple_object_find_sections (obj.objfile, process_symtab,
+					      &obj, &err);
 
-  if (obj.found == 0 && obj.offload == 0)
-    goto err;
+      if (!obj.objfile || errmsg)
+	{
+	  if (err && message)
+	    message (LDPL_FATAL, "%s: %s: %s", file->name, errmsg,
+		    xstrerror (err));
+	  else if (message)
+	    message (LDPL_FATAL, "%s: %s", file->name, errmsg);
+	  goto err;
+	}
+
+      if (obj.objfile)
+	simple_object_find_sections (obj.objfile, process_offload_section,
+				     &obj, &err);
+
+      if (symtab_cache_dir && !obj.corrupt)
+	add_symtab_cache (file, obj.found, obj.offload, obj.cache_data,
+			  obj.cache_len);
+
+      if (obj.found == 0 && obj.offload == 0)
+	goto err;
+    }
 
   if (obj.found > 1)
     resolve_conflicts (&lto_file.symtab, &lto_file.conflicts);
@@ -1165,6 +1484,7 @@ claim_file_handler (const struct ld_plugin_input_file *file, int *claimed)
  cleanup:
   if (obj.objfile)
     simple_object_release_read (obj.objfile);
+  free (obj.cache_data);
 
   return LDPS_OK;
 }
@@ -1193,6 +1513,8 @@ process_option (const char *option)
       pass_through_items[num_pass_through_items - 1] =
           xstrdup (option + strlen ("-pass-through="));
     }
+  else if (!strncmp (option, "-symtab-cache=", sizeof ("-symtab-cache=") - 1))
+    symtab_cache_dir = xstrdup (option + sizeof ("-symtab-cache=") - 1);
   else if (!strncmp (option, "-sym-style=", sizeof ("-sym-style=") - 1))
     {
       switch (option[sizeof ("-sym-style=") - 1])